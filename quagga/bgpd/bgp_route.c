@@ -6144,228 +6144,286 @@ enum bgp_show_type
   bgp_show_type_damp_neighbor
 };
 
+/* Write the routes of one node matching a show type, returns the
+   number written. */
 static int
-bgp_show_table (struct vty *vty, struct bgp_table *table, struct in_addr *router_id,
-	  enum bgp_show_type type, void *output_arg)
+bgp_show_node (struct vty *vty, struct bgp_node *rn, struct in_addr router_id,
+	       enum bgp_show_type type, void *output_arg, int *header)
 {
   struct bgp_info *ri;
-  struct bgp_node *rn;
-  int header = 1;
-  int display;
-  unsigned long output_count;
-
-  /* This is first entry point, so reset total line. */
-  output_count = 0;
-
-  /* Start processing of routes. */
-  for (rn = bgp_table_top (table); rn; rn = bgp_route_next (rn)) 
-    if (rn->info != NULL)
-      {
-	display = 0;
+  int display = 0;
 
-	for (ri = rn->info; ri; ri = ri->next)
-	  {
-	    if (type == bgp_show_type_flap_statistics
-		|| type == bgp_show_type_flap_address
-		|| type == bgp_show_type_flap_prefix
-		|| type == bgp_show_type_flap_cidr_only
-		|| type == bgp_show_type_flap_regexp
-		|| type == bgp_show_type_flap_filter_list
-		|| type == bgp_show_type_flap_prefix_list
-		|| type == bgp_show_type_flap_prefix_longer
-		|| type == bgp_show_type_flap_route_map
-		|| type == bgp_show_type_flap_neighbor
-		|| type == bgp_show_type_dampend_paths
-		|| type == bgp_show_type_damp_neighbor)
-	      {
-		if (!(ri->extra && ri->extra->damp_info))
-		  continue;
-	      }
-	    if (type == bgp_show_type_regexp
-		|| type == bgp_show_type_flap_regexp)
-	      {
-		regex_t *regex = output_arg;
+  for (ri = rn->info; ri; ri = ri->next)
+    {
+      if (type == bgp_show_type_flap_statistics
+	  || type == bgp_show_type_flap_address
+	  || type == bgp_show_type_flap_prefix
+	  || type == bgp_show_type_flap_cidr_only
+	  || type == bgp_show_type_flap_regexp
+	  || type == bgp_show_type_flap_filter_list
+	  || type == bgp_show_type_flap_prefix_list
+	  || type == bgp_show_type_flap_prefix_longer
+	  || type == bgp_show_type_flap_route_map
+	  || type == bgp_show_type_flap_neighbor
+	  || type == bgp_show_type_dampend_paths
+	  || type == bgp_show_type_damp_neighbor)
+	{
+	  if (!(ri->extra && ri->extra->damp_info))
+	    continue;
+	}
+      if (type == bgp_show_type_regexp
+	  || type == bgp_show_type_flap_regexp)
+	{
+	  regex_t *regex = output_arg;
 		    
-		if (bgp_regexec (regex, ri->attr->aspath) == REG_NOMATCH)
-		  continue;
-	      }
-	    if (type == bgp_show_type_prefix_list
-		|| type == bgp_show_type_flap_prefix_list)
-	      {
-		struct prefix_list *plist = output_arg;
+	  if (bgp_regexec (regex, ri->attr->aspath) == REG_NOMATCH)
+	    continue;
+	}
+      if (type == bgp_show_type_prefix_list
+	  || type == bgp_show_type_flap_prefix_list)
+	{
+	  struct prefix_list *plist = output_arg;
 		    
-		if (prefix_list_apply (plist, &rn->p) != PREFIX_PERMIT)
-		  continue;
-	      }
-	    if (type == bgp_show_type_filter_list
-		|| type == bgp_show_type_flap_filter_list)
-	      {
-		struct as_list *as_list = output_arg;
+	  if (prefix_list_apply (plist, &rn->p) != PREFIX_PERMIT)
+	    continue;
+	}
+      if (type == bgp_show_type_filter_list
+	  || type == bgp_show_type_flap_filter_list)
+	{
+	  struct as_list *as_list = output_arg;
 
-		if (as_list_apply (as_list, ri->attr->aspath) != AS_FILTER_PERMIT)
-		  continue;
-	      }
-	    if (type == bgp_show_type_route_map
-		|| type == bgp_show_type_flap_route_map)
-	      {
-		struct route_map *rmap = output_arg;
-		struct bgp_info binfo;
-		struct attr dummy_attr = { 0 }; 
-		int ret;
+	  if (as_list_apply (as_list, ri->attr->aspath) != AS_FILTER_PERMIT)
+	    continue;
+	}
+      if (type == bgp_show_type_route_map
+	  || type == bgp_show_type_flap_route_map)
+	{
+	  struct route_map *rmap = output_arg;
+	  struct bgp_info binfo;
+	  struct attr dummy_attr = { 0 }; 
+	  int ret;
 
-		bgp_attr_dup (&dummy_attr, ri->attr);
-		binfo.peer = ri->peer;
-		binfo.attr = &dummy_attr;
+	  bgp_attr_dup (&dummy_attr, ri->attr);
+	  binfo.peer = ri->peer;
+	  binfo.attr = &dummy_attr;
 
-		ret = route_map_apply (rmap, &rn->p, RMAP_BGP, &binfo);
+	  ret = route_map_apply (rmap, &rn->p, RMAP_BGP, &binfo);
 		
-		bgp_attr_extra_free (&dummy_attr);
+	  bgp_attr_extra_free (&dummy_attr);
 		
-		if (ret == RMAP_DENYMATCH)
-		  continue;
-	      }
-	    if (type == bgp_show_type_neighbor
-		|| type == bgp_show_type_flap_neighbor
-		|| type == bgp_show_type_damp_neighbor)
-	      {
-		union sockunion *su = output_arg;
+	  if (ret == RMAP_DENYMATCH)
+	    continue;
+	}
+      if (type == bgp_show_type_neighbor
+	  || type == bgp_show_type_flap_neighbor
+	  || type == bgp_show_type_damp_neighbor)
+	{
+	  union sockunion *su = output_arg;
 
-		if (ri->peer->su_remote == NULL || ! sockunion_same(ri->peer->su_remote, su))
-		  continue;
-	      }
-	    if (type == bgp_show_type_cidr_only
-		|| type == bgp_show_type_flap_cidr_only)
-	      {
-		u_int32_t destination;
-
-		destination = ntohl (rn->p.u.prefix4.s_addr);
-		if (IN_CLASSC (destination) && rn->p.prefixlen == 24)
-		  continue;
-		if (IN_CLASSB (destination) && rn->p.prefixlen == 16)
-		  continue;
-		if (IN_CLASSA (destination) && rn->p.prefixlen == 8)
-		  continue;
-	      }
-	    if (type == bgp_show_type_prefix_longer
-		|| type == bgp_show_type_flap_prefix_longer)
-	      {
-		struct prefix *p = output_arg;
+	  if (ri->peer->su_remote == NULL || ! sockunion_same(ri->peer->su_remote, su))
+	    continue;
+	}
+      if (type == bgp_show_type_cidr_only
+	  || type == bgp_show_type_flap_cidr_only)
+	{
+	  u_int32_t destination;
 
-		if (! prefix_match (p, &rn->p))
-		  continue;
-	      }
-	    if (type == bgp_show_type_community_all)
-	      {
-		if (! ri->attr->community)
-		  continue;
-	      }
-	    if (type == bgp_show_type_community)
-	      {
-		struct community *com = output_arg;
+	  destination = ntohl (rn->p.u.prefix4.s_addr);
+	  if (IN_CLASSC (destination) && rn->p.prefixlen == 24)
+	    continue;
+	  if (IN_CLASSB (destination) && rn->p.prefixlen == 16)
+	    continue;
+	  if (IN_CLASSA (destination) && rn->p.prefixlen == 8)
+	    continue;
+	}
+      if (type == bgp_show_type_prefix_longer
+	  || type == bgp_show_type_flap_prefix_longer)
+	{
+	  struct prefix *p = output_arg;
 
-		if (! ri->attr->community ||
-		    ! community_match (ri->attr->community, com))
-		  continue;
-	      }
-	    if (type == bgp_show_type_community_exact)
-	      {
-		struct community *com = output_arg;
+	  if (! prefix_match (p, &rn->p))
+	    continue;
+	}
+      if (type == bgp_show_type_community_all)
+	{
+	  if (! ri->attr->community)
+	    continue;
+	}
+      if (type == bgp_show_type_community)
+	{
+	  struct community *com = output_arg;
 
-		if (! ri->attr->community ||
-		    ! community_cmp (ri->attr->community, com))
-		  continue;
-	      }
-	    if (type == bgp_show_type_community_list)
-	      {
-		struct community_list *list = output_arg;
+	  if (! ri->attr->community ||
+	      ! community_match (ri->attr->community, com))
+	    continue;
+	}
+      if (type == bgp_show_type_community_exact)
+	{
+	  struct community *com = output_arg;
 
-		if (! community_list_match (ri->attr->community, list))
-		  continue;
-	      }
-	    if (type == bgp_show_type_community_list_exact)
-	      {
-		struct community_list *list = output_arg;
+	  if (! ri->attr->community ||
+	      ! community_cmp (ri->attr->community, com))
+	    continue;
+	}
+      if (type == bgp_show_type_community_list)
+	{
+	  struct community_list *list = output_arg;
 
-		if (! community_list_exact_match (ri->attr->community, list))
-		  continue;
-	      }
-	    if (type == bgp_show_type_flap_address
-		|| type == bgp_show_type_flap_prefix)
-	      {
-		struct prefix *p = output_arg;
+	  if (! community_list_match (ri->attr->community, list))
+	    continue;
+	}
+      if (type == bgp_show_type_community_list_exact)
+	{
+	  struct community_list *list = output_arg;
 
-		if (! prefix_match (&rn->p, p))
-		  continue;
+	  if (! community_list_exact_match (ri->attr->community, list))
+	    continue;
+	}
+      if (type == bgp_show_type_flap_address
+	  || type == bgp_show_type_flap_prefix)
+	{
+	  struct prefix *p = output_arg;
 
-		if (type == bgp_show_type_flap_prefix)
-		  if (p->prefixlen != rn->p.prefixlen)
-		    continue;
-	      }
-	    if (type == bgp_show_type_dampend_paths
-		|| type == bgp_show_type_damp_neighbor)
-	      {
-		if (! CHECK_FLAG (ri->flags, BGP_INFO_DAMPED)
-		    || CHECK_FLAG (ri->flags, BGP_INFO_HISTORY))
-		  continue;
-	      }
+	  if (! prefix_match (&rn->p, p))
+	    continue;
 
-	    if (header)
-	      {
-		vty_out (vty, "BGP table version is 0, local router ID is %s%s", inet_ntoa (*router_id), VTY_NEWLINE);
-		vty_out (vty, BGP_SHOW_SCODE_HEADER, VTY_NEWLINE, VTY_NEWLINE);
-		vty_out (vty, BGP_SHOW_OCODE_HEADER, VTY_NEWLINE, VTY_NEWLINE);
-		if (type == bgp_show_type_dampend_paths
-		    || type == bgp_show_type_damp_neighbor)
-		  vty_out (vty, BGP_SHOW_DAMP_HEADER, VTY_NEWLINE);
-		else if (type == bgp_show_type_flap_statistics
-			 || type == bgp_show_type_flap_address
-			 || type == bgp_show_type_flap_prefix
-			 || type == bgp_show_type_flap_cidr_only
-			 || type == bgp_show_type_flap_regexp
-			 || type == bgp_show_type_flap_filter_list
-			 || type == bgp_show_type_flap_prefix_list
-			 || type == bgp_show_type_flap_prefix_longer
-			 || type == bgp_show_type_flap_route_map
-			 || type == bgp_show_type_flap_neighbor)
-		  vty_out (vty, BGP_SHOW_FLAP_HEADER, VTY_NEWLINE);
-		else
-		  vty_out (vty, BGP_SHOW_HEADER, VTY_NEWLINE);
-		header = 0;
-	      }
+	  if (type == bgp_show_type_flap_prefix)
+	    if (p->prefixlen != rn->p.prefixlen)
+	      continue;
+	}
+      if (type == bgp_show_type_dampend_paths
+	  || type == bgp_show_type_damp_neighbor)
+	{
+	  if (! CHECK_FLAG (ri->flags, BGP_INFO_DAMPED)
+	      || CHECK_FLAG (ri->flags, BGP_INFO_HISTORY))
+	    continue;
+	}
 
-	    if (type == bgp_show_type_dampend_paths
-		|| type == bgp_show_type_damp_neighbor)
-	      damp_route_vty_out (vty, &rn->p, ri, display, SAFI_UNICAST);
-	    else if (type == bgp_show_type_flap_statistics
-		     || type == bgp_show_type_flap_address
-		     || type == bgp_show_type_flap_prefix
-		     || type == bgp_show_type_flap_cidr_only
-		     || type == bgp_show_type_flap_regexp
-		     || type == bgp_show_type_flap_filter_list
-		     || type == bgp_show_type_flap_prefix_list
-		     || type == bgp_show_type_flap_prefix_longer
-		     || type == bgp_show_type_flap_route_map
-		     || type == bgp_show_type_flap_neighbor)
-	      flap_route_vty_out (vty, &rn->p, ri, display, SAFI_UNICAST);
-	    else
-	      route_vty_out (vty, &rn->p, ri, display, SAFI_UNICAST);
-	    display++;
-	  }
-	if (display)
-	  output_count++;
+      if (*header)
+	{
+	  vty_out (vty, "BGP table version is 0, local router ID is %s%s", inet_ntoa (router_id), VTY_NEWLINE);
+	  vty_out (vty, BGP_SHOW_SCODE_HEADER, VTY_NEWLINE, VTY_NEWLINE);
+	  vty_out (vty, BGP_SHOW_OCODE_HEADER, VTY_NEWLINE, VTY_NEWLINE);
+	  if (type == bgp_show_type_dampend_paths
+	      || type == bgp_show_type_damp_neighbor)
+	    vty_out (vty, BGP_SHOW_DAMP_HEADER, VTY_NEWLINE);
+	  else if (type == bgp_show_type_flap_statistics
+		   || type == bgp_show_type_flap_address
+		   || type == bgp_show_type_flap_prefix
+		   || type == bgp_show_type_flap_cidr_only
+		   || type == bgp_show_type_flap_regexp
+		   || type == bgp_show_type_flap_filter_list
+		   || type == bgp_show_type_flap_prefix_list
+		   || type == bgp_show_type_flap_prefix_longer
+		   || type == bgp_show_type_flap_route_map
+		   || type == bgp_show_type_flap_neighbor)
+	    vty_out (vty, BGP_SHOW_FLAP_HEADER, VTY_NEWLINE);
+	  else
+	    vty_out (vty, BGP_SHOW_HEADER, VTY_NEWLINE);
+	  *header = 0;
+	}
+
+      if (type == bgp_show_type_dampend_paths
+	  || type == bgp_show_type_damp_neighbor)
+	damp_route_vty_out (vty, &rn->p, ri, display, SAFI_UNICAST);
+      else if (type == bgp_show_type_flap_statistics
+	       || type == bgp_show_type_flap_address
+	       || type == bgp_show_type_flap_prefix
+	       || type == bgp_show_type_flap_cidr_only
+	       || type == bgp_show_type_flap_regexp
+	       || type == bgp_show_type_flap_filter_list
+	       || type == bgp_show_type_flap_prefix_list
+	       || type == bgp_show_type_flap_prefix_longer
+	       || type == bgp_show_type_flap_route_map
+	       || type == bgp_show_type_flap_neighbor)
+	flap_route_vty_out (vty, &rn->p, ri, display, SAFI_UNICAST);
+      else
+	route_vty_out (vty, &rn->p, ri, display, SAFI_UNICAST);
+      display++;
+    }
+  return display;
+}
+
+/* Cursor of a table walk written in slices, see vty_output_start. */
+struct bgp_show_walk
+{
+  struct bgp_table *table;
+
+  /* Next node to show, locked. */
+  struct bgp_node *rn;
+
+  struct in_addr router_id;
+  enum bgp_show_type type;
+  void *output_arg;
+  int header;
+  unsigned long output_count;
+};
+
+static int
+bgp_show_walk_run (struct vty *vty, void *arg)
+{
+  struct bgp_show_walk *walk = arg;
+  int budget = VTY_OUTPUT_SLICE;
+
+  for (; walk->rn && budget > 0; walk->rn = bgp_route_next (walk->rn))
+    if (walk->rn->info != NULL)
+      {
+	if (bgp_show_node (vty, walk->rn, walk->router_id, walk->type,
+			   walk->output_arg, &walk->header))
+	  walk->output_count++;
+	budget--;
       }
+  if (walk->rn)
+    return 1;
 
   /* No route is displayed */
-  if (output_count == 0)
+  if (walk->output_count == 0)
     {
-      if (type == bgp_show_type_normal)
+      if (walk->type == bgp_show_type_normal)
 	vty_out (vty, "No BGP network exists%s", VTY_NEWLINE);
     }
   else
     vty_out (vty, "%sTotal number of prefixes %ld%s",
-	     VTY_NEWLINE, output_count, VTY_NEWLINE);
+	     VTY_NEWLINE, walk->output_count, VTY_NEWLINE);
+  return 0;
+}
 
-  return CMD_SUCCESS;
+static void
+bgp_show_walk_free (struct vty *vty, void *arg)
+{
+  struct bgp_show_walk *walk = arg;
+
+  if (walk->rn)
+    bgp_unlock_node (walk->rn);
+  bgp_table_unlock (walk->table);
+  XFREE (MTYPE_BGP_SHOW_WALK, walk);
+}
+
+static int
+bgp_show_table (struct vty *vty, struct bgp_table *table, struct in_addr *router_id,
+	  enum bgp_show_type type, void *output_arg)
+{
+  struct bgp_show_walk *walk;
+
+  walk = XCALLOC (MTYPE_BGP_SHOW_WALK, sizeof (struct bgp_show_walk));
+  walk->table = table;
+  bgp_table_lock (table);
+  walk->rn = bgp_table_top (table);
+  walk->router_id = *router_id;
+  walk->type = type;
+  walk->output_arg = output_arg;
+  walk->header = 1;
+
+  /* The filter of a show type belongs to the caller, which frees it on
+     return, so filtered walks are written at once. */
+  if (output_arg)
+    {
+      while (bgp_show_walk_run (vty, walk))
+	;
+      bgp_show_walk_free (vty, walk);
+      return CMD_SUCCESS;
+    }
+  return vty_output_start (vty, bgp_show_walk_run, bgp_show_walk_free, walk);
 }
 
 static int
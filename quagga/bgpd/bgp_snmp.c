@@ -612,6 +612,51 @@ bgpRcvdPathAttrTable (struct variable *v, oid name[], size_t *length,
   return NULL;
 }
 
+/* Where the last bgp4PathAttrTable GETNEXT stopped.  A walk asks for
+   the row after the one returned before, that is resumed from the
+   locked node instead of looked up again.  The table is locked too, so
+   that the node outlives a deleted instance. */
+static struct
+{
+  struct bgp_table *table;
+  struct bgp_node *rn;
+  struct in_addr paddr;
+} bgp4_path_cursor;
+
+static void
+bgp4_path_cursor_set (struct bgp_table *table, struct bgp_node *rn,
+		      struct in_addr paddr)
+{
+  if (bgp4_path_cursor.rn)
+    bgp_unlock_node (bgp4_path_cursor.rn);
+  if (bgp4_path_cursor.table != table)
+    {
+      if (bgp4_path_cursor.table)
+	bgp_table_unlock (bgp4_path_cursor.table);
+      if (table)
+	bgp_table_lock (table);
+      bgp4_path_cursor.table = table;
+    }
+  bgp4_path_cursor.rn = rn;
+  bgp4_path_cursor.paddr = paddr;
+}
+
+/* The locked node of the cursor if it stopped at p and paddr, else
+   NULL. */
+static struct bgp_node *
+bgp4_path_cursor_get (struct bgp_table *table, struct prefix_ipv4 *p,
+		      struct in_addr paddr)
+{
+  struct bgp_node *rn = bgp4_path_cursor.rn;
+
+  if (rn == NULL || bgp4_path_cursor.table != table
+      || ! prefix_same (&rn->p, (struct prefix *) p)
+      || ! IPV4_ADDR_SAME (&bgp4_path_cursor.paddr, &paddr))
+    return NULL;
+  bgp4_path_cursor.rn = NULL;
+  return rn;
+}
+
 struct bgp_info *
 bgp4PathAttrLookup (struct variable *v, oid name[], size_t *length,
 		    struct bgp *bgp, struct prefix_ipv4 *addr, int exact)
@@ -620,14 +665,18 @@ bgp4PathAttrLookup (struct variable *v, oid name[], size_t *length,
   int offsetlen;
   struct bgp_info *binfo;
   struct bgp_info *min;
+  struct bgp_table *table;
   struct bgp_node *rn;
   union sockunion su;
   unsigned int len;
   struct in_addr paddr;
+  int resume;
 
 #define BGP_PATHATTR_ENTRY_OFFSET \
           (IN_ADDR_SIZE + 1 + IN_ADDR_SIZE)
 
+  table = bgp->rib[AFI_IP][SAFI_UNICAST];
+
   if (exact)
     {
       if (*length - v->namelen != BGP_PATHATTR_ENTRY_OFFSET)
@@ -663,9 +712,10 @@ bgp4PathAttrLookup (struct variable *v, oid name[], size_t *length,
       offset = name + v->namelen;
       offsetlen = *length - v->namelen;
       len = offsetlen;
+      resume = 0;
 
       if (offsetlen == 0)
-	rn = bgp_table_top (bgp->rib[AFI_IP][SAFI_UNICAST]);
+	rn = bgp_table_top (table);
       else
 	{
 	  if (len > IN_ADDR_SIZE)
@@ -681,8 +731,8 @@ bgp4PathAttrLookup (struct variable *v, oid name[], size_t *length,
 	  else
 	    addr->prefixlen = len * 8;
 
-	  rn = bgp_node_get (bgp->rib[AFI_IP][SAFI_UNICAST],
-			       (struct prefix *) addr);
+	  resume = 1;
+	  rn = NULL;
 
 	  offset++;
 	  offsetlen--;
@@ -699,6 +749,21 @@ bgp4PathAttrLookup (struct variable *v, oid name[], size_t *length,
       else
 	paddr.s_addr = 0;
 
+      /* Resume from the cursor, else from the node of the prefix for the
+	 peers after paddr, else from the node after it.  No node is
+	 added. */
+      if (resume)
+	{
+	  rn = bgp4_path_cursor_get (table, addr, paddr);
+	  if (rn == NULL)
+	    rn = bgp_node_lookup (table, (struct prefix *) addr);
+	  if (rn == NULL)
+	    {
+	      rn = bgp_table_get_next (table, (struct prefix *) addr);
+	      paddr.s_addr = 0;
+	    }
+	}
+
       if (! rn)
 	return NULL;
 
@@ -737,7 +802,7 @@ bgp4PathAttrLookup (struct variable *v, oid name[], size_t *length,
 	      addr->prefix = rn->p.u.prefix4;
 	      addr->prefixlen = rn->p.prefixlen;
 
-	      bgp_unlock_node (rn);
+	      bgp4_path_cursor_set (table, rn, min->peer->su.sin.sin_addr);
 
 	      return min;
 	    }
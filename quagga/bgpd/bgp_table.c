@@ -42,14 +42,29 @@ bgp_table_init (afi_t afi, safi_t safi)
   rt->type = BGP_TABLE_MAIN;
   rt->afi = afi;
   rt->safi = safi;
+  rt->lock = 1;
   
   return rt;
 }
 
+void
+bgp_table_lock (struct bgp_table *rt)
+{
+  rt->lock++;
+}
+
+void
+bgp_table_unlock (struct bgp_table *rt)
+{
+  assert (rt->lock > 0);
+  if (--rt->lock == 0)
+    bgp_table_free (rt);
+}
+
 void
 bgp_table_finish (struct bgp_table *rt)
 {
-  bgp_table_free (rt);
+  bgp_table_unlock (rt);
 }
 
 static struct bgp_node *
@@ -456,6 +471,69 @@ bgp_route_next (struct bgp_node *node)
   return NULL;
 }
 
+/* The node following the subtree under node, in the order of
+   bgp_route_next. */
+static struct bgp_node *
+bgp_subtree_next (struct bgp_node *node)
+{
+  while (node->parent)
+    {
+      if (node->parent->l_left == node && node->parent->l_right)
+	return node->parent->l_right;
+      node = node->parent;
+    }
+  return NULL;
+}
+
+/* Lock and return the first node that bgp_route_next would visit after
+   prefix p, whether p is in the table or not.  Unlike bgp_node_get
+   followed by bgp_route_next this never adds a node to the table. */
+struct bgp_node *
+bgp_table_get_next (struct bgp_table *table, struct prefix *p)
+{
+  struct bgp_node *node;
+  struct bgp_node *next;
+  struct prefix common;
+  int bit;
+
+  node = table->top;
+  while (node)
+    {
+      /* Node is p or holds it in its subtree. */
+      if (node->p.prefixlen <= p->prefixlen && prefix_match (&node->p, p))
+	{
+	  if (node->p.prefixlen == p->prefixlen)
+	    return bgp_route_next (bgp_lock_node (node));
+
+	  bit = check_bit (&p->u.prefix, node->p.prefixlen);
+	  next = node->link[bit];
+	  if (next == NULL)
+	    {
+	      /* P would be a leaf here. */
+	      next = bit ? NULL : node->l_right;
+	      if (next == NULL)
+		next = bgp_subtree_next (node);
+	      return next ? bgp_lock_node (next) : NULL;
+	    }
+	  node = next;
+	  continue;
+	}
+
+      /* P holds node, so would come right before it. */
+      if (p->prefixlen < node->p.prefixlen && prefix_match (p, &node->p))
+	return bgp_lock_node (node);
+
+      /* They part at a bit, p comes before the subtree of node if it
+         branches to the left there. */
+      route_common (&node->p, p, &common);
+      if (check_bit (&p->u.prefix, common.prefixlen) == 0)
+	return bgp_lock_node (node);
+      next = bgp_subtree_next (node);
+      return next ? bgp_lock_node (next) : NULL;
+    }
+  return NULL;
+}
+
 /* Unlock current node and lock next node until limit. */
 struct bgp_node *
 bgp_route_next_until (struct bgp_node *node, struct bgp_node *limit)
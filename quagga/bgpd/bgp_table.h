@@ -41,6 +41,10 @@ struct bgp_table
   struct bgp_node *top;
   
   unsigned long count;
+
+  /* Freed when the last reference goes, a table walk may outlive its
+     owner. */
+  unsigned int lock;
 };
 
 struct bgp_node
@@ -69,6 +73,8 @@ struct bgp_node
 
 extern struct bgp_table *bgp_table_init (afi_t, safi_t);
 extern void bgp_table_finish (struct bgp_table *);
+extern void bgp_table_lock (struct bgp_table *);
+extern void bgp_table_unlock (struct bgp_table *);
 extern void bgp_unlock_node (struct bgp_node *node);
 extern void bgp_node_delete (struct bgp_node *node);
 extern struct bgp_node *bgp_table_top (struct bgp_table *);
@@ -76,6 +82,8 @@ extern struct bgp_node *bgp_route_next (struct bgp_node *);
 extern struct bgp_node *bgp_route_next_until (struct bgp_node *, struct bgp_node *);
 extern struct bgp_node *bgp_node_get (struct bgp_table *, struct prefix *);
 extern struct bgp_node *bgp_node_lookup (struct bgp_table *, struct prefix *);
+extern struct bgp_node *bgp_table_get_next (struct bgp_table *,
+					    struct prefix *);
 extern struct bgp_node *bgp_lock_node (struct bgp_node *node);
 extern struct bgp_node *bgp_node_match (struct bgp_table *, struct prefix *);
 extern struct bgp_node *bgp_node_match_ipv4 (struct bgp_table *,
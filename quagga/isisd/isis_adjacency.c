@@ -43,6 +43,8 @@
 #include "isisd/isis_dr.h"
 #include "isisd/isis_dynhn.h"
 #include "isisd/isis_pdu.h"
+#include "isisd/isis_tlv.h"
+#include "isisd/isis_lsp.h"
 
 extern struct isis *isis;
 
@@ -169,7 +171,11 @@ isis_adj_state_change (struct isis_adjacency *adj, enum isis_adj_state state,
   if (circuit->circ_type == CIRCUIT_T_BROADCAST)
     {
       if (state == ISIS_ADJ_UP)
-	circuit->upadjcount[level - 1]++;
+	{
+	  circuit->upadjcount[level - 1]++;
+	  if (circuit->upadjcount[level - 1] == 1)
+	    lsp_srm_requeue (circuit, level);
+	}
       if (state == ISIS_ADJ_DOWN)
 	{
 	  isis_delete_adj (adj, adj->circuit->u.bc.adjdb[level - 1]);
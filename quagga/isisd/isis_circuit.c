@@ -133,6 +133,7 @@ isis_circuit_configure (struct isis_circuit *circuit, struct isis_area *area)
 
   circuit->idx = flags_get_index (&area->flags);
   circuit->lsp_queue = list_new ();
+  circuit->lsp_rexmit = list_new ();
 
   return;
 }
@@ -144,6 +145,8 @@ isis_circuit_deconfigure (struct isis_circuit *circuit,
 
   /* Remove circuit from area */
   listnode_delete (area->circuit_list, circuit);
+  /* Nothing stays queued under the index */
+  lsp_queue_flush (circuit);
   /* Free the index of SRM and SSN flags */
   flags_free_index (&area->flags, circuit->idx);
 
@@ -602,6 +605,7 @@ isis_circuit_down (struct isis_circuit *circuit)
     {
       THREAD_TIMER_OFF (circuit->u.p2p.t_send_p2p_hello);
     }
+  lsp_queue_flush (circuit);
   /* close the socket */
   close (circuit->fd);
 
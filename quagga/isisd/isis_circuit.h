@@ -78,6 +78,9 @@ struct isis_circuit
   struct thread *t_send_csnp[2];
   struct thread *t_send_psnp[2];
   struct list *lsp_queue;	/* LSPs to be txed (both levels) */
+  struct list *lsp_rexmit;	/* LSPs held back, retried every second */
+  struct thread *t_send_lsp;
+  struct thread *t_lsp_rexmit;
   /* there is no real point in two streams, just for programming kicker */
   int (*rx) (struct isis_circuit * circuit, u_char * ssnpa);
   struct stream *rcv_stream;	/* Stream for receiving */
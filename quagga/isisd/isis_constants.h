@@ -72,6 +72,7 @@
 /* different vendors implement different values 5-10 on average */
 #define LSP_GEN_INTERVAL_DEFAULT      10
 #define LSP_INTERVAL                  33	/* msecs */
+#define LSP_TX_BATCH                  10	/* LSPs sent per LSP_INTERVAL */
 #define DEFAULT_CIRCUIT_METRICS 10
 #define METRICS_UNSUPPORTED 0x80
 #define PERIODIC_SPF_INTERVAL         60	/* at the top of my head */
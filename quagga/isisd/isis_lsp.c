@@ -33,6 +33,7 @@
 #include "command.h"
 #include "hash.h"
 #include "if.h"
+#include "pqueue.h"
 
 #include "isisd/dict.h"
 #include "isisd/isis_constants.h"
@@ -79,6 +80,98 @@ lsp_db_init (void)
   return dict;
 }
 
+/*
+ * The expiry queue of an area keeps its LSPs ordered by the time their
+ * remaining lifetime runs out, or for those at zero, by the time they
+ * have spent ZeroAgeLifetime and are removed.  lsp_tick runs when the
+ * first one is due.
+ */
+static int
+lsp_expiry_cmp (void *a, void *b)
+{
+  struct isis_lsp *lsp1 = a;
+  struct isis_lsp *lsp2 = b;
+
+  if (lsp1->expires < lsp2->expires)
+    return -1;
+  if (lsp1->expires > lsp2->expires)
+    return 1;
+  return 0;
+}
+
+static void
+lsp_expiry_index (void *node, int position)
+{
+  ((struct isis_lsp *) node)->expiry_index = position + 1;
+}
+
+struct pqueue *
+lsp_expiry_init (void)
+{
+  struct pqueue *queue;
+
+  queue = pqueue_create ();
+  queue->cmp = lsp_expiry_cmp;
+  queue->update = lsp_expiry_index;
+
+  return queue;
+}
+
+static void
+lsp_expiry_arm (struct isis_area *area)
+{
+  struct isis_lsp *lsp;
+  time_t now;
+
+  THREAD_TIMER_OFF (area->t_tick);
+  if (area->lsp_expiry->size == 0)
+    return;
+
+  lsp = area->lsp_expiry->array[0];
+  now = time (NULL);
+  THREAD_TIMER_ON (master, area->t_tick, lsp_tick, area,
+		   lsp->expires > now ? lsp->expires - now : 0);
+}
+
+static void
+lsp_expiry_remove (struct isis_lsp *lsp)
+{
+  if (lsp->expiry_index == 0)
+    return;
+
+  pqueue_remove_at (lsp->expiry_index - 1, lsp->area->lsp_expiry);
+  lsp->expiry_index = 0;
+}
+
+/*
+ * Sets the expiry of the LSP from its remaining lifetime, or from its
+ * age_out if that is zero.  To be called whenever the remaining lifetime
+ * of an LSP in the database is written.
+ */
+void
+lsp_expiry_update (struct isis_lsp *lsp)
+{
+  struct isis_area *area = lsp->area;
+  struct isis_lsp *head;
+
+  if (area == NULL || area->lsp_expiry == NULL)
+    return;
+
+  head = area->lsp_expiry->size ? area->lsp_expiry->array[0] : NULL;
+
+  lsp->expires = time (NULL);
+  if (lsp->lsp_header->rem_lifetime)
+    lsp->expires += ntohs (lsp->lsp_header->rem_lifetime);
+  else
+    lsp->expires += lsp->age_out;
+
+  lsp_expiry_remove (lsp);
+  pqueue_enqueue (lsp, area->lsp_expiry);
+
+  if (area->lsp_expiry->array[0] != head || head == lsp)
+    lsp_expiry_arm (area);
+}
+
 struct isis_lsp *
 lsp_search (u_char * id, dict_t * lspdb)
 {
@@ -157,6 +250,22 @@ lsp_destroy (struct isis_lsp *lsp)
       list_delete (lsp->lspu.frags);
     }
 
+  if (lsp->area)
+    {
+      struct isis_circuit *circuit;
+      struct listnode *node;
+
+      lsp_expiry_remove (lsp);
+      isis_csnp_cache_del (lsp);
+      if (flags_any_set (lsp->rexmit_queue))
+	for (ALL_LIST_ELEMENTS_RO (lsp->area->circuit_list, node, circuit))
+	  if (ISIS_CHECK_FLAG (lsp->rexmit_queue, circuit))
+	    {
+	      listnode_delete (circuit->lsp_queue, lsp);
+	      listnode_delete (circuit->lsp_rexmit, lsp);
+	    }
+    }
+
   if (lsp->pdu)
     stream_free (lsp->pdu);
   XFREE (MTYPE_ISIS_LSP, lsp);
@@ -438,7 +547,7 @@ lsp_update (struct isis_lsp *lsp, struct isis_link_state_hdr *lsp_hdr,
   memcpy (lsp->lsp_header, lsp_hdr, ISIS_LSP_HDR_LEN);
 
   if (dnode)
-    lsp_insert (lsp, area->lspdb[level - 1]);
+    lsp_insert (lsp, area);
 }
 
 /* creation of LSP directly from what we received */
@@ -523,9 +632,13 @@ lsp_new (u_char * lsp_id, u_int16_t rem_lifetime, u_int32_t seq_num,
 }
 
 void
-lsp_insert (struct isis_lsp *lsp, dict_t * lspdb)
+lsp_insert (struct isis_lsp *lsp, struct isis_area *area)
 {
-  dict_alloc_insert (lspdb, lsp->lsp_header->lsp_id, lsp);
+  dict_alloc_insert (area->lspdb[lsp->level - 1], lsp->lsp_header->lsp_id,
+		     lsp);
+  lsp->area = area;
+  lsp_expiry_update (lsp);
+  isis_csnp_cache_add (lsp);
 }
 
 /*
@@ -615,31 +728,27 @@ lsp_build_list_ssn (struct isis_circuit *circuit, struct list *list,
   return;
 }
 
-static void
+/*
+ * The remaining lifetime and age_out are not counted down every second,
+ * bring them up to date from the expiry time before they are sent or
+ * shown.  Turning zero is left to lsp_tick.
+ */
+void
 lsp_set_time (struct isis_lsp *lsp)
 {
-  assert (lsp);
-
-  if (lsp->lsp_header->rem_lifetime == 0)
-    {
-      if (lsp->age_out != 0)
-	lsp->age_out--;
-      return;
-    }
+  time_t now;
 
-  /* If we are turning 0 */
-  /* ISO 10589 - 7.3.16.4 first paragraph */
+  assert (lsp);
 
-  if (ntohs (lsp->lsp_header->rem_lifetime) == 1)
-    {
-      /* 7.3.16.4 a) set SRM flags on all */
-      ISIS_FLAGS_SET_ALL (lsp->SRMflags);
-      /* 7.3.16.4 b) retain only the header FIXME  */
-      /* 7.3.16.4 c) record the time to purge FIXME (other way to do it) */
-    }
+  if (lsp->expiry_index == 0)
+    return;
 
-  lsp->lsp_header->rem_lifetime =
-    htons (ntohs (lsp->lsp_header->rem_lifetime) - 1);
+  now = time (NULL);
+  if (lsp->lsp_header->rem_lifetime == 0)
+    lsp->age_out = lsp->expires > now ? lsp->expires - now : 0;
+  else
+    lsp->lsp_header->rem_lifetime =
+      htons (lsp->expires > now ? lsp->expires - now : 1);
 }
 
 static void
@@ -698,6 +807,7 @@ lsp_print (dnode_t * node, struct vty *vty, char dynhost)
   struct isis_lsp *lsp = dnode_get (node);
   u_char LSPid[255];
 
+  lsp_set_time (lsp);
   lspid_print (lsp->lsp_header->lsp_id, LSPid, dynhost, 1);
   vty_out (vty, "%-21s%c   ", LSPid, lsp->own_lsp ? '*' : ' ');
   vty_out (vty, "0x%08x   ", ntohl (lsp->lsp_header->seq_num));
@@ -983,7 +1093,7 @@ lsp_next_frag (u_char frag_num, struct isis_lsp *lsp0, struct isis_area *area,
   lsp = lsp_new (frag_id, area->max_lsp_lifetime[level - 1], 0, area->is_type,
 		 0, level);
   lsp->own_lsp = 1;
-  lsp_insert (lsp, area->lspdb[level - 1]);
+  lsp_insert (lsp, area);
   listnode_add (lsp0->lspu.frags, lsp);
   lsp->lspu.zero_lsp = lsp0;
   /*
@@ -1439,7 +1549,7 @@ lsp_generate_non_pseudo (struct isis_area *area, int level)
 			area->is_type, 0, level);
       newlsp->own_lsp = 1;
 
-      lsp_insert (newlsp, area->lspdb[level - 1]);
+      lsp_insert (newlsp, area);
       /* build_lsp_data (newlsp, area); */
       lsp_build_nonpseudo (newlsp, area);
       /* time to calculate our checksum */
@@ -1523,14 +1633,16 @@ lsp_non_pseudo_regenerate (struct isis_area *area, int level)
 
   lsp->last_generated = time (NULL);
   area->lsp_regenerate_pending[level - 1] = 0;
-  ISIS_FLAGS_SET_ALL (lsp->SRMflags);
+  lsp_expiry_update (lsp);
+  lsp_srm_set_all (lsp);
   for (ALL_LIST_ELEMENTS_RO (lsp->lspu.frags, node, frag))
     {
       frag->lsp_header->rem_lifetime = htons (isis_jitter
 					      (area->
 					       max_lsp_lifetime[level - 1],
 					       MAX_AGE_JITTER));
-      ISIS_FLAGS_SET_ALL (frag->SRMflags);
+      lsp_expiry_update (frag);
+      lsp_srm_set_all (frag);
     }
 
   if (area->ip_circuits)
@@ -1848,7 +1960,8 @@ lsp_pseudo_regenerate (struct isis_circuit *circuit, int level)
     }
 
   lsp->last_generated = time (NULL);
-  ISIS_FLAGS_SET_ALL (lsp->SRMflags);
+  lsp_expiry_update (lsp);
+  lsp_srm_set_all (lsp);
 
   return ISIS_OK;
 }
@@ -1901,8 +2014,8 @@ lsp_l1_pseudo_generate (struct isis_circuit *circuit)
   lsp_build_pseudo (lsp, circuit, 1);
 
   lsp->own_lsp = 1;
-  lsp_insert (lsp, circuit->area->lspdb[0]);
-  ISIS_FLAGS_SET_ALL (lsp->SRMflags);
+  lsp_insert (lsp, circuit->area);
+  lsp_srm_set_all (lsp);
 
   ref_time = circuit->area->lsp_refresh[0] > MAX_LSP_GEN_INTERVAL ?
     MAX_LSP_GEN_INTERVAL : circuit->area->lsp_refresh[0];
@@ -1963,8 +2076,8 @@ lsp_l2_pseudo_generate (struct isis_circuit *circuit)
 
 
   lsp->own_lsp = 1;
-  lsp_insert (lsp, circuit->area->lspdb[1]);
-  ISIS_FLAGS_SET_ALL (lsp->SRMflags);
+  lsp_insert (lsp, circuit->area);
+  lsp_srm_set_all (lsp);
 
   THREAD_TIMER_ON (master, circuit->u.bc.t_refresh_pseudo_lsp[1],
 		   lsp_l2_refresh_pseudo, circuit,
@@ -1974,90 +2087,182 @@ lsp_l2_pseudo_generate (struct isis_circuit *circuit)
 }
 
 /*
- * Walk through LSPs for an area
- *  - set remaining lifetime
- *  - set LSPs with SRMflag set for sending
+ * Expire the LSPs of an area that are due
+ *  - flood those whose remaining lifetime ran out and keep them for
+ *    ZeroAgeLifetime
+ *  - remove those that have been at zero for ZeroAgeLifetime
  */
 int
 lsp_tick (struct thread *thread)
 {
   struct isis_area *area;
-  struct isis_circuit *circuit;
   struct isis_lsp *lsp;
-  struct list *lsp_list;
-  struct listnode *lspnode, *cnode;
-  dnode_t *dnode, *dnode_next;
-  int level;
-
-  lsp_list = list_new ();
+  dnode_t *dnode;
+  time_t now;
 
   area = THREAD_ARG (thread);
   assert (area);
   area->t_tick = NULL;
-  THREAD_TIMER_ON (master, area->t_tick, lsp_tick, area, 1);
 
-  /*
-   * Build a list of LSPs with (any) SRMflag set
-   * and removed the ones that have aged out
-   */
-  for (level = 0; level < ISIS_LEVELS; level++)
+  now = time (NULL);
+  while (area->lsp_expiry->size > 0)
     {
-      if (area->lspdb[level] && dict_count (area->lspdb[level]) > 0)
+      lsp = area->lsp_expiry->array[0];
+      if (lsp->expires > now)
+	break;
+
+      /* ISO 10589 - 7.3.16.4 first paragraph */
+      if (lsp->lsp_header->rem_lifetime != 0)
 	{
-	  dnode = dict_first (area->lspdb[level]);
-	  while (dnode != NULL)
-	    {
-	      dnode_next = dict_next (area->lspdb[level], dnode);
-	      lsp = dnode_get (dnode);
-	      lsp_set_time (lsp);
-	      if (lsp->age_out == 0)
-		{
+	  lsp->lsp_header->rem_lifetime = 0;
+	  lsp->age_out = ZERO_AGE_LIFETIME;
+	  /* 7.3.16.4 a) set SRM flags on all */
+	  lsp_srm_set_all (lsp);
+	  /* 7.3.16.4 b) retain only the header FIXME  */
+	  /* 7.3.16.4 c) record the time to purge */
+	  lsp_expiry_remove (lsp);
+	  lsp->expires = now + lsp->age_out;
+	  pqueue_enqueue (lsp, area->lsp_expiry);
+	  continue;
+	}
 
-		  zlog_debug ("ISIS-Upd (%s): L%u LSP %s seq 0x%08x aged out",
-			      area->area_tag,
-			      lsp->level,
-			      rawlspid_print (lsp->lsp_header->lsp_id),
-			      ntohl (lsp->lsp_header->seq_num));
+      zlog_debug ("ISIS-Upd (%s): L%u LSP %s seq 0x%08x aged out",
+		  area->area_tag,
+		  lsp->level,
+		  rawlspid_print (lsp->lsp_header->lsp_id),
+		  ntohl (lsp->lsp_header->seq_num));
 #ifdef TOPOLOGY_GENERATE
-		  if (lsp->from_topology)
-		    THREAD_TIMER_OFF (lsp->t_lsp_top_ref);
+      if (lsp->from_topology)
+	THREAD_TIMER_OFF (lsp->t_lsp_top_ref);
 #endif /* TOPOLOGY_GENERATE */
-		  lsp_destroy (lsp);
-		  dict_delete (area->lspdb[level], dnode);
-		}
-	      else if (flags_any_set (lsp->SRMflags))
-		listnode_add (lsp_list, lsp);
-	      dnode = dnode_next;
-	    }
+      dnode = dict_lookup (area->lspdb[lsp->level - 1],
+			   lsp->lsp_header->lsp_id);
+      if (dnode && dnode_get (dnode) == lsp)
+	dnode_destroy (dict_delete (area->lspdb[lsp->level - 1], dnode));
+      lsp_destroy (lsp);
+    }
 
-	  /*
-	   * Send LSPs on circuits indicated by the SRMflags
-	   */
-	  if (listcount (lsp_list) > 0)
-	    {
-              for (ALL_LIST_ELEMENTS_RO (area->circuit_list, cnode, circuit))
-		{
-                  for (ALL_LIST_ELEMENTS_RO (lsp_list, lspnode, lsp))
-		    {
-		      if (ISIS_CHECK_FLAG (lsp->SRMflags, circuit))
-			{
-			  /* FIXME: if same or elder lsp is already in lsp
-			   * queue */
-			  listnode_add (circuit->lsp_queue, lsp);
-			  thread_add_event (master, send_lsp, circuit, 0);
-			}
-		    }
-		}
-	    }
-	  list_delete_all_node (lsp_list);
-	}
+  lsp_expiry_arm (area);
+
+  return ISIS_OK;
+}
+
+/*
+ * The circuits keep the LSPs to send in lsp_queue, filled as SRM flags
+ * are set rather than by walking the database.  An LSP is at most once on
+ * the lsp_queue or lsp_rexmit of a circuit, as told by its rexmit_queue
+ * flags.  Clearing SRM leaves it queued, send_lsp skips it.
+ */
+static void
+lsp_queue_add (struct isis_lsp *lsp, struct isis_circuit *circuit)
+{
+  if (circuit->state != C_STATE_UP || circuit->lsp_queue == NULL)
+    return;
+
+  /* lsp_srm_requeue queues it when an adjacency comes up */
+  if (!(lsp->level & circuit->circuit_is_type)
+      || circuit->upadjcount[lsp->level - 1] == 0)
+    return;
+
+  if (!(ISIS_CHECK_FLAG (lsp->rexmit_queue, circuit)))
+    {
+      ISIS_SET_FLAG (lsp->rexmit_queue, circuit);
+      listnode_add (circuit->lsp_queue, lsp);
     }
 
-  list_delete (lsp_list);
+  if (circuit->t_send_lsp == NULL && listcount (circuit->lsp_queue) > 0)
+    circuit->t_send_lsp = thread_add_event (master, send_lsp, circuit, 0);
+}
+
+void
+lsp_srm_set (struct isis_lsp *lsp, struct isis_circuit *circuit)
+{
+  ISIS_SET_FLAG (lsp->SRMflags, circuit);
+  lsp_queue_add (lsp, circuit);
+}
+
+void
+lsp_srm_set_all (struct isis_lsp *lsp)
+{
+  struct isis_circuit *circuit;
+  struct listnode *node;
+
+  ISIS_FLAGS_SET_ALL (lsp->SRMflags);
+  if (lsp->area)
+    for (ALL_LIST_ELEMENTS_RO (lsp->area->circuit_list, node, circuit))
+      lsp_queue_add (lsp, circuit);
+}
+
+/*
+ * Queue the LSPs of a level with SRM set for the circuit, when it gets
+ * its first adjacency on that level.
+ */
+void
+lsp_srm_requeue (struct isis_circuit *circuit, int level)
+{
+  dict_t *lspdb = circuit->area->lspdb[level - 1];
+  dnode_t *dnode;
+  struct isis_lsp *lsp;
+
+  if (lspdb == NULL)
+    return;
+
+  for (dnode = dict_first (lspdb); dnode; dnode = dict_next (lspdb, dnode))
+    {
+      lsp = dnode_get (dnode);
+      if (ISIS_CHECK_FLAG (lsp->SRMflags, circuit))
+	lsp_queue_add (lsp, circuit);
+    }
+}
+
+/*
+ * Requeue the LSPs send_lsp held back, unless SRM got cleared meanwhile
+ */
+int
+lsp_rexmit (struct thread *thread)
+{
+  struct isis_circuit *circuit;
+  struct isis_lsp *lsp;
+  struct listnode *node, *nnode;
+
+  circuit = THREAD_ARG (thread);
+  assert (circuit);
+  circuit->t_lsp_rexmit = NULL;
+
+  for (ALL_LIST_ELEMENTS (circuit->lsp_rexmit, node, nnode, lsp))
+    {
+      list_delete_node (circuit->lsp_rexmit, node);
+      ISIS_CLEAR_FLAG (lsp->rexmit_queue, circuit);
+      if (ISIS_CHECK_FLAG (lsp->SRMflags, circuit))
+	lsp_queue_add (lsp, circuit);
+    }
 
   return ISIS_OK;
 }
 
+void
+lsp_queue_flush (struct isis_circuit *circuit)
+{
+  struct isis_lsp *lsp;
+  struct listnode *node;
+
+  THREAD_OFF (circuit->t_send_lsp);
+  THREAD_TIMER_OFF (circuit->t_lsp_rexmit);
+
+  if (circuit->lsp_queue)
+    {
+      for (ALL_LIST_ELEMENTS_RO (circuit->lsp_queue, node, lsp))
+	ISIS_CLEAR_FLAG (lsp->rexmit_queue, circuit);
+      list_delete_all_node (circuit->lsp_queue);
+    }
+  if (circuit->lsp_rexmit)
+    {
+      for (ALL_LIST_ELEMENTS_RO (circuit->lsp_rexmit, node, lsp))
+	ISIS_CLEAR_FLAG (lsp->rexmit_queue, circuit);
+      list_delete_all_node (circuit->lsp_rexmit);
+    }
+}
+
 void
 lsp_purge_dr (u_char * id, struct isis_circuit *circuit, int level)
 {
@@ -2067,13 +2272,15 @@ lsp_purge_dr (u_char * id, struct isis_circuit *circuit, int level)
 
   if (lsp && lsp->purged == 0)
     {
+      lsp_set_time (lsp);
       lsp->lsp_header->rem_lifetime = htons (0);
       lsp->lsp_header->pdu_len =
 	htons (ISIS_FIXED_HDR_LEN + ISIS_LSP_HDR_LEN);
       lsp->purged = 0;
       iso_csum_create (STREAM_DATA (lsp->pdu) + 12,
 		       ntohs (lsp->lsp_header->pdu_len) - 12, 12);
-      ISIS_FLAGS_SET_ALL (lsp->SRMflags);
+      lsp_expiry_update (lsp);
+      lsp_srm_set_all (lsp);
     }
 
   return;
@@ -2113,15 +2320,16 @@ lsp_purge_non_exist (struct isis_link_state_hdr *lsp_hdr,
    * Set the remaining lifetime to 0
    */
   lsp->lsp_header->rem_lifetime = 0;
+  lsp->age_out = ZERO_AGE_LIFETIME;
   /*
    * Put the lsp into LSPdb
    */
-  lsp_insert (lsp, area->lspdb[lsp->level - 1]);
+  lsp_insert (lsp, area);
 
   /*
    * Send in to whole area
    */
-  ISIS_FLAGS_SET_ALL (lsp->SRMflags);
+  lsp_srm_set_all (lsp);
 
   return;
 }
@@ -2140,7 +2348,6 @@ top_lsp_refresh (struct thread *thread)
 
   lsp_seqnum_update (lsp);
 
-  ISIS_FLAGS_SET_ALL (lsp->SRMflags);
   if (isis->debugs & DEBUG_UPDATE_PACKETS)
     {
       zlog_debug ("ISIS-Upd (): refreshing Topology L1 %s",
@@ -2152,6 +2359,8 @@ top_lsp_refresh (struct thread *thread)
 
   lsp->lsp_header->rem_lifetime =
     htons (isis_jitter (lsp->area->max_lsp_lifetime[0], MAX_AGE_JITTER));
+  lsp_expiry_update (lsp);
+  lsp_srm_set_all (lsp);
 
   ref_time = lsp->area->lsp_refresh[0] > MAX_LSP_GEN_INTERVAL ?
     MAX_LSP_GEN_INTERVAL : lsp->area->lsp_refresh[0];
@@ -2208,8 +2417,8 @@ generate_topology_lsps (struct isis_area *area)
 
       THREAD_TIMER_ON (master, lsp->t_lsp_top_ref, top_lsp_refresh, lsp,
 		       isis_jitter (ref_time, MAX_LSP_GEN_JITTER));
-      ISIS_FLAGS_SET_ALL (lsp->SRMflags);
-      lsp_insert (lsp, area->lspdb[0]);
+      lsp_insert (lsp, area);
+      lsp_srm_set_all (lsp);
     }
 }
 
@@ -44,7 +44,7 @@ struct isis_lsp
   } lspu;
   u_int32_t SRMflags[ISIS_MAX_CIRCUITS];
   u_int32_t SSNflags[ISIS_MAX_CIRCUITS];
-  u_int32_t rexmit_queue[ISIS_MAX_CIRCUITS];
+  u_int32_t rexmit_queue[ISIS_MAX_CIRCUITS];	/* on the circuit tx queues */
   int level;			/* L1 or L2? */
   int purged;			/* have purged this one */
   int scheduled;		/* scheduled for sending */
@@ -58,15 +58,20 @@ struct isis_lsp
 #endif
   /* used for 60 second counting when rem_lifetime is zero */
   int age_out;
+  /* when rem_lifetime or age_out runs out, see lsp_set_time () */
+  time_t expires;
+  int expiry_index;		/* position in area->lsp_expiry + 1 */
   struct isis_adjacency *adj;
-  /* FIXME: For now only topology LSP's use this. Is it helpful for others? */
-  struct isis_area *area;
+  struct isis_area *area;	/* set by lsp_insert */
   struct tlvs tlv_data;		/* Simplifies TLV access */
 };
 
 dict_t *lsp_db_init (void);
 void lsp_db_destroy (dict_t * lspdb);
+struct pqueue *lsp_expiry_init (void);
 int lsp_tick (struct thread *thread);
+void lsp_set_time (struct isis_lsp *lsp);
+void lsp_expiry_update (struct isis_lsp *lsp);
 
 int lsp_l1_generate (struct isis_area *area);
 int lsp_l2_generate (struct isis_area *area);
@@ -87,7 +92,7 @@ struct isis_lsp *lsp_new_from_stream_ptr (struct stream *stream,
 					  u_int16_t pdu_len,
 					  struct isis_lsp *lsp0,
 					  struct isis_area *area);
-void lsp_insert (struct isis_lsp *lsp, dict_t * lspdb);
+void lsp_insert (struct isis_lsp *lsp, struct isis_area *area);
 struct isis_lsp *lsp_search (u_char * id, dict_t * lspdb);
 
 void lsp_build_list (u_char * start_id, u_char * stop_id,
@@ -99,6 +104,11 @@ void lsp_build_list_ssn (struct isis_circuit *circuit, struct list *list,
 
 void lsp_search_and_destroy (u_char * id, dict_t * lspdb);
 void lsp_purge_dr (u_char * id, struct isis_circuit *circuit, int level);
+void lsp_srm_set (struct isis_lsp *lsp, struct isis_circuit *circuit);
+void lsp_srm_set_all (struct isis_lsp *lsp);
+void lsp_srm_requeue (struct isis_circuit *circuit, int level);
+int lsp_rexmit (struct thread *thread);
+void lsp_queue_flush (struct isis_circuit *circuit);
 void lsp_purge_non_exist (struct isis_link_state_hdr *lsp_hdr,
 			  struct isis_area *area);
 
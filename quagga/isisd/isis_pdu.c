@@ -1084,7 +1084,7 @@ dontcheckadj:
 		  lsp_update (lsp, hdr, circuit->rcv_stream, circuit->area,
 			      level);
 		  /* ii */
-		  ISIS_FLAGS_SET_ALL (lsp->SRMflags);
+		  lsp_srm_set_all (lsp);
 		  /* iii */
 		  ISIS_CLEAR_FLAG (lsp->SRMflags, circuit);
 		  /* v */
@@ -1104,7 +1104,7 @@ dontcheckadj:
 		}		/* 7.3.16.4 b) 3) */
 	      else
 		{
-		  ISIS_SET_FLAG (lsp->SRMflags, circuit);
+		  lsp_srm_set (lsp, circuit);
 		  ISIS_CLEAR_FLAG (lsp->SSNflags, circuit);
 		}
 	    }
@@ -1123,7 +1123,6 @@ dontcheckadj:
 				ntohs (lsp->lsp_header->pdu_len));
 		  iso_csum_create (STREAM_DATA (lsp->pdu) + 12,
 				   ntohs (lsp->lsp_header->pdu_len) - 12, 12);
-		  ISIS_FLAGS_SET_ALL (lsp->SRMflags);
 		  if (isis->debugs & DEBUG_UPDATE_PACKETS)
 		    zlog_debug ("ISIS-Upd (%s): (1) re-originating LSP %s new "
 				"seq 0x%08x", circuit->area->area_tag,
@@ -1133,6 +1132,8 @@ dontcheckadj:
 		    htons (isis_jitter
 			   (circuit->area->max_lsp_lifetime[level - 1],
 			    MAX_AGE_JITTER));
+		  lsp_expiry_update (lsp);
+		  lsp_srm_set_all (lsp);
 		}
 	      else
 		{
@@ -1167,7 +1168,6 @@ dontcheckadj:
 	  iso_csum_create (STREAM_DATA (lsp->pdu) + 12,
 			   ntohs (lsp->lsp_header->pdu_len) - 12, 12);
 
-	  ISIS_FLAGS_SET_ALL (lsp->SRMflags);
 	  if (isis->debugs & DEBUG_UPDATE_PACKETS)
 	    zlog_debug ("ISIS-Upd (%s): (2) re-originating LSP %s new seq "
 			"0x%08x", circuit->area->area_tag,
@@ -1177,6 +1177,8 @@ dontcheckadj:
 	    htons (isis_jitter
 		   (circuit->area->max_lsp_lifetime[level - 1],
 		    MAX_AGE_JITTER));
+	  lsp_expiry_update (lsp);
+	  lsp_srm_set_all (lsp);
 	}
     }
   else
@@ -1221,9 +1223,9 @@ dontcheckadj:
 				     circuit->area);
 	  lsp->level = level;
 	  lsp->adj = adj;
-	  lsp_insert (lsp, circuit->area->lspdb[level - 1]);
+	  lsp_insert (lsp, circuit->area);
 	  /* ii */
-	  ISIS_FLAGS_SET_ALL (lsp->SRMflags);
+	  lsp_srm_set_all (lsp);
 	  /* iii */
 	  ISIS_CLEAR_FLAG (lsp->SRMflags, circuit);
 
@@ -1245,7 +1247,7 @@ dontcheckadj:
       /* 7.3.15.1 e) 3) LSP older than the one in db */
       else
 	{
-	  ISIS_SET_FLAG (lsp->SRMflags, circuit);
+	  lsp_srm_set (lsp, circuit);
 	  ISIS_CLEAR_FLAG (lsp->SSNflags, circuit);
 	}
     }
@@ -1467,7 +1469,7 @@ process_snp (int snp_type, int level, struct isis_circuit *circuit,
 	    else if (cmp == LSP_OLDER)
 	      {
 		ISIS_CLEAR_FLAG (lsp->SSNflags, circuit);
-		ISIS_SET_FLAG (lsp->SRMflags, circuit);
+		lsp_srm_set (lsp, circuit);
 	      }
 	    else
 	      {
@@ -1476,7 +1478,7 @@ process_snp (int snp_type, int level, struct isis_circuit *circuit,
 		if (own_lsp)
 		  {
 		    lsp_inc_seqnum (lsp, ntohl (entry->seq_num));
-		    ISIS_SET_FLAG (lsp->SRMflags, circuit);
+		    lsp_srm_set (lsp, circuit);
 		  }
 		else
 		  {
@@ -1495,7 +1497,7 @@ process_snp (int snp_type, int level, struct isis_circuit *circuit,
 	      {
 		lsp = lsp_new (entry->lsp_id, ntohs (entry->rem_lifetime),
 			       0, 0, entry->checksum, level);
-		lsp_insert (lsp, circuit->area->lspdb[level - 1]);
+		lsp_insert (lsp, circuit->area);
 		ISIS_SET_FLAG (lsp->SSNflags, circuit);
 	      }
 	  }
@@ -1530,7 +1532,7 @@ process_snp (int snp_type, int level, struct isis_circuit *circuit,
       /* on remaining LSPs we set SRM (neighbor knew not of) */
       for (ALL_LIST_ELEMENTS_RO (lsp_list, node, lsp))
       {
-	ISIS_SET_FLAG (lsp->SRMflags, circuit);
+	lsp_srm_set (lsp, circuit);
       }
       /* lets free it */
       list_free (lsp_list);
@@ -2123,7 +2125,7 @@ send_p2p_hello (struct thread *thread)
 
 static int
 build_csnp (int level, u_char * start, u_char * stop, struct list *lsps,
-	    struct isis_circuit *circuit)
+	    struct stream *stream, struct isis_area *area)
 {
   struct isis_fixed_hdr fixed_hdr;
   struct isis_passwd *passwd;
@@ -2132,92 +2134,346 @@ build_csnp (int level, u_char * start, u_char * stop, struct list *lsps,
   u_int16_t length;
 
   if (level == 1)
-    fill_fixed_hdr_andstream (&fixed_hdr, L1_COMPLETE_SEQ_NUM,
-			      circuit->snd_stream);
+    fill_fixed_hdr_andstream (&fixed_hdr, L1_COMPLETE_SEQ_NUM, stream);
   else
-    fill_fixed_hdr_andstream (&fixed_hdr, L2_COMPLETE_SEQ_NUM,
-			      circuit->snd_stream);
+    fill_fixed_hdr_andstream (&fixed_hdr, L2_COMPLETE_SEQ_NUM, stream);
 
   /*
    * Fill Level 1 or 2 Complete Sequence Numbers header
    */
 
-  lenp = stream_get_endp (circuit->snd_stream);
-  stream_putw (circuit->snd_stream, 0);	/* PDU length - when we know it */
+  lenp = stream_get_endp (stream);
+  stream_putw (stream, 0);	/* PDU length - when we know it */
   /* no need to send the source here, it is always us if we csnp */
-  stream_put (circuit->snd_stream, isis->sysid, ISIS_SYS_ID_LEN);
+  stream_put (stream, isis->sysid, ISIS_SYS_ID_LEN);
   /* with zero circuit id - ref 9.10, 9.11 */
-  stream_putc (circuit->snd_stream, 0x00);
+  stream_putc (stream, 0x00);
 
-  stream_put (circuit->snd_stream, start, ISIS_SYS_ID_LEN + 2);
-  stream_put (circuit->snd_stream, stop, ISIS_SYS_ID_LEN + 2);
+  stream_put (stream, start, ISIS_SYS_ID_LEN + 2);
+  stream_put (stream, stop, ISIS_SYS_ID_LEN + 2);
 
   /*
    * And TLVs
    */
   if (level == 1)
-    passwd = &circuit->area->area_passwd;
+    passwd = &area->area_passwd;
   else
-    passwd = &circuit->area->domain_passwd;
+    passwd = &area->domain_passwd;
 
   if (CHECK_FLAG(passwd->snp_auth, SNP_AUTH_SEND))
     if (passwd->type)
       retval = tlv_add_authinfo (passwd->type, passwd->len,
-				 passwd->passwd, circuit->snd_stream);
+				 passwd->passwd, stream);
 
   if (!retval && lsps)
     {
-      retval = tlv_add_lsp_entries (lsps, circuit->snd_stream);
+      retval = tlv_add_lsp_entries (lsps, stream);
     }
-  length = (u_int16_t) stream_get_endp (circuit->snd_stream);
+  length = (u_int16_t) stream_get_endp (stream);
   assert (length >= ISIS_CSNP_HDRLEN);
   /* Update PU length */
-  stream_putw_at (circuit->snd_stream, lenp, length);
+  stream_putw_at (stream, lenp, length);
 
   return retval;
 }
 
 /*
- * FIXME: support multiple CSNPs
+ * CSNP cache
+ *
+ * The CSNPs of a level are the same on all circuits but for the size of
+ * the PDUs, so they are built once for the smallest MTU of the area and
+ * copied on each circuit.  An LSP replaced by one with the same LSP ID
+ * takes its entry over, only LSPs added or removed have the CSNPs
+ * rebuilt.  The remaining lifetime, sequence number and checksum of the
+ * entries are patched in before sending.
  */
 
-int
-send_csnp (struct isis_circuit *circuit, int level)
+/* LSP entries in a full LSP_ENTRIES TLV, as tlv_add_lsp_entries fills
+   them */
+#define CSNP_TLV_ENTRIES (255 / LSP_ENTRIES_LEN)
+#define CSNP_TLV_LEN (2 + CSNP_TLV_ENTRIES * LSP_ENTRIES_LEN)
+
+static u_char *
+csnp_cache_entry (struct isis_csnp_cache *cache, int i)
 {
-  int retval = ISIS_OK;
+  int j = i % cache->per_pdu;
+
+  return STREAM_DATA (cache->pdus[i / cache->per_pdu]) + cache->base
+    + (j / CSNP_TLV_ENTRIES) * CSNP_TLV_LEN
+    + 2 + (j % CSNP_TLV_ENTRIES) * LSP_ENTRIES_LEN;
+}
+
+static int
+csnp_cache_find (struct isis_csnp_cache *cache, u_char * lsp_id)
+{
+  int low = 0, high = cache->count - 1;
+  int mid, cmp;
+
+  while (low <= high)
+    {
+      mid = (low + high) / 2;
+      cmp = lsp_id_cmp (lsp_id, csnp_cache_entry (cache, mid) + 2);
+      if (cmp == 0)
+	return mid;
+      if (cmp < 0)
+	high = mid - 1;
+      else
+	low = mid + 1;
+    }
+
+  return -1;
+}
+
+void
+isis_csnp_cache_flush (struct isis_area *area, int level)
+{
+  struct isis_csnp_cache *cache = area->csnp_cache[level - 1];
+  int i;
+
+  if (cache == NULL)
+    return;
+
+  for (i = 0; i < cache->pdu_count; i++)
+    stream_free (cache->pdus[i]);
+  XFREE (MTYPE_ISIS_CSNP, cache->pdus);
+  XFREE (MTYPE_ISIS_CSNP, cache->lsps);
+  XFREE (MTYPE_ISIS_CSNP, cache);
+  area->csnp_cache[level - 1] = NULL;
+}
+
+/* An LSP was put into the database */
+void
+isis_csnp_cache_add (struct isis_lsp *lsp)
+{
+  struct isis_csnp_cache *cache;
+  int i;
+
+  if (lsp->area == NULL
+      || (cache = lsp->area->csnp_cache[lsp->level - 1]) == NULL)
+    return;
+
+  i = csnp_cache_find (cache, lsp->lsp_header->lsp_id);
+  if (i < 0)
+    isis_csnp_cache_flush (lsp->area, lsp->level);
+  else if (cache->lsps[i] == NULL)
+    {
+      cache->lsps[i] = lsp;
+      cache->missing--;
+    }
+}
+
+/* An LSP of the database is going away */
+void
+isis_csnp_cache_del (struct isis_lsp *lsp)
+{
+  struct isis_csnp_cache *cache;
+  int i;
+
+  if (lsp->area == NULL
+      || (cache = lsp->area->csnp_cache[lsp->level - 1]) == NULL)
+    return;
+
+  i = csnp_cache_find (cache, lsp->lsp_header->lsp_id);
+  if (i >= 0 && cache->lsps[i] == lsp)
+    {
+      cache->lsps[i] = NULL;
+      cache->missing++;
+    }
+}
+
+static void
+lsp_id_inc (u_char * lsp_id)
+{
+  int i;
+
+  for (i = ISIS_SYS_ID_LEN + 1; i >= 0; i--)
+    if (++lsp_id[i] != 0)
+      break;
+}
+
+static struct isis_csnp_cache *
+csnp_cache_build (struct isis_area *area, int level, size_t mtu)
+{
+  struct isis_csnp_cache *cache;
+  dict_t *lspdb = area->lspdb[level - 1];
+  dnode_t *dnode;
+  struct list *list;
+  struct stream *stream;
   u_char start[ISIS_SYS_ID_LEN + 2];
   u_char stop[ISIS_SYS_ID_LEN + 2];
-  struct list *list = NULL;
-  struct listnode *node;
-  struct isis_lsp *lsp;
+  size_t room;
+  int i, p, last;
 
   memset (start, 0x00, ISIS_SYS_ID_LEN + 2);
   memset (stop, 0xff, ISIS_SYS_ID_LEN + 2);
 
-  if (circuit->area->lspdb[level - 1] &&
-      dict_count (circuit->area->lspdb[level - 1]) > 0)
+  cache = XCALLOC (MTYPE_ISIS_CSNP, sizeof (struct isis_csnp_cache));
+  cache->mtu = mtu;
+  memcpy (cache->sysid, isis->sysid, ISIS_SYS_ID_LEN);
+  if (level == 1)
+    memcpy (&cache->passwd, &area->area_passwd, sizeof (struct isis_passwd));
+  else
+    memcpy (&cache->passwd, &area->domain_passwd,
+	    sizeof (struct isis_passwd));
+
+  /* The header and authentication are the same in every PDU */
+  stream = stream_new (mtu);
+  build_csnp (level, start, stop, NULL, stream, area);
+  cache->base = stream_get_endp (stream);
+  stream_free (stream);
+
+  room = mtu > cache->base ? mtu - cache->base : 0;
+  cache->per_pdu = (room / CSNP_TLV_LEN) * CSNP_TLV_ENTRIES;
+  room %= CSNP_TLV_LEN;
+  if (room > 2)
+    cache->per_pdu += (room - 2) / LSP_ENTRIES_LEN;
+  if (cache->per_pdu == 0)
     {
-      list = list_new ();
-      lsp_build_list (start, stop, list, circuit->area->lspdb[level - 1]);
+      XFREE (MTYPE_ISIS_CSNP, cache);
+      return NULL;
+    }
+
+  cache->count = dict_count (lspdb);
+  cache->lsps = XCALLOC (MTYPE_ISIS_CSNP,
+			 cache->count * sizeof (struct isis_lsp *));
+  for (i = 0, dnode = dict_first (lspdb); dnode;
+       dnode = dict_next (lspdb, dnode))
+    cache->lsps[i++] = dnode_get (dnode);
+
+  cache->pdu_count = (cache->count + cache->per_pdu - 1) / cache->per_pdu;
+  cache->pdus = XCALLOC (MTYPE_ISIS_CSNP,
+			 cache->pdu_count * sizeof (struct stream *));
 
-      if (circuit->snd_stream == NULL)
-	circuit->snd_stream = stream_new (ISO_MTU (circuit));
+  /*
+   * Each PDU covers the LSP IDs from right after the last entry of the
+   * one before up to its own last entry, the last one up to the end
+   */
+  list = list_new ();
+  for (p = 0; p < cache->pdu_count; p++)
+    {
+      last = (p + 1) * cache->per_pdu;
+      if (last >= cache->count)
+	{
+	  last = cache->count;
+	  memset (stop, 0xff, ISIS_SYS_ID_LEN + 2);
+	}
       else
-	stream_reset (circuit->snd_stream);
+	memcpy (stop, cache->lsps[last - 1]->lsp_header->lsp_id,
+		ISIS_SYS_ID_LEN + 2);
+
+      list_delete_all_node (list);
+      for (i = p * cache->per_pdu; i < last; i++)
+	listnode_add (list, cache->lsps[i]);
+
+      cache->pdus[p] = stream_new (mtu);
+      build_csnp (level, start, stop, list, cache->pdus[p], area);
+
+      memcpy (start, stop, ISIS_SYS_ID_LEN + 2);
+      lsp_id_inc (start);
+    }
+  list_delete (list);
+
+  area->csnp_cache_rebuilds[level - 1]++;
+
+  return cache;
+}
 
-      retval = build_csnp (level, start, stop, list, circuit);
+static void
+csnp_cache_patch (struct isis_csnp_cache *cache)
+{
+  struct isis_lsp *lsp;
+  u_char *entry;
+  int i;
+
+  for (i = 0; i < cache->count; i++)
+    {
+      lsp = cache->lsps[i];
+      entry = csnp_cache_entry (cache, i);
+      lsp_set_time (lsp);
+      memcpy (entry, &lsp->lsp_header->rem_lifetime, 2);
+      memcpy (entry + 2 + ISIS_SYS_ID_LEN + 2, &lsp->lsp_header->seq_num, 4);
+      memcpy (entry + 2 + ISIS_SYS_ID_LEN + 6, &lsp->lsp_header->checksum, 2);
+    }
+}
+
+int
+send_csnp (struct isis_circuit *circuit, int level)
+{
+  int retval = ISIS_OK;
+  struct isis_area *area = circuit->area;
+  struct isis_csnp_cache *cache;
+  struct isis_circuit *c;
+  struct listnode *node;
+  struct isis_lsp *lsp;
+  size_t mtu, c_mtu;
+  struct isis_passwd *passwd;
+  int i, p;
+
+  if (area->lspdb[level - 1] == NULL
+      || dict_count (area->lspdb[level - 1]) == 0)
+    {
+      isis_csnp_cache_flush (area, level);
+      return retval;
+    }
+
+  /* The PDUs must fit on every circuit */
+  mtu = ISO_MTU (circuit);
+  for (ALL_LIST_ELEMENTS_RO (area->circuit_list, node, c))
+    if (c->state == C_STATE_UP && c->interface)
+      {
+	c_mtu = ISO_MTU (c);
+	if (c_mtu < mtu)
+	  mtu = c_mtu;
+      }
+
+  if (level == 1)
+    passwd = &area->area_passwd;
+  else
+    passwd = &area->domain_passwd;
+
+  cache = area->csnp_cache[level - 1];
+  if (cache && (cache->missing || cache->mtu != mtu
+		|| memcmp (cache->sysid, isis->sysid, ISIS_SYS_ID_LEN)
+		|| memcmp (&cache->passwd, passwd,
+			   sizeof (struct isis_passwd))))
+    {
+      isis_csnp_cache_flush (area, level);
+      cache = NULL;
+    }
+
+  if (cache)
+    area->csnp_cache_hits[level - 1]++;
+  else if ((cache = csnp_cache_build (area, level, mtu)) == NULL)
+    return ISIS_WARNING;
+  area->csnp_cache[level - 1] = cache;
+
+  csnp_cache_patch (cache);
+
+  if (circuit->snd_stream && STREAM_SIZE (circuit->snd_stream) < mtu)
+    {
+      stream_free (circuit->snd_stream);
+      circuit->snd_stream = NULL;
+    }
+  if (circuit->snd_stream == NULL)
+    circuit->snd_stream = stream_new (ISO_MTU (circuit));
+
+  for (p = 0; p < cache->pdu_count && retval == ISIS_OK; p++)
+    {
+      stream_copy (circuit->snd_stream, cache->pdus[p]);
 
       if (isis->debugs & DEBUG_SNP_PACKETS)
 	{
 	  zlog_debug ("ISIS-Snp (%s): Sent L%d CSNP on %s, length %ld",
-		     circuit->area->area_tag, level, circuit->interface->name,
+		     area->area_tag, level, circuit->interface->name,
 		     /* FIXME: use %z when we stop supporting old compilers. */
-		     (unsigned long) STREAM_SIZE (circuit->snd_stream));
-	  for (ALL_LIST_ELEMENTS_RO (list, node, lsp))
+		     (unsigned long) stream_get_endp (circuit->snd_stream));
+	  for (i = p * cache->per_pdu;
+	       i < cache->count && i < (p + 1) * cache->per_pdu; i++)
 	  {
+	    lsp = cache->lsps[i];
 	    zlog_debug ("ISIS-Snp (%s):         CSNP entry %s, seq 0x%08x,"
 			" cksum 0x%04x, lifetime %us",
-			circuit->area->area_tag,
+			area->area_tag,
 			rawlspid_print (lsp->lsp_header->lsp_id),
 			ntohl (lsp->lsp_header->seq_num),
 			ntohs (lsp->lsp_header->checksum),
@@ -2225,11 +2481,9 @@ send_csnp (struct isis_circuit *circuit, int level)
 	  }
 	}
 
-      list_delete (list);
-
-      if (retval == ISIS_OK)
-	retval = circuit->tx (circuit, level);
+      retval = circuit->tx (circuit, level);
     }
+
   return retval;
 }
 
@@ -2450,6 +2704,11 @@ send_l2_psnp (struct thread *thread)
 
 /*
  * ISO 10589 - 7.3.14.3
+ *
+ * Sends the LSPs queued on the circuit, LSP_TX_BATCH of them every
+ * lsp_interval.  Those that may not be sent yet, or on point-to-point
+ * wait for their acknowledgement, move to lsp_rexmit and are retried
+ * every second by lsp_rexmit ().
  */
 int
 send_lsp (struct thread *thread)
@@ -2457,91 +2716,100 @@ send_lsp (struct thread *thread)
   struct isis_circuit *circuit;
   struct isis_lsp *lsp;
   struct listnode *node;
+  int sent = 0;
   int retval = 0;
 
   circuit = THREAD_ARG (thread);
   assert (circuit);
+  circuit->t_send_lsp = NULL;
 
-  if (circuit->state == C_STATE_UP)
+  if (circuit->state != C_STATE_UP)
     {
-      lsp = listgetdata ((node = listhead (circuit->lsp_queue)));
+      lsp_queue_flush (circuit);
+      return retval;
+    }
 
-      /*
-       * Do not send if levels do not match
-       */
-      if (!(lsp->level & circuit->circuit_is_type))
-	goto dontsend;
+  while (sent < LSP_TX_BATCH && (node = listhead (circuit->lsp_queue)))
+    {
+      lsp = listgetdata (node);
+      list_delete_node (circuit->lsp_queue, node);
 
       /*
-       * Do not send if we do not have adjacencies in state up on the circuit
+       * Do not send if SRM got cleared since it was queued, if levels do
+       * not match or if we do not have adjacencies in state up on the
+       * circuit
        */
-      if (circuit->upadjcount[lsp->level - 1] == 0)
-	goto dontsend;
+      if (!(ISIS_CHECK_FLAG (lsp->SRMflags, circuit))
+	  || !(lsp->level & circuit->circuit_is_type)
+	  || circuit->upadjcount[lsp->level - 1] == 0)
+	{
+	  ISIS_CLEAR_FLAG (lsp->rexmit_queue, circuit);
+	  continue;
+	}
+
       /* only send if it needs sending */
-      if ((time (NULL) - lsp->last_sent) >=
+      if ((time (NULL) - lsp->last_sent) <
 	  circuit->area->lsp_gen_interval[lsp->level - 1])
 	{
+	  listnode_add (circuit->lsp_rexmit, lsp);
+	  continue;
+	}
 
-	  if (isis->debugs & DEBUG_UPDATE_PACKETS)
-	    {
-	      zlog_debug
-		("ISIS-Upd (%s): Sent L%d LSP %s, seq 0x%08x, cksum 0x%04x,"
-		 " lifetime %us on %s", circuit->area->area_tag, lsp->level,
-		 rawlspid_print (lsp->lsp_header->lsp_id),
-		 ntohl (lsp->lsp_header->seq_num),
-		 ntohs (lsp->lsp_header->checksum),
-		 ntohs (lsp->lsp_header->rem_lifetime),
-		 circuit->interface->name);
-	    }
-	  /* copy our lsp to the send buffer */
-	  stream_copy (circuit->snd_stream, lsp->pdu);
-
-	  retval = circuit->tx (circuit, lsp->level);
+      lsp_set_time (lsp);
+      if (isis->debugs & DEBUG_UPDATE_PACKETS)
+	{
+	  zlog_debug
+	    ("ISIS-Upd (%s): Sent L%d LSP %s, seq 0x%08x, cksum 0x%04x,"
+	     " lifetime %us on %s", circuit->area->area_tag, lsp->level,
+	     rawlspid_print (lsp->lsp_header->lsp_id),
+	     ntohl (lsp->lsp_header->seq_num),
+	     ntohs (lsp->lsp_header->checksum),
+	     ntohs (lsp->lsp_header->rem_lifetime),
+	     circuit->interface->name);
+	}
+      /* copy our lsp to the send buffer */
+      stream_copy (circuit->snd_stream, lsp->pdu);
 
-	  /*
-	   * If the sending succeeded, we can del the lsp from circuits
-	   * lsp_queue
-	   */
-	  if (retval == ISIS_OK)
-	    {
-	      list_delete_node (circuit->lsp_queue, node);
+      retval = circuit->tx (circuit, lsp->level);
+      sent++;
 
-	      /*
-	       * On broadcast circuits also the SRMflag can be cleared
-	       */
-	      if (circuit->circ_type == CIRCUIT_T_BROADCAST)
-		ISIS_CLEAR_FLAG (lsp->SRMflags, circuit);
+      if (retval != ISIS_OK)
+	{
+	  zlog_debug ("sending of level %d link state failed", lsp->level);
+	  listnode_add (circuit->lsp_rexmit, lsp);
+	  continue;
+	}
 
-	      if (flags_any_set (lsp->SRMflags) == 0)
-		{
-		  /*
-		   * need to remember when we were last sent
-		   */
-		  lsp->last_sent = time (NULL);
-		}
-	    }
-	  else
-	    {
-	      zlog_debug ("sending of level %d link state failed", lsp->level);
-	    }
+      /*
+       * On broadcast circuits the SRMflag can be cleared, elsewhere it
+       * stays until the LSP is acknowledged
+       */
+      if (circuit->circ_type == CIRCUIT_T_BROADCAST)
+	{
+	  ISIS_CLEAR_FLAG (lsp->SRMflags, circuit);
+	  ISIS_CLEAR_FLAG (lsp->rexmit_queue, circuit);
 	}
       else
+	listnode_add (circuit->lsp_rexmit, lsp);
+
+      if (flags_any_set (lsp->SRMflags) == 0)
 	{
-	  /* my belief is that if it wasn't his time, the lsp can be removed
-	   * from the queue
+	  /*
+	   * need to remember when we were last sent
 	   */
-	dontsend:
-	  list_delete_node (circuit->lsp_queue, node);
+	  lsp->last_sent = time (NULL);
 	}
-#if 0
-      /*
-       * If there are still LSPs send next one after lsp-interval (33 msecs)
-       */
-      if (listcount (circuit->lsp_queue) > 0)
-	thread_add_timer (master, send_lsp, circuit, 1);
-#endif
     }
 
+  /*
+   * If there are still LSPs send the next ones after lsp-interval
+   */
+  if (listcount (circuit->lsp_queue) > 0)
+    circuit->t_send_lsp = thread_add_timer_msec (master, send_lsp, circuit,
+						 circuit->lsp_interval);
+  if (listcount (circuit->lsp_rexmit) > 0)
+    THREAD_TIMER_ON (master, circuit->t_lsp_rexmit, lsp_rexmit, circuit, 1);
+
   return retval;
 }
 
@@ -209,6 +209,23 @@ struct isis_complete_seqnum_hdr
 };
 #define ISIS_CSNP_HDRLEN 25
 
+/*
+ * The CSNPs of a level, built once for all circuits, see send_csnp ()
+ */
+struct isis_csnp_cache
+{
+  size_t mtu;			/* PDU size it was built for */
+  u_char sysid[ISIS_SYS_ID_LEN];
+  struct isis_passwd passwd;	/* authentication it was built with */
+  int per_pdu;			/* LSP entries in a PDU */
+  size_t base;			/* offset of the first entry in a PDU */
+  int count;
+  int missing;			/* entries whose LSP was removed */
+  struct isis_lsp **lsps;	/* the LSPs of the entries, by LSP ID */
+  int pdu_count;
+  struct stream **pdus;
+};
+
 #define L1_PARTIAL_SEQ_NUM   26
 #define L2_PARTIAL_SEQ_NUM   27
 /*
@@ -248,6 +265,9 @@ int send_lan_l1_hello (struct thread *thread);
 int send_lan_l2_hello (struct thread *thread);
 int send_p2p_hello (struct thread *thread);
 int send_csnp (struct isis_circuit *circuit, int level);
+void isis_csnp_cache_add (struct isis_lsp *lsp);
+void isis_csnp_cache_del (struct isis_lsp *lsp);
+void isis_csnp_cache_flush (struct isis_area *area, int level);
 int send_l1_csnp (struct thread *thread);
 int send_l2_csnp (struct thread *thread);
 int send_l1_psnp (struct thread *thread);
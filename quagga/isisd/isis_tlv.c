@@ -956,6 +956,7 @@ tlv_add_lsp_entries (struct list *lsps, struct stream *stream)
 	    return retval;
 	  pos = value;
 	}
+      lsp_set_time (lsp);
       *((u_int16_t *) pos) = lsp->lsp_header->rem_lifetime;
       pos += 2;
       memcpy (pos, lsp->lsp_header->lsp_id, ISIS_SYS_ID_LEN + 2);
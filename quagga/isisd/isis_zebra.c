@@ -107,7 +107,7 @@ isis_zebra_if_del (int command, struct zclient *zclient, zebra_size_t length)
 
   isis_csm_state_change (IF_DOWN_FROM_Z, circuit_scan_by_ifp (ifp), ifp);
 
-  ifp->ifindex = IFINDEX_INTERNAL;
+  if_set_index (ifp, IFINDEX_INTERNAL);
 
   return 0;
 }
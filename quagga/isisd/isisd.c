@@ -33,6 +33,7 @@
 #include "stream.h"
 #include "prefix.h"
 #include "table.h"
+#include "pqueue.h"
 
 #include "isisd/dict.h"
 #include "isisd/include-netbsd/iso.h"
@@ -129,7 +130,7 @@ isis_area_create ()
 #endif /* HAVE_IPV6 */
   area->circuit_list = list_new ();
   area->area_addrs = list_new ();
-  THREAD_TIMER_ON (master, area->t_tick, lsp_tick, area, 1);
+  area->lsp_expiry = lsp_expiry_init ();
   flags_initialize (&area->flags);
   /*
    * Default values
@@ -225,6 +226,9 @@ isis_area_destroy (struct vty *vty, const char *area_tag)
     }
   listnode_delete (isis->area_list, area);
   THREAD_TIMER_OFF (area->t_tick);
+  pqueue_delete (area->lsp_expiry);
+  isis_csnp_cache_flush (area, 1);
+  isis_csnp_cache_flush (area, 2);
   if (area->t_remove_aged)
     thread_cancel (area->t_remove_aged);
   THREAD_TIMER_OFF (area->t_lsp_refresh[0]);
@@ -983,6 +987,39 @@ DEFUN (show_database_detail,
   return CMD_SUCCESS;
 }
 
+DEFUN (show_isis_csnp_cache,
+       show_isis_csnp_cache_cmd,
+       "show isis csnp-cache",
+       SHOW_STR
+       "IS-IS information\n"
+       "IS-IS CSNP cache\n")
+{
+  struct listnode *node;
+  struct isis_area *area;
+  struct isis_csnp_cache *cache;
+  int level;
+
+  for (ALL_LIST_ELEMENTS_RO (isis->area_list, node, area))
+    {
+      vty_out (vty, "Area %s:%s", area->area_tag ? area->area_tag : "null",
+	       VTY_NEWLINE);
+      for (level = 0; level < ISIS_LEVELS; level++)
+	{
+	  cache = area->csnp_cache[level];
+	  if (cache)
+	    vty_out (vty, "  Level-%d: %d PDUs, %d LSP entries",
+		     level + 1, cache->pdu_count, cache->count);
+	  else
+	    vty_out (vty, "  Level-%d: not built", level + 1);
+	  vty_out (vty, ", %u hits, %u rebuilds%s",
+		   area->csnp_cache_hits[level],
+		   area->csnp_cache_rebuilds[level], VTY_NEWLINE);
+	}
+    }
+
+  return CMD_SUCCESS;
+}
+
 /* 
  * 'router isis' command 
  */
@@ -2096,6 +2133,7 @@ isis_init ()
   install_element (VIEW_NODE, &show_hostname_cmd);
   install_element (VIEW_NODE, &show_database_cmd);
   install_element (VIEW_NODE, &show_database_detail_cmd);
+  install_element (VIEW_NODE, &show_isis_csnp_cache_cmd);
 
   install_element (ENABLE_NODE, &show_clns_neighbors_cmd);
   install_element (ENABLE_NODE, &show_isis_neighbors_cmd);
@@ -2105,6 +2143,7 @@ isis_init ()
   install_element (ENABLE_NODE, &show_hostname_cmd);
   install_element (ENABLE_NODE, &show_database_cmd);
   install_element (ENABLE_NODE, &show_database_detail_cmd);
+  install_element (ENABLE_NODE, &show_isis_csnp_cache_cmd);
   install_element (ENABLE_NODE, &show_debugging_cmd);
 
   install_node (&debug_node, config_write_debug);
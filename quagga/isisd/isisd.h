@@ -91,7 +91,9 @@ struct isis_area
   unsigned int min_bcast_mtu;
   struct list *circuit_list;	/* IS-IS circuits */
   struct flags flags;
-  struct thread *t_tick;	/* LSP walker */
+  struct isis_csnp_cache *csnp_cache[ISIS_LEVELS];
+  struct pqueue *lsp_expiry;	/* LSPs by expiry time */
+  struct thread *t_tick;	/* LSP expiry */
   struct thread *t_remove_aged;
   int lsp_regenerate_pending[ISIS_LEVELS];
   struct thread *t_lsp_refresh[ISIS_LEVELS];
@@ -125,6 +127,9 @@ struct isis_area
 #endif				/* HAVE_IPV6 */
   /* Counters */
   u_int32_t circuit_state_changes;
+  /* CSNPs sent from the cache, and cache rebuilds */
+  u_int32_t csnp_cache_hits[ISIS_LEVELS];
+  u_int32_t csnp_cache_rebuilds[ISIS_LEVELS];
 
 #ifdef TOPOLOGY_GENERATE
   struct list *topology;
@@ -6,12 +6,17 @@
 #include "log.h"
 #include "zclient.h"
 #include "if.h"
+#include "hash.h"
+#include "linklist.h"
+#include "thread.h"
+#include "vty.h"
 
 #include "ldp.h"
 #include "ldp_struct.h"
 #include "ldp_entity.h"
 #include "mpls_mpls_impl.h"
 #include "mpls_socket_impl.h"
+#include "mpls_compare.h"
 
 #include "ldp_interface.h"
 #include "impl_mpls.h"
@@ -23,9 +28,37 @@
 static int label = 10000;
 static int request = -2;
 extern struct zclient *zclient;
-extern struct list *pending_out_segment;
-extern struct list *pending_ftn;
-extern struct list *pending_xc;
+
+/* out segments waiting for their index from zebra, keyed by request
+ * number, with the FTN and XC adds that have to wait for that index */
+static struct hash *pending_out;
+
+/* outgoing interface name by nexthop, flushed on any interface or
+ * address change */
+static struct hash *nexthop_ifname;
+
+struct nexthop_ifname_data
+{
+    struct in_addr addr;
+    char name[INTERFACE_NAMSIZ];
+};
+
+static struct
+{
+    unsigned long out_add;
+    unsigned long out_del;
+    unsigned long in_add;
+    unsigned long in_del;
+    unsigned long xc_add;
+    unsigned long xc_del;
+    unsigned long ftn_add;
+    unsigned long ftn_del;
+    unsigned long deferred;
+    unsigned long resolved;
+    unsigned long unknown;
+    unsigned long latency_total;	/* usec */
+    unsigned long latency_max;		/* usec */
+} mpls_stats;
 
 static int new_request()
 {
@@ -36,6 +69,163 @@ static int new_request()
   return request;
 }
 
+static unsigned int pending_out_hash_key(void *p)
+{
+  return (unsigned int)((struct pending_out_data *)p)->req;
+}
+
+static int pending_out_hash_cmp(void *a, void *b)
+{
+  return ((struct pending_out_data *)a)->req ==
+    ((struct pending_out_data *)b)->req;
+}
+
+static unsigned int nexthop_ifname_hash_key(void *p)
+{
+  return ((struct nexthop_ifname_data *)p)->addr.s_addr;
+}
+
+static int nexthop_ifname_hash_cmp(void *a, void *b)
+{
+  return ((struct nexthop_ifname_data *)a)->addr.s_addr ==
+    ((struct nexthop_ifname_data *)b)->addr.s_addr;
+}
+
+static void pending_data_free(void *m)
+{
+  XFREE(MTYPE_TMP, m);
+}
+
+static void pending_out_free(void *m)
+{
+  struct pending_out_data *p = m;
+
+  list_delete(p->ftn);
+  list_delete(p->xc);
+  XFREE(MTYPE_TMP, p);
+}
+
+void mpls_mpls_pending_init(void)
+{
+  pending_out = hash_create_size(4096, pending_out_hash_key,
+    pending_out_hash_cmp);
+  nexthop_ifname = hash_create(nexthop_ifname_hash_key,
+    nexthop_ifname_hash_cmp);
+}
+
+void mpls_mpls_nexthop_flush(void)
+{
+  hash_clean(nexthop_ifname, pending_data_free);
+}
+
+/* the pending entry for o, if its add is still waiting on zebra */
+static struct pending_out_data *pending_out_lookup(mpls_outsegment *o)
+{
+  struct pending_out_data key;
+  struct pending_out_data *p;
+
+  if (o->handle >= 0)
+    return NULL;
+
+  key.req = o->handle;
+  p = hash_lookup(pending_out, &key);
+  if (p && p->o == o)
+    return p;
+  return NULL;
+}
+
+/* fill in the outgoing interface of a segment, if o does not name one
+ * find the interface connected to the nexthop */
+static mpls_return_enum mpls_nexthop_ifname(mpls_outsegment *o,
+  struct zapi_mpls_out_segment *out)
+{
+  struct nexthop_ifname_data key;
+  struct nexthop_ifname_data *nh;
+  struct interface *ifp;
+
+  if (o->nexthop.type & MPLS_NH_IF) {
+    strncpy(out->nh.intf.name, o->nexthop.if_handle->name, INTERFACE_NAMSIZ);
+    SET_FLAG (out->nh.type, ZEBRA_NEXTHOP_IFNAME);
+    return MPLS_SUCCESS;
+  }
+
+  MPLS_ASSERT(o->nexthop.type & MPLS_NH_IP);
+
+  key.addr = out->nh.gw.ipv4;
+  if (!(nh = hash_lookup(nexthop_ifname, &key))) {
+    if (!(ifp = if_lookup_address(out->nh.gw.ipv4)))
+      return MPLS_FAILURE;
+
+    nh = XCALLOC(MTYPE_TMP, sizeof(struct nexthop_ifname_data));
+    nh->addr = key.addr;
+    strncpy(nh->name, ifp->name, INTERFACE_NAMSIZ);
+    hash_get(nexthop_ifname, nh, hash_alloc_intern);
+  }
+
+  strncpy(out->nh.intf.name, nh->name, INTERFACE_NAMSIZ);
+  SET_FLAG (out->nh.type, ZEBRA_NEXTHOP_IFNAME);
+  return MPLS_SUCCESS;
+}
+
+/* zebra has assigned an index to the out segment requested as req,
+ * send the FTN and XC adds that were waiting on it */
+void mpls_mpls_out_segment_resolved(int req, int index)
+{
+  struct pending_out_data key;
+  struct pending_out_data *p;
+  struct pending_ftn_data *fn;
+  struct pending_xc_data *x;
+  struct listnode *n;
+  struct timeval now;
+  unsigned long usec;
+
+  key.req = req;
+  if (!(p = hash_release(pending_out, &key))) {
+    mpls_stats.unknown++;
+    zlog_info("requested out segment %d not pending", req);
+    return;
+  }
+
+  quagga_gettime(QUAGGA_CLK_MONOTONIC, &now);
+  usec = (now.tv_sec - p->sent.tv_sec) * 1000000L +
+    (now.tv_usec - p->sent.tv_usec);
+  mpls_stats.resolved++;
+  mpls_stats.latency_total += usec;
+  if (usec > mpls_stats.latency_max)
+    mpls_stats.latency_max = usec;
+
+  p->o->handle = index;
+
+  for (ALL_LIST_ELEMENTS_RO(p->ftn, n, fn))
+    mpls_mpls_fec2out_add(fn->h, fn->f, fn->o);
+  for (ALL_LIST_ELEMENTS_RO(p->xc, n, x))
+    mpls_mpls_xconnect_add(x->h, x->i, x->o);
+
+  pending_out_free(p);
+}
+
+void mpls_mpls_show_stats(struct vty *vty)
+{
+  vty_out(vty, "Out segments: %lu added, %lu deleted, %lu pending%s",
+    mpls_stats.out_add, mpls_stats.out_del, pending_out->count, VTY_NEWLINE);
+  vty_out(vty, "In segments: %lu added, %lu deleted%s",
+    mpls_stats.in_add, mpls_stats.in_del, VTY_NEWLINE);
+  vty_out(vty, "Cross connects: %lu added, %lu deleted%s",
+    mpls_stats.xc_add, mpls_stats.xc_del, VTY_NEWLINE);
+  vty_out(vty, "FTNs: %lu added, %lu deleted%s",
+    mpls_stats.ftn_add, mpls_stats.ftn_del, VTY_NEWLINE);
+  vty_out(vty, "Deferred on out segment: %lu%s",
+    mpls_stats.deferred, VTY_NEWLINE);
+  vty_out(vty, "Out segment replies: %lu, %lu unknown%s",
+    mpls_stats.resolved, mpls_stats.unknown, VTY_NEWLINE);
+  if (mpls_stats.resolved)
+    vty_out(vty, "Reply latency: %lu usec average, %lu usec max%s",
+      mpls_stats.latency_total / mpls_stats.resolved,
+      mpls_stats.latency_max, VTY_NEWLINE);
+  vty_out(vty, "Cached nexthop interfaces: %lu%s",
+    nexthop_ifname->count, VTY_NEWLINE);
+}
+
 mpls_mpls_handle mpls_mpls_open(mpls_instance_handle user_data)
 {
   return MPLS_SUCCESS;
@@ -48,7 +238,7 @@ void mpls_mpls_close(mpls_mpls_handle handle)
 mpls_return_enum mpls_mpls_outsegment_add(mpls_mpls_handle handle, mpls_outsegment * o)
 {
   struct zapi_mpls_out_segment out;
-  struct interface *ifp;
+  struct pending_out_data *p;
 
   memset(&out, 0, sizeof(out));
 
@@ -64,27 +254,25 @@ mpls_return_enum mpls_mpls_outsegment_add(mpls_mpls_handle handle, mpls_outsegme
     out.nh.gw.ipv4.s_addr = htonl(o->nexthop.ip.u.ipv4);
   }
 
-  if (o->nexthop.type & MPLS_NH_IF) {
-    strcpy(out.nh.intf.name, o->nexthop.if_handle->name);
-    SET_FLAG (out.nh.type, ZEBRA_NEXTHOP_IFNAME);
-  } else {
-    MPLS_ASSERT(o->nexthop.type & MPLS_NH_IP);
-
-    ifp = if_lookup_address(out.nh.gw.ipv4);
-    if (ifp) {
-      strcpy(out.nh.intf.name, ifp->name);
-      SET_FLAG (out.nh.type, ZEBRA_NEXTHOP_IFNAME);
-    } else {
-      return MPLS_FAILURE;
-    }
+  if (mpls_nexthop_ifname(o, &out) != MPLS_SUCCESS) {
+    return MPLS_FAILURE;
   }
 
   /* store the request number as the handle, we'll need it when the
    * response from zebra arrives */
   o->handle = out.req;
 
-  listnode_add(pending_out_segment, o);
-
+  p = XCALLOC(MTYPE_TMP, sizeof(struct pending_out_data));
+  p->req = out.req;
+  p->o = o;
+  p->ftn = list_new();
+  p->ftn->del = pending_data_free;
+  p->xc = list_new();
+  p->xc->del = pending_data_free;
+  quagga_gettime(QUAGGA_CLK_MONOTONIC, &p->sent);
+  hash_get(pending_out, p, hash_alloc_intern);
+
+  mpls_stats.out_add++;
   zapi_mpls_out_segment_add(zclient, &out);
   return MPLS_SUCCESS;
 }
@@ -92,8 +280,7 @@ mpls_return_enum mpls_mpls_outsegment_add(mpls_mpls_handle handle, mpls_outsegme
 void mpls_mpls_outsegment_del(mpls_mpls_handle handle, mpls_outsegment * o)
 {
   struct zapi_mpls_out_segment out;
-  struct interface *ifp;
-  struct listnode *n;
+  struct pending_out_data *p;
 
   memset(&out, 0, sizeof(out));
 
@@ -108,28 +295,19 @@ void mpls_mpls_outsegment_del(mpls_mpls_handle handle, mpls_outsegment * o)
     out.nh.gw.ipv4.s_addr = htonl(o->nexthop.ip.u.ipv4);
   }
 
-  if (o->nexthop.type & MPLS_NH_IF) {
-    strncpy(out.nh.intf.name, o->nexthop.if_handle->name, INTERFACE_NAMSIZ);
-    SET_FLAG (out.nh.type, ZEBRA_NEXTHOP_IFNAME);
-  } else {
-    MPLS_ASSERT(o->nexthop.type & MPLS_NH_IP);
-
-    ifp = if_lookup_address(out.nh.gw.ipv4);
-    if (ifp) {
-      strcpy(out.nh.intf.name, ifp->name);
-      SET_FLAG (out.nh.type, ZEBRA_NEXTHOP_IFNAME);
-    } else {
-      return;
-    }
+  if (mpls_nexthop_ifname(o, &out) != MPLS_SUCCESS) {
+    return;
   }
 
-  /* the out segment might still be in the pending list, remove it */
-  n = listnode_lookup(pending_out_segment, o);
-  if (n) {
-    list_delete_node(pending_out_segment, n);
+  /* the out segment might still be pending, forget it along with any
+   * FTN or XC waiting on it */
+  if ((p = pending_out_lookup(o))) {
+    hash_release(pending_out, p);
+    pending_out_free(p);
   }
 
   out.index = o->handle;
+  mpls_stats.out_del++;
   zapi_mpls_out_segment_delete(zclient, &out);
 }
 
@@ -150,6 +328,7 @@ mpls_return_enum mpls_mpls_insegment_add(mpls_mpls_handle handle,
   api.label.type = ZEBRA_MPLS_LABEL_GEN;
   api.label.u.gen = i->label.u.gen;
 
+  mpls_stats.in_add++;
   zapi_mpls_in_segment_add(zclient, &api);
   return MPLS_SUCCESS;
 }
@@ -165,22 +344,23 @@ void mpls_mpls_insegment_del(mpls_mpls_handle handle, mpls_insegment * i)
   api.label.type = ZEBRA_MPLS_LABEL_GEN;
   api.label.u.gen = i->label.u.gen;
 
+  mpls_stats.in_del++;
   zapi_mpls_in_segment_delete(zclient, &api);
 }
 
 mpls_return_enum mpls_mpls_xconnect_add(mpls_mpls_handle handle, mpls_insegment * i, mpls_outsegment * o)
 {
   struct zapi_mpls_xc api;
-  struct listnode *n;
+  struct pending_out_data *p;
 
-  n = listnode_lookup(pending_out_segment, o);
-  if (n) {
+  if ((p = pending_out_lookup(o))) {
     struct pending_xc_data *x = XMALLOC(MTYPE_TMP,
 	sizeof(struct pending_xc_data));
     x->o = o;
     x->i = i;
     x->h = handle;
-    listnode_add(pending_xc, x);
+    listnode_add(p->xc, x);
+    mpls_stats.deferred++;
     return MPLS_SUCCESS;
   }
 
@@ -190,6 +370,7 @@ mpls_return_enum mpls_mpls_xconnect_add(mpls_mpls_handle handle, mpls_insegment
   api.in_label.u.gen = i->label.u.gen;
   api.out_index = o->handle;
 
+  mpls_stats.xc_add++;
   zapi_mpls_xc_add(zclient, &api);
   return MPLS_SUCCESS;
 }
@@ -198,15 +379,21 @@ void mpls_mpls_xconnect_del(mpls_mpls_handle handle, mpls_insegment * i,
   mpls_outsegment * o)
 {
   struct zapi_mpls_xc api;
+  struct pending_out_data *p;
+  struct pending_xc_data *x;
   struct listnode *n;
 
-  /* if its in the pending XC list, no need to send the delete because
-   * the add was never sent
+  /* if the XC is still waiting on the out segment, no need to send the
+   * delete because the add was never sent
    */
-  n = listnode_lookup(pending_xc, o);
-  if (n) {
-    list_delete_node(pending_xc, n);
-    return;
+  if ((p = pending_out_lookup(o))) {
+    for (ALL_LIST_ELEMENTS_RO(p->xc, n, x)) {
+      if (x->i == i) {
+        list_delete_node(p->xc, n);
+        XFREE(MTYPE_TMP, x);
+        return;
+      }
+    }
   }
 
   api.owner = ZEBRA_ROUTE_LDP;
@@ -215,6 +402,7 @@ void mpls_mpls_xconnect_del(mpls_mpls_handle handle, mpls_insegment * i,
   api.in_label.u.gen = i->label.u.gen;
   api.out_index = o->handle;
 
+  mpls_stats.xc_del++;
   zapi_mpls_xc_delete(zclient, &api);
 }
 
@@ -222,17 +410,17 @@ mpls_return_enum mpls_mpls_fec2out_add(mpls_mpls_handle handle, mpls_fec * f,
   mpls_outsegment * o)
 {
   struct zapi_mpls_ftn api;
-  struct listnode *n;
+  struct pending_out_data *p;
   int retval;
 
-  n = listnode_lookup(pending_out_segment, o);
-  if (n) {
+  if ((p = pending_out_lookup(o))) {
     struct pending_ftn_data *fn = XMALLOC(MTYPE_TMP,
 	sizeof(struct pending_ftn_data));
     fn->o = o;
     fn->f = f;
     fn->h = handle;
-    listnode_add(pending_ftn, fn);
+    listnode_add(p->ftn, fn);
+    mpls_stats.deferred++;
     return MPLS_SUCCESS;
   }
 
@@ -242,6 +430,7 @@ mpls_return_enum mpls_mpls_fec2out_add(mpls_mpls_handle handle, mpls_fec * f,
   api.fec.owner = -1;
   api.owner = ZEBRA_ROUTE_LDP;
 
+  mpls_stats.ftn_add++;
   retval = zapi_mpls_ftn_add(zclient, &api);
   return MPLS_SUCCESS;
 }
@@ -250,16 +439,22 @@ void mpls_mpls_fec2out_del(mpls_mpls_handle handle, mpls_fec * f,
   mpls_outsegment * o)
 {
   struct zapi_mpls_ftn api;
+  struct pending_out_data *p;
+  struct pending_ftn_data *fn;
   struct listnode *n;
   int retval;
 
-  /* if its in the pending FTN list, no need to send the delete because
-   * the add was never sent
+  /* if the FTN is still waiting on the out segment, no need to send the
+   * delete because the add was never sent
    */
-  n = listnode_lookup(pending_ftn, o);
-  if (n) {
-    list_delete_node(pending_ftn, n);
-    return;
+  if ((p = pending_out_lookup(o))) {
+    for (ALL_LIST_ELEMENTS_RO(p->ftn, n, fn)) {
+      if (!mpls_fec_compare(fn->f, f)) {
+        list_delete_node(p->ftn, n);
+        XFREE(MTYPE_TMP, fn);
+        return;
+      }
+    }
   }
 
   api.fec.type = ZEBRA_MPLS_FEC_IPV4;
@@ -268,6 +463,7 @@ void mpls_mpls_fec2out_del(mpls_mpls_handle handle, mpls_fec * f,
   api.fec.owner = -1;
   api.owner = ZEBRA_ROUTE_LDP;
 
+  mpls_stats.ftn_del++;
   retval = zapi_mpls_ftn_delete(zclient, &api);
 }
 
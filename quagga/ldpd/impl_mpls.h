@@ -3,6 +3,17 @@
 
 #include "ldp_interface.h"
 
+struct vty;
+
+struct pending_out_data
+{
+    int req;
+    mpls_outsegment *o;
+    struct timeval sent;
+    struct list *ftn;
+    struct list *xc;
+};
+
 struct pending_ftn_data
 {
     mpls_mpls_handle h;
@@ -19,4 +30,9 @@ struct pending_xc_data
 
 int do_mpls_labelspace(struct ldp_interface *li);
 
+void mpls_mpls_pending_init(void);
+void mpls_mpls_out_segment_resolved(int req, int index);
+void mpls_mpls_nexthop_flush(void);
+void mpls_mpls_show_stats(struct vty *vty);
+
 #endif
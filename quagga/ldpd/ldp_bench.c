@@ -0,0 +1,139 @@
+/*
+ *  Synthetic benchmark for the LDP global tables.
+ *
+ *  Creates N FECs and M sessions, propagates a mapping for every
+ *  FEC to every session, walks the global tables by index the way the
+ *  MIB and vty code does, then withdraws all of the mappings.
+ *
+ *  usage: ldp_bench [fecs] [sessions]
+ *
+ *  This software is covered under the LGPL, for more
+ *  info check out http://www.gnu.org/copyleft/lgpl.html
+ */
+
+#include <zebra.h>
+#include "thread.h"
+#include "privs.h"
+
+#include "ldp_struct.h"
+#include "ldp_global.h"
+#include "ldp_session.h"
+#include "ldp_attr.h"
+#include "ldp_fec.h"
+
+#include "mpls_mm_impl.h"
+
+/* ldp_main.c normally provides these for the porting layer */
+struct thread_master *master;
+struct zebra_privs_t ldpd_privs;
+
+static struct timeval bench_start;
+
+static void bench_begin(void)
+{
+  gettimeofday(&bench_start, NULL);
+}
+
+static void bench_end(const char *what, int count)
+{
+  struct timeval now;
+  double usec;
+
+  gettimeofday(&now, NULL);
+  usec = (now.tv_sec - bench_start.tv_sec) * 1000000.0 +
+    (now.tv_usec - bench_start.tv_usec);
+  printf("%-12s %9d ops %10.0f usec %8.3f usec/op\n", what, count, usec,
+    count ? usec / count : 0.0);
+}
+
+int main(int argc, char **argv)
+{
+  int nfec = 1000;
+  int nses = 16;
+  ldp_global *g;
+  ldp_session **ses;
+  ldp_fec **fec;
+  ldp_attr *a;
+  ldp_session *s;
+  ldp_fec *f;
+  mpls_fec info;
+  uint32_t index;
+  int count;
+  int i, j;
+
+  if (argc > 1)
+    nfec = atoi(argv[1]);
+  if (argc > 2)
+    nses = atoi(argv[2]);
+  if (nfec <= 0 || nfec > 65536 || nses <= 0) {
+    fprintf(stderr, "usage: %s [fecs(1-65536)] [sessions]\n", argv[0]);
+    return 1;
+  }
+
+  master = thread_master_create();
+  g = ldp_global_create(NULL);
+
+  ses = mpls_malloc(sizeof(ldp_session *) * nses);
+  fec = mpls_malloc(sizeof(ldp_fec *) * nfec);
+
+  bench_begin();
+  for (j = 0; j < nses; j++) {
+    ses[j] = ldp_session_create();
+    ses[j]->state = LDP_STATE_OPERATIONAL;
+    _ldp_global_add_session(g, ses[j]);
+  }
+  memset(&info, 0, sizeof(info));
+  info.type = MPLS_FEC_PREFIX;
+  info.u.prefix.network.type = MPLS_FAMILY_IPV4;
+  info.u.prefix.length = 24;
+  for (i = 0; i < nfec; i++) {
+    info.u.prefix.network.u.ipv4 = 0x0a000000 | (i << 8);
+    fec[i] = ldp_fec_create(g, &info);
+  }
+  bench_end("create", nses + nfec);
+
+  /* a label mapping for every FEC towards every session */
+  bench_begin();
+  for (i = 0; i < nfec; i++) {
+    for (j = 0; j < nses; j++) {
+      a = ldp_attr_create(g, &fec[i]->info);
+      a->state = LDP_LSP_STATE_MAP_SENT;
+      ldp_attr_insert_upstream2(g, ses[j], a, fec[i]);
+    }
+  }
+  bench_end("propagate", nfec * nses);
+
+  /* walk every table by index, as the MIB getnext handlers do */
+  count = 0;
+  bench_begin();
+  index = 0;
+  while (ldp_global_find_attr_index(g, ++index, &a) != MPLS_END_OF_LIST)
+    count++;
+  index = 0;
+  while (ldp_global_find_session_index(g, ++index, &s) != MPLS_END_OF_LIST)
+    count++;
+  index = 0;
+  while (ldp_global_find_fec_index(g, ++index, &f) != MPLS_END_OF_LIST)
+    count++;
+  bench_end("walk", count);
+
+  bench_begin();
+  for (i = 0; i < nfec; i++) {
+    for (j = 0; j < nses; j++) {
+      a = ldp_attr_find_upstream_state2(g, ses[j], fec[i],
+        LDP_LSP_STATE_MAP_SENT);
+      /* the last withdraw releases the FEC */
+      ldp_attr_delete_upstream(g, ses[j], a);
+    }
+  }
+  bench_end("withdraw", nfec * nses);
+
+  for (j = 0; j < nses; j++) {
+    _ldp_global_del_session(g, ses[j]);
+  }
+
+  mpls_free(fec);
+  mpls_free(ses);
+  ldp_global_delete(g);
+  return 0;
+}
@@ -1963,6 +1963,9 @@ mpls_return_enum ldp_cfg_session_get(mpls_cfg_handle handle, ldp_session * s,
   if (flag & LDP_SESSION_CFG_MESG_RX) {
     s->mesg_rx = session->mesg_rx;
   }
+  if (flag & LDP_SESSION_CFG_PDU_TX) {
+    s->pdu_tx = session->pdu_tx;
+  }
   if (flag & LDP_SESSION_CFG_LOCAL_NAME) {
     if (mpls_socket_handle_verify(global->socket_handle,
       session->socket) == MPLS_BOOL_TRUE) {
@@ -127,6 +127,7 @@
 #define LDP_SESSION_CFG_OPER_UP				0x00200000
 #define LDP_SESSION_CFG_LOCAL_NAME			0x00400000
 #define LDP_SESSION_CFG_REMOTE_NAME			0x00800000
+#define LDP_SESSION_CFG_PDU_TX				0x01000000
 
 #define LDP_SESSION_RADDR_CFG_ADDR			0x00000002
 #define LDP_SESSION_RADDR_CFG_INDEX			0x00000004
@@ -47,6 +47,36 @@
 #include "mpls_mpls_impl.h"
 #endif
 
+/*
+ * every global list is also kept in a tree keyed by the object index so
+ * the SNMP/vty walkers can find an object without scanning the list,
+ * the lists themselves stay sorted by index for ordered iteration
+ */
+
+static void ldp_global_index_add(mpls_tree_handle tree, uint32_t index,
+  void *obj)
+{
+  if (mpls_tree_insert(tree, index, 32, obj) != MPLS_SUCCESS) {
+    LDP_PRINT(NULL, "ldp_global_index_add: unable to index %d", index);
+  }
+}
+
+static void ldp_global_index_del(mpls_tree_handle tree, uint32_t index)
+{
+  void *obj;
+
+  mpls_tree_remove(tree, index, 32, &obj);
+}
+
+static mpls_return_enum ldp_global_index_get(mpls_tree_handle tree,
+  uint32_t index, void **obj)
+{
+  if (mpls_tree_get(tree, index, 32, obj) != MPLS_SUCCESS || *obj == NULL) {
+    return MPLS_FAILURE;
+  }
+  return MPLS_SUCCESS;
+}
+
 ldp_global *ldp_global_create(mpls_instance_handle data)
 {
   ldp_global *g = (ldp_global *) mpls_malloc(sizeof(ldp_global));
@@ -101,6 +131,20 @@ ldp_global *ldp_global_create(mpls_instance_handle data)
     g->addr_tree = mpls_tree_create(32);
     g->fec_tree = mpls_tree_create(32);
 
+    g->outlabel_index = mpls_tree_create(32);
+    g->resource_index = mpls_tree_create(32);
+    g->hop_list_index = mpls_tree_create(32);
+    g->inlabel_index = mpls_tree_create(32);
+    g->session_index = mpls_tree_create(32);
+    g->tunnel_index = mpls_tree_create(32);
+    g->entity_index = mpls_tree_create(32);
+    g->peer_index = mpls_tree_create(32);
+    g->attr_index = mpls_tree_create(32);
+    g->addr_index = mpls_tree_create(32);
+    g->adj_index = mpls_tree_create(32);
+    g->iff_index = mpls_tree_create(32);
+    g->fec_index = mpls_tree_create(32);
+
     mpls_lock_release(g->global_lock);
 
     LDP_EXIT(g->user_data, "ldp_global_create");
@@ -418,6 +462,20 @@ mpls_return_enum ldp_global_delete(ldp_global * g)
     mpls_tree_delete(g->addr_tree);
     mpls_tree_delete(g->fec_tree);
 
+    mpls_tree_delete(g->outlabel_index);
+    mpls_tree_delete(g->resource_index);
+    mpls_tree_delete(g->hop_list_index);
+    mpls_tree_delete(g->inlabel_index);
+    mpls_tree_delete(g->session_index);
+    mpls_tree_delete(g->tunnel_index);
+    mpls_tree_delete(g->entity_index);
+    mpls_tree_delete(g->peer_index);
+    mpls_tree_delete(g->attr_index);
+    mpls_tree_delete(g->addr_index);
+    mpls_tree_delete(g->adj_index);
+    mpls_tree_delete(g->iff_index);
+    mpls_tree_delete(g->fec_index);
+
     mpls_lock_delete(g->global_lock);
     LDP_PRINT(g->user_data, "global delete");
     mpls_free(g);
@@ -427,47 +485,33 @@ mpls_return_enum ldp_global_delete(ldp_global * g)
 
 void _ldp_global_add_attr(ldp_global * g, ldp_attr * a)
 {
-  ldp_attr *ap = NULL;
 
   MPLS_ASSERT(g && a);
-  ap = MPLS_LIST_HEAD(&g->attr);
-  while (ap != NULL) {
-    if (ap->index > a->index) {
-      MPLS_LIST_INSERT_BEFORE(&g->attr, ap, a, _global);
-      return;
-    }
-    ap = MPLS_LIST_NEXT(&g->attr, ap, _global);
-  }
-  MPLS_LIST_ADD_TAIL(&g->attr, a, _global, ldp_attr);
+  MPLS_LIST_ADD_SORTED(&g->attr, a, _global, ldp_attr, index);
+  ldp_global_index_add(g->attr_index, a->index, a);
 }
 
 void _ldp_global_del_attr(ldp_global * g, ldp_attr * a)
 {
   MPLS_ASSERT(g && a);
   MPLS_LIST_REMOVE(&g->attr, a, _global);
+  ldp_global_index_del(g->attr_index, a->index);
 }
 
 void _ldp_global_add_peer(ldp_global * g, ldp_peer * p)
 {
-  ldp_peer *pp = NULL;
 
   MPLS_ASSERT(g && p);
   MPLS_REFCNT_HOLD(p);
-  pp = MPLS_LIST_HEAD(&g->peer);
-  while (pp != NULL) {
-    if (pp->index > p->index) {
-      MPLS_LIST_INSERT_BEFORE(&g->peer, pp, p, _global);
-      return;
-    }
-    pp = MPLS_LIST_NEXT(&g->peer, pp, _global);
-  }
-  MPLS_LIST_ADD_TAIL(&g->peer, p, _global, ldp_peer);
+  MPLS_LIST_ADD_SORTED(&g->peer, p, _global, ldp_peer, index);
+  ldp_global_index_add(g->peer_index, p->index, p);
 }
 
 void _ldp_global_del_peer(ldp_global * g, ldp_peer * p)
 {
   MPLS_ASSERT(g && p);
   MPLS_LIST_REMOVE(&g->peer, p, _global);
+  ldp_global_index_del(g->peer_index, p->index);
   MPLS_REFCNT_RELEASE(p, ldp_peer_delete);
 }
 
@@ -480,112 +524,76 @@ void _ldp_global_del_peer(ldp_global * g, ldp_peer * p)
 
 void _ldp_global_add_if(ldp_global * g, ldp_if * i)
 {
-  ldp_if *ip = NULL;
 
   MPLS_ASSERT(g && i);
-  ip = MPLS_LIST_HEAD(&g->iff);
-  while (ip != NULL) {
-    if (ip->index > i->index) {
-      MPLS_LIST_INSERT_BEFORE(&g->iff, ip, i, _global);
-      return;
-    }
-    ip = MPLS_LIST_NEXT(&g->iff, ip, _global);
-  }
-  MPLS_LIST_ADD_TAIL(&g->iff, i, _global, ldp_if);
+  MPLS_LIST_ADD_SORTED(&g->iff, i, _global, ldp_if, index);
+  ldp_global_index_add(g->iff_index, i->index, i);
 }
 
 void _ldp_global_del_if(ldp_global * g, ldp_if * i)
 {
   MPLS_ASSERT(g && i);
   MPLS_LIST_REMOVE(&g->iff, i, _global);
+  ldp_global_index_del(g->iff_index, i->index);
 }
 
 void _ldp_global_add_addr(ldp_global * g, ldp_addr * a)
 {
-  ldp_addr *ap = NULL;
 
   MPLS_ASSERT(g && a);
-  ap = MPLS_LIST_HEAD(&g->addr);
-  while (ap != NULL) {
-    if (ap->index > a->index) {
-      MPLS_LIST_INSERT_BEFORE(&g->addr, ap, a, _global);
-      return;
-    }
-    ap = MPLS_LIST_NEXT(&g->addr, ap, _global);
-  }
-  MPLS_LIST_ADD_TAIL(&g->addr, a, _global, ldp_addr);
+  MPLS_LIST_ADD_SORTED(&g->addr, a, _global, ldp_addr, index);
+  ldp_global_index_add(g->addr_index, a->index, a);
 }
 
 void _ldp_global_del_addr(ldp_global * g, ldp_addr * a)
 {
   MPLS_ASSERT(g && a);
   MPLS_LIST_REMOVE(&g->addr, a, _global);
+  ldp_global_index_del(g->addr_index, a->index);
 }
 
 void _ldp_global_add_adj(ldp_global * g, ldp_adj * a)
 {
-  ldp_adj *ap = NULL;
 
   MPLS_ASSERT(g && a);
   MPLS_REFCNT_HOLD(a);
-  ap = MPLS_LIST_HEAD(&g->adj);
-  while (ap != NULL) {
-    if (ap->index > a->index) {
-      MPLS_LIST_INSERT_BEFORE(&g->adj, ap, a, _global);
-      return;
-    }
-    ap = MPLS_LIST_NEXT(&g->adj, ap, _global);
-  }
-  MPLS_LIST_ADD_TAIL(&g->adj, a, _global, ldp_adj);
+  MPLS_LIST_ADD_SORTED(&g->adj, a, _global, ldp_adj, index);
+  ldp_global_index_add(g->adj_index, a->index, a);
 }
 
 void _ldp_global_del_adj(ldp_global * g, ldp_adj * a)
 {
   MPLS_ASSERT(g && a);
   MPLS_LIST_REMOVE(&g->adj, a, _global);
+  ldp_global_index_del(g->adj_index, a->index);
   MPLS_REFCNT_RELEASE(a, ldp_adj_delete);
 }
 
 void _ldp_global_add_entity(ldp_global * g, ldp_entity * e)
 {
-  ldp_entity *ep = NULL;
 
   MPLS_ASSERT(g && e);
   MPLS_REFCNT_HOLD(e);
-  ep = MPLS_LIST_HEAD(&g->entity);
-  while (ep != NULL) {
-    if (ep->index > e->index) {
-      MPLS_LIST_INSERT_BEFORE(&g->entity, ep, e, _global);
-      return;
-    }
-    ep = MPLS_LIST_NEXT(&g->entity, ep, _global);
-  }
-  MPLS_LIST_ADD_TAIL(&g->entity, e, _global, ldp_entity);
+  MPLS_LIST_ADD_SORTED(&g->entity, e, _global, ldp_entity, index);
+  ldp_global_index_add(g->entity_index, e->index, e);
 }
 
 void _ldp_global_del_entity(ldp_global * g, ldp_entity * e)
 {
   MPLS_ASSERT(g && e);
   MPLS_LIST_REMOVE(&g->entity, e, _global);
+  ldp_global_index_del(g->entity_index, e->index);
   MPLS_REFCNT_RELEASE(e, ldp_entity_delete);
 }
 
 void _ldp_global_add_session(ldp_global * g, ldp_session * s)
 {
-  ldp_session *sp = NULL;
 
   MPLS_ASSERT(g && s);
   MPLS_REFCNT_HOLD(s);
   s->on_global = MPLS_BOOL_TRUE;
-  sp = MPLS_LIST_HEAD(&g->session);
-  while (sp != NULL) {
-    if (sp->index > s->index) {
-      MPLS_LIST_INSERT_BEFORE(&g->session, sp, s, _global);
-      return;
-    }
-    sp = MPLS_LIST_NEXT(&g->session, sp, _global);
-  }
-  MPLS_LIST_ADD_TAIL(&g->session, s, _global, ldp_session);
+  MPLS_LIST_ADD_SORTED(&g->session, s, _global, ldp_session, index);
+  ldp_global_index_add(g->session_index, s->index, s);
 }
 
 void _ldp_global_del_session(ldp_global * g, ldp_session * s)
@@ -593,13 +601,13 @@ void _ldp_global_del_session(ldp_global * g, ldp_session * s)
   MPLS_ASSERT(g && s);
   MPLS_ASSERT(s->on_global == MPLS_BOOL_TRUE);
   MPLS_LIST_REMOVE(&g->session, s, _global);
+  ldp_global_index_del(g->session_index, s->index);
   s->on_global = MPLS_BOOL_FALSE;
   MPLS_REFCNT_RELEASE(s, ldp_session_delete);
 }
 
 mpls_return_enum _ldp_global_add_inlabel(ldp_global * g, ldp_inlabel * i)
 {
-  ldp_inlabel *ip = NULL;
   mpls_return_enum result;
 
   MPLS_ASSERT(g && i);
@@ -622,15 +630,8 @@ mpls_return_enum _ldp_global_add_inlabel(ldp_global * g, ldp_inlabel * i)
     return result;
   }
 
-  ip = MPLS_LIST_HEAD(&g->inlabel);
-  while (ip != NULL) {
-    if (ip->index > i->index) {
-      MPLS_LIST_INSERT_BEFORE(&g->inlabel, ip, i, _global);
-      return MPLS_SUCCESS;
-    }
-    ip = MPLS_LIST_NEXT(&g->inlabel, ip, _global);
-  }
-  MPLS_LIST_ADD_TAIL(&g->inlabel, i, _global, ldp_inlabel);
+  MPLS_LIST_ADD_SORTED(&g->inlabel, i, _global, ldp_inlabel, index);
+  ldp_global_index_add(g->inlabel_index, i->index, i);
   return MPLS_SUCCESS;
 }
 
@@ -648,12 +649,12 @@ mpls_return_enum _ldp_global_del_inlabel(ldp_global * g, ldp_inlabel * i)
   mpls_mpls_insegment_del(g->mpls_handle, &i->info);
 #endif
   MPLS_LIST_REMOVE(&g->inlabel, i, _global);
+  ldp_global_index_del(g->inlabel_index, i->index);
   return MPLS_SUCCESS;
 }
 
 mpls_return_enum _ldp_global_add_outlabel(ldp_global * g, ldp_outlabel * o)
 {
-  ldp_outlabel *op = NULL;
   mpls_return_enum result;
 
   MPLS_ASSERT(g && o);
@@ -676,15 +677,8 @@ mpls_return_enum _ldp_global_add_outlabel(ldp_global * g, ldp_outlabel * o)
   }
 
   o->switching = MPLS_BOOL_TRUE;
-  op = MPLS_LIST_HEAD(&g->outlabel);
-  while (op != NULL) {
-    if (op->index > o->index) {
-      MPLS_LIST_INSERT_BEFORE(&g->outlabel, op, o, _global);
-      return MPLS_SUCCESS;
-    }
-    op = MPLS_LIST_NEXT(&g->outlabel, op, _global);
-  }
-  MPLS_LIST_ADD_TAIL(&g->outlabel, o, _global, ldp_outlabel);
+  MPLS_LIST_ADD_SORTED(&g->outlabel, o, _global, ldp_outlabel, index);
+  ldp_global_index_add(g->outlabel_index, o->index, o);
   return MPLS_SUCCESS;
 }
 
@@ -708,6 +702,7 @@ LDP_PRINT(g->user_data,"Here 3");
   MPLS_ASSERT(o->merge_count == 0);
 LDP_PRINT(g->user_data,"Here 4");
   MPLS_LIST_REMOVE(&g->outlabel, o, _global);
+  ldp_global_index_del(g->outlabel_index, o->index);
 LDP_PRINT(g->user_data,"Here 5");
   return MPLS_SUCCESS;
 }
@@ -728,13 +723,9 @@ mpls_return_enum ldp_global_find_attr_index(ldp_global * g, uint32_t index,
       *attr = NULL;
     }
 
-    a = MPLS_LIST_HEAD(&g->attr);
-    while (a != NULL) {
-      if (a->index == index) {
-        *attr = a;
-        return MPLS_SUCCESS;
-      }
-      a = MPLS_LIST_NEXT(&g->attr, a, _global);
+    if (ldp_global_index_get(g->attr_index, index, (void **)attr) ==
+      MPLS_SUCCESS) {
+      return MPLS_SUCCESS;
     }
   }
   *attr = NULL;
@@ -757,13 +748,9 @@ mpls_return_enum ldp_global_find_session_index(ldp_global * g, uint32_t index,
       return MPLS_END_OF_LIST;
     }
 
-    s = MPLS_LIST_HEAD(&g->session);
-    while (s != NULL) {
-      if (s->index == index) {
-        *session = s;
-        return MPLS_SUCCESS;
-      }
-      s = MPLS_LIST_NEXT(&g->session, s, _global);
+    if (ldp_global_index_get(g->session_index, index, (void **)session) ==
+      MPLS_SUCCESS) {
+      return MPLS_SUCCESS;
     }
   }
   *session = NULL;
@@ -786,13 +773,9 @@ mpls_return_enum ldp_global_find_inlabel_index(ldp_global * g, uint32_t index,
       return MPLS_END_OF_LIST;
     }
 
-    i = MPLS_LIST_HEAD(&g->inlabel);
-    while (i != NULL) {
-      if (i->index == index) {
-        *inlabel = i;
-        return MPLS_SUCCESS;
-      }
-      i = MPLS_LIST_NEXT(&g->inlabel, i, _global);
+    if (ldp_global_index_get(g->inlabel_index, index, (void **)inlabel) ==
+      MPLS_SUCCESS) {
+      return MPLS_SUCCESS;
     }
   }
   *inlabel = NULL;
@@ -815,13 +798,9 @@ mpls_return_enum ldp_global_find_outlabel_index(ldp_global * g, uint32_t index,
       return MPLS_END_OF_LIST;
     }
 
-    o = MPLS_LIST_HEAD(&g->outlabel);
-    while (o != NULL) {
-      if (o->index == index) {
-        *outlabel = o;
-        return MPLS_SUCCESS;
-      }
-      o = MPLS_LIST_NEXT(&g->outlabel, o, _global);
+    if (ldp_global_index_get(g->outlabel_index, index, (void **)outlabel) ==
+      MPLS_SUCCESS) {
+      return MPLS_SUCCESS;
     }
   }
   *outlabel = NULL;
@@ -860,13 +839,9 @@ mpls_return_enum ldp_global_find_entity_index(ldp_global * g, uint32_t index,
       return MPLS_END_OF_LIST;
     }
 
-    e = MPLS_LIST_HEAD(&g->entity);
-    while (e != NULL) {
-      if (e->index == index) {
-        *entity = e;
-        return MPLS_SUCCESS;
-      }
-      e = MPLS_LIST_NEXT(&g->entity, e, _global);
+    if (ldp_global_index_get(g->entity_index, index, (void **)entity) ==
+      MPLS_SUCCESS) {
+      return MPLS_SUCCESS;
     }
   }
   *entity = NULL;
@@ -911,13 +886,9 @@ mpls_return_enum ldp_global_find_adj_index(ldp_global * g, uint32_t index,
       *adj = NULL;
     }
 
-    a = MPLS_LIST_HEAD(&g->adj);
-    while (a != NULL) {
-      if (a->index == index) {
-        *adj = a;
-        return MPLS_SUCCESS;
-      }
-      a = MPLS_LIST_NEXT(&g->adj, a, _global);
+    if (ldp_global_index_get(g->adj_index, index, (void **)adj) ==
+      MPLS_SUCCESS) {
+      return MPLS_SUCCESS;
     }
   }
   *adj = NULL;
@@ -939,13 +910,9 @@ mpls_return_enum ldp_global_find_peer_index(ldp_global * g, uint32_t index,
       return MPLS_END_OF_LIST;
     }
 
-    p = MPLS_LIST_HEAD(&g->peer);
-    while (p != NULL) {
-      if (p->index == index) {
-        *peer = p;
-        return MPLS_SUCCESS;
-      }
-      p = MPLS_LIST_NEXT(&g->peer, p, _global);
+    if (ldp_global_index_get(g->peer_index, index, (void **)peer) ==
+      MPLS_SUCCESS) {
+      return MPLS_SUCCESS;
     }
   }
   *peer = NULL;
@@ -967,13 +934,9 @@ mpls_return_enum ldp_global_find_fec_index(ldp_global * g, uint32_t index,
       return MPLS_END_OF_LIST;
     }
 
-    f = MPLS_LIST_HEAD(&g->fec);
-    while (f != NULL) {
-      if (f->index == index) {
-        *fec = f;
-        return MPLS_SUCCESS;
-      }
-      f = MPLS_LIST_NEXT(&g->fec, f, _global);
+    if (ldp_global_index_get(g->fec_index, index, (void **)fec) ==
+      MPLS_SUCCESS) {
+      return MPLS_SUCCESS;
     }
   }
   *fec = NULL;
@@ -1014,13 +977,9 @@ mpls_return_enum ldp_global_find_addr_index(ldp_global * g, uint32_t index,
       return MPLS_END_OF_LIST;
     }
 
-    a = MPLS_LIST_HEAD(&g->addr);
-    while (a != NULL) {
-      if (a->index == index) {
-        *addr = a;
-        return MPLS_SUCCESS;
-      }
-      a = MPLS_LIST_NEXT(&g->addr, a, _global);
+    if (ldp_global_index_get(g->addr_index, index, (void **)addr) ==
+      MPLS_SUCCESS) {
+      return MPLS_SUCCESS;
     }
   }
   *addr = NULL;
@@ -1043,13 +1002,9 @@ mpls_return_enum ldp_global_find_if_index(ldp_global * g, uint32_t index,
       return MPLS_END_OF_LIST;
     }
 
-    i = MPLS_LIST_HEAD(&g->iff);
-    while (i != NULL) {
-      if (i->index == index) {
-        *iff = i;
-        return MPLS_SUCCESS;
-      }
-      i = MPLS_LIST_NEXT(&g->iff, i, _global);
+    if (ldp_global_index_get(g->iff_index, index, (void **)iff) ==
+      MPLS_SUCCESS) {
+      return MPLS_SUCCESS;
     }
   }
   *iff = NULL;
@@ -1102,13 +1057,9 @@ mpls_return_enum ldp_global_find_tunnel_index(ldp_global * g, uint32_t index,
       return MPLS_END_OF_LIST;
     }
 
-    t = MPLS_LIST_HEAD(&g->tunnel);
-    while (t != NULL) {
-      if (t->index == index) {
-        *tunnel = t;
-        return MPLS_SUCCESS;
-      }
-      t = MPLS_LIST_NEXT(&g->tunnel, t, _global);
+    if (ldp_global_index_get(g->tunnel_index, index, (void **)tunnel) ==
+      MPLS_SUCCESS) {
+      return MPLS_SUCCESS;
     }
   }
   *tunnel = NULL;
@@ -1130,13 +1081,9 @@ mpls_return_enum ldp_global_find_resource_index(ldp_global * g, uint32_t index,
       return MPLS_END_OF_LIST;
     }
 
-    r = MPLS_LIST_HEAD(&g->resource);
-    while (r != NULL) {
-      if (r->index == index) {
-        *resource = r;
-        return MPLS_SUCCESS;
-      }
-      r = MPLS_LIST_NEXT(&g->resource, r, _global);
+    if (ldp_global_index_get(g->resource_index, index, (void **)resource) ==
+      MPLS_SUCCESS) {
+      return MPLS_SUCCESS;
     }
   }
   *resource = NULL;
@@ -1158,13 +1105,9 @@ mpls_return_enum ldp_global_find_hop_list_index(ldp_global * g, uint32_t index,
       return MPLS_END_OF_LIST;
     }
 
-    h = MPLS_LIST_HEAD(&g->hop_list);
-    while (h != NULL) {
-      if (h->index == index) {
-        *hop_list = h;
-        return MPLS_SUCCESS;
-      }
-      h = MPLS_LIST_NEXT(&g->hop_list, h, _global);
+    if (ldp_global_index_get(g->hop_list_index, index, (void **)hop_list) ==
+      MPLS_SUCCESS) {
+      return MPLS_SUCCESS;
     }
   }
   *hop_list = NULL;
@@ -1173,79 +1116,57 @@ mpls_return_enum ldp_global_find_hop_list_index(ldp_global * g, uint32_t index,
 
 void _ldp_global_add_tunnel(ldp_global * g, ldp_tunnel * t)
 {
-  ldp_tunnel *tp = NULL;
 
   MPLS_ASSERT(g && t);
   MPLS_REFCNT_HOLD(t);
-  tp = MPLS_LIST_HEAD(&g->tunnel);
-  while (tp != NULL) {
-    if (tp->index > t->index) {
-      MPLS_LIST_INSERT_BEFORE(&g->tunnel, tp, t, _global);
-      return;
-    }
-    tp = MPLS_LIST_NEXT(&g->tunnel, tp, _global);
-  }
-  MPLS_LIST_ADD_TAIL(&g->tunnel, t, _global, ldp_tunnel);
+  MPLS_LIST_ADD_SORTED(&g->tunnel, t, _global, ldp_tunnel, index);
+  ldp_global_index_add(g->tunnel_index, t->index, t);
 }
 
 void _ldp_global_del_tunnel(ldp_global * g, ldp_tunnel * t)
 {
   MPLS_ASSERT(g && t);
   MPLS_LIST_REMOVE(&g->tunnel, t, _global);
+  ldp_global_index_del(g->tunnel_index, t->index);
   MPLS_REFCNT_RELEASE(t, ldp_tunnel_delete);
 }
 
 void _ldp_global_add_resource(ldp_global * g, ldp_resource * r)
 {
-  ldp_resource *rp = NULL;
 
   MPLS_ASSERT(g && r);
   MPLS_REFCNT_HOLD(r);
-  rp = MPLS_LIST_HEAD(&g->resource);
-  while (rp != NULL) {
-    if (rp->index > r->index) {
-      MPLS_LIST_INSERT_BEFORE(&g->resource, rp, r, _global);
-      return;
-    }
-    rp = MPLS_LIST_NEXT(&g->resource, rp, _global);
-  }
-  MPLS_LIST_ADD_TAIL(&g->resource, r, _global, ldp_resource);
+  MPLS_LIST_ADD_SORTED(&g->resource, r, _global, ldp_resource, index);
+  ldp_global_index_add(g->resource_index, r->index, r);
 }
 
 void _ldp_global_del_resource(ldp_global * g, ldp_resource * r)
 {
   MPLS_ASSERT(g && r);
   MPLS_LIST_REMOVE(&g->resource, r, _global);
+  ldp_global_index_del(g->resource_index, r->index);
   MPLS_REFCNT_RELEASE(r, ldp_resource_delete);
 }
 
 void _ldp_global_add_hop_list(ldp_global * g, ldp_hop_list * h)
 {
-  ldp_hop_list *hp = NULL;
 
   MPLS_ASSERT(g && h);
   MPLS_REFCNT_HOLD(h);
-  hp = MPLS_LIST_HEAD(&g->hop_list);
-  while (hp != NULL) {
-    if (hp->index > h->index) {
-      MPLS_LIST_INSERT_BEFORE(&g->hop_list, hp, h, _global);
-      return;
-    }
-    hp = MPLS_LIST_NEXT(&g->hop_list, hp, _global);
-  }
-  MPLS_LIST_ADD_TAIL(&g->hop_list, h, _global, ldp_hop_list);
+  MPLS_LIST_ADD_SORTED(&g->hop_list, h, _global, ldp_hop_list, index);
+  ldp_global_index_add(g->hop_list_index, h->index, h);
 }
 
 void _ldp_global_del_hop_list(ldp_global * g, ldp_hop_list * h)
 {
   MPLS_ASSERT(g && h);
   MPLS_LIST_REMOVE(&g->hop_list, h, _global);
+  ldp_global_index_del(g->hop_list_index, h->index);
   MPLS_REFCNT_RELEASE(h, ldp_hop_list_delete);
 }
 
 void _ldp_global_add_fec(ldp_global * g, ldp_fec * f)
 {
-  ldp_fec *fp = NULL;
 
   MPLS_ASSERT(g && f);
   /*
@@ -1256,37 +1177,22 @@ void _ldp_global_add_fec(ldp_global * g, ldp_fec * f)
    * ldp_fec_create()
    * MPLS_REFCNT_HOLD(f);
    */
-  fp = MPLS_LIST_HEAD(&g->fec);
-  while (fp != NULL) {
-    if (fp->index > f->index) {
-      MPLS_LIST_INSERT_BEFORE(&g->fec, fp, f, _global);
-      return;
-    }
-    fp = MPLS_LIST_NEXT(&g->fec, fp, _global);
-  }
-  MPLS_LIST_ADD_TAIL(&g->fec, f, _global, ldp_fec);
+  MPLS_LIST_ADD_SORTED(&g->fec, f, _global, ldp_fec, index);
+  ldp_global_index_add(g->fec_index, f->index, f);
 }
 
 void _ldp_global_del_fec(ldp_global * g, ldp_fec * f)
 {
   MPLS_ASSERT(g && f);
   MPLS_LIST_REMOVE(&g->fec, f, _global);
+  ldp_global_index_del(g->fec_index, f->index);
 }
 
 void _ldp_global_add_nexthop(ldp_global * g, ldp_nexthop * nh)
 {
-  ldp_nexthop *nhp = NULL;
 
   MPLS_ASSERT(g && nh);
-  nhp = MPLS_LIST_HEAD(&g->nexthop);
-  while (nhp != NULL) {
-    if (nhp->index > nh->index) {
-      MPLS_LIST_INSERT_BEFORE(&g->nexthop, nhp, nh, _global);
-      return;
-    }
-    nhp = MPLS_LIST_NEXT(&g->nexthop, nhp, _global);
-  }
-  MPLS_LIST_ADD_TAIL(&g->nexthop, nh, _global, ldp_nexthop);
+  MPLS_LIST_ADD_SORTED(&g->nexthop, nh, _global, ldp_nexthop, index);
 }
 
 void _ldp_global_del_nexthop(ldp_global * g, ldp_nexthop * nh)
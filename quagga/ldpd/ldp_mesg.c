@@ -9,22 +9,92 @@
 
 #include <stdio.h>
 #include <sys/socket.h>
+#include <netinet/in.h>
 #include "ldp_struct.h"
 #include "ldp_mesg.h"
 #include "ldp_buf.h"
+#include "ldp_nortel.h"
+#include "ldp_session.h"
 
 #include "mpls_assert.h"
 #include "mpls_mm_impl.h"
 #include "mpls_socket_impl.h"
+#include "mpls_timer_impl.h"
+#include "mpls_lock_impl.h"
+#include "mpls_refcnt.h"
 #include "mpls_trace_impl.h"
 
-mpls_return_enum ldp_mesg_send_tcp(ldp_global * g, ldp_session * s,
-  ldp_mesg * msg)
+static mpls_return_enum ldp_mesg_write_tcp(ldp_global * g, ldp_session * s,
+  ldp_buf * b)
 {
   int32_t result = 0;
 
+  result = mpls_socket_tcp_write(g->socket_handle, s->socket,
+    b->buffer, b->size);
+
+  if (result <= 0) {
+    LDP_PRINT(g->user_data, "send failed(%d)\n", result);
+    perror("send");
+    return MPLS_FAILURE;
+  }
+  s->pdu_tx++;
+  return MPLS_SUCCESS;
+}
+
+/*
+ * the largest PDU we may send, as negotiated during initialization
+ */
+static int ldp_mesg_max_pdu(ldp_session * s)
+{
+  if (s->oper_max_pdu > MPLS_LDP_HDRSIZE && s->oper_max_pdu < MPLS_PDUMAXLEN)
+    return s->oper_max_pdu;
+  return MPLS_PDUMAXLEN;
+}
+
+mpls_return_enum ldp_mesg_flush_tcp(ldp_global * g, ldp_session * s)
+{
+  mpls_return_enum retval = MPLS_SUCCESS;
+
   MPLS_ASSERT(s);
 
+  if (s->tx_pdu->size) {
+    retval = ldp_mesg_write_tcp(g, s, s->tx_pdu);
+    s->tx_pdu->size = 0;
+  }
+  return retval;
+}
+
+void ldp_mesg_flush_callback(mpls_timer_handle timer, void *extra,
+  mpls_cfg_handle handle)
+{
+  ldp_session *s = (ldp_session *) extra;
+  ldp_global *g = (ldp_global*)handle;
+
+  mpls_lock_get(g->global_lock);
+
+  mpls_timer_stop(g->timer_handle, timer);
+  mpls_timer_delete(g->timer_handle, timer);
+  s->tx_flush_timer = (mpls_timer_handle) 0;
+
+  ldp_mesg_flush_tcp(g, s);
+  MPLS_REFCNT_RELEASE(s, ldp_session_delete);
+
+  mpls_lock_release(g->global_lock);
+}
+
+/*
+ * append the message to the session's pending PDU, sending the PDU first if
+ * the message would push it over the max PDU length.  The PDU goes out at
+ * the latest when the flush timer fires, once the current event is done.
+ */
+static mpls_return_enum ldp_mesg_queue_tcp(ldp_global * g, ldp_session * s,
+  ldp_mesg * msg)
+{
+  ldp_buf *pdu = s->tx_pdu;
+  uint16_t pdu_len;
+  int32_t result = 0;
+  int len;
+
   result = ldp_encode_one_mesg(g, g->lsr_identifier.u.ipv4,
     s->cfg_label_space, s->tx_buffer, msg);
 
@@ -33,17 +103,73 @@ mpls_return_enum ldp_mesg_send_tcp(ldp_global * g, ldp_session * s,
 
   s->mesg_tx++;
 
-  result = mpls_socket_tcp_write(g->socket_handle, s->socket,
-    s->tx_buffer->buffer, s->tx_buffer->size);
+  len = result - MPLS_LDP_HDRSIZE;
+  if (pdu->size && pdu->size + len > ldp_mesg_max_pdu(s)) {
+    if (ldp_mesg_flush_tcp(g, s) != MPLS_SUCCESS)
+      return MPLS_FAILURE;
+  }
 
-  if (result <= 0) {
-    LDP_PRINT(g->user_data, "send failed(%d)\n", result);
-    perror("send");
-    return MPLS_FAILURE;
+  if (!pdu->size) {
+    memcpy(pdu->buffer, s->tx_buffer->buffer, result);
+    pdu->size = result;
+  } else {
+    memcpy(pdu->buffer + pdu->size, s->tx_buffer->buffer + MPLS_LDP_HDRSIZE,
+      len);
+    pdu->size += len;
+
+    /* the PDU length covers the LDP identifier and all messages */
+    pdu_len = htons(pdu->size - MPLS_LDP_HDRSIZE + MPLS_LDPIDLEN);
+    memcpy(pdu->buffer + 2, &pdu_len, sizeof(pdu_len));
+  }
+
+  if (mpls_timer_handle_verify(g->timer_handle, s->tx_flush_timer) ==
+    MPLS_BOOL_FALSE) {
+    MPLS_REFCNT_HOLD(s);
+    s->tx_flush_timer = mpls_timer_create(g->timer_handle, MPLS_UNIT_SEC,
+      0, (void *)s, g, ldp_mesg_flush_callback);
+    if (mpls_timer_handle_verify(g->timer_handle, s->tx_flush_timer) ==
+      MPLS_BOOL_FALSE) {
+      MPLS_REFCNT_RELEASE(s, ldp_session_delete);
+      return ldp_mesg_flush_tcp(g, s);
+    }
+    mpls_timer_start(g->timer_handle, s->tx_flush_timer, MPLS_TIMER_ONESHOT);
   }
   return MPLS_SUCCESS;
 }
 
+mpls_return_enum ldp_mesg_send_tcp(ldp_global * g, ldp_session * s,
+  ldp_mesg * msg)
+{
+  int32_t result = 0;
+
+  MPLS_ASSERT(s);
+
+  if (s->state == LDP_STATE_OPERATIONAL) {
+    switch (ldp_mesg_get_type(msg)) {
+      case MPLS_LBLMAP_MSGTYPE:
+      case MPLS_LBLWITH_MSGTYPE:
+      case MPLS_LBLREL_MSGTYPE:
+        return ldp_mesg_queue_tcp(g, s, msg);
+      default:
+        break;
+    }
+  }
+
+  /* anything else goes out right away, behind what is already queued */
+  if (ldp_mesg_flush_tcp(g, s) != MPLS_SUCCESS)
+    return MPLS_FAILURE;
+
+  result = ldp_encode_one_mesg(g, g->lsr_identifier.u.ipv4,
+    s->cfg_label_space, s->tx_buffer, msg);
+
+  if (result <= 0)
+    return MPLS_FAILURE;
+
+  s->mesg_tx++;
+
+  return ldp_mesg_write_tcp(g, s, s->tx_buffer);
+}
+
 mpls_return_enum ldp_mesg_send_udp(ldp_global * g, ldp_entity * e,
   ldp_mesg * msg)
 {
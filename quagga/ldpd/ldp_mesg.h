@@ -32,5 +32,8 @@ extern mpls_return_enum ldp_mesg_send_tcp(ldp_global * g, ldp_session * s,
   ldp_mesg * mesg);
 extern mpls_return_enum ldp_mesg_send_udp(ldp_global * g, ldp_entity * s,
   ldp_mesg * mesg);
+extern mpls_return_enum ldp_mesg_flush_tcp(ldp_global * g, ldp_session * s);
+extern void ldp_mesg_flush_callback(mpls_timer_handle timer, void *extra,
+  mpls_cfg_handle handle);
 
 #endif
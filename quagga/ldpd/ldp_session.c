@@ -103,6 +103,7 @@ ldp_session *ldp_session_create()
 
     s->on_global = MPLS_BOOL_FALSE;
     s->tx_buffer = ldp_buf_create(MPLS_PDUMAXLEN);
+    s->tx_pdu = ldp_buf_create(MPLS_PDUMAXLEN);
     s->tx_message = ldp_mesg_create();
     s->index = _ldp_session_get_next_index();
     s->oper_role = LDP_NONE;
@@ -253,6 +254,7 @@ void ldp_session_delete(ldp_session * s)
   LDP_PRINT(NULL, "session delete");
   MPLS_REFCNT_ASSERT(s, 0);
   ldp_buf_delete(s->tx_buffer);
+  ldp_buf_delete(s->tx_pdu);
   ldp_mesg_delete(s->tx_message);
   mpls_free(s);
 }
@@ -382,6 +384,18 @@ void ldp_session_shutdown(ldp_global * g, ldp_session * s, mpls_bool complete)
     s->initial_distribution_timer = (mpls_timer_handle) 0;
   }
 
+  /*
+   * drop label messages still waiting to be sent
+   */
+  if (mpls_timer_handle_verify(g->timer_handle, s->tx_flush_timer) ==
+    MPLS_BOOL_TRUE) {
+    mpls_timer_stop(g->timer_handle, s->tx_flush_timer);
+    mpls_timer_delete(g->timer_handle, s->tx_flush_timer);
+    MPLS_REFCNT_RELEASE(s, ldp_session_delete);
+    s->tx_flush_timer = (mpls_timer_handle) 0;
+  }
+  s->tx_pdu->size = 0;
+
   /*
    * get rid of the socket
    */
@@ -231,6 +231,21 @@ typedef struct ldp_global {
   mpls_tree_handle addr_tree;
   mpls_tree_handle fec_tree;
 
+  /* per list trees keyed by object index */
+  mpls_tree_handle outlabel_index;
+  mpls_tree_handle resource_index;
+  mpls_tree_handle hop_list_index;
+  mpls_tree_handle inlabel_index;
+  mpls_tree_handle session_index;
+  mpls_tree_handle tunnel_index;
+  mpls_tree_handle entity_index;
+  mpls_tree_handle peer_index;
+  mpls_tree_handle attr_index;
+  mpls_tree_handle addr_index;
+  mpls_tree_handle adj_index;
+  mpls_tree_handle iff_index;
+  mpls_tree_handle fec_index;
+
   mpls_socket_handle hello_socket;
   mpls_socket_handle listen_socket;
 
@@ -392,6 +407,7 @@ typedef struct ldp_session {
   mpls_timer_handle initial_distribution_timer;
   mpls_timer_handle keepalive_recv_timer;
   mpls_timer_handle keepalive_send_timer;
+  mpls_timer_handle tx_flush_timer;
   uint32_t index;
   ldp_state_enum state;
   uint32_t oper_up;
@@ -427,6 +443,9 @@ typedef struct ldp_session {
   struct ldp_mesg *tx_message;
   struct ldp_buf *tx_buffer;
 
+  /* label messages waiting to go out, packed into one PDU */
+  struct ldp_buf *tx_pdu;
+
   /* cached from adj's */ 
   ldp_role_enum oper_role;
 
@@ -446,6 +465,7 @@ typedef struct ldp_session {
   /* mesg counters */
   uint32_t mesg_tx;
   uint32_t mesg_rx;
+  uint32_t pdu_tx;
 
   /* only used by cfg gets */
   uint32_t adj_index;
@@ -1289,6 +1289,16 @@ Peer LDP Ident: 7.1.1.1:0; Local LDP Ident 8.1.1.1:0
   return CMD_SUCCESS;
 }
 
+DEFUN (mpls_show_ldp_zebra, mpls_show_ldp_zebra_cmd,
+       "show ldp zebra",
+       SHOW_STR
+       "LDP related commands\n"
+       "Label programming towards zebra\n")
+{
+  mpls_mpls_show_stats(vty);
+  return CMD_SUCCESS;
+}
+
 DEFUN (mpls_show_ldp_session, mpls_show_ldp_session_cmd,
        "show ldp session [A.B.C.D:E]",
        SHOW_STR
@@ -1300,6 +1310,7 @@ DEFUN (mpls_show_ldp_session, mpls_show_ldp_session_cmd,
   ldp_session session;
   ldp_addr addr;
   struct in_addr in;
+  uint64_t per_pdu;
   int count = 0;
 
     if (!ldp) {
@@ -1315,6 +1326,14 @@ DEFUN (mpls_show_ldp_session, mpls_show_ldp_session_cmd,
       vty_out(vty, "%-2d %s %-3d %s%s", session.index,
         inet_ntoa(in), session.oper_keepalive,
         session_state[session.state], VTY_NEWLINE);
+      vty_out(vty, "\tMsgs sent %u in %u PDUs", session.mesg_tx,
+        session.pdu_tx);
+      if (session.pdu_tx) {
+        per_pdu = (uint64_t)session.mesg_tx * 100 / session.pdu_tx;
+        vty_out(vty, " (%u.%02u per PDU)", (unsigned int)(per_pdu / 100),
+          (unsigned int)(per_pdu % 100));
+      }
+      vty_out(vty, "%s", VTY_NEWLINE);
       addr.index = 0;
       while (ldp_cfg_session_raddr_getnext(ldp->h, &session,
         &addr, 0xFFFFFFFF) == MPLS_SUCCESS) {
@@ -2381,6 +2400,9 @@ void ldp_vty_show_init() {
   install_element (VIEW_NODE, &mpls_show_ldp_session_cmd);
   install_element (ENABLE_NODE, &mpls_show_ldp_session_cmd);
 
+  install_element (VIEW_NODE, &mpls_show_ldp_zebra_cmd);
+  install_element (ENABLE_NODE, &mpls_show_ldp_zebra_cmd);
+
   install_element (VIEW_NODE, &mpls_show_ldp_discovery_cmd);
   install_element (ENABLE_NODE, &mpls_show_ldp_discovery_cmd);
 
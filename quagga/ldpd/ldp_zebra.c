@@ -21,9 +21,6 @@
 
 /* All information about zebra. */
 struct zclient *zclient = NULL;
-struct list *pending_out_segment = NULL;
-struct list *pending_ftn = NULL;
-struct list *pending_xc = NULL;
 
 /* For registering threads. */
 extern struct thread_master *master;
@@ -84,6 +81,8 @@ static int ldp_interface_deletez(int command, struct zclient *zclient,
     zlog_info("interface delete %s index %d flags %ld metric %d mtu %d",
        ifp->name, ifp->ifindex, ifp->flags, ifp->metric, ifp->mtu);
 
+    mpls_mpls_nexthop_flush();
+
     return 0;
 }
 
@@ -202,6 +201,8 @@ static int ldp_interface_address_add(int command, struct zclient *zclient,
     ifp = c->ifp;
     p = c->address;
 
+    mpls_mpls_nexthop_flush();
+
     /* Don't register addresses connected to the loopback interface */
     if (if_is_loopback(ifp))
 	return 0;
@@ -266,6 +267,8 @@ static int ldp_interface_address_delete(int command, struct zclient *zclient,
     ifp = c->ifp;
     p = c->address;
 
+    mpls_mpls_nexthop_flush();
+
     zlog_info("address delete %s from interface %s",
 	inet_ntoa(p->u.prefix4), ifp->name);
 
@@ -441,41 +444,9 @@ static int ldp_in_segment_read(int cmd, struct zclient *client,
 static int ldp_out_segment_read(int cmd, struct zclient *client,
     zebra_size_t size) {
     struct zapi_mpls_out_segment api;
-    struct listnode *n;
-    struct listnode *nn;
-    mpls_outsegment *o;
-    struct pending_ftn_data *fn;
-    struct pending_xc_data *x;
 
     mpls_out_segment_stream_read(client->ibuf, &api);
-
-    for (ALL_LIST_ELEMENTS(pending_out_segment, n, nn, o)) {
-	if (api.req == o->handle) {
-	    zlog_info("found pending NHLFE: %p", o);
-	    o->handle = api.index;
-	    list_delete_node(pending_out_segment,n);
-	    goto ftn;
-	}
-    }
-    zlog_info("requested out segment %d not in list", api.req);
-    return 0;
-
-ftn:
-    /* if we've gotten this for then the o->handle is not the proper index */
-    for (ALL_LIST_ELEMENTS(pending_ftn, n, nn, fn)) {
-	if (api.index == fn->o->handle) {
-	    mpls_mpls_fec2out_add(fn->h, fn->f, fn->o);
-	    list_delete_node(pending_ftn,n);
-	    break;
-	}
-    }
-    for (ALL_LIST_ELEMENTS(pending_xc, n, nn, x)) {
-	if (api.index == x->o->handle) {
-	    mpls_mpls_xconnect_add(x->h, x->i, x->o);
-	    list_delete_node(pending_xc,n);
-	    break;
-	}
-    }
+    mpls_mpls_out_segment_resolved(api.req, api.index);
     return 0;
 }
 
@@ -534,21 +505,15 @@ void ldp_zebra_shutdown() {
   }
 }
 
-void pending_delete(void *m) {
-    XFREE(MTYPE_TMP, m);
-}
-
 void ldp_zebra_init() {
 
-  pending_out_segment = list_new();
-  pending_ftn = list_new();
-  pending_ftn->del = pending_delete;
-  pending_xc = list_new();
-  pending_xc->del = pending_delete;
+  mpls_mpls_pending_init();
 
   /* Allocate zebra structure. */
   zclient = zclient_new();
   zclient_init(zclient, ZEBRA_ROUTE_LDP);
+  /* label programming comes in bursts, write it once per event loop */
+  zclient->write_batch = 1;
   zclient->router_id_update = ldp_router_id_update_zebra;
   zclient->interface_add = ldp_interface_add;
   zclient->interface_delete = ldp_interface_deletez;
@@ -81,6 +81,21 @@ struct {				\
   (head)->count++;					\
 }
 
+/* insert elm keeping the list sorted on key, the list is searched from */
+/* the tail since new elements almost always carry the highest key */
+#define MPLS_LIST_ADD_SORTED(head, elm, field, type, key) {	\
+  struct type *_lp = MPLS_LIST_TAIL(head);			\
+  while (_lp && _lp->key > (elm)->key)				\
+    _lp = MPLS_LIST_PREV(head, _lp, field);			\
+  if (_lp == NULL) {						\
+    MPLS_LIST_ADD_HEAD(head, elm, field, type);			\
+  } else if (_lp == (head)->llh_last) {				\
+    MPLS_LIST_ADD_TAIL(head, elm, field, type);			\
+  } else {							\
+    MPLS_LIST_INSERT_BEFORE(head, _lp->field.lle_next, elm, field);	\
+  }								\
+}
+
 #define MPLS_LIST_REMOVE_TAIL(root,elem,field) {	\
   (elem) = (root)->llh_last;			\
   if((elem) && (elem) != (void*)(root)) {	\
@@ -9,39 +9,228 @@
 #include <zebra.h>
 #include "checksum.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif /* __SSE2__ */
+
 int			/* return checksum in low-order 16 bits */
 in_cksum(void *parg, int nbytes)
 {
-	u_short *ptr = parg;
-	register long		sum;		/* assumes long == 32 bits */
+	u_char *ptr = parg;
+	u_int64_t		sum;
+	u_int32_t		w[4];
+	u_short			half;
 	u_short			oddbyte;
 	register u_short	answer;		/* assumes u_short == 16 bits */
 
 	/*
-	 * Our algorithm is simple, using a 32-bit accumulator (sum),
-	 * we add sequential 16-bit words to it, and at the end, fold back
-	 * all the carry bits from the top 16 bits into the lower 16 bits.
+	 * The ones-complement sum does not depend on the word size, so
+	 * we add 32-bit words to a 64-bit accumulator, which cannot
+	 * overflow for any int nbytes, and fold the carries at the end.
+	 * The words are copied out as the buffer need not be aligned.
 	 */
 
 	sum = 0;
-	while (nbytes > 1)  {
-		sum += *ptr++;
+	while (nbytes >= 16)  {
+		memcpy (w, ptr, 16);
+		sum += (u_int64_t) w[0] + w[1] + w[2] + w[3];
+		ptr += 16;
+		nbytes -= 16;
+	}
+	while (nbytes >= 4)  {
+		memcpy (w, ptr, 4);
+		sum += w[0];
+		ptr += 4;
+		nbytes -= 4;
+	}
+	if (nbytes >= 2)  {
+		memcpy (&half, ptr, 2);
+		sum += half;
+		ptr += 2;
 		nbytes -= 2;
 	}
 
 				/* mop up an odd byte, if necessary */
 	if (nbytes == 1) {
 		oddbyte = 0;		/* make sure top half is zero */
-		*((u_char *) &oddbyte) = *(u_char *)ptr;   /* one byte only */
+		*((u_char *) &oddbyte) = *ptr;   /* one byte only */
 		sum += oddbyte;
 	}
 
 	/*
-	 * Add back carry outs from top 16 bits to low 16 bits.
+	 * Add back carry outs from the top bits to the low 16 bits.
 	 */
 
+	sum  = (sum >> 32) + (sum & 0xffffffff);
+	sum  = (sum >> 32) + (sum & 0xffffffff);
 	sum  = (sum >> 16) + (sum & 0xffff);	/* add high-16 to low-16 */
+	sum  = (sum >> 16) + (sum & 0xffff);
 	sum += (sum >> 16);			/* add carry */
 	answer = ~sum;		/* ones-complement, then truncate to 16 bits */
 	return(answer);
 }
+
+/* Fletcher checksum, RFC 1008 and ISO/IEC 8473 Annex C, as used by the
+ * OSPF and OSPFv3 LSAs and the IS-IS LSPs.
+ *
+ * For a block of n bytes b[0..n-1] the running sums move on as
+ *
+ *   c0' = c0 + sum b[i]
+ *   c1' = c1 + n * c0 + sum (n - i) b[i]
+ *
+ * so whole words can be added at once.  The sums are kept in 64 bits
+ * and reduced modulo 255 once per FLETCHER_CHUNK bytes.
+ */
+#define FLETCHER_CHUNK		(1 << 20)
+
+/* Weights of the even and odd bytes of a 64-bit word in its 16-bit
+   lanes, arranged so that the top lane of (lanes * weights) holds
+   their weighted sum. */
+#ifdef WORDS_BIGENDIAN
+#define FLETCHER_WEIGHT_EVEN	0x0001000300050007ULL
+#define FLETCHER_WEIGHT_ODD	0x0002000400060008ULL
+#else
+#define FLETCHER_WEIGHT_EVEN	0x0008000600040002ULL
+#define FLETCHER_WEIGHT_ODD	0x0007000500030001ULL
+#endif /* WORDS_BIGENDIAN */
+#define FLETCHER_LANES		0x00ff00ff00ff00ffULL
+#define FLETCHER_LANE_SUM	0x0001000100010001ULL
+
+/* Add len bytes, a multiple of 8, a word at a time. */
+static void
+fletcher_words (const u_char *p, size_t len, u_int64_t *c0, u_int64_t *c1)
+{
+  u_int64_t s0 = *c0, s1 = *c1;
+  u_int64_t w, even, odd;
+  const u_char *end = p + len;
+
+  for (; p < end; p += 8)
+    {
+      memcpy (&w, p, 8);
+      even = w & FLETCHER_LANES;
+      odd = (w >> 8) & FLETCHER_LANES;
+      s1 += 8 * s0 + ((even * FLETCHER_WEIGHT_EVEN
+		       + odd * FLETCHER_WEIGHT_ODD) >> 48);
+      s0 += ((even + odd) * FLETCHER_LANE_SUM) >> 48;
+    }
+  *c0 = s0;
+  *c1 = s1;
+}
+
+#ifdef __SSE2__
+/* Add len bytes, a multiple of 16 and at most FLETCHER_SSE2_CHUNK, 16
+   at a time.  Per 32-bit lane, bytes keeps the byte sums, prefix the
+   byte sums before each block and weighted the sums of (16 - i) b[i]. */
+#define FLETCHER_SSE2_CHUNK	(1024 * 16)
+
+static void
+fletcher_blocks (const u_char *p, size_t len, u_int64_t *c0, u_int64_t *c1)
+{
+  const __m128i zero = _mm_setzero_si128 ();
+  const __m128i wlo = _mm_set_epi16 (9, 10, 11, 12, 13, 14, 15, 16);
+  const __m128i whi = _mm_set_epi16 (1, 2, 3, 4, 5, 6, 7, 8);
+  __m128i bytes = zero, prefix = zero, weighted = zero;
+  __m128i v;
+  u_int32_t lanes[4];
+  u_int64_t sum, sum_prefix, sum_weighted;
+  size_t n = len / 16;
+  size_t i;
+
+  for (i = 0; i < n; i++, p += 16)
+    {
+      v = _mm_loadu_si128 ((const __m128i *) p);
+      prefix = _mm_add_epi32 (prefix, bytes);
+      bytes = _mm_add_epi32 (bytes, _mm_sad_epu8 (v, zero));
+      weighted = _mm_add_epi32 (weighted,
+		   _mm_add_epi32 (_mm_madd_epi16 (_mm_unpacklo_epi8 (v, zero),
+						  wlo),
+				  _mm_madd_epi16 (_mm_unpackhi_epi8 (v, zero),
+						  whi)));
+    }
+
+  _mm_storeu_si128 ((__m128i *) lanes, bytes);
+  sum = (u_int64_t) lanes[0] + lanes[2];
+  _mm_storeu_si128 ((__m128i *) lanes, prefix);
+  sum_prefix = (u_int64_t) lanes[0] + lanes[2];
+  _mm_storeu_si128 ((__m128i *) lanes, weighted);
+  sum_weighted = (u_int64_t) lanes[0] + lanes[1] + lanes[2] + lanes[3];
+
+  *c1 += len * *c0 + 16 * sum_prefix + sum_weighted;
+  *c0 += sum;
+}
+#endif /* __SSE2__ */
+
+/* The Fletcher sums of len bytes at p, modulo 255. */
+static void
+fletcher_sum (const u_char *p, size_t len, int *c0p, int *c1p)
+{
+  u_int64_t c0 = 0, c1 = 0;
+  size_t chunk, words;
+
+  while (len)
+    {
+      chunk = MIN (len, FLETCHER_CHUNK);
+      len -= chunk;
+
+#ifdef __SSE2__
+      while (chunk >= 16)
+	{
+	  words = MIN (chunk & ~(size_t) 15, FLETCHER_SSE2_CHUNK);
+	  fletcher_blocks (p, words, &c0, &c1);
+	  p += words;
+	  chunk -= words;
+	}
+#endif /* __SSE2__ */
+
+      words = chunk & ~(size_t) 7;
+      fletcher_words (p, words, &c0, &c1);
+      p += words;
+      chunk -= words;
+
+      for (; chunk; chunk--, p++)
+	{
+	  c0 += *p;
+	  c1 += c0;
+	}
+
+      c0 %= 255;
+      c1 %= 255;
+    }
+
+  *c0p = c0;
+  *c1p = c1;
+}
+
+/* Fletcher checksum of len bytes at buffer.  The two checksum bytes
+ * are at offset: they are set and the checksum returned, first byte
+ * high.  With offset FLETCHER_CHECKSUM_VALIDATE the buffer is checked
+ * instead and 0 returned if its checksum is good.
+ */
+u_int16_t
+fletcher_checksum (u_char *buffer, const size_t len, const u_int16_t offset)
+{
+  int c0, c1;
+  int x, y;
+
+  if (offset == FLETCHER_CHECKSUM_VALIDATE)
+    {
+      fletcher_sum (buffer, len, &c0, &c1);
+      return (c1 << 8) | c0;
+    }
+
+  buffer[offset] = 0;
+  buffer[offset + 1] = 0;
+  fletcher_sum (buffer, len, &c0, &c1);
+
+  x = (((int) len - offset - 1) * c0 - c1) % 255;
+  if (x <= 0)
+    x += 255;
+  y = 510 - c0 - x;
+  if (y > 255)
+    y -= 255;
+
+  buffer[offset] = x;
+  buffer[offset + 1] = y;
+
+  return (x << 8) | y;
+}
@@ -1 +1,6 @@
 extern int in_cksum(void *, int);
+
+/* Offset to pass to fletcher_checksum to check a buffer. */
+#define FLETCHER_CHECKSUM_VALIDATE 0xffff
+extern u_int16_t fletcher_checksum (u_char *, const size_t len,
+				    const u_int16_t offset);
@@ -179,6 +179,9 @@ argv_concat (const char **argv, int argc, int shift)
   return str;
 }
 
+static struct cmd_trie_node *cmd_trie_node_new (unsigned int);
+static void cmd_trie_insert (struct cmd_trie_node *, struct cmd_element *);
+
 /* Install top node of command vector. */
 void
 install_node (struct cmd_node *node, 
@@ -187,6 +190,7 @@ install_node (struct cmd_node *node,
   vector_set_index (cmdvec, node->node, node);
   node->func = func;
   node->cmd_vector = vector_init (VECTOR_MIN_SIZE);
+  node->trie = cmd_trie_node_new (0);
 }
 
 /* Compare two command's string.  Used in sort_node (). */
@@ -493,6 +497,7 @@ install_element (enum node_type ntype, struct cmd_element *cmd)
 
   cmd->strvec = cmd_make_descvec (cmd->string, cmd->doc);
   cmd->cmdsize = cmd_cmdsize (cmd->strvec);
+  cmd_trie_insert (cnode->trie, cmd);
 }
 
 static unsigned char itoa64[] =	
@@ -598,6 +603,23 @@ config_write_host (struct vty *vty)
     vty_out (vty, "log timestamp precision %d%s",
 	     zlog_default->timestamp_precision, VTY_NEWLINE);
 
+  if (zlog_default->async_size)
+    {
+      vty_out (vty, "log async");
+      if (zlog_default->async_size != ZLOG_ASYNC_DEFAULT_SIZE)
+	vty_out (vty, " %lu", (u_long) zlog_default->async_size);
+      vty_out (vty, "%s", VTY_NEWLINE);
+    }
+
+  if (! thread_slow_warning_is_default ())
+    {
+      if (thread_get_slow_warning ())
+	vty_out (vty, "thread slow-warning %lu%s", thread_get_slow_warning (),
+		 VTY_NEWLINE);
+      else
+	vty_out (vty, "no thread slow-warning%s", VTY_NEWLINE);
+    }
+
   if (host.advanced)
     vty_out (vty, "service advanced-vty%s", VTY_NEWLINE);
 
@@ -1236,12 +1258,55 @@ cmd_filter_by_completion (char *command, vector v, unsigned int index)
   return match_type;
 }
 
+/* Match type of one alternative of a command token against the input
+   token, no_match if it does not match. */
+static enum match_type
+cmd_desc_filter (const char *str, const char *command)
+{
+  if (CMD_VARARG (str))
+    return vararg_match;
+  else if (CMD_RANGE (str))
+    {
+      if (cmd_range_match (str, command))
+	return range_match;
+    }
+#ifdef HAVE_IPV6
+  else if (CMD_IPV6 (str))
+    {
+      if (cmd_ipv6_match (command) == exact_match)
+	return ipv6_match;
+    }
+  else if (CMD_IPV6_PREFIX (str))
+    {
+      if (cmd_ipv6_prefix_match (command) == exact_match)
+	return ipv6_prefix_match;
+    }
+#endif /* HAVE_IPV6  */
+  else if (CMD_IPV4 (str))
+    {
+      if (cmd_ipv4_match (command) == exact_match)
+	return ipv4_match;
+    }
+  else if (CMD_IPV4_PREFIX (str))
+    {
+      if (cmd_ipv4_prefix_match (command) == exact_match)
+	return ipv4_prefix_match;
+    }
+  else if (CMD_OPTION (str) || CMD_VARIABLE (str))
+    return extend_match;
+  else
+    {
+      if (strcmp (command, str) == 0)
+	return exact_match;
+    }
+  return no_match;
+}
+
 /* Filter vector by command character with index. */
 static enum match_type
 cmd_filter_by_string (char *command, vector v, unsigned int index)
 {
   unsigned int i;
-  const char *str;
   struct cmd_element *cmd_element;
   enum match_type match_type;
   vector descvec;
@@ -1267,75 +1332,14 @@ cmd_filter_by_string (char *command, vector v, unsigned int index)
 	    for (j = 0; j < vector_active (descvec); j++)
 	      if ((desc = vector_slot (descvec, j)))
 		{
-		  str = desc->cmd;
+		  enum match_type ret = cmd_desc_filter (desc->cmd, command);
 
-		  if (CMD_VARARG (str))
+		  if (ret != no_match)
 		    {
-		      if (match_type < vararg_match)
-			match_type = vararg_match;
+		      if (match_type < ret)
+			match_type = ret;
 		      matched++;
 		    }
-		  else if (CMD_RANGE (str))
-		    {
-		      if (cmd_range_match (str, command))
-			{
-			  if (match_type < range_match)
-			    match_type = range_match;
-			  matched++;
-			}
-		    }
-#ifdef HAVE_IPV6
-		  else if (CMD_IPV6 (str))
-		    {
-		      if (cmd_ipv6_match (command) == exact_match)
-			{
-			  if (match_type < ipv6_match)
-			    match_type = ipv6_match;
-			  matched++;
-			}
-		    }
-		  else if (CMD_IPV6_PREFIX (str))
-		    {
-		      if (cmd_ipv6_prefix_match (command) == exact_match)
-			{
-			  if (match_type < ipv6_prefix_match)
-			    match_type = ipv6_prefix_match;
-			  matched++;
-			}
-		    }
-#endif /* HAVE_IPV6  */
-		  else if (CMD_IPV4 (str))
-		    {
-		      if (cmd_ipv4_match (command) == exact_match)
-			{
-			  if (match_type < ipv4_match)
-			    match_type = ipv4_match;
-			  matched++;
-			}
-		    }
-		  else if (CMD_IPV4_PREFIX (str))
-		    {
-		      if (cmd_ipv4_prefix_match (command) == exact_match)
-			{
-			  if (match_type < ipv4_prefix_match)
-			    match_type = ipv4_prefix_match;
-			  matched++;
-			}
-		    }
-		  else if (CMD_OPTION (str) || CMD_VARIABLE (str))
-		    {
-		      if (match_type < extend_match)
-			match_type = extend_match;
-		      matched++;
-		    }
-		  else
-		    {
-		      if (strcmp (command, str) == 0)
-			{
-			  match_type = exact_match;
-			  matched++;
-			}
-		    }
 		}
 	    if (!matched)
 	      vector_slot (v, i) = NULL;
@@ -1344,13 +1348,90 @@ cmd_filter_by_string (char *command, vector v, unsigned int index)
   return match_type;
 }
 
+/* Check one alternative of a command token which passed the filter
+   against the best match type of the input token.  Returns 1 if the
+   alternative stays, 0 if not, or -1 (ambiguous) and -2 (incomplete).
+   *matched carries the first matching string across the alternatives
+   of all the commands checked for the token. */
+static int
+cmd_desc_ambiguous (const char *str, char *command, enum match_type type,
+		    const char **matched)
+{
+  enum match_type ret;
+
+  switch (type)
+    {
+    case exact_match:
+      if (!(CMD_OPTION (str) || CMD_VARIABLE (str))
+	  && strcmp (command, str) == 0)
+	return 1;
+      break;
+    case partly_match:
+      if (!(CMD_OPTION (str) || CMD_VARIABLE (str))
+	  && strncmp (command, str, strlen (command)) == 0)
+	{
+	  if (*matched && strcmp (*matched, str) != 0)
+	    return -1;	/* There is ambiguous match. */
+	  else
+	    *matched = str;
+	  return 1;
+	}
+      break;
+    case range_match:
+      if (cmd_range_match (str, command))
+	{
+	  if (*matched && strcmp (*matched, str) != 0)
+	    return -1;
+	  else
+	    *matched = str;
+	  return 1;
+	}
+      break;
+#ifdef HAVE_IPV6
+    case ipv6_match:
+      if (CMD_IPV6 (str))
+	return 1;
+      break;
+    case ipv6_prefix_match:
+      if ((ret = cmd_ipv6_prefix_match (command)) != no_match)
+	{
+	  if (ret == partly_match)
+	    return -2;	/* There is incomplete match. */
+
+	  return 1;
+	}
+      break;
+#endif /* HAVE_IPV6 */
+    case ipv4_match:
+      if (CMD_IPV4 (str))
+	return 1;
+      break;
+    case ipv4_prefix_match:
+      if ((ret = cmd_ipv4_prefix_match (command)) != no_match)
+	{
+	  if (ret == partly_match)
+	    return -2;	/* There is incomplete match. */
+
+	  return 1;
+	}
+      break;
+    case extend_match:
+      if (CMD_OPTION (str) || CMD_VARIABLE (str))
+	return 1;
+      break;
+    case no_match:
+    default:
+      break;
+    }
+  return 0;
+}
+
 /* Check ambiguous match */
 static int
 is_cmd_ambiguous (char *command, vector v, int index, enum match_type type)
 {
   unsigned int i;
   unsigned int j;
-  const char *str = NULL;
   struct cmd_element *cmd_element;
   const char *matched = NULL;
   vector descvec;
@@ -1366,74 +1447,11 @@ is_cmd_ambiguous (char *command, vector v, int index, enum match_type type)
 	for (j = 0; j < vector_active (descvec); j++)
 	  if ((desc = vector_slot (descvec, j)))
 	    {
-	      enum match_type ret;
-	      
-	      str = desc->cmd;
+	      int ret = cmd_desc_ambiguous (desc->cmd, command, type, &matched);
 
-	      switch (type)
-		{
-		case exact_match:
-		  if (!(CMD_OPTION (str) || CMD_VARIABLE (str))
-		      && strcmp (command, str) == 0)
-		    match++;
-		  break;
-		case partly_match:
-		  if (!(CMD_OPTION (str) || CMD_VARIABLE (str))
-		      && strncmp (command, str, strlen (command)) == 0)
-		    {
-		      if (matched && strcmp (matched, str) != 0)
-			return 1;	/* There is ambiguous match. */
-		      else
-			matched = str;
-		      match++;
-		    }
-		  break;
-		case range_match:
-		  if (cmd_range_match (str, command))
-		    {
-		      if (matched && strcmp (matched, str) != 0)
-			return 1;
-		      else
-			matched = str;
-		      match++;
-		    }
-		  break;
-#ifdef HAVE_IPV6
-		case ipv6_match:
-		  if (CMD_IPV6 (str))
-		    match++;
-		  break;
-		case ipv6_prefix_match:
-		  if ((ret = cmd_ipv6_prefix_match (command)) != no_match)
-		    {
-		      if (ret == partly_match)
-			return 2;	/* There is incomplete match. */
-
-		      match++;
-		    }
-		  break;
-#endif /* HAVE_IPV6 */
-		case ipv4_match:
-		  if (CMD_IPV4 (str))
-		    match++;
-		  break;
-		case ipv4_prefix_match:
-		  if ((ret = cmd_ipv4_prefix_match (command)) != no_match)
-		    {
-		      if (ret == partly_match)
-			return 2;	/* There is incomplete match. */
-
-		      match++;
-		    }
-		  break;
-		case extend_match:
-		  if (CMD_OPTION (str) || CMD_VARIABLE (str))
-		    match++;
-		  break;
-		case no_match:
-		default:
-		  break;
-		}
+	      if (ret < 0)
+		return -ret;
+	      match += ret;
 	    }
 	if (!match)
 	  vector_slot (v, i) = NULL;
@@ -1441,6 +1459,305 @@ is_cmd_ambiguous (char *command, vector v, int index, enum match_type type)
   return 0;
 }
 
+/* Token trie of a node's commands, used by cmd_execute_command_strict.
+   An edge stands for the alternatives of one command token, commands
+   sharing the first N token specifications share the path of length N.
+   Matching a line walks the edges matching each input token, applying
+   the filter and ambiguity rules of the linear match level by level, so
+   it costs in proportion to the line rather than to the node's command
+   count.  Edges made of keywords only are looked up by binary search,
+   the others are checked one by one. */
+struct cmd_trie_word
+{
+  const char *word;
+  struct cmd_trie_edge *edge;
+};
+
+struct cmd_trie_edge
+{
+  vector descvec;		/* alternatives of the token */
+  struct cmd_trie_node *child;
+};
+
+struct cmd_trie_node
+{
+  unsigned int depth;
+
+  /* Keyword alternatives of the keyword only edges, sorted. */
+  struct cmd_trie_word *words;
+  unsigned int word_count;
+  unsigned int word_size;
+
+  vector edges;			/* all edges */
+  vector special;		/* edges with a non keyword alternative */
+
+  /* Commands below this node: the ones complete with 'depth' tokens,
+     the number of the others, and for vararg matches all of them. */
+  vector complete;
+  unsigned int incomplete;
+  unsigned int count;
+  struct cmd_element *last;
+};
+
+#define CMD_KEYWORD(S) \
+  (!(CMD_OPTION (S) || CMD_VARIABLE (S) || CMD_VARARG (S)))
+
+static struct cmd_trie_node *
+cmd_trie_node_new (unsigned int depth)
+{
+  struct cmd_trie_node *node;
+
+  node = XCALLOC (MTYPE_CMD_TRIE, sizeof (struct cmd_trie_node));
+  node->depth = depth;
+  node->edges = vector_init (1);
+  node->special = vector_init (1);
+  node->complete = vector_init (1);
+  return node;
+}
+
+/* Index of the first word not less than 'word'. */
+static unsigned int
+cmd_trie_word_find (struct cmd_trie_node *node, const char *word)
+{
+  unsigned int low = 0, high = node->word_count;
+
+  while (low < high)
+    {
+      unsigned int mid = (low + high) / 2;
+
+      if (strcmp (node->words[mid].word, word) < 0)
+	low = mid + 1;
+      else
+	high = mid;
+    }
+  return low;
+}
+
+static void
+cmd_trie_word_add (struct cmd_trie_node *node, const char *word,
+		   struct cmd_trie_edge *edge)
+{
+  unsigned int i;
+
+  if (node->word_count == node->word_size)
+    {
+      node->word_size = node->word_size ? node->word_size * 2 : 4;
+      node->words = XREALLOC (MTYPE_CMD_TRIE, node->words,
+			      node->word_size * sizeof (struct cmd_trie_word));
+    }
+  i = cmd_trie_word_find (node, word);
+  memmove (&node->words[i + 1], &node->words[i],
+	   (node->word_count - i) * sizeof (struct cmd_trie_word));
+  node->words[i].word = word;
+  node->words[i].edge = edge;
+  node->word_count++;
+}
+
+static int
+cmd_trie_descvec_same (vector a, vector b)
+{
+  unsigned int i;
+
+  if (vector_active (a) != vector_active (b))
+    return 0;
+  for (i = 0; i < vector_active (a); i++)
+    {
+      struct desc *da = vector_slot (a, i);
+      struct desc *db = vector_slot (b, i);
+
+      if (strcmp (da->cmd, db->cmd) != 0)
+	return 0;
+    }
+  return 1;
+}
+
+static struct cmd_trie_edge *
+cmd_trie_edge_get (struct cmd_trie_node *node, vector descvec)
+{
+  struct cmd_trie_edge *edge;
+  struct desc *desc;
+  unsigned int i;
+  int keyword = 1;
+
+  for (i = 0; i < vector_active (node->edges); i++)
+    {
+      edge = vector_slot (node->edges, i);
+      if (cmd_trie_descvec_same (edge->descvec, descvec))
+	return edge;
+    }
+
+  edge = XCALLOC (MTYPE_CMD_TRIE, sizeof (struct cmd_trie_edge));
+  edge->descvec = descvec;
+  edge->child = cmd_trie_node_new (node->depth + 1);
+  vector_set (node->edges, edge);
+
+  for (i = 0; i < vector_active (descvec); i++)
+    if ((desc = vector_slot (descvec, i)) && !CMD_KEYWORD (desc->cmd))
+      keyword = 0;
+  if (keyword)
+    {
+      for (i = 0; i < vector_active (descvec); i++)
+	if ((desc = vector_slot (descvec, i)))
+	  cmd_trie_word_add (node, desc->cmd, edge);
+    }
+  else
+    vector_set (node->special, edge);
+  return edge;
+}
+
+static void
+cmd_trie_insert (struct cmd_trie_node *node, struct cmd_element *cmd)
+{
+  unsigned int i;
+
+  if (cmd->strvec == NULL)
+    return;
+  for (i = 0; i < vector_active (cmd->strvec); i++)
+    {
+      node = cmd_trie_edge_get (node, vector_slot (cmd->strvec, i))->child;
+      if (cmd->cmdsize <= node->depth)
+	vector_set (node->complete, cmd);
+      else
+	node->incomplete++;
+      node->count++;
+      node->last = cmd;
+    }
+}
+
+/* Add the edges of 'node' which pass cmd_filter_by_string for 'command'
+   to 'pass', returns the best match type. */
+static enum match_type
+cmd_trie_filter (struct cmd_trie_node *node, const char *command,
+		 vector pass, enum match_type match_type)
+{
+  struct cmd_trie_edge *edge = NULL;
+  struct desc *desc;
+  unsigned int i, j;
+
+  for (i = cmd_trie_word_find (node, command);
+       i < node->word_count && strcmp (node->words[i].word, command) == 0;
+       i++)
+    {
+      /* "(a|a)" lists the edge twice. */
+      if (edge != node->words[i].edge)
+	vector_set (pass, node->words[i].edge);
+      edge = node->words[i].edge;
+      match_type = exact_match;
+    }
+
+  for (i = 0; i < vector_active (node->special); i++)
+    {
+      int matched = 0;
+
+      edge = vector_slot (node->special, i);
+      for (j = 0; j < vector_active (edge->descvec); j++)
+	if ((desc = vector_slot (edge->descvec, j)))
+	  {
+	    enum match_type ret = cmd_desc_filter (desc->cmd, command);
+
+	    if (ret != no_match)
+	      {
+		if (match_type < ret)
+		  match_type = ret;
+		matched++;
+	      }
+	  }
+      if (matched)
+	vector_set (pass, edge);
+    }
+  return match_type;
+}
+
+/* The matching part of cmd_execute_command_strict over the trie. */
+static int
+cmd_trie_match (struct cmd_trie_node *root, vector vline,
+		struct cmd_element **matched_element)
+{
+  vector frontier, pass;
+  unsigned int index, i, j;
+  unsigned int matched_count = 0, incomplete_count = 0;
+  enum match_type match;
+  struct cmd_trie_node *node;
+  struct cmd_trie_edge *edge;
+  struct desc *desc;
+  int ret = CMD_SUCCESS;
+
+  frontier = vector_init (1);
+  vector_set (frontier, root);
+  *matched_element = NULL;
+
+  for (index = 0; index < vector_active (vline); index++)
+    {
+      char *command = vector_slot (vline, index);
+      const char *matched = NULL;
+
+      pass = vector_init (1);
+      match = no_match;
+      for (i = 0; i < vector_active (frontier); i++)
+	match = cmd_trie_filter (vector_slot (frontier, i), command, pass,
+				 match);
+      vector_free (frontier);
+
+      /* If command meets '.VARARG' then finish matching: everything
+         below the passing edges matches. */
+      if (match == vararg_match)
+	{
+	  for (i = 0; i < vector_active (pass); i++)
+	    {
+	      node = ((struct cmd_trie_edge *) vector_slot (pass, i))->child;
+	      matched_count += node->count;
+	      *matched_element = node->last;
+	    }
+	  vector_free (pass);
+	  goto count;
+	}
+
+      frontier = vector_init (1);
+      for (i = 0; i < vector_active (pass); i++)
+	{
+	  int stay = 0;
+
+	  edge = vector_slot (pass, i);
+	  for (j = 0; j < vector_active (edge->descvec); j++)
+	    if ((desc = vector_slot (edge->descvec, j)))
+	      {
+		int amb = cmd_desc_ambiguous (desc->cmd, command, match,
+					      &matched);
+
+		if (amb < 0)
+		  {
+		    ret = (amb == -1) ? CMD_ERR_AMBIGUOUS : CMD_ERR_NO_MATCH;
+		    vector_free (pass);
+		    vector_free (frontier);
+		    return ret;
+		  }
+		stay += amb;
+	      }
+	  if (stay)
+	    vector_set (frontier, edge->child);
+	}
+      vector_free (pass);
+    }
+
+  for (i = 0; i < vector_active (frontier); i++)
+    {
+      node = vector_slot (frontier, i);
+      matched_count += vector_active (node->complete);
+      incomplete_count += node->incomplete;
+      if (vector_active (node->complete))
+	*matched_element = vector_slot (node->complete, 0);
+    }
+  vector_free (frontier);
+
+ count:
+  /* To execute command, matched_count must be 1. */
+  if (matched_count == 0)
+    return incomplete_count ? CMD_ERR_INCOMPLETE : CMD_ERR_NO_MATCH;
+  if (matched_count > 1)
+    return CMD_ERR_AMBIGUOUS;
+  return CMD_SUCCESS;
+}
+
 /* If src matches dst return dst string, otherwise return NULL */
 static const char *
 cmd_entry_function (const char *src, const char *dst)
@@ -2169,10 +2486,10 @@ cmd_execute_command (vector vline, struct vty *vty, struct cmd_element **cmd,
   return saved_ret;
 }
 
-/* Execute command by argument readline. */
-int
-cmd_execute_command_strict (vector vline, struct vty *vty,
-			    struct cmd_element **cmd)
+/* Find the command of 'node' matching vline exactly, the linear way. */
+static int
+cmd_match_strict (vector vline, struct cmd_node *cnode,
+		  struct cmd_element **matched)
 {
   unsigned int i;
   unsigned int index;
@@ -2180,14 +2497,11 @@ cmd_execute_command_strict (vector vline, struct vty *vty,
   struct cmd_element *cmd_element;
   struct cmd_element *matched_element;
   unsigned int matched_count, incomplete_count;
-  int argc;
-  const char *argv[CMD_ARGC_MAX];
-  int varflag;
   enum match_type match = 0;
   char *command;
 
   /* Make copy of command element */
-  cmd_vector = vector_copy (cmd_node_vector (cmdvec, vty->node));
+  cmd_vector = vector_copy (cnode->cmd_vector);
 
   for (index = 0; index < vector_active (vline); index++)
     if ((command = vector_slot (vline, index)))
@@ -2247,6 +2561,37 @@ cmd_execute_command_strict (vector vline, struct vty *vty,
   if (matched_count > 1)
     return CMD_ERR_AMBIGUOUS;
 
+  *matched = matched_element;
+  return CMD_SUCCESS;
+}
+
+/* Execute command by argument readline. */
+int
+cmd_execute_command_strict (vector vline, struct vty *vty,
+			    struct cmd_element **cmd)
+{
+  unsigned int i;
+  struct cmd_node *cnode;
+  struct cmd_element *matched_element;
+  int argc;
+  const char *argv[CMD_ARGC_MAX];
+  int varflag;
+  int ret;
+
+  cnode = vector_slot (cmdvec, vty->node);
+
+  /* The trie walk does not skip empty tokens, leave such lines to the
+     linear match. */
+  for (i = 0; i < vector_active (vline); i++)
+    if (vector_slot (vline, i) == NULL)
+      break;
+  if (cnode->trie && vector_active (vline) && i == vector_active (vline))
+    ret = cmd_trie_match (cnode->trie, vline, &matched_element);
+  else
+    ret = cmd_match_strict (vline, cnode, &matched_element);
+  if (ret != CMD_SUCCESS)
+    return ret;
+
   /* Argument treatment */
   varflag = 0;
   argc = 0;
@@ -3049,6 +3394,15 @@ DEFUN (config_logmsg,
   return CMD_SUCCESS;
 }
 
+static void
+show_logging_buffer (struct vty *vty, const char *name,
+		     struct zlog_buffer *zb)
+{
+  vty_out (vty, "  %s: %lu lines queued, %lu dropped, %lu writes, "
+	   "%lu bytes pending%s", name, zb->queued, zb->dropped,
+	   zb->writes, (u_long) zb->len, VTY_NEWLINE);
+}
+
 DEFUN (show_logging,
        show_logging_cmd,
        "show logging",
@@ -3099,6 +3453,17 @@ DEFUN (show_logging,
   vty_out (vty, "Timestamp precision: %d%s",
 	   zl->timestamp_precision, VTY_NEWLINE);
 
+  vty_out (vty, "Asynchronous logging: ");
+  if (!zl->async_size)
+    vty_out (vty, "disabled%s", VTY_NEWLINE);
+  else
+    {
+      vty_out (vty, "buffer size %lu%s", (u_long) zl->async_size,
+	       VTY_NEWLINE);
+      show_logging_buffer (vty, "File", &zl->async[ZLOG_DEST_FILE]);
+      show_logging_buffer (vty, "Stdout", &zl->async[ZLOG_DEST_STDOUT]);
+    }
+
   return CMD_SUCCESS;
 }
 
@@ -3453,6 +3818,82 @@ DEFUN (no_config_log_timestamp_precision,
   return CMD_SUCCESS;
 }
 
+DEFUN (config_log_async,
+       config_log_async_cmd,
+       "log async",
+       "Logging control\n"
+       "Queue file and stdout logging and write it in batches\n")
+{
+  zlog_set_async (NULL, ZLOG_ASYNC_DEFAULT_SIZE);
+  return CMD_SUCCESS;
+}
+
+DEFUN (config_log_async_size,
+       config_log_async_size_cmd,
+       "log async <4096-16777216>",
+       "Logging control\n"
+       "Queue file and stdout logging and write it in batches\n"
+       "Buffer size per destination in bytes\n")
+{
+  size_t size;
+
+  VTY_GET_INTEGER_RANGE ("Buffer size", size, argv[0], 4096, 16777216);
+  zlog_set_async (NULL, size);
+  return CMD_SUCCESS;
+}
+
+DEFUN (no_config_log_async,
+       no_config_log_async_cmd,
+       "no log async",
+       NO_STR
+       "Logging control\n"
+       "Write file and stdout logging as it is logged\n")
+{
+  zlog_set_async (NULL, 0);
+  return CMD_SUCCESS;
+}
+
+ALIAS (no_config_log_async,
+       no_config_log_async_size_cmd,
+       "no log async <4096-16777216>",
+       NO_STR
+       "Logging control\n"
+       "Write file and stdout logging as it is logged\n"
+       "Buffer size per destination in bytes\n")
+
+DEFUN (thread_slow_warning,
+       thread_slow_warning_cmd,
+       "thread slow-warning <1-3600000>",
+       "Thread scheduler\n"
+       "Warn of callbacks and commands running longer than this\n"
+       "Milliseconds\n")
+{
+  unsigned long msec;
+
+  VTY_GET_INTEGER_RANGE ("milliseconds", msec, argv[0], 1, 3600000);
+  thread_set_slow_warning (msec);
+  return CMD_SUCCESS;
+}
+
+DEFUN (no_thread_slow_warning,
+       no_thread_slow_warning_cmd,
+       "no thread slow-warning",
+       NO_STR
+       "Thread scheduler\n"
+       "Warn of callbacks and commands running longer than this\n")
+{
+  thread_set_slow_warning (0);
+  return CMD_SUCCESS;
+}
+
+ALIAS (no_thread_slow_warning,
+       no_thread_slow_warning_val_cmd,
+       "no thread slow-warning <1-3600000>",
+       NO_STR
+       "Thread scheduler\n"
+       "Warn of callbacks and commands running longer than this\n"
+       "Milliseconds\n")
+
 DEFUN (banner_motd_file,
        banner_motd_file_cmd,
        "banner motd file [FILE]",
@@ -3610,6 +4051,13 @@ cmd_init (int terminal)
       install_element (CONFIG_NODE, &no_config_log_record_priority_cmd);
       install_element (CONFIG_NODE, &config_log_timestamp_precision_cmd);
       install_element (CONFIG_NODE, &no_config_log_timestamp_precision_cmd);
+      install_element (CONFIG_NODE, &config_log_async_cmd);
+      install_element (CONFIG_NODE, &config_log_async_size_cmd);
+      install_element (CONFIG_NODE, &no_config_log_async_cmd);
+      install_element (CONFIG_NODE, &no_config_log_async_size_cmd);
+      install_element (CONFIG_NODE, &thread_slow_warning_cmd);
+      install_element (CONFIG_NODE, &no_thread_slow_warning_cmd);
+      install_element (CONFIG_NODE, &no_thread_slow_warning_val_cmd);
       install_element (CONFIG_NODE, &service_password_encrypt_cmd);
       install_element (CONFIG_NODE, &no_service_password_encrypt_cmd);
       install_element (CONFIG_NODE, &banner_motd_default_cmd);
@@ -3620,6 +4068,10 @@ cmd_init (int terminal)
 
       install_element (VIEW_NODE, &show_thread_cpu_cmd);
       install_element (ENABLE_NODE, &show_thread_cpu_cmd);
+      install_element (VIEW_NODE, &show_thread_latency_cmd);
+      install_element (ENABLE_NODE, &show_thread_latency_cmd);
+      install_element (VIEW_NODE, &show_thread_health_cmd);
+      install_element (ENABLE_NODE, &show_thread_health_cmd);
       install_element (VIEW_NODE, &show_work_queues_cmd);
       install_element (ENABLE_NODE, &show_work_queues_cmd);
     }
@@ -121,6 +121,9 @@ struct cmd_node
 
   /* Vector of this node's command list. */
   vector cmd_vector;	
+
+  /* Token trie of the command list, for cmd_execute_command_strict. */
+  struct cmd_trie_node *trie;
 };
 
 enum
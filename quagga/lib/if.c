@@ -35,6 +35,7 @@
 #include "buffer.h"
 #include "str.h"
 #include "log.h"
+#include "hash.h"
 
 /* Master list of interfaces. */
 struct list *iflist;
@@ -46,6 +47,17 @@ struct if_master
   int (*if_delete_hook) (struct interface *);
 } if_master;
 
+/* Indexes of the interface list: interfaces by ifindex and by name, and
+   their IPv4 connected addresses by prefix and by local address.  The
+   route table nodes hold lists of struct connected. */
+static struct hash *if_index_hash;
+static struct hash *if_name_hash;
+static struct route_table *ifaddr_ipv4_table;
+static struct route_table *ifaddr_ipv4_host_table;
+
+static void connected_index (struct connected *);
+static void connected_unindex (struct connected *);
+
 /* Compare interface names, returning an integer greater than, equal to, or
  * less than 0, (following the strcmp convention), according to the
  * relationship between ifp1 and ifp2.  Interface names consist of an
@@ -111,12 +123,96 @@ if_cmp_func (struct interface *ifp1, struct interface *ifp2)
   return 0;
 }
 
+static unsigned int
+if_index_hash_key (void *arg)
+{
+  return ((struct interface *) arg)->ifindex;
+}
+
+static int
+if_index_hash_cmp (void *a, void *b)
+{
+  return ((struct interface *) a)->ifindex == ((struct interface *) b)->ifindex;
+}
+
+static unsigned int
+if_name_hash_key (void *arg)
+{
+  const char *name = ((struct interface *) arg)->name;
+  unsigned int key = 0;
+
+  while (*name)
+    key = (key * 33) + (unsigned char) *name++;
+  return key;
+}
+
+static int
+if_name_hash_cmp (void *a, void *b)
+{
+  return strcmp (((struct interface *) a)->name,
+		 ((struct interface *) b)->name) == 0;
+}
+
+/* Not every daemon calls if_init, so the indexes come with the first
+   interface. */
+static void
+if_index_init (void)
+{
+  if (if_index_hash)
+    return;
+  if_index_hash = hash_create (if_index_hash_key, if_index_hash_cmp);
+  if_name_hash = hash_create (if_name_hash_key, if_name_hash_cmp);
+  ifaddr_ipv4_table = route_table_init ();
+  ifaddr_ipv4_host_table = route_table_init ();
+}
+
+static void
+if_index_link (struct interface *ifp)
+{
+  if (ifp->ifindex != IFINDEX_INTERNAL)
+    hash_get (if_index_hash, ifp, hash_alloc_intern);
+}
+
+static void
+if_index_unlink (struct interface *ifp)
+{
+  struct listnode *node;
+  struct interface *other;
+
+  if (ifp->ifindex == IFINDEX_INTERNAL
+      || hash_lookup (if_index_hash, ifp) != ifp)
+    return;
+  hash_release (if_index_hash, ifp);
+
+  /* Another interface may be claiming the same index for a moment. */
+  for (ALL_LIST_ELEMENTS_RO (iflist, node, other))
+    if (other != ifp && other->ifindex == ifp->ifindex)
+      {
+	hash_get (if_index_hash, other, hash_alloc_intern);
+	break;
+      }
+}
+
+/* Change the ifindex of an interface, all changes must go through here
+   to keep if_lookup_by_index working. */
+void
+if_set_index (struct interface *ifp, unsigned int ifindex)
+{
+  if (ifp->ifindex == ifindex)
+    return;
+  if_index_unlink (ifp);
+  ifp->ifindex = ifindex;
+  if_index_link (ifp);
+}
+
 /* Create new interface structure. */
 struct interface *
 if_create (const char *name, int namelen)
 {
   struct interface *ifp;
 
+  if_index_init ();
+
   ifp = XCALLOC (MTYPE_IF, sizeof (struct interface));
   ifp->ifindex = IFINDEX_INTERNAL;
   
@@ -125,7 +221,10 @@ if_create (const char *name, int namelen)
   strncpy (ifp->name, name, namelen);
   ifp->name[namelen] = '\0';
   if (if_lookup_by_name(ifp->name) == NULL)
-    listnode_add_sort (iflist, ifp);
+    {
+      listnode_add_sort (iflist, ifp);
+      hash_get (if_name_hash, ifp, hash_alloc_intern);
+    }
   else
     zlog_err("if_create(%s): corruption detected -- interface with this "
 	     "name exists already!", ifp->name);
@@ -142,10 +241,15 @@ if_create (const char *name, int namelen)
 void
 if_delete_retain (struct interface *ifp)
 {
+  struct listnode *node;
+  struct connected *ifc;
+
   if (if_master.if_delete_hook)
     (*if_master.if_delete_hook) (ifp);
 
   /* Free connected address list */
+  for (ALL_LIST_ELEMENTS_RO (ifp->connected, node, ifc))
+    connected_unindex (ifc);
   list_delete (ifp->connected);
 }
 
@@ -154,6 +258,9 @@ void
 if_delete (struct interface *ifp)
 {
   listnode_delete (iflist, ifp);
+  if_index_unlink (ifp);
+  if (hash_lookup (if_name_hash, ifp) == ifp)
+    hash_release (if_name_hash, ifp);
 
   if_delete_retain(ifp);
 
@@ -182,13 +289,20 @@ if_lookup_by_index (unsigned int index)
 {
   struct listnode *node;
   struct interface *ifp;
+  struct interface key;
 
-  for (ALL_LIST_ELEMENTS_RO(iflist, node, ifp))
+  /* Any number of interfaces may be internal, the first one wins. */
+  if (index == IFINDEX_INTERNAL)
     {
-      if (ifp->ifindex == index)
-	return ifp;
+      for (ALL_LIST_ELEMENTS_RO(iflist, node, ifp))
+	if (ifp->ifindex == index)
+	  return ifp;
+      return NULL;
     }
-  return NULL;
+  if (if_index_hash == NULL)
+    return NULL;
+  key.ifindex = index;
+  return hash_lookup (if_index_hash, &key);
 }
 
 const char *
@@ -212,92 +326,108 @@ ifname2ifindex (const char *name)
 struct interface *
 if_lookup_by_name (const char *name)
 {
-  struct listnode *node;
-  struct interface *ifp;
-
-  for (ALL_LIST_ELEMENTS_RO (iflist, node, ifp))
-    {
-      if (strcmp(name, ifp->name) == 0)
-	return ifp;
-    }
-  return NULL;
+  return if_lookup_by_name_len (name, strnlen (name, INTERFACE_NAMSIZ + 1));
 }
 
 struct interface *
 if_lookup_by_name_len(const char *name, size_t namelen)
 {
-  struct listnode *node;
-  struct interface *ifp;
+  struct interface key;
+  size_t i;
 
-  if (namelen > INTERFACE_NAMSIZ)
+  if (namelen > INTERFACE_NAMSIZ || if_name_hash == NULL)
     return NULL;
 
-  for (ALL_LIST_ELEMENTS_RO (iflist, node, ifp))
+  memcpy (key.name, name, namelen);
+  key.name[namelen] = '\0';
+  /* Trailing NULs inside namelen compare equal to the name's padding,
+     anything after them never does. */
+  for (i = strlen (key.name); i < namelen; i++)
+    if (key.name[i] != '\0')
+      return NULL;
+  return hash_lookup (if_name_hash, &key);
+}
+
+/* Of the interfaces owning the connected addresses in 'list' which
+   satisfy 'match', the one with the longest address prefix, first in
+   interface order on a tie. */
+static struct interface *
+ifaddr_ipv4_best (struct list *list, struct prefix *addr,
+		  struct interface *best, int *bestlen)
+{
+  struct listnode *node;
+  struct connected *c;
+
+  for (ALL_LIST_ELEMENTS_RO (list, node, c))
     {
-      if (!memcmp(name, ifp->name, namelen) && (ifp->name[namelen] == '\0'))
-	return ifp;
+      if (! prefix_match (CONNECTED_PREFIX (c), addr))
+	continue;
+      if (c->address->prefixlen > *bestlen
+	  || (c->address->prefixlen == *bestlen && best
+	      && if_cmp_func (c->ifp, best) < 0))
+	{
+	  *bestlen = c->address->prefixlen;
+	  best = c->ifp;
+	}
     }
-  return NULL;
+  return best;
 }
 
 /* Lookup interface by IPv4 address. */
 struct interface *
 if_lookup_exact_address (struct in_addr src)
 {
+  struct prefix_ipv4 p;
+  struct route_node *rn;
   struct listnode *node;
-  struct listnode *cnode;
-  struct interface *ifp;
-  struct prefix *p;
   struct connected *c;
+  struct interface *ifp = NULL;
 
-  for (ALL_LIST_ELEMENTS_RO (iflist, node, ifp))
-    {
-      for (ALL_LIST_ELEMENTS_RO (ifp->connected, cnode, c))
-	{
-	  p = c->address;
+  if (ifaddr_ipv4_host_table == NULL)
+    return NULL;
 
-	  if (p && p->family == AF_INET)
-	    {
-	      if (IPV4_ADDR_SAME (&p->u.prefix4, &src))
-		return ifp;
-	    }	      
-	}
-    }
-  return NULL;
+  p.family = AF_INET;
+  p.prefixlen = IPV4_MAX_PREFIXLEN;
+  p.prefix = src;
+
+  rn = route_node_lookup (ifaddr_ipv4_host_table, (struct prefix *) &p);
+  if (! rn)
+    return NULL;
+
+  for (ALL_LIST_ELEMENTS_RO ((struct list *) rn->info, node, c))
+    if (! ifp || if_cmp_func (c->ifp, ifp) < 0)
+      ifp = c->ifp;
+  route_unlock_node (rn);
+  return ifp;
 }
 
 /* Lookup interface by IPv4 address. */
 struct interface *
 if_lookup_address (struct in_addr src)
 {
-  struct listnode *node;
   struct prefix addr;
   int bestlen = 0;
-  struct listnode *cnode;
+  struct route_node *rn, *match;
   struct interface *ifp;
-  struct connected *c;
-  struct interface *match;
+
+  if (ifaddr_ipv4_table == NULL)
+    return NULL;
 
   addr.family = AF_INET;
   addr.u.prefix4 = src;
   addr.prefixlen = IPV4_MAX_BITLEN;
 
-  match = NULL;
-
-  for (ALL_LIST_ELEMENTS_RO (iflist, node, ifp))
-    {
-      for (ALL_LIST_ELEMENTS_RO (ifp->connected, cnode, c))
-	{
-	  if (c->address && (c->address->family == AF_INET) &&
-	      prefix_match(CONNECTED_PREFIX(c), &addr) &&
-	      (c->address->prefixlen > bestlen))
-	    {
-	      bestlen = c->address->prefixlen;
-	      match = ifp;
-	    }
-	}
-    }
-  return match;
+  /* The connected prefixes covering src are the matching node and its
+     ancestors.  A peer address is filed under both its local and its
+     peer prefix, so check each against src again. */
+  ifp = NULL;
+  match = route_node_match (ifaddr_ipv4_table, &addr);
+  for (rn = match; rn; rn = rn->parent)
+    if (rn->info)
+      ifp = ifaddr_ipv4_best (rn->info, &addr, ifp, &bestlen);
+  if (match)
+    route_unlock_node (match);
+  return ifp;
 }
 
 /* Get interface by name if given name interface doesn't exist create
@@ -685,6 +815,24 @@ connected_same_prefix (struct prefix *p1, struct prefix *p2)
   return 0;
 }
 
+/* Add a connected address to the interface, the address and
+   destination prefixes must be set and stay unchanged until
+   connected_delete. */
+void
+connected_add (struct interface *ifp, struct connected *ifc)
+{
+  listnode_add (ifp->connected, ifc);
+  connected_index (ifc);
+}
+
+/* Remove a connected address from the interface, it is not freed. */
+void
+connected_delete (struct interface *ifp, struct connected *ifc)
+{
+  connected_unindex (ifc);
+  listnode_delete (ifp->connected, ifc);
+}
+
 struct connected *
 connected_delete_by_prefix (struct interface *ifp, struct prefix *p)
 {
@@ -700,7 +848,7 @@ connected_delete_by_prefix (struct interface *ifp, struct prefix *p)
 
       if (connected_same_prefix (ifc->address, p))
 	{
-	  listnode_delete (ifp->connected, ifc);
+	  connected_delete (ifp, ifc);
 	  return ifc;
 	}
     }
@@ -755,7 +903,7 @@ connected_add_by_prefix (struct interface *ifp, struct prefix *p,
     }
 
   /* Add connected address to the interface. */
-  listnode_add (ifp->connected, ifc);
+  connected_add (ifp, ifc);
   return ifc;
 }
 
@@ -783,93 +931,98 @@ if_indextoname (unsigned int ifindex, char *name)
 }
 #endif
 
-#if 0 /* this route_table of struct connected's is unused
-       * however, it would be good to use a route_table rather than
-       * a list..
-       */
-/* Interface looking up by interface's address. */
-/* Interface's IPv4 address reverse lookup table. */
-struct route_table *ifaddr_ipv4_table;
-/* struct route_table *ifaddr_ipv6_table; */
-
+/* File a connected address under prefix p. */
 static void
-ifaddr_ipv4_add (struct in_addr *ifaddr, struct interface *ifp)
+ifaddr_ipv4_add (struct route_table *table, struct prefix *p,
+		 struct connected *ifc)
 {
   struct route_node *rn;
-  struct prefix_ipv4 p;
+  struct prefix_ipv4 key;
 
-  p.family = AF_INET;
-  p.prefixlen = IPV4_MAX_PREFIXLEN;
-  p.prefix = *ifaddr;
+  key.family = AF_INET;
+  key.prefixlen = p->prefixlen;
+  key.prefix = p->u.prefix4;
+  apply_mask_ipv4 (&key);
 
-  rn = route_node_get (ifaddr_ipv4_table, (struct prefix *) &p);
-  if (rn)
-    {
-      route_unlock_node (rn);
-      zlog_info ("ifaddr_ipv4_add(): address %s is already added",
-		 inet_ntoa (*ifaddr));
-      return;
-    }
-  rn->info = ifp;
+  rn = route_node_get (table, (struct prefix *) &key);
+  if (rn->info)
+    route_unlock_node (rn);
+  else
+    rn->info = list_new ();
+  listnode_add (rn->info, ifc);
 }
 
 static void
-ifaddr_ipv4_delete (struct in_addr *ifaddr, struct interface *ifp)
+ifaddr_ipv4_delete (struct route_table *table, struct prefix *p,
+		    struct connected *ifc)
 {
   struct route_node *rn;
-  struct prefix_ipv4 p;
+  struct prefix_ipv4 key;
 
-  p.family = AF_INET;
-  p.prefixlen = IPV4_MAX_PREFIXLEN;
-  p.prefix = *ifaddr;
+  key.family = AF_INET;
+  key.prefixlen = p->prefixlen;
+  key.prefix = p->u.prefix4;
+  apply_mask_ipv4 (&key);
 
-  rn = route_node_lookup (ifaddr_ipv4_table, (struct prefix *) &p);
+  rn = route_node_lookup (table, (struct prefix *) &key);
   if (! rn)
+    return;
+  listnode_delete (rn->info, ifc);
+  if (list_isempty ((struct list *) rn->info))
     {
-      zlog_info ("ifaddr_ipv4_delete(): can't find address %s",
-		 inet_ntoa (*ifaddr));
-      return;
+      list_delete (rn->info);
+      rn->info = NULL;
+      route_unlock_node (rn);
     }
-  rn->info = NULL;
-  route_unlock_node (rn);
   route_unlock_node (rn);
 }
 
-/* Lookup interface by interface's IP address or interface index. */
-static struct interface *
-ifaddr_ipv4_lookup (struct in_addr *addr, unsigned int ifindex)
+/* The keys of an IPv4 connected address: its local address, its prefix
+   and, for a peer in another prefix, the peer prefix. */
+static void
+connected_index (struct connected *ifc)
 {
-  struct prefix_ipv4 p;
-  struct route_node *rn;
-  struct interface *ifp;
+  struct prefix host;
+  struct prefix *p = ifc->address;
+  struct prefix *d = ifc->destination;
 
-  if (addr)
-    {
-      p.family = AF_INET;
-      p.prefixlen = IPV4_MAX_PREFIXLEN;
-      p.prefix = *addr;
-
-      rn = route_node_lookup (ifaddr_ipv4_table, (struct prefix *) &p);
-      if (! rn)
-	return NULL;
-      
-      ifp = rn->info;
-      route_unlock_node (rn);
-      return ifp;
-    }
-  else
-    return if_lookup_by_index(ifindex);
+  if (! p || p->family != AF_INET)
+    return;
+
+  host = *p;
+  host.prefixlen = IPV4_MAX_PREFIXLEN;
+  ifaddr_ipv4_add (ifaddr_ipv4_host_table, &host, ifc);
+  ifaddr_ipv4_add (ifaddr_ipv4_table, p, ifc);
+  if (d && d->family == AF_INET
+      && (d->prefixlen != p->prefixlen || ! prefix_match (p, d)))
+    ifaddr_ipv4_add (ifaddr_ipv4_table, d, ifc);
+}
+
+static void
+connected_unindex (struct connected *ifc)
+{
+  struct prefix host;
+  struct prefix *p = ifc->address;
+  struct prefix *d = ifc->destination;
+
+  if (! p || p->family != AF_INET || ! ifaddr_ipv4_table)
+    return;
+
+  host = *p;
+  host.prefixlen = IPV4_MAX_PREFIXLEN;
+  ifaddr_ipv4_delete (ifaddr_ipv4_host_table, &host, ifc);
+  ifaddr_ipv4_delete (ifaddr_ipv4_table, p, ifc);
+  if (d && d->family == AF_INET
+      && (d->prefixlen != p->prefixlen || ! prefix_match (p, d)))
+    ifaddr_ipv4_delete (ifaddr_ipv4_table, d, ifc);
 }
-#endif /* ifaddr_ipv4_table */
 
 /* Initialize interface list. */
 void
 if_init (void)
 {
   iflist = list_new ();
-#if 0
-  ifaddr_ipv4_table = route_table_init ();
-#endif /* ifaddr_ipv4_table */
+  if_index_init ();
 
   if (iflist) {
     iflist->cmp = (int (*)(void *, void *))if_cmp_func;
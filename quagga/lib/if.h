@@ -75,13 +75,13 @@ struct interface
      interface is created, because the configuration info for this interface
      is associated with this structure.  For that reason, the interface
      should also never be deleted (to avoid losing configuration info).
-     To delete, just set ifindex to IFINDEX_INTERNAL to indicate that the
-     interface does not exist in the kernel.
+     To delete, just set ifindex to IFINDEX_INTERNAL (with if_set_index) to
+     indicate that the interface does not exist in the kernel.
    */
   char name[INTERFACE_NAMSIZ + 1];
 
   /* Interface index (should be IFINDEX_INTERNAL for non-kernel or
-     deleted interfaces). */
+     deleted interfaces).  Change it with if_set_index only. */
   unsigned int ifindex;
 #define IFINDEX_INTERNAL	0
 
@@ -145,11 +145,14 @@ struct connected
   u_char conf;
 #define ZEBRA_IFC_REAL         (1 << 0)
 #define ZEBRA_IFC_CONFIGURED   (1 << 1)
+#define ZEBRA_IFC_STALE        (1 << 2)
   /*
      The ZEBRA_IFC_REAL flag should be set if and only if this address
      exists in the kernel.
      The ZEBRA_IFC_CONFIGURED flag should be set if and only if this address
      was configured by the user from inside quagga.
+     The ZEBRA_IFC_STALE flag is set by zebra while it reads the kernel's
+     addresses again, on those not read back yet.
    */
 
   /* Flags for connected address. */
@@ -231,6 +234,7 @@ struct connected
 /* Prototypes. */
 extern int if_cmp_func (struct interface *, struct interface *);
 extern struct interface *if_create (const char *name, int namelen);
+extern void if_set_index (struct interface *, unsigned int);
 extern struct interface *if_lookup_by_index (unsigned int);
 extern struct interface *if_lookup_exact_address (struct in_addr);
 extern struct interface *if_lookup_address (struct in_addr);
@@ -283,6 +287,7 @@ extern unsigned int ifname2ifindex(const char *ifname);
 extern struct connected *connected_new (void);
 extern void connected_free (struct connected *);
 extern void connected_add (struct interface *, struct connected *);
+extern void connected_delete (struct interface *, struct connected *);
 extern struct connected  *connected_add_by_prefix (struct interface *,
                                             struct prefix *,
                                             struct prefix *);
@@ -141,11 +141,166 @@ time_print(FILE *fp, struct timestamp_control *ctl)
 }
   
 
+/* Write out what is queued, using only async-signal-safe calls.  What
+   the descriptor does not take stays queued. */
+static void
+zlog_buffer_write (struct zlog_buffer *zb, int fd)
+{
+  size_t off = 0;
+  ssize_t n;
+
+  if (fd < 0)
+    {
+      zb->len = 0;
+      return;
+    }
+  while (off < zb->len)
+    {
+      if ((n = write (fd, zb->buf + off, zb->len - off)) < 0)
+	{
+	  if (errno == EINTR)
+	    continue;
+	  break;
+	}
+      off += n;
+    }
+  if (off < zb->len)
+    memmove (zb->buf, zb->buf + off, zb->len - off);
+  zb->len -= off;
+}
+
+static int
+zlog_dest_fd (struct zlog *zl, zlog_dest_t dest)
+{
+  if (dest == ZLOG_DEST_STDOUT)
+    return STDOUT_FILENO;
+  return (zl->fp ? fileno (zl->fp) : -1);
+}
+
+static void
+zlog_buffer_flush (struct zlog *zl, zlog_dest_t dest)
+{
+  struct zlog_buffer *zb = &zl->async[dest];
+  int fd = zlog_dest_fd (zl, dest);
+
+  if (zb->len)
+    {
+      zlog_buffer_write (zb, fd);
+      zb->writes++;
+    }
+  if (zb->unreported && (zb->len == 0) && (fd >= 0))
+    {
+      char note[128];
+      size_t len;
+
+      len = quagga_timestamp (zl->timestamp_precision, note, sizeof (note));
+      len += snprintf (note + len, sizeof (note) - len,
+		       " %s: %lu log messages dropped\n",
+		       zlog_proto_names[zl->protocol], zb->unreported);
+      if (len < sizeof (note))
+	write (fd, note, len);
+      zb->unreported = 0;
+    }
+}
+
+void
+zlog_flush (struct zlog *zl)
+{
+  if (zl == NULL)
+    zl = zlog_default;
+  if ((zl == NULL) || (zl->async_size == 0))
+    return;
+  zlog_buffer_flush (zl, ZLOG_DEST_FILE);
+  zlog_buffer_flush (zl, ZLOG_DEST_STDOUT);
+}
+
+static void
+zlog_flush_default (void)
+{
+  zlog_flush (NULL);
+}
+
+void
+zlog_set_async (struct zlog *zl, size_t size)
+{
+  static int registered;
+  int dest;
+
+  if (zl == NULL)
+    zl = zlog_default;
+
+  zlog_flush (zl);
+  for (dest = 0; dest < ZLOG_NUM_DESTS; dest++)
+    {
+      struct zlog_buffer *zb = &zl->async[dest];
+
+      if ((dest != ZLOG_DEST_FILE) && (dest != ZLOG_DEST_STDOUT))
+	continue;
+      if (zb->buf)
+	XFREE (MTYPE_ZLOG, zb->buf);
+      zb->buf = (size ? XMALLOC (MTYPE_ZLOG, size) : NULL);
+      zb->len = 0;
+    }
+  zl->async_size = size;
+
+  if (size && !registered)
+    {
+      atexit (zlog_flush_default);
+      registered = 1;
+    }
+}
+
+static void
+zlog_write (struct zlog *zl, zlog_dest_t dest, int priority,
+	    const char *line, size_t len)
+{
+  struct zlog_buffer *zb = &zl->async[dest];
+
+  if (zl->async_size == 0)
+    {
+      FILE *fp = (dest == ZLOG_DEST_FILE) ? zl->fp : stdout;
+
+      fwrite (line, 1, len, fp);
+      fflush (fp);
+      return;
+    }
+
+  /* errors are neither held back nor dropped */
+  if ((priority <= LOG_ERR) && (zb->len + len > zl->async_size))
+    zlog_buffer_flush (zl, dest);
+  if (zb->len + len <= zl->async_size)
+    {
+      memcpy (zb->buf + zb->len, line, len);
+      zb->len += len;
+      zb->queued++;
+    }
+  else if ((priority <= LOG_ERR) && (zb->len == 0))
+    {
+      int fd = zlog_dest_fd (zl, dest);
+
+      if (fd >= 0)
+	write (fd, line, len);
+      zb->queued++;
+    }
+  else
+    {
+      zb->dropped++;
+      zb->unreported++;
+    }
+  if (priority <= LOG_ERR)
+    zlog_buffer_flush (zl, dest);
+}
+
 /* va_list version of zlog. */
 static void
 vzlog (struct zlog *zl, int priority, const char *format, va_list args)
 {
   struct timestamp_control tsctl;
+  char buf[1024];
+  char *line = buf;
+  int hdrlen = 0, len = 0;
+  int to_syslog, to_file, to_stdout;
+
   tsctl.already_rendered = 0;
 
   /* If zlog is not specified, use default one. */
@@ -167,44 +322,54 @@ vzlog (struct zlog *zl, int priority, const char *format, va_list args)
     }
   tsctl.precision = zl->timestamp_precision;
 
-  /* Syslog output */
-  if (priority <= zl->maxlvl[ZLOG_DEST_SYSLOG])
+  to_syslog = (priority <= zl->maxlvl[ZLOG_DEST_SYSLOG]);
+  to_file = ((priority <= zl->maxlvl[ZLOG_DEST_FILE]) && zl->fp);
+  to_stdout = (priority <= zl->maxlvl[ZLOG_DEST_STDOUT]);
+
+  /* Render the line once for syslog, file and stdout: the timestamp
+     and the prefix are followed by the message, syslog gets the
+     message only. */
+  if (to_syslog || to_file || to_stdout)
     {
       va_list ac;
-      va_copy(ac, args);
-      vsyslog (priority|zlog_default->facility, format, ac);
-      va_end(ac);
+
+      tsctl.len = quagga_timestamp (tsctl.precision, tsctl.buf,
+				    sizeof (tsctl.buf));
+      tsctl.already_rendered = 1;
+      hdrlen = snprintf (buf, sizeof (buf), "%s %s%s%s: ", tsctl.buf,
+			 (zl->record_priority ? zlog_priority[priority] : ""),
+			 (zl->record_priority ? ": " : ""),
+			 zlog_proto_names[zl->protocol]);
+      va_copy (ac, args);
+      len = vsnprintf (buf + hdrlen, sizeof (buf) - hdrlen, format, ac);
+      va_end (ac);
+      if (len < 0)
+	len = 0;
+      if ((size_t) (hdrlen + len + 2) > sizeof (buf))
+	{
+	  line = XMALLOC (MTYPE_TMP, hdrlen + len + 2);
+	  memcpy (line, buf, hdrlen);
+	  va_copy (ac, args);
+	  vsnprintf (line + hdrlen, len + 1, format, ac);
+	  va_end (ac);
+	}
+      line[hdrlen + len] = '\n';
     }
 
+  /* Syslog output */
+  if (to_syslog)
+    syslog (priority|zlog_default->facility, "%.*s", len, line + hdrlen);
+
   /* File output. */
-  if ((priority <= zl->maxlvl[ZLOG_DEST_FILE]) && zl->fp)
-    {
-      va_list ac;
-      time_print (zl->fp, &tsctl);
-      if (zl->record_priority)
-	fprintf (zl->fp, "%s: ", zlog_priority[priority]);
-      fprintf (zl->fp, "%s: ", zlog_proto_names[zl->protocol]);
-      va_copy(ac, args);
-      vfprintf (zl->fp, format, ac);
-      va_end(ac);
-      fprintf (zl->fp, "\n");
-      fflush (zl->fp);
-    }
+  if (to_file)
+    zlog_write (zl, ZLOG_DEST_FILE, priority, line, hdrlen + len + 1);
 
   /* stdout output. */
-  if (priority <= zl->maxlvl[ZLOG_DEST_STDOUT])
-    {
-      va_list ac;
-      time_print (stdout, &tsctl);
-      if (zl->record_priority)
-	fprintf (stdout, "%s: ", zlog_priority[priority]);
-      fprintf (stdout, "%s: ", zlog_proto_names[zl->protocol]);
-      va_copy(ac, args);
-      vfprintf (stdout, format, ac);
-      va_end(ac);
-      fprintf (stdout, "\n");
-      fflush (stdout);
-    }
+  if (to_stdout)
+    zlog_write (zl, ZLOG_DEST_STDOUT, priority, line, hdrlen + len + 1);
+
+  if (line != buf)
+    XFREE (MTYPE_TMP, line);
 
   /* Terminal monitor. */
   if (priority <= zl->maxlvl[ZLOG_DEST_MONITOR])
@@ -364,6 +529,14 @@ zlog_signal(int signo, const char *action
 #define LOC s,buf+sizeof(buf)-s
 
   time(&now);
+  if (zlog_default && zlog_default->async_size)
+    {
+      /* what was logged before the signal goes first */
+      zlog_buffer_write (&zlog_default->async[ZLOG_DEST_FILE],
+			 zlog_dest_fd (zlog_default, ZLOG_DEST_FILE));
+      zlog_buffer_write (&zlog_default->async[ZLOG_DEST_STDOUT],
+			 STDOUT_FILENO);
+    }
   if (zlog_default)
     {
       s = str_append(LOC,zlog_proto_names[zlog_default->protocol]);
@@ -635,6 +808,7 @@ openzlog (const char *progname, zlog_proto_t protocol,
 void
 closezlog (struct zlog *zl)
 {
+  zlog_set_async (zl, 0);
   closelog();
   fclose (zl->fp);
 
@@ -687,6 +861,8 @@ zlog_reset_file (struct zlog *zl)
   if (zl == NULL)
     zl = zlog_default;
 
+  if (zl->async_size)
+    zlog_buffer_flush (zl, ZLOG_DEST_FILE);
   if (zl->fp)
     fclose (zl->fp);
   zl->fp = NULL;
@@ -709,6 +885,8 @@ zlog_rotate (struct zlog *zl)
   if (zl == NULL)
     zl = zlog_default;
 
+  if (zl->async_size)
+    zlog_buffer_flush (zl, ZLOG_DEST_FILE);
   if (zl->fp)
     fclose (zl->fp);
   zl->fp = NULL;
@@ -847,6 +1025,10 @@ static const struct zebra_desc_table command_types[] = {
   DESC_ENTRY	(ZEBRA_ROUTER_ID_ADD),
   DESC_ENTRY	(ZEBRA_ROUTER_ID_DELETE),
   DESC_ENTRY	(ZEBRA_ROUTER_ID_UPDATE),
+  DESC_ENTRY	(ZEBRA_IPV4_ROUTE_ADD_BULK),
+  DESC_ENTRY	(ZEBRA_IPV4_ROUTE_DELETE_BULK),
+  DESC_ENTRY	(ZEBRA_IPV6_ROUTE_ADD_BULK),
+  DESC_ENTRY	(ZEBRA_IPV6_ROUTE_DELETE_BULK),
 };
 #undef DESC_ENTRY
 
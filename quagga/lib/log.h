@@ -70,6 +70,19 @@ typedef enum
 } zlog_dest_t;
 #define ZLOG_NUM_DESTS		(ZLOG_DEST_FILE+1)
 
+/* Lines queued for a logging destination with asynchronous logging. */
+struct zlog_buffer
+{
+  char *buf;
+  size_t len;
+  u_long queued;	/* lines accepted */
+  u_long dropped;	/* lines dropped because the buffer was full */
+  u_long unreported;	/* dropped lines not yet noted in the log */
+  u_long writes;	/* batches written */
+};
+
+#define ZLOG_ASYNC_DEFAULT_SIZE	(256 * 1024)
+
 struct zlog 
 {
   const char *ident;	/* daemon name (first arg to openlog) */
@@ -84,6 +97,8 @@ struct zlog
   			   priority of the message? */
   int syslog_options;	/* 2nd arg to openlog */
   int timestamp_precision;	/* # of digits of subsecond precision */
+  size_t async_size;	/* buffer size per destination, 0 if synchronous */
+  struct zlog_buffer async[ZLOG_NUM_DESTS];	/* file and stdout only */
 };
 
 /* Message structure. */
@@ -141,6 +156,14 @@ extern int zlog_reset_file (struct zlog *zl);
 /* Rotate log. */
 extern int zlog_rotate (struct zlog *);
 
+/* Queue the file and stdout output in buffers of the given size instead
+   of writing every line as it is logged; 0 returns to synchronous
+   logging.  The buffers are written by zlog_flush, which the thread
+   scheduler calls before it blocks, and right away for errors.  Lines
+   not fitting in a buffer are dropped and counted. */
+extern void zlog_set_async (struct zlog *zl, size_t size);
+extern void zlog_flush (struct zlog *zl);
+
 /* For hackey massage lookup and check */
 #define LOOKUP(x, y) mes_lookup(x, x ## _max, y, "(no item found)")
 
@@ -58,6 +58,7 @@ struct memory_list memory_list_lib[] =
   { MTYPE_ROUTE_MAP_RULE_STR,	"Route map rule str"		},
   { MTYPE_ROUTE_MAP_COMPILED,	"Route map compiled"		},
   { MTYPE_DESC,			"Command desc"			},
+  { MTYPE_CMD_TRIE,		"Command trie"			},
   { MTYPE_KEY,			"Key"				},
   { MTYPE_KEYCHAIN,		"Key chain"			},
   { MTYPE_IF_RMAP,		"Interface route map"		},
@@ -81,10 +82,14 @@ struct memory_list memory_list_zebra[] =
   { MTYPE_VRF,			"VRF"				},
   { MTYPE_VRF_NAME,		"VRF name"			},
   { MTYPE_NEXTHOP,		"Nexthop"			},
+  { MTYPE_NEXTHOP_GROUP,	"Nexthop group"			},
+  { MTYPE_RIB_NHT,		"RIB nexthop tracking"		},
   { MTYPE_RIB,			"RIB"				},
   { MTYPE_RIB_QUEUE,		"RIB process work queue"	},
+  { MTYPE_RIB_SHOW_WALK,	"RIB show table cursor"		},
   { MTYPE_STATIC_IPV4,		"Static IPv4 route"		},
   { MTYPE_STATIC_IPV6,		"Static IPv6 route"		},
+  { MTYPE_ZEBRA_REDIST,		"Redistribution queue entry"	},
   { -1, NULL },
 };
 
@@ -104,6 +109,7 @@ struct memory_list memory_list_bgp[] =
   { 0, NULL },
   { MTYPE_BGP_TABLE,		"BGP table"			},
   { MTYPE_BGP_NODE,		"BGP node"			},
+  { MTYPE_BGP_SHOW_WALK,	"BGP show table cursor"		},
   { MTYPE_BGP_ROUTE,		"BGP route"			},
   { MTYPE_BGP_ROUTE_EXTRA,	"BGP ancillary route info"	},
   { MTYPE_BGP_STATIC,		"BGP static"			},
@@ -159,6 +165,7 @@ struct memory_list memory_list_rip[] =
   { MTYPE_RIP_PEER,           "RIP peer"			},
   { MTYPE_RIP_OFFSET_LIST,    "RIP offset list"			},
   { MTYPE_RIP_DISTANCE,       "RIP distance"			},
+  { MTYPE_RIP_OUTPUT,         "RIP output set"			},
   { -1, NULL }
 };
 
@@ -170,6 +177,7 @@ struct memory_list memory_list_ripng[] =
   { MTYPE_RIPNG_PEER,         "RIPng peer"			},
   { MTYPE_RIPNG_OFFSET_LIST,  "RIPng offset lst"		},
   { MTYPE_RIPNG_RTE_DATA,     "RIPng rte data"			},
+  { MTYPE_RIPNG_OUTPUT,       "RIPng output set"		},
   { -1, NULL }
 };
 
@@ -229,6 +237,7 @@ struct memory_list memory_list_isis[] =
   { MTYPE_ISIS_TMP,           "ISIS TMP"			},
   { MTYPE_ISIS_CIRCUIT,       "ISIS circuit"			},
   { MTYPE_ISIS_LSP,           "ISIS LSP"			},
+  { MTYPE_ISIS_CSNP,          "ISIS CSNP cache"			},
   { MTYPE_ISIS_ADJACENCY,     "ISIS adjacency"			},
   { MTYPE_ISIS_AREA,          "ISIS area"			},
   { MTYPE_ISIS_AREA_ADDR,     "ISIS area address"		},
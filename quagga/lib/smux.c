@@ -43,6 +43,7 @@
 enum smux_event {SMUX_SCHEDULE, SMUX_CONNECT, SMUX_READ};
 
 void smux_event (enum smux_event, int);
+static void smux_flush (void);
 
 
 /* SMUX socket. */
@@ -61,6 +62,15 @@ char *smux_passwd = NULL;
 /* SMUX read threads. */
 struct thread *smux_read_thread;
 
+/* Bytes read but not yet parsed, the start of a message the rest of
+   which is still to come. */
+static u_char smux_rbuf[SMUXMAXPKTSIZE];
+static size_t smux_rlen;
+
+/* GETRSP messages of one read, sent together when it is parsed. */
+static u_char smux_obuf[BUFSIZ];
+static size_t smux_olen;
+
 /* SMUX connect thrads. */
 struct thread *smux_connect_thread;
 
@@ -268,7 +278,6 @@ void
 smux_getresp_send (oid objid[], size_t objid_len, long reqid, long errstat,
 		   long errindex, u_char val_type, void *arg, size_t arg_len)
 {
-  int ret;
   u_char buf[BUFSIZ];
   u_char *ptr, *h1, *h1e, *h2, *h2e;
   size_t len, length;
@@ -323,8 +332,28 @@ smux_getresp_send (oid objid[], size_t objid_len, long reqid, long errstat,
 
   if (debug_smux)
     zlog_debug ("SMUX getresp send: %ld", (ptr - buf));
-  
-  ret = send (smux_sock, buf, (ptr - buf), 0);
+
+  if (smux_olen + (ptr - buf) > sizeof (smux_obuf))
+    smux_flush ();
+  memcpy (smux_obuf + smux_olen, buf, ptr - buf);
+  smux_olen += ptr - buf;
+}
+
+/* Send the GETRSP messages kept by smux_getresp_send. */
+static void
+smux_flush (void)
+{
+  int ret;
+
+  if (smux_olen == 0)
+    return;
+  if (debug_smux)
+    zlog_debug ("SMUX send: %ld", (long) smux_olen);
+  ret = send (smux_sock, smux_obuf, smux_olen, 0);
+  if (ret != (int) smux_olen)
+    zlog_warn ("SMUX send of %ld bytes: %s", (long) smux_olen,
+	       ret < 0 ? safe_strerror (errno) : "short write");
+  smux_olen = 0;
 }
 
 char *
@@ -777,14 +806,11 @@ smux_parse (char *ptr, size_t len)
   static u_char sout_save_buff[SMUXMAXPKTSIZE];
   static int sout_save_len = 0;
 
-  int len_income = len; /* see note below: YYY */
   u_char type;
   u_char rollback;
 
   rollback = ptr[2]; /* important only for SMUX_SOUT */
 
-process_rest: /* see note below: YYY */
-
   /* Parse SMUX message type and subsequent length. */
   ptr = asn_parse_header (ptr, &len, &type);
 
@@ -815,23 +841,6 @@ process_rest: /* see note below: YYY */
         }
       else
         zlog_warn ("SMUX_SOUT sout_save_len=%d - invalid", (int) sout_save_len);
-
-      if (len_income > 3) 
-        {
-          /* YYY: this strange code has to solve the "slow peer"
-             problem: When agent sends SMUX_SOUT message it doesn't
-             wait any responce and may send some next message to
-             subagent. Then the peer in 'smux_read()' will recieve
-             from socket the 'concatenated' buffer, contaning both
-             SMUX_SOUT message and the next one
-             (SMUX_GET/SMUX_GETNEXT/SMUX_GET). So we should check: if
-             the buffer is longer than 3 ( length of SMUX_SOUT ), we
-             must process the rest of it.  This effect may be observed
-             if 'debug_smux' is set to '1' */
-          ptr++;
-          len = len_income - 3;
-          goto process_rest;
-        }
       break;
     case SMUX_GETRSP:
       /* SMUX_GETRSP message is invalid for us. */
@@ -880,13 +889,40 @@ process_rest: /* see note below: YYY */
   return 0;
 }
 
-/* SMUX message read function. */
+/* Length of the message at ptr, header included, 0 if len bytes do not
+   hold its header yet, -1 if it is not a message. */
+static int
+smux_message_len (u_char *ptr, size_t len)
+{
+  size_t lenlen, msglen, i;
+
+  if (len < 2)
+    return 0;
+  if (! (ptr[1] & ASN_LONG_LEN))
+    return 2 + ptr[1];
+
+  lenlen = ptr[1] & ~ASN_LONG_LEN;
+  if (lenlen == 0 || lenlen > 2)
+    return -1;
+  if (len < 2 + lenlen)
+    return 0;
+  for (msglen = 0, i = 0; i < lenlen; i++)
+    msglen = (msglen << 8) | ptr[2 + i];
+  return 2 + lenlen + msglen;
+}
+
+/* SMUX message read function.  The agent does not wait for a response
+   to SMUX_SOUT, and a peer may send several requests before reading
+   the responses, so a read holds any number of messages, the last one
+   maybe in part.  They are all parsed and their responses sent at
+   once. */
 int
 smux_read (struct thread *t)
 {
   int sock;
   int len;
-  u_char buf[SMUXMAXPKTSIZE];
+  int msglen;
+  size_t done;
   int ret;
 
   /* Clear thread. */
@@ -897,13 +933,14 @@ smux_read (struct thread *t)
     zlog_debug ("SMUX read start");
 
   /* Read message from SMUX socket. */
-  len = recv (sock, buf, SMUXMAXPKTSIZE, 0);
+  len = recv (sock, smux_rbuf + smux_rlen, sizeof (smux_rbuf) - smux_rlen, 0);
 
   if (len < 0)
     {
       zlog_warn ("Can't read all SMUX packet: %s", safe_strerror (errno));
       close (sock);
       smux_sock = -1;
+      smux_rlen = 0;
       smux_event (SMUX_CONNECT, 0);
       return -1;
     }
@@ -913,6 +950,7 @@ smux_read (struct thread *t)
       zlog_warn ("SMUX connection closed: %d", sock);
       close (sock);
       smux_sock = -1;
+      smux_rlen = 0;
       smux_event (SMUX_CONNECT, 0);
       return -1;
     }
@@ -920,17 +958,36 @@ smux_read (struct thread *t)
   if (debug_smux)
     zlog_debug ("SMUX read len: %d", len);
 
-  /* Parse the message. */
-  ret = smux_parse (buf, len);
+  /* Parse the messages. */
+  smux_rlen += len;
+  ret = 0;
+  for (done = 0; ret >= 0 && done < smux_rlen; done += msglen)
+    {
+      msglen = smux_message_len (smux_rbuf + done, smux_rlen - done);
+      if (msglen < 0 || msglen > (int) sizeof (smux_rbuf))
+	{
+	  zlog_warn ("SMUX message too long or bad: resetting connection.");
+	  ret = -1;
+	  break;
+	}
+      if (msglen == 0 || (size_t) msglen > smux_rlen - done)
+	break;
+      ret = smux_parse ((char *) smux_rbuf + done, msglen);
+    }
+  smux_flush ();
 
   if (ret < 0)
     {
       close (sock);
       smux_sock = -1;
+      smux_rlen = 0;
       smux_event (SMUX_CONNECT, 0);
       return -1;
     }
 
+  smux_rlen -= done;
+  memmove (smux_rbuf, smux_rbuf + done, smux_rlen);
+
   /* Regiser read thread. */
   smux_event (SMUX_READ, sock);
 
@@ -1244,6 +1301,8 @@ smux_stop ()
       close (smux_sock);
       smux_sock = -1;
     }
+  smux_rlen = 0;
+  smux_olen = 0;
 }
 
 
@@ -461,6 +461,69 @@ route_next (struct route_node *node)
   return NULL;
 }
 
+/* The node following the subtree under node, in the order of
+   route_next. */
+static struct route_node *
+route_subtree_next (struct route_node *node)
+{
+  while (node->parent)
+    {
+      if (node->parent->l_left == node && node->parent->l_right)
+	return node->parent->l_right;
+      node = node->parent;
+    }
+  return NULL;
+}
+
+/* Lock and return the first node that route_next would visit after
+   prefix p, whether p is in the table or not.  Unlike route_node_get
+   followed by route_next this never adds a node to the table. */
+struct route_node *
+route_table_get_next (struct route_table *table, struct prefix *p)
+{
+  struct route_node *node;
+  struct route_node *next;
+  struct prefix common;
+  int bit;
+
+  node = table->top;
+  while (node)
+    {
+      /* Node is p or holds it in its subtree. */
+      if (node->p.prefixlen <= p->prefixlen && prefix_match (&node->p, p))
+	{
+	  if (node->p.prefixlen == p->prefixlen)
+	    return route_next (route_lock_node (node));
+
+	  bit = check_bit (&p->u.prefix, node->p.prefixlen);
+	  next = node->link[bit];
+	  if (next == NULL)
+	    {
+	      /* P would be a leaf here. */
+	      next = bit ? NULL : node->l_right;
+	      if (next == NULL)
+		next = route_subtree_next (node);
+	      return next ? route_lock_node (next) : NULL;
+	    }
+	  node = next;
+	  continue;
+	}
+
+      /* P holds node, so would come right before it. */
+      if (p->prefixlen < node->p.prefixlen && prefix_match (p, &node->p))
+	return route_lock_node (node);
+
+      /* They part at a bit, p comes before the subtree of node if it
+         branches to the left there. */
+      route_common (&node->p, p, &common);
+      if (check_bit (&p->u.prefix, common.prefixlen) == 0)
+	return route_lock_node (node);
+      next = route_subtree_next (node);
+      return next ? route_lock_node (next) : NULL;
+    }
+  return NULL;
+}
+
 /* Unlock current node and lock next node until limit. */
 struct route_node *
 route_next_until (struct route_node *node, struct route_node *limit)
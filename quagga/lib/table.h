@@ -65,6 +65,8 @@ extern struct route_node *route_node_get (struct route_table *,
                                           struct prefix *);
 extern struct route_node *route_node_lookup (struct route_table *,
                                              struct prefix *);
+extern struct route_node *route_table_get_next (struct route_table *,
+                                                struct prefix *);
 extern struct route_node *route_lock_node (struct route_node *node);
 extern struct route_node *route_node_match (struct route_table *, 
                                             struct prefix *);
@@ -40,6 +40,34 @@ static struct timeval relative_time_base;
 static unsigned short timers_inited;
 
 static struct hash *cpu_record = NULL;
+
+/* Distribution of a time in microseconds: bucket 0 counts 0, bucket b
+   the values from 2^(b-1) up to 2^b, the last bucket everything
+   above. */
+#define THREAD_HIST_BUCKETS	28
+
+struct thread_histogram
+{
+  unsigned long count;
+  unsigned long max;
+  u_int64_t total;
+  unsigned long bucket[THREAD_HIST_BUCKETS];
+};
+
+/* Scheduling statistics of the daemon: how long the callbacks ran, how
+   late the timers ran, how long the events and I/O waited on the ready
+   list and how long the scheduler took from one select to the next. */
+static struct
+{
+  struct thread_histogram runtime;
+  struct thread_histogram late;
+  struct thread_histogram wait;
+  struct thread_histogram loop;
+  unsigned long slow;
+} thread_stats;
+
+/* Warn of callbacks running longer than this, microseconds. */
+static unsigned long thread_slow_warning = THREAD_SLOW_WARNING_DEFAULT;
 
 /* Struct timeval's tv_usec one second value.  */
 #define TIMER_SECOND_MICRO 1000000L
@@ -216,6 +244,91 @@ recent_relative_time (void)
   return relative_time;
 }
 
+static void
+thread_hist_add (struct thread_histogram *h, unsigned long usec)
+{
+  unsigned long v = usec;
+  int b = 0;
+
+  while (v && b < THREAD_HIST_BUCKETS - 1)
+    {
+      v >>= 1;
+      b++;
+    }
+  h->bucket[b]++;
+  h->count++;
+  h->total += usec;
+  if (h->max < usec)
+    h->max = usec;
+}
+
+/* Upper bound of bucket b in microseconds. */
+static unsigned long
+thread_hist_bound (int b)
+{
+  return b ? 1UL << b : 1;
+}
+
+/* Count of values at least usec, rounded up to a bucket boundary. */
+static unsigned long
+thread_hist_above (struct thread_histogram *h, unsigned long usec)
+{
+  unsigned long n = 0;
+  int b;
+
+  for (b = THREAD_HIST_BUCKETS - 1; b > 0; b--)
+    {
+      if (thread_hist_bound (b - 1) < usec)
+	break;
+      n += h->bucket[b];
+    }
+  return n;
+}
+
+/* The bucket bound below which a fraction per mille of the values
+   lie. */
+static unsigned long
+thread_hist_percentile (struct thread_histogram *h, int permille)
+{
+  u_int64_t n = 0;
+  int b;
+
+  if (h->count == 0)
+    return 0;
+  for (b = 0; b < THREAD_HIST_BUCKETS - 1; b++)
+    {
+      n += h->bucket[b];
+      if (n * 1000 >= (u_int64_t) h->count * permille)
+	break;
+    }
+  return thread_hist_bound (b);
+}
+
+void
+thread_set_slow_warning (unsigned long msec)
+{
+  thread_slow_warning = msec * 1000;
+}
+
+unsigned long
+thread_get_slow_warning (void)
+{
+  return (thread_slow_warning + 999) / 1000;
+}
+
+int
+thread_slow_warning_is_default (void)
+{
+  return thread_slow_warning == THREAD_SLOW_WARNING_DEFAULT;
+}
+
+/* Whether realtime microseconds is long enough to warn of. */
+int
+thread_is_slow (unsigned long realtime)
+{
+  return thread_slow_warning && realtime > thread_slow_warning;
+}
+
 static unsigned int
 cpu_record_hash_key (struct cpu_thread_history *a)
 {
@@ -373,6 +486,85 @@ DEFUN(show_thread_cpu,
   cpu_record_print(vty, filter);
   return CMD_SUCCESS;
 }
+
+static void
+vty_out_thread_histogram (struct vty *vty, const char *name,
+			  struct thread_histogram *h)
+{
+  vty_out (vty, "%-15s %10lu %9lu %9lu %8lu %8lu %8lu%s", name, h->count,
+	   h->count ? (unsigned long) (h->total / h->count) : 0, h->max,
+	   thread_hist_percentile (h, 500), thread_hist_percentile (h, 900),
+	   thread_hist_percentile (h, 990), VTY_NEWLINE);
+}
+
+DEFUN (show_thread_latency,
+       show_thread_latency_cmd,
+       "show thread latency",
+       SHOW_STR
+       "Thread information\n"
+       "Scheduling latency histograms\n")
+{
+  struct thread_histogram *h[] = { &thread_stats.runtime, &thread_stats.late,
+				   &thread_stats.wait, &thread_stats.loop };
+  int b, i;
+
+  vty_out (vty, "%-15s %10s %9s %9s %8s %8s %8s%s", "", "Count", "Avg uSec",
+	   "Max uSecs", "50% <", "90% <", "99% <", VTY_NEWLINE);
+  vty_out_thread_histogram (vty, "Runtime", &thread_stats.runtime);
+  vty_out_thread_histogram (vty, "Timer lateness", &thread_stats.late);
+  vty_out_thread_histogram (vty, "Ready wait", &thread_stats.wait);
+  vty_out_thread_histogram (vty, "Loop period", &thread_stats.loop);
+
+  vty_out (vty, "%s%10s %10s %10s %10s %10s%s", VTY_NEWLINE, "uSecs <",
+	   "Runtime", "Lateness", "Wait", "Loop", VTY_NEWLINE);
+  for (b = 0; b < THREAD_HIST_BUCKETS; b++)
+    {
+      for (i = 0; i < 4; i++)
+	if (h[i]->bucket[b])
+	  break;
+      if (i == 4)
+	continue;
+      if (b == THREAD_HIST_BUCKETS - 1)
+	vty_out (vty, "%10s", "more");
+      else
+	vty_out (vty, "%10lu", thread_hist_bound (b));
+      for (i = 0; i < 4; i++)
+	vty_out (vty, " %10lu", h[i]->bucket[b]);
+      vty_out (vty, "%s", VTY_NEWLINE);
+    }
+
+  if (thread_slow_warning)
+    vty_out (vty, "%s%lu callbacks ran longer than %lu ms%s", VTY_NEWLINE,
+	     thread_stats.slow, thread_get_slow_warning (), VTY_NEWLINE);
+  return CMD_SUCCESS;
+}
+
+/* One line for watchquagga: how many callbacks ran, how many timers and
+   events were late and how many loop periods were at least the given
+   time, rounded up to a power of two microseconds, since the daemon
+   started. */
+DEFUN (show_thread_health,
+       show_thread_health_cmd,
+       "show thread health <1-3600000>",
+       SHOW_STR
+       "Thread information\n"
+       "Counts of callbacks, events and loop periods over a time\n"
+       "Milliseconds\n")
+{
+  unsigned long msec;
+  unsigned long usec;
+
+  VTY_GET_INTEGER_RANGE ("milliseconds", msec, argv[0], 1, 3600000);
+  usec = msec * 1000;
+
+  vty_out (vty, "health %lu calls %lu slow %lu late %lu long %lu%s", msec,
+	   thread_stats.runtime.count,
+	   thread_hist_above (&thread_stats.runtime, usec),
+	   thread_hist_above (&thread_stats.late, usec)
+	   + thread_hist_above (&thread_stats.wait, usec),
+	   thread_hist_above (&thread_stats.loop, usec), VTY_NEWLINE);
+  return CMD_SUCCESS;
+}
 
 /* List allocation and head/tail print out. */
 static void
@@ -659,7 +851,7 @@ funcname_thread_add_timer_timeval (struct thread_master *m,
   thread = thread_get (m, type, func, arg, funcname);
 
   /* Do we need jitter here? */
-  quagga_gettimeofday (&recent_time);
+  quagga_get_relative (NULL);
   alarm_time.tv_sec = relative_time.tv_sec + time_relative->tv_sec;
   alarm_time.tv_usec = relative_time.tv_usec + time_relative->tv_usec;
   thread->u.sands = timeval_adjust(alarm_time);
@@ -749,6 +941,7 @@ funcname_thread_add_event (struct thread_master *m,
 
   thread = thread_get (m, THREAD_EVENT, func, arg, funcname);
   thread->u.val = val;
+  quagga_get_relative (&thread->ready);
   thread_list_add (&m->event, thread);
 
   return thread;
@@ -860,6 +1053,7 @@ thread_process_fd (struct thread_list *list, fd_set *fdset, fd_set *mfdset)
           thread_list_delete (list, thread);
           thread_list_add (&thread->master->ready, thread);
           thread->type = THREAD_READY;
+          thread->ready = relative_time;
           ready++;
         }
     }
@@ -929,7 +1123,17 @@ thread_fetch (struct thread_master *m, struct thread *fetch)
 	  (!timer_wait || (timeval_cmp (*timer_wait, *timer_wait_bg) > 0)))
 	timer_wait = timer_wait_bg;
       
+      /* Write out the log lines queued by the threads run so far */
+      zlog_flush (NULL);
+
+      /* The loop period, from the last select to this one. */
+      if (m->polled.tv_sec || m->polled.tv_usec)
+	thread_hist_add (&thread_stats.loop,
+			 timeval_elapsed (relative_time, m->polled));
+
       num = select (FD_SETSIZE, &readfd, &writefd, &exceptfd, timer_wait);
+      quagga_get_relative (NULL);
+      m->polled = relative_time;
       
       /* Signals should get quick treatment */
       if (num < 0)
@@ -943,7 +1147,6 @@ thread_fetch (struct thread_master *m, struct thread *fetch)
       /* Check foreground timers.  Historically, they have had higher
          priority than I/O threads, so let's push them onto the ready
 	 list in front of the I/O threads. */
-      quagga_get_relative (NULL);
       thread_timer_process (&m->timer, &relative_time);
       
       /* Got IO, process it */
@@ -1048,11 +1251,31 @@ thread_call (struct thread *thread)
 
   GETRUSAGE (&thread->ru);
 
+  /* How late a timer runs, how long an event or I/O waited. */
+  switch (thread->add_type)
+    {
+    case THREAD_TIMER:
+    case THREAD_BACKGROUND:
+      if (timeval_cmp (thread->ru.real, thread->u.sands) > 0)
+	thread_hist_add (&thread_stats.late,
+			 timeval_elapsed (thread->ru.real, thread->u.sands));
+      else
+	thread_hist_add (&thread_stats.late, 0);
+      break;
+    case THREAD_EXECUTE:
+      break;
+    default:
+      thread_hist_add (&thread_stats.wait,
+		       timeval_elapsed (thread->ru.real, thread->ready));
+      break;
+    }
+
   (*thread->func) (thread);
 
   GETRUSAGE (&ru);
 
   realtime = thread_consumed_time (&ru, &thread->ru, &cputime);
+  thread_hist_add (&thread_stats.runtime, realtime);
   thread->hist->real.total += realtime;
   if (thread->hist->real.max < realtime)
     thread->hist->real.max = realtime;
@@ -1065,20 +1288,19 @@ thread_call (struct thread *thread)
   ++(thread->hist->total_calls);
   thread->hist->types |= (1 << thread->add_type);
 
-#ifdef CONSUMED_TIME_CHECK
-  if (realtime > CONSUMED_TIME_CHECK)
+  if (thread_is_slow (realtime))
     {
       /*
        * We have a CPU Hog on our hands.
        * Whinge about it now, so we're aware this is yet another task
        * to fix.
        */
+      thread_stats.slow++;
       zlog_warn ("SLOW THREAD: task %s (%lx) ran for %lums (cpu time %lums)",
 		 thread->funcname,
 		 (unsigned long) thread->func,
 		 realtime/1000, cputime/1000);
     }
-#endif /* CONSUMED_TIME_CHECK */
 }
 
 /* Execute thread */
@@ -55,6 +55,7 @@ struct thread_master
   fd_set writefd;
   fd_set exceptfd;
   unsigned long alloc;
+  struct timeval polled;	/* when select last returned */
 };
 
 /* Thread itself. */
@@ -75,6 +76,7 @@ struct thread
   RUSAGE_T ru;			/* Indepth usage info.  */
   struct cpu_thread_history *hist; /* cache pointer to cpu_history */
   char* funcname;
+  struct timeval ready;		/* event added or fd ready, for the wait */
 };
 
 struct cpu_thread_history 
@@ -112,6 +114,13 @@ enum quagga_clkid {
 /* Thread yield time.  */
 #define THREAD_YIELD_TIME_SLOT     10 * 1000L /* 10ms */
 
+/* Default for "thread slow-warning", in microseconds, 0 for none. */
+#ifdef CONSUMED_TIME_CHECK
+#define THREAD_SLOW_WARNING_DEFAULT CONSUMED_TIME_CHECK
+#else
+#define THREAD_SLOW_WARNING_DEFAULT 0
+#endif /* CONSUMED_TIME_CHECK */
+
 /* Macros. */
 #define THREAD_ARG(X) ((X)->arg)
 #define THREAD_FD(X)  ((X)->u.fd)
@@ -195,6 +204,15 @@ extern int thread_should_yield (struct thread *);
 /* Internal libzebra exports */
 extern void thread_getrusage (RUSAGE_T *);
 extern struct cmd_element show_thread_cpu_cmd;
+extern struct cmd_element show_thread_latency_cmd;
+extern struct cmd_element show_thread_health_cmd;
+
+/* Warn of callbacks and vty commands running longer than msec
+   milliseconds, 0 for never.  The getter rounds up to milliseconds. */
+extern void thread_set_slow_warning (unsigned long msec);
+extern unsigned long thread_get_slow_warning (void);
+extern int thread_slow_warning_is_default (void);
+extern int thread_is_slow (unsigned long realtime);
 
 /* replacements for the system gettimeofday(), clock_gettime() and
  * time() functions, providing support for non-decrementing clock on
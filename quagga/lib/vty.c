@@ -46,6 +46,7 @@ enum event
   VTY_READ,
   VTY_WRITE,
   VTY_TIMEOUT_RESET,
+  VTY_OUTPUT,
 #ifdef VTYSH
   VTYSH_SERV,
   VTYSH_READ,
@@ -54,6 +55,8 @@ enum event
 };
 
 static void vty_event (enum event, int, struct vty *);
+static int vty_output_run (struct thread *);
+static void vty_output_cancel (struct vty *);
 
 /* Extern host structure from command.c */
 extern struct host host;
@@ -396,6 +399,9 @@ vty_command (struct vty *vty, char *buf)
   int ret;
   vector vline;
   const char *protocolname;
+  RUSAGE_T before;
+  RUSAGE_T after;
+  unsigned long realtime, cputime;
 
   /* Split readline string up into the vector */
   vline = cmd_make_strvec (buf);
@@ -403,14 +409,7 @@ vty_command (struct vty *vty, char *buf)
   if (vline == NULL)
     return CMD_SUCCESS;
 
-#ifdef CONSUMED_TIME_CHECK
-  {
-    RUSAGE_T before;
-    RUSAGE_T after;
-    unsigned long realtime, cputime;
-
-    GETRUSAGE(&before);
-#endif /* CONSUMED_TIME_CHECK */
+  GETRUSAGE(&before);
 
   ret = cmd_execute_command (vline, vty, NULL, 0);
 
@@ -419,16 +418,13 @@ vty_command (struct vty *vty, char *buf)
       protocolname = zlog_proto_names[zlog_default->protocol];
   else
       protocolname = zlog_proto_names[ZLOG_NONE];
-                                                                           
-#ifdef CONSUMED_TIME_CHECK
-    GETRUSAGE(&after);
-    if ((realtime = thread_consumed_time(&after, &before, &cputime)) >
-    	CONSUMED_TIME_CHECK)
-      /* Warn about CPU hog that must be fixed. */
-      zlog_warn("SLOW COMMAND: command took %lums (cpu time %lums): %s",
-      		realtime/1000, cputime/1000, buf);
-  }
-#endif /* CONSUMED_TIME_CHECK */
+
+  GETRUSAGE(&after);
+  realtime = thread_consumed_time(&after, &before, &cputime);
+  if (thread_is_slow (realtime))
+    /* Warn about CPU hog that must be fixed. */
+    zlog_warn("SLOW COMMAND: command took %lums (cpu time %lums): %s",
+	      realtime/1000, cputime/1000, buf);
 
   if (ret != CMD_SUCCESS)
     switch (ret)
@@ -1282,7 +1278,8 @@ vty_execute (struct vty *vty)
   vty->cp = vty->length = 0;
   vty_clear_buf (vty);
 
-  if (vty->status != VTY_CLOSE )
+  /* A command writing in slices prompts when it is done. */
+  if (vty->status != VTY_CLOSE && ! vty->output_func)
     vty_prompt (vty);
 
   return ret;
@@ -1323,6 +1320,7 @@ vty_escape_map (unsigned char c, struct vty *vty)
 static void
 vty_buffer_reset (struct vty *vty)
 {
+  vty_output_cancel (vty);
   buffer_reset (vty->obuf);
   vty_prompt (vty);
   vty_redraw_line (vty);
@@ -1413,6 +1411,19 @@ vty_read (struct thread *thread)
 	  continue;
 	}
 
+      /* While a command writes its output only ^C and q are read, to
+         stop it. */
+      if (vty->output_func)
+	{
+	  if (buf[i] == CONTROL('C') || buf[i] == 'q' || buf[i] == 'Q')
+	    {
+	      vty_output_cancel (vty);
+	      vty_out (vty, "%s", VTY_NEWLINE);
+	      vty_prompt (vty);
+	    }
+	  continue;
+	}
+
       /* Escape character. */
       if (vty->escape == VTY_ESCAPE)
 	{
@@ -1597,6 +1608,9 @@ vty_flush (struct thread *thread)
       break;
     }
 
+  if (vty->output_func && buffer_pending (vty->obuf) < VTY_OUTPUT_LOWAT)
+    vty_event (VTY_OUTPUT, vty_sock, vty);
+
   return 0;
 }
 
@@ -2030,6 +2044,8 @@ vtysh_flush(struct vty *vty)
     case BUFFER_EMPTY:
       break;
     }
+  if (vty->output_func && buffer_pending (vty->obuf) < VTY_OUTPUT_LOWAT)
+    vty_event (VTY_OUTPUT, vty->fd, vty);
   return 0;
 }
 
@@ -2090,6 +2106,11 @@ vtysh_read (struct thread *thread)
 	  printf ("vtysh node: %d\n", vty->node);
 #endif /* VTYSH_DEBUG */
 
+	  /* A command writing in slices sends the result when done, and
+	     vtysh waits for it before sending anything else. */
+	  if (vty->output_func)
+	    return 0;
+
 	  header[3] = ret;
 	  buffer_put(vty->obuf, header, 4);
 
@@ -2116,6 +2137,94 @@ vtysh_write (struct thread *thread)
 
 #endif /* VTYSH */
 
+/* Output of a command walking a large table.  Rather than writing it
+   all into the output buffer at once, the command hands a walker to
+   vty_output_start.  The walker keeps its own cursor, writes about
+   VTY_OUTPUT_SLICE entries per call and returns non-zero while there is
+   more to write.  It is called from the event loop at background
+   priority while less than VTY_OUTPUT_HIWAT bytes wait to be sent, and
+   again once the vty drains below VTY_OUTPUT_LOWAT.  clean releases the
+   cursor when the output ends, is stopped or the vty closes.  Vtys not
+   driven by the event loop get the whole output at once. */
+int
+vty_output_start (struct vty *vty, int (*func) (struct vty *, void *),
+		  void (*clean) (struct vty *, void *), void *arg)
+{
+  if (vty->type != VTY_TERM && vty->type != VTY_SHELL_SERV)
+    {
+      while ((*func) (vty, arg))
+	;
+      if (clean)
+	(*clean) (vty, arg);
+      return CMD_SUCCESS;
+    }
+
+  vty->output_func = func;
+  vty->output_clean = clean;
+  vty->output_arg = arg;
+  vty_event (VTY_OUTPUT, vty->fd, vty);
+  return CMD_SUCCESS;
+}
+
+static void
+vty_output_cancel (struct vty *vty)
+{
+  if (! vty->output_func)
+    return;
+  if (vty->t_output)
+    {
+      thread_cancel (vty->t_output);
+      vty->t_output = NULL;
+    }
+  if (vty->output_clean)
+    (*vty->output_clean) (vty, vty->output_arg);
+  vty->output_func = NULL;
+  vty->output_clean = NULL;
+  vty->output_arg = NULL;
+}
+
+static int
+vty_output_run (struct thread *thread)
+{
+  struct vty *vty = THREAD_ARG (thread);
+
+  vty->t_output = NULL;
+  if ((*vty->output_func) (vty, vty->output_arg))
+    {
+      if (buffer_pending (vty->obuf) < VTY_OUTPUT_HIWAT)
+	vty_event (VTY_OUTPUT, vty->fd, vty);
+    }
+  else
+    {
+      /* Done, give the prompt or the vtysh result. */
+      vty_output_cancel (vty);
+#ifdef VTYSH
+      if (vty->type == VTY_SHELL_SERV)
+	{
+	  u_char header[4] = {0, 0, 0, CMD_SUCCESS};
+
+	  buffer_put (vty->obuf, header, 4);
+	  vty_event (VTYSH_READ, vty->fd, vty);
+	}
+      else
+#endif /* VTYSH */
+	vty_prompt (vty);
+    }
+
+  /* At a --More-- the next window waits for a key. */
+#ifdef VTYSH
+  if (vty->type == VTY_SHELL_SERV)
+    {
+      if (! vty->t_write)
+	vtysh_flush (vty);
+    }
+  else
+#endif /* VTYSH */
+    if (vty->status != VTY_MORE && vty->status != VTY_MORELINE)
+      vty_event (VTY_WRITE, vty->fd, vty);
+  return 0;
+}
+
 /* Determine address family to bind. */
 void
 vty_serv_sock (const char *addr, unsigned short port, const char *path)
@@ -2157,6 +2266,7 @@ vty_close (struct vty *vty)
     thread_cancel (vty->t_write);
   if (vty->t_timeout)
     thread_cancel (vty->t_timeout);
+  vty_output_cancel (vty);
 
   /* Flush buffer. */
   buffer_flush_all (vty->obuf, vty->fd);
@@ -2522,6 +2632,10 @@ vty_event (enum event event, int sock, struct vty *vty)
       if (! vty->t_write)
 	vty->t_write = thread_add_write (master, vty_flush, vty, sock);
       break;
+    case VTY_OUTPUT:
+      if (! vty->t_output)
+	vty->t_output = thread_add_background (master, vty_output_run, vty, 0);
+      break;
     case VTY_TIMEOUT_RESET:
       if (vty->t_timeout)
 	{
@@ -118,6 +118,12 @@ struct vty
   /* Timeout seconds and thread. */
   unsigned long v_timeout;
   struct thread *t_timeout;
+
+  /* Output of a command written in slices, see vty_output_start. */
+  int (*output_func) (struct vty *, void *);
+  void (*output_clean) (struct vty *, void *);
+  void *output_arg;
+  struct thread *t_output;
 };
 
 /* Integrated configuration file. */
@@ -129,6 +135,13 @@ struct vty
 /* Default time out value */
 #define VTY_TIMEOUT_DEFAULT 600
 
+/* A command writing its output in slices writes about VTY_OUTPUT_SLICE
+   entries per slice.  Above VTY_OUTPUT_HIWAT bytes of unsent output it
+   waits until the vty drains below VTY_OUTPUT_LOWAT. */
+#define VTY_OUTPUT_SLICE 200
+#define VTY_OUTPUT_HIWAT (64 * 1024)
+#define VTY_OUTPUT_LOWAT (16 * 1024)
+
 /* Vty read buffer size. */
 #define VTY_READ_BUFSIZ 512
 
@@ -210,6 +223,8 @@ extern void vty_read_config (char *, char *);
 extern void vty_time_print (struct vty *, int);
 extern void vty_serv_sock (const char *, unsigned short, const char *);
 extern void vty_close (struct vty *);
+extern int vty_output_start (struct vty *, int (*) (struct vty *, void *),
+			     void (*) (struct vty *, void *), void *);
 extern char *vty_get_cwd (void);
 extern void vty_log (const char *level, const char *proto, 
                      const char *fmt, struct timestamp_control *, va_list);
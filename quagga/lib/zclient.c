@@ -124,9 +124,14 @@ zclient_stop (struct zclient *zclient)
   THREAD_OFF(zclient->t_connect);
   THREAD_OFF(zclient->t_write);
 
+  THREAD_OFF(zclient->t_batch);
+
   /* Reset streams. */
   stream_reset(zclient->ibuf);
   stream_reset(zclient->obuf);
+  if (zclient->batch)
+    stream_reset(zclient->batch);
+  zclient->batch_count = 0;
 
   /* Empty the write buffer. */
   buffer_reset(zclient->wb);
@@ -246,13 +251,19 @@ zclient_flush_data(struct thread *thread)
   return 0;
 }
 
-int
-zclient_send_message(struct zclient *zclient)
+static int
+zclient_write (struct zclient *zclient, const void *data, size_t len)
 {
   if (zclient->sock < 0)
     return -1;
-  switch (buffer_write(zclient->wb, zclient->sock, STREAM_DATA(zclient->obuf),
-		       stream_get_endp(zclient->obuf)))
+  if (zclient->write_batch)
+    {
+      buffer_put(zclient->wb, data, len);
+      THREAD_WRITE_ON(master, zclient->t_write,
+		      zclient_flush_data, zclient, zclient->sock);
+      return 0;
+    }
+  switch (buffer_write(zclient->wb, zclient->sock, data, len))
     {
     case BUFFER_ERROR:
       zlog_warn("%s: buffer_write failed to zclient fd %d, closing",
@@ -270,6 +281,154 @@ zclient_send_message(struct zclient *zclient)
   return 0;
 }
 
+int
+zclient_send_message(struct zclient *zclient)
+{
+  /* Keep pending bulk routes ahead of this message. */
+  if (zclient->batch_count && zclient_route_batch_flush (zclient) < 0)
+    return -1;
+
+  return zclient_write (zclient, STREAM_DATA(zclient->obuf),
+			stream_get_endp(zclient->obuf));
+}
+
+/* Bulk route messages.
+ *
+ * A single-route message is laid out as
+ *
+ *   header, type, flags, message, prefixlen, prefix, attributes
+ *
+ * where attributes are the nexthop, distance and metric fields selected
+ * by message.  A bulk message carries any number of prefixes sharing
+ * everything but the prefix:
+ *
+ *   header, type, flags, message, count (2 bytes), attributes,
+ *   count x (prefixlen, prefix)
+ */
+#define ZCLIENT_BATCH_ATTR (ZEBRA_HEADER_SIZE + 5)
+
+static uint16_t
+zclient_bulk_command (uint16_t cmd)
+{
+  switch (cmd)
+    {
+    case ZEBRA_IPV4_ROUTE_ADD:
+      return ZEBRA_IPV4_ROUTE_ADD_BULK;
+    case ZEBRA_IPV4_ROUTE_DELETE:
+      return ZEBRA_IPV4_ROUTE_DELETE_BULK;
+    case ZEBRA_IPV6_ROUTE_ADD:
+      return ZEBRA_IPV6_ROUTE_ADD_BULK;
+    case ZEBRA_IPV6_ROUTE_DELETE:
+      return ZEBRA_IPV6_ROUTE_DELETE_BULK;
+    }
+  return 0;
+}
+
+static int
+zclient_route_batch_timer (struct thread *thread)
+{
+  struct zclient *zclient = THREAD_ARG (thread);
+
+  zclient->t_batch = NULL;
+  zclient_route_batch_flush (zclient);
+  return 0;
+}
+
+int
+zclient_route_batch_flush (struct zclient *zclient)
+{
+  struct stream *b = zclient->batch;
+  u_char msg[ZEBRA_MAX_PACKET_SIZ];
+  size_t attr_end, len;
+  uint16_t count;
+  int ret;
+
+  THREAD_OFF (zclient->t_batch);
+
+  if (! (count = zclient->batch_count))
+    return 0;
+  zclient->batch_count = 0;
+
+  if (count > 1)
+    {
+      stream_putw_at (b, 0, stream_get_endp (b));
+      stream_putw_at (b, ZEBRA_HEADER_SIZE + 3, count);
+      ret = zclient_write (zclient, STREAM_DATA (b), stream_get_endp (b));
+      stream_reset (b);
+      return ret;
+    }
+
+  /* A lone route goes out as the plain message it was queued as. */
+  attr_end = ZCLIENT_BATCH_ATTR + zclient->batch_attr_len;
+  len = stream_get_endp (b) - attr_end;
+
+  memcpy (msg, STREAM_DATA (b), ZEBRA_HEADER_SIZE + 3);
+  memcpy (msg + ZEBRA_HEADER_SIZE + 3, STREAM_DATA (b) + attr_end, len);
+  memcpy (msg + ZEBRA_HEADER_SIZE + 3 + len,
+	  STREAM_DATA (b) + ZCLIENT_BATCH_ATTR, zclient->batch_attr_len);
+  len += ZEBRA_HEADER_SIZE + 3 + zclient->batch_attr_len;
+
+  msg[0] = len >> 8;
+  msg[1] = len & 0xff;
+  msg[4] = zclient->batch_cmd >> 8;
+  msg[5] = zclient->batch_cmd & 0xff;
+
+  stream_reset (b);
+  return zclient_write (zclient, msg, len);
+}
+
+int
+zclient_send_route (struct zclient *zclient)
+{
+  struct stream *s = zclient->obuf;
+  struct stream *b;
+  uint16_t cmd;
+  size_t psize, attr, attr_len;
+
+  cmd = stream_getw_from (s, ZEBRA_HEADER_SIZE - 2);
+  if (! zclient->route_batch || ! zclient_bulk_command (cmd))
+    return zclient_send_message (zclient);
+
+  psize = PSIZE (stream_getc_from (s, ZEBRA_HEADER_SIZE + 3));
+  attr = ZEBRA_HEADER_SIZE + 4 + psize;
+  attr_len = stream_get_endp (s) - attr;
+
+  if (! zclient->batch)
+    zclient->batch = stream_new (ZEBRA_MAX_PACKET_SIZ);
+  b = zclient->batch;
+
+  /* Start over unless this route shares command, type, flags, message and
+     attributes with the pending ones and still fits. */
+  if (zclient->batch_count
+      && (zclient->batch_cmd != cmd
+	  || zclient->batch_attr_len != attr_len
+	  || memcmp (STREAM_DATA (b) + ZEBRA_HEADER_SIZE,
+		     STREAM_DATA (s) + ZEBRA_HEADER_SIZE, 3)
+	  || memcmp (STREAM_DATA (b) + ZCLIENT_BATCH_ATTR,
+		     STREAM_DATA (s) + attr, attr_len)
+	  || STREAM_WRITEABLE (b) < 1 + psize))
+    if (zclient_route_batch_flush (zclient) < 0)
+      return -1;
+
+  if (! zclient->batch_count)
+    {
+      zclient_create_header (b, zclient_bulk_command (cmd));
+      stream_put (b, STREAM_DATA (s) + ZEBRA_HEADER_SIZE, 3);
+      stream_putw (b, 0);
+      stream_put (b, STREAM_DATA (s) + attr, attr_len);
+      zclient->batch_cmd = cmd;
+      zclient->batch_attr_len = attr_len;
+    }
+
+  stream_put (b, STREAM_DATA (s) + ZEBRA_HEADER_SIZE + 3, 1 + psize);
+  zclient->batch_count++;
+
+  if (! zclient->t_batch)
+    zclient->t_batch = thread_add_event (master, zclient_route_batch_timer,
+					 zclient, 0);
+  return 0;
+}
+
 void
 zclient_create_header (struct stream *s, uint16_t command)
 {
@@ -478,7 +637,7 @@ zapi_ipv4_route (u_char cmd, struct zclient *zclient, struct prefix_ipv4 *p,
   /* Put length at the first point of the stream. */
   stream_putw_at (s, 0, stream_get_endp (s));
 
-  return zclient_send_message(zclient);
+  return zclient_send_route(zclient);
 }
 
 #ifdef HAVE_IPV6
@@ -531,7 +690,7 @@ zapi_ipv6_route (u_char cmd, struct zclient *zclient, struct prefix_ipv6 *p,
   /* Put length at the first point of the stream. */
   stream_putw_at (s, 0, stream_get_endp (s));
 
-  return zclient_send_message(zclient);
+  return zclient_send_route(zclient);
 }
 #endif /* HAVE_IPV6 */
 
@@ -616,7 +775,7 @@ zebra_interface_add_read (struct stream *s)
   ifp = if_get_by_name_len (ifname_tmp, strnlen(ifname_tmp, INTERFACE_NAMSIZ));
 
   /* Read interface's index. */
-  ifp->ifindex = stream_getl (s);
+  if_set_index (ifp, stream_getl (s));
 
   /* Read interface's value. */
   ifp->status = stream_getc (s);
@@ -661,7 +820,7 @@ zebra_interface_state_read (struct stream *s)
      return NULL;
 
   /* Read interface's index. */
-  ifp->ifindex = stream_getl (s);
+  if_set_index (ifp, stream_getl (s));
 
   /* Read interface's value. */
   ifp->status = stream_getc (s);
@@ -710,7 +869,7 @@ void
 zebra_interface_if_set_value (struct stream *s, struct interface *ifp)
 {
   /* Read interface's index. */
-  ifp->ifindex = stream_getl (s);
+  if_set_index (ifp, stream_getl (s));
   ifp->status = stream_getc (s);
 
   /* Read interface's value. */
@@ -773,6 +932,7 @@ zebra_interface_address_read (int type, struct stream *s)
   /* Fetch destination address. */
   stream_get (&d.u.prefix, s, plen);
   d.family = family;
+  d.prefixlen = p.prefixlen;
 
   if (type == ZEBRA_INTERFACE_ADDRESS_ADD) 
     {
@@ -780,11 +940,7 @@ zebra_interface_address_read (int type, struct stream *s)
        ifc = connected_add_by_prefix(ifp, &p,(memconstant(&d.u.prefix,0,plen) ?
 					      NULL : &d));
        if (ifc != NULL)
-	 {
-	   ifc->flags = ifc_flags;
-	   if (ifc->destination)
-	     ifc->destination->prefixlen = ifc->address->prefixlen;
-	 }
+	 ifc->flags = ifc_flags;
     }
   else
     {
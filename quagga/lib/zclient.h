@@ -60,6 +60,22 @@ struct zclient
   /* Thread to write buffered data to zebra. */
   struct thread *t_write;
 
+  /* Leave messages in wb for the write thread instead of writing each
+     one as it is sent, so a burst goes out in a single writev. */
+  u_char write_batch;
+
+  /* Fold route add/delete messages sharing the same attributes into
+     ZEBRA_IPV{4,6}_ROUTE_{ADD,DELETE}_BULK messages. */
+  u_char route_batch;
+
+  /* Bulk message being built, the single-route command it stands for,
+     its attribute length and prefix count, and the thread flushing it. */
+  struct stream *batch;
+  uint16_t batch_cmd;
+  uint16_t batch_attr_len;
+  uint16_t batch_count;
+  struct thread *t_batch;
+
   /* Redistribute information. */
   u_char redist_default;
   u_char redist[ZEBRA_ROUTE_MAX];
@@ -145,6 +161,14 @@ extern void zclient_redistribute_default (int command, struct zclient *);
    Returns 0 for success or -1 on an I/O error. */
 extern int zclient_send_message(struct zclient *);
 
+/* Send the route add/delete message in zclient->obuf, folding it into a
+   pending bulk message if route_batch is set.  Returns 0 for success or
+   -1 on an I/O error. */
+extern int zclient_send_route (struct zclient *);
+
+/* Send any pending bulk route message now. */
+extern int zclient_route_batch_flush (struct zclient *);
+
 /* create header for command, length to be filled in by user later */
 extern void zclient_create_header (struct stream *, uint16_t);
 
@@ -413,7 +413,11 @@ struct in_pktinfo
 #define ZEBRA_ROUTER_ID_ADD               20
 #define ZEBRA_ROUTER_ID_DELETE            21
 #define ZEBRA_ROUTER_ID_UPDATE            22
-#define ZEBRA_MESSAGE_MAX                 23
+#define ZEBRA_IPV4_ROUTE_ADD_BULK         23
+#define ZEBRA_IPV4_ROUTE_DELETE_BULK      24
+#define ZEBRA_IPV6_ROUTE_ADD_BULK         25
+#define ZEBRA_IPV6_ROUTE_DELETE_BULK      26
+#define ZEBRA_MESSAGE_MAX                 27
 
 /* Marker value used in new Zserv, in the byte location corresponding
  * the command value in the old zserv header. To allow old and new
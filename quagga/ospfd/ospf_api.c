@@ -111,6 +111,8 @@ msg_new (u_char msgtype, void *msgbody, u_int32_t seqnum, u_int16_t msglen)
   assert (new->s);
   stream_put (new->s, msgbody, msglen);
 
+  new->refcnt = 1;
+
   return new;
 }
 
@@ -129,6 +131,18 @@ msg_dup (struct msg *msg)
 }
 
 
+/* Take another reference to a message, to queue it without a copy. */
+struct msg *
+msg_ref (struct msg *msg)
+{
+  assert (msg);
+  assert (msg->refcnt > 0);
+
+  msg->refcnt++;
+  return msg;
+}
+
+
 /* XXX only for testing, will be removed */
 
 struct nametab {
@@ -240,6 +254,10 @@ msg_print (struct msg *msg)
 void
 msg_free (struct msg *msg)
 {
+  assert (msg->refcnt > 0);
+  if (--msg->refcnt > 0)
+    return;
+
   if (msg->s)
     stream_free (msg->s);
 
@@ -279,35 +297,46 @@ msg_fifo_new ()
   return new;
 }
 
-/* Add new message to fifo. */
-void
+/* Add new message to fifo, which takes over the caller's reference. */
+struct msg_fifo_node *
 msg_fifo_push (struct msg_fifo *fifo, struct msg *msg)
 {
+  struct msg_fifo_node *node;
+
+  node = XMALLOC (MTYPE_OSPF_API_FIFO, sizeof (struct msg_fifo_node));
+  node->next = NULL;
+  node->msg = msg;
+
   if (fifo->tail)
-    fifo->tail->next = msg;
+    fifo->tail->next = node;
   else
-    fifo->head = msg;
+    fifo->head = node;
 
-  fifo->tail = msg;
+  fifo->tail = node;
   fifo->count++;
+
+  return node;
 }
 
 
-/* Remove first message from fifo. */
+/* Remove first message from fifo, the reference goes to the caller. */
 struct msg *
 msg_fifo_pop (struct msg_fifo *fifo)
 {
-  struct msg *msg;
+  struct msg_fifo_node *node;
+  struct msg *msg = NULL;
 
-  msg = fifo->head;
-  if (msg)
+  node = fifo->head;
+  if (node)
     {
-      fifo->head = msg->next;
+      fifo->head = node->next;
 
       if (fifo->head == NULL)
 	fifo->tail = NULL;
 
       fifo->count--;
+      msg = node->msg;
+      XFREE (MTYPE_OSPF_API_FIFO, node);
     }
   return msg;
 }
@@ -316,20 +345,21 @@ msg_fifo_pop (struct msg_fifo *fifo)
 struct msg *
 msg_fifo_head (struct msg_fifo *fifo)
 {
-  return fifo->head;
+  return fifo->head ? fifo->head->msg : NULL;
 }
 
 /* Flush message fifo. */
 void
 msg_fifo_flush (struct msg_fifo *fifo)
 {
-  struct msg *op;
-  struct msg *next;
+  struct msg_fifo_node *node;
+  struct msg_fifo_node *next;
 
-  for (op = fifo->head; op; op = next)
+  for (node = fifo->head; node; node = next)
     {
-      next = op->next;
-      msg_free (op);
+      next = node->next;
+      msg_free (node->msg);
+      XFREE (MTYPE_OSPF_API_FIFO, node);
     }
 
   fifo->head = fifo->tail = NULL;
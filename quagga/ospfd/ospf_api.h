@@ -55,19 +55,22 @@ struct apimsghdr
 /* Message representation with header and body */
 struct msg
 {
-  struct msg *next;		/* to link into fifo */
-
   /* Message header */
   struct apimsghdr hdr;
 
   /* Message body */
   struct stream *s;
+
+  /* References, one by the creator and one by each fifo the message
+     is queued on.  msg_free drops one. */
+  unsigned int refcnt;
 };
 
 /* Prototypes for generic messages. */
 extern struct msg *msg_new (u_char msgtype, void *msgbody,
 		     u_int32_t seqnum, u_int16_t msglen);
 extern struct msg *msg_dup (struct msg *msg);
+extern struct msg *msg_ref (struct msg *msg);
 extern void msg_print (struct msg *msg);	/* XXX debug only */
 extern void msg_free (struct msg *msg);
 struct msg *msg_read (int fd);
@@ -88,17 +91,25 @@ extern u_int32_t msg_get_seq (struct msg *msg);
  */
 
 /* Message queue structure. */
+/* A message can be on several fifos at once, each links it by a node. */
+struct msg_fifo_node
+{
+  struct msg_fifo_node *next;
+  struct msg *msg;
+};
+
 struct msg_fifo
 {
   unsigned long count;
 
-  struct msg *head;
-  struct msg *tail;
+  struct msg_fifo_node *head;
+  struct msg_fifo_node *tail;
 };
 
 /* Prototype for message fifo queues. */
 extern struct msg_fifo *msg_fifo_new (void);
-extern void msg_fifo_push (struct msg_fifo *, struct msg *msg);
+extern struct msg_fifo_node *msg_fifo_push (struct msg_fifo *,
+					    struct msg *msg);
 extern struct msg *msg_fifo_pop (struct msg_fifo *fifo);
 extern struct msg *msg_fifo_head (struct msg_fifo *fifo);
 extern void msg_fifo_flush (struct msg_fifo *fifo);
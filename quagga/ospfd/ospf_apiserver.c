@@ -40,6 +40,8 @@
 #include "hash.h"
 #include "sockunion.h"		/* for inet_aton() */
 #include "buffer.h"
+#include "network.h"
+#include "jhash.h"
 
 #include <sys/types.h>
 
@@ -75,6 +77,23 @@
 /* List of all active connections. */
 struct list *apiserver_list;
 
+/* An LSA update or delete notify queued on the asynchronous channel of
+   a client, by the LSA it is about. */
+struct apiserver_lsa_notify
+{
+  struct in_addr ifaddr;
+  struct in_addr area_id;
+  u_char type;
+  struct in_addr id;
+  struct in_addr adv_router;
+
+  /* Where the notify is in out_async_fifo. */
+  struct msg_fifo_node *node;
+};
+
+static void apiserver_sync_free (struct ospf_apiserver *apiserv);
+static void ospf_apiserver_register_vty (void);
+
 /* -----------------------------------------------------------
  * Functions to lookup interfaces
  * -----------------------------------------------------------
@@ -147,6 +166,8 @@ ospf_apiserver_init (void)
   /* Initialize list that keeps track of all connections. */
   apiserver_list = list_new ();
 
+  ospf_apiserver_register_vty ();
+
   /* Register opaque-independent call back functions. These functions
      are invoked on ISM, NSM changes and LSA update and LSA deletes */
   rc =
@@ -256,6 +277,66 @@ ospf_apiserver_del_lsa_hook (struct ospf_lsa *lsa)
   return 0;
 }
 
+/* The LSA key of an LSA update or delete notify. */
+static void
+apiserver_lsa_notify_set (struct apiserver_lsa_notify *key, struct msg *msg)
+{
+  struct msg_lsa_change_notify *nmsg;
+
+  nmsg = (struct msg_lsa_change_notify *) STREAM_DATA (msg->s);
+  key->ifaddr = nmsg->ifaddr;
+  key->area_id = nmsg->area_id;
+  key->type = nmsg->data.type;
+  key->id = nmsg->data.id;
+  key->adv_router = nmsg->data.adv_router;
+  key->node = NULL;
+}
+
+static unsigned int
+apiserver_lsa_notify_key (void *arg)
+{
+  struct apiserver_lsa_notify *key = arg;
+
+  return jhash_3words (key->id.s_addr, key->adv_router.s_addr,
+		       key->area_id.s_addr ^ key->ifaddr.s_addr, key->type);
+}
+
+static int
+apiserver_lsa_notify_cmp (void *arg1, void *arg2)
+{
+  struct apiserver_lsa_notify *k1 = arg1;
+  struct apiserver_lsa_notify *k2 = arg2;
+
+  return (k1->type == k2->type
+	  && IPV4_ADDR_SAME (&k1->id, &k2->id)
+	  && IPV4_ADDR_SAME (&k1->adv_router, &k2->adv_router)
+	  && IPV4_ADDR_SAME (&k1->area_id, &k2->area_id)
+	  && IPV4_ADDR_SAME (&k1->ifaddr, &k2->ifaddr));
+}
+
+static void *
+apiserver_lsa_notify_alloc (void *arg)
+{
+  struct apiserver_lsa_notify *new;
+
+  new = XMALLOC (MTYPE_OSPF_APISERVER, sizeof (struct apiserver_lsa_notify));
+  memcpy (new, arg, sizeof (struct apiserver_lsa_notify));
+  return new;
+}
+
+static void
+apiserver_lsa_notify_free (void *arg)
+{
+  XFREE (MTYPE_OSPF_APISERVER, arg);
+}
+
+static int
+apiserver_is_lsa_notify (struct msg *msg)
+{
+  return (msg->hdr.msgtype == MSG_LSA_UPDATE_NOTIFY
+	  || msg->hdr.msgtype == MSG_LSA_DELETE_NOTIFY);
+}
+
 /* Allocate new connection structure. */
 struct ospf_apiserver *
 ospf_apiserver_new (int fd_sync, int fd_async)
@@ -281,12 +362,22 @@ ospf_apiserver_new (int fd_sync, int fd_async)
 
   new->out_sync_fifo = msg_fifo_new ();
   new->out_async_fifo = msg_fifo_new ();
+  new->out_async_lsa = hash_create (apiserver_lsa_notify_key,
+				    apiserver_lsa_notify_cmp);
+  new->out_async_buf = buffer_new (0);
+  new->sync = NULL;
+  new->async_sent = 0;
+  new->async_coalesced = 0;
+  new->async_dropped = 0;
+  new->async_synced = 0;
+  new->async_max = 0;
   new->t_sync_read = NULL;
 #ifdef USE_ASYNC_READ
   new->t_async_read = NULL;
 #endif /* USE_ASYNC_READ */
   new->t_sync_write = NULL;
   new->t_async_write = NULL;
+  new->t_close = NULL;
 
   new->filter->typemask = 0;	/* filter all LSAs */
   new->filter->origin = ANY_ORIGIN;
@@ -331,6 +422,13 @@ ospf_apiserver_event (enum event event, int fd,
 	    thread_add_write (master, ospf_apiserver_async_write, apiserv, fd);
 	}
       break;
+    case OSPF_APISERVER_CLOSE:
+      if (!apiserv->t_close)
+	{
+	  apiserv->t_close =
+	    thread_add_event (master, ospf_apiserver_close, apiserv, fd);
+	}
+      break;
     }
 }
 
@@ -363,6 +461,11 @@ ospf_apiserver_free (struct ospf_apiserver *apiserv)
       thread_cancel (apiserv->t_async_write);
     }
 
+  if (apiserv->t_close)
+    {
+      thread_cancel (apiserv->t_close);
+    }
+
   /* Unregister all opaque types that application registered 
      and flush opaque LSAs if still in LSDB. */
 
@@ -389,6 +492,10 @@ ospf_apiserver_free (struct ospf_apiserver *apiserv)
   /* Free fifos */
   msg_fifo_free (apiserv->out_sync_fifo);
   msg_fifo_free (apiserv->out_async_fifo);
+  hash_clean (apiserv->out_async_lsa, apiserver_lsa_notify_free);
+  hash_free (apiserv->out_async_lsa);
+  buffer_free (apiserv->out_async_buf);
+  apiserver_sync_free (apiserv);
 
   /* Clear temporary strage for LSA instances to be refreshed. */
   ospf_lsdb_delete_all (&apiserv->reserve);
@@ -541,13 +648,38 @@ ospf_apiserver_sync_write (struct thread *thread)
 }
 
 
+/* Take the next message off the asynchronous fifo. */
+static struct msg *
+apiserver_async_pop (struct ospf_apiserver *apiserv)
+{
+  struct apiserver_lsa_notify key, *notify;
+  struct msg *msg;
+
+  msg = msg_fifo_pop (apiserv->out_async_fifo);
+  if (msg && apiserver_is_lsa_notify (msg))
+    {
+      apiserver_lsa_notify_set (&key, msg);
+      notify = hash_release (apiserv->out_async_lsa, &key);
+      if (notify)
+	apiserver_lsa_notify_free (notify);
+    }
+  return msg;
+}
+
+static void apiserver_sync_walk (struct ospf_apiserver *apiserv);
+
+/* The asynchronous channel is non-blocking: messages are moved from
+   the fifo to out_async_buf a batch at a time and written as far as the
+   socket takes them.  The LSDB walk of a sync request is carried on
+   while the fifo runs low, so a large LSDB is never queued at once. */
 int
 ospf_apiserver_async_write (struct thread *thread)
 {
   struct ospf_apiserver *apiserv;
   struct msg *msg;
   int fd;
-  int rc = -1;
+  int i;
+  unsigned long bytes;
 
   apiserv = THREAD_ARG (thread);
   assert (apiserv);
@@ -559,7 +691,8 @@ ospf_apiserver_async_write (struct thread *thread)
   if (fd != apiserv->fd_async)
     {
       zlog_warn ("ospf_apiserver_async_write: Unknown fd=%d", fd);
-      goto out;
+      ospf_apiserver_free (apiserv);
+      return -1;
     }
 
   if (IS_DEBUG_OSPF_EVENT)
@@ -567,46 +700,68 @@ ospf_apiserver_async_write (struct thread *thread)
                 inet_ntoa (apiserv->peer_async.sin_addr),
                 ntohs (apiserv->peer_async.sin_port));
 
-  /* Check whether there is really a message in the fifo. */
-  msg = msg_fifo_pop (apiserv->out_async_fifo);
-  if (!msg)
+  for (bytes = 0; bytes < OSPF_APISERVER_WRITE_MAX; )
     {
-      zlog_warn ("API: ospf_apiserver_async_write: No message in Async-FIFO?");
-      return 0;
-    }
+      for (i = 0; i < OSPF_APISERVER_SYNC_BATCH; i++)
+	{
+	  if (apiserv->sync
+	      && apiserv->out_async_fifo->count < OSPF_APISERVER_SYNC_BATCH)
+	    apiserver_sync_walk (apiserv);
 
-  if (IS_DEBUG_OSPF_EVENT)
-    msg_print (msg);
+	  if ((msg = apiserver_async_pop (apiserv)) == NULL)
+	    break;
 
-  rc = msg_write (fd, msg);
+	  if (IS_DEBUG_OSPF_EVENT)
+	    msg_print (msg);
 
-  /* Once a message is dequeued, it should be freed anyway. */
-  msg_free (msg);
-
-  if (rc < 0)
-    {
-      zlog_warn
-        ("ospf_apiserver_async_write: write failed on fd=%d", fd);
-      goto out;
-    }
+	  buffer_put (apiserv->out_async_buf, &msg->hdr,
+		      sizeof (struct apimsghdr));
+	  buffer_put (apiserv->out_async_buf, STREAM_DATA (msg->s),
+		      ntohs (msg->hdr.msglen));
+	  bytes += sizeof (struct apimsghdr) + ntohs (msg->hdr.msglen);
+	  apiserv->async_sent++;
 
+	  /* Once a message is dequeued, it should be freed anyway. */
+	  msg_free (msg);
+	}
 
-  /* If more messages are in async message fifo, schedule write thread. */
-  if (msg_fifo_head (apiserv->out_async_fifo))
-    {
-      ospf_apiserver_event (OSPF_APISERVER_ASYNC_WRITE, apiserv->fd_async,
-                            apiserv);
+      switch (buffer_flush_available (apiserv->out_async_buf, fd))
+	{
+	case BUFFER_ERROR:
+	  zlog_warn
+	    ("ospf_apiserver_async_write: write failed on fd=%d", fd);
+	  /* Perform cleanup and disconnect with peer */
+	  ospf_apiserver_free (apiserv);
+	  return -1;
+	case BUFFER_PENDING:
+	  ospf_apiserver_event (OSPF_APISERVER_ASYNC_WRITE, fd, apiserv);
+	  return 0;
+	case BUFFER_EMPTY:
+	  if (!msg_fifo_head (apiserv->out_async_fifo) && !apiserv->sync)
+	    return 0;
+	  break;
+	}
     }
 
- out:
+  /* More to write, let other threads run first. */
+  ospf_apiserver_event (OSPF_APISERVER_ASYNC_WRITE, fd, apiserv);
+  return 0;
+}
 
-  if (rc < 0)
-    {
-      /* Perform cleanup and disconnect with peer */
-      ospf_apiserver_free (apiserv);
-    }
+/* Close the connection of a client that could not keep up. */
+int
+ospf_apiserver_close (struct thread *thread)
+{
+  struct ospf_apiserver *apiserv;
 
-  return rc;
+  apiserv = THREAD_ARG (thread);
+  apiserv->t_close = NULL;
+
+  zlog_warn ("API: Closing connection to %s/%u, %lu messages dropped",
+	     inet_ntoa (apiserv->peer_sync.sin_addr),
+	     ntohs (apiserv->peer_sync.sin_port), apiserv->async_dropped);
+  ospf_apiserver_free (apiserv);
+  return 0;
 }
 
 
@@ -741,6 +896,9 @@ ospf_apiserver_accept (struct thread *thread)
       close (new_async_sock);
       return -1;
     }
+
+  /* The asynchronous channel is written through out_async_buf. */
+  set_nonblocking (new_async_sock);
 #endif /* USE_ASYNC_READ */
 
   /* Allocate new server-side connection structure */
@@ -773,7 +931,8 @@ static int
 ospf_apiserver_send_msg (struct ospf_apiserver *apiserv, struct msg *msg)
 {
   struct msg_fifo *fifo;
-  struct msg *msg2;
+  struct msg_fifo_node *node;
+  struct apiserver_lsa_notify key, *notify;
   enum event event;
   int fd;
 
@@ -801,13 +960,46 @@ ospf_apiserver_send_msg (struct ospf_apiserver *apiserv, struct msg *msg)
       return -1;
     }
 
-  /* Make a copy of the message and put in the fifo. Once the fifo
-     gets drained by the write thread, the message will be freed. */
-  /* NB: Given "msg" is untouched in this function. */
-  msg2 = msg_dup (msg);
+  /* Put a reference to the message in the fifo, it is shared by all
+     clients it is sent to and freed once the last fifo is drained. */
+  if (fifo == apiserv->out_async_fifo)
+    {
+      /* A notify for an LSA that already has one queued replaces it. */
+      if (apiserver_is_lsa_notify (msg))
+	{
+	  apiserver_lsa_notify_set (&key, msg);
+	  notify = hash_lookup (apiserv->out_async_lsa, &key);
+	  if (notify)
+	    {
+	      msg_free (notify->node->msg);
+	      notify->node->msg = msg_ref (msg);
+	      apiserv->async_coalesced++;
+	      return 0;
+	    }
+	}
 
-  /* Enqueue message into corresponding fifo queue */
-  msg_fifo_push (fifo, msg2);
+      if (fifo->count >= OSPF_APISERVER_ASYNC_MAX)
+	{
+	  if (apiserv->async_dropped++ == 0)
+	    zlog_warn ("ospf_apiserver_send_msg: %lu messages queued for "
+		       "%s/%u", fifo->count,
+		       inet_ntoa (apiserv->peer_async.sin_addr),
+		       ntohs (apiserv->peer_async.sin_port));
+	  ospf_apiserver_event (OSPF_APISERVER_CLOSE, fd, apiserv);
+	  return -1;
+	}
+
+      node = msg_fifo_push (fifo, msg_ref (msg));
+      if (apiserver_is_lsa_notify (msg))
+	{
+	  key.node = node;
+	  hash_get (apiserv->out_async_lsa, &key, apiserver_lsa_notify_alloc);
+	}
+      if (fifo->count > apiserv->async_max)
+	apiserv->async_max = fifo->count;
+    }
+  else
+    msg_fifo_push (fifo, msg_ref (msg));
 
   /* Schedule write thread */
   ospf_apiserver_event (event, fd, apiserv);
@@ -1270,31 +1462,21 @@ ospf_apiserver_handle_register_event (struct ospf_apiserver *apiserv,
  * -----------------------------------------------------------
  */
 
+/* Queue an LSA for a sync request, returns 1 if it passed the origin
+   filter. */
 static int
-apiserver_sync_callback (struct ospf_lsa *lsa, void *p_arg, int int_arg)
+apiserver_sync_callback (struct ospf_apiserver *apiserv,
+			 struct lsa_filter_type *filter,
+			 struct ospf_lsa *lsa, u_int32_t seqnum)
 {
-  struct ospf_apiserver *apiserv;
-  int seqnum;
   struct msg *msg;
-  struct param_t
-  {
-    struct ospf_apiserver *apiserv;
-    struct lsa_filter_type *filter;
-  }
-   *param;
-  int rc = -1;
 
   /* Sanity check */
   assert (lsa->data);
-  assert (p_arg);
-
-  param = (struct param_t *) p_arg;
-  apiserv = param->apiserv;
-  seqnum = (u_int32_t) int_arg;
 
   /* Check origin in filter. */
-  if ((param->filter->origin == ANY_ORIGIN) ||
-      (param->filter->origin == (lsa->flags & OSPF_LSA_SELF)))
+  if ((filter->origin == ANY_ORIGIN) ||
+      (filter->origin == (lsa->flags & OSPF_LSA_SELF)))
     {
 
       /* Default area for AS-External and Opaque11 LSAs */
@@ -1319,127 +1501,209 @@ apiserver_sync_callback (struct ospf_lsa *lsa, void *p_arg, int int_arg)
       if (!msg)
 	{
 	  zlog_warn ("apiserver_sync_callback: new_msg_update failed");
-#ifdef NOTYET
-	  /* Cannot allocate new message. What should we do? */
-/*        ospf_apiserver_free (apiserv);*//* Do nothing here XXX */
-#endif
-	  goto out;
+	  return 0;
 	}
 
       /* Send LSA */
       ospf_apiserver_send_msg (apiserv, msg);
       msg_free (msg);
+      apiserv->async_synced++;
+      return 1;
     }
-  rc = 0;
+  return 0;
+}
 
-out:
-  return rc;
+/* LSA types of an area LSDB and of the AS LSDB, in walk order. */
+static const u_char apiserver_sync_area_types[] =
+{
+  OSPF_ROUTER_LSA,
+  OSPF_NETWORK_LSA,
+  OSPF_SUMMARY_LSA,
+  OSPF_ASBR_SUMMARY_LSA,
+  OSPF_OPAQUE_LINK_LSA,
+  OSPF_OPAQUE_AREA_LSA,
+};
+#define APISERVER_SYNC_AREA_TYPES \
+  (sizeof (apiserver_sync_area_types) / sizeof (apiserver_sync_area_types[0]))
+
+static const u_char apiserver_sync_as_types[] =
+{
+  OSPF_AS_EXTERNAL_LSA,
+  OSPF_OPAQUE_AS_LSA,
+};
+#define APISERVER_SYNC_AS_TYPES \
+  (sizeof (apiserver_sync_as_types) / sizeof (apiserver_sync_as_types[0]))
+
+static void
+apiserver_sync_free (struct ospf_apiserver *apiserv)
+{
+  if (apiserv->sync)
+    {
+      XFREE (MTYPE_OSPF_APISERVER_MSGFILTER, apiserv->sync->filter);
+      XFREE (MTYPE_OSPF_APISERVER, apiserv->sync);
+      apiserv->sync = NULL;
+    }
 }
 
-int
-ospf_apiserver_handle_sync_lsdb (struct ospf_apiserver *apiserv,
-				 struct msg *msg)
+/* Compare area_id with area_ids in sync request. */
+static int
+apiserver_sync_area_match (struct lsa_filter_type *filter,
+			   struct in_addr area_id)
 {
-  struct listnode *node, *nnode;
-  u_int32_t seqnum;
-  int rc = 0;
-  struct msg_sync_lsdb *smsg;
-  struct ospf_apiserver_param_t
-  {
-    struct ospf_apiserver *apiserv;
-    struct lsa_filter_type *filter;
-  } param;
-  u_int16_t mask;
-  struct route_node *rn;
-  struct ospf_lsa *lsa;
+  u_int32_t *ids;
+  int i;
+
+  if (filter->num_areas == 0)
+    return 1;
+
+  /* The list of area IDs is at the end of the filter. */
+  ids = (u_int32_t *) (filter + 1);
+  for (i = 0; i < filter->num_areas; i++)
+    if (ids[i] == area_id.s_addr)
+      return 1;
+  return 0;
+}
+
+/* Queue up to OSPF_APISERVER_SYNC_BATCH more LSAs of the sync request,
+   from after the last one queued.  The LSDBs may have changed since, an
+   LSA added behind the walk is sent by its update notify. */
+static void
+apiserver_sync_walk (struct ospf_apiserver *apiserv)
+{
+  struct ospf_apiserver_sync *sync = apiserv->sync;
   struct ospf *ospf;
   struct ospf_area *area;
+  struct ospf_lsdb *lsdb;
+  struct ospf_lsa *lsa;
+  struct listnode *node;
+  u_int16_t mask;
+  u_char type;
+  int queued = 0;
 
   ospf = ospf_lookup ();
+  mask = ntohs (sync->filter->typemask);
 
-  /* Get request sequence number */
-  seqnum = msg_get_seq (msg);
-  /* Set sync msg. */
-  smsg = (struct msg_sync_lsdb *) STREAM_DATA (msg->s);
+  while (queued < OSPF_APISERVER_SYNC_BATCH)
+    {
+      if (ospf == NULL)
+	{
+	  apiserver_sync_free (apiserv);
+	  return;
+	}
 
-  /* Set parameter struct. */
-  param.apiserv = apiserv;
-  param.filter = &smsg->filter;
+      if (!sync->as_scope)
+	{
+	  /* The area being walked, or the next one after it. */
+	  for (ALL_LIST_ELEMENTS_RO (ospf->areas, node, area))
+	    if (!sync->area_valid
+		|| ntohl (area->area_id.s_addr) >= ntohl (sync->area_id.s_addr))
+	      break;
 
-  /* Remember mask. */
-  mask = ntohs (smsg->filter.typemask);
+	  if (node == NULL)
+	    {
+	      sync->as_scope = 1;
+	      sync->type_index = 0;
+	      sync->first = 1;
+	      continue;
+	    }
 
-  /* Iterate over all areas. */
-  for (ALL_LIST_ELEMENTS (ospf->areas, node, nnode, area))
-    {
-      int i;
-      u_int32_t *area_id = NULL;
+	  if (!sync->area_valid
+	      || !IPV4_ADDR_SAME (&area->area_id, &sync->area_id))
+	    {
+	      sync->area_id = area->area_id;
+	      sync->area_valid = 1;
+	      sync->type_index = 0;
+	      sync->first = 1;
+	    }
 
-      /* Compare area_id with area_ids in sync request. */
-      if ((i = smsg->filter.num_areas) > 0)
-	{
-	  /* Let area_id point to the list of area IDs,
-	   * which is at the end of smsg->filter. */
-	  area_id = (u_int32_t *) (&smsg->filter + 1);
-	  while (i)
+	  if (sync->type_index >= (int) APISERVER_SYNC_AREA_TYPES
+	      || !apiserver_sync_area_match (sync->filter, area->area_id))
 	    {
-	      if (*area_id == area->area_id.s_addr)
-		{
-		  break;
-		}
-	      i--;
-	      area_id++;
+	      /* On to the next area. */
+	      if (ntohl (area->area_id.s_addr) == 0xffffffff)
+		sync->as_scope = 1;
+	      else
+		sync->area_id.s_addr = htonl (ntohl (area->area_id.s_addr) + 1);
+	      sync->type_index = 0;
+	      sync->first = 1;
+	      continue;
 	    }
+
+	  type = apiserver_sync_area_types[sync->type_index];
+	  lsdb = area->lsdb;
 	}
       else
 	{
-	  i = 1;
+	  if (sync->type_index >= (int) APISERVER_SYNC_AS_TYPES
+	      || ospf->lsdb == NULL)
+	    {
+	      apiserver_sync_free (apiserv);
+	      return;
+	    }
+
+	  type = apiserver_sync_as_types[sync->type_index];
+	  lsdb = ospf->lsdb;
 	}
 
-      /* If area was found, then i>0 here. */
-      if (i)
+      /* Check msg type. */
+      lsa = NULL;
+      if (mask & Power2[type])
+	lsa = ospf_lsdb_lookup_by_id_next (lsdb, type, sync->id,
+					   sync->adv_router, sync->first);
+      if (lsa == NULL)
 	{
-	  /* Check msg type. */
-	  if (mask & Power2[OSPF_ROUTER_LSA])
-	    LSDB_LOOP (ROUTER_LSDB (area), rn, lsa)
-	      apiserver_sync_callback(lsa, (void *) &param, seqnum);
-	  if (mask & Power2[OSPF_NETWORK_LSA])
-            LSDB_LOOP (NETWORK_LSDB (area), rn, lsa)
-              apiserver_sync_callback(lsa, (void *) &param, seqnum);
-	  if (mask & Power2[OSPF_SUMMARY_LSA])
-            LSDB_LOOP (SUMMARY_LSDB (area), rn, lsa)
-              apiserver_sync_callback(lsa, (void *) &param, seqnum);
-	  if (mask & Power2[OSPF_ASBR_SUMMARY_LSA])
-            LSDB_LOOP (ASBR_SUMMARY_LSDB (area), rn, lsa)
-              apiserver_sync_callback(lsa, (void *) &param, seqnum);
-	  if (mask & Power2[OSPF_OPAQUE_LINK_LSA])
-            LSDB_LOOP (OPAQUE_LINK_LSDB (area), rn, lsa)
-              apiserver_sync_callback(lsa, (void *) &param, seqnum);
-	  if (mask & Power2[OSPF_OPAQUE_AREA_LSA])
-            LSDB_LOOP (OPAQUE_AREA_LSDB (area), rn, lsa)
-              apiserver_sync_callback(lsa, (void *) &param, seqnum);
+	  sync->type_index++;
+	  sync->first = 1;
+	  continue;
 	}
-    }
 
-  /* For AS-external LSAs */
-  if (ospf->lsdb)
-    {
-      if (mask & Power2[OSPF_AS_EXTERNAL_LSA])
-	LSDB_LOOP (EXTERNAL_LSDB (ospf), rn, lsa)
-	  apiserver_sync_callback(lsa, (void *) &param, seqnum);
+      sync->id = lsa->data->id;
+      sync->adv_router = lsa->data->adv_router;
+      sync->first = 0;
+      queued += apiserver_sync_callback (apiserv, sync->filter, lsa,
+					 sync->seqnum);
     }
+}
+
+int
+ospf_apiserver_handle_sync_lsdb (struct ospf_apiserver *apiserv,
+				 struct msg *msg)
+{
+  struct ospf_apiserver_sync *sync;
+  struct msg_sync_lsdb *smsg;
+  u_int32_t seqnum;
+  int len;
 
-  /* For AS-external opaque LSAs */
-  if (ospf->lsdb)
+  /* Get request sequence number */
+  seqnum = msg_get_seq (msg);
+  /* Set sync msg. */
+  smsg = (struct msg_sync_lsdb *) STREAM_DATA (msg->s);
+
+  /* The filter with its list of area IDs. */
+  len = sizeof (struct lsa_filter_type)
+    + smsg->filter.num_areas * sizeof (u_int32_t);
+  if (len > ntohs (msg->hdr.msglen))
     {
-      if (mask & Power2[OSPF_OPAQUE_AS_LSA])
-	LSDB_LOOP (OPAQUE_AS_LSDB (ospf), rn, lsa)
-	  apiserver_sync_callback(lsa, (void *) &param, seqnum);
+      zlog_warn ("ospf_apiserver_handle_sync_lsdb: %d areas in %d bytes",
+		 smsg->filter.num_areas, ntohs (msg->hdr.msglen));
+      return ospf_apiserver_send_reply (apiserv, seqnum, OSPF_API_ERROR);
     }
 
+  /* A new request starts the walk over. */
+  apiserver_sync_free (apiserv);
+  sync = XCALLOC (MTYPE_OSPF_APISERVER, sizeof (struct ospf_apiserver_sync));
+  sync->filter = XMALLOC (MTYPE_OSPF_APISERVER_MSGFILTER, len);
+  memcpy (sync->filter, &smsg->filter, len);
+  sync->seqnum = seqnum;
+  sync->first = 1;
+  apiserv->sync = sync;
+
+  /* The LSAs are queued as the asynchronous channel drains. */
+  ospf_apiserver_event (OSPF_APISERVER_ASYNC_WRITE, apiserv->fd_async,
+			apiserv);
+
   /* Send a reply back to client with return code */
-  rc = ospf_apiserver_send_reply (apiserv, seqnum, rc);
-  return rc;
+  return ospf_apiserver_send_reply (apiserv, seqnum, OSPF_API_OK);
 }
 
 
@@ -2588,13 +2852,6 @@ apiserver_clients_lsa_change_notify (u_char msgtype, struct ospf_lsa *lsa)
 static int
 apiserver_notify_clients_lsa (u_char msgtype, struct ospf_lsa *lsa)
 {
-  struct msg *msg;
-  /* default area for AS-External and Opaque11 LSAs */
-  struct in_addr area_id = { .s_addr = 0L };
-
-  /* default interface for non Opaque9 LSAs */
-  struct in_addr ifaddr = { .s_addr = 0L };
-
   /* Only notify this update if the LSA's age is smaller than
      MAXAGE. Otherwise clients would see LSA updates with max age just
      before they are deleted from the LSDB. LSA delete messages have
@@ -2603,28 +2860,9 @@ apiserver_notify_clients_lsa (u_char msgtype, struct ospf_lsa *lsa)
     return 0;
   }
 
-  if (lsa->area)
-    {
-      area_id = lsa->area->area_id;
-    }
-  if (lsa->data->type == OSPF_OPAQUE_LINK_LSA)
-    {
-      ifaddr = lsa->oi->address->u.prefix4;
-    }
-  msg = new_msg_lsa_change_notify (msgtype, 0L,	/* no sequence number */
-				   ifaddr, area_id,
-				   lsa->flags & OSPF_LSA_SELF, lsa->data);
-  if (!msg)
-    {
-      zlog_warn ("notify_clients_lsa: msg_new failed");
-      return -1;
-    }
   /* Notify all clients that new LSA is added/updated */
   apiserver_clients_lsa_change_notify (msgtype, lsa);
 
-  /* Clients made their own copies of msg so we can free msg here */
-  msg_free (msg);
-
   return 0;
 }
 
@@ -2640,5 +2878,61 @@ ospf_apiserver_lsa_delete (struct ospf_lsa *lsa)
   return apiserver_notify_clients_lsa (MSG_LSA_DELETE_NOTIFY, lsa);
 }
 
+
+/* -----------------------------------------------------------
+ * Client connection statistics
+ * -----------------------------------------------------------
+ */
+
+DEFUN (show_ip_ospf_apiserver,
+       show_ip_ospf_apiserver_cmd,
+       "show ip ospf apiserver",
+       SHOW_STR
+       IP_STR
+       "OSPF information\n"
+       "OSPF API server clients\n")
+{
+  struct listnode *node;
+  struct ospf_apiserver *apiserv;
+
+  vty_out (vty, "%u OSPF API clients%s", listcount (apiserver_list),
+	   VTY_NEWLINE);
+
+  for (ALL_LIST_ELEMENTS_RO (apiserver_list, node, apiserv))
+    {
+      vty_out (vty, "Client %s/%u, asynchronous port %u%s",
+	       inet_ntoa (apiserv->peer_sync.sin_addr),
+	       ntohs (apiserv->peer_sync.sin_port),
+	       ntohs (apiserv->peer_async.sin_port), VTY_NEWLINE);
+      vty_out (vty, "  Queued: %lu replies, %lu notifies (most %lu), "
+	       "%lu bytes unwritten%s", apiserv->out_sync_fifo->count,
+	       apiserv->out_async_fifo->count, apiserv->async_max,
+	       (unsigned long) buffer_pending (apiserv->out_async_buf),
+	       VTY_NEWLINE);
+      vty_out (vty, "  Notifies: %lu sent, %lu coalesced, %lu dropped, "
+	       "%lu LSAs synced%s", apiserv->async_sent,
+	       apiserv->async_coalesced, apiserv->async_dropped,
+	       apiserv->async_synced, VTY_NEWLINE);
+      if (apiserv->sync)
+	{
+	  if (apiserv->sync->as_scope)
+	    vty_out (vty, "  LSDB sync in progress, AS scope LSAs%s",
+		     VTY_NEWLINE);
+	  else
+	    vty_out (vty, "  LSDB sync in progress, area %s%s",
+		     inet_ntoa (apiserv->sync->area_id), VTY_NEWLINE);
+	}
+    }
+
+  return CMD_SUCCESS;
+}
+
+static void
+ospf_apiserver_register_vty (void)
+{
+  install_element (VIEW_NODE, &show_ip_ospf_apiserver_cmd);
+  install_element (ENABLE_NODE, &show_ip_ospf_apiserver_cmd);
+}
+
 #endif /* SUPPORT_OSPF_API */
 
@@ -27,6 +27,16 @@
 #define MTYPE_OSPF_APISERVER MTYPE_TMP
 #define MTYPE_OSPF_APISERVER_MSGFILTER MTYPE_TMP
 
+/* Limits of the asynchronous channel of a client: at most
+   OSPF_APISERVER_ASYNC_MAX messages queued, else the client is too slow
+   and gets disconnected.  The LSDB walk of a sync request adds
+   OSPF_APISERVER_SYNC_BATCH LSAs at a time while fewer than that are
+   queued, and each run of the write thread writes up to
+   OSPF_APISERVER_WRITE_MAX bytes. */
+#define OSPF_APISERVER_ASYNC_MAX	100000
+#define OSPF_APISERVER_SYNC_BATCH	256
+#define OSPF_APISERVER_WRITE_MAX	(256 * 1024)
+
 /* List of opaque types that application registered */
 struct registered_opaque_type
 {
@@ -62,6 +72,25 @@ struct ospf_apiserver
   struct msg_fifo *out_sync_fifo;
   struct msg_fifo *out_async_fifo;
 
+  /* LSA update and delete notifies in out_async_fifo, by LSA.  A later
+     notify for the same LSA takes the place of the queued one. */
+  struct hash *out_async_lsa;
+
+  /* Messages taken from out_async_fifo and not yet written, the
+     asynchronous channel is non-blocking. */
+  struct buffer *out_async_buf;
+
+  /* LSDB walk of a sync request, carried on as the asynchronous
+     channel drains. */
+  struct ospf_apiserver_sync *sync;
+
+  /* Statistics of the asynchronous channel */
+  unsigned long async_sent;		/* messages written */
+  unsigned long async_coalesced;	/* notifies replaced by a later one */
+  unsigned long async_dropped;		/* messages over the queue limit */
+  unsigned long async_synced;		/* LSAs sent for sync requests */
+  unsigned long async_max;		/* most messages queued */
+
   /* Read and write threads */
   struct thread *t_sync_read;
 #ifdef USE_ASYNC_READ
@@ -69,6 +98,26 @@ struct ospf_apiserver
 #endif /* USE_ASYNC_READ */
   struct thread *t_sync_write;
   struct thread *t_async_write;
+
+  /* Closes the connection of a client over the queue limit. */
+  struct thread *t_close;
+};
+
+/* Position of the LSDB walk of a sync request: the areas in order of
+   their IDs with the area scope LSA types, then the AS scope types,
+   each LSDB from after the last LSA sent. */
+struct ospf_apiserver_sync
+{
+  u_int32_t seqnum;
+  struct lsa_filter_type *filter;	/* with its area IDs */
+
+  int as_scope;
+  struct in_addr area_id;
+  int area_valid;			/* area_id is being walked */
+  int type_index;
+  struct in_addr id;
+  struct in_addr adv_router;
+  int first;				/* nothing sent from this LSDB yet */
 };
 
 enum event
@@ -79,7 +128,8 @@ enum event
   OSPF_APISERVER_ASYNC_READ,
 #endif /* USE_ASYNC_READ */
   OSPF_APISERVER_SYNC_WRITE,
-  OSPF_APISERVER_ASYNC_WRITE
+  OSPF_APISERVER_ASYNC_WRITE,
+  OSPF_APISERVER_CLOSE
 };
 
 /* -----------------------------------------------------------
@@ -99,6 +149,7 @@ extern int ospf_apiserver_accept (struct thread *thread);
 extern int ospf_apiserver_read (struct thread *thread);
 extern int ospf_apiserver_sync_write (struct thread *thread);
 extern int ospf_apiserver_async_write (struct thread *thread);
+extern int ospf_apiserver_close (struct thread *thread);
 extern int ospf_apiserver_send_reply (struct ospf_apiserver *apiserv,
 			       u_int32_t seqnr, u_char rc);
 
@@ -860,7 +860,6 @@ ospf_vl_new (struct ospf *ospf, struct ospf_vl_data *vl_data)
   vi = if_create (ifname, strnlen(ifname, sizeof(ifname)));
   co = connected_new ();
   co->ifp = vi;
-  listnode_add (vi->connected, co);
 
   p = prefix_ipv4_new ();
   p->family = AF_INET;
@@ -868,6 +867,7 @@ ospf_vl_new (struct ospf *ospf, struct ospf_vl_data *vl_data)
   p->prefixlen = 0;
  
   co->address = (struct prefix *)p;
+  connected_add (vi, co);
   
   voi = ospf_if_new (ospf, vi, co->address);
   if (voi == NULL)
@@ -904,12 +904,26 @@ ospf_vl_new (struct ospf *ospf, struct ospf_vl_data *vl_data)
   return voi;
 }
 
+/* The address of the virtual link is in lib's interface address
+   index, change it through here. */
+static void
+ospf_vl_set_address (struct ospf_interface *voi, struct in_addr addr,
+		     u_char prefixlen)
+{
+  connected_delete (voi->ifp, voi->connected);
+  voi->address->u.prefix4 = addr;
+  voi->address->prefixlen = prefixlen;
+  connected_add (voi->ifp, voi->connected);
+}
+
 static void
 ospf_vl_if_delete (struct ospf_vl_data *vl_data)
 {
   struct interface *ifp = vl_data->vl_oi->ifp;
-  vl_data->vl_oi->address->u.prefix4.s_addr = 0;
-  vl_data->vl_oi->address->prefixlen = 0;
+  struct in_addr any;
+
+  any.s_addr = INADDR_ANY;
+  ospf_vl_set_address (vl_data->vl_oi, any, 0);
   ospf_if_free (vl_data->vl_oi);
   if_delete (ifp);
   vlink_count--;
@@ -953,12 +967,13 @@ static void
 ospf_vl_shutdown (struct ospf_vl_data *vl_data)
 {
   struct ospf_interface *oi;
+  struct in_addr any;
 
   if ((oi = vl_data->vl_oi) == NULL)
     return;
 
-  oi->address->u.prefix4.s_addr = 0;
-  oi->address->prefixlen = 0;
+  any.s_addr = INADDR_ANY;
+  ospf_vl_set_address (oi, any, 0);
 
   UNSET_FLAG (oi->ifp->flags, IFF_UP);
   /* OSPF_ISM_EVENT_SCHEDULE (oi, ISM_InterfaceDown); */
@@ -1016,8 +1031,8 @@ ospf_vl_set_params (struct ospf_vl_data *vl_data, struct vertex *v)
                           &vl_data->nexthop.oi->address->u.prefix4))
         changed = 1;
         
-      voi->address->u.prefix4 = vl_data->nexthop.oi->address->u.prefix4;
-      voi->address->prefixlen = vl_data->nexthop.oi->address->prefixlen;
+      ospf_vl_set_address (voi, vl_data->nexthop.oi->address->u.prefix4,
+			   vl_data->nexthop.oi->address->prefixlen);
 
       break; /* We take the first interface. */
     }
@@ -31,6 +31,7 @@
 #include "log.h"
 #include "thread.h"
 #include "hash.h"
+#include "checksum.h"
 #include "sockunion.h"		/* for inet_aton() */
 
 #include "ospfd/ospfd.h"
@@ -171,45 +172,16 @@ get_age (struct ospf_lsa *lsa)
 }
 
 
-/* Fletcher Checksum -- Refer to RFC1008. */
-#define MODX                 4102
-#define LSA_CHECKSUM_OFFSET    15
-
+/* Fletcher Checksum -- Refer to RFC1008.  It covers the LSA but the
+   age, the checksum offset is counted from the options field. */
 u_int16_t
 ospf_lsa_checksum (struct lsa_header *lsa)
 {
-  u_char *sp, *ep, *p, *q;
-  int c0 = 0, c1 = 0;
-  int x, y;
+  u_char *buffer = (u_char *) &lsa->options;
   u_int16_t length;
 
-  lsa->checksum = 0;
-  length = ntohs (lsa->length) - 2;
-  sp = (u_char *) &lsa->options;
-
-  for (ep = sp + length; sp < ep; sp = q)
-    {
-      q = sp + MODX;
-      if (q > ep)
-        q = ep;
-      for (p = sp; p < q; p++)
-        {
-          c0 += *p;
-          c1 += c0;
-        }
-      c0 %= 255;
-      c1 %= 255;
-    }
-
-  x = (((int)length - LSA_CHECKSUM_OFFSET) * c0 - c1) % 255;
-  if (x <= 0)
-    x += 255;
-  y = 510 - c0 - x;
-  if (y > 255)
-    y -= 255;
-
-  /* take care endian issue. */
-  lsa->checksum = htons ((x << 8) + y);
+  length = ntohs (lsa->length) - (buffer - (u_char *) lsa);
+  fletcher_checksum (buffer, length, (u_char *) &lsa->checksum - buffer);
 
   return (lsa->checksum);
 }
@@ -49,6 +49,7 @@ ospf_lsdb_init (struct ospf_lsdb *lsdb)
   
   for (i = OSPF_MIN_LSA; i < OSPF_MAX_LSA; i++)
     lsdb->type[i].db = route_table_init ();
+  lsdb->walk = NULL;
 }
 
 void
@@ -66,6 +67,12 @@ ospf_lsdb_cleanup (struct ospf_lsdb *lsdb)
   assert (lsdb->total == 0);
 
   ospf_lsdb_delete_all (lsdb);
+
+  if (lsdb->walk)
+    {
+      route_unlock_node (lsdb->walk);
+      lsdb->walk = NULL;
+    }
   
   for (i = OSPF_MIN_LSA; i < OSPF_MAX_LSA; i++)
     route_table_finish (lsdb->type[i].db);
@@ -252,6 +259,10 @@ ospf_lsdb_lookup_by_id (struct ospf_lsdb *lsdb, u_char type,
   return NULL;
 }
 
+/* The LSA after id and adv_router, or the first with first set.  Walks
+   such as the SNMP tables ask for the LSA after the one returned before,
+   that is resumed from lsdb->walk instead of looked up again.  No node is
+   added to the table. */
 struct ospf_lsa *
 ospf_lsdb_lookup_by_id_next (struct ospf_lsdb *lsdb, u_char type,
 			    struct in_addr id, struct in_addr adv_router,
@@ -270,22 +281,32 @@ ospf_lsdb_lookup_by_id_next (struct ospf_lsdb *lsdb, u_char type,
   lp.id = id;
   lp.adv_router = adv_router;
 
-  if (first)
-      rn = route_top (table);
+  rn = lsdb->walk;
+  lsdb->walk = NULL;
+  if (rn && !first && lsdb->walk_type == type
+      && IPV4_ADDR_SAME (&((struct prefix_ls *) &rn->p)->id, &id)
+      && IPV4_ADDR_SAME (&((struct prefix_ls *) &rn->p)->adv_router,
+			 &adv_router))
+    rn = route_next (rn);
   else
     {
-      rn = route_node_get (table, (struct prefix *) &lp);
-      rn = route_next (rn);
+      if (rn)
+	route_unlock_node (rn);
+      if (first)
+	rn = route_top (table);
+      else
+	rn = route_table_get_next (table, (struct prefix *) &lp);
     }
 
   for (; rn; rn = route_next (rn))
     if (rn->info)
       break;
 
-  if (rn && rn->info)
+  if (rn)
     {
       find = rn->info;
-      route_unlock_node (rn);
+      lsdb->walk = rn;
+      lsdb->walk_type = type;
       return find;
     }
   return NULL;
@@ -34,6 +34,10 @@ struct ospf_lsdb
     struct route_table *db;
   } type[OSPF_MAX_LSA];
   unsigned long total;
+  /* Node of the last ospf_lsdb_lookup_by_id_next, locked, to resume
+     from when the next call asks for the LSA after it. */
+  struct route_node *walk;
+  u_char walk_type;
 #define MONITOR_LSDB_CHANGE 1 /* XXX */
 #ifdef MONITOR_LSDB_CHANGE
   /* Hooks for callback functions to catch every add/del event. */
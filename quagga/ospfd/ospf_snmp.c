@@ -1953,10 +1953,7 @@ ospf_snmp_vl_lookup_next (struct in_addr *area_id, struct in_addr *neighbor,
   if (first)
     rn = route_top (ospf_snmp_vl_table);
   else
-    {
-      rn = route_node_get (ospf_snmp_vl_table, (struct prefix *) &lp);
-      rn = route_next (rn);
-    }
+    rn = route_table_get_next (ospf_snmp_vl_table, (struct prefix *) &lp);
 
   for (; rn; rn = route_next (rn))
     if (rn->info)
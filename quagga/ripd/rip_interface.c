@@ -133,6 +133,8 @@ rip_interface_new (void)
   ri->split_horizon_default = RIP_SPLIT_HORIZON;
   ri->split_horizon = ri->split_horizon_default;
 
+  ri->output = list_new ();
+
   return ri;
 }
 
@@ -464,6 +466,9 @@ rip_interface_add (int command, struct zclient *zclient, zebra_size_t length)
   /* Check interface routemap. */
   rip_if_rmap_update_interface (ifp);
 
+  /* Split horizon compares interface indexes. */
+  rip_output_reset ();
+
   return 0;
 }
 
@@ -491,7 +496,10 @@ rip_interface_delete (int command, struct zclient *zclient,
   
   /* To support pseudo interface do not free interface structure.  */
   /* if_delete(ifp); */
-  ifp->ifindex = IFINDEX_INTERNAL;
+  if_set_index (ifp, IFINDEX_INTERNAL);
+
+  /* Split horizon compares interface indexes. */
+  rip_output_reset ();
 
   return 0;
 }
@@ -750,6 +758,8 @@ rip_interface_address_delete (int command, struct zclient *zclient,
 
 	}
 
+      rip_output_delete (ifc);
+
       connected_free (ifc);
 
     }
@@ -1808,6 +1818,7 @@ DEFUN (ip_rip_split_horizon,
   ri = ifp->info;
 
   ri->split_horizon = RIP_SPLIT_HORIZON;
+  rip_output_reset ();
   return CMD_SUCCESS;
 }
 
@@ -1826,6 +1837,7 @@ DEFUN (ip_rip_split_horizon_poisoned_reverse,
   ri = ifp->info;
 
   ri->split_horizon = RIP_SPLIT_HORIZON_POISONED_REVERSE;
+  rip_output_reset ();
   return CMD_SUCCESS;
 }
 
@@ -1848,6 +1860,7 @@ DEFUN (no_ip_rip_split_horizon,
   ri = ifp->info;
 
   ri->split_horizon = RIP_NO_SPLIT_HORIZON;
+  rip_output_reset ();
   return CMD_SUCCESS;
 }
 
@@ -1873,6 +1886,7 @@ DEFUN (no_ip_rip_split_horizon_poisoned_reverse,
 	default:
 		break;
   }
+  rip_output_reset ();
 
   return CMD_SUCCESS;
 }
@@ -2071,6 +2085,8 @@ rip_interface_new_hook (struct interface *ifp)
 static int
 rip_interface_delete_hook (struct interface *ifp)
 {
+  rip_output_flush (ifp);
+  list_delete (((struct rip_interface *) ifp->info)->output);
   XFREE (MTYPE_RIP_INTERFACE, ifp->info);
   ifp->info = NULL;
   return 0;
@@ -142,6 +142,8 @@ rip_offset_list_set (struct vty *vty, const char *alist, const char *direct_str,
   offset->direct[direct].alist_name = strdup (alist);
   offset->direct[direct].metric = metric;
 
+  rip_output_reset ();
+
   return CMD_SUCCESS;
 }
 
@@ -196,6 +198,9 @@ rip_offset_list_unset (struct vty *vty, const char *alist,
       vty_out (vty, "Can't find offset-list%s", VTY_NEWLINE);
       return CMD_WARNING;
     }
+
+  rip_output_reset ();
+
   return CMD_SUCCESS;
 }
 
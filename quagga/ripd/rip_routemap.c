@@ -158,6 +158,7 @@ rip_route_map_update (const char *notused)
 	    rip->route_map[i].map = 
 	      route_map_lookup_by_name (rip->route_map[i].name);
 	}
+      rip_output_reset ();
     }
 }
 
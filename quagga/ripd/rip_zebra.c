@@ -159,6 +159,7 @@ rip_routemap_set (int type, const char *name)
 
   rip->route_map[type].name = strdup (name);
   rip->route_map[type].map = route_map_lookup_by_name (name);
+  rip_output_reset ();
 }
 
 static void
@@ -166,6 +167,7 @@ rip_redistribute_metric_set (int type, unsigned int metric)
 {
   rip->route_map[type].metric_config = 1;
   rip->route_map[type].metric = metric;
+  rip_output_reset ();
 }
 
 static int
@@ -177,6 +179,7 @@ rip_metric_unset (int type, unsigned int metric)
     return 1;
   rip->route_map[type].metric_config = 0;
   rip->route_map[type].metric = 0;
+  rip_output_reset ();
   return 0;
 }
 
@@ -191,6 +194,7 @@ rip_routemap_unset (int type, const char *name)
   free (rip->route_map[type].name);
   rip->route_map[type].name = NULL;
   rip->route_map[type].map = NULL;
+  rip_output_reset ();
 
   return 0;
 }
@@ -65,6 +65,8 @@ long rip_global_queries = 0;
 /* Prototypes. */
 static void rip_event (enum rip_event, int);
 static void rip_output_process (struct connected *, struct sockaddr_in *, int, u_char);
+static void rip_output_change (struct route_node *);
+static void rip_route_changed (struct rip_info *);
 static int rip_triggered_update (struct thread *);
 static int rip_update_jitter (unsigned long);
 
@@ -142,6 +144,7 @@ rip_garbage_collect (struct thread *t)
 
   /* Unlock route_node. */
   rp->info = NULL;
+  rip_output_change (rp);
   route_unlock_node (rp);
 
   /* Free RIP routing information. */
@@ -175,7 +178,7 @@ rip_timeout (struct thread *t)
 
   /* - The route change flag is to indicate that this entry has been
      changed. */
-  rinfo->flags |= RIP_RTF_CHANGED;
+  rip_route_changed (rinfo);
 
   /* - The output process is signalled to trigger a response. */
   rip_event (RIP_TRIGGERED_UPDATE, 0);
@@ -545,7 +548,7 @@ rip_rte_process (struct rte *rte, struct sockaddr_in *from,
           rip_timeout_update (rinfo);
 
           /* - Set the route change flag. */
-          rinfo->flags |= RIP_RTF_CHANGED;
+          rip_route_changed (rinfo);
 
           /* - Signal the output process to trigger an update (see section
              2.5). */
@@ -651,7 +654,7 @@ rip_rte_process (struct rte *rte, struct sockaddr_in *from,
 
           /* - Set the route change flag and signal the output process
              to trigger an update. */
-          rinfo->flags |= RIP_RTF_CHANGED;
+          rip_route_changed (rinfo);
           rip_event (RIP_TRIGGERED_UPDATE, 0);
 
           /* - If the new metric is infinity, start the deletion
@@ -1581,7 +1584,7 @@ rip_redistribute_add (int type, int sub_type, struct prefix_ipv4 *p,
   rinfo->flags |= RIP_RTF_FIB;
   rp->info = rinfo;
 
-  rinfo->flags |= RIP_RTF_CHANGED;
+  rip_route_changed (rinfo);
 
   if (IS_RIP_DEBUG_EVENT) {
     if (!nexthop)
@@ -1626,7 +1629,7 @@ rip_redistribute_delete (int type, int sub_type, struct prefix_ipv4 *p,
 	  RIP_TIMER_ON (rinfo->t_garbage_collect, 
 			rip_garbage_collect, rip->garbage_time);
 	  RIP_TIMER_OFF (rinfo->t_timeout);
-	  rinfo->flags |= RIP_RTF_CHANGED;
+	  rip_route_changed (rinfo);
 
           if (IS_RIP_DEBUG_EVENT)
             zlog_debug ("Poisone %s/%d on the interface %s with an infinity metric [delete]",
@@ -2097,37 +2100,455 @@ rip_read (struct thread *t)
   return len;
 }
 
-/* Write routing table entry to the stream and return next index of
-   the routing table entry in the stream. */
+/* Work out the RTE for the route at rp sent through ifc with version,
+   or return -1 if split horizon or the out filters suppress it. */
 static int
-rip_write_rte (int num, struct stream *s, struct prefix_ipv4 *p,
-               u_char version, struct rip_info *rinfo)
+rip_output_rte (struct connected *ifc, u_char version, struct route_node *rp,
+		struct rte *rte)
 {
+  int ret;
+  struct rip_info *rinfo;
+  struct rip_interface *ri;
+  struct prefix_ipv4 *p;
+  struct prefix_ipv4 classfull;
+  struct prefix_ipv4 ifaddrclass;
   struct in_addr mask;
 
-  /* Write routing table entry. */
+  if ((rinfo = rp->info) == NULL)
+    return -1;
+
+  ri = ifc->ifp->info;
+  p = (struct prefix_ipv4 *) &rp->p;
+
+  /* For RIPv1, if we are subnetted, output subnets in our network    */
+  /* that have the same mask as the output "interface". For other     */
+  /* networks, only the classfull version is output.                  */
   if (version == RIPv1)
     {
-      stream_putw (s, AF_INET);
-      stream_putw (s, 0);
-      stream_put_ipv4 (s, p->prefix.s_addr);
-      stream_put_ipv4 (s, 0);
-      stream_put_ipv4 (s, 0);
-      stream_putl (s, rinfo->metric_out);
+      memcpy (&ifaddrclass, ifc->address, sizeof (struct prefix_ipv4));
+      apply_classful_mask_ipv4 (&ifaddrclass);
+
+      if (IS_RIP_DEBUG_PACKET)
+	zlog_debug("RIPv1 mask check, %s/%d considered for output",
+		   inet_ntoa (rp->p.u.prefix4), rp->p.prefixlen);
+
+      if (ifc->address->prefixlen > ifaddrclass.prefixlen &&
+	  prefix_match ((struct prefix *) &ifaddrclass, &rp->p))
+	{
+	  if ((ifc->address->prefixlen != rp->p.prefixlen) &&
+	      (rp->p.prefixlen != 32))
+	    return -1;
+	}
+      else
+	{
+	  memcpy (&classfull, &rp->p, sizeof(struct prefix_ipv4));
+	  apply_classful_mask_ipv4(&classfull);
+	  if (rp->p.u.prefix4.s_addr != 0 &&
+	      classfull.prefixlen != rp->p.prefixlen)
+	    return -1;
+	}
+      if (IS_RIP_DEBUG_PACKET)
+	zlog_debug("RIPv1 mask check, %s/%d made it through",
+		   inet_ntoa (rp->p.u.prefix4), rp->p.prefixlen);
     }
-  else
+
+  /* Apply output filters. */
+  ret = rip_outgoing_filter (p, ri);
+  if (ret < 0)
+    return -1;
+
+  /* Split horizon. */
+  /* if (split_horizon == rip_split_horizon) */
+  if (ri->split_horizon == RIP_SPLIT_HORIZON)
+    {
+      /* 
+       * We perform split horizon for RIP and connected route. 
+       * For rip routes, we want to suppress the route if we would
+       * end up sending the route back on the interface that we
+       * learned it from, with a higher metric. For connected routes,
+       * we suppress the route if the prefix is a subset of the
+       * source address that we are going to use for the packet 
+       * (in order to handle the case when multiple subnets are
+       * configured on the same interface).
+       */
+      if (rinfo->type == ZEBRA_ROUTE_RIP  &&
+	  rinfo->ifindex == ifc->ifp->ifindex) 
+	return -1;
+      if (rinfo->type == ZEBRA_ROUTE_CONNECT &&
+	  prefix_match((struct prefix *)p, ifc->address))
+	return -1;
+    }
+
+  /* Preparation for route-map. */
+  rinfo->metric_set = 0;
+  rinfo->nexthop_out.s_addr = 0;
+  rinfo->metric_out = rinfo->metric;
+  rinfo->tag_out = rinfo->tag;
+  rinfo->ifindex_out = ifc->ifp->ifindex;
+
+  /* In order to avoid some local loops,
+   * if the RIP route has a nexthop via this interface, keep the nexthop,
+   * otherwise set it to 0. The nexthop should not be propagated
+   * beyond the local broadcast/multicast area in order
+   * to avoid an IGP multi-level recursive look-up.
+   * see (4.4)
+   */
+  if (rinfo->ifindex == ifc->ifp->ifindex)
+    rinfo->nexthop_out = rinfo->nexthop;
+
+  /* Interface route-map */
+  if (ri->routemap[RIP_FILTER_OUT])
+    {
+      ret = route_map_apply (ri->routemap[RIP_FILTER_OUT], 
+			     (struct prefix *) p, RMAP_RIP, 
+			     rinfo);
+
+      if (ret == RMAP_DENYMATCH)
+	{
+	  if (IS_RIP_DEBUG_PACKET)
+	    zlog_debug ("RIP %s/%d is filtered by route-map out",
+			inet_ntoa (p->prefix), p->prefixlen);
+	  return -1;
+	}
+    }
+           
+  /* Apply redistribute route map - continue, if deny */
+  if (rip->route_map[rinfo->type].name
+      && rinfo->sub_type != RIP_ROUTE_INTERFACE)
+    {
+      ret = route_map_apply (rip->route_map[rinfo->type].map,
+			     (struct prefix *)p, RMAP_RIP, rinfo);
+
+      if (ret == RMAP_DENYMATCH) 
+	{
+	  if (IS_RIP_DEBUG_PACKET)
+	    zlog_debug ("%s/%d is filtered by route-map",
+			inet_ntoa (p->prefix), p->prefixlen);
+	  return -1;
+	}
+    }
+
+  /* When route-map does not set metric. */
+  if (! rinfo->metric_set)
+    {
+      /* If redistribute metric is set. */
+      if (rip->route_map[rinfo->type].metric_config
+	  && rinfo->metric != RIP_METRIC_INFINITY)
+	{
+	  rinfo->metric_out = rip->route_map[rinfo->type].metric;
+	}
+      else
+	{
+	  /* If the route is not connected or localy generated
+	     one, use default-metric value*/
+	  if (rinfo->type != ZEBRA_ROUTE_RIP 
+	      && rinfo->type != ZEBRA_ROUTE_CONNECT
+	      && rinfo->metric != RIP_METRIC_INFINITY)
+	    rinfo->metric_out = rip->default_metric;
+	}
+    }
+
+  /* Apply offset-list */
+  if (rinfo->metric != RIP_METRIC_INFINITY)
+    rip_offset_list_apply_out (p, ifc->ifp, &rinfo->metric_out);
+
+  if (rinfo->metric_out > RIP_METRIC_INFINITY)
+    rinfo->metric_out = RIP_METRIC_INFINITY;
+
+  /* Perform split-horizon with poisoned reverse 
+   * for RIP and connected routes.
+   **/
+  if (ri->split_horizon == RIP_SPLIT_HORIZON_POISONED_REVERSE)
+    {
+      if (rinfo->type == ZEBRA_ROUTE_RIP  &&
+	  rinfo->ifindex == ifc->ifp->ifindex)
+	rinfo->metric_out = RIP_METRIC_INFINITY;
+      if (rinfo->type == ZEBRA_ROUTE_CONNECT &&
+	  prefix_match((struct prefix *)p, ifc->address))
+	rinfo->metric_out = RIP_METRIC_INFINITY;
+    }
+
+  /* Fill in the RTE as it goes on the wire. */
+  memset (rte, 0, sizeof (struct rte));
+  rte->family = htons (AF_INET);
+  rte->prefix = p->prefix;
+  rte->metric = htonl (rinfo->metric_out);
+  if (version != RIPv1)
     {
       masklen2ip (p->prefixlen, &mask);
+      rte->tag = htons (rinfo->tag_out);
+      rte->mask = mask;
+      rte->nexthop = rinfo->nexthop_out;
+    }
+  return 0;
+}
 
-      stream_putw (s, AF_INET);
-      stream_putw (s, rinfo->tag_out);
-      stream_put_ipv4 (s, p->prefix.s_addr);
-      stream_put_ipv4 (s, mask.s_addr);
-      stream_put_ipv4 (s, rinfo->nexthop_out.s_addr);
-      stream_putl (s, rinfo->metric_out);
+/* Record that the route at rp changed for the output sets and the
+   next triggered update. */
+static void
+rip_output_change (struct route_node *rp)
+{
+  struct route_node *rn;
+
+  rn = route_node_get (rip->changes, &rp->p);
+  if (rn->info)
+    route_unlock_node (rn);
+  else
+    rn->info = (void *) 1;
+  rip->output_seq++;
+}
+
+static void
+rip_route_changed (struct rip_info *rinfo)
+{
+  rinfo->flags |= RIP_RTF_CHANGED;
+  rip_output_change (rinfo->rp);
+}
+
+/* Forget all output sets' RTEs, they are recomputed from the routing
+   table when next used.  Called when configuration the output depends
+   on changes. */
+void
+rip_output_reset (void)
+{
+  if (rip)
+    rip->output_epoch++;
+}
+
+static void
+rip_output_clear (struct rip_output *set)
+{
+  struct route_node *rn;
+
+  for (rn = route_top (set->table); rn; rn = route_next (rn))
+    if (rn->info)
+      {
+	XFREE (MTYPE_RIP_OUTPUT, rn->info);
+	rn->info = NULL;
+	route_unlock_node (rn);
+      }
+  set->count = 0;
+  set->stale = 1;
+}
+
+static void
+rip_output_free (struct rip_output *set)
+{
+  rip_output_clear (set);
+  route_table_finish (set->table);
+  if (set->rtes)
+    XFREE (MTYPE_RIP_OUTPUT, set->rtes);
+  XFREE (MTYPE_RIP_OUTPUT, set);
+}
+
+/* Free the output sets of ifc, before the address goes. */
+void
+rip_output_delete (struct connected *ifc)
+{
+  struct rip_interface *ri = ifc->ifp->info;
+  struct listnode *node, *nnode;
+  struct rip_output *set;
+
+  for (ALL_LIST_ELEMENTS (ri->output, node, nnode, set))
+    if (set->ifc == ifc)
+      {
+	list_delete_node (ri->output, node);
+	rip_output_free (set);
+      }
+}
+
+/* Free all output sets of ifp. */
+void
+rip_output_flush (struct interface *ifp)
+{
+  struct rip_interface *ri = ifp->info;
+  struct rip_output *set;
+
+  while (listcount (ri->output))
+    {
+      set = listgetdata (listhead (ri->output));
+      list_delete_node (ri->output, listhead (ri->output));
+      rip_output_free (set);
     }
+}
 
-  return ++num;
+static struct rip_output *
+rip_output_get (struct connected *ifc, u_char version)
+{
+  struct rip_interface *ri = ifc->ifp->info;
+  struct listnode *node;
+  struct rip_output *set;
+
+  for (ALL_LIST_ELEMENTS_RO (ri->output, node, set))
+    if (set->ifc == ifc && set->version == version)
+      return set;
+
+  set = XCALLOC (MTYPE_RIP_OUTPUT, sizeof (struct rip_output));
+  set->ifc = ifc;
+  set->version = version;
+  set->table = route_table_init ();
+  set->epoch = rip->output_epoch - 1;
+  listnode_add (ri->output, set);
+  return set;
+}
+
+/* Set the RTE for prefix p in set, or remove it when rte is NULL. */
+static void
+rip_output_set (struct rip_output *set, struct prefix *p, struct rte *rte)
+{
+  struct route_node *rn;
+
+  if (rte == NULL)
+    {
+      rn = route_node_lookup (set->table, p);
+      if (rn)
+	{
+	  XFREE (MTYPE_RIP_OUTPUT, rn->info);
+	  rn->info = NULL;
+	  route_unlock_node (rn);
+	  route_unlock_node (rn);
+	  set->stale = 1;
+	}
+      return;
+    }
+
+  rn = route_node_get (set->table, p);
+  if (rn->info)
+    {
+      route_unlock_node (rn);
+      if (memcmp (rn->info, rte, sizeof (struct rte)) == 0)
+	return;
+    }
+  else
+    rn->info = XMALLOC (MTYPE_RIP_OUTPUT, sizeof (struct rte));
+  memcpy (rn->info, rte, sizeof (struct rte));
+  set->stale = 1;
+}
+
+/* Bring set up to date with the routing table: apply the changes
+   recorded since it was last used, or recompute every route if the
+   set was reset or missed an update. */
+static void
+rip_output_sync (struct rip_output *set)
+{
+  struct route_node *rp, *rn;
+  struct rte rte;
+
+  if (set->epoch != rip->output_epoch)
+    {
+      rip_output_clear (set);
+      for (rp = route_top (rip->table); rp; rp = route_next (rp))
+	if (rip_output_rte (set->ifc, set->version, rp, &rte) == 0)
+	  rip_output_set (set, &rp->p, &rte);
+    }
+  else if (set->seq != rip->output_seq)
+    for (rn = route_top (rip->changes); rn; rn = route_next (rn))
+      if (rn->info)
+	{
+	  rp = route_node_lookup (rip->table, &rn->p);
+	  if (rp && rip_output_rte (set->ifc, set->version, rp, &rte) == 0)
+	    rip_output_set (set, &rn->p, &rte);
+	  else
+	    rip_output_set (set, &rn->p, NULL);
+	  if (rp)
+	    route_unlock_node (rp);
+	}
+
+  set->epoch = rip->output_epoch;
+  set->seq = rip->output_seq;
+}
+
+/* Lay the RTEs of set out in table order. */
+static void
+rip_output_layout (struct rip_output *set)
+{
+  struct route_node *rn;
+  int count = 0;
+
+  for (rn = route_top (set->table); rn; rn = route_next (rn))
+    if (rn->info)
+      count++;
+
+  if (set->rtes)
+    XFREE (MTYPE_RIP_OUTPUT, set->rtes);
+  set->rtes = NULL;
+  if (count)
+    set->rtes = XMALLOC (MTYPE_RIP_OUTPUT, count * sizeof (struct rte));
+
+  set->count = 0;
+  for (rn = route_top (set->table); rn; rn = route_next (rn))
+    if (rn->info)
+      memcpy (&set->rtes[set->count++], rn->info, sizeof (struct rte));
+  set->stale = 0;
+}
+
+/* An update went out on every interface: clear the route change
+   flags, move the output sets that saw every change on to the next
+   epoch and start a new list of changes. */
+static void
+rip_output_commit (void)
+{
+  struct route_node *rn, *rp;
+  struct listnode *node, *snode;
+  struct interface *ifp;
+  struct rip_interface *ri;
+  struct rip_output *set;
+
+  for (rn = route_top (rip->changes); rn; rn = route_next (rn))
+    if (rn->info)
+      {
+	rp = route_node_lookup (rip->table, &rn->p);
+	if (rp)
+	  {
+	    ((struct rip_info *) rp->info)->flags &= ~RIP_RTF_CHANGED;
+	    route_unlock_node (rp);
+	  }
+	rn->info = NULL;
+	route_unlock_node (rn);
+      }
+
+  for (ALL_LIST_ELEMENTS_RO (iflist, node, ifp))
+    {
+      ri = ifp->info;
+      for (ALL_LIST_ELEMENTS_RO (ri->output, snode, set))
+	if (set->epoch == rip->output_epoch && set->seq == rip->output_seq)
+	  set->epoch++;
+    }
+  rip->output_epoch++;
+}
+
+/* Send count RTEs in one response, with the header and authentication
+   written for this packet. */
+static void
+rip_output_packet (struct connected *ifc, struct sockaddr_in *to,
+		   u_char version, struct key *key, char *auth_str,
+		   struct rte *rtes, int count)
+{
+  int ret;
+  struct stream *s = rip->obuf;
+  struct rip_interface *ri = ifc->ifp->info;
+  size_t doff = 0; /* offset of digest offset field */
+
+  stream_reset (s);
+  stream_putc (s, RIP_RESPONSE);
+  stream_putc (s, version);
+  stream_putw (s, 0);
+
+  /* auth header for !v1 && !no_auth */
+  if ( (ri->auth_type != RIP_NO_AUTH) && (version != RIPv1) )
+    doff = rip_auth_header_write (s, ri, key, auth_str, 
+				  RIP_AUTH_SIMPLE_SIZE);
+
+  stream_put (s, rtes, count * RIP_RTE_SIZE);
+
+  if (version == RIPv2 && ri->auth_type == RIP_AUTH_MD5)
+    rip_auth_md5_set (s, ri, doff, auth_str, RIP_AUTH_SIMPLE_SIZE);
+
+  ret = rip_send_packet (STREAM_DATA (s), stream_get_endp (s), to, ifc);
+
+  if (ret >= 0 && IS_RIP_DEBUG_SEND)
+    rip_packet_dump ((struct rip_packet *)STREAM_DATA (s),
+		     stream_get_endp (s), "SEND");
 }
 
 /* Send update to the ifp or spcified neighbor. */
@@ -2135,22 +2556,17 @@ void
 rip_output_process (struct connected *ifc, struct sockaddr_in *to, 
                     int route_type, u_char version)
 {
-  int ret;
-  struct stream *s;
-  struct route_node *rp;
-  struct rip_info *rinfo;
+  struct route_node *rn, *node;
   struct rip_interface *ri;
-  struct prefix_ipv4 *p;
-  struct prefix_ipv4 classfull;
-  struct prefix_ipv4 ifaddrclass;
+  struct rip_output *set;
   struct key *key = NULL;
   /* this might need to made dynamic if RIP ever supported auth methods
      with larger key string sizes */
   char auth_str[RIP_AUTH_SIMPLE_SIZE];
-  size_t doff = 0; /* offset of digest offset field */
+  struct rte rtes[(RIP_PACKET_MAXSIZ - 4) / RIP_RTE_SIZE];
   int num = 0;
   int rtemax;
-  int subnetted = 0;
+  int i;
 
   /* Logging output event. */
   if (IS_RIP_DEBUG_EVENT)
@@ -2162,12 +2578,7 @@ rip_output_process (struct connected *ifc, struct sockaddr_in *to,
 		   ifc->ifp->name, ifc->ifp->ifindex);
     }
 
-  /* Set output stream. */
-  s = rip->obuf;
-
-  /* Reset stream and RTE counter. */
-  stream_reset (s);
-  rtemax = (RIP_PACKET_MAXSIZ - 4) / 20;
+  rtemax = (RIP_PACKET_MAXSIZ - 4) / RIP_RTE_SIZE;
 
   /* Get RIP interface. */
   ri = ifc->ifp->info;
@@ -2198,226 +2609,39 @@ rip_output_process (struct connected *ifc, struct sockaddr_in *to,
       rip_auth_prepare_str_send (ri, key, auth_str, RIP_AUTH_SIMPLE_SIZE);
     }
 
-  if (version == RIPv1)
+  /* Bring the RTEs for this address and version up to date. */
+  set = rip_output_get (ifc, version);
+  rip_output_sync (set);
+
+  if (route_type == rip_all_route)
     {
-      memcpy (&ifaddrclass, ifc->address, sizeof (struct prefix_ipv4));
-      apply_classful_mask_ipv4 (&ifaddrclass);
-      subnetted = 0;
-      if (ifc->address->prefixlen > ifaddrclass.prefixlen)
-        subnetted = 1;
+      /* Send the RTEs as laid out, only the header and authentication
+	 differ between updates. */
+      if (set->stale)
+	rip_output_layout (set);
+
+      for (i = 0; i < set->count; i += rtemax)
+	rip_output_packet (ifc, to, version, key, auth_str, &set->rtes[i],
+			   MIN (rtemax, set->count - i));
     }
-
-  for (rp = route_top (rip->table); rp; rp = route_next (rp))
-    if ((rinfo = rp->info) != NULL)
-      {
-	/* For RIPv1, if we are subnetted, output subnets in our network    */
-	/* that have the same mask as the output "interface". For other     */
-	/* networks, only the classfull version is output.                  */
-	
-	if (version == RIPv1)
-	  {
-	    p = (struct prefix_ipv4 *) &rp->p;
-
-	    if (IS_RIP_DEBUG_PACKET)
-	      zlog_debug("RIPv1 mask check, %s/%d considered for output",
-			inet_ntoa (rp->p.u.prefix4), rp->p.prefixlen);
-
-	    if (subnetted &&
-		prefix_match ((struct prefix *) &ifaddrclass, &rp->p))
-	      {
-		if ((ifc->address->prefixlen != rp->p.prefixlen) &&
-		    (rp->p.prefixlen != 32))
-		  continue;
-	      }
-	    else
-	      {
-		memcpy (&classfull, &rp->p, sizeof(struct prefix_ipv4));
-		apply_classful_mask_ipv4(&classfull);
-		if (rp->p.u.prefix4.s_addr != 0 &&
-		    classfull.prefixlen != rp->p.prefixlen)
-		  continue;
-	      }
-	    if (IS_RIP_DEBUG_PACKET)
-	      zlog_debug("RIPv1 mask check, %s/%d made it through",
-			inet_ntoa (rp->p.u.prefix4), rp->p.prefixlen);
-	  }
-	else 
-	  p = (struct prefix_ipv4 *) &rp->p;
-
-	/* Apply output filters. */
-	ret = rip_outgoing_filter (p, ri);
-	if (ret < 0)
-	  continue;
-
-	/* Changed route only output. */
-	if (route_type == rip_changed_route &&
-	    (! (rinfo->flags & RIP_RTF_CHANGED)))
-	  continue;
-
-	/* Split horizon. */
-	/* if (split_horizon == rip_split_horizon) */
-	if (ri->split_horizon == RIP_SPLIT_HORIZON)
-	  {
-	    /* 
-	     * We perform split horizon for RIP and connected route. 
-	     * For rip routes, we want to suppress the route if we would
-             * end up sending the route back on the interface that we
-             * learned it from, with a higher metric. For connected routes,
-             * we suppress the route if the prefix is a subset of the
-             * source address that we are going to use for the packet 
-             * (in order to handle the case when multiple subnets are
-             * configured on the same interface).
-             */
-	    if (rinfo->type == ZEBRA_ROUTE_RIP  &&
-                 rinfo->ifindex == ifc->ifp->ifindex) 
-	      continue;
-	    if (rinfo->type == ZEBRA_ROUTE_CONNECT &&
-                 prefix_match((struct prefix *)p, ifc->address))
-	      continue;
-	  }
-
-	/* Preparation for route-map. */
-	rinfo->metric_set = 0;
-	rinfo->nexthop_out.s_addr = 0;
-	rinfo->metric_out = rinfo->metric;
-	rinfo->tag_out = rinfo->tag;
-	rinfo->ifindex_out = ifc->ifp->ifindex;
-
-	/* In order to avoid some local loops,
-	 * if the RIP route has a nexthop via this interface, keep the nexthop,
-	 * otherwise set it to 0. The nexthop should not be propagated
-	 * beyond the local broadcast/multicast area in order
-	 * to avoid an IGP multi-level recursive look-up.
-	 * see (4.4)
-	 */
-	if (rinfo->ifindex == ifc->ifp->ifindex)
-	  rinfo->nexthop_out = rinfo->nexthop;
-
-	/* Interface route-map */
-	if (ri->routemap[RIP_FILTER_OUT])
-	  {
-	    ret = route_map_apply (ri->routemap[RIP_FILTER_OUT], 
-				     (struct prefix *) p, RMAP_RIP, 
-				     rinfo);
-
-	    if (ret == RMAP_DENYMATCH)
-	      {
-	        if (IS_RIP_DEBUG_PACKET)
-	          zlog_debug ("RIP %s/%d is filtered by route-map out",
-			     inet_ntoa (p->prefix), p->prefixlen);
-		  continue;
-	      }
-	  }
-           
-	/* Apply redistribute route map - continue, if deny */
-	if (rip->route_map[rinfo->type].name
-	    && rinfo->sub_type != RIP_ROUTE_INTERFACE)
-	  {
-	    ret = route_map_apply (rip->route_map[rinfo->type].map,
-				   (struct prefix *)p, RMAP_RIP, rinfo);
-
-	    if (ret == RMAP_DENYMATCH) 
-	      {
-		if (IS_RIP_DEBUG_PACKET)
-		  zlog_debug ("%s/%d is filtered by route-map",
-			     inet_ntoa (p->prefix), p->prefixlen);
-		continue;
-	      }
-	  }
-
-	/* When route-map does not set metric. */
-	if (! rinfo->metric_set)
+  else
+    {
+      /* Changed route only output. */
+      for (rn = route_top (rip->changes); rn; rn = route_next (rn))
+	if (rn->info && (node = route_node_lookup (set->table, &rn->p)))
 	  {
-	    /* If redistribute metric is set. */
-	    if (rip->route_map[rinfo->type].metric_config
-		&& rinfo->metric != RIP_METRIC_INFINITY)
-	      {
-		rinfo->metric_out = rip->route_map[rinfo->type].metric;
-	      }
-	    else
+	    memcpy (&rtes[num++], node->info, sizeof (struct rte));
+	    route_unlock_node (node);
+	    if (num == rtemax)
 	      {
-		/* If the route is not connected or localy generated
-		   one, use default-metric value*/
-		if (rinfo->type != ZEBRA_ROUTE_RIP 
-		    && rinfo->type != ZEBRA_ROUTE_CONNECT
-		    && rinfo->metric != RIP_METRIC_INFINITY)
-		  rinfo->metric_out = rip->default_metric;
+		rip_output_packet (ifc, to, version, key, auth_str, rtes, num);
+		num = 0;
 	      }
 	  }
 
-	/* Apply offset-list */
-	if (rinfo->metric != RIP_METRIC_INFINITY)
-	  rip_offset_list_apply_out (p, ifc->ifp, &rinfo->metric_out);
-
-	if (rinfo->metric_out > RIP_METRIC_INFINITY)
-	  rinfo->metric_out = RIP_METRIC_INFINITY;
-
-	/* Perform split-horizon with poisoned reverse 
-	 * for RIP and connected routes.
-	 **/
-	if (ri->split_horizon == RIP_SPLIT_HORIZON_POISONED_REVERSE) {
-	    /* 
-	     * We perform split horizon for RIP and connected route. 
-	     * For rip routes, we want to suppress the route if we would
-             * end up sending the route back on the interface that we
-             * learned it from, with a higher metric. For connected routes,
-             * we suppress the route if the prefix is a subset of the
-             * source address that we are going to use for the packet 
-             * (in order to handle the case when multiple subnets are
-             * configured on the same interface).
-             */
-	  if (rinfo->type == ZEBRA_ROUTE_RIP  &&
-	       rinfo->ifindex == ifc->ifp->ifindex)
-	       rinfo->metric_out = RIP_METRIC_INFINITY;
-	  if (rinfo->type == ZEBRA_ROUTE_CONNECT &&
-              prefix_match((struct prefix *)p, ifc->address))
-	       rinfo->metric_out = RIP_METRIC_INFINITY;
-	}
-	
-	/* Prepare preamble, auth headers, if needs be */
-	if (num == 0)
-	  {
-	    stream_putc (s, RIP_RESPONSE);
-	    stream_putc (s, version);
-	    stream_putw (s, 0);
-	    
-	    /* auth header for !v1 && !no_auth */
-            if ( (ri->auth_type != RIP_NO_AUTH) && (version != RIPv1) )
-              doff = rip_auth_header_write (s, ri, key, auth_str, 
-                                              RIP_AUTH_SIMPLE_SIZE);
-          }
-        
-	/* Write RTE to the stream. */
-	num = rip_write_rte (num, s, p, version, rinfo);
-	if (num == rtemax)
-	  {
-	    if (version == RIPv2 && ri->auth_type == RIP_AUTH_MD5)
-              rip_auth_md5_set (s, ri, doff, auth_str, RIP_AUTH_SIMPLE_SIZE);
-
-	    ret = rip_send_packet (STREAM_DATA (s), stream_get_endp (s),
-				   to, ifc);
-
-	    if (ret >= 0 && IS_RIP_DEBUG_SEND)
-	      rip_packet_dump ((struct rip_packet *)STREAM_DATA (s),
-			       stream_get_endp(s), "SEND");
-	    num = 0;
-	    stream_reset (s);
-	  }
-      }
-
-  /* Flush unwritten RTE. */
-  if (num != 0)
-    {
-      if (version == RIPv2 && ri->auth_type == RIP_AUTH_MD5)
-        rip_auth_md5_set (s, ri, doff, auth_str, RIP_AUTH_SIMPLE_SIZE);
-
-      ret = rip_send_packet (STREAM_DATA (s), stream_get_endp (s), to, ifc);
-
-      if (ret >= 0 && IS_RIP_DEBUG_SEND)
-	rip_packet_dump ((struct rip_packet *)STREAM_DATA (s),
-			 stream_get_endp (s), "SEND");
-      num = 0;
-      stream_reset (s);
+      /* Flush unwritten RTE. */
+      if (num != 0)
+	rip_output_packet (ifc, to, version, key, auth_str, rtes, num);
     }
 
   /* Statistics updates. */
@@ -2571,6 +2795,10 @@ rip_update (struct thread *t)
   /* Process update output. */
   rip_update_process (rip_all_route);
 
+  /* Every route went out, a pending triggered update has nothing
+     left to send. */
+  rip_output_commit ();
+
   /* Triggered updates may be suppressed if a regular update is due by
      the time the triggered update would be sent. */
   if (rip->t_triggered_interval)
@@ -2586,19 +2814,6 @@ rip_update (struct thread *t)
   return 0;
 }
 
-/* Walk down the RIP routing table then clear changed flag. */
-static void
-rip_clear_changed_flag (void)
-{
-  struct route_node *rp;
-  struct rip_info *rinfo;
-
-  for (rp = route_top (rip->table); rp; rp = route_next (rp))
-    if ((rinfo = rp->info) != NULL)
-      if (rinfo->flags & RIP_RTF_CHANGED)
-	rinfo->flags &= ~RIP_RTF_CHANGED;
-}
-
 /* Triggered update interval timer. */
 static int
 rip_triggered_interval (struct thread *t)
@@ -2642,7 +2857,7 @@ rip_triggered_update (struct thread *t)
 
   /* Once all of the triggered updates have been generated, the route
      change flags should be cleared. */
-  rip_clear_changed_flag ();
+  rip_output_commit ();
 
   /* After a triggered update is sent, a timer should be set for a
    random interval between 1 and 5 seconds.  If other changes that
@@ -2677,7 +2892,7 @@ rip_redistribute_withdraw (int type)
 	    RIP_TIMER_ON (rinfo->t_garbage_collect, 
 			  rip_garbage_collect, rip->garbage_time);
 	    RIP_TIMER_OFF (rinfo->t_timeout);
-	    rinfo->flags |= RIP_RTF_CHANGED;
+	    rip_route_changed (rinfo);
 
 	    if (IS_RIP_DEBUG_EVENT) {
               struct prefix_ipv4 *p = (struct prefix_ipv4 *) &rp->p;
@@ -2711,6 +2926,8 @@ rip_create (void)
   rip->table = route_table_init ();
   rip->route = route_table_init ();
   rip->neighbor = route_table_init ();
+  rip->changes = route_table_init ();
+  rip->output_epoch = 1;
 
   /* Make output stream. */
   rip->obuf = stream_new (1500);
@@ -2999,6 +3216,7 @@ DEFUN (rip_default_metric,
     {
       rip->default_metric = atoi (argv[0]);
       /* rip_update_default_metric (); */
+      rip_output_reset ();
     }
   return CMD_SUCCESS;
 }
@@ -3014,6 +3232,7 @@ DEFUN (no_rip_default_metric,
     {
       rip->default_metric = RIP_DEFAULT_METRIC_DEFAULT;
       /* rip_update_default_metric (); */
+      rip_output_reset ();
     }
   return CMD_SUCCESS;
 }
@@ -3755,6 +3974,8 @@ rip_distribute_update (struct distribute *dist)
     }
   else
     ri->prefix[RIP_FILTER_OUT] = NULL;
+
+  rip_output_reset ();
 }
 
 void
@@ -3777,6 +3998,9 @@ rip_distribute_update_all (struct prefix_list *notused)
 
   for (ALL_LIST_ELEMENTS (iflist, node, nnode, ifp))
     rip_distribute_update_interface (ifp);
+
+  /* Offset lists and route-maps match on the lists too. */
+  rip_output_reset ();
 }
 /* ARGSUSED */
 static void
@@ -3792,6 +4016,8 @@ rip_clean (void)
   int i;
   struct route_node *rp;
   struct rip_info *rinfo;
+  struct listnode *node;
+  struct interface *ifp;
 
   if (rip)
     {
@@ -3856,6 +4082,11 @@ rip_clean (void)
 	if (rip->route_map[i].name)
 	  free (rip->route_map[i].name);
 
+      /* Output sets and pending changes. */
+      for (ALL_LIST_ELEMENTS_RO (iflist, node, ifp))
+	rip_output_flush (ifp);
+      route_table_finish (rip->changes);
+
       XFREE (MTYPE_ROUTE_TABLE, rip->table);
       XFREE (MTYPE_ROUTE_TABLE, rip->route);
       XFREE (MTYPE_ROUTE_TABLE, rip->neighbor);
@@ -3931,6 +4162,8 @@ rip_if_rmap_update (struct if_rmap *if_rmap)
     }
   else
     ri->routemap[RIP_FILTER_OUT] = NULL;
+
+  rip_output_reset ();
 }
 
 void
@@ -3970,6 +4203,15 @@ rip_routemap_update (const char *notused)
     rip_if_rmap_update_interface (ifp);
 
   rip_routemap_update_redistribute ();
+  rip_output_reset ();
+}
+
+/* A route-map rule changed, routes may be announced differently. */
+/* ARGSUSED */
+static void
+rip_routemap_event (route_map_event_t event, const char *notused)
+{
+  rip_output_reset ();
 }
 
 /* Allocate new rip structure and set default value. */
@@ -4038,6 +4280,7 @@ rip_init (void)
 
   route_map_add_hook (rip_routemap_update);
   route_map_delete_hook (rip_routemap_update);
+  route_map_event_hook (rip_routemap_event);
 
   if_rmap_init (RIP_NODE);
   if_rmap_hook_add (rip_if_rmap_update);
@@ -151,6 +151,12 @@ struct rip
     int metric_config;
     u_int32_t metric;
   } route_map[ZEBRA_ROUTE_MAX];
+
+  /* Prefixes changed since the last update, not yet applied to every
+     output set, and the counters output sets are checked against. */
+  struct route_table *changes;
+  unsigned long output_epoch;
+  unsigned long output_seq;
 };
 
 /* RIP routing table entry which belong to rip_packet. */
@@ -293,6 +299,28 @@ struct rip_interface
 
   /* Passive interface. */
   int passive;
+
+  /* Output sets of the connected addresses. */
+  struct list *output;
+};
+
+/* RTEs sent through one connected address with one RIP version, by
+   prefix, after split horizon, out filters, route-maps and offset
+   lists.  Kept in step with the routing table by applying
+   rip->changes; rtes holds them in table order for periodic
+   updates. */
+struct rip_output
+{
+  struct connected *ifc;
+  u_char version;
+
+  struct route_table *table;
+  unsigned long epoch;
+  unsigned long seq;
+
+  struct rte *rtes;
+  int count;
+  int stale;
 };
 
 /* RIP peer information. */
@@ -426,6 +454,9 @@ extern u_char rip_distance_apply (struct rip_info *);
 extern void rip_redistribute_clean (void);
 extern void rip_ifaddr_add (struct interface *, struct connected *);
 extern void rip_ifaddr_delete (struct interface *, struct connected *);
+extern void rip_output_reset (void);
+extern void rip_output_delete (struct connected *);
+extern void rip_output_flush (struct interface *);
 
 /* There is only one rip strucutre. */
 extern struct rip *rip;
@@ -303,6 +303,8 @@ ripng_interface_add (int command, struct zclient *zclient, zebra_size_t length)
   /* Check interface routemap. */
   ripng_if_rmap_update_interface (ifp);
 
+  ripng_output_reset ();
+
   return 0;
 }
 
@@ -329,7 +331,10 @@ ripng_interface_delete (int command, struct zclient *zclient,
 
   /* To support pseudo interface do not free interface structure.  */
   /* if_delete(ifp); */
-  ifp->ifindex = IFINDEX_INTERNAL;
+  if_set_index (ifp, IFINDEX_INTERNAL);
+
+  /* Split horizon compares interface indexes. */
+  ripng_output_reset ();
 
   return 0;
 }
@@ -1050,6 +1055,7 @@ DEFUN (ipv6_ripng_split_horizon,
   ri = ifp->info;
 
   ri->split_horizon = RIPNG_SPLIT_HORIZON;
+  ripng_output_reset ();
   return CMD_SUCCESS;
 }
 
@@ -1068,6 +1074,7 @@ DEFUN (ipv6_ripng_split_horizon_poisoned_reverse,
   ri = ifp->info;
 
   ri->split_horizon = RIPNG_SPLIT_HORIZON_POISONED_REVERSE;
+  ripng_output_reset ();
   return CMD_SUCCESS;
 }
 
@@ -1086,6 +1093,7 @@ DEFUN (no_ipv6_ripng_split_horizon,
   ri = ifp->info;
 
   ri->split_horizon = RIPNG_NO_SPLIT_HORIZON;
+  ripng_output_reset ();
   return CMD_SUCCESS;
 }
 
@@ -1144,6 +1152,10 @@ ripng_if_new_hook (struct interface *ifp)
 int
 ripng_if_delete_hook (struct interface *ifp)
 {
+  struct ripng_interface *ri = ifp->info;
+
+  if (ri->output)
+    ripng_output_free (ri->output);
   XFREE (MTYPE_IF, ifp->info);
   ifp->info = NULL;
   return 0;
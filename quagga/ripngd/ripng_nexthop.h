@@ -40,7 +40,7 @@ void ripng_rte_send(struct list *ripng_rte_list, struct interface *ifp,
  * -1 if A < B
  **/
 static inline int
-addr6_cmp(struct in6_addr *A, struct in6_addr *B) {
+addr6_cmp(const struct in6_addr *A, const struct in6_addr *B) {
 
 #ifndef s6_addr32
 #if defined(SUNOS_5)
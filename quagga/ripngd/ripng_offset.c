@@ -32,6 +32,8 @@
 #include "linklist.h"
 #include "memory.h"
 
+#include "ripngd/ripngd.h"
+
 #define RIPNG_OFFSET_LIST_IN  0
 #define RIPNG_OFFSET_LIST_OUT 1
 #define RIPNG_OFFSET_LIST_MAX 2
@@ -144,6 +146,8 @@ ripng_offset_list_set (struct vty *vty, const char *alist,
   offset->direct[direct].alist_name = strdup (alist);
   offset->direct[direct].metric = metric;
 
+  ripng_output_reset ();
+
   return CMD_SUCCESS;
 }
 
@@ -198,6 +202,8 @@ ripng_offset_list_unset (struct vty *vty, const char *alist,
       vty_out (vty, "Can't find offset-list%s", VTY_NEWLINE);
       return CMD_WARNING;
     }
+
+  ripng_output_reset ();
   return CMD_SUCCESS;
 }
 
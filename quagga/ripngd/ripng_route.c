@@ -58,6 +58,7 @@ ripng_aggregate_increment (struct route_node *child, struct ripng_info *rinfo)
       {
 	aggregate->count++;
 	rinfo->suppress++;
+	ripng_output_change (np);
       }
 }
 
@@ -73,6 +74,7 @@ ripng_aggregate_decrement (struct route_node *child, struct ripng_info *rinfo)
       {
 	aggregate->count--;
 	rinfo->suppress--;
+	ripng_output_change (np);
       }
 }
 
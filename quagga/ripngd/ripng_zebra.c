@@ -175,6 +175,7 @@ ripng_redistribute_metric_set (int type, int metric)
 {
   ripng->route_map[type].metric_config = 1;
   ripng->route_map[type].metric = metric;
+  ripng_output_reset ();
 }
 
 int
@@ -182,6 +183,7 @@ ripng_redistribute_metric_unset (int type)
 {
   ripng->route_map[type].metric_config = 0;
   ripng->route_map[type].metric = 0;
+  ripng_output_reset ();
   return 0;
 }
 
@@ -193,6 +195,7 @@ ripng_redistribute_routemap_set (int type, const char *name)
 
   ripng->route_map[type].name = strdup (name);
   ripng->route_map[type].map = route_map_lookup_by_name (name);
+  ripng_output_reset ();
 }
 
 void
@@ -203,6 +206,7 @@ ripng_redistribute_routemap_unset (int type)
 
   ripng->route_map[type].name = NULL;
   ripng->route_map[type].map = NULL;
+  ripng_output_reset ();
 }
 
 /* Redistribution types */
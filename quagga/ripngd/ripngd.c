@@ -21,6 +21,8 @@
 
 #include <zebra.h>
 
+#include <netinet/udp.h>
+
 #include "prefix.h"
 #include "filter.h"
 #include "log.h"
@@ -62,6 +64,9 @@ ripng_output_process (struct interface *, struct sockaddr_in6 *, int);
 int
 ripng_triggered_update (struct thread *);
 
+static void ripng_route_changed (struct ripng_info *);
+static void ripng_output_commit (void);
+
 /* RIPng next hop specification. */
 struct ripng_nexthop
 {
@@ -414,6 +419,7 @@ ripng_garbage_collect (struct thread *t)
 
   /* Unlock route_node. */
   rp->info = NULL;
+  ripng_output_change (rp);
   route_unlock_node (rp);
 
   /* Free RIPng routing information. */
@@ -452,7 +458,7 @@ ripng_timeout (struct thread *t)
 
   /* - The route change flag is to indicate that this entry has been
      changed. */
-  rinfo->flags |= RIPNG_RTF_CHANGED;
+  ripng_route_changed (rinfo);
 
   /* - The output process is signalled to trigger a response. */
   ripng_event (RIPNG_TRIGGERED_UPDATE, 0);
@@ -773,7 +779,7 @@ ripng_route_process (struct rte *rte, struct sockaddr_in6 *from,
 	  ripng_timeout_update (rinfo);
 
 	  /* - Set the route change flag. */
-	  rinfo->flags |= RIPNG_RTF_CHANGED;
+	  ripng_route_changed (rinfo);
 
 	  /* - Signal the output process to trigger an update (see section
 	     2.5). */
@@ -860,7 +866,7 @@ ripng_route_process (struct rte *rte, struct sockaddr_in6 *from,
 
 	  /* - Set the route change flag and signal the output process
 	     to trigger an update. */
-	  rinfo->flags |= RIPNG_RTF_CHANGED;
+	  ripng_route_changed (rinfo);
 	  ripng_event (RIPNG_TRIGGERED_UPDATE, 0);
 
 	  /* - If the new metric is infinity, start the deletion
@@ -989,7 +995,7 @@ ripng_redistribute_add (int type, int sub_type, struct prefix_ipv6 *p,
   /* Aggregate check. */
   ripng_aggregate_increment (rp, rinfo);
 
-  rinfo->flags |= RIPNG_RTF_CHANGED;
+  ripng_route_changed (rinfo);
 
   if (IS_RIPNG_DEBUG_EVENT) {
     if (!nexthop)
@@ -1047,7 +1053,7 @@ ripng_redistribute_delete (int type, int sub_type, struct prefix_ipv6 *p,
 	  /* Aggregate count decrement. */
 	  ripng_aggregate_decrement (rp, rinfo);
 
-	  rinfo->flags |= RIPNG_RTF_CHANGED;
+	  ripng_route_changed (rinfo);
 	  
           if (IS_RIPNG_DEBUG_EVENT)
             zlog_debug ("Poisone %s/%d on the interface %s with an infinity metric [delete]",
@@ -1084,7 +1090,7 @@ ripng_redistribute_withdraw (int type)
 	    /* Aggregate count decrement. */
 	    ripng_aggregate_decrement (rp, rinfo);
 
-	    rinfo->flags |= RIPNG_RTF_CHANGED;
+	    ripng_route_changed (rinfo);
 
 	    if (IS_RIPNG_DEBUG_EVENT) {
 	      struct prefix_ipv6 *p = (struct prefix_ipv6 *) &rp->p;
@@ -1409,19 +1415,6 @@ ripng_read (struct thread *thread)
   return 0;
 }
 
-/* Walk down the RIPng routing table then clear changed flag. */
-void
-ripng_clear_changed_flag ()
-{
-  struct route_node *rp;
-  struct ripng_info *rinfo;
-
-  for (rp = route_top (ripng->table); rp; rp = route_next (rp))
-    if ((rinfo = rp->info) != NULL)
-      if (rinfo->flags & RIPNG_RTF_CHANGED)
-	rinfo->flags &= ~RIPNG_RTF_CHANGED;
-}
-
 /* Regular update of RIPng route.  Send all routing formation to RIPng
    enabled interface. */
 int
@@ -1468,6 +1461,10 @@ ripng_update (struct thread *t)
       ripng_output_process (ifp, NULL, ripng_all_route);
     }
 
+  /* Every route went out, a pending triggered update has nothing
+     left to send. */
+  ripng_output_commit ();
+
   /* Triggered updates may be suppressed if a regular update is due by
      the time the triggered update would be sent. */
   if (ripng->t_triggered_interval)
@@ -1542,7 +1539,7 @@ ripng_triggered_update (struct thread *t)
 
   /* Once all of the triggered updates have been generated, the route
      change flags should be cleared. */
-  ripng_clear_changed_flag ();
+  ripng_output_commit ();
 
   /* After a triggered update is sent, a timer should be set for a
      random interval between 1 and 5 seconds.  If other changes that
@@ -1585,231 +1582,633 @@ ripng_write_rte (int num, struct stream *s, struct prefix_ipv6 *p,
   return ++num;
 }
 
-/* Send RESPONSE message to specified destination. */
-void
-ripng_output_process (struct interface *ifp, struct sockaddr_in6 *to,
-		      int route_type)
+/* Fill in out as the RTE for p sent under nexthop. */
+static void
+ripng_output_rte_fill (struct ripng_output_rte *out, struct prefix_ipv6 *p,
+		       struct in6_addr *nexthop, u_int16_t tag, u_char metric)
+{
+  out->valid = 1;
+  out->nexthop = *nexthop;
+  out->rte.addr = p->prefix;
+  out->rte.tag = htons (tag);
+  out->rte.prefixlen = p->prefixlen;
+  out->rte.metric = metric;
+}
+
+/* Work out the RTEs the prefix at rp contributes through ifp: rte[0]
+   for its route and rte[1] for the aggregate configured there. */
+static void
+ripng_output_rte (struct interface *ifp, struct route_node *rp,
+		  struct ripng_output_rte *rte)
 {
   int ret;
-  struct route_node *rp;
   struct ripng_info *rinfo;
   struct ripng_interface *ri;
   struct ripng_aggregate *aggregate;
   struct prefix_ipv6 *p;
-  struct list * ripng_rte_list;
-
-  if (IS_RIPNG_DEBUG_EVENT) {
-    if (to)
-      zlog_debug ("RIPng update routes to neighbor %s",
-                 inet6_ntoa(to->sin6_addr));
-    else
-      zlog_debug ("RIPng update routes on interface %s", ifp->name);
-  }
 
   /* Get RIPng interface. */
   ri = ifp->info;
- 
-  ripng_rte_list = ripng_rte_new();
- 
-  for (rp = route_top (ripng->table); rp; rp = route_next (rp))
-    {
-      if ((rinfo = rp->info) != NULL && rinfo->suppress == 0)
-	{
-	  /* If no route-map are applied, the RTE will be these following
-	   * informations.
-	   */
-	  p = (struct prefix_ipv6 *) &rp->p;
-	  rinfo->metric_out = rinfo->metric;
-	  rinfo->tag_out    = rinfo->tag;
-	  memset(&rinfo->nexthop_out, 0, sizeof(rinfo->nexthop_out));
-	  /* In order to avoid some local loops,
-	   * if the RIPng route has a nexthop via this interface, keep the nexthop,
-	   * otherwise set it to 0. The nexthop should not be propagated
-	   * beyond the local broadcast/multicast area in order
-	   * to avoid an IGP multi-level recursive look-up.
-	   */
-	  if (rinfo->ifindex == ifp->ifindex)
-	    rinfo->nexthop_out = rinfo->nexthop;
-
-	  /* Apply output filters. */
-	  ret = ripng_outgoing_filter (p, ri);
-	  if (ret < 0)
-	    continue;
-
-	  /* Changed route only output. */
-	  if (route_type == ripng_changed_route &&
-	      (! (rinfo->flags & RIPNG_RTF_CHANGED)))
-	    continue;
-
-	  /* Split horizon. */
-	  if (ri->split_horizon == RIPNG_SPLIT_HORIZON)
-	  {
-	    /* We perform split horizon for RIPng routes. */
-	    if ((rinfo->type == ZEBRA_ROUTE_RIPNG) &&
-		rinfo->ifindex == ifp->ifindex)
-	      continue;
-	  }
 
-	  /* Preparation for route-map. */
-	  rinfo->metric_set = 0;
-	  /* nexthop_out,
-	   * metric_out
-	   * and tag_out are already initialized.
-	   */
+  memset (rte, 0, 2 * sizeof (struct ripng_output_rte));
+
+  if ((rinfo = rp->info) != NULL && rinfo->suppress == 0)
+    {
+      /* If no route-map are applied, the RTE will be these following
+       * informations.
+       */
+      p = (struct prefix_ipv6 *) &rp->p;
+      rinfo->metric_out = rinfo->metric;
+      rinfo->tag_out    = rinfo->tag;
+      memset(&rinfo->nexthop_out, 0, sizeof(rinfo->nexthop_out));
+      /* In order to avoid some local loops,
+       * if the RIPng route has a nexthop via this interface, keep the nexthop,
+       * otherwise set it to 0. The nexthop should not be propagated
+       * beyond the local broadcast/multicast area in order
+       * to avoid an IGP multi-level recursive look-up.
+       */
+      if (rinfo->ifindex == ifp->ifindex)
+	rinfo->nexthop_out = rinfo->nexthop;
+
+      /* Apply output filters. */
+      ret = ripng_outgoing_filter (p, ri);
+      if (ret < 0)
+	return;
 
-	  /* Interface route-map */
-	  if (ri->routemap[RIPNG_FILTER_OUT])
-	    {
-	      int ret;
+      /* Split horizon. */
+      if (ri->split_horizon == RIPNG_SPLIT_HORIZON)
+      {
+	/* We perform split horizon for RIPng routes. */
+	if ((rinfo->type == ZEBRA_ROUTE_RIPNG) &&
+	    rinfo->ifindex == ifp->ifindex)
+	  return;
+      }
 
-	      ret = route_map_apply (ri->routemap[RIPNG_FILTER_OUT], 
-				     (struct prefix *) p, RMAP_RIPNG, 
-				     rinfo);
+      /* Preparation for route-map. */
+      rinfo->metric_set = 0;
+      /* nexthop_out,
+       * metric_out
+       * and tag_out are already initialized.
+       */
 
-	      if (ret == RMAP_DENYMATCH)
-		{
-		  if (IS_RIPNG_DEBUG_PACKET)
-		    zlog_debug ("RIPng %s/%d is filtered by route-map out",
-			       inet6_ntoa (p->prefix), p->prefixlen);
-		  continue;
-		}
+      /* Interface route-map */
+      if (ri->routemap[RIPNG_FILTER_OUT])
+	{
+	  ret = route_map_apply (ri->routemap[RIPNG_FILTER_OUT], 
+				 (struct prefix *) p, RMAP_RIPNG, 
+				 rinfo);
 
+	  if (ret == RMAP_DENYMATCH)
+	    {
+	      if (IS_RIPNG_DEBUG_PACKET)
+		zlog_debug ("RIPng %s/%d is filtered by route-map out",
+			   inet6_ntoa (p->prefix), p->prefixlen);
+	      return;
 	    }
 
-	  /* Redistribute route-map. */
-	  if (ripng->route_map[rinfo->type].name)
-	    {
-	      int ret;
+	}
 
-	      ret = route_map_apply (ripng->route_map[rinfo->type].map,
-				     (struct prefix *) p, RMAP_RIPNG,
-				     rinfo);
+      /* Redistribute route-map. */
+      if (ripng->route_map[rinfo->type].name)
+	{
+	  ret = route_map_apply (ripng->route_map[rinfo->type].map,
+				 (struct prefix *) p, RMAP_RIPNG,
+				 rinfo);
 
-	      if (ret == RMAP_DENYMATCH)
-		{
-		  if (IS_RIPNG_DEBUG_PACKET)
-		    zlog_debug ("RIPng %s/%d is filtered by route-map",
-			       inet6_ntoa (p->prefix), p->prefixlen);
-		  continue;
-		}
+	  if (ret == RMAP_DENYMATCH)
+	    {
+	      if (IS_RIPNG_DEBUG_PACKET)
+		zlog_debug ("RIPng %s/%d is filtered by route-map",
+			   inet6_ntoa (p->prefix), p->prefixlen);
+	      return;
 	    }
+	}
 
-	  /* When the route-map does not set metric. */
-	  if (! rinfo->metric_set)
+      /* When the route-map does not set metric. */
+      if (! rinfo->metric_set)
+	{
+	  /* If the redistribute metric is set. */
+	  if (ripng->route_map[rinfo->type].metric_config
+	      && rinfo->metric != RIPNG_METRIC_INFINITY)
+	    {
+	      rinfo->metric_out = ripng->route_map[rinfo->type].metric;
+	    }
+	  else
 	    {
-	      /* If the redistribute metric is set. */
-	      if (ripng->route_map[rinfo->type].metric_config
+	      /* If the route is not connected or localy generated
+		 one, use default-metric value */
+	      if (rinfo->type != ZEBRA_ROUTE_RIPNG
+		  && rinfo->type != ZEBRA_ROUTE_CONNECT
 		  && rinfo->metric != RIPNG_METRIC_INFINITY)
-		{
-		  rinfo->metric_out = ripng->route_map[rinfo->type].metric;
-		}
-	      else
-		{
-		  /* If the route is not connected or localy generated
-		     one, use default-metric value */
-		  if (rinfo->type != ZEBRA_ROUTE_RIPNG
-		      && rinfo->type != ZEBRA_ROUTE_CONNECT
-		      && rinfo->metric != RIPNG_METRIC_INFINITY)
-		    rinfo->metric_out = ripng->default_metric;
-		}
+		rinfo->metric_out = ripng->default_metric;
 	    }
+	}
 
-          /* Apply offset-list */
-	  if (rinfo->metric_out != RIPNG_METRIC_INFINITY)
-            ripng_offset_list_apply_out (p, ifp, &rinfo->metric_out);
+      /* Apply offset-list */
+      if (rinfo->metric_out != RIPNG_METRIC_INFINITY)
+        ripng_offset_list_apply_out (p, ifp, &rinfo->metric_out);
 
-          if (rinfo->metric_out > RIPNG_METRIC_INFINITY)
-            rinfo->metric_out = RIPNG_METRIC_INFINITY;
+      if (rinfo->metric_out > RIPNG_METRIC_INFINITY)
+        rinfo->metric_out = RIPNG_METRIC_INFINITY;
 
-	  /* Perform split-horizon with poisoned reverse 
-	   * for RIPng routes.
-	   **/
-	  if (ri->split_horizon == RIPNG_SPLIT_HORIZON_POISONED_REVERSE) {
-	    if ((rinfo->type == ZEBRA_ROUTE_RIPNG) &&
-	         rinfo->ifindex == ifp->ifindex)
-	         rinfo->metric_out = RIPNG_METRIC_INFINITY;
-	  }
+      /* Perform split-horizon with poisoned reverse 
+       * for RIPng routes.
+       **/
+      if (ri->split_horizon == RIPNG_SPLIT_HORIZON_POISONED_REVERSE) {
+	if ((rinfo->type == ZEBRA_ROUTE_RIPNG) &&
+	     rinfo->ifindex == ifp->ifindex)
+	     rinfo->metric_out = RIPNG_METRIC_INFINITY;
+      }
 
-	  /* Add RTE to the list */
-	  ripng_rte_add(ripng_rte_list, p, rinfo, NULL);
-	}
+      ripng_output_rte_fill (&rte[0], p, &rinfo->nexthop_out,
+			     rinfo->tag_out, rinfo->metric_out);
+    }
+
+  /* Process the aggregated RTE entry */
+  if ((aggregate = rp->aggregate) != NULL && 
+      aggregate->count > 0 && 
+      aggregate->suppress == 0)
+    {
+      /* If no route-map are applied, the RTE will be these following
+       * informations.
+       */
+      p = (struct prefix_ipv6 *) &rp->p;
+      aggregate->metric_set = 0;
+      aggregate->metric_out = aggregate->metric;
+      aggregate->tag_out    = aggregate->tag;
+      memset(&aggregate->nexthop_out, 0, sizeof(aggregate->nexthop_out));
 
-      /* Process the aggregated RTE entry */
-      if ((aggregate = rp->aggregate) != NULL && 
-	  aggregate->count > 0 && 
-	  aggregate->suppress == 0)
+      /* Apply output filters.*/
+      ret = ripng_outgoing_filter (p, ri);
+      if (ret < 0)
+	return;
+
+      /* Interface route-map */
+      if (ri->routemap[RIPNG_FILTER_OUT])
 	{
-	  /* If no route-map are applied, the RTE will be these following
-	   * informations.
-	   */
-	  p = (struct prefix_ipv6 *) &rp->p;
-	  aggregate->metric_set = 0;
-	  aggregate->metric_out = aggregate->metric;
-	  aggregate->tag_out    = aggregate->tag;
-	  memset(&aggregate->nexthop_out, 0, sizeof(aggregate->nexthop_out));
-
-	  /* Apply output filters.*/
-	  ret = ripng_outgoing_filter (p, ri);
-	  if (ret < 0)
-	    continue;
-
-	  /* Interface route-map */
-	  if (ri->routemap[RIPNG_FILTER_OUT])
-	    {
-	      int ret;
-	      struct ripng_info newinfo;
-
-	      /* let's cast the aggregate structure to ripng_info */
-	      memset (&newinfo, 0, sizeof (struct ripng_info));
-	      /* the nexthop is :: */
-	      newinfo.metric = aggregate->metric;
-	      newinfo.metric_out = aggregate->metric_out;
-	      newinfo.tag = aggregate->tag;
-	      newinfo.tag_out = aggregate->tag_out;
-
-	      ret = route_map_apply (ri->routemap[RIPNG_FILTER_OUT], 
-				     (struct prefix *) p, RMAP_RIPNG, 
-				     &newinfo);
-
-	      if (ret == RMAP_DENYMATCH)
-		{
-		  if (IS_RIPNG_DEBUG_PACKET)
-		    zlog_debug ("RIPng %s/%d is filtered by route-map out",
-			       inet6_ntoa (p->prefix), p->prefixlen);
-		  continue;
-		}
+	  struct ripng_info newinfo;
+
+	  /* let's cast the aggregate structure to ripng_info */
+	  memset (&newinfo, 0, sizeof (struct ripng_info));
+	  /* the nexthop is :: */
+	  newinfo.metric = aggregate->metric;
+	  newinfo.metric_out = aggregate->metric_out;
+	  newinfo.tag = aggregate->tag;
+	  newinfo.tag_out = aggregate->tag_out;
+
+	  ret = route_map_apply (ri->routemap[RIPNG_FILTER_OUT], 
+				 (struct prefix *) p, RMAP_RIPNG, 
+				 &newinfo);
 
-	      aggregate->metric_out = newinfo.metric_out;
-	      aggregate->tag_out = newinfo.tag_out;
-	      if (IN6_IS_ADDR_LINKLOCAL(&newinfo.nexthop_out))
-		aggregate->nexthop_out = newinfo.nexthop_out;
+	  if (ret == RMAP_DENYMATCH)
+	    {
+	      if (IS_RIPNG_DEBUG_PACKET)
+		zlog_debug ("RIPng %s/%d is filtered by route-map out",
+			   inet6_ntoa (p->prefix), p->prefixlen);
+	      return;
 	    }
 
-	  /* There is no redistribute routemap for the aggregated RTE */
+	  aggregate->metric_out = newinfo.metric_out;
+	  aggregate->tag_out = newinfo.tag_out;
+	  if (IN6_IS_ADDR_LINKLOCAL(&newinfo.nexthop_out))
+	    aggregate->nexthop_out = newinfo.nexthop_out;
+	}
+
+      /* There is no redistribute routemap for the aggregated RTE */
+
+      /* Apply offset-list */
+      if (aggregate->metric_out != RIPNG_METRIC_INFINITY)
+	ripng_offset_list_apply_out (p, ifp, &aggregate->metric_out);
+
+      if (aggregate->metric_out > RIPNG_METRIC_INFINITY)
+	aggregate->metric_out = RIPNG_METRIC_INFINITY;
+
+      ripng_output_rte_fill (&rte[1], p, &aggregate->nexthop_out,
+			     aggregate->tag_out, aggregate->metric_out);
+    }
+}
+
+/* Record that the route or aggregate at rp changed for the output sets
+   and the next triggered update. */
+void
+ripng_output_change (struct route_node *rp)
+{
+  struct route_node *rn;
+
+  rn = route_node_get (ripng->changes, &rp->p);
+  if (rn->info)
+    route_unlock_node (rn);
+  else
+    rn->info = (void *) 1;
+  ripng->output_seq++;
+}
+
+static void
+ripng_route_changed (struct ripng_info *rinfo)
+{
+  rinfo->flags |= RIPNG_RTF_CHANGED;
+  ripng_output_change (rinfo->rp);
+}
+
+/* Forget all output sets' RTEs, they are recomputed from the routing
+   table when next used.  Called when configuration the output depends
+   on changes. */
+void
+ripng_output_reset (void)
+{
+  if (ripng)
+    ripng->output_epoch++;
+}
+
+static void
+ripng_output_clear (struct ripng_output *set)
+{
+  struct route_node *rn;
+
+  for (rn = route_top (set->table); rn; rn = route_next (rn))
+    if (rn->info)
+      {
+	XFREE (MTYPE_RIPNG_OUTPUT, rn->info);
+	rn->info = NULL;
+	route_unlock_node (rn);
+      }
+  set->stale = 1;
+}
+
+static void
+ripng_output_packets_free (struct ripng_output *set)
+{
+  if (set->packets)
+    XFREE (MTYPE_RIPNG_OUTPUT, set->packets);
+  if (set->packet_size)
+    XFREE (MTYPE_RIPNG_OUTPUT, set->packet_size);
+  set->packets = NULL;
+  set->packet_size = NULL;
+  set->packet_count = 0;
+}
+
+void
+ripng_output_free (struct ripng_output *set)
+{
+  ripng_output_clear (set);
+  route_table_finish (set->table);
+  ripng_output_packets_free (set);
+  XFREE (MTYPE_RIPNG_OUTPUT, set);
+}
+
+static struct ripng_output *
+ripng_output_get (struct interface *ifp)
+{
+  struct ripng_interface *ri = ifp->info;
+
+  if (ri->output == NULL)
+    {
+      ri->output = XCALLOC (MTYPE_RIPNG_OUTPUT, sizeof (struct ripng_output));
+      ri->output->table = route_table_init ();
+      ri->output->epoch = ripng->output_epoch - 1;
+    }
+  return ri->output;
+}
+
+/* Set the RTEs for prefix p in set, or remove them when none is valid. */
+static void
+ripng_output_set (struct ripng_output *set, struct prefix *p,
+		  struct ripng_output_rte *rte)
+{
+  struct route_node *rn;
+  size_t size = 2 * sizeof (struct ripng_output_rte);
+
+  if (! rte[0].valid && ! rte[1].valid)
+    {
+      rn = route_node_lookup (set->table, p);
+      if (rn)
+	{
+	  XFREE (MTYPE_RIPNG_OUTPUT, rn->info);
+	  rn->info = NULL;
+	  route_unlock_node (rn);
+	  route_unlock_node (rn);
+	  set->stale = 1;
+	}
+      return;
+    }
+
+  rn = route_node_get (set->table, p);
+  if (rn->info)
+    {
+      route_unlock_node (rn);
+      if (memcmp (rn->info, rte, size) == 0)
+	return;
+    }
+  else
+    rn->info = XMALLOC (MTYPE_RIPNG_OUTPUT, size);
+  memcpy (rn->info, rte, size);
+  set->stale = 1;
+}
+
+/* Bring the set of ifp up to date with the routing table: apply the
+   changes recorded since it was last used, or recompute every route if
+   the set was reset or missed an update. */
+static struct ripng_output *
+ripng_output_sync (struct interface *ifp)
+{
+  struct ripng_output *set;
+  struct route_node *rp, *rn;
+  struct ripng_output_rte rte[2];
+
+  set = ripng_output_get (ifp);
+
+  if (set->epoch != ripng->output_epoch)
+    {
+      ripng_output_clear (set);
+      for (rp = route_top (ripng->table); rp; rp = route_next (rp))
+	if (rp->info || rp->aggregate)
+	  {
+	    ripng_output_rte (ifp, rp, rte);
+	    ripng_output_set (set, &rp->p, rte);
+	  }
+    }
+  else if (set->seq != ripng->output_seq)
+    for (rn = route_top (ripng->changes); rn; rn = route_next (rn))
+      if (rn->info)
+	{
+	  /* The node may only hold an aggregate, look it up by hand. */
+	  rp = route_node_get (ripng->table, &rn->p);
+	  ripng_output_rte (ifp, rp, rte);
+	  ripng_output_set (set, &rn->p, rte);
+	  route_unlock_node (rp);
+	}
+
+  set->epoch = ripng->output_epoch;
+  set->seq = ripng->output_seq;
+  return set;
+}
+
+static int
+ripng_output_cmp (const void *a, const void *b)
+{
+  const struct ripng_output_rte *A = (const struct ripng_output_rte *) a;
+  const struct ripng_output_rte *B = (const struct ripng_output_rte *) b;
+  int ret;
+
+  ret = addr6_cmp (&A->nexthop, &B->nexthop);
+  if (ret)
+    return ret;
+  return A->order - B->order;
+}
+
+/* Append rte to the response being built in out, starting a new one
+   when num is 0. */
+static void
+ripng_output_put (struct ripng_output *out, size_t *len, int *num,
+		  struct rte *rte)
+{
+  u_char *pnt = out->packets + *len;
 
-	  /* Changed route only output. */
-	  /* XXX, vincent, in order to increase time convergence,
-	   * it should be announced if a child has changed.
-	   */
-	  if (route_type == ripng_changed_route)
-	    continue;
+  if (*num == 0)
+    {
+      pnt[0] = RIPNG_RESPONSE;
+      pnt[1] = RIPNG_V1;
+      pnt[2] = pnt[3] = 0;
+      *len += 4;
+      out->packet_size[out->packet_count++] = 4;
+    }
+  memcpy (out->packets + *len, rte, sizeof (struct rte));
+  *len += sizeof (struct rte);
+  out->packet_size[out->packet_count - 1] += sizeof (struct rte);
+  (*num)++;
+}
 
-	  /* Apply offset-list */
-	  if (aggregate->metric_out != RIPNG_METRIC_INFINITY)
-	    ripng_offset_list_apply_out (p, ifp, &aggregate->metric_out);
+/* Build the responses carrying the count RTEs in rtes, at most rtemax
+   RTEs each: grouped by nexthop, each group led by a nexthop RTE
+   unless the nexthop is unspecified (2.1). */
+static void
+ripng_output_pack (struct ripng_output *out, struct ripng_output_rte *rtes,
+		   int count, int rtemax)
+{
+  struct in6_addr last_nexthop;
+  struct in6_addr myself_nexthop;
+  struct rte nexthop;
+  size_t len = 0;
+  int max_packets;
+  int num = 0;
+  int i;
 
-	  if (aggregate->metric_out > RIPNG_METRIC_INFINITY)
-	    aggregate->metric_out = RIPNG_METRIC_INFINITY;
+  ripng_output_packets_free (out);
+  if (count == 0)
+    return;
+
+  qsort (rtes, count, sizeof (struct ripng_output_rte), ripng_output_cmp);
+
+  /* Every response but the last carries at least rtemax - 1 RTEs, and
+     each RTE may need a nexthop RTE. */
+  max_packets = (2 * count) / (rtemax - 1) + 1;
+  out->packets = XMALLOC (MTYPE_RIPNG_OUTPUT,
+			  max_packets * (4 + rtemax * sizeof (struct rte)));
+  out->packet_size = XMALLOC (MTYPE_RIPNG_OUTPUT, max_packets * sizeof (int));
+
+  /* Most of the time, there is no nexthop */
+  memset (&last_nexthop, 0, sizeof (last_nexthop));
+  memset (&myself_nexthop, 0, sizeof (myself_nexthop));
+  memset (&nexthop, 0, sizeof (nexthop));
+  nexthop.metric = RIPNG_METRIC_NEXTHOP;
+
+  for (i = 0; i < count; i++)
+    {
+      if (! IPV6_ADDR_SAME (&last_nexthop, &rtes[i].nexthop))
+	{
+	  /* A nexthop entry should be at least followed by 1 RTE */
+	  if (num == rtemax - 1)
+	    num = 0;
+
+	  /* If the received next hop address is not a link-local
+	     address, it should be treated as 0:0:0:0:0:0:0:0. */
+	  if (! IN6_IS_ADDR_LINKLOCAL (&rtes[i].nexthop))
+	    last_nexthop = myself_nexthop;
+	  else
+	    last_nexthop = rtes[i].nexthop;
 
-	  /* Add RTE to the list */
-	  ripng_rte_add(ripng_rte_list, p, NULL, aggregate);
+	  nexthop.addr = last_nexthop;
+	  ripng_output_put (out, &len, &num, &nexthop);
+	}
+      else if (num == 0 && ! IPV6_ADDR_SAME (&last_nexthop, &myself_nexthop))
+	{
+	  /* Rewrite the nexthop for each new packet */
+	  nexthop.addr = last_nexthop;
+	  ripng_output_put (out, &len, &num, &nexthop);
 	}
 
+      ripng_output_put (out, &len, &num, &rtes[i].rte);
+      if (num == rtemax)
+	num = 0;
     }
+}
+
+/* Lay out the responses of a periodic update on ifp. */
+static void
+ripng_output_layout (struct ripng_output *set, int mtu)
+{
+  struct ripng_output_rte *rtes, *rte;
+  struct route_node *rn;
+  int rtemax;
+  int count = 0;
+  int i;
+
+  for (rn = route_top (set->table); rn; rn = route_next (rn))
+    if (rn->info)
+      count += 2;
 
-  /* Flush the list */
-  ripng_rte_send(ripng_rte_list, ifp, to);
-  ripng_rte_free(ripng_rte_list);
+  rtes = XMALLOC (MTYPE_TMP, (count ? count : 1) * sizeof (*rtes));
+  count = 0;
+  for (rn = route_top (set->table); rn; rn = route_next (rn))
+    if ((rte = rn->info) != NULL)
+      for (i = 0; i < 2; i++)
+	if (rte[i].valid)
+	  {
+	    rtes[count] = rte[i];
+	    rtes[count].order = count;
+	    count++;
+	  }
+
+  rtemax = (MIN (mtu, RIPNG_MAX_PACKET_SIZE) -
+	    IPV6_HDRLEN - 
+	    sizeof (struct udphdr) -
+	    sizeof (struct ripng_packet) +
+	    sizeof (struct rte)) / sizeof (struct rte);
+
+  ripng_output_pack (set, rtes, count, rtemax);
+  XFREE (MTYPE_TMP, rtes);
+
+  set->mtu = mtu;
+  set->stale = 0;
+}
+
+/* Send the responses built in out. */
+static void
+ripng_output_send (struct ripng_output *out, struct interface *ifp,
+		   struct sockaddr_in6 *to)
+{
+  u_char *pnt = out->packets;
+  int ret;
+  int i;
+
+  for (i = 0; i < out->packet_count; i++)
+    {
+      ret = ripng_send_packet ((caddr_t) pnt, out->packet_size[i], to, ifp);
+
+      if (ret >= 0 && IS_RIPNG_DEBUG_SEND)
+        ripng_packet_dump ((struct ripng_packet *) pnt, out->packet_size[i],
+			   "SEND");
+      pnt += out->packet_size[i];
+    }
+}
+
+/* An update went out on every interface: clear the route change
+   flags, move the output sets that saw every change on to the next
+   epoch and start a new list of changes. */
+static void
+ripng_output_commit (void)
+{
+  struct route_node *rn, *rp;
+  struct listnode *node;
+  struct interface *ifp;
+  struct ripng_interface *ri;
+
+  for (rn = route_top (ripng->changes); rn; rn = route_next (rn))
+    if (rn->info)
+      {
+	rp = route_node_lookup (ripng->table, &rn->p);
+	if (rp)
+	  {
+	    ((struct ripng_info *) rp->info)->flags &= ~RIPNG_RTF_CHANGED;
+	    route_unlock_node (rp);
+	  }
+	rn->info = NULL;
+	route_unlock_node (rn);
+      }
+
+  for (ALL_LIST_ELEMENTS_RO (iflist, node, ifp))
+    {
+      ri = ifp->info;
+      if (ri->output
+	  && ri->output->epoch == ripng->output_epoch
+	  && ri->output->seq == ripng->output_seq)
+	ri->output->epoch++;
+    }
+  ripng->output_epoch++;
+}
+
+/* Send RESPONSE message to specified destination. */
+void
+ripng_output_process (struct interface *ifp, struct sockaddr_in6 *to,
+		      int route_type)
+{
+  struct ripng_output *set;
+  struct ripng_output changed;
+  struct ripng_output_rte *rtes, *rte;
+  struct route_node *rn, *node;
+  int mtu;
+  int count = 0;
+
+  if (IS_RIPNG_DEBUG_EVENT) {
+    if (to)
+      zlog_debug ("RIPng update routes to neighbor %s",
+                 inet6_ntoa(to->sin6_addr));
+    else
+      zlog_debug ("RIPng update routes on interface %s", ifp->name);
+  }
+
+  mtu = ifp->mtu6;
+  if (mtu < 0)
+    mtu = IFMINMTU;
+
+  /* Bring the RTEs for this interface up to date. */
+  set = ripng_output_sync (ifp);
+
+  if (route_type == ripng_all_route)
+    {
+      /* Send the responses as built, they only change with the RTEs
+	 or the MTU. */
+      if (set->stale || set->mtu != mtu)
+	ripng_output_layout (set, mtu);
+      ripng_output_send (set, ifp, to);
+      return;
+    }
+
+  /* Changed route only output.  Aggregates are not announced.
+   * XXX, vincent, in order to increase time convergence,
+   * it should be announced if a child has changed.
+   */
+  for (rn = route_top (ripng->changes); rn; rn = route_next (rn))
+    if (rn->info)
+      count++;
+  if (count == 0)
+    return;
+
+  rtes = XMALLOC (MTYPE_TMP, count * sizeof (*rtes));
+  count = 0;
+  for (rn = route_top (ripng->changes); rn; rn = route_next (rn))
+    if (rn->info && (node = route_node_lookup (set->table, &rn->p)))
+      {
+	rte = node->info;
+	if (rte[0].valid)
+	  {
+	    rtes[count] = rte[0];
+	    rtes[count].order = count;
+	    count++;
+	  }
+	route_unlock_node (node);
+      }
+
+  memset (&changed, 0, sizeof (changed));
+  ripng_output_pack (&changed, rtes, count,
+		     (MIN (mtu, RIPNG_MAX_PACKET_SIZE) -
+		      IPV6_HDRLEN - 
+		      sizeof (struct udphdr) -
+		      sizeof (struct ripng_packet) +
+		      sizeof (struct rte)) / sizeof (struct rte));
+  ripng_output_send (&changed, ifp, to);
+  ripng_output_packets_free (&changed);
+  XFREE (MTYPE_TMP, rtes);
 }
 
 /* Create new RIPng instance and set it to global variable. */
@@ -1838,6 +2237,8 @@ ripng_create ()
   ripng->table = route_table_init ();
   ripng->route = route_table_init ();
   ripng->aggregate = route_table_init ();
+  ripng->changes = route_table_init ();
+  ripng->output_epoch = 1;
  
   /* Make socket. */
   ripng->sock = ripng_make_socket ();
@@ -2294,6 +2695,7 @@ DEFUN (ripng_aggregate_address,
   node->info = (void *)1;
 
   ripng_aggregate_add (&p);
+  ripng_output_reset ();
 
   return CMD_SUCCESS;
 }
@@ -2327,6 +2729,7 @@ DEFUN (no_ripng_aggregate_address,
   route_unlock_node (rn);
 
   ripng_aggregate_delete (&p);
+  ripng_output_reset ();
 
   return CMD_SUCCESS;
 }
@@ -2340,6 +2743,7 @@ DEFUN (ripng_default_metric,
   if (ripng)
     {
       ripng->default_metric = atoi (argv[0]);
+      ripng_output_reset ();
     }
   return CMD_SUCCESS;
 }
@@ -2354,6 +2758,7 @@ DEFUN (no_ripng_default_metric,
   if (ripng)
     {
       ripng->default_metric = RIPNG_DEFAULT_METRIC_DEFAULT;
+      ripng_output_reset ();
     }
   return CMD_SUCCESS;
 }
@@ -2752,6 +3157,8 @@ ripng_distribute_update (struct distribute *dist)
     }
   else
     ri->prefix[RIPNG_FILTER_OUT] = NULL;
+
+  ripng_output_reset ();
 }
 
 void
@@ -2773,6 +3180,9 @@ ripng_distribute_update_all (struct prefix_list *notused)
 
   for (ALL_LIST_ELEMENTS_RO (iflist, node, ifp))
     ripng_distribute_update_interface (ifp);
+
+  /* Offset lists and route-maps match on the lists too. */
+  ripng_output_reset ();
 }
 
 void
@@ -2788,6 +3198,9 @@ ripng_clean()
   int i;
   struct route_node *rp;
   struct ripng_info *rinfo;
+  struct listnode *node;
+  struct interface *ifp;
+  struct ripng_interface *ri;
 
   if (ripng) {
     /* Clear RIPng routes */
@@ -2843,6 +3256,18 @@ ripng_clean()
       if (ripng->route_map[i].name)
         free (ripng->route_map[i].name);
 
+    /* Output sets and pending changes. */
+    for (ALL_LIST_ELEMENTS_RO (iflist, node, ifp))
+      {
+        ri = ifp->info;
+        if (ri->output)
+          {
+            ripng_output_free (ri->output);
+            ri->output = NULL;
+          }
+      }
+    route_table_finish (ripng->changes);
+
     XFREE (MTYPE_ROUTE_TABLE, ripng->table);
     XFREE (MTYPE_ROUTE_TABLE, ripng->route);
     XFREE (MTYPE_ROUTE_TABLE, ripng->aggregate);
@@ -2912,6 +3337,8 @@ ripng_if_rmap_update (struct if_rmap *if_rmap)
     }
   else
     ri->routemap[RIPNG_FILTER_OUT] = NULL;
+
+  ripng_output_reset ();
 }
 
 void
@@ -2950,6 +3377,14 @@ ripng_routemap_update (const char *unused)
     ripng_if_rmap_update_interface (ifp);
 
   ripng_routemap_update_redistribute ();
+  ripng_output_reset ();
+}
+
+/* A route-map rule changed, routes may be announced differently. */
+static void
+ripng_routemap_event (route_map_event_t event, const char *unused)
+{
+  ripng_output_reset ();
 }
 
 /* Initialize ripng structure and set commands. */
@@ -3021,6 +3456,7 @@ ripng_init ()
 
   route_map_add_hook (ripng_routemap_update);
   route_map_delete_hook (ripng_routemap_update);
+  route_map_event_hook (ripng_routemap_event);
 
   if_rmap_init (RIPNG_NODE);
   if_rmap_hook_add (ripng_if_rmap_update);
@@ -134,6 +134,12 @@ struct ripng
     int metric_config;
     u_int32_t metric;
   } route_map[ZEBRA_ROUTE_MAX];
+
+  /* Prefixes changed since the last update, not yet applied to every
+     output set, and the counters output sets are checked against. */
+  struct route_table *changes;
+  unsigned long output_epoch;
+  unsigned long output_seq;
 };
 
 /* Routing table entry. */
@@ -280,6 +286,36 @@ struct ripng_interface
 
   /* Passive interface. */
   int passive;
+
+  /* Output set. */
+  struct ripng_output *output;
+};
+
+/* An RTE of an output set and the nexthop it goes out under. */
+struct ripng_output_rte
+{
+  u_char valid;
+  int order;
+  struct in6_addr nexthop;
+  struct rte rte;
+};
+
+/* RTEs sent through one interface, by prefix, after split horizon,
+   out filters, route-maps, offset lists and aggregation: the route and
+   the aggregate each prefix contributes.  Kept in step with the routing
+   table by applying ripng->changes.  The responses of a periodic
+   update are kept built for the MTU they were laid out for. */
+struct ripng_output
+{
+  struct route_table *table;
+  unsigned long epoch;
+  unsigned long seq;
+
+  u_char *packets;
+  int *packet_size;
+  int packet_count;
+  int mtu;
+  int stale;
 };
 
 /* RIPng peer information. */
@@ -388,6 +424,10 @@ void ripng_zebra_ipv6_delete (struct prefix_ipv6 *p, struct in6_addr *nexthop, u
 
 void ripng_redistribute_clean ();
 
+void ripng_output_change (struct route_node *);
+void ripng_output_reset (void);
+void ripng_output_free (struct ripng_output *);
+
 int ripng_write_rte (int num, struct stream *s, struct prefix_ipv6 *p,
 		     struct in6_addr *nexthop, u_int16_t tag, u_char metric);
 int ripng_send_packet (caddr_t buf, int bufsize, struct sockaddr_in6 *to, 
@@ -28,6 +28,20 @@ typedef enum
 } E_RC;
 
 
+/* debugging - the trace arguments are not evaluated unless the flag
+   is set */
+extern uns32 RsvpDebugFlags;
+
+#define RSVP_DEBUG_TRACE  0x01
+#define RSVP_DEBUG_PACKET 0x02
+
+#define IS_RSVP_DEBUG(f) (RsvpDebugFlags & RSVP_DEBUG_##f)
+
+#define RSVP_TRACE(...) \
+  do { if (IS_RSVP_DEBUG (TRACE)) zlog_debug (__VA_ARGS__); } while (0)
+#define RSVP_PKT_TRACE(...) \
+  do { if (IS_RSVP_DEBUG (PACKET)) zlog_debug (__VA_ARGS__); } while (0)
+
 #define LOCAL_ADDRESS       "127.0.0.1"
 #define RSVP_CONSOLE_PORT   2002
 #define RSVP_TE_PORT        2003
@@ -29,9 +29,11 @@
 #include "patricia.h"
 
 #include "general.h"
+#include "rsvp_timer.h"
 #include "messages.h"
 #include "rsvp_packet.h"
 #include "te_lib.h"
+#include "rsvp_rr.h"
 #include "rsvp_psb.h"
 #include "rsvp_rsb.h"
 #include "rsvp_socket.h"
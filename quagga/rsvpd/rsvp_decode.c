@@ -112,9 +112,9 @@ SessionDecoder (void **ppData, RSVP_PKT * pRsvpPkt, OBJ_HDR * pObjHdr,
   pRsvpPkt->Session.Resvd = decode_16bit ((uns8 **) ppData);
   pRsvpPkt->Session.TunnelId = decode_16bit ((uns8 **) ppData);
   pRsvpPkt->Session.ExtTunelId = decode_32bit ((uns8 **) ppData);
-  zlog_info ("Dest %x TunnelId %x ExtTunnelId %x",
-	     pRsvpPkt->Session.Dest,
-	     pRsvpPkt->Session.TunnelId, pRsvpPkt->Session.ExtTunelId);
+  RSVP_PKT_TRACE ("Dest %x TunnelId %x ExtTunnelId %x",
+		  pRsvpPkt->Session.Dest,
+		  pRsvpPkt->Session.TunnelId, pRsvpPkt->Session.ExtTunelId);
   return E_OK;
 }
 
@@ -124,8 +124,8 @@ RsvpHopDecoder (void **ppData, RSVP_PKT * pRsvpPkt, OBJ_HDR * pObjHdr,
 {
   pRsvpPkt->ReceivedRsvpHop.PHop = decode_32bit ((uns8 **) ppData);
   pRsvpPkt->ReceivedRsvpHop.LIH = decode_32bit ((uns8 **) ppData);
-  zlog_info ("RSVP HOP %x %x", pRsvpPkt->ReceivedRsvpHop.PHop,
-	     pRsvpPkt->ReceivedRsvpHop.LIH);
+  RSVP_PKT_TRACE ("RSVP HOP %x %x", pRsvpPkt->ReceivedRsvpHop.PHop,
+		  pRsvpPkt->ReceivedRsvpHop.LIH);
   return E_OK;
 }
 
@@ -134,7 +134,7 @@ TimeValuesDecoder (void **ppData, RSVP_PKT * pRsvpPkt, OBJ_HDR * pObjHdr,
 		   uns32 RemainingLen)
 {
   pRsvpPkt->TimeValues.TimeValues = decode_32bit ((uns8 **) ppData);
-  zlog_info ("Time Values %x", pRsvpPkt->TimeValues.TimeValues);
+  RSVP_PKT_TRACE ("Time Values %x", pRsvpPkt->TimeValues.TimeValues);
   return E_OK;
 }
 
@@ -145,8 +145,8 @@ SenderTemplateDecoder (void **ppData, RSVP_PKT * pRsvpPkt, OBJ_HDR * pObjHdr,
   pRsvpPkt->SenderTemplate.IpAddr = decode_32bit ((uns8 **) ppData);
   pRsvpPkt->SenderTemplate.Resvd = decode_16bit ((uns8 **) ppData);
   pRsvpPkt->SenderTemplate.LspId = decode_16bit ((uns8 **) ppData);
-  zlog_info ("IP %x LSP ID %x", pRsvpPkt->SenderTemplate.IpAddr,
-	     pRsvpPkt->SenderTemplate.LspId);
+  RSVP_PKT_TRACE ("IP %x LSP ID %x", pRsvpPkt->SenderTemplate.IpAddr,
+		  pRsvpPkt->SenderTemplate.LspId);
   return E_OK;
 }
 
@@ -156,7 +156,7 @@ LabelReqDecoder (void **ppData, RSVP_PKT * pRsvpPkt, OBJ_HDR * pObjHdr,
 {
   pRsvpPkt->LabelRequest.Resvd = decode_16bit ((uns8 **) ppData);
   pRsvpPkt->LabelRequest.L3Pid = decode_16bit ((uns8 **) ppData);
-  zlog_info ("Label Request");
+  RSVP_PKT_TRACE ("Label Request");
   return E_OK;
 }
 
@@ -167,7 +167,7 @@ ERO_Decoder (void **ppData, RSVP_PKT * pRsvpPkt, OBJ_HDR * pObjHdr,
   int Count;
   ER_SUBOBJ *pErSubObj, *pPrev = NULL;
   int Len = pObjHdr->Length - sizeof (OBJ_HDR);
-  zlog_info ("entering ERO_Decoder");
+  RSVP_TRACE ("entering ERO_Decoder");
   if (Len % 8)
     {
       zlog_err (" the length is not 8-alligned");
@@ -204,9 +204,9 @@ ERO_Decoder (void **ppData, RSVP_PKT * pRsvpPkt, OBJ_HDR * pObjHdr,
 	  pErSubObj->u.Ipv4.IpAddress = decode_32bit ((uns8 **) ppData);
 	  pErSubObj->u.Ipv4.PrefixLength = decode_8bit ((uns8 **) ppData);
 	  pErSubObj->u.Ipv4.Resvd = decode_8bit ((uns8 **) ppData);
-	  zlog_info ("ERO subobject: IP %x prefix length %x",
-		     pErSubObj->u.Ipv4.IpAddress,
-		     pErSubObj->u.Ipv4.PrefixLength);
+	  RSVP_PKT_TRACE ("ERO subobject: IP %x prefix length %x",
+			  pErSubObj->u.Ipv4.IpAddress,
+			  pErSubObj->u.Ipv4.PrefixLength);
 	  break;
 	default:
 	  zlog_err ("the type %d of subobject is unknown %s %d",
@@ -215,7 +215,7 @@ ERO_Decoder (void **ppData, RSVP_PKT * pRsvpPkt, OBJ_HDR * pObjHdr,
 	}
       pPrev = pErSubObj;
     }
-  zlog_info ("leaving ERO_Decoder");
+  RSVP_TRACE ("leaving ERO_Decoder");
   return E_OK;
 }
 
@@ -349,12 +349,12 @@ SenderTSpecDecoder (void **ppData, RSVP_PKT * pRsvpPkt, OBJ_HDR * pObjHdr,
   pRsvpPkt->SenderTSpec.PeakDataRate = decode_float ((uns8 **) ppData);
   pRsvpPkt->SenderTSpec.MinPolicedUnit = decode_32bit ((uns8 **) ppData);
   pRsvpPkt->SenderTSpec.MaxPacketSize = decode_32bit ((uns8 **) ppData);
-  zlog_info ("Sender TSPEC %f %f %f %x %x",
-	     pRsvpPkt->SenderTSpec.PeakDataRate,
-	     pRsvpPkt->SenderTSpec.TockenBucketRate,
-	     pRsvpPkt->SenderTSpec.TockenBucketSize,
-	     pRsvpPkt->SenderTSpec.MinPolicedUnit,
-	     pRsvpPkt->SenderTSpec.MaxPacketSize);
+  RSVP_PKT_TRACE ("Sender TSPEC %f %f %f %x %x",
+		  pRsvpPkt->SenderTSpec.PeakDataRate,
+		  pRsvpPkt->SenderTSpec.TockenBucketRate,
+		  pRsvpPkt->SenderTSpec.TockenBucketSize,
+		  pRsvpPkt->SenderTSpec.MinPolicedUnit,
+		  pRsvpPkt->SenderTSpec.MaxPacketSize);
   return E_OK;
 }
 
@@ -401,16 +401,16 @@ RRO_Decoder (void **ppData, RSVP_PKT * pRsvpPkt, OBJ_HDR * pObjHdr,
 	  pRrSubObj->u.Ipv4.IpAddr = decode_32bit ((uns8 **) ppData);
 	  pRrSubObj->u.Ipv4.PrefixLen = decode_8bit ((uns8 **) ppData);
 	  pRrSubObj->u.Ipv4.Flags = decode_8bit ((uns8 **) ppData);
-	  zlog_info ("RRO subobject: IP %x prefix length %x",
-		     pRrSubObj->u.Ipv4.IpAddr, pRrSubObj->u.Ipv4.PrefixLen);
+	  RSVP_PKT_TRACE ("RRO subobject: IP %x prefix length %x",
+			  pRrSubObj->u.Ipv4.IpAddr, pRrSubObj->u.Ipv4.PrefixLen);
 	  break;
 	case RRO_SUBTYPE_LABEL:
 	  pRrSubObj->u.Label.Flags = decode_8bit ((uns8 **) ppData);
 	  pRrSubObj->u.Label.CType = decode_8bit ((uns8 **) ppData);
 	  pRrSubObj->u.Label.Label = decode_32bit ((uns8 **) ppData);
-	  zlog_info ("RRO subobject: Flags %x CType %x Label %x",
-		     pRrSubObj->u.Label.Flags, pRrSubObj->u.Label.CType,
-		     pRrSubObj->u.Label.Label);
+	  RSVP_PKT_TRACE ("RRO subobject: Flags %x CType %x Label %x",
+			  pRrSubObj->u.Label.Flags, pRrSubObj->u.Label.CType,
+			  pRrSubObj->u.Label.Label);
 	  break;
 	default:
 	  zlog_err ("the type %d of subobject is unknown %s %d",
@@ -632,8 +632,8 @@ FlowSpecDecoder (void **ppData, FLOW_SPEC_OBJ * pFlowSpec)
       pFlowSpec->u.CtrlLoad.TockenBucketSize =
 	decode_float ((uns8 **) ppData);
       pFlowSpec->u.CtrlLoad.PeakDataRate = decode_float ((uns8 **) ppData);
-      zlog_info ("FLOW_SPEC - data rate %f",
-		 pFlowSpec->u.CtrlLoad.PeakDataRate);
+      RSVP_PKT_TRACE ("FLOW_SPEC - data rate %f",
+		      pFlowSpec->u.CtrlLoad.PeakDataRate);
       pFlowSpec->u.CtrlLoad.MinPolicedUnit = decode_float ((uns8 **) ppData);
       pFlowSpec->u.CtrlLoad.MaxPacketSize = decode_float ((uns8 **) ppData);
     }
@@ -645,8 +645,8 @@ FlowSpecDecoder (void **ppData, FLOW_SPEC_OBJ * pFlowSpec)
 	decode_float ((uns8 **) ppData);
       pFlowSpec->u.Guar.CtrlLoad.PeakDataRate =
 	decode_float ((uns8 **) ppData);
-      zlog_info ("FLOW_SPEC1 - data rate %f",
-		 pFlowSpec->u.Guar.CtrlLoad.PeakDataRate);
+      RSVP_PKT_TRACE ("FLOW_SPEC1 - data rate %f",
+		      pFlowSpec->u.Guar.CtrlLoad.PeakDataRate);
       pFlowSpec->u.Guar.CtrlLoad.MinPolicedUnit =
 	decode_float ((uns8 **) ppData);
       pFlowSpec->u.Guar.CtrlLoad.MaxPacketSize =
@@ -674,7 +674,7 @@ FilterSpecDecoder (void **ppData, FILTER_SPEC_OBJ * pFilterSpec)
   pFilterSpec->IpAddr = decode_32bit ((uns8 **) ppData);
   pFilterSpec->Resvd = decode_16bit ((uns8 **) ppData);
   pFilterSpec->LspId = decode_16bit ((uns8 **) ppData);
-  zlog_info ("FILTER_SPEC %x %x", pFilterSpec->IpAddr, pFilterSpec->LspId);
+  RSVP_PKT_TRACE ("FILTER_SPEC %x %x", pFilterSpec->IpAddr, pFilterSpec->LspId);
   return E_OK;
 }
 
@@ -682,7 +682,7 @@ E_RC
 LabelDecoder (void **ppData, LABEL_OBJ * pLabelObj)
 {
   pLabelObj->Label = decode_32bit ((uns8 **) ppData);
-  zlog_info ("label decoded %x", pLabelObj->Label);
+  RSVP_PKT_TRACE ("label decoded %x", pLabelObj->Label);
   return E_OK;
 }
 
@@ -749,6 +749,7 @@ flow_spec_missing:
 	      XFREE (MTYPE_RSVP, pFilterListNew);
 	      return E_ERR;
 	    }
+	  memset (pFilterSpecData, 0, sizeof (FILTER_SPEC_DATA));
 	  pFilterListNew->pFilterSpecData = pFilterSpecData;
 	  if (FilterSpecDecoder (ppData, &pFilterSpecData->FilterSpec) !=
 	      E_OK)
@@ -841,8 +842,8 @@ StyleDecoder (void **ppData, RSVP_PKT * pRsvpPkt, OBJ_HDR * pObjHdr,
   pRsvpPkt->Style.Flags = decode_8bit ((uns8 **) ppData);
   pRsvpPkt->Style.OptionVector1 = decode_8bit ((uns8 **) ppData);
   pRsvpPkt->Style.OptionVector2 = decode_16bit ((uns8 **) ppData);
-  zlog_info ("Style %x %x %x", pRsvpPkt->Style.Flags,
-	     pRsvpPkt->Style.OptionVector1, pRsvpPkt->Style.OptionVector2);
+  RSVP_PKT_TRACE ("Style %x %x %x", pRsvpPkt->Style.Flags,
+		  pRsvpPkt->Style.OptionVector1, pRsvpPkt->Style.OptionVector2);
   return FlowDescriptorDecoder (ppData, pRsvpPkt, RemainingLen - 4);
 }
 
@@ -857,6 +858,31 @@ ErrSpecDecoder (void **ppData, RSVP_PKT * pRsvpPkt, OBJ_HDR * pObjHdr,
   return E_OK;
 }
 
+E_RC
+MessageIdDecoder (void **ppData, RSVP_PKT * pRsvpPkt, OBJ_HDR * pObjHdr,
+		  uns32 RemainingLen)
+{
+  pRsvpPkt->MessageId.Flags = decode_8bit ((uns8 **) ppData);
+  pRsvpPkt->MessageId.Epoch = decode_24bit ((uns8 **) ppData);
+  pRsvpPkt->MessageId.MessageId = decode_32bit ((uns8 **) ppData);
+  pRsvpPkt->MessageIdValid = TRUE;
+  return E_OK;
+}
+
+E_RC
+MessageIdAckDecoder (void **ppData, RSVP_PKT * pRsvpPkt, OBJ_HDR * pObjHdr,
+		     uns32 RemainingLen)
+{
+  MESSAGE_ID_OBJ Ack;
+
+  /* piggybacked acknowledgement of a message we sent */
+  Ack.Flags = decode_8bit ((uns8 **) ppData);
+  Ack.Epoch = decode_24bit ((uns8 **) ppData);
+  Ack.MessageId = decode_32bit ((uns8 **) ppData);
+  RsvpRrProcessAck (&Ack, pObjHdr->CType);
+  return E_OK;
+}
+
 void
 InitRsvpDecoder ()
 {
@@ -875,6 +901,8 @@ InitRsvpDecoder ()
   DecodeHandlers[POLICY_DATA_CLASS].pObjDecoder = OpaqueObjDecoder;
   DecodeHandlers[INTEGRITY_CLASS].pObjDecoder = OpaqueObjDecoder;
   DecodeHandlers[ERR_SPEC_CLASS].pObjDecoder = ErrSpecDecoder;
+  DecodeHandlers[MESSAGE_ID_CLASS].pObjDecoder = MessageIdDecoder;
+  DecodeHandlers[MESSAGE_ID_ACK_CLASS].pObjDecoder = MessageIdAckDecoder;
 }
 
 E_RC
@@ -918,6 +946,17 @@ DecodeAndProcessRsvpMsg (void *pPkt, int PktLen, uns32 IfIndex,
     }
   //PktLen -= sizeof(RSVP_COMMON_HDR);
 
+  RsvpRrNeighborSeen (SrcIpAddr, IfIndex, RsvpCommonHdr.VersionFlags);
+  if ((RsvpCommonHdr.MsgType == BUNDLE_MSG) ||
+      (RsvpCommonHdr.MsgType == ACK_MSG) ||
+      (RsvpCommonHdr.MsgType == SREFRESH_MSG))
+    {
+      XFREE (MTYPE_RSVP, pRsvpPkt);
+      return RsvpRrProcessMsg (RsvpCommonHdr.MsgType, pData,
+			       PktLen - ((uns32) pData - InitialAddress),
+			       SrcIpAddr, IfIndex);
+    }
+
   while (((uns32) pData - InitialAddress) < PktLen)
     {
       ppData = (void **) &pData;
@@ -951,6 +990,7 @@ DecodeAndProcessRsvpMsg (void *pPkt, int PktLen, uns32 IfIndex,
     {
     case PATH_MSG:
       DumpPathMsg (pRsvpPkt, NULL);
+      RsvpRrMessageIdReceived (pRsvpPkt, PATH_MSG, SrcIpAddr, IfIndex);
       if (ProcessRsvpPathMessage
 	  (pRsvpPkt, IfIndex, SrcIpAddr, RsvpCommonHdr.SendTTL) != E_OK)
 	{
@@ -959,6 +999,7 @@ DecodeAndProcessRsvpMsg (void *pPkt, int PktLen, uns32 IfIndex,
       break;
     case RESV_MSG:
       DumpResvMsg (pRsvpPkt, NULL);
+      RsvpRrMessageIdReceived (pRsvpPkt, RESV_MSG, SrcIpAddr, IfIndex);
       if (ProcessRsvpResvMessage (pRsvpPkt) != E_OK)
 	{
 	  zlog_err ("An error on RESV processing");
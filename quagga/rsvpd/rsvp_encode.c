@@ -103,7 +103,7 @@ static char BigBuffer[1500];
     encode_16bit((uns8 **)ppData,Length); /* Length */\
     encode_8bit((uns8 **)ppData,ClassNum);/* ClassNum */\
     encode_8bit((uns8 **)ppData,CType);/* CType */\
-    zlog_info("obj %d ctype %d len %d",ClassNum,CType,Length);\
+    RSVP_PKT_TRACE("obj %d ctype %d len %d",ClassNum,CType,Length);\
     PktLen += 4; \
 }
 
@@ -158,7 +158,7 @@ static char BigBuffer[1500];
     VariableLengthObj = sizeof(OBJ_HDR); /* for obj header */ \
     while(pErSubObj != NULL) \
     { \
-        zlog_info("encoding of %x",pErSubObj->u.Ipv4.IpAddress);\
+        RSVP_PKT_TRACE("encoding of %x",pErSubObj->u.Ipv4.IpAddress);\
         encode_8bit((uns8 **)ppData,pErSubObj->SubObjHdr.LType);\
         encode_8bit((uns8 **)ppData,pErSubObj->SubObjHdr.Length);\
         PktLen += 2; \
@@ -181,7 +181,7 @@ static char BigBuffer[1500];
     pErSubObj = pRsvpPkt->SentEro.er;\
     while(pErSubObj != NULL)\
     {\
-        zlog_info("encoding2 of %x",pErSubObj->u.Ipv4.IpAddress);\
+        RSVP_PKT_TRACE("encoding2 of %x",pErSubObj->u.Ipv4.IpAddress);\
         encode_8bit((uns8 **)ppData,pErSubObj->SubObjHdr.LType);\
         encode_8bit((uns8 **)ppData,pErSubObj->SubObjHdr.Length);\
         PktLen += 2; \
@@ -306,7 +306,7 @@ static char BigBuffer[1500];
             encode_32bit((uns8 **)ppData,pRrSubObj->u.Ipv4.IpAddr); \
             encode_8bit((uns8 **)ppData,pRrSubObj->u.Ipv4.PrefixLen); \
             encode_8bit((uns8 **)ppData,pRrSubObj->u.Ipv4.Flags); \
-            zlog_info("RRO sub - IP: %x",pRrSubObj->u.Ipv4.IpAddr);\
+            RSVP_PKT_TRACE("RRO sub - IP: %x",pRrSubObj->u.Ipv4.IpAddr);\
             PktLen += 6; \
             VariableLengthObj += 6; \
             break; \
@@ -314,7 +314,7 @@ static char BigBuffer[1500];
             encode_8bit((uns8 **)ppData,pRrSubObj->u.Label.Flags); \
             encode_8bit((uns8 **)ppData,pRrSubObj->u.Label.CType); \
             encode_32bit((uns8 **)ppData,pRrSubObj->u.Label.Label); \
-            zlog_info("RRO sub - Label: %x",pRrSubObj->u.Label.Label);\
+            RSVP_PKT_TRACE("RRO sub - Label: %x",pRrSubObj->u.Label.Label);\
             PktLen += 6; \
             VariableLengthObj += 6; \
             break; \
@@ -341,7 +341,7 @@ static char BigBuffer[1500];
             encode_32bit((uns8 **)ppData,pRrSubObj->u.Ipv4.IpAddr); \
             encode_8bit((uns8 **)ppData,pRrSubObj->u.Ipv4.PrefixLen); \
             encode_8bit((uns8 **)ppData,pRrSubObj->u.Ipv4.Flags); \
-            zlog_info(" RRO sub - IP: %x",pRrSubObj->u.Ipv4.IpAddr);\
+            RSVP_PKT_TRACE(" RRO sub - IP: %x",pRrSubObj->u.Ipv4.IpAddr);\
             PktLen += 6; \
             VariableLengthObj += 6; \
             break; \
@@ -349,7 +349,7 @@ static char BigBuffer[1500];
             encode_8bit((uns8 **)ppData,pRrSubObj->u.Label.Flags); \
             encode_8bit((uns8 **)ppData,pRrSubObj->u.Label.CType); \
             encode_32bit((uns8 **)ppData,pRrSubObj->u.Label.Label); \
-            zlog_info(" RRO sub - Label: %x",pRrSubObj->u.Label.Label);\
+            RSVP_PKT_TRACE(" RRO sub - Label: %x",pRrSubObj->u.Label.Label);\
             PktLen += 6; \
             VariableLengthObj += 6; \
             break; \
@@ -473,7 +473,7 @@ static char BigBuffer[1500];
   encode_32bit((uns8 **)ppData,pFilterSpecData->FilterSpec.IpAddr);\
   encode_16bit((uns8 **)ppData,pFilterSpecData->FilterSpec.Resvd);\
   encode_16bit((uns8 **)ppData,pFilterSpecData->FilterSpec.LspId);\
-  zlog_info("encoding FILTER_SPEC %x %x",pFilterSpecData->FilterSpec.IpAddr,pFilterSpecData->FilterSpec.LspId);\
+  RSVP_PKT_TRACE("encoding FILTER_SPEC %x %x",pFilterSpecData->FilterSpec.IpAddr,pFilterSpecData->FilterSpec.LspId);\
   PktLen += 8;\
   ENCODE_OBJ_HDR(sizeof(LABEL_OBJ)+sizeof(OBJ_HDR),LABEL_CLASS,COMMON_CTYPE)\
   encode_32bit((uns8 **)ppData,pFilterSpecData->SentLabel.Label);\
@@ -498,14 +498,14 @@ EncodeAndSendRsvpPathMessage (RSVP_PKT * pRsvpPkt,
 			      char **ppSentBuffer, uns16 * pSentBufferLen)
 {
   uns16 PktLen = 0;
-  uns8 VersionFlags = RSVP_VERSION;
+  uns8 VersionFlags = RSVP_VERSION_FLAGS;
   uns16 *pCheckSum, CheckSum = 0;
   uns16 *pRsvpLength;
   uns8 *pData = BigBuffer;
   uns8 **ppData = &pData;
   uns16 *pVariableLengthObj;
   uns16 VariableLengthObj;
-  zlog_info ("entering EncodeAndSendRsvpPathMessage");
+  RSVP_TRACE ("entering EncodeAndSendRsvpPathMessage");
   memset (BigBuffer, 0, 1500);
 
   ENCODE_COMMON_HDR (VersionFlags, PATH_MSG, 0 /* CheckSum */ , ttl,
@@ -594,7 +594,7 @@ EncodeAndSendRsvpResvMessage (RSVP_PKT * pRsvpPkt,
 			      char **ppSentBuffer, uns16 * pSentBufferLen)
 {
   uns16 PktLen = 0;
-  uns8 VersionFlags = RSVP_VERSION;
+  uns8 VersionFlags = RSVP_VERSION_FLAGS;
   uns16 *pCheckSum, CheckSum = 0;
   uns16 *pRsvpLength;
   uns8 *pData = BigBuffer;
@@ -605,7 +605,7 @@ EncodeAndSendRsvpResvMessage (RSVP_PKT * pRsvpPkt,
   FILTER_SPEC_DATA *pFilterSpecData;
   FLOW_SPEC_OBJ *pFlowSpecObj;
 
-  zlog_info ("entering EncodeAndSendRsvpResvMessage");
+  RSVP_TRACE ("entering EncodeAndSendRsvpResvMessage");
   memset (BigBuffer, 0, 1500);
 
   ENCODE_COMMON_HDR (VersionFlags, RESV_MSG, 0 /* CheckSum */ , ttl,
@@ -668,14 +668,14 @@ EncodeAndSendRsvpPathErrMessage (RSVP_PKT * pRsvpPkt, IPV4_ADDR DestIpAddr,
 				 uns32 OutIf, uns8 ttl)
 {
   uns16 PktLen = 0;
-  uns8 VersionFlags = RSVP_VERSION;
+  uns8 VersionFlags = RSVP_VERSION_FLAGS;
   uns16 *pCheckSum, CheckSum = 0;
   uns16 *pRsvpLength;
   uns8 *pData = BigBuffer;
   uns8 **ppData = &pData;
   uns16 *pVariableLengthObj;
 
-  zlog_info ("entering EncodeAndSendRsvpPathErrMessage");
+  RSVP_TRACE ("entering EncodeAndSendRsvpPathErrMessage");
   memset (BigBuffer, 0, 1500);
 
   ENCODE_COMMON_HDR (VersionFlags, PATH_ERR_MSG, 0 /* CheckSum */ , ttl,
@@ -706,14 +706,14 @@ EncodeAndSendRsvpPathTearMessage (RSVP_PKT * pRsvpPkt, IPV4_ADDR DestIpAddr,
 				  uns32 OutIf, uns8 ttl)
 {
   uns16 PktLen = 0;
-  uns8 VersionFlags = RSVP_VERSION;
+  uns8 VersionFlags = RSVP_VERSION_FLAGS;
   uns16 *pCheckSum, CheckSum = 0;
   uns16 *pRsvpLength;
   uns8 *pData = BigBuffer;
   uns8 **ppData = &pData;
   uns16 *pVariableLengthObj;
 
-  zlog_info ("entering EncodeAndSendRsvpPathTearMessage");
+  RSVP_TRACE ("entering EncodeAndSendRsvpPathTearMessage");
   memset (BigBuffer, 0, 1500);
 
   ENCODE_COMMON_HDR (VersionFlags, PATH_TEAR_MSG, 0 /* CheckSum */ , ttl,
@@ -744,7 +744,7 @@ EncodeAndSendRsvpResvErrMessage (RSVP_PKT * pRsvpPkt, IPV4_ADDR DestIpAddr,
 				 uns32 OutIf, uns8 ttl)
 {
   uns16 PktLen = 0;
-  uns8 VersionFlags = RSVP_VERSION;
+  uns8 VersionFlags = RSVP_VERSION_FLAGS;
   uns16 *pCheckSum, CheckSum = 0;
   uns16 *pRsvpLength;
   uns8 *pData = BigBuffer;
@@ -755,7 +755,7 @@ EncodeAndSendRsvpResvErrMessage (RSVP_PKT * pRsvpPkt, IPV4_ADDR DestIpAddr,
   FILTER_SPEC_DATA *pFilterSpecData;
   FLOW_SPEC_OBJ *pFlowSpecObj;
 
-  zlog_info ("entering EncodeAndSendRsvpResvErrMessage");
+  RSVP_TRACE ("entering EncodeAndSendRsvpResvErrMessage");
   memset (BigBuffer, 0, 1500);
 
   ENCODE_COMMON_HDR (VersionFlags, RESV_ERR_MSG, 0 /* CheckSum */ , ttl,
@@ -808,7 +808,7 @@ EncodeAndSendRsvpResvTearMessage (RSVP_PKT * pRsvpPkt, IPV4_ADDR DestIpAddr,
 				  uns32 OutIf, uns8 ttl)
 {
   uns16 PktLen = 0;
-  uns8 VersionFlags = RSVP_VERSION;
+  uns8 VersionFlags = RSVP_VERSION_FLAGS;
   uns16 *pCheckSum, CheckSum = 0;
   uns16 *pRsvpLength;
   uns8 *pData = BigBuffer;
@@ -819,7 +819,7 @@ EncodeAndSendRsvpResvTearMessage (RSVP_PKT * pRsvpPkt, IPV4_ADDR DestIpAddr,
   FILTER_SPEC_DATA *pFilterSpecData;
   FLOW_SPEC_OBJ *pFlowSpecObj;
 
-  zlog_info ("entering EncodeAndSendRsvpResvTearMessage");
+  RSVP_TRACE ("entering EncodeAndSendRsvpResvTearMessage");
   memset (BigBuffer, 0, 1500);
 
   ENCODE_COMMON_HDR (VersionFlags, RESV_TEAR_MSG, 0 /* CheckSum */ , ttl,
@@ -227,8 +227,10 @@ main (int argc, char **argv)
   rsvp_vty ();
 
   InitRsvpDecoder ();
+  InitRsvpTimerWheel ();
   InitRsvpPathMessageProcessing ();
   InitResvProcessing ();
+  InitRsvpRefreshReduction ();
   InitInterfaceIpAdressesDB ();
 
   if (rdb_create () != E_OK)
@@ -23,6 +23,9 @@
 #define LABEL_REQUEST_CLASS       19
 #define EXPLICIT_ROUTE_CLASS      20
 #define RECORDED_ROUTE_CLASS      21
+#define MESSAGE_ID_CLASS          23
+#define MESSAGE_ID_ACK_CLASS      24
+#define MESSAGE_ID_LIST_CLASS     25
 #define SESSION_ATTRIBUTE_CLASS   207
 
 #define SESSION_CTYPE 7
@@ -43,6 +46,7 @@
 #define SESSION_ATTRIBUTES_RA_IPV4_CTYPE   1
 
 #define RSVP_VERSION (1 << 4)
+#define RSVP_RR_CAPABLE_FLAG 0x01	/* RFC 2961 Refresh-Reduction-Capable */
 
 #define LOCAL_PROTECTION_DESIRED   0x01
 #define LABEL_RECORDING_DESIRED    0x02
@@ -65,6 +69,9 @@ typedef struct
 #define PATH_TEAR_MSG    5
 #define RESV_TEAR_MSG    6
 #define RESV_CONF_MSG    7
+#define BUNDLE_MSG       12
+#define ACK_MSG          13
+#define SREFRESH_MSG     15
 
 typedef struct
 {
@@ -355,6 +362,20 @@ typedef struct
   IPV4_ADDR IpAddr;
 } RESV_CONF_OBJ;
 
+#define MESSAGE_ID_CTYPE          1
+#define MESSAGE_ID_ACK_CTYPE      1
+#define MESSAGE_ID_NACK_CTYPE     2
+#define MESSAGE_ID_LIST_CTYPE     1
+
+#define MESSAGE_ID_ACK_DESIRED    0x01
+
+typedef struct
+{
+  uns8 Flags;
+  uns32 Epoch;			/* 24 bits on the wire */
+  uns32 MessageId;
+} MESSAGE_ID_OBJ;
+
 typedef struct
 {
   IPV4_ADDR IpAddr;
@@ -435,7 +456,7 @@ typedef struct
   LABEL_OBJ SentLabel;		/* sent with RESV (allocated upon PATH) */
   RR_OBJ Rro;
   uns32 AgeOutValue;
-  struct thread *AgeOutTimer;
+  RSVP_TIMER *AgeOutTimer;
   FLOW_SPEC_OBJ FlowSpec;
   uns8 NewFlowSpecValid;
   FLOW_SPEC_OBJ NewFlowSpec;
@@ -445,7 +466,7 @@ typedef struct
   struct _psb_ *pPsb;
   uns8 ToBeDeleted;
   uns32 BlocadeValue;
-  struct thread *BlocadeTimer;
+  RSVP_TIMER *BlocadeTimer;
   uns8 Blocked;
 } FILTER_SPEC_DATA;
 
@@ -478,6 +499,8 @@ typedef struct
   POLICY_DATA_OBJ *pPolicyDataObj;
   OPAQUE_OBJ_LIST *pOpaqueObjList;
   ERR_SPEC_OBJ ErrorSpec;
+  uns8 MessageIdValid;
+  MESSAGE_ID_OBJ MessageId;
 } RSVP_PKT;
 
 #define ERO_SUBTYPE_IPV4 1
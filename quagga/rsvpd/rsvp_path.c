@@ -15,12 +15,12 @@ extern struct thread_master *master;
 static PATRICIA_TREE PsbTree;
 
 static void PrepareAndSendMsg2TE (PSB * pPsb);
-static E_RC StartPathAgeOutTimer (uns32 time, struct thread **pTimerId,
+static E_RC StartPathAgeOutTimer (uns32 time, RSVP_TIMER ** pTimerId,
 				  void *data);
-static E_RC StopPathAgeOutTimer (struct thread **pTimerId);
-static E_RC StartPathRefreshTimer (uns32 time, struct thread **pTimerId,
+static E_RC StopPathAgeOutTimer (RSVP_TIMER ** pTimerId);
+static E_RC StartPathRefreshTimer (uns32 time, RSVP_TIMER ** pTimerId,
 				   void *data);
-static E_RC StopPathRefreshTimer (struct thread **pTimerId);
+static E_RC StopPathRefreshTimer (RSVP_TIMER ** pTimerId);
 static void PrepareAndSendLabelReleaseMsg2TE (PSB * pPsb);
 static void PrepareAndSendPathErrNotificationMsg2TE (PSB * pPsb,
 						     ERR_SPEC_OBJ *
@@ -142,19 +142,19 @@ PsbDequeueAndInvokeMessages (PSB * pPsb)
     }
 }
 
-static int RsvpPathRefreshTimer (struct thread *);
+static int RsvpPathRefreshTimer (RSVP_TIMER *);
 
 E_RC
 RsvpPathRefresh (PSB * pPsb)
 {
   E_RC rc = E_OK;
-  zlog_info ("entering RsvpPathRefresh");
-  zlog_info ("Session.Dest %x .TunnelId %x .ExtTunnelId %x .Src %x .LspId %x",
-	     pPsb->PsbKey.Session.Dest,
-	     pPsb->PsbKey.Session.TunnelId,
-	     pPsb->PsbKey.Session.ExtTunelId,
-	     pPsb->PsbKey.SenderTemplate.IpAddr,
-	     pPsb->PsbKey.SenderTemplate.LspId);
+  RSVP_TRACE ("entering RsvpPathRefresh");
+  RSVP_TRACE ("Session.Dest %x .TunnelId %x .ExtTunnelId %x .Src %x .LspId %x",
+	      pPsb->PsbKey.Session.Dest,
+	      pPsb->PsbKey.Session.TunnelId,
+	      pPsb->PsbKey.Session.ExtTunelId,
+	      pPsb->PsbKey.SenderTemplate.IpAddr,
+	      pPsb->PsbKey.SenderTemplate.LspId);
   if ((pPsb->pSentBuffer == NULL) || (pPsb->SentBufferLen == 0))
     {
       if (EncodeAndSendRsvpPathMessage (&pPsb->OldPacket,
@@ -168,7 +168,9 @@ RsvpPathRefresh (PSB * pPsb)
 	  rc = E_ERR;
 	}
     }
-  else
+  else if (RsvpRrRefresh (&pPsb->MsgIdState, PATH_MSG, pPsb, pPsb->NextHop,
+			  pPsb->OutIfIndex, &pPsb->pSentBuffer,
+			  &pPsb->SentBufferLen) != TRUE)
     {
       if (SendRawData
 	  (pPsb->pSentBuffer, pPsb->SentBufferLen, pPsb->NextHop,
@@ -190,26 +192,48 @@ RsvpPathRefresh (PSB * pPsb)
       zlog_err ("Cannot add timer %s %d", __FILE__, __LINE__);
       rc = E_ERR;
     }
-  zlog_info ("leaving RsvpPathRefresh");
+  RSVP_TRACE ("leaving RsvpPathRefresh");
   return rc;
 }
 
+/* Refresh of the PSB by a MESSAGE_ID listed in an Srefresh */
+E_RC
+RsvpPathSummaryRefresh (PSB_KEY * pPsbKey)
+{
+  PSB *pPsb;
+
+  if (((pPsb = FindPsb (pPsbKey)) == NULL) || (pPsb->AgeOutTimer == NULL))
+    return E_ERR;
+  if (StopPathAgeOutTimer (&pPsb->AgeOutTimer) != E_OK)
+    {
+      zlog_err ("Cannot stop Ageout timer");
+      return E_ERR;
+    }
+  if (StartPathAgeOutTimer (pPsb->AgeOutValue, &pPsb->AgeOutTimer, pPsb)
+      != E_OK)
+    {
+      zlog_err ("Cannot start AgeOut timer ");
+      return E_ERR;
+    }
+  return E_OK;
+}
+
 static int
-RsvpPathRefreshTimer (struct thread *thread)
+RsvpPathRefreshTimer (RSVP_TIMER * pTimer)
 {
-  PSB *pPsb = THREAD_ARG (thread);
+  PSB *pPsb = RSVP_TIMER_ARG (pTimer);
   if (pPsb == NULL)
     {
       zlog_err ("pPsb is NULL %s %d", __FILE__, __LINE__);
       return;
     }
-  zlog_info ("entering RsvpPathRefreshTimer");
-  memset (&pPsb->PathRefreshTimer, 0, sizeof (struct thread *));
+  RSVP_TRACE ("entering RsvpPathRefreshTimer");
+  memset (&pPsb->PathRefreshTimer, 0, sizeof (RSVP_TIMER *));
   if (RsvpPathRefresh (pPsb) != E_OK)
     {
       zlog_err ("an error o RsvpPathRefresh");
     }
-  zlog_info ("leaving RsvpPathRefreshTimer");
+  RSVP_TRACE ("leaving RsvpPathRefreshTimer");
 }
 
 E_RC
@@ -224,13 +248,13 @@ RsvpPathPopERO (RSVP_PKT * pRsvpPkt)
       switch (pErSubObj->SubObjHdr.LType & 0x7F)
 	{
 	case ERO_SUBTYPE_IPV4:
-	  zlog_info ("checking for abstract node %x",
-		     pErSubObj->u.Ipv4.IpAddress);
+	  RSVP_TRACE ("checking for abstract node %x",
+		      pErSubObj->u.Ipv4.IpAddress);
 	  if (IsAbstractNode
 	      (pErSubObj->u.Ipv4.IpAddress,
 	       pErSubObj->u.Ipv4.PrefixLength) == TRUE)
 	    {
-	      zlog_info ("FOUND...");
+	      RSVP_TRACE ("FOUND...");
 	      if (pErSubObjPrev == NULL)
 		{
 		  pRsvpPkt->ReceivedEro.er = pRsvpPkt->ReceivedEro.er->next;
@@ -270,9 +294,9 @@ CompareERO (ER_SUBOBJ * pErSubObj1, ER_SUBOBJ * pErSubObj2, uns16 HopsNum)
 	      if (memcmp (&pErSubObj1->u.Ipv4,
 			  &pErSubObj2->u.Ipv4, sizeof (ER_IPV4_SUBOBJ)) != 0)
 		{
-		  zlog_info ("IP address differs %x %x...",
-			     pErSubObj1->u.Ipv4.IpAddress,
-			     pErSubObj2->u.Ipv4.IpAddress);
+		  RSVP_TRACE ("IP address differs %x %x...",
+			      pErSubObj1->u.Ipv4.IpAddress,
+			      pErSubObj2->u.Ipv4.IpAddress);
 		  return TRUE;
 		}
 	      break;
@@ -299,21 +323,21 @@ CompareERO (ER_SUBOBJ * pErSubObj1, ER_SUBOBJ * pErSubObj2, uns16 HopsNum)
        (pErSubObj2 != NULL)) ||
       ((pErSubObj1 != NULL) && (pErSubObj2 == NULL)))
     {
-      zlog_info ("Number of elements differs...");
+      RSVP_TRACE ("Number of elements differs...");
       return TRUE;
     }
   return FALSE;
 }
 
 static int
-RsvpPathAgeOut (struct thread *thread)
+RsvpPathAgeOut (RSVP_TIMER * pTimer)
 {
-  PSB *pPsb = THREAD_ARG (thread);
+  PSB *pPsb = RSVP_TIMER_ARG (pTimer);
 
-  zlog_info ("entering RsvpPathAgeOut");
+  RSVP_TRACE ("entering RsvpPathAgeOut");
 
   // jleu: timer is not rescheduled
-  memset (&pPsb->AgeOutTimer, 0, sizeof (struct thread *));
+  memset (&pPsb->AgeOutTimer, 0, sizeof (RSVP_TIMER *));
 
   if (pPsb->OutIfIndex != 0)
     {
@@ -330,7 +354,7 @@ RsvpPathAgeOut (struct thread *thread)
       zlog_err ("an error on DeleteSender %s %d", __FILE__, __LINE__);
     }
   RsvpStatistics.PsbAgeOutCount++;
-  zlog_info ("leaving RsvpPathAgeOut");
+  RSVP_TRACE ("leaving RsvpPathAgeOut");
 }
 
 uns8
@@ -347,17 +371,17 @@ ProcessRsvpPathMessage (RSVP_PKT * pRsvpPkt, uns32 IfIndex,
   PSB_KEY PsbKey;
   RSVP_PKT_QUEUE *pQueuedItem;
   uns8 ApplicationTrapFlag = FALSE;
-  zlog_info ("entering ProcessRsvpPathMessage");
+  RSVP_TRACE ("entering ProcessRsvpPathMessage");
   RsvpStatistics.PathMsgCount++;
   memset (&PsbKey, 0, sizeof (PSB_KEY));
 
   PsbKey.Session = pRsvpPkt->Session;
   PsbKey.SenderTemplate = pRsvpPkt->SenderTemplate;
-  zlog_info ("Session.Dest %x .TunnelId %x .ExtTunnelId %x .Src %x .LspId %x",
-	     PsbKey.Session.Dest,
-	     PsbKey.Session.TunnelId,
-	     PsbKey.Session.ExtTunelId,
-	     PsbKey.SenderTemplate.IpAddr, PsbKey.SenderTemplate.LspId);
+  RSVP_TRACE ("Session.Dest %x .TunnelId %x .ExtTunnelId %x .Src %x .LspId %x",
+	      PsbKey.Session.Dest,
+	      PsbKey.Session.TunnelId,
+	      PsbKey.Session.ExtTunelId,
+	      PsbKey.SenderTemplate.IpAddr, PsbKey.SenderTemplate.LspId);
   if ((pPsb = FindPsb (&PsbKey)) == NULL)
     {
       if ((pPsb = NewPsb (&PsbKey)) == NULL)
@@ -439,7 +463,7 @@ ProcessRsvpPathMessage (RSVP_PKT * pRsvpPkt, uns32 IfIndex,
       val = (2 * RefreshMultiple + 1) * val;
       /* and divide by 4 to get (M + 0.5) * (1.5 * R) */
       pPsb->AgeOutValue = val >> 2;
-      zlog_info ("AgeOut value %d", pPsb->AgeOutValue);
+      RSVP_TRACE ("AgeOut value %d", pPsb->AgeOutValue);
     }
 
   if (memcmp (&pRsvpPkt->ReceivedRsvpHop,
@@ -457,25 +481,25 @@ ProcessRsvpPathMessage (RSVP_PKT * pRsvpPkt, uns32 IfIndex,
 	      sizeof (SENDER_TSPEC_OBJ));
       ApplicationTrapFlag = TRUE;
     }
-  zlog_info ("popping ERO...");
+  RSVP_TRACE ("popping ERO...");
   if (RsvpPathPopERO (pRsvpPkt) != E_OK)
     {
       zlog_err ("Cannot pop ERO");
       FreeRsvpPkt (pRsvpPkt);
       return E_ERR;
     }
-  zlog_info ("comparing ERO...");
+  RSVP_TRACE ("comparing ERO...");
   if (CompareERO (pPsb->OldPacket.ReceivedEro.er,
 		  pRsvpPkt->ReceivedEro.er, 0) == TRUE)
     {
-      zlog_info ("not equal...");
+      RSVP_TRACE ("not equal...");
       pPsb->PathRefreshFlag = TRUE;
     }
-  zlog_info ("comparing ERO...");
+  RSVP_TRACE ("comparing ERO...");
   if (CompareERO (pPsb->OldPacket.ReceivedEro.er,
 		  pRsvpPkt->ReceivedEro.er, 1) == TRUE)
     {
-      zlog_info ("not equal...");
+      RSVP_TRACE ("not equal...");
       ApplicationTrapFlag = TRUE;
     }
   if (pPsb->OldPacket.SessionAttributes.CType ==
@@ -600,7 +624,7 @@ ProcessRsvpPathMessage (RSVP_PKT * pRsvpPkt, uns32 IfIndex,
 	    }
 	  else
 	    {
-	      zlog_info ("Egress reached");
+	      RSVP_TRACE ("Egress reached");
 	      if (StartPathAgeOutTimer
 		  (pPsb->AgeOutValue, &pPsb->AgeOutTimer, pPsb) != E_OK)
 		{
@@ -616,7 +640,7 @@ ProcessRsvpPathMessage (RSVP_PKT * pRsvpPkt, uns32 IfIndex,
 	    {
 	      zlog_err ("Cannot stop PathRefresh timer");
 	    }
-	  zlog_info ("Locking Flow %s %d", __FILE__, __LINE__);
+	  RSVP_TRACE ("Locking Flow %s %d", __FILE__, __LINE__);
 	  pPsb->TE_InProcess = TRUE;
 	  pPsb->PathRefreshFlag = FALSE;
 	  PrepareAndSendMsg2TE (pPsb);
@@ -646,11 +670,11 @@ ProcessRsvpPathMessage (RSVP_PKT * pRsvpPkt, uns32 IfIndex,
     }
   if (pPsb->ResvRefreshFlag == TRUE)
     {
-      zlog_info ("RESV refresh will be called here");
+      RSVP_TRACE ("RESV refresh will be called here");
       pPsb->ResvRefreshFlag = FALSE;
     }
   FreeRsvpPkt (pRsvpPkt);
-  zlog_info ("leaving ProcessRsvpPathMessage");
+  RSVP_TRACE ("leaving ProcessRsvpPathMessage");
   return E_OK;
 }
 
@@ -661,19 +685,19 @@ ProcessTEMsgUponPath (TE_API_MSG * pMsg)
   PSB *pPsb;
 
   uns8 FrwChangeFlag = FALSE;
-  zlog_info ("entering ProcessTEMsgUponPath");
+  RSVP_TRACE ("entering ProcessTEMsgUponPath");
   memset (&PsbKey, 0, sizeof (PSB_KEY));
   PsbKey = pMsg->u.PathNotification.PsbKey;
 
-  zlog_info ("Session.Dest %x .TunnelId %x .ExtTunnelId %x .Src %x .LspId %x",
-	     PsbKey.Session.Dest,
-	     PsbKey.Session.TunnelId,
-	     PsbKey.Session.ExtTunelId,
-	     PsbKey.SenderTemplate.IpAddr, PsbKey.SenderTemplate.LspId);
+  RSVP_TRACE ("Session.Dest %x .TunnelId %x .ExtTunnelId %x .Src %x .LspId %x",
+	      PsbKey.Session.Dest,
+	      PsbKey.Session.TunnelId,
+	      PsbKey.Session.ExtTunelId,
+	      PsbKey.SenderTemplate.IpAddr, PsbKey.SenderTemplate.LspId);
 
   if ((pPsb = FindPsb (&PsbKey)) != NULL)
     {
-      zlog_info ("UnLocking Flow %s %d", __FILE__, __LINE__);
+      RSVP_TRACE ("UnLocking Flow %s %d", __FILE__, __LINE__);
       pPsb->TE_InProcess = FALSE;
       if (pMsg->u.PathNotification.rc != PATH_PROC_OK)
 	{
@@ -773,7 +797,7 @@ ProcessTEMsgUponPath (TE_API_MSG * pMsg)
 	    }
 	  else
 	    {
-	      zlog_info ("NHOP %x", pPsb->OldPacket.SentRsvpHop.PHop);
+	      RSVP_TRACE ("NHOP %x", pPsb->OldPacket.SentRsvpHop.PHop);
 	    }
 	  if (pPsb->pSentBuffer)
 	    {
@@ -790,14 +814,14 @@ ProcessTEMsgUponPath (TE_API_MSG * pMsg)
 	}
       RsvpPathRefresh (pPsb);
       PsbDequeueAndInvokeMessages (pPsb);
-      zlog_info ("leaving ProcessTEMsgUponPath+");
+      RSVP_TRACE ("leaving ProcessTEMsgUponPath+");
       return E_OK;
     }
   else
     {
       zlog_debug ("cannot find PSB");
     }
-  zlog_info ("leaving ProcessTEMsgUponPath-");
+  RSVP_TRACE ("leaving ProcessTEMsgUponPath-");
   return E_ERR;
 }
 
@@ -924,14 +948,14 @@ DeleteSender (PSB * pPsb)
   FILTER_LIST *pFilterList, *pFilterListPrev = NULL;
   FILTER_SPEC_DATA *pFilterSpecData = NULL;
   int Shared = 0;
-  zlog_info ("entering DeleteSender");
-  zlog_info ("Session.Dest %x .TunnelId %x .ExtTunnelId %x .Src %x .LspId %x",
-	     pPsb->PsbKey.Session.Dest,
-	     pPsb->PsbKey.Session.TunnelId,
-	     pPsb->PsbKey.Session.ExtTunelId,
-	     pPsb->PsbKey.SenderTemplate.IpAddr,
-	     pPsb->PsbKey.SenderTemplate.LspId);
-  zlog_info ("pPsb %x pRsb %x", pPsb, pPsb->pRsb);
+  RSVP_TRACE ("entering DeleteSender");
+  RSVP_TRACE ("Session.Dest %x .TunnelId %x .ExtTunnelId %x .Src %x .LspId %x",
+	      pPsb->PsbKey.Session.Dest,
+	      pPsb->PsbKey.Session.TunnelId,
+	      pPsb->PsbKey.Session.ExtTunelId,
+	      pPsb->PsbKey.SenderTemplate.IpAddr,
+	      pPsb->PsbKey.SenderTemplate.LspId);
+  RSVP_TRACE ("pPsb %x pRsb %x", pPsb, pPsb->pRsb);
   if ((pRsb = pPsb->pRsb) == NULL)
     {
       RSB_KEY RsbKey;
@@ -944,23 +968,23 @@ DeleteSender (PSB * pPsb)
       if ((pRsb->OldPacket.Style.OptionVector2 & 0x001F) == SE_STYLE_BITS)
 	{
 	  Shared = 1;
-	  zlog_info ("Shared %s %d", __FILE__, __LINE__);
+	  RSVP_TRACE ("Shared %s %d", __FILE__, __LINE__);
 	}
       else
 	{
-	  zlog_info ("Not Shared %s %d", __FILE__, __LINE__);
+	  RSVP_TRACE ("Not Shared %s %d", __FILE__, __LINE__);
 	}
       pFilterList = pRsb->OldPacket.pFilterList;
-      zlog_info ("searching for filter data");
+      RSVP_TRACE ("searching for filter data");
       while (pFilterList != NULL)
 	{
 	  if ((pFilterSpecData = pFilterList->pFilterSpecData) != NULL)
 	    {
-	      zlog_info ("%x %x %x %x",
-			 pPsb->PsbKey.SenderTemplate.IpAddr,
-			 pPsb->PsbKey.SenderTemplate.LspId,
-			 pFilterSpecData->FilterSpec.IpAddr,
-			 pFilterSpecData->FilterSpec.LspId);
+	      RSVP_TRACE ("%x %x %x %x",
+			  pPsb->PsbKey.SenderTemplate.IpAddr,
+			  pPsb->PsbKey.SenderTemplate.LspId,
+			  pFilterSpecData->FilterSpec.IpAddr,
+			  pFilterSpecData->FilterSpec.LspId);
 	      if (memcmp (&pPsb->PsbKey.SenderTemplate,
 			  &pFilterSpecData->FilterSpec,
 			  sizeof (FILTER_SPEC_OBJ)) == 0)
@@ -1019,10 +1043,10 @@ DeleteSender (PSB * pPsb)
   if (DeletePsb (pPsb) != E_OK)
     {
       zlog_info ("Cannot delete PSB %s %d", __FILE__, __LINE__);
-      zlog_info ("leaving DeleteSender-");
+      RSVP_TRACE ("leaving DeleteSender-");
       return E_ERR;
     }
-  zlog_info ("leaving DeleteSender+");
+  RSVP_TRACE ("leaving DeleteSender+");
   return E_OK;
 }
 
@@ -1033,7 +1057,7 @@ ProcessRsvpPathTearMessage (RSVP_PKT * pRsvpPkt, uns32 IfIndex,
   PSB *pPsb;
   PSB_KEY PsbKey;
   RSVP_PKT_QUEUE *pQueuedItem;
-  zlog_info ("entering ProcessRsvpPathTearMessage");
+  RSVP_TRACE ("entering ProcessRsvpPathTearMessage");
 
   RsvpStatistics.PathTearMsgCount++;
   memset (&PsbKey, 0, sizeof (PSB_KEY));
@@ -1041,15 +1065,15 @@ ProcessRsvpPathTearMessage (RSVP_PKT * pRsvpPkt, uns32 IfIndex,
   PsbKey.Session = pRsvpPkt->Session;
   PsbKey.SenderTemplate = pRsvpPkt->SenderTemplate;
 
-  zlog_info ("Session.Dest %x .TunnelId %x .ExtTunnelId %x .Src %x .LspId %x",
-	     PsbKey.Session.Dest,
-	     PsbKey.Session.TunnelId,
-	     PsbKey.Session.ExtTunelId,
-	     PsbKey.SenderTemplate.IpAddr, PsbKey.SenderTemplate.LspId);
+  RSVP_TRACE ("Session.Dest %x .TunnelId %x .ExtTunnelId %x .Src %x .LspId %x",
+	      PsbKey.Session.Dest,
+	      PsbKey.Session.TunnelId,
+	      PsbKey.Session.ExtTunelId,
+	      PsbKey.SenderTemplate.IpAddr, PsbKey.SenderTemplate.LspId);
 
   if ((pPsb = FindPsb (&PsbKey)) == NULL)
     {
-      zlog_info ("leaving ProcessRsvpPathTearMessage");
+      RSVP_TRACE ("leaving ProcessRsvpPathTearMessage");
       FreeRsvpPkt (pRsvpPkt);
       return E_OK;
     }
@@ -1101,18 +1125,18 @@ ProcessRsvpPathErrMessage (RSVP_PKT * pRsvpPkt, uns32 IfIndex,
   PSB *pPsb;
   PSB_KEY PsbKey;
 
-  zlog_info ("entering ProcessRsvpPathErrMessage");
+  RSVP_TRACE ("entering ProcessRsvpPathErrMessage");
   RsvpStatistics.PathErrMsgCount++;
   memset (&PsbKey, 0, sizeof (PSB_KEY));
 
   PsbKey.Session = pRsvpPkt->Session;
   PsbKey.SenderTemplate = pRsvpPkt->SenderTemplate;
 
-  zlog_info ("Session.Dest %x .TunnelId %x .ExtTunnelId %x .Src %x .LspId %x",
-	     PsbKey.Session.Dest,
-	     PsbKey.Session.TunnelId,
-	     PsbKey.Session.ExtTunelId,
-	     PsbKey.SenderTemplate.IpAddr, PsbKey.SenderTemplate.LspId);
+  RSVP_TRACE ("Session.Dest %x .TunnelId %x .ExtTunnelId %x .Src %x .LspId %x",
+	      PsbKey.Session.Dest,
+	      PsbKey.Session.TunnelId,
+	      PsbKey.Session.ExtTunelId,
+	      PsbKey.SenderTemplate.IpAddr, PsbKey.SenderTemplate.LspId);
 
   if ((pPsb = FindPsb (&PsbKey)) == NULL)
     {
@@ -1121,7 +1145,7 @@ ProcessRsvpPathErrMessage (RSVP_PKT * pRsvpPkt, uns32 IfIndex,
     }
   if (pPsb->InIfIndex == 0)
     {
-      zlog_info ("Ingress: PathErr received");
+      RSVP_TRACE ("Ingress: PathErr received");
       PrepareAndSendPathErrNotificationMsg2TE (pPsb, &pRsvpPkt->ErrorSpec);
     }
   else
@@ -1138,41 +1162,38 @@ ProcessRsvpPathErrMessage (RSVP_PKT * pRsvpPkt, uns32 IfIndex,
 }
 
 static E_RC
-StartPathAgeOutTimer (uns32 time, struct thread **pTimerId, void *data)
+StartPathAgeOutTimer (uns32 time, RSVP_TIMER ** pTimerId, void *data)
 {
-  zlog_info ("entering StartPathAgeOutTimer");
-  *pTimerId = thread_add_timer (master, RsvpPathAgeOut, data, time);
-  THREAD_VAL (*pTimerId) = time;
-  zlog_info ("leaving StartPathAgeOutTimer");
+  RSVP_TRACE ("entering StartPathAgeOutTimer");
+  RsvpTimerAdd (RsvpPathAgeOut, data, time, pTimerId);
+  RSVP_TRACE ("leaving StartPathAgeOutTimer");
   return E_OK;
 }
 
 static E_RC
-StopPathAgeOutTimer (struct thread **pTimerId)
+StopPathAgeOutTimer (RSVP_TIMER ** pTimerId)
 {
-  zlog_info ("entering StopPathAgeOutTimer");
-  thread_cancel (*pTimerId);
-  *pTimerId = NULL;
-  zlog_info ("leaving StopPathAgeOutTimer");
+  RSVP_TRACE ("entering StopPathAgeOutTimer");
+  RsvpTimerCancel (pTimerId);
+  RSVP_TRACE ("leaving StopPathAgeOutTimer");
   return E_OK;
 }
 
 static E_RC
-StartPathRefreshTimer (uns32 time, struct thread **pTimerId, void *data)
+StartPathRefreshTimer (uns32 time, RSVP_TIMER ** pTimerId, void *data)
 {
-  zlog_info ("entering StartPathRefreshTimer");
-  *pTimerId = thread_add_timer (master, RsvpPathRefreshTimer, data, time);
-  zlog_info ("leaving StartPathRefreshTimer");
+  RSVP_TRACE ("entering StartPathRefreshTimer");
+  RsvpTimerAdd (RsvpPathRefreshTimer, data, time, pTimerId);
+  RSVP_TRACE ("leaving StartPathRefreshTimer");
   return E_OK;
 }
 
 static E_RC
-StopPathRefreshTimer (struct thread **pTimerId)
+StopPathRefreshTimer (RSVP_TIMER ** pTimerId)
 {
-  zlog_info ("entering StopPathRefreshTimer");
-  thread_cancel (*pTimerId);
-  *pTimerId = NULL;
-  zlog_info ("leaving StopPathRefreshTimer");
+  RSVP_TRACE ("entering StopPathRefreshTimer");
+  RsvpTimerCancel (pTimerId);
+  RSVP_TRACE ("leaving StopPathRefreshTimer");
   return E_OK;
 }
 
@@ -1185,7 +1206,7 @@ PrepareAndSendLabelReleaseMsg2TE (PSB * pPsb)
   msg.NotificationType = LABEL_RELEASE_NOTIFICATION;
   msg.u.LabelRelease.PsbKey = pPsb->PsbKey;
   msg.u.LabelRelease.Label = pPsb->Label;
-  zlog_info ("sending message to TE upon RESV");
+  RSVP_TRACE ("sending message to TE upon RESV");
   rsvp_send_msg (&msg, sizeof (msg));
 }
 
@@ -1199,7 +1220,7 @@ PrepareAndSendPathErrNotificationMsg2TE (PSB * pPsb,
   msg.NotificationType = PATH_ERR_NOTIFICATION;
   msg.u.PathErrNotification.PsbKey = pPsb->PsbKey;
   msg.u.PathErrNotification.ErrSpec = *pErrSpecObj;
-  zlog_info ("sending message to TE upon RESV");
+  RSVP_TRACE ("sending message to TE upon RESV");
   rsvp_send_msg (&msg, sizeof (msg));
 }
 
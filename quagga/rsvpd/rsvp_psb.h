@@ -14,14 +14,15 @@ typedef struct _psb_
   uns32 Label;
   IPV4_ADDR NextHop;
   uns32 RefreshValue;
-  struct thread *PathRefreshTimer;
+  RSVP_TIMER *PathRefreshTimer;
   uns32 AgeOutValue;
-  struct thread *AgeOutTimer;
+  RSVP_TIMER *AgeOutTimer;
   uns8 PathRefreshFlag;
   uns8 ResvRefreshFlag;
   uns8 TE_InProcess;
   char *pSentBuffer;
   uns16 SentBufferLen;
+  RSVP_MSG_ID_STATE MsgIdState;
   struct _rsb_ *pRsb;
   FILTER_SPEC_DATA *pFilterSpecData;
   struct _rsvp_pkt_queue_ *packet_queue;
@@ -41,6 +42,7 @@ PSB *GetNextPSB (PSB_KEY * pPsbKey);
 PSB *FindPsb (PSB_KEY * pPsbKey);
 PSB *NewPsb (PSB_KEY * pPsbKey);
 E_RC RsvpPathRefresh (PSB * pPsb);
+E_RC RsvpPathSummaryRefresh (PSB_KEY * pPsbKey);
 E_RC InitRsvpPathMessageProcessing ();
 E_RC ProcessTEMsgUponPath (struct _te_api_msg_ *pMsg);
 E_RC RemovePsb (PSB_KEY * pPsbKey);
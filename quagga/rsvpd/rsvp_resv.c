@@ -26,7 +26,10 @@ static void PrepareAndSendBWReleaseMsg2TE (PSB * pPsb, uns8 Priority,
 static void PrepareAndSendResvTearNotificationMsg2TE (RSB * pRsb,
 						      FILTER_SPEC_OBJ *
 						      pFilterSpec);
-E_RC StartBlocadeTimer (uns32 time, struct thread **pTimerId, void *data);
+E_RC StartBlocadeTimer (uns32 time, RSVP_TIMER ** pTimerId, void *data);
+E_RC StartFilterAgeOutTimer (uns32 time, RSVP_TIMER ** pTimerId,
+			     void *data);
+E_RC StopFilterAgeOutTimer (RSVP_TIMER ** pTimerId);
 
 RSB *
 NewRSB (RSB_KEY * pRsbKey)
@@ -179,7 +182,7 @@ DeletePHopResvRefreshList (RSB * pRsb,
 {
   PHOP_RESV_REFRESH_LIST *pPHopResvRefreshList2 =
     pRsb->pPHopResvRefreshList, *pPHopResvRefreshListPrev = NULL;
-  zlog_info ("entering DeletePHopResvRefreshList");
+  RSVP_TRACE ("entering DeletePHopResvRefreshList");
   while (pPHopResvRefreshList2 != NULL)
     {
       if (pPHopResvRefreshList2 == pPHopResvRefreshList)
@@ -192,18 +195,19 @@ DeletePHopResvRefreshList (RSB * pRsb,
 	    {
 	      pPHopResvRefreshListPrev->next = pPHopResvRefreshList2->next;
 	    }
+	  RsvpRrReleaseMsgId (&pPHopResvRefreshList2->MsgIdState);
 	  if (pPHopResvRefreshList2->pAddedRro)
 	    XFREE (MTYPE_RSVP, pPHopResvRefreshList2->pAddedRro);
 	  if (pPHopResvRefreshList2->pSentBuffer)
 	    XFREE (MTYPE_RSVP, pPHopResvRefreshList2->pSentBuffer);
 	  XFREE (MTYPE_RSVP, pPHopResvRefreshList2);
-	  zlog_info ("leaving DeletePHopResvRefreshList+");
+	  RSVP_TRACE ("leaving DeletePHopResvRefreshList+");
 	  return E_OK;
 	}
       pPHopResvRefreshListPrev = pPHopResvRefreshList2;
       pPHopResvRefreshList2 = pPHopResvRefreshList2->next;
     }
-  zlog_info ("leaving DeletePHopResvRefreshList-");
+  RSVP_TRACE ("leaving DeletePHopResvRefreshList-");
   return E_ERR;
 }
 
@@ -211,7 +215,7 @@ EFFECTIVE_FLOW *
 GetOrCreateEffectiveFlow (RSB * pRsb, uns32 IfIndex)
 {
   EFFECTIVE_FLOW *pEffectiveFlow, *pEffectiveFlowPrev = NULL;
-  zlog_info ("entering GetOrCreateEffectiveFlow");
+  RSVP_TRACE ("entering GetOrCreateEffectiveFlow");
   pEffectiveFlow = pRsb->pEffectiveFlow;
   while (pEffectiveFlow != NULL)
     {
@@ -223,7 +227,7 @@ GetOrCreateEffectiveFlow (RSB * pRsb, uns32 IfIndex)
     }
   if (pEffectiveFlow != NULL)
     {
-      zlog_info ("leaving GetOrCreateEffectiveFlow(1)");
+      RSVP_TRACE ("leaving GetOrCreateEffectiveFlow(1)");
       return pEffectiveFlow;
     }
   if ((pEffectiveFlow =
@@ -244,7 +248,7 @@ GetOrCreateEffectiveFlow (RSB * pRsb, uns32 IfIndex)
     {
       pEffectiveFlowPrev->next = pEffectiveFlow;
     }
-  zlog_info ("leaving GetOrCreateEffectiveFlow(2)");
+  RSVP_TRACE ("leaving GetOrCreateEffectiveFlow(2)");
   return pEffectiveFlow;
 }
 
@@ -253,7 +257,7 @@ DeleteEffectiveFlow (RSB * pRsb, EFFECTIVE_FLOW * pEffectiveFlow)
 {
   EFFECTIVE_FLOW *pEffectiveFlow2 =
     pRsb->pEffectiveFlow, *pEffectiveFlowPrev = NULL;
-  zlog_info ("entering DeleteEffectiveFlow");
+  RSVP_TRACE ("entering DeleteEffectiveFlow");
   while (pEffectiveFlow2 != NULL)
     {
       if (pEffectiveFlow2 == pEffectiveFlow)
@@ -267,13 +271,13 @@ DeleteEffectiveFlow (RSB * pRsb, EFFECTIVE_FLOW * pEffectiveFlow)
 	      pEffectiveFlowPrev->next = pEffectiveFlow2->next;
 	    }
 	  XFREE (MTYPE_RSVP, pEffectiveFlow2);
-	  zlog_info ("leaving DeleteEffectiveFlow+");
+	  RSVP_TRACE ("leaving DeleteEffectiveFlow+");
 	  return E_OK;
 	}
       pEffectiveFlowPrev = pEffectiveFlow2;
       pEffectiveFlow2 = pEffectiveFlow2->next;
     }
-  zlog_info ("leaving DeleteEffectiveFlow-");
+  RSVP_TRACE ("leaving DeleteEffectiveFlow-");
   return E_ERR;
 }
 
@@ -282,7 +286,7 @@ DeleteFilterListNode (FILTER_LIST ** ppFilterList,
 		      FILTER_SPEC_DATA * pFilterSpecData)
 {
   FILTER_LIST *pFilterList, *pFilterListPrev = NULL;
-  zlog_info ("entering DeleteFilterListNode");
+  RSVP_TRACE ("entering DeleteFilterListNode");
   if (ppFilterList == NULL)
     {
       return E_OK;
@@ -310,7 +314,7 @@ DeleteFilterListNode (FILTER_LIST ** ppFilterList,
       pFilterListPrev->next = pFilterList->next;
     }
   XFREE (MTYPE_RSVP, pFilterList);
-  zlog_info ("leaving DeleteFilterListNode");
+  RSVP_TRACE ("leaving DeleteFilterListNode");
   return E_OK;
 }
 
@@ -319,7 +323,7 @@ NewFilterListNode (FILTER_LIST ** ppFilterListHead,
 		   FILTER_SPEC_DATA * pFilterSpecData)
 {
   FILTER_LIST *pFilterList = *ppFilterListHead, *pFilterListPrev = NULL;
-  zlog_info ("entering NewFilterListNode");
+  RSVP_TRACE ("entering NewFilterListNode");
   while (pFilterList != NULL)
     {
       if (pFilterList->pFilterSpecData == pFilterSpecData)
@@ -346,7 +350,7 @@ NewFilterListNode (FILTER_LIST ** ppFilterListHead,
     {
       pFilterListPrev->next = pFilterList;
     }
-  zlog_info ("leaving NewFilterListNode");
+  RSVP_TRACE ("leaving NewFilterListNode");
   return E_OK;
 }
 
@@ -518,10 +522,10 @@ CheckAndSetFlowSpecObj (PSB * pPsb, FLOW_SPEC_OBJ * pFilterFlowSpec,
 }
 
 static int
-BlocadeTimerExpiry (struct thread *thread)
+BlocadeTimerExpiry (RSVP_TIMER * pTimer)
 {
-  FILTER_SPEC_DATA *pFilterSpecData = THREAD_ARG (thread);
-  memset (&pFilterSpecData->BlocadeTimer, 0, sizeof (struct thread *));
+  FILTER_SPEC_DATA *pFilterSpecData = RSVP_TIMER_ARG (pTimer);
+  memset (&pFilterSpecData->BlocadeTimer, 0, sizeof (RSVP_TIMER *));
   pFilterSpecData->Blocked = FALSE;
   if ((pFilterSpecData->pPsb->pRsb->OldPacket.Style.OptionVector2 & 0x001F) ==
       SE_STYLE_BITS)
@@ -543,32 +547,32 @@ BlocadeTimerExpiry (struct thread *thread)
 	    }
 	  return;
 	}
-      zlog_info ("Locking Flow %x %x %x %x %x %s %d",
-		 pFilterSpecData->pPsb->pRsb->RsbKey.Session.Dest,
-		 pFilterSpecData->pPsb->pRsb->RsbKey.Session.TunnelId,
-		 pFilterSpecData->pPsb->pRsb->RsbKey.Session.ExtTunelId,
-		 pFilterSpecData->FilterSpec.IpAddr,
-		 pFilterSpecData->FilterSpec.LspId, __FILE__, __LINE__);
+      RSVP_TRACE ("Locking Flow %x %x %x %x %x %s %d",
+		  pFilterSpecData->pPsb->pRsb->RsbKey.Session.Dest,
+		  pFilterSpecData->pPsb->pRsb->RsbKey.Session.TunnelId,
+		  pFilterSpecData->pPsb->pRsb->RsbKey.Session.ExtTunelId,
+		  pFilterSpecData->FilterSpec.IpAddr,
+		  pFilterSpecData->FilterSpec.LspId, __FILE__, __LINE__);
       pFilterSpecData->pPsb->TE_InProcess = TRUE;
       PrepareAndSendMsg2TE4FF (pFilterSpecData->pPsb->pRsb, pFilterSpecData);
     }
 }
 
 static int
-FilterAgeOut (struct thread *thread)
+FilterAgeOut (RSVP_TIMER * pTimer)
 {
-  FILTER_SPEC_DATA *pFilterSpecData = THREAD_ARG (thread);
+  FILTER_SPEC_DATA *pFilterSpecData = RSVP_TIMER_ARG (pTimer);
   RSB *pRsb;
   PSB *pPsb;
   uns8 Shared = 0;
 
-  zlog_info ("entering FilterAgeOut");
+  RSVP_TRACE ("entering FilterAgeOut");
   if (pFilterSpecData == NULL)
     {
       zlog_err ("pFilterSpecData == NULL %s %d", __FILE__, __LINE__);
       return;
     }
-  memset (&pFilterSpecData->AgeOutTimer, 0, sizeof (struct thread *));
+  memset (&pFilterSpecData->AgeOutTimer, 0, sizeof (RSVP_TIMER *));
   if (pFilterSpecData->pPsb == NULL)
     {
       zlog_err ("pFilterSpecData->pPsb == NULL %s %d", __FILE__, __LINE__);
@@ -580,12 +584,12 @@ FilterAgeOut (struct thread *thread)
 		__LINE__);
       return;
     }
-  zlog_info ("Session.Dest %x .TunnelId %x .ExtTunnelId %x Src %x LspId %x",
-	     pFilterSpecData->pPsb->pRsb->RsbKey.Session.Dest,
-	     pFilterSpecData->pPsb->pRsb->RsbKey.Session.TunnelId,
-	     pFilterSpecData->pPsb->pRsb->RsbKey.Session.ExtTunelId,
-	     pFilterSpecData->FilterSpec.IpAddr,
-	     pFilterSpecData->FilterSpec.LspId);
+  RSVP_TRACE ("Session.Dest %x .TunnelId %x .ExtTunnelId %x Src %x LspId %x",
+	      pFilterSpecData->pPsb->pRsb->RsbKey.Session.Dest,
+	      pFilterSpecData->pPsb->pRsb->RsbKey.Session.TunnelId,
+	      pFilterSpecData->pPsb->pRsb->RsbKey.Session.ExtTunelId,
+	      pFilterSpecData->FilterSpec.IpAddr,
+	      pFilterSpecData->FilterSpec.LspId);
   if ((pRsb->OldPacket.Style.OptionVector2 & 0x001F) == SE_STYLE_BITS)
     {
       Shared = 1;
@@ -625,108 +629,155 @@ FilterAgeOut (struct thread *thread)
       FreeRSB (pRsb);
     }
   RsvpStatistics.FilterAgeOutCount++;
-  zlog_info ("leaving FilterAgeOut");
+  RSVP_TRACE ("leaving FilterAgeOut");
 }
 
-static int
-PHopResvRefreshTimeOut (struct thread *thread)
+E_RC
+ResvRefreshPHop (PHOP_RESV_REFRESH_LIST * pPhopResvRefreshList)
 {
-  PHOP_RESV_REFRESH_LIST *pPhopResvRefreshList = THREAD_ARG (thread);
-  FILTER_LIST *pFilterList;
+  FILTER_LIST *pFilterList = pPhopResvRefreshList->pFilterList;
   FILTER_SPEC_DATA *pFilterSpecData;
   RSB *pRsb;
-  zlog_info ("entering PHopResvRefreshTimeOut");
-  if (pPhopResvRefreshList == NULL)
-    {
-      zlog_err ("pPhopResvRefreshList == NULL %s %d", __FILE__, __LINE__);
-      zlog_info ("leaving PHopResvRefreshTimeOut-");
-      return;
-    }
-  pFilterList = pPhopResvRefreshList->pFilterList;
-  memset (&pPhopResvRefreshList->ResvRefreshTimer, 0,
-	  sizeof (struct thread *));
+
   if (pFilterList == NULL)
     {
       zlog_err ("pFilterList == NULL!!! %s %d", __FILE__, __LINE__);
-      return;
+      return E_ERR;
     }
   if ((pFilterSpecData = pFilterList->pFilterSpecData) == NULL)
     {
       zlog_err ("pFilterSpecData == NULL!!! %s %d", __FILE__, __LINE__);
-      return;
+      return E_ERR;
     }
   if (pFilterSpecData->pPsb == NULL)
     {
       zlog_err ("pFilterSpecData->pPsb == NULL!!! %s %d", __FILE__, __LINE__);
-      return;
+      return E_ERR;
     }
   if ((pRsb = pFilterSpecData->pPsb->pRsb) == NULL)
     {
       zlog_err ("pFilterSpecData->pPsb->pRsb == NULL!!! %s %d", __FILE__,
 		__LINE__);
+      return E_ERR;
+    }
+  return ResvRefreshProc (pRsb, pPhopResvRefreshList);
+}
+
+static int
+PHopResvRefreshTimeOut (RSVP_TIMER * pTimer)
+{
+  PHOP_RESV_REFRESH_LIST *pPhopResvRefreshList = RSVP_TIMER_ARG (pTimer);
+  RSVP_TRACE ("entering PHopResvRefreshTimeOut");
+  if (pPhopResvRefreshList == NULL)
+    {
+      zlog_err ("pPhopResvRefreshList == NULL %s %d", __FILE__, __LINE__);
+      RSVP_TRACE ("leaving PHopResvRefreshTimeOut-");
       return;
     }
-  if (ResvRefreshProc (pRsb, pPhopResvRefreshList) != E_OK)
+  memset (&pPhopResvRefreshList->ResvRefreshTimer, 0,
+	  sizeof (RSVP_TIMER *));
+  if (ResvRefreshPHop (pPhopResvRefreshList) != E_OK)
     {
       zlog_err ("An error on ResvRefreshProc %s %d", __FILE__, __LINE__);
     }
-  zlog_info ("leaving PHopResvRefreshTimeOut+");
+  RSVP_TRACE ("leaving PHopResvRefreshTimeOut+");
 }
 
+/* Refresh of the filters reserved by a Resv whose MESSAGE_ID is listed
+   in an Srefresh */
 E_RC
-StartPHopResvRefreshTimer (uns32 time, struct thread **pTimerId, void *data)
+RsvpResvSummaryRefresh (RSB_KEY * pRsbKey, FILTER_SPEC_OBJ * pFilterSpecs,
+			uns32 Count)
 {
-  zlog_info ("entering StartPHopResvRefreshTimer");
-  *pTimerId = thread_add_timer (master, PHopResvRefreshTimeOut, data, time);
-  zlog_info ("leaving StartPHopResvRefreshTimer");
+  RSB *pRsb;
+  FILTER_LIST *pFilterList;
+  FILTER_SPEC_DATA *pFilterSpecData;
+  uns32 i, Refreshed = 0;
+
+  if ((pRsb = FindRsb (pRsbKey)) == NULL)
+    return E_ERR;
+  for (pFilterList = pRsb->OldPacket.pFilterList; pFilterList != NULL;
+       pFilterList = pFilterList->next)
+    {
+      if ((pFilterSpecData = pFilterList->pFilterSpecData) == NULL)
+	continue;
+      for (i = 0; i < Count; i++)
+	{
+	  if ((pFilterSpecData->FilterSpec.IpAddr != pFilterSpecs[i].IpAddr)
+	      || (pFilterSpecData->FilterSpec.LspId != pFilterSpecs[i].LspId))
+	    continue;
+	  /* blocked filters age out on their own */
+	  if ((pFilterSpecData->Blocked == TRUE) ||
+	      (pFilterSpecData->AgeOutTimer == NULL))
+	    break;
+	  if (StopFilterAgeOutTimer (&pFilterSpecData->AgeOutTimer) != E_OK)
+	    {
+	      zlog_err ("Cannot stop timer %s %d", __FILE__, __LINE__);
+	    }
+	  if (StartFilterAgeOutTimer (pFilterSpecData->AgeOutValue,
+				      &pFilterSpecData->AgeOutTimer,
+				      pFilterSpecData) != E_OK)
+	    {
+	      zlog_err ("Cannot add timer %s %d", __FILE__, __LINE__);
+	    }
+	  Refreshed++;
+	  break;
+	}
+    }
+  return (Refreshed == Count) ? E_OK : E_ERR;
+}
+
+E_RC
+StartPHopResvRefreshTimer (uns32 time, RSVP_TIMER ** pTimerId, void *data)
+{
+  RSVP_TRACE ("entering StartPHopResvRefreshTimer");
+  RsvpTimerAdd (PHopResvRefreshTimeOut, data, time, pTimerId);
+  RSVP_TRACE ("leaving StartPHopResvRefreshTimer");
   return E_OK;
 }
 
 E_RC
-StopPHopResvRefreshTimer (struct thread * *pTimerId)
+StopPHopResvRefreshTimer (RSVP_TIMER ** pTimerId)
 {
-  zlog_info ("entering StopPHopResvRefreshTimer");
-  thread_cancel (*pTimerId);
-  *pTimerId = NULL;
-  zlog_info ("leaving StopPHopResvRefreshTimer");
+  RSVP_TRACE ("entering StopPHopResvRefreshTimer");
+  RsvpTimerCancel (pTimerId);
+  RSVP_TRACE ("leaving StopPHopResvRefreshTimer");
   return E_OK;
 }
 
 E_RC
-StartFilterAgeOutTimer (uns32 time, struct thread * *pTimerId, void *data)
+StartFilterAgeOutTimer (uns32 time, RSVP_TIMER ** pTimerId, void *data)
 {
-  zlog_info ("entering StartFilterAgeOutTimer");
-  *pTimerId = thread_add_timer (master, FilterAgeOut, data, time);
-  zlog_info ("leaving StartFilterAgeOutTimer");
+  RSVP_TRACE ("entering StartFilterAgeOutTimer");
+  RsvpTimerAdd (FilterAgeOut, data, time, pTimerId);
+  RSVP_TRACE ("leaving StartFilterAgeOutTimer");
   return E_OK;
 }
 
 E_RC
-StopFilterAgeOutTimer (struct thread * *pTimerId)
+StopFilterAgeOutTimer (RSVP_TIMER ** pTimerId)
 {
-  zlog_info ("entering StopFilterAgeOutTimer");
-  thread_cancel (*pTimerId);
-  *pTimerId = NULL;
-  zlog_info ("leaving StopFilterAgeOutTimer");
+  RSVP_TRACE ("entering StopFilterAgeOutTimer");
+  RsvpTimerCancel (pTimerId);
+  RSVP_TRACE ("leaving StopFilterAgeOutTimer");
   return E_OK;
 }
 
 E_RC
-StartBlocadeTimer (uns32 time, struct thread * *pTimerId, void *data)
+StartBlocadeTimer (uns32 time, RSVP_TIMER ** pTimerId, void *data)
 {
-  zlog_info ("entering StartBlocadeTimer");
-  *pTimerId = thread_add_timer (master, BlocadeTimerExpiry, data, time);
-  zlog_info ("leaving StartBlocadeTimer");
+  RSVP_TRACE ("entering StartBlocadeTimer");
+  RsvpTimerAdd (BlocadeTimerExpiry, data, time, pTimerId);
+  RSVP_TRACE ("leaving StartBlocadeTimer");
   return E_OK;
 }
 
 E_RC
-StopBlocadeTimer (struct thread * *pTimerId)
+StopBlocadeTimer (RSVP_TIMER ** pTimerId)
 {
-  zlog_info ("entering StopBlocadeTimer");
-  thread_cancel (*pTimerId);
-  *pTimerId = NULL;
-  zlog_info ("leaving StopBlocadeTimer");
+  RSVP_TRACE ("entering StopBlocadeTimer");
+  RsvpTimerCancel (pTimerId);
+  RSVP_TRACE ("leaving StopBlocadeTimer");
   return E_OK;
 }
 
@@ -734,10 +785,10 @@ static E_RC
 ResvRefreshProc (RSB * pRsb, PHOP_RESV_REFRESH_LIST * pPHopResvRefreshList)
 {
   RSVP_PKT RsvpPkt;
-  zlog_info ("entering ResvRefreshProc");
-  zlog_info ("Session.Dest %x .TunnelId %x .ExtTunnelId %x",
-	     pRsb->RsbKey.Session.Dest,
-	     pRsb->RsbKey.Session.TunnelId, pRsb->RsbKey.Session.ExtTunelId);
+  RSVP_TRACE ("entering ResvRefreshProc");
+  RSVP_TRACE ("Session.Dest %x .TunnelId %x .ExtTunnelId %x",
+	      pRsb->RsbKey.Session.Dest,
+	      pRsb->RsbKey.Session.TunnelId, pRsb->RsbKey.Session.ExtTunelId);
   if (pPHopResvRefreshList == NULL)
     {
       zlog_err ("ResvRefreshProc: pPHopResvRefreshList is NULL");
@@ -775,7 +826,12 @@ ResvRefreshProc (RSB * pRsb, PHOP_RESV_REFRESH_LIST * pPHopResvRefreshList)
 	  return E_ERR;
 	}
     }
-  else
+  else if (RsvpRrRefresh (&pPHopResvRefreshList->MsgIdState, RESV_MSG,
+			  pPHopResvRefreshList,
+			  ntohl (pPHopResvRefreshList->PHop.PHop),
+			  pPHopResvRefreshList->pFilterList->pFilterSpecData->
+			  pPsb->InIfIndex, &pPHopResvRefreshList->pSentBuffer,
+			  &pPHopResvRefreshList->SentBufferLen) != TRUE)
     {
       if (SendRawData (pPHopResvRefreshList->pSentBuffer,
 		       pPHopResvRefreshList->SentBufferLen,
@@ -801,7 +857,7 @@ ResvRefreshProc (RSB * pRsb, PHOP_RESV_REFRESH_LIST * pPHopResvRefreshList)
       zlog_err ("Cannot start timer %s %d", __FILE__, __LINE__);
       return E_ERR;
     }
-  zlog_info ("leaving ResvRefreshProc");
+  RSVP_TRACE ("leaving ResvRefreshProc");
   return E_OK;
 }
 
@@ -1029,10 +1085,10 @@ ProcessEffectiveFlows (RSB * pRsb)
 {
   EFFECTIVE_FLOW *pEffectiveFlow = pRsb->pEffectiveFlow;
   uns8 NewFlow;
-  zlog_info ("entering ProcessEffectiveFlows");
-  zlog_info ("Session.Dest %x .TunnelId %x .ExtTunnelId %x",
-	     pRsb->RsbKey.Session.Dest,
-	     pRsb->RsbKey.Session.TunnelId, pRsb->RsbKey.Session.ExtTunelId);
+  RSVP_TRACE ("entering ProcessEffectiveFlows");
+  RSVP_TRACE ("Session.Dest %x .TunnelId %x .ExtTunnelId %x",
+	      pRsb->RsbKey.Session.Dest,
+	      pRsb->RsbKey.Session.TunnelId, pRsb->RsbKey.Session.ExtTunelId);
   while (pEffectiveFlow != NULL)
     {
       if ((pEffectiveFlow->MustBeProcessed) &&
@@ -1048,20 +1104,20 @@ ProcessEffectiveFlows (RSB * pRsb)
 	      FLOW_SPEC_OBJ *pFlowSpec;
 	      if (pFilterList->pFilterSpecData != NULL)
 		{
-		  zlog_info ("processing filter spec %x %x",
-			     pFilterList->pFilterSpecData->FilterSpec.IpAddr,
-			     pFilterList->pFilterSpecData->FilterSpec.LspId);
+		  RSVP_TRACE ("processing filter spec %x %x",
+			      pFilterList->pFilterSpecData->FilterSpec.IpAddr,
+			      pFilterList->pFilterSpecData->FilterSpec.LspId);
 
 		  if (pFilterList->pFilterSpecData->NewFlowSpecValid)
 		    {
 		      pFlowSpec = &pFilterList->pFilterSpecData->NewFlowSpec;
 		      NewFlow = TRUE;
-		      zlog_info ("New");
+		      RSVP_TRACE ("New");
 		    }
 		  else
 		    {
 		      pFlowSpec = &pFilterList->pFilterSpecData->FlowSpec;
-		      zlog_info ("Not new");
+		      RSVP_TRACE ("Not new");
 		    }
 
 		  if (pEffectiveFlowSpec->ServHdr.ServHdr == 0)
@@ -1072,8 +1128,8 @@ ProcessEffectiveFlows (RSB * pRsb)
 		  if (FlowSpec1GreaterThanFlowSpec2
 		      (pFlowSpec, pEffectiveFlowSpec) == TRUE)
 		    {
-		      zlog_info ("Setting Effective flow's BW to %f",
-				 pFlowSpec->u.CtrlLoad.PeakDataRate);
+		      RSVP_TRACE ("Setting Effective flow's BW to %f",
+				  pFlowSpec->u.CtrlLoad.PeakDataRate);
 		      *pEffectiveFlowSpec = *pFlowSpec;
 		    }
 		}
@@ -1106,13 +1162,13 @@ ProcessEffectiveFlows (RSB * pRsb)
 	    }
 	  else
 	    {
-	      zlog_info ("no change...");
+	      RSVP_TRACE ("no change...");
 	    }
 	  pEffectiveFlow->MustBeProcessed = 0;
 	}
       pEffectiveFlow = pEffectiveFlow->next;
     }
-  zlog_info ("leaving ProcessEffectiveFlows");
+  RSVP_TRACE ("leaving ProcessEffectiveFlows");
   return E_OK;
 }
 
@@ -1123,10 +1179,10 @@ ProcessReceivedFilterSpecs (RSB * pRsb, RSVP_PKT * pRsvpPkt)
   FILTER_LIST *pFilterList, *pFilterListPrev = NULL, *pFilterListNext;
   uns8 ItemExtracted;
   int Shared = 0;
-  zlog_info ("entering ProcessReceivedFilterSpecs");
-  zlog_info ("Session.Dest %x .TunnelId %x .ExtTunnelId %x",
-	     pRsb->RsbKey.Session.Dest,
-	     pRsb->RsbKey.Session.TunnelId, pRsb->RsbKey.Session.ExtTunelId);
+  RSVP_TRACE ("entering ProcessReceivedFilterSpecs");
+  RSVP_TRACE ("Session.Dest %x .TunnelId %x .ExtTunnelId %x",
+	      pRsb->RsbKey.Session.Dest,
+	      pRsb->RsbKey.Session.TunnelId, pRsb->RsbKey.Session.ExtTunelId);
   if ((pRsvpPkt->Style.OptionVector2 & 0x001F) == SE_STYLE_BITS)
     {
       Shared = 1;
@@ -1183,7 +1239,7 @@ ProcessReceivedFilterSpecs (RSB * pRsb, RSVP_PKT * pRsvpPkt)
 		      && (pRsbFilterList->pFilterSpecData->FilterSpec.LspId ==
 			  pFilterList->pFilterSpecData->FilterSpec.LspId))
 		    {
-		      zlog_info ("existing filter spec found");
+		      RSVP_TRACE ("existing filter spec found");
 		      Found = 1;
 
 		      if ((pRsbFilterList->pFilterSpecData->pPsb)
@@ -1301,7 +1357,7 @@ ProcessReceivedFilterSpecs (RSB * pRsb, RSVP_PKT * pRsvpPkt)
 			  (pFilterSpecData->pEffectiveFlow !=
 			   pRsbFilterList->pFilterSpecData->pEffectiveFlow))
 			{
-			  zlog_info
+			  RSVP_TRACE
 			    ("Deletion of filter_spec from effective_flow list .Src %x .LspId %x",
 			     pFilterSpecData->FilterSpec.IpAddr,
 			     pFilterSpecData->FilterSpec.LspId);
@@ -1396,7 +1452,7 @@ ProcessReceivedFilterSpecs (RSB * pRsb, RSVP_PKT * pRsvpPkt)
 			    1;
 			  pRsbFilterList->pFilterSpecData->NewFlowSpec =
 			    pFilterList->pFilterSpecData->NewFlowSpec;
-			  zlog_info
+			  RSVP_TRACE
 			    ("Adding filter_spec to effective_flow list .Src %x .LspId %x",
 			     pFilterSpecData->FilterSpec.IpAddr,
 			     pFilterSpecData->FilterSpec.LspId);
@@ -1491,7 +1547,7 @@ ProcessReceivedFilterSpecs (RSB * pRsb, RSVP_PKT * pRsvpPkt)
 				   &pFilterList->pFilterSpecData->
 				   NewFlowSpec) == TRUE)
 				{
-				  zlog_info
+				  RSVP_TRACE
 				    ("Locking Flow %x %x %x %x %x %s %d",
 				     pRsbFilterList->pFilterSpecData->pPsb->
 				     pRsb->RsbKey.Session.Dest,
@@ -1531,17 +1587,17 @@ ProcessReceivedFilterSpecs (RSB * pRsb, RSVP_PKT * pRsvpPkt)
 
 	  if (Found == 0)
 	    {
-	      zlog_info ("the filter spec is new %x %x",
-			 pFilterSpecData, pFilterSpecData->pPsb);
+	      RSVP_TRACE ("the filter spec is new %x %x",
+			  pFilterSpecData, pFilterSpecData->pPsb);
 	      PsbKey.SenderTemplate.IpAddr =
 		pFilterSpecData->FilterSpec.IpAddr;
 	      PsbKey.SenderTemplate.LspId = pFilterSpecData->FilterSpec.LspId;
-	      zlog_info ("%x %x %x %x %x %s %d",
-			 PsbKey.Session.Dest,
-			 PsbKey.Session.TunnelId,
-			 PsbKey.Session.ExtTunelId,
-			 PsbKey.SenderTemplate.IpAddr,
-			 PsbKey.SenderTemplate.LspId, __FILE__, __LINE__);
+	      RSVP_TRACE ("%x %x %x %x %x %s %d",
+			  PsbKey.Session.Dest,
+			  PsbKey.Session.TunnelId,
+			  PsbKey.Session.ExtTunelId,
+			  PsbKey.SenderTemplate.IpAddr,
+			  PsbKey.SenderTemplate.LspId, __FILE__, __LINE__);
 	      if ((pFilterSpecData->pPsb = FindPsb (&PsbKey)) == NULL)
 		{
 		  zlog_err ("cannot find PSB %s %d", __FILE__, __LINE__);
@@ -1615,25 +1671,25 @@ ProcessReceivedFilterSpecs (RSB * pRsb, RSVP_PKT * pRsvpPkt)
 	      pFilterSpecData->pPsb->pFilterSpecData = pFilterSpecData;
 	      {
 		uns32 val;
-		zlog_info ("TimeValue %x", pRsvpPkt->TimeValues.TimeValues);
+		RSVP_TRACE ("TimeValue %x", pRsvpPkt->TimeValues.TimeValues);
 		val = (uns32) pRsvpPkt->TimeValues.TimeValues / 10000;
-		zlog_info ("val %x", val);
+		RSVP_TRACE ("val %x", val);
 		/* 3*R: */
 		val *= 3;
-		zlog_info ("val %x", val);
+		RSVP_TRACE ("val %x", val);
 		/* (2M+1) * (3*R): */
 		val = (2 * ResvRefreshMultiple + 1) * val;
-		zlog_info ("val %x", val);
+		RSVP_TRACE ("val %x", val);
 		/* and divide by 4 to get (M + 0.5) * (1.5 * R) */
 		pFilterSpecData->AgeOutValue = val >> 2;
 		//pFilterSpecData->AgeOutValue = 1;
-		zlog_info ("AgeOut value %d", pFilterSpecData->AgeOutValue);
+		RSVP_TRACE ("AgeOut value %d", pFilterSpecData->AgeOutValue);
 	      }
 	      pFilterSpecData->SentLabel.Label = pFilterSpecData->pPsb->Label;
 
 	      if (Shared)
 		{
-		  zlog_info ("and shared...");
+		  RSVP_TRACE ("and shared...");
 		  if ((pFilterSpecData->pEffectiveFlow =
 		       GetOrCreateEffectiveFlow (pRsb,
 						 pFilterSpecData->pPsb->
@@ -1699,7 +1755,7 @@ ProcessReceivedFilterSpecs (RSB * pRsb, RSVP_PKT * pRsvpPkt)
 		      goto outer_loop_cont;
 		    }
 		  pFilterSpecData->pEffectiveFlow->MustBeProcessed = 1;
-		  zlog_info
+		  RSVP_TRACE
 		    ("Adding filter_spec to effective_flow list .Src %x .LspId %x",
 		     pFilterSpecData->FilterSpec.IpAddr,
 		     pFilterSpecData->FilterSpec.LspId);
@@ -1724,14 +1780,14 @@ ProcessReceivedFilterSpecs (RSB * pRsb, RSVP_PKT * pRsvpPkt)
 		  pFilterList->next = pRsb->OldPacket.pFilterList;
 		  pRsb->OldPacket.pFilterList = pFilterList;
 		  /* send notification to TE */
-		  zlog_info ("Locking Flow %x %x %x %x %x %s %d",
-			     pFilterSpecData->pPsb->pRsb->RsbKey.Session.Dest,
-			     pFilterSpecData->pPsb->pRsb->RsbKey.Session.
-			     TunnelId,
-			     pFilterSpecData->pPsb->pRsb->RsbKey.Session.
-			     ExtTunelId, pFilterSpecData->FilterSpec.IpAddr,
-			     pFilterSpecData->FilterSpec.LspId, __FILE__,
-			     __LINE__);
+		  RSVP_TRACE ("Locking Flow %x %x %x %x %x %s %d",
+			      pFilterSpecData->pPsb->pRsb->RsbKey.Session.Dest,
+			      pFilterSpecData->pPsb->pRsb->RsbKey.Session.
+			      TunnelId,
+			      pFilterSpecData->pPsb->pRsb->RsbKey.Session.
+			      ExtTunelId, pFilterSpecData->FilterSpec.IpAddr,
+			      pFilterSpecData->FilterSpec.LspId, __FILE__,
+			      __LINE__);
 		  pFilterSpecData->pPsb->TE_InProcess = TRUE;
 		  PrepareAndSendMsg2TE4FF (pRsb,
 					   pFilterList->pFilterSpecData);
@@ -1763,7 +1819,7 @@ ProcessReceivedFilterSpecs (RSB * pRsb, RSVP_PKT * pRsvpPkt)
 	  return E_ERR;
 	}
     }
-  zlog_info ("leaving ProcessReceivedFilterSpecs");
+  RSVP_TRACE ("leaving ProcessReceivedFilterSpecs");
   return E_OK;
 }
 
@@ -1790,7 +1846,7 @@ BuildRRSubObj (FILTER_SPEC_DATA * pFilterSpecData)
 	RRO_SUBTYPE_IPV4;
       pFilterSpecData->pPHopResvRefreshList->pAddedRro->SubObjHdr.Length = 8;
       pFilterSpecData->pPHopResvRefreshList->pAddedRro->u.Ipv4.PrefixLen = 32;
-      zlog_info ("inside of BuildRRSubObj %s %d...", __FILE__, __LINE__);
+      RSVP_TRACE ("inside of BuildRRSubObj %s %d...", __FILE__, __LINE__);
       if (IpAddrGetByIfIndex (pPsb->InIfIndex, &IpAddr) != E_OK)
 	{
 	  zlog_err ("Cannot set RSVP HOP %s %d", __FILE__, __LINE__);
@@ -1818,7 +1874,7 @@ BuildRRSubObj (FILTER_SPEC_DATA * pFilterSpecData)
 	}
       if (LabelRecordingDesired == 1)
 	{
-	  zlog_info ("inside of BuildRRSubObj %s %d...", __FILE__, __LINE__);
+	  RSVP_TRACE ("inside of BuildRRSubObj %s %d...", __FILE__, __LINE__);
 	  if ((pFilterSpecData->pPHopResvRefreshList->pAddedRro->next =
 	       (RR_SUBOBJ *) XMALLOC (MTYPE_RSVP,
 				      sizeof (RR_SUBOBJ))) == NULL)
@@ -1852,7 +1908,7 @@ ProcessPHopFilterSpecLists (RSB * pRsb, uns8 Shared)
   PHOP_RESV_REFRESH_LIST *pPHopResvRefreshList;
   FILTER_LIST *pFilterList;
   int FlowCount = 0;
-  zlog_info ("entering ProcessPHopFilterSpecLists");
+  RSVP_TRACE ("entering ProcessPHopFilterSpecLists");
   pPHopResvRefreshList = pRsb->pPHopResvRefreshList;
   while (pPHopResvRefreshList != NULL)
     {
@@ -1915,7 +1971,7 @@ ProcessPHopFilterSpecLists (RSB * pRsb, uns8 Shared)
       pPHopResvRefreshList = pPHopResvRefreshList->next;
     }
 
-  zlog_info ("leaving ProcessPHopFilterSpecLists");
+  RSVP_TRACE ("leaving ProcessPHopFilterSpecLists");
   return E_OK;
 }
 
@@ -1926,7 +1982,7 @@ ProcessForwardedSEFilterSpecsByIfIndex (RSB * pRsb, uns32 IfIndex)
   PSB *pPsb;
   uns8 Ingress = FALSE;
   EFFECTIVE_FLOW *pEffectiveFlow = pRsb->pEffectiveFlow;
-  zlog_info ("entering ProcessForwardedSEFilterSpecsByIfIndex");
+  RSVP_TRACE ("entering ProcessForwardedSEFilterSpecsByIfIndex");
   while (pEffectiveFlow != NULL)
     {
       if (pEffectiveFlow->IfIndex == IfIndex)
@@ -1979,7 +2035,7 @@ ProcessForwardedSEFilterSpecsByIfIndex (RSB * pRsb, uns32 IfIndex)
 
 	      if (pFilterSpecData->pPsb->InIfIndex == 0)
 		{
-		  zlog_info ("Congratulations: RESV has reached Ingress!!");
+		  RSVP_TRACE ("Congratulations: RESV has reached Ingress!!");
 		  Ingress = TRUE;
 		}
 	    }
@@ -2014,7 +2070,7 @@ ProcessFailedSEFilterSpecsByIfIndex (RSB * pRsb, uns32 IfIndex)
   EFFECTIVE_FLOW *pEffectiveFlow = pRsb->pEffectiveFlow;
   RSVP_PKT RsvpPkt;
   IPV4_ADDR NHop = 0;
-  zlog_info ("entering ProcessFailedSEFilterSpecsByIfIndex");
+  RSVP_TRACE ("entering ProcessFailedSEFilterSpecsByIfIndex");
   memset (&RsvpPkt, 0, sizeof (RSVP_PKT));
   RsvpPkt.Session = pRsb->RsbKey.Session;
   RsvpPkt.Style = pRsb->OldPacket.Style;
@@ -2122,7 +2178,7 @@ ProcessForwardedFFFilterSpec (RSB * pRsb, FILTER_SPEC_OBJ * pFilterSpecObj)
   PSB *pPsb;
   FILTER_SPEC_DATA *pFilterSpecData = NULL;
   FILTER_LIST *pFilterList = pRsb->OldPacket.pFilterList;
-  zlog_info ("entering ProcessForwardedFFFilterSpec");
+  RSVP_TRACE ("entering ProcessForwardedFFFilterSpec");
   while (pFilterList != NULL)
     {
       if ((pFilterSpecData = pFilterList->pFilterSpecData) != NULL)
@@ -2178,7 +2234,7 @@ ProcessForwardedFFFilterSpec (RSB * pRsb, FILTER_SPEC_OBJ * pFilterSpecObj)
 	}
       return ProcessPHopFilterSpecLists (pRsb, 0);
     }
-  zlog_info ("leaving ProcessForwardedFFFilterSpec");
+  RSVP_TRACE ("leaving ProcessForwardedFFFilterSpec");
   return E_ERR;
 }
 
@@ -2187,7 +2243,7 @@ ProcessFailedFFFilterSpec (RSB * pRsb, FILTER_SPEC_OBJ * pFilterSpecObj)
 {
   FILTER_SPEC_DATA *pFilterSpecData = NULL;
   FILTER_LIST *pFilterList = pRsb->OldPacket.pFilterList;
-  zlog_info ("entering ProcessFailedFFFilterSpec");
+  RSVP_TRACE ("entering ProcessFailedFFFilterSpec");
   while (pFilterList != NULL)
     {
       if ((pFilterSpecData = pFilterList->pFilterSpecData) != NULL)
@@ -2247,7 +2303,7 @@ ProcessFailedFFFilterSpec (RSB * pRsb, FILTER_SPEC_OBJ * pFilterSpecObj)
 	}
       return ProcessPHopFilterSpecLists (pRsb, 0);
     }
-  zlog_info ("leaving ProcessFailedFFFilterSpec");
+  RSVP_TRACE ("leaving ProcessFailedFFFilterSpec");
   return E_ERR;
 }
 
@@ -2256,14 +2312,14 @@ ProcessRsvpResvMessage (RSVP_PKT * pRsvpPkt)
 {
   RSB *pRsb;
   RSB_KEY RsbKey;
-  zlog_info ("entering ProcessRsvpResvMessage");
+  RSVP_TRACE ("entering ProcessRsvpResvMessage");
   RsvpStatistics.ResvMsgCount++;
   memset (&RsbKey, 0, sizeof (RSB_KEY));
   RsbKey.Session = pRsvpPkt->Session;
 
-  zlog_info ("Session.Dest %x .TunnelId %x .ExtTunnelId %x",
-	     RsbKey.Session.Dest,
-	     RsbKey.Session.TunnelId, RsbKey.Session.ExtTunelId);
+  RSVP_TRACE ("Session.Dest %x .TunnelId %x .ExtTunnelId %x",
+	      RsbKey.Session.Dest,
+	      RsbKey.Session.TunnelId, RsbKey.Session.ExtTunelId);
 
   if ((pRsb = FindRsb (&RsbKey)) == NULL)
     {
@@ -2325,7 +2381,7 @@ ProcessRsvpResvMessage (RSVP_PKT * pRsvpPkt)
       pRsb = NULL;
     }
   FreeRsvpPkt (pRsvpPkt);
-  zlog_info ("leaving ProcessRsvpResvMessage");
+  RSVP_TRACE ("leaving ProcessRsvpResvMessage");
   return E_OK;
 }
 
@@ -2409,19 +2465,19 @@ PrepareAndSendMsg2TE4SE (RSB * pRsb, EFFECTIVE_FLOW * pEffectiveFlow)
 	      msg.u.ResvNotification.u.FilterDataSE.FilterDataArraySE[i].
 		AllocatedLabel = pFilterSpecData->pPsb->Label;
 	      i++;
-	      zlog_info ("Locking Flow %x %x %x %x %x %s %d",
-			 pFilterSpecData->pPsb->pRsb->RsbKey.Session.Dest,
-			 pFilterSpecData->pPsb->pRsb->RsbKey.Session.TunnelId,
-			 pFilterSpecData->pPsb->pRsb->RsbKey.Session.
-			 ExtTunelId, pFilterSpecData->FilterSpec.IpAddr,
-			 pFilterSpecData->FilterSpec.LspId, __FILE__,
-			 __LINE__);
+	      RSVP_TRACE ("Locking Flow %x %x %x %x %x %s %d",
+			  pFilterSpecData->pPsb->pRsb->RsbKey.Session.Dest,
+			  pFilterSpecData->pPsb->pRsb->RsbKey.Session.TunnelId,
+			  pFilterSpecData->pPsb->pRsb->RsbKey.Session.
+			  ExtTunelId, pFilterSpecData->FilterSpec.IpAddr,
+			  pFilterSpecData->FilterSpec.LspId, __FILE__,
+			  __LINE__);
 	      pFilterSpecData->pPsb->TE_InProcess = TRUE;
 	    }
 	}
     }
   msg.u.ResvNotification.u.FilterDataSE.FilterSpecNumber = i;
-  zlog_info ("sending message to TE upon RESV");
+  RSVP_TRACE ("sending message to TE upon RESV");
   rsvp_send_msg (&msg, sizeof (msg));
 }
 
@@ -2483,7 +2539,7 @@ PrepareAndSendMsg2TE4FF (RSB * pRsb, FILTER_SPEC_DATA * pFilterSpecData)
       msg.u.ResvNotification.u.FilterDataFF.SetupPrio =
 	pFilterSpecData->pPsb->OldPacket.SessionAttributes.u.SessAttr.SetPrio;
     }
-  zlog_info ("sending message to TE upon RESV FF");
+  RSVP_TRACE ("sending message to TE upon RESV FF");
   rsvp_send_msg (&msg, sizeof (msg));
 }
 
@@ -2551,12 +2607,12 @@ ResvTeMsgProc (TE_API_MSG * pMsg)
   RSB *pRsb;
   FILTER_LIST *pFilterList;
   int i;
-  zlog_info ("response from TE");
+  RSVP_TRACE ("response from TE");
   memset (&RsbKey, 0, sizeof (RSB_KEY));
   RsbKey = pMsg->u.ResvNotification.RsbKey;
-  zlog_info ("Session.Dest %x .TunnelId %x .ExtTunnelId %x",
-	     RsbKey.Session.Dest,
-	     RsbKey.Session.TunnelId, RsbKey.Session.ExtTunelId);
+  RSVP_TRACE ("Session.Dest %x .TunnelId %x .ExtTunnelId %x",
+	      RsbKey.Session.Dest,
+	      RsbKey.Session.TunnelId, RsbKey.Session.ExtTunelId);
   if ((pRsb =
        (RSB *) patricia_tree_get (&ResbTree, (const uns8 *) &RsbKey)) == NULL)
     {
@@ -2579,9 +2635,9 @@ ResvTeMsgProc (TE_API_MSG * pMsg)
 			  FilterDataArraySE[i].FilterSpec,
 			  sizeof (FILTER_SPEC_OBJ)) == 0)
 		{
-		  zlog_info ("Found FilterSpec %x %x",
-			     pFilterList->pFilterSpecData->FilterSpec.IpAddr,
-			     pFilterList->pFilterSpecData->FilterSpec.LspId);
+		  RSVP_TRACE ("Found FilterSpec %x %x",
+			      pFilterList->pFilterSpecData->FilterSpec.IpAddr,
+			      pFilterList->pFilterSpecData->FilterSpec.LspId);
 		  break;
 		}
 	      pFilterList = pFilterList->next;
@@ -2589,9 +2645,9 @@ ResvTeMsgProc (TE_API_MSG * pMsg)
 	  if ((pFilterList != NULL)
 	      && (pFilterList->pFilterSpecData->pPsb->TE_InProcess == TRUE))
 	    {
-	      zlog_info ("Unlocking FilterSpec %x %x",
-			 pFilterList->pFilterSpecData->FilterSpec.IpAddr,
-			 pFilterList->pFilterSpecData->FilterSpec.LspId);
+	      RSVP_TRACE ("Unlocking FilterSpec %x %x",
+			  pFilterList->pFilterSpecData->FilterSpec.IpAddr,
+			  pFilterList->pFilterSpecData->FilterSpec.LspId);
 	      pFilterList->pFilterSpecData->pPsb->TE_InProcess = FALSE;
 	    }
 	}
@@ -2644,7 +2700,7 @@ ResvTeMsgProc (TE_API_MSG * pMsg)
 	}
     }
   RsbDequeueAndInvokeMessages (pRsb);
-  zlog_info ("done...");
+  RSVP_TRACE ("done...");
   return E_OK;
 }
 
@@ -2652,7 +2708,7 @@ E_RC
 FilterShutDown (FILTER_SPEC_DATA * pFilterSpecData, int Shared)
 {
   uns8 Priority;
-  zlog_info ("entering FilterShutDown");
+  RSVP_TRACE ("entering FilterShutDown");
   if (pFilterSpecData == NULL)
     {
       zlog_err ("pFilterSpecData == NULL %s %d", __FILE__, __LINE__);
@@ -2668,7 +2724,7 @@ FilterShutDown (FILTER_SPEC_DATA * pFilterSpecData, int Shared)
 	     pRsb->RsbKey.Session.ExtTunelId,
 	     pFilterSpecData->FilterSpec.IpAddr,
 	     pFilterSpecData->FilterSpec.LspId);
-    zlog_info ("Session and filter: %s", buffer);
+    RSVP_TRACE ("Session and filter: %s", buffer);
   }
   if (StopFilterAgeOutTimer (&pFilterSpecData->AgeOutTimer) != E_OK)
     {
@@ -2684,7 +2740,7 @@ FilterShutDown (FILTER_SPEC_DATA * pFilterSpecData, int Shared)
   if ((pFilterSpecData->pPsb->InIfIndex != 0) &&
       (pFilterSpecData->pPHopResvRefreshList != NULL))
     {
-      zlog_info ("Not Ingress...");
+      RSVP_TRACE ("Not Ingress...");
 
       pFilterSpecData->pPHopResvRefreshList->MustBeProcessed = 1;
       if (pFilterSpecData->pPHopResvRefreshList->pSentBuffer != NULL)
@@ -2721,14 +2777,14 @@ FilterShutDown (FILTER_SPEC_DATA * pFilterSpecData, int Shared)
   else if (pFilterSpecData->pPsb->pRsb != NULL)
 #endif
     {
-      zlog_info
+      RSVP_TRACE
 	("PHopFilterList is NULL while not Ingress (TE may be in progress)");
       PrepareAndSendResvTearNotificationMsg2TE (pFilterSpecData->pPsb->pRsb,
 						&pFilterSpecData->FilterSpec);
     }
   if (pFilterSpecData->pPsb->OutIfIndex != 0)
     {
-      zlog_info ("Not Egress...");
+      RSVP_TRACE ("Not Egress...");
       if (Shared)
 	{
 	  if (DeleteFilterListNode
@@ -2805,7 +2861,7 @@ FilterShutDown (FILTER_SPEC_DATA * pFilterSpecData, int Shared)
   pFilterSpecData->pPsb->pRsb = NULL;
   pFilterSpecData->pPsb->pFilterSpecData = NULL;
   FreeFilterSpecData (&pFilterSpecData);
-  zlog_info ("leaving FilterShutDown");
+  RSVP_TRACE ("leaving FilterShutDown");
   return E_OK;
 }
 
@@ -2815,7 +2871,7 @@ ForwardResvTearMsg (RSB * pRsb)
   RSVP_PKT RsvpPkt;
   PHOP_RESV_REFRESH_LIST *pPHopResvRefreshList = pRsb->pPHopResvRefreshList;
 
-  zlog_info ("entering ForwardResvTearMsg");
+  RSVP_TRACE ("entering ForwardResvTearMsg");
 
   memset (&RsvpPkt, 0, sizeof (RSVP_PKT));
 
@@ -2878,7 +2934,7 @@ ForwardResvTearMsg (RSB * pRsb)
 		}
 	      else
 		{
-		  zlog_info ("%s %d", __FILE__, __LINE__);
+		  RSVP_TRACE ("%s %d", __FILE__, __LINE__);
 		}
 	      memset (&RsvpPkt.SentRsvpHop, 0, sizeof (RSVP_HOP_OBJ));
 	      pFilterListPrev = RsvpPkt.pFilterList;
@@ -2894,7 +2950,7 @@ ForwardResvTearMsg (RSB * pRsb)
 	}
       pPHopResvRefreshList = pPHopResvRefreshList->next;
     }
-  zlog_info ("leaving ForwardResvTearMsg");
+  RSVP_TRACE ("leaving ForwardResvTearMsg");
   return E_OK;
 }
 
@@ -2909,14 +2965,14 @@ ProcessRsvpResvTearMessage (RSVP_PKT * pRsvpPkt)
     NULL, *pFilterListPrev2, *pFilterListNext;
   uns8 ItemExtracted;
   int Shared = 0;
-  zlog_info ("entering ProcessRsvpResvTearMessage");
+  RSVP_TRACE ("entering ProcessRsvpResvTearMessage");
   RsvpStatistics.ResvTearMsgCount++;
   memset (&RsbKey, 0, sizeof (RSB_KEY));
   RsbKey.Session = pRsvpPkt->Session;
 
   if ((pRsb = FindRsb (&RsbKey)) == NULL)
     {
-      zlog_info ("leaving ProcessRsvpResvTearMessage");
+      RSVP_TRACE ("leaving ProcessRsvpResvTearMessage");
       FreeRsvpPkt (pRsvpPkt);
       return E_OK;
     }
@@ -2926,7 +2982,7 @@ ProcessRsvpResvTearMessage (RSVP_PKT * pRsvpPkt)
       Shared = 1;
     }
   /* First - for the list of FILTER_SPECs to be deleted */
-  zlog_info ("Determining FilterSpecs to be deleted...");
+  RSVP_TRACE ("Determining FilterSpecs to be deleted...");
   pFilterList = pRsvpPkt->pFilterList;
   while (pFilterList != NULL)
     {
@@ -2935,8 +2991,8 @@ ProcessRsvpResvTearMessage (RSVP_PKT * pRsvpPkt)
       ItemExtracted = FALSE;
       if (pFilterSpecData != NULL)
 	{
-	  zlog_info ("FilterSpec %x %x", pFilterSpecData->FilterSpec.IpAddr,
-		     pFilterSpecData->FilterSpec.LspId);
+	  RSVP_TRACE ("FilterSpec %x %x", pFilterSpecData->FilterSpec.IpAddr,
+		      pFilterSpecData->FilterSpec.LspId);
 	  pFilterList2 = pRsb->OldPacket.pFilterList;
 	  pFilterListPrev2 = NULL;
 	  while (pFilterList2 != NULL)
@@ -2944,9 +3000,9 @@ ProcessRsvpResvTearMessage (RSVP_PKT * pRsvpPkt)
 	      pFilterSpecData2 = pFilterList2->pFilterSpecData;
 	      if (pFilterSpecData2 != NULL)
 		{
-		  zlog_info ("FilterSpec2 %x %x",
-			     pFilterSpecData2->FilterSpec.IpAddr,
-			     pFilterSpecData2->FilterSpec.LspId);
+		  RSVP_TRACE ("FilterSpec2 %x %x",
+			      pFilterSpecData2->FilterSpec.IpAddr,
+			      pFilterSpecData2->FilterSpec.LspId);
 		  if (memcmp
 		      (&pFilterSpecData->FilterSpec,
 		       &pFilterSpecData2->FilterSpec,
@@ -3006,7 +3062,7 @@ ProcessRsvpResvTearMessage (RSVP_PKT * pRsvpPkt)
 					__FILE__, __LINE__);
 			      return E_ERR;
 			    }
-			  zlog_info ("Queued...");
+			  RSVP_TRACE ("Queued...");
 			  break;
 			}
 		      if (pFilterSpecData2->pPHopResvRefreshList != 0)
@@ -3027,13 +3083,13 @@ ProcessRsvpResvTearMessage (RSVP_PKT * pRsvpPkt)
 			}
 		      pFilterList2->next = pFilterList2BeDeleted;
 		      pFilterList2BeDeleted = pFilterList2;
-		      zlog_info ("Inserted to deletion list...");
+		      RSVP_TRACE ("Inserted to deletion list...");
 		      break;
 		    }
 		}
 	      else
 		{
-		  zlog_info ("FilterSpec - FlowSpecData2 is NULL!!!");
+		  RSVP_TRACE ("FilterSpec - FlowSpecData2 is NULL!!!");
 		}
 	      pFilterListPrev2 = pFilterList2;
 	      pFilterList2 = pFilterList2->next;
@@ -3041,7 +3097,7 @@ ProcessRsvpResvTearMessage (RSVP_PKT * pRsvpPkt)
 	}
       else
 	{
-	  zlog_info ("FilterSpec - FlowSpecData is NULL!!!");
+	  RSVP_TRACE ("FilterSpec - FlowSpecData is NULL!!!");
 	}
       if (ItemExtracted == FALSE)
 	{
@@ -3100,7 +3156,7 @@ ProcessRsvpResvTearMessage (RSVP_PKT * pRsvpPkt)
       FreeRSB (pRsb);
     }
   FreeRsvpPkt (pRsvpPkt);
-  zlog_info ("leaving ProcessRsvpResvTearMessage");
+  RSVP_TRACE ("leaving ProcessRsvpResvTearMessage");
   return E_OK;
 }
 
@@ -3124,7 +3180,7 @@ ProcessRsvpResvErrMessage (RSVP_PKT * pRsvpPkt)
   uns8 Shared = 0;
   uns8 ItemExtracted;
   RSVP_PKT RsvpPkt;
-  zlog_info ("entering ProcessRsvpResvErrMessage");
+  RSVP_TRACE ("entering ProcessRsvpResvErrMessage");
   RsvpStatistics.ResvErrMsgCount++;
   memset (&RsbKey, 0, sizeof (RSB_KEY));
 
@@ -3390,7 +3446,7 @@ ProcessRsvpResvErrMessage (RSVP_PKT * pRsvpPkt)
       pIfListEntry = pIfList;
     }
   FreeRsvpPkt (pRsvpPkt);
-  zlog_info ("leaving ProcessRsvpResvErrMessage");
+  RSVP_TRACE ("leaving ProcessRsvpResvErrMessage");
   return E_OK;
 }
 
@@ -3412,7 +3468,7 @@ PrepareAndSendBWReleaseMsg2TE (PSB * pPsb, uns8 Priority, uns32 IfIndex,
     }
   msg.u.BwRelease.IfIndex = IfIndex;
   msg.u.BwRelease.HoldPrio = Priority;	/*pFilterSpecData->pPsb->OldPacket.SessionAttributes.u.SessAttrRa.HoldPrio */
-  zlog_info ("sending message to TE upon RESV");
+  RSVP_TRACE ("sending message to TE upon RESV");
   rsvp_send_msg (&msg, sizeof (msg));
 }
 
@@ -3426,7 +3482,7 @@ PrepareAndSendResvTearNotificationMsg2TE (RSB * pRsb,
   msg.NotificationType = RESV_TEAR_NOTIFICATION;
   msg.u.ResvTearNotification.RsbKey = pRsb->RsbKey;
   msg.u.ResvTearNotification.FilterSpec = *pFilterSpec;
-  zlog_info ("sending message to TE upon RESV");
+  RSVP_TRACE ("sending message to TE upon RESV");
   rsvp_send_msg (&msg, sizeof (msg));
 }
 
@@ -3443,7 +3499,7 @@ PreemptFlow (TE_API_MSG * pMsg)
   int Shared = 0;
   IF_LIST *pIfList = NULL, *pIfListEntry, *pIfListEntryPrev = NULL;
 
-  zlog_info ("entering PreemptFlow");
+  RSVP_TRACE ("entering PreemptFlow");
 
   memset (&RsbKey, 0, sizeof (RSB_KEY));
   RsbKey = pMsg->u.PreemptFlow.RsbKey;
@@ -3626,5 +3682,5 @@ PreemptFlow (TE_API_MSG * pMsg)
     {
       FreeRSB (pRsb);
     }
-  zlog_info ("leaving PreemptFlow");
+  RSVP_TRACE ("leaving PreemptFlow");
 }
@@ -0,0 +1,848 @@
+/* Module:   rsvp_rr.c
+   Contains: RSVP refresh reduction (RFC 2961) - MESSAGE_ID and
+   MESSAGE_ID_ACK handling, Ack, Bundle and Srefresh messages
+   and per neighbor capability tracking.
+   */
+#include "rsvp.h"
+#include "thread.h"
+
+#define RSVP_COMMON_HDR_LEN   8
+#define RSVP_OBJ_HDR_LEN      4
+#define MESSAGE_ID_OBJ_LEN    12
+#define RSVP_RR_MAX_MSG_LEN   1400
+
+/* Acks and Srefresh message ids queued to a neighbor are sent together
+   this many seconds after the first one was queued. */
+uns32 RsvpRrFlushDelay = 1;
+
+uns8 RefreshReductionEnabled = TRUE;
+RSVP_RR_STATISTICS RsvpRrStatistics;
+
+extern uns32 PathRefreshInterval;
+extern uns32 RefreshMultiple;
+extern struct thread_master *master;
+
+typedef struct
+{
+  IPV4_ADDR Neighbor;
+  uns32 MessageId;
+} RCVD_MSG_ID_KEY;
+
+/* State installed by a Path or Resv received with a MESSAGE_ID, so a
+   later Srefresh listing the id refreshes it without the full message. */
+typedef struct _rcvd_msg_id_
+{
+  PATRICIA_NODE Node;
+  RCVD_MSG_ID_KEY Key;
+  uns8 MsgType;
+  time_t LastSeen;
+  PSB_KEY PsbKey;
+  RSB_KEY RsbKey;
+  FILTER_SPEC_OBJ *pFilterSpecs;
+  uns32 FilterSpecCount;
+} RCVD_MSG_ID;
+
+static PATRICIA_TREE NeighborTree;
+static PATRICIA_TREE SentMsgIdTree;
+static PATRICIA_TREE RcvdMsgIdTree;
+static RSVP_TIMER *RcvdMsgIdCleanupTimer;
+static uns32 LocalEpoch;
+static uns32 LastMessageId;
+static char RrBuffer[1500];
+
+static int RsvpRrFlushTimer (RSVP_TIMER *);
+static int RsvpRrCleanupTimer (RSVP_TIMER *);
+
+void encode_32bit (uns8 ** stream, uns32 val);
+void encode_24bit (uns8 ** stream, uns32 val);
+void encode_16bit (uns8 ** stream, uns32 val);
+void encode_8bit (uns8 ** stream, uns32 val);
+uns32 decode_32bit (uns8 ** stream);
+uns32 decode_24bit (uns8 ** stream);
+uns16 decode_16bit (uns8 ** stream);
+uns8 decode_8bit (uns8 ** stream);
+
+E_RC
+InitRsvpRefreshReduction ()
+{
+  PATRICIA_PARAMS params;
+
+  memset (&params, 0, sizeof (PATRICIA_PARAMS));
+  params.key_size = sizeof (IPV4_ADDR);
+  if (patricia_tree_init (&NeighborTree, &params) != E_OK)
+    {
+      zlog_err ("Cannot initiate neighbor tree");
+      return E_ERR;
+    }
+  params.key_size = sizeof (uns32);
+  if (patricia_tree_init (&SentMsgIdTree, &params) != E_OK)
+    {
+      zlog_err ("Cannot initiate message id tree");
+      return E_ERR;
+    }
+  params.key_size = sizeof (RCVD_MSG_ID_KEY);
+  if (patricia_tree_init (&RcvdMsgIdTree, &params) != E_OK)
+    {
+      zlog_err ("Cannot initiate received message id tree");
+      return E_ERR;
+    }
+  memset (&RsvpRrStatistics, 0, sizeof (RSVP_RR_STATISTICS));
+  /* a new epoch on every restart tells the neighbors to forget the
+     message ids learned from the previous incarnation */
+  LocalEpoch = ((uns32) time (NULL) ^ (uns32) getpid ()) & 0x00FFFFFF;
+  LastMessageId = 0;
+  RsvpTimerAdd (RsvpRrCleanupTimer, NULL,
+		PathRefreshInterval * RefreshMultiple, &RcvdMsgIdCleanupTimer);
+  return E_OK;
+}
+
+static RSVP_NEIGHBOR *
+FindNeighbor (IPV4_ADDR Addr)
+{
+  return (RSVP_NEIGHBOR *) patricia_tree_get (&NeighborTree,
+					      (const uns8 *) &Addr);
+}
+
+static RSVP_NEIGHBOR *
+GetOrCreateNeighbor (IPV4_ADDR Addr, uns32 IfIndex)
+{
+  RSVP_NEIGHBOR *pNbr;
+
+  if ((pNbr = FindNeighbor (Addr)) != NULL)
+    return pNbr;
+  if ((pNbr =
+       (RSVP_NEIGHBOR *) XMALLOC (MTYPE_RSVP, sizeof (RSVP_NEIGHBOR))) == NULL)
+    {
+      zlog_err ("Cannot allocate memory %s %d", __FILE__, __LINE__);
+      return NULL;
+    }
+  memset (pNbr, 0, sizeof (RSVP_NEIGHBOR));
+  pNbr->Addr = Addr;
+  pNbr->IfIndex = IfIndex;
+  pNbr->Node.key_info = (uns8 *) & pNbr->Addr;
+  if (patricia_tree_add (&NeighborTree, &pNbr->Node) != E_OK)
+    {
+      zlog_err ("Cannot add node to patricia tree %s %d", __FILE__, __LINE__);
+      XFREE (MTYPE_RSVP, pNbr);
+      return NULL;
+    }
+  return pNbr;
+}
+
+void
+RsvpRrNeighborSeen (IPV4_ADDR Addr, uns32 IfIndex, uns8 VersionFlags)
+{
+  RSVP_NEIGHBOR *pNbr;
+  uns8 Capable;
+
+  if (Addr == 0)
+    return;
+  Capable = ((RefreshReductionEnabled == TRUE) &&
+	     ((VersionFlags & RSVP_RR_CAPABLE_FLAG) != 0)) ? TRUE : FALSE;
+  if ((pNbr = FindNeighbor (Addr)) == NULL)
+    {
+      /* nothing to track for neighbors doing full refreshes */
+      if (Capable == FALSE)
+	return;
+      if ((pNbr = GetOrCreateNeighbor (Addr, IfIndex)) == NULL)
+	return;
+    }
+  if (pNbr->RefreshReduction != Capable)
+    zlog_info ("neighbor %x refresh reduction %s", Addr,
+	       (Capable == TRUE) ? "enabled" : "disabled");
+  pNbr->RefreshReduction = Capable;
+  if (IfIndex != 0)
+    pNbr->IfIndex = IfIndex;
+}
+
+static void
+ScheduleFlush (RSVP_NEIGHBOR * pNbr)
+{
+  if (pNbr->FlushTimer == NULL)
+    RsvpTimerAdd (RsvpRrFlushTimer, pNbr, RsvpRrFlushDelay,
+		  &pNbr->FlushTimer);
+}
+
+static E_RC
+QueueSrefreshId (RSVP_NEIGHBOR * pNbr, uns32 MessageId)
+{
+  if (pNbr->SrefreshIdCount == pNbr->SrefreshIdSize)
+    {
+      uns32 Size = (pNbr->SrefreshIdSize) ? pNbr->SrefreshIdSize * 2 : 64;
+      uns32 *pIds;
+
+      if ((pIds =
+	   (uns32 *) XREALLOC (MTYPE_RSVP, pNbr->pSrefreshIds,
+			       Size * sizeof (uns32))) == NULL)
+	{
+	  zlog_err ("Cannot allocate memory %s %d", __FILE__, __LINE__);
+	  return E_ERR;
+	}
+      pNbr->pSrefreshIds = pIds;
+      pNbr->SrefreshIdSize = Size;
+    }
+  pNbr->pSrefreshIds[pNbr->SrefreshIdCount++] = MessageId;
+  ScheduleFlush (pNbr);
+  return E_OK;
+}
+
+static E_RC
+QueueAck (RSVP_NEIGHBOR * pNbr, MESSAGE_ID_OBJ * pMessageId, uns8 CType)
+{
+  if (pNbr->AckCount == pNbr->AckSize)
+    {
+      uns32 Size = (pNbr->AckSize) ? pNbr->AckSize * 2 : 16;
+      MESSAGE_ID_OBJ *pAcks;
+      uns8 *pCTypes;
+
+      if ((pAcks =
+	   (MESSAGE_ID_OBJ *) XREALLOC (MTYPE_RSVP, pNbr->pAcks,
+					Size * sizeof (MESSAGE_ID_OBJ))) ==
+	  NULL)
+	{
+	  zlog_err ("Cannot allocate memory %s %d", __FILE__, __LINE__);
+	  return E_ERR;
+	}
+      pNbr->pAcks = pAcks;
+      if ((pCTypes =
+	   (uns8 *) XREALLOC (MTYPE_RSVP, pNbr->pAckCTypes, Size)) == NULL)
+	{
+	  zlog_err ("Cannot allocate memory %s %d", __FILE__, __LINE__);
+	  return E_ERR;
+	}
+      pNbr->pAckCTypes = pCTypes;
+      pNbr->AckSize = Size;
+    }
+  pNbr->pAcks[pNbr->AckCount] = *pMessageId;
+  pNbr->pAcks[pNbr->AckCount].Flags = 0;
+  pNbr->pAckCTypes[pNbr->AckCount] = CType;
+  pNbr->AckCount++;
+  ScheduleFlush (pNbr);
+  return E_OK;
+}
+
+static uns16
+EncodeRrMsgHdr (uns8 * pData, uns8 MsgType, uns16 PktLen)
+{
+  uns8 *p = pData;
+
+  encode_8bit (&p, RSVP_VERSION_FLAGS);
+  encode_8bit (&p, MsgType);
+  encode_16bit (&p, 0);
+  encode_8bit (&p, 1);
+  encode_8bit (&p, 0);
+  encode_16bit (&p, PktLen);
+  return RSVP_COMMON_HDR_LEN;
+}
+
+static void
+SetRrMsgCheckSum (uns8 * pData, uns16 PktLen)
+{
+  uns16 CheckSum = 0;
+  uns8 *p = pData + 2;
+
+  rsvp_calc_pkt_cksum ((char *) pData, PktLen, &CheckSum);
+  encode_16bit (&p, CheckSum);
+}
+
+/* Encodes an Ack message carrying up to Count acknowledgements. */
+static uns16
+EncodeAckMsg (uns8 * pData, MESSAGE_ID_OBJ * pAcks, uns8 * pCTypes,
+	      uns32 Count)
+{
+  uns8 *p = pData + RSVP_COMMON_HDR_LEN;
+  uns16 PktLen = RSVP_COMMON_HDR_LEN + Count * MESSAGE_ID_OBJ_LEN;
+  uns32 i;
+
+  EncodeRrMsgHdr (pData, ACK_MSG, PktLen);
+  for (i = 0; i < Count; i++)
+    {
+      encode_16bit (&p, MESSAGE_ID_OBJ_LEN);
+      encode_8bit (&p, MESSAGE_ID_ACK_CLASS);
+      encode_8bit (&p, pCTypes[i]);
+      encode_8bit (&p, 0);
+      encode_24bit (&p, pAcks[i].Epoch);
+      encode_32bit (&p, pAcks[i].MessageId);
+    }
+  SetRrMsgCheckSum (pData, PktLen);
+  return PktLen;
+}
+
+/* Encodes an Srefresh message with a single MESSAGE_ID_LIST. */
+static uns16
+EncodeSrefreshMsg (uns8 * pData, uns32 * pIds, uns32 Count)
+{
+  uns8 *p = pData + RSVP_COMMON_HDR_LEN;
+  uns16 ObjLen = RSVP_OBJ_HDR_LEN + 4 + Count * 4;
+  uns16 PktLen = RSVP_COMMON_HDR_LEN + ObjLen;
+  uns32 i;
+
+  EncodeRrMsgHdr (pData, SREFRESH_MSG, PktLen);
+  encode_16bit (&p, ObjLen);
+  encode_8bit (&p, MESSAGE_ID_LIST_CLASS);
+  encode_8bit (&p, MESSAGE_ID_LIST_CTYPE);
+  encode_8bit (&p, 0);
+  encode_24bit (&p, LocalEpoch);
+  for (i = 0; i < Count; i++)
+    encode_32bit (&p, pIds[i]);
+  SetRrMsgCheckSum (pData, PktLen);
+  return PktLen;
+}
+
+static void
+RsvpRrFlush (RSVP_NEIGHBOR * pNbr)
+{
+  uns32 MaxAcks = (RSVP_RR_MAX_MSG_LEN / 2 - RSVP_COMMON_HDR_LEN) /
+    MESSAGE_ID_OBJ_LEN;
+  uns32 MaxIds = (RSVP_RR_MAX_MSG_LEN / 2 - RSVP_COMMON_HDR_LEN -
+		  RSVP_OBJ_HDR_LEN - 4) / 4;
+  uns32 AckDone = 0, IdDone = 0;
+
+  RsvpTimerCancel (&pNbr->FlushTimer);
+  while ((AckDone < pNbr->AckCount) || (IdDone < pNbr->SrefreshIdCount))
+    {
+      uns32 Acks = pNbr->AckCount - AckDone;
+      uns32 Ids = pNbr->SrefreshIdCount - IdDone;
+      uns8 *pData = (uns8 *) RrBuffer + RSVP_COMMON_HDR_LEN;
+      uns16 PktLen = 0;
+      uns8 MsgNumber = 0;
+
+      if (Acks > MaxAcks)
+	Acks = MaxAcks;
+      if (Ids > MaxIds)
+	Ids = MaxIds;
+
+      /* both kinds go out in a single Bundle when there are both */
+      if (Acks != 0)
+	{
+	  PktLen += EncodeAckMsg (pData, &pNbr->pAcks[AckDone],
+				  &pNbr->pAckCTypes[AckDone], Acks);
+	  RsvpRrStatistics.AckSentCount += Acks;
+	  MsgNumber++;
+	}
+      if (Ids != 0)
+	{
+	  PktLen += EncodeSrefreshMsg (pData + PktLen,
+				       &pNbr->pSrefreshIds[IdDone], Ids);
+	  RsvpRrStatistics.SrefreshSentCount++;
+	  RsvpRrStatistics.MsgIdSummarizedCount += Ids;
+	  pNbr->SrefreshSent++;
+	  MsgNumber++;
+	}
+      AckDone += Acks;
+      IdDone += Ids;
+
+      if (MsgNumber > 1)
+	{
+	  PktLen += EncodeRrMsgHdr ((uns8 *) RrBuffer, BUNDLE_MSG,
+				    PktLen + RSVP_COMMON_HDR_LEN);
+	  SetRrMsgCheckSum ((uns8 *) RrBuffer, PktLen);
+	  pData = (uns8 *) RrBuffer;
+	  RsvpRrStatistics.BundleSentCount++;
+	}
+      if (SendRawData ((char *) pData, PktLen, pNbr->Addr, pNbr->IfIndex, 1,
+		       FALSE) != E_OK)
+	{
+	  zlog_err ("Cannot send raw data %s %d", __FILE__, __LINE__);
+	}
+    }
+  pNbr->AckCount = 0;
+  pNbr->SrefreshIdCount = 0;
+}
+
+static int
+RsvpRrFlushTimer (RSVP_TIMER * pTimer)
+{
+  RsvpRrFlush ((RSVP_NEIGHBOR *) RSVP_TIMER_ARG (pTimer));
+  return 0;
+}
+
+/* Sends whatever was queued to the neighbors, called once the refresh
+   wheel has processed its due slots. */
+void
+RsvpRrFlushAll ()
+{
+  RSVP_NEIGHBOR *pNbr;
+  IPV4_ADDR Addr = 0;
+
+  while ((pNbr =
+	  (RSVP_NEIGHBOR *) patricia_tree_getnext (&NeighborTree,
+						   (const uns8 *) &Addr)) !=
+	 NULL)
+    {
+      Addr = pNbr->Addr;
+      if ((pNbr->AckCount != 0) || (pNbr->SrefreshIdCount != 0))
+	RsvpRrFlush (pNbr);
+    }
+}
+
+static uns8
+BufferHasMessageId (char *pBuffer, uns16 Len, uns32 MessageId)
+{
+  uns8 *p = (uns8 *) pBuffer + RSVP_COMMON_HDR_LEN;
+
+  if (Len < RSVP_COMMON_HDR_LEN + MESSAGE_ID_OBJ_LEN)
+    return FALSE;
+  if (p[2] != MESSAGE_ID_CLASS)
+    return FALSE;
+  if (MessageId == 0)
+    return TRUE;
+  p += RSVP_OBJ_HDR_LEN + 4;
+  return (decode_32bit (&p) == MessageId) ? TRUE : FALSE;
+}
+
+/* Puts a MESSAGE_ID object right after the common header of an already
+   encoded message, replacing the one present. */
+static E_RC
+StampMessageId (char **ppBuffer, uns16 * pLen, uns32 MessageId)
+{
+  uns8 *p;
+
+  if (BufferHasMessageId (*ppBuffer, *pLen, 0) == FALSE)
+    {
+      char *pNew;
+
+      if ((pNew =
+	   (char *) XMALLOC (MTYPE_RSVP, *pLen + MESSAGE_ID_OBJ_LEN)) == NULL)
+	{
+	  zlog_err ("Cannot allocate memory %s %d", __FILE__, __LINE__);
+	  return E_ERR;
+	}
+      memcpy (pNew, *ppBuffer, RSVP_COMMON_HDR_LEN);
+      memcpy (pNew + RSVP_COMMON_HDR_LEN + MESSAGE_ID_OBJ_LEN,
+	      *ppBuffer + RSVP_COMMON_HDR_LEN, *pLen - RSVP_COMMON_HDR_LEN);
+      XFREE (MTYPE_RSVP, *ppBuffer);
+      *ppBuffer = pNew;
+      *pLen += MESSAGE_ID_OBJ_LEN;
+    }
+  p = (uns8 *) * ppBuffer;
+  p[0] |= RSVP_RR_CAPABLE_FLAG;
+  p += 6;
+  encode_16bit (&p, *pLen);
+  encode_16bit (&p, MESSAGE_ID_OBJ_LEN);
+  encode_8bit (&p, MESSAGE_ID_CLASS);
+  encode_8bit (&p, MESSAGE_ID_CTYPE);
+  encode_8bit (&p, MESSAGE_ID_ACK_DESIRED);
+  encode_24bit (&p, LocalEpoch);
+  encode_32bit (&p, MessageId);
+  SetRrMsgCheckSum ((uns8 *) * ppBuffer, *pLen);
+  return E_OK;
+}
+
+void
+RsvpRrReleaseMsgId (RSVP_MSG_ID_STATE * pState)
+{
+  if (pState->MessageId == 0)
+    return;
+  if (patricia_tree_del (&SentMsgIdTree, &pState->Node) != E_OK)
+    {
+      zlog_err ("Cannot delete node from patricia %s %d", __FILE__, __LINE__);
+    }
+  pState->MessageId = 0;
+  pState->Acked = FALSE;
+}
+
+/* Called on the refresh of a PSB or PHOP entry whose full message is
+   cached in *ppBuffer.  Returns TRUE when the refresh was queued to the
+   neighbor's next Srefresh, FALSE when the caller has to send the full
+   message, which may have been stamped with a new MESSAGE_ID. */
+uns8
+RsvpRrRefresh (RSVP_MSG_ID_STATE * pState, uns8 MsgType, void *pOwner,
+	       IPV4_ADDR Neighbor, uns32 IfIndex,
+	       char **ppBuffer, uns16 * pBufferLen)
+{
+  RSVP_NEIGHBOR *pNbr = FindNeighbor (Neighbor);
+
+  if ((pNbr == NULL) || (pNbr->RefreshReduction == FALSE) ||
+      (*ppBuffer == NULL) || (*pBufferLen == 0))
+    {
+      RsvpRrStatistics.FullRefreshCount++;
+      if (pNbr != NULL)
+	pNbr->FullRefreshSent++;
+      return FALSE;
+    }
+  if ((pState->MessageId != 0) && (pState->Acked == TRUE) &&
+      (pState->Neighbor == Neighbor) &&
+      (BufferHasMessageId (*ppBuffer, *pBufferLen, pState->MessageId) ==
+       TRUE))
+    {
+      pNbr->IfIndex = IfIndex;
+      if (QueueSrefreshId (pNbr, pState->MessageId) == E_OK)
+	return TRUE;
+    }
+
+  /* the neighbor has not acknowledged the state yet, announce it with a
+     new MESSAGE_ID in a full refresh */
+  RsvpRrReleaseMsgId (pState);
+  if (++LastMessageId == 0)
+    LastMessageId = 1;
+  if (StampMessageId (ppBuffer, pBufferLen, LastMessageId) != E_OK)
+    {
+      RsvpRrStatistics.FullRefreshCount++;
+      return FALSE;
+    }
+  pState->MessageId = LastMessageId;
+  pState->MsgType = MsgType;
+  pState->Acked = FALSE;
+  pState->Neighbor = Neighbor;
+  pState->IfIndex = IfIndex;
+  pState->pOwner = pOwner;
+  pState->Node.key_info = (uns8 *) & pState->MessageId;
+  if (patricia_tree_add (&SentMsgIdTree, &pState->Node) != E_OK)
+    {
+      zlog_err ("Cannot add node to patricia tree %s %d", __FILE__, __LINE__);
+      pState->MessageId = 0;
+    }
+  RsvpRrStatistics.FullRefreshCount++;
+  pNbr->FullRefreshSent++;
+  return FALSE;
+}
+
+void
+RsvpRrProcessAck (MESSAGE_ID_OBJ * pAck, uns8 CType)
+{
+  RSVP_MSG_ID_STATE *pState;
+
+  if (pAck->Epoch != LocalEpoch)
+    return;
+  if ((pState =
+       (RSVP_MSG_ID_STATE *) patricia_tree_get (&SentMsgIdTree,
+						(const uns8 *) &pAck->
+						MessageId)) == NULL)
+    return;
+  if (CType == MESSAGE_ID_ACK_CTYPE)
+    {
+      RsvpRrStatistics.AckRcvdCount++;
+      pState->Acked = TRUE;
+      return;
+    }
+  /* the neighbor does not know the state - fall back to a full refresh */
+  RsvpRrStatistics.NackRcvdCount++;
+  pState->Acked = FALSE;
+  if (pState->MsgType == PATH_MSG)
+    {
+      if (RsvpPathRefresh ((PSB *) pState->pOwner) != E_OK)
+	zlog_err ("an error on RsvpPathRefresh");
+    }
+  else if (pState->MsgType == RESV_MSG)
+    {
+      if (ResvRefreshPHop ((PHOP_RESV_REFRESH_LIST *) pState->pOwner) !=
+	  E_OK)
+	zlog_err ("an error on ResvRefreshPHop");
+    }
+}
+
+static void
+FreeRcvdMsgId (RCVD_MSG_ID * pRcvd)
+{
+  if (patricia_tree_del (&RcvdMsgIdTree, &pRcvd->Node) != E_OK)
+    {
+      zlog_err ("Cannot delete node from patricia %s %d", __FILE__, __LINE__);
+      return;
+    }
+  if (pRcvd->pFilterSpecs)
+    XFREE (MTYPE_RSVP, pRcvd->pFilterSpecs);
+  XFREE (MTYPE_RSVP, pRcvd);
+}
+
+static void
+FlushNeighborRcvdMsgIds (IPV4_ADDR Neighbor)
+{
+  RCVD_MSG_ID_KEY Key;
+  RCVD_MSG_ID *pRcvd;
+
+  memset (&Key, 0, sizeof (RCVD_MSG_ID_KEY));
+  Key.Neighbor = Neighbor;
+  while (((pRcvd =
+	   (RCVD_MSG_ID *) patricia_tree_getnext (&RcvdMsgIdTree,
+						  (const uns8 *) &Key)) !=
+	  NULL) && (pRcvd->Key.Neighbor == Neighbor))
+    {
+      Key = pRcvd->Key;
+      FreeRcvdMsgId (pRcvd);
+    }
+}
+
+void
+RsvpRrMessageIdReceived (RSVP_PKT * pRsvpPkt, uns8 MsgType,
+			 IPV4_ADDR Neighbor, uns32 IfIndex)
+{
+  RSVP_NEIGHBOR *pNbr;
+  RCVD_MSG_ID_KEY Key;
+  RCVD_MSG_ID *pRcvd;
+
+  if ((pRsvpPkt->MessageIdValid == FALSE) || (Neighbor == 0) ||
+      (RefreshReductionEnabled == FALSE))
+    return;
+  if ((pNbr = GetOrCreateNeighbor (Neighbor, IfIndex)) == NULL)
+    return;
+  if ((pNbr->EpochValid == TRUE) &&
+      (pNbr->Epoch != pRsvpPkt->MessageId.Epoch))
+    {
+      zlog_info ("neighbor %x restarted, flushing its message ids",
+		 Neighbor);
+      FlushNeighborRcvdMsgIds (Neighbor);
+    }
+  pNbr->Epoch = pRsvpPkt->MessageId.Epoch;
+  pNbr->EpochValid = TRUE;
+
+  memset (&Key, 0, sizeof (RCVD_MSG_ID_KEY));
+  Key.Neighbor = Neighbor;
+  Key.MessageId = pRsvpPkt->MessageId.MessageId;
+  if ((pRcvd =
+       (RCVD_MSG_ID *) patricia_tree_get (&RcvdMsgIdTree,
+					  (const uns8 *) &Key)) == NULL)
+    {
+      FILTER_LIST *pFilterList;
+
+      if ((pRcvd =
+	   (RCVD_MSG_ID *) XMALLOC (MTYPE_RSVP, sizeof (RCVD_MSG_ID))) ==
+	  NULL)
+	{
+	  zlog_err ("Cannot allocate memory %s %d", __FILE__, __LINE__);
+	  return;
+	}
+      memset (pRcvd, 0, sizeof (RCVD_MSG_ID));
+      pRcvd->Key = Key;
+      pRcvd->MsgType = MsgType;
+      if (MsgType == PATH_MSG)
+	{
+	  pRcvd->PsbKey.Session = pRsvpPkt->Session;
+	  pRcvd->PsbKey.SenderTemplate = pRsvpPkt->SenderTemplate;
+	}
+      else
+	{
+	  pRcvd->RsbKey.Session = pRsvpPkt->Session;
+	  for (pFilterList = pRsvpPkt->pFilterList; pFilterList != NULL;
+	       pFilterList = pFilterList->next)
+	    pRcvd->FilterSpecCount++;
+	  if ((pRcvd->FilterSpecCount != 0) &&
+	      ((pRcvd->pFilterSpecs =
+		(FILTER_SPEC_OBJ *) XMALLOC (MTYPE_RSVP,
+					     pRcvd->FilterSpecCount *
+					     sizeof (FILTER_SPEC_OBJ))) ==
+	       NULL))
+	    {
+	      zlog_err ("Cannot allocate memory %s %d", __FILE__, __LINE__);
+	      XFREE (MTYPE_RSVP, pRcvd);
+	      return;
+	    }
+	  pRcvd->FilterSpecCount = 0;
+	  for (pFilterList = pRsvpPkt->pFilterList; pFilterList != NULL;
+	       pFilterList = pFilterList->next)
+	    if (pFilterList->pFilterSpecData != NULL)
+	      pRcvd->pFilterSpecs[pRcvd->FilterSpecCount++] =
+		pFilterList->pFilterSpecData->FilterSpec;
+	}
+      pRcvd->Node.key_info = (uns8 *) & pRcvd->Key;
+      if (patricia_tree_add (&RcvdMsgIdTree, &pRcvd->Node) != E_OK)
+	{
+	  zlog_err ("Cannot add node to patricia tree %s %d", __FILE__,
+		    __LINE__);
+	  if (pRcvd->pFilterSpecs)
+	    XFREE (MTYPE_RSVP, pRcvd->pFilterSpecs);
+	  XFREE (MTYPE_RSVP, pRcvd);
+	  return;
+	}
+    }
+  pRcvd->LastSeen = time (NULL);
+  if (pRsvpPkt->MessageId.Flags & MESSAGE_ID_ACK_DESIRED)
+    QueueAck (pNbr, &pRsvpPkt->MessageId, MESSAGE_ID_ACK_CTYPE);
+}
+
+static E_RC
+ProcessSrefreshList (RSVP_NEIGHBOR * pNbr, uns8 * pData, uns16 ObjLen)
+{
+  MESSAGE_ID_OBJ Nack;
+  RCVD_MSG_ID_KEY Key;
+  RCVD_MSG_ID *pRcvd;
+  uns32 Epoch;
+  E_RC rc;
+
+  decode_8bit (&pData);
+  Epoch = decode_24bit (&pData);
+  ObjLen -= RSVP_OBJ_HDR_LEN + 4;
+  memset (&Key, 0, sizeof (RCVD_MSG_ID_KEY));
+  Key.Neighbor = pNbr->Addr;
+  memset (&Nack, 0, sizeof (MESSAGE_ID_OBJ));
+  Nack.Epoch = Epoch;
+  while (ObjLen >= 4)
+    {
+      Key.MessageId = decode_32bit (&pData);
+      ObjLen -= 4;
+      rc = E_ERR;
+      if ((pNbr->EpochValid == TRUE) && (pNbr->Epoch == Epoch) &&
+	  ((pRcvd =
+	    (RCVD_MSG_ID *) patricia_tree_get (&RcvdMsgIdTree,
+					       (const uns8 *) &Key)) != NULL))
+	{
+	  if (pRcvd->MsgType == PATH_MSG)
+	    rc = RsvpPathSummaryRefresh (&pRcvd->PsbKey);
+	  else
+	    rc = RsvpResvSummaryRefresh (&pRcvd->RsbKey, pRcvd->pFilterSpecs,
+					 pRcvd->FilterSpecCount);
+	  if (rc == E_OK)
+	    pRcvd->LastSeen = time (NULL);
+	  else
+	    FreeRcvdMsgId (pRcvd);
+	}
+      if (rc == E_OK)
+	{
+	  RsvpRrStatistics.MsgIdRefreshedCount++;
+	}
+      else
+	{
+	  /* unknown state, ask for the full message */
+	  Nack.MessageId = Key.MessageId;
+	  QueueAck (pNbr, &Nack, MESSAGE_ID_NACK_CTYPE);
+	  RsvpRrStatistics.NackSentCount++;
+	}
+    }
+  return E_OK;
+}
+
+E_RC
+RsvpRrProcessMsg (uns8 MsgType, uns8 * pData, uns32 Len,
+		  IPV4_ADDR Neighbor, uns32 IfIndex)
+{
+  RSVP_NEIGHBOR *pNbr = NULL;
+  MESSAGE_ID_OBJ Ack;
+  uns8 *pObj;
+  uns16 ObjLen;
+  uns8 ClassNum, CType;
+
+  if (MsgType == BUNDLE_MSG)
+    {
+      RsvpRrStatistics.BundleRcvdCount++;
+      while (Len >= RSVP_COMMON_HDR_LEN)
+	{
+	  uns8 *p = pData + 6;
+	  uns16 SubLen = decode_16bit (&p);
+
+	  if ((SubLen < RSVP_COMMON_HDR_LEN) || (SubLen > Len))
+	    {
+	      zlog_err ("malformed Bundle message from %x", Neighbor);
+	      return E_ERR;
+	    }
+	  DecodeAndProcessRsvpMsg (pData, SubLen, IfIndex, Neighbor);
+	  pData += SubLen;
+	  Len -= SubLen;
+	}
+      return E_OK;
+    }
+
+  if (MsgType == SREFRESH_MSG)
+    {
+      RsvpRrStatistics.SrefreshRcvdCount++;
+      if (((pNbr = FindNeighbor (Neighbor)) == NULL) ||
+	  (RefreshReductionEnabled == FALSE))
+	{
+	  zlog_warn ("Srefresh from unknown neighbor %x", Neighbor);
+	  return E_ERR;
+	}
+      pNbr->SrefreshRcvd++;
+    }
+
+  while (Len >= RSVP_OBJ_HDR_LEN)
+    {
+      pObj = pData;
+      ObjLen = decode_16bit (&pObj);
+      ClassNum = decode_8bit (&pObj);
+      CType = decode_8bit (&pObj);
+      if ((ObjLen < RSVP_OBJ_HDR_LEN) || (ObjLen > Len) || (ObjLen & 3))
+	{
+	  zlog_err ("malformed object in message %d from %x", MsgType,
+		    Neighbor);
+	  return E_ERR;
+	}
+      if ((ClassNum == MESSAGE_ID_ACK_CLASS) &&
+	  (ObjLen == MESSAGE_ID_OBJ_LEN))
+	{
+	  Ack.Flags = decode_8bit (&pObj);
+	  Ack.Epoch = decode_24bit (&pObj);
+	  Ack.MessageId = decode_32bit (&pObj);
+	  RsvpRrProcessAck (&Ack, CType);
+	}
+      else if ((ClassNum == MESSAGE_ID_LIST_CLASS) &&
+	       (MsgType == SREFRESH_MSG) &&
+	       (ObjLen >= RSVP_OBJ_HDR_LEN + 4))
+	{
+	  ProcessSrefreshList (pNbr, pObj, ObjLen);
+	}
+      pData += ObjLen;
+      Len -= ObjLen;
+    }
+  return E_OK;
+}
+
+static int
+RsvpRrCleanupTimer (RSVP_TIMER * pTimer)
+{
+  RCVD_MSG_ID_KEY Key;
+  RCVD_MSG_ID *pRcvd;
+  time_t Now = time (NULL);
+  uns32 Lifetime = PathRefreshInterval * RefreshMultiple;
+
+  memset (&Key, 0, sizeof (RCVD_MSG_ID_KEY));
+  while ((pRcvd =
+	  (RCVD_MSG_ID *) patricia_tree_getnext (&RcvdMsgIdTree,
+						 (const uns8 *) &Key)) !=
+	 NULL)
+    {
+      Key = pRcvd->Key;
+      /* the state itself has aged out by now */
+      if (Now - pRcvd->LastSeen > Lifetime)
+	FreeRcvdMsgId (pRcvd);
+    }
+  RsvpTimerAdd (RsvpRrCleanupTimer, NULL, Lifetime, &RcvdMsgIdCleanupTimer);
+  return 0;
+}
+
+void
+DumpRsvpNeighbors (struct vty *vty)
+{
+  RSVP_NEIGHBOR *pNbr;
+  IPV4_ADDR Addr = 0;
+
+  while ((pNbr =
+	  (RSVP_NEIGHBOR *) patricia_tree_getnext (&NeighborTree,
+						   (const uns8 *) &Addr)) !=
+	 NULL)
+    {
+      struct in_addr in;
+
+      Addr = pNbr->Addr;
+      in.s_addr = pNbr->Addr;
+      vty_out (vty,
+	       "Neighbor %s IfIndex %d RefreshReduction %s Epoch %x%s",
+	       inet_ntoa (in), pNbr->IfIndex,
+	       (pNbr->RefreshReduction == TRUE) ? "yes" : "no", pNbr->Epoch,
+	       VTY_NEWLINE);
+      vty_out (vty, "  Srefresh sent %d received %d, full refreshes %d%s",
+	       pNbr->SrefreshSent, pNbr->SrefreshRcvd, pNbr->FullRefreshSent,
+	       VTY_NEWLINE);
+    }
+}
+
+void
+DumpRsvpRrStatistics (struct vty *vty)
+{
+  if (vty == NULL)
+    return;
+  vty_out (vty, "Refresh reduction %s, epoch %x%s",
+	   (RefreshReductionEnabled == TRUE) ? "enabled" : "disabled",
+	   LocalEpoch, VTY_NEWLINE);
+  vty_out (vty, "Srefresh sent %d received %d, ids summarized %d "
+	   "refreshed %d, full refreshes %d%s",
+	   RsvpRrStatistics.SrefreshSentCount,
+	   RsvpRrStatistics.SrefreshRcvdCount,
+	   RsvpRrStatistics.MsgIdSummarizedCount,
+	   RsvpRrStatistics.MsgIdRefreshedCount,
+	   RsvpRrStatistics.FullRefreshCount, VTY_NEWLINE);
+  vty_out (vty, "Ack sent %d received %d, Nack sent %d received %d, "
+	   "Bundle sent %d received %d%s",
+	   RsvpRrStatistics.AckSentCount, RsvpRrStatistics.AckRcvdCount,
+	   RsvpRrStatistics.NackSentCount, RsvpRrStatistics.NackRcvdCount,
+	   RsvpRrStatistics.BundleSentCount,
+	   RsvpRrStatistics.BundleRcvdCount, VTY_NEWLINE);
+}
@@ -0,0 +1,83 @@
+
+#ifndef _RSVP_RR_H_
+#define _RSVP_RR_H_
+
+/* RFC 2961 refresh reduction.
+   A PSB or PHOP entry which is refreshed towards a neighbor carries one
+   RSVP_MSG_ID_STATE.  Once the neighbor has acknowledged the MESSAGE_ID
+   of the full message, further refreshes are sent as MESSAGE_ID_LISTs in
+   Srefresh messages.  Neighbors not announcing the capability keep
+   receiving full refreshes. */
+
+typedef struct _rsvp_msg_id_state_
+{
+  PATRICIA_NODE Node;
+  uns32 MessageId;		/* key, 0 - no MESSAGE_ID was sent yet */
+  uns8 MsgType;
+  uns8 Acked;
+  IPV4_ADDR Neighbor;
+  uns32 IfIndex;
+  char *pStampedBuffer;
+  void *pOwner;			/* PSB or PHOP_RESV_REFRESH_LIST */
+} RSVP_MSG_ID_STATE;
+
+typedef struct _rsvp_neighbor_
+{
+  PATRICIA_NODE Node;
+  IPV4_ADDR Addr;		/* key, network order */
+  uns32 IfIndex;
+  uns8 RefreshReduction;
+  uns8 EpochValid;
+  uns32 Epoch;
+  uns32 *pSrefreshIds;
+  uns32 SrefreshIdCount;
+  uns32 SrefreshIdSize;
+  MESSAGE_ID_OBJ *pAcks;
+  uns8 *pAckCTypes;
+  uns32 AckCount;
+  uns32 AckSize;
+  RSVP_TIMER *FlushTimer;
+  uns32 SrefreshSent;
+  uns32 SrefreshRcvd;
+  uns32 FullRefreshSent;
+} RSVP_NEIGHBOR;
+
+typedef struct _rsvp_rr_statistics_
+{
+  uns32 SrefreshSentCount;
+  uns32 SrefreshRcvdCount;
+  uns32 MsgIdSummarizedCount;
+  uns32 MsgIdRefreshedCount;
+  uns32 FullRefreshCount;
+  uns32 AckSentCount;
+  uns32 AckRcvdCount;
+  uns32 NackSentCount;
+  uns32 NackRcvdCount;
+  uns32 BundleSentCount;
+  uns32 BundleRcvdCount;
+} RSVP_RR_STATISTICS;
+
+extern uns8 RefreshReductionEnabled;
+extern RSVP_RR_STATISTICS RsvpRrStatistics;
+
+#define RSVP_VERSION_FLAGS \
+  (RSVP_VERSION | (RefreshReductionEnabled ? RSVP_RR_CAPABLE_FLAG : 0))
+
+struct vty;
+
+E_RC InitRsvpRefreshReduction ();
+void RsvpRrNeighborSeen (IPV4_ADDR Addr, uns32 IfIndex, uns8 VersionFlags);
+uns8 RsvpRrRefresh (RSVP_MSG_ID_STATE * pState, uns8 MsgType, void *pOwner,
+		    IPV4_ADDR Neighbor, uns32 IfIndex,
+		    char **ppBuffer, uns16 * pBufferLen);
+void RsvpRrReleaseMsgId (RSVP_MSG_ID_STATE * pState);
+void RsvpRrMessageIdReceived (RSVP_PKT * pRsvpPkt, uns8 MsgType,
+			      IPV4_ADDR Neighbor, uns32 IfIndex);
+void RsvpRrProcessAck (MESSAGE_ID_OBJ * pAck, uns8 CType);
+void RsvpRrFlushAll ();
+E_RC RsvpRrProcessMsg (uns8 MsgType, uns8 * pData, uns32 Len,
+		       IPV4_ADDR Neighbor, uns32 IfIndex);
+void DumpRsvpNeighbors (struct vty *vty);
+void DumpRsvpRrStatistics (struct vty *vty);
+
+#endif
@@ -7,13 +7,14 @@ typedef struct _phop_resv_refresh_list_
   RSVP_HOP_OBJ PHop;
   uns32 InIfIndex;
   uns32 RefreshValue;
-  struct thread *ResvRefreshTimer;
+  RSVP_TIMER *ResvRefreshTimer;
   FILTER_LIST *pFilterList;
   RR_SUBOBJ *pAddedRro;
   FLOW_SPEC_OBJ FwdFlowSpec;	/* for SE only */
   uns8 MustBeProcessed;
   char *pSentBuffer;
   uns16 SentBufferLen;
+  RSVP_MSG_ID_STATE MsgIdState;
   struct _phop_resv_refresh_list_ *next;
 } PHOP_RESV_REFRESH_LIST;
 
@@ -53,6 +54,9 @@ E_RC NewFilterListNode (FILTER_LIST ** ppFilterListHead,
 E_RC ForwardResvTearMsg (RSB * pRsb);
 E_RC NewModifiedPath (PSB * pPsb);
 E_RC InitResvProcessing ();
+E_RC ResvRefreshPHop (PHOP_RESV_REFRESH_LIST * pPHopResvRefreshList);
+E_RC RsvpResvSummaryRefresh (RSB_KEY * pRsbKey,
+			     FILTER_SPEC_OBJ * pFilterSpecs, uns32 Count);
 E_RC ResvTeMsgProc (struct _te_api_msg_ *pMsg);
 void PreemptFlow (struct _te_api_msg_ *pMsg);
 E_RC RemoveRSB (RSB_KEY * pRsbKey);
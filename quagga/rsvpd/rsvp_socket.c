@@ -2,10 +2,51 @@
    Contains: RSVP socket routines
    Module creator: Vadim Suraev, vadim_suraev@hotmail.com
    */
+#include <zebra.h>
+
 #include "rsvp.h"
 #include "if.h"
 
+#ifndef HAVE_SENDMMSG
+#ifndef HAVE_RECVMMSG
+struct mmsghdr
+{
+  struct msghdr msg_hdr;
+  unsigned int msg_len;
+};
+#endif /* HAVE_RECVMMSG */
+
+/* Fallback sending a single datagram. */
+static int
+sendmmsg (int sock, struct mmsghdr *vec, unsigned int vlen, int flags)
+{
+  int ret;
+
+  ret = sendmsg (sock, &vec->msg_hdr, flags);
+  if (ret < 0)
+    return ret;
+  vec->msg_len = ret;
+  return 1;
+}
+#endif /* HAVE_SENDMMSG */
+
+#define RSVP_SEND_BATCH    16
+#define RSVP_SEND_BUF_SIZE 1500
+
+#define RSVP_SOCKOPT_UNKNOWN 0xFF
+
 typedef struct
+{
+  uns32 Count;
+  uns8 Ttl;
+  uns8 RouterAlert;
+  struct mmsghdr Msgs[RSVP_SEND_BATCH];
+  struct iovec Iov[RSVP_SEND_BATCH];
+  struct sockaddr_in Dest[RSVP_SEND_BATCH];
+  char Buffers[RSVP_SEND_BATCH][RSVP_SEND_BUF_SIZE];
+} SEND_QUEUE;
+
+typedef struct _if_node_
 {
   PATRICIA_NODE Node;
   uns32 IfIndex;
@@ -14,10 +55,20 @@ typedef struct
   IPV4_ADDR Peer;
   char IfName[20];
   struct thread *pThread;
+  int Ttl;			/* options the socket has, -1 - unknown */
+  uns8 RouterAlert;
+  SEND_QUEUE *pSendQueue;
+  uns8 SendPending;
+  struct _if_node_ *PendingNext;
+  uns32 SentMsgs;
+  uns32 SendCalls;
 } IF_NODE;
 
 PATRICIA_TREE IfTree;
 
+static uns32 SendBatchDepth;
+static IF_NODE *PendingIfList;
+
 char BigBuf[1024];
 
 extern struct thread_master *master;
@@ -85,13 +136,17 @@ InitInterfaceDB ()
 }
 
 E_RC
-SetRouterAlert (int sock)
+SetRouterAlert (int sock, uns8 RouterAlert)
 {
 #if defined(IPOPT_RA)
   static const char ra_opt[4] = { IPOPT_RA, 4, 0, 0 };
+  int rc;
 
-
-  if (setsockopt (sock, IPPROTO_IP, IP_OPTIONS, ra_opt, sizeof (ra_opt)))
+  if (RouterAlert == TRUE)
+    rc = setsockopt (sock, IPPROTO_IP, IP_OPTIONS, ra_opt, sizeof (ra_opt));
+  else
+    rc = setsockopt (sock, IPPROTO_IP, IP_OPTIONS, NULL, 0);
+  if (rc)
     {
       zlog_err ("Cannot set router alert %s %s %d", strerror (errno),
 		__FILE__, __LINE__);
@@ -143,6 +198,136 @@ SetTtl (int sock, uns16 ttl)
   return E_OK;
 }
 
+/* The socket keeps the options between the sends, so they are set only
+   when they differ from the ones of the previous message */
+static void
+SetIfSocketOptions (IF_NODE * pIfNode, uns8 ttl, uns8 RouterAlert)
+{
+  if (pIfNode->Ttl != ttl)
+    {
+      if (SetTtl (pIfNode->IfSocket, ttl) != E_OK)
+	{
+	  zlog_err ("Cannot set ttl");
+	  pIfNode->Ttl = -1;
+	}
+      else
+	pIfNode->Ttl = ttl;
+    }
+  if (pIfNode->RouterAlert != RouterAlert)
+    {
+      if (SetRouterAlert (pIfNode->IfSocket, RouterAlert) != E_OK)
+	{
+	  zlog_err ("Cannot set router alert");
+	  pIfNode->RouterAlert = RSVP_SOCKOPT_UNKNOWN;
+	}
+      else
+	pIfNode->RouterAlert = RouterAlert;
+    }
+}
+
+static void
+FlushSendQueue (IF_NODE * pIfNode)
+{
+  SEND_QUEUE *pQueue = pIfNode->pSendQueue;
+  uns32 Sent = 0;
+  int rc;
+
+  if ((pQueue == NULL) || (pQueue->Count == 0))
+    return;
+  SetIfSocketOptions (pIfNode, pQueue->Ttl, pQueue->RouterAlert);
+  while (Sent < pQueue->Count)
+    {
+      rc = sendmmsg (pIfNode->IfSocket, &pQueue->Msgs[Sent],
+		     pQueue->Count - Sent, 0);
+      if (rc <= 0)
+	{
+	  zlog_err ("an error occured on sendmmsg %s, %d messages dropped",
+		    strerror (errno), pQueue->Count - Sent);
+	  break;
+	}
+      pIfNode->SendCalls++;
+      Sent += rc;
+    }
+  pIfNode->SentMsgs += Sent;
+  RSVP_PKT_TRACE ("sent %d messages on %s", Sent, pIfNode->IfName);
+  pQueue->Count = 0;
+}
+
+static E_RC
+QueueRawData (IF_NODE * pIfNode, char *buffer, uns32 Len,
+	      IPV4_ADDR remote_addr, uns8 ttl, uns8 RouterAlert)
+{
+  SEND_QUEUE *pQueue = pIfNode->pSendQueue;
+  uns32 i;
+
+  if (pQueue == NULL)
+    {
+      if ((pQueue =
+	   (SEND_QUEUE *) XMALLOC (MTYPE_RSVP, sizeof (SEND_QUEUE))) == NULL)
+	{
+	  zlog_err ("cannot allocate memory %s %d", __FILE__, __LINE__);
+	  return E_ERR;
+	}
+      memset (pQueue, 0, sizeof (SEND_QUEUE));
+      pIfNode->pSendQueue = pQueue;
+    }
+  /* the options are per socket, so a batch carries messages which share
+     them */
+  if ((pQueue->Count != 0) &&
+      ((pQueue->Ttl != ttl) || (pQueue->RouterAlert != RouterAlert)))
+    FlushSendQueue (pIfNode);
+  if (pQueue->Count == RSVP_SEND_BATCH)
+    FlushSendQueue (pIfNode);
+  if (pQueue->Count == 0)
+    {
+      pQueue->Ttl = ttl;
+      pQueue->RouterAlert = RouterAlert;
+      if (pIfNode->SendPending == FALSE)
+	{
+	  pIfNode->SendPending = TRUE;
+	  pIfNode->PendingNext = PendingIfList;
+	  PendingIfList = pIfNode;
+	}
+    }
+  i = pQueue->Count++;
+  memcpy (pQueue->Buffers[i], buffer, Len);
+  memset (&pQueue->Dest[i], 0, sizeof (struct sockaddr_in));
+  pQueue->Dest[i].sin_family = AF_INET;
+  pQueue->Dest[i].sin_addr.s_addr = remote_addr;
+  pQueue->Iov[i].iov_base = pQueue->Buffers[i];
+  pQueue->Iov[i].iov_len = Len;
+  memset (&pQueue->Msgs[i], 0, sizeof (struct mmsghdr));
+  pQueue->Msgs[i].msg_hdr.msg_name = &pQueue->Dest[i];
+  pQueue->Msgs[i].msg_hdr.msg_namelen = sizeof (struct sockaddr_in);
+  pQueue->Msgs[i].msg_hdr.msg_iov = &pQueue->Iov[i];
+  pQueue->Msgs[i].msg_hdr.msg_iovlen = 1;
+  return E_OK;
+}
+
+/* Between RsvpSendBatchBegin and RsvpSendBatchEnd the messages are
+   queued per interface and leave in sendmmsg batches */
+void
+RsvpSendBatchBegin ()
+{
+  SendBatchDepth++;
+}
+
+void
+RsvpSendBatchEnd ()
+{
+  IF_NODE *pIfNode;
+
+  if ((SendBatchDepth == 0) || (--SendBatchDepth != 0))
+    return;
+  while ((pIfNode = PendingIfList) != NULL)
+    {
+      PendingIfList = pIfNode->PendingNext;
+      pIfNode->PendingNext = NULL;
+      pIfNode->SendPending = FALSE;
+      FlushSendQueue (pIfNode);
+    }
+}
+
 E_RC
 SendRawData (char *buffer, uns32 Len, IPV4_ADDR remote_addr, uns32 IfIndex,
 	     uns8 ttl, uns8 RouterAlert)
@@ -150,7 +335,7 @@ SendRawData (char *buffer, uns32 Len, IPV4_ADDR remote_addr, uns32 IfIndex,
   struct sockaddr_in saddr;
   int bytes_sent;
   IF_NODE *pIfNode;
-  zlog_info ("entering SendRawData");
+  RSVP_TRACE ("entering SendRawData");
   if ((pIfNode =
        (IF_NODE *) patricia_tree_get (&IfTree,
 				      (const uns8 *) &IfIndex)) == NULL)
@@ -160,27 +345,24 @@ SendRawData (char *buffer, uns32 Len, IPV4_ADDR remote_addr, uns32 IfIndex,
       return E_ERR;
     }
 
+  if ((SendBatchDepth != 0) && (Len <= RSVP_SEND_BUF_SIZE))
+    {
+      return QueueRawData (pIfNode, buffer, Len, remote_addr, ttl,
+			   RouterAlert);
+    }
+  /* keep the order of the messages already queued */
+  FlushSendQueue (pIfNode);
+
   memset ((char *) &saddr, 0x00, sizeof (saddr));
   saddr.sin_family = AF_INET;
   saddr.sin_addr.s_addr = remote_addr;
 
-
-  if (SetTtl (pIfNode->IfSocket, ttl) != E_OK)
-    {
-      zlog_err ("Cannot set ttl");
-    }
-
-  if (RouterAlert == TRUE)
-    {
-      if (SetRouterAlert (pIfNode->IfSocket) != E_OK)
-	{
-	  zlog_err ("Cannot set router alert");
-	}
-    }
+  SetIfSocketOptions (pIfNode, ttl, RouterAlert);
 
   bytes_sent =
     sendto (pIfNode->IfSocket, buffer, Len, 0, (struct sockaddr *) &saddr,
 	    sizeof (saddr));
+  pIfNode->SendCalls++;
   if (bytes_sent == -1)
     {
       zlog_err ("an error occured on sendto %s", strerror (errno));
@@ -191,10 +373,30 @@ SendRawData (char *buffer, uns32 Len, IPV4_ADDR remote_addr, uns32 IfIndex,
       zlog_err ("tried to send %d bytes, actually sent %d", Len, bytes_sent);
       return E_ERR;
     }
-  zlog_info ("leaving SendRawData");
+  pIfNode->SentMsgs++;
+  RSVP_TRACE ("leaving SendRawData");
   return E_OK;
 }
 
+void
+DumpRsvpSendStatistics (struct vty *vty)
+{
+  IF_NODE *pIfNode;
+  uns32 IfIndex = 0;
+
+  if (vty == NULL)
+    return;
+  vty_out (vty, "Interface  Messages   System calls%s", VTY_NEWLINE);
+  while ((pIfNode =
+	  (IF_NODE *) patricia_tree_getnext (&IfTree,
+					     (const uns8 *) &IfIndex)) != NULL)
+    {
+      vty_out (vty, "%-10s %-10d %-10d%s", pIfNode->IfName,
+	       pIfNode->SentMsgs, pIfNode->SendCalls, VTY_NEWLINE);
+      IfIndex = pIfNode->IfIndex;
+    }
+}
+
 int
 ProcessRsvpMsg (struct thread *pThread)
 {
@@ -214,7 +416,8 @@ ProcessRsvpMsg (struct thread *pThread)
       zlog_err (" an error %s on ioctl %s %d", strerror (errno), __FILE__,
 		__LINE__);
     }
-  zlog_info ("message received on %d %s", pIfNode->IfIndex, pIfNode->IfName);
+  RSVP_PKT_TRACE ("message received on %d %s", pIfNode->IfIndex,
+		  pIfNode->IfName);
   memset (BigBuf, 0, 1000);
   if ((PktLen =
        recvfrom (pIfNode->IfSocket, BigBuf, 1000, 0,
@@ -225,11 +428,13 @@ ProcessRsvpMsg (struct thread *pThread)
     }
   else
     {
-      zlog_info ("From %x", from.sin_addr.s_addr);
+      RSVP_PKT_TRACE ("From %x", from.sin_addr.s_addr);
       pIpHdr = BigBuf;
       PktLen -= (unsigned int) 4 *(*pIpHdr & 0xf);
+      RsvpSendBatchBegin ();
       DecodeAndProcessRsvpMsg (&BigBuf[(unsigned int) 4 * (*pIpHdr & 0xf)],
-			       PktLen, pIfNode->IfIndex, 0);
+			       PktLen, pIfNode->IfIndex, from.sin_addr.s_addr);
+      RsvpSendBatchEnd ();
     }
   pIfNode->pThread =
     thread_add_read (master, ProcessRsvpMsg, pIfNode, pIfNode->IfSocket);
@@ -393,6 +598,8 @@ EnableRsvpOnInterface (uns32 IfIndex)
 #endif
 
   pIfNode->IfSocket = sock;
+  pIfNode->Ttl = -1;
+  pIfNode->RouterAlert = FALSE;
   if (pIfNode->IpAddr != 0)
     {
       return EnableRsvpOnInterface2 (IfIndex);
@@ -418,6 +625,16 @@ DisableRsvpOnInterface (int IfIndex)
   if (pIfNode->pThread)
     thread_cancel (pIfNode->pThread);
   pIfNode->pThread = NULL;
+  if (pIfNode->SendPending == TRUE)
+    {
+      IF_NODE **ppIfNode = &PendingIfList;
+
+      while (*ppIfNode != pIfNode)
+	ppIfNode = &(*ppIfNode)->PendingNext;
+      *ppIfNode = pIfNode->PendingNext;
+    }
+  if (pIfNode->pSendQueue)
+    XFREE (MTYPE_RSVP, pIfNode->pSendQueue);
   close (pIfNode->IfSocket);
   if (patricia_tree_del (&IfTree, (PATRICIA_NODE *) & pIfNode->Node) != E_OK)
     {
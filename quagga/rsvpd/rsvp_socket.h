@@ -14,4 +14,7 @@ E_RC SendRawData (char *buffer,
 		  IPV4_ADDR remote_addr,
 		  uns32 IfIndex, uns8 ttl, uns8 RouterAlert);
 E_RC InitInterfaceDB ();
+void RsvpSendBatchBegin ();
+void RsvpSendBatchEnd ();
+void DumpRsvpSendStatistics (struct vty *vty);
 #endif
@@ -0,0 +1,242 @@
+/* Module:   rsvp_timer.c
+   Contains: refresh wheel - the timers of the RSVP state blocks
+   grouped in one second slots and processed slot by slot.
+   */
+#include "rsvp.h"
+#include "thread.h"
+
+extern struct thread_master *master;
+
+RSVP_WHEEL_STATISTICS RsvpWheelStatistics;
+
+/* slot heads of circular lists, a timer being processed is detached
+   from its slot and marked with RSVP_WHEEL_SLOTS */
+static RSVP_TIMER Wheel[RSVP_WHEEL_SLOTS];
+static uns32 SlotCount[RSVP_WHEEL_SLOTS];
+static uns32 CurrentSlot;
+static time_t WheelTime;
+static struct thread *WheelThread;
+static RSVP_TIMER *FreeTimers;
+
+static int RsvpTimerWheelTick (struct thread *);
+
+static time_t
+WheelNow ()
+{
+  struct timeval tv;
+
+  quagga_gettime (QUAGGA_CLK_MONOTONIC, &tv);
+  return tv.tv_sec;
+}
+
+static void
+TimerListInit (RSVP_TIMER * pHead)
+{
+  pHead->next = pHead;
+  pHead->prev = pHead;
+}
+
+static void
+TimerListAdd (RSVP_TIMER * pHead, RSVP_TIMER * pTimer)
+{
+  pTimer->next = pHead;
+  pTimer->prev = pHead->prev;
+  pHead->prev->next = pTimer;
+  pHead->prev = pTimer;
+}
+
+static void
+TimerListDel (RSVP_TIMER * pTimer)
+{
+  pTimer->prev->next = pTimer->next;
+  pTimer->next->prev = pTimer->prev;
+  pTimer->next = pTimer->prev = NULL;
+}
+
+static void
+WheelInsert (RSVP_TIMER * pTimer, uns32 Slot)
+{
+  pTimer->Slot = Slot;
+  TimerListAdd (&Wheel[Slot], pTimer);
+  if (++SlotCount[Slot] > RsvpWheelStatistics.SlotMax)
+    RsvpWheelStatistics.SlotMax = SlotCount[Slot];
+}
+
+E_RC
+InitRsvpTimerWheel ()
+{
+  uns32 i;
+
+  for (i = 0; i < RSVP_WHEEL_SLOTS; i++)
+    {
+      TimerListInit (&Wheel[i]);
+      SlotCount[i] = 0;
+    }
+  memset (&RsvpWheelStatistics, 0, sizeof (RSVP_WHEEL_STATISTICS));
+  CurrentSlot = 0;
+  WheelTime = WheelNow ();
+  return E_OK;
+}
+
+E_RC
+RsvpTimerAdd (int (*func) (RSVP_TIMER *), void *arg, uns32 time,
+	      RSVP_TIMER ** ppTimer)
+{
+  RSVP_TIMER *pTimer;
+
+  if (*ppTimer != NULL)
+    RsvpTimerCancel (ppTimer);
+  if ((pTimer = FreeTimers) != NULL)
+    FreeTimers = pTimer->next;
+  else if ((pTimer =
+	    (RSVP_TIMER *) XMALLOC (MTYPE_RSVP, sizeof (RSVP_TIMER))) == NULL)
+    {
+      zlog_err ("Cannot allocate memory %s %d", __FILE__, __LINE__);
+      return E_ERR;
+    }
+  if (WheelThread == NULL)
+    {
+      /* the wheel does not turn while empty */
+      WheelTime = WheelNow ();
+      WheelThread = thread_add_timer (master, RsvpTimerWheelTick, NULL, 1);
+    }
+  if (time == 0)
+    time = 1;
+  pTimer->func = func;
+  pTimer->arg = arg;
+  pTimer->ppRef = ppTimer;
+  pTimer->Rounds = (time - 1) / RSVP_WHEEL_SLOTS;
+  WheelInsert (pTimer, (CurrentSlot + time) % RSVP_WHEEL_SLOTS);
+  RsvpWheelStatistics.TimerCount++;
+  *ppTimer = pTimer;
+  return E_OK;
+}
+
+static void
+RsvpTimerFree (RSVP_TIMER * pTimer)
+{
+  pTimer->next = FreeTimers;
+  FreeTimers = pTimer;
+  RsvpWheelStatistics.TimerCount--;
+}
+
+void
+RsvpTimerCancel (RSVP_TIMER ** ppTimer)
+{
+  RSVP_TIMER *pTimer = *ppTimer;
+
+  if (pTimer == NULL)
+    return;
+  if (pTimer->Slot < RSVP_WHEEL_SLOTS)
+    SlotCount[pTimer->Slot]--;
+  TimerListDel (pTimer);
+  RsvpTimerFree (pTimer);
+  RsvpWheelStatistics.CancelledCount++;
+  *ppTimer = NULL;
+}
+
+static void
+ProcessSlot (uns32 Slot)
+{
+  RSVP_TIMER Batch, *pTimer;
+  uns32 Fired = 0;
+
+  if (Wheel[Slot].next == &Wheel[Slot])
+    return;
+  /* detach the slot so that the timers armed from the callbacks do not
+     land in the batch being processed */
+  Batch.next = Wheel[Slot].next;
+  Batch.prev = Wheel[Slot].prev;
+  Batch.next->prev = &Batch;
+  Batch.prev->next = &Batch;
+  TimerListInit (&Wheel[Slot]);
+  SlotCount[Slot] = 0;
+  for (pTimer = Batch.next; pTimer != &Batch; pTimer = pTimer->next)
+    pTimer->Slot = RSVP_WHEEL_SLOTS;
+
+  while ((pTimer = Batch.next) != &Batch)
+    {
+      TimerListDel (pTimer);
+      if (pTimer->Rounds != 0)
+	{
+	  pTimer->Rounds--;
+	  WheelInsert (pTimer, Slot);
+	  continue;
+	}
+      if (pTimer->ppRef != NULL)
+	*pTimer->ppRef = NULL;
+      pTimer->func (pTimer);
+      RsvpTimerFree (pTimer);
+      Fired++;
+    }
+  if (Fired != 0)
+    {
+      RsvpWheelStatistics.BatchCount++;
+      RsvpWheelStatistics.FiredCount += Fired;
+      if (Fired > RsvpWheelStatistics.BatchMax)
+	RsvpWheelStatistics.BatchMax = Fired;
+    }
+}
+
+static int
+RsvpTimerWheelTick (struct thread *thread)
+{
+  time_t Now = WheelNow ();
+  uns32 Processed = 0;
+
+  WheelThread = NULL;
+  if (Now < WheelTime)
+    WheelTime = Now;
+  RsvpSendBatchBegin ();
+  while (WheelTime < Now)
+    {
+      WheelTime++;
+      CurrentSlot = (CurrentSlot + 1) % RSVP_WHEEL_SLOTS;
+      ProcessSlot (CurrentSlot);
+      Processed++;
+    }
+  RsvpWheelStatistics.Lag = (Processed > 1) ? Processed - 1 : 0;
+  if (RsvpWheelStatistics.Lag > RsvpWheelStatistics.LagMax)
+    RsvpWheelStatistics.LagMax = RsvpWheelStatistics.Lag;
+
+  /* the Srefresh ids and acks queued by the batch go out packed per
+     neighbor, and the messages of the batch in sendmmsg bursts per
+     interface */
+  RsvpRrFlushAll ();
+  RsvpSendBatchEnd ();
+
+  if ((RsvpWheelStatistics.TimerCount != 0) && (WheelThread == NULL))
+    WheelThread = thread_add_timer (master, RsvpTimerWheelTick, NULL, 1);
+  return 0;
+}
+
+void
+DumpRsvpTimerWheel (struct vty *vty)
+{
+  uns32 i, Slot, Busy = 0, Max = 0;
+
+  for (i = 0; i < RSVP_WHEEL_SLOTS; i++)
+    {
+      if (SlotCount[i] != 0)
+	Busy++;
+      if (SlotCount[i] > Max)
+	Max = SlotCount[i];
+    }
+  vty_out (vty, "Timers %d in %d of %d slots, largest slot %d (ever %d)%s",
+	   RsvpWheelStatistics.TimerCount, Busy, RSVP_WHEEL_SLOTS, Max,
+	   RsvpWheelStatistics.SlotMax, VTY_NEWLINE);
+  vty_out (vty, "Batches %d, largest %d, fired %d, cancelled %d%s",
+	   RsvpWheelStatistics.BatchCount, RsvpWheelStatistics.BatchMax,
+	   RsvpWheelStatistics.FiredCount,
+	   RsvpWheelStatistics.CancelledCount, VTY_NEWLINE);
+  vty_out (vty, "Lag %d sec, max %d sec%s", RsvpWheelStatistics.Lag,
+	   RsvpWheelStatistics.LagMax, VTY_NEWLINE);
+  vty_out (vty, "Occupancy of the next 60 slots:%s", VTY_NEWLINE);
+  for (i = 1; i <= 60; i++)
+    {
+      Slot = (CurrentSlot + i) % RSVP_WHEEL_SLOTS;
+      vty_out (vty, " %5d", SlotCount[Slot]);
+      if ((i % 10) == 0)
+	vty_out (vty, "%s", VTY_NEWLINE);
+    }
+}
@@ -0,0 +1,45 @@
+
+#ifndef _RSVP_TIMER_H_
+#define _RSVP_TIMER_H_
+
+/* Refresh wheel.
+   All PSB/RSB refresh, age-out and blockade timers live in one wheel of
+   one second slots driven by a single thread timer, so arming a timer
+   is O(1) and every slot is processed as one batch. */
+
+#define RSVP_WHEEL_SLOTS 512
+
+typedef struct _rsvp_timer_
+{
+  struct _rsvp_timer_ *next;
+  struct _rsvp_timer_ *prev;
+  uns32 Slot;
+  uns32 Rounds;
+  int (*func) (struct _rsvp_timer_ *);
+  void *arg;
+  struct _rsvp_timer_ **ppRef;	/* owner's handle, cleared on expiry */
+} RSVP_TIMER;
+
+#define RSVP_TIMER_ARG(t) ((t)->arg)
+
+typedef struct _rsvp_wheel_statistics_
+{
+  uns32 TimerCount;
+  uns32 SlotMax;
+  uns32 BatchCount;
+  uns32 BatchMax;
+  uns32 FiredCount;
+  uns32 CancelledCount;
+  uns32 Lag;
+  uns32 LagMax;
+} RSVP_WHEEL_STATISTICS;
+
+struct vty;
+
+E_RC InitRsvpTimerWheel ();
+E_RC RsvpTimerAdd (int (*func) (RSVP_TIMER *), void *arg, uns32 time,
+		   RSVP_TIMER ** ppTimer);
+void RsvpTimerCancel (RSVP_TIMER ** ppTimer);
+void DumpRsvpTimerWheel (struct vty *vty);
+
+#endif
@@ -5,6 +5,8 @@
    */
 #include "rsvp.h"
 
+uns32 RsvpDebugFlags;
+
 
 #define LOG1(a1) \
 {\
@@ -305,18 +307,18 @@ void
 FreeFilterSpecData (FILTER_SPEC_DATA ** ppFilterSpecData)
 {
   FILTER_SPEC_DATA *pFilterSpecData = *ppFilterSpecData;
-  zlog_info ("entering FreeFilterSpecData");
+  RSVP_TRACE ("entering FreeFilterSpecData");
   FreeRRO (&pFilterSpecData->Rro);
   XFREE (MTYPE_RSVP, *ppFilterSpecData);
   *ppFilterSpecData = NULL;
-  zlog_info ("leaving FreeFilterSpecData");
+  RSVP_TRACE ("leaving FreeFilterSpecData");
 }
 
 void
 FreeRsvpPkt (RSVP_PKT * pRsvpPkt)
 {
   FILTER_LIST *pFilterList, *pFilterList2;
-  zlog_info ("entering FreeRsvpPkt");
+  RSVP_TRACE ("entering FreeRsvpPkt");
   FreeRRO (&pRsvpPkt->AddedRro);
   FreeRRO (&pRsvpPkt->ReceivedRro);
   FreeERO (&pRsvpPkt->ReceivedEro);
@@ -340,26 +342,26 @@ FreeRsvpPkt (RSVP_PKT * pRsvpPkt)
       pFilterList = pFilterList2;
     }
   XFREE (MTYPE_RSVP, pRsvpPkt);
-  zlog_info ("leaving FreeRsvpPkt");
+  RSVP_TRACE ("leaving FreeRsvpPkt");
 }
 
 E_RC
 EnqueueRsvpPacket (RSVP_PKT_QUEUE * pItem, RSVP_PKT_QUEUE ** ppQueueHead)
 {
   RSVP_PKT_QUEUE *pQueue;
-  zlog_info ("entering EnqueueRsvpPacket");
+  RSVP_TRACE ("entering EnqueueRsvpPacket");
 
   if ((*ppQueueHead) == NULL)
     {
       (*ppQueueHead) = pItem;
-      zlog_info ("leaving EnqueueRsvpPacket");
+      RSVP_TRACE ("leaving EnqueueRsvpPacket");
       return E_OK;
     }
   pQueue = (*ppQueueHead);
   while (pQueue->next != NULL)
     pQueue = pQueue->next;
   pQueue->next = pItem;
-  zlog_info ("leaving EnqueueRsvpPacket");
+  RSVP_TRACE ("leaving EnqueueRsvpPacket");
   return E_OK;
 }
 
@@ -367,14 +369,14 @@ RSVP_PKT_QUEUE *
 DequeueRsvpPacket (RSVP_PKT_QUEUE ** ppQueueHead)
 {
   RSVP_PKT_QUEUE *pTemp;
-  zlog_info ("entering DequeueRsvpPacket");
+  RSVP_TRACE ("entering DequeueRsvpPacket");
   if ((*ppQueueHead) == NULL)
     {
       return NULL;
     }
   pTemp = (*ppQueueHead);
   (*ppQueueHead) = (*ppQueueHead)->next;
-  zlog_info ("leaving DequeueRsvpPacket");
+  RSVP_TRACE ("leaving DequeueRsvpPacket");
   return pTemp;
 }
 
@@ -382,7 +384,8 @@ void
 FreePSB (PSB * pPsb)
 {
   RSVP_PKT_QUEUE *pQueueItem;
-  zlog_info ("entering FreePSB");
+  RSVP_TRACE ("entering FreePSB");
+  RsvpRrReleaseMsgId (&pPsb->MsgIdState);
   if (pPsb->pSentBuffer)
     {
       XFREE (MTYPE_RSVP, pPsb->pSentBuffer);
@@ -430,13 +433,13 @@ FreePSB (PSB * pPsb)
       zlog_err ("Freeing os PSB was not completed");
     }
   RsvpStatistics.DeletePsbCount++;
-  zlog_info ("leaving FreePSB");
+  RSVP_TRACE ("leaving FreePSB");
 }
 
 void
 FreeRSB (RSB * pRsb)
 {
-  zlog_info ("entering FreeRSB");
+  RSVP_TRACE ("entering FreeRSB");
   if (RemoveRSB (&pRsb->RsbKey) == E_OK)
     {
       FreeOpaqueObj (pRsb->OldPacket.pIntegrityObj);
@@ -449,7 +452,7 @@ FreeRSB (RSB * pRsb)
       zlog_err ("Cannot free RSB");
     }
   RsvpStatistics.DeleteRsbCount++;
-  zlog_info ("leaving FreeRSB");
+  RSVP_TRACE ("leaving FreeRSB");
 }
 
 E_RC
@@ -972,6 +975,8 @@ DumpRsvpStatistics (struct vty *vty)
 	RsvpStatistics.NewFiltersCount);
   LOG3 ("PathAgeOut %d FilterAgeOut %d", RsvpStatistics.PsbAgeOutCount,
 	RsvpStatistics.FilterAgeOutCount);
+  DumpRsvpRrStatistics (vty);
+  DumpRsvpSendStatistics (vty);
 }
 
 int
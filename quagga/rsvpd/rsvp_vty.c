@@ -137,7 +137,7 @@ DEFUN (mpls_te_tunnel,
   strcat (MplsTePrompt, ")# ");
   if ((pUserLsp = (USER_LSP *) XMALLOC (MTYPE_TE, sizeof (USER_LSP))) == NULL)
     {
-      zlog_info ("leaving UserLspAPI %s %d", __FILE__, __LINE__);
+      RSVP_TRACE ("leaving UserLspAPI %s %d", __FILE__, __LINE__);
       return CMD_SUCCESS;
     }
   memset (pUserLsp, 0, sizeof (USER_LSP));
@@ -168,7 +168,7 @@ DEFUN (mpls_te_tunnel,
 						   (LSP_PATH_SHARED_PARAMS)))
 	      == NULL)
 	    {
-	      zlog_info ("leaving UserLspAPI %s %d", __FILE__, __LINE__);
+	      RSVP_TRACE ("leaving UserLspAPI %s %d", __FILE__, __LINE__);
 	      return CMD_SUCCESS;
 	    }
 	  memcpy (pDestParams->PrimaryPathParams,
@@ -182,7 +182,7 @@ DEFUN (mpls_te_tunnel,
 						sizeof (SECONDARY_PATH_LIST)))
 	      == NULL)
 	    {
-	      zlog_info ("leaving UserLspAPI %s %d", __FILE__, __LINE__);
+	      RSVP_TRACE ("leaving UserLspAPI %s %d", __FILE__, __LINE__);
 	      return CMD_SUCCESS;
 	    }
 	  memset (pPathListTemp, 0, sizeof (SECONDARY_PATH_LIST));
@@ -204,7 +204,7 @@ DEFUN (mpls_te_tunnel,
 						       (LSP_PATH_SHARED_PARAMS)))
 		  == NULL)
 		{
-		  zlog_info ("leaving UserLspAPI %s %d", __FILE__, __LINE__);
+		  RSVP_TRACE ("leaving UserLspAPI %s %d", __FILE__, __LINE__);
 		  return CMD_SUCCESS;
 		}
 	      memcpy (pDestSecPathList->SecondaryPathParams,
@@ -493,6 +493,14 @@ DEFUN (show_mpls_te_path_cache,
   return CMD_SUCCESS;
 }
 
+DEFUN (show_mpls_te_cspf,
+       show_mpls_te_cspf_cmd,
+       "show mpls traffic-eng cspf", "MPLS TE in-process CSPF")
+{
+  DumpCspf (vty);
+  return CMD_SUCCESS;
+}
+
 DEFUN (show_mpls_te_remote_link,
        show_mpls_te_remote_link_cmd,
        "show mpls traffic-eng remote-link", "MPLS TE remote links cache")
@@ -590,6 +598,70 @@ DEFUN (show_rsvp_te_statistics,
   return CMD_SUCCESS;
 }
 
+DEFUN (show_rsvp_te_neighbors,
+       show_rsvp_te_neighbors_cmd,
+       "show rsvpte neighbors", "RSVP TE neighbors")
+{
+  DumpRsvpNeighbors (vty);
+  return CMD_SUCCESS;
+}
+
+DEFUN (show_rsvp_te_refresh_wheel,
+       show_rsvp_te_refresh_wheel_cmd,
+       "show rsvpte refresh-wheel", "RSVP TE refresh wheel")
+{
+  DumpRsvpTimerWheel (vty);
+  return CMD_SUCCESS;
+}
+
+static uns32
+RsvpDebugFlagByName (const char *name)
+{
+  if (strncmp (name, "t", 1) == 0)
+    return RSVP_DEBUG_TRACE;
+  return RSVP_DEBUG_PACKET;
+}
+
+DEFUN (debug_rsvp,
+       debug_rsvp_cmd,
+       "debug rsvp (trace|packet)",
+       DEBUG_STR
+       "RSVP information\n"
+       "Function entry/exit and state machine tracing\n"
+       "Received and sent objects\n")
+{
+  RsvpDebugFlags |= RsvpDebugFlagByName (argv[0]);
+  return CMD_SUCCESS;
+}
+
+DEFUN (no_debug_rsvp,
+       no_debug_rsvp_cmd,
+       "no debug rsvp (trace|packet)",
+       NO_STR
+       DEBUG_STR
+       "RSVP information\n"
+       "Function entry/exit and state machine tracing\n"
+       "Received and sent objects\n")
+{
+  RsvpDebugFlags &= ~RsvpDebugFlagByName (argv[0]);
+  return CMD_SUCCESS;
+}
+
+DEFUN (show_debugging_rsvp,
+       show_debugging_rsvp_cmd,
+       "show debugging rsvp",
+       SHOW_STR
+       "Debugging information\n"
+       "RSVP information\n")
+{
+  vty_out (vty, "RSVP debugging status:%s", VTY_NEWLINE);
+  if (IS_RSVP_DEBUG (TRACE))
+    vty_out (vty, "  RSVP trace debugging is on%s", VTY_NEWLINE);
+  if (IS_RSVP_DEBUG (PACKET))
+    vty_out (vty, "  RSVP packet debugging is on%s", VTY_NEWLINE);
+  return CMD_SUCCESS;
+}
+
 void
 rsvp_vty ()
 {
@@ -601,6 +673,7 @@ rsvp_vty ()
   install_element (VIEW_NODE, &show_mpls_te_tunnels_cmd);
   install_element (VIEW_NODE, &show_mpls_te_links_cmd);
   install_element (VIEW_NODE, &show_mpls_te_path_cache_cmd);
+  install_element (VIEW_NODE, &show_mpls_te_cspf_cmd);
   install_element (VIEW_NODE, &show_mpls_te_remote_link_cmd);
   install_element (VIEW_NODE, &show_mpls_te_next_hop_cmd);
   install_element (VIEW_NODE, &show_mpls_te_configured_paths_cmd);
@@ -610,6 +683,7 @@ rsvp_vty ()
   install_element (ENABLE_NODE, &show_mpls_te_tunnels_cmd);
   install_element (ENABLE_NODE, &show_mpls_te_links_cmd);
   install_element (ENABLE_NODE, &show_mpls_te_path_cache_cmd);
+  install_element (ENABLE_NODE, &show_mpls_te_cspf_cmd);
   install_element (ENABLE_NODE, &show_mpls_te_remote_link_cmd);
   install_element (ENABLE_NODE, &show_mpls_te_next_hop_cmd);
   install_element (ENABLE_NODE, &show_mpls_te_configured_paths_cmd);
@@ -653,4 +727,14 @@ rsvp_vty ()
 
   install_element (VIEW_NODE, &show_rsvp_te_statistics_cmd);
   install_element (ENABLE_NODE, &show_rsvp_te_statistics_cmd);
+  install_element (VIEW_NODE, &show_rsvp_te_neighbors_cmd);
+  install_element (ENABLE_NODE, &show_rsvp_te_neighbors_cmd);
+  install_element (VIEW_NODE, &show_rsvp_te_refresh_wheel_cmd);
+  install_element (ENABLE_NODE, &show_rsvp_te_refresh_wheel_cmd);
+
+  install_element (ENABLE_NODE, &show_debugging_rsvp_cmd);
+  install_element (ENABLE_NODE, &debug_rsvp_cmd);
+  install_element (ENABLE_NODE, &no_debug_rsvp_cmd);
+  install_element (CONFIG_NODE, &debug_rsvp_cmd);
+  install_element (CONFIG_NODE, &no_debug_rsvp_cmd);
 }
@@ -37,6 +37,7 @@
 
 #include "rsvp.h"
 #include "te.h"
+#include "te_cspf.h"
 
 /* Zebra structure to hold current status. */
 struct zclient *zclient = NULL;
@@ -432,6 +433,24 @@ case RemoteLsUpdate:
 
   LinkProperties.LinkType = PSC_PATH;
 
+  {
+    CSPF_LINK_INFO LinkInfo;
+
+    LinkInfo.RouterId = link->routerid.s_addr;
+    LinkInfo.LocalIp = link->from_node.s_addr;
+    LinkInfo.RemoteIp = link->to_node.s_addr;
+    LinkInfo.TeMetric = link->metric;
+    LinkInfo.ColorMask = link->color_mask;
+    LinkInfo.MaxLspBW = link->max_lsp_bw;
+    LinkInfo.MaxReservableBW = link->max_res_bw;
+    for (j = 0; j < 8; j++)
+      LinkInfo.ReservableBW[j] = link->reservable_bw[j];
+    if (CspfLinkUpdate (&LinkInfo) != E_OK)
+      {
+        zlog_err ("\nCannot update CSPF link");
+      }
+  }
+
   if (rdb_link_state_update (link->from_node.s_addr, link->to_node.s_addr, &LinkProperties) != E_OK)
     {
       zlog_err ("\nFailure");
@@ -439,6 +458,7 @@ case RemoteLsUpdate:
 }
 break;
 case ConnectivityBroken:
+  CspfLinkDelete (link->from_node.s_addr, link->to_node.s_addr);
   if (rdb_connectivity_broken (link->from_node.s_addr, link->to_node.s_addr, PSC_PATH) != E_OK)
     {
       zlog_err ("\nfailed");
@@ -30,6 +30,7 @@
 #include "zclient.h"
 
 #include "general.h"
+#include "rsvp_timer.h"
 #include "messages.h"
 #include "rsvp_packet.h"
 #include "te_lib.h"
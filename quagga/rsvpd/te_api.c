@@ -3,6 +3,7 @@
    Module creator: Vadim Suraev, vadim_suraev@hotmail.com
    */
 #include "te.h"
+#include "te_cspf.h"
 
 #define MAX_FLOAT 40000000000.0
 
@@ -44,15 +45,68 @@ TE_RSVPTE_API_TransitReqAPI (TE_API_MSG * dmsg)
   return;
 }
 
+static void
+PathAdd (IPV4_ADDR dest_ip, TE_HOP * er_hops, int hop_count)
+{
+  PATH *pPath;
+  float PathMinReservableBW[8], PathMaxBW = MAX_FLOAT, PathMaxReservableBW = MAX_FLOAT;	/*FIXME!! */
+  int i, j, SumTeMetric = 0;
+
+  pPath = (PATH *) XMALLOC (MTYPE_TE, sizeof (PATH));
+  if (pPath == NULL)
+    {
+      zlog_err ("Cannot allocate memory %s %d", __FILE__, __LINE__);
+      XFREE (MTYPE_TE, er_hops);
+      return;
+    }
+  memset (pPath, 0, sizeof (PATH));
+  for (i = 0; i < 8; i++)
+    {
+      PathMinReservableBW[i] = MAX_FLOAT;
+    }
+
+  for (i = 0; i < hop_count; i++)
+    {
+      if (er_hops[i].MaxLspBW < PathMaxBW)
+	PathMaxBW = er_hops[i].MaxLspBW;
+      for (j = 0; j < 8; j++)
+	{
+	  if (er_hops[i].ReservableBW[j] < PathMinReservableBW[j])
+	    PathMinReservableBW[j] = er_hops[i].ReservableBW[j];
+	}
+      SumTeMetric += er_hops[i].te_metric;
+      if (er_hops[i].MaxReservableBW < PathMaxReservableBW)
+	PathMaxReservableBW = er_hops[i].MaxReservableBW;
+    }
+  if (hop_count == 0)
+    {
+      XFREE (MTYPE_TE, er_hops);
+      er_hops = NULL;
+    }
+  pPath->u.er_hops = er_hops;
+  pPath->PathProperties.PathType = PSC_PATH;
+  pPath->PathProperties.PathHopCount = hop_count;
+  pPath->PathProperties.PathMaxLspBW = PathMaxBW;
+  pPath->PathProperties.PathMaxReservableBW = PathMaxReservableBW;
+
+  for (j = 0; j < 8; j++)
+    pPath->PathProperties.PathReservableBW[j] = PathMinReservableBW[j];
+
+  pPath->PathProperties.PathSumTeMetric = SumTeMetric;
+  pPath->destination = dest_ip;
+  if (rdb_add_mod_path (dest_ip, pPath) != E_OK)
+    {
+      zlog_err ("Cannot add path");
+    }
+}
+
 void
 TE_IGP_API_PathAdd (void *pBuf, int Len)
 {
   char *p;
-  PATH *pPath;
   IPV4_ADDR dest_ip;
   TE_HOP *er_hops;
-  float PathMinReservableBW[8], PathMaxBW = MAX_FLOAT, PathMaxReservableBW = MAX_FLOAT;	/*FIXME!! */
-  int hop_count, i, j, SumTeMetric = 0;
+  int hop_count, i, j;
   zlog_info ("PathAdd");
 
 
@@ -70,23 +124,12 @@ TE_IGP_API_PathAdd (void *pBuf, int Len)
       return;
     }
   hop_count = Len / sizeof (TE_HOP);
-  pPath = (PATH *) XMALLOC (MTYPE_TE, sizeof (PATH));
-  if (pPath == NULL)
-    {
-      zlog_err ("Cannot allocate memory %s %d", __FILE__, __LINE__);
-      return;
-    }
-  memset (pPath, 0, sizeof (PATH));
   er_hops = (TE_HOP *) XMALLOC (MTYPE_TE, sizeof (TE_HOP) * hop_count);
   if (er_hops == NULL)
     {
       zlog_err ("Cannot allocate memory %s %d", __FILE__, __LINE__);
       return;
     }
-  for (i = 0; i < 8; i++)
-    {
-      PathMinReservableBW[i] = MAX_FLOAT;
-    }
 
   for (i = 0; i < hop_count; i++)
     {
@@ -102,40 +145,45 @@ TE_IGP_API_PathAdd (void *pBuf, int Len)
 	  p += sizeof (float);
 	}
       er_hops[i].MaxLspBW = *((float *) p);
-      if (er_hops[i].MaxLspBW < PathMaxBW)
-	PathMaxBW = er_hops[i].MaxLspBW;
       p += sizeof (float);
-
-      for (j = 0; j < 8; j++)
-	{
-	  if (er_hops[i].ReservableBW[j] < PathMinReservableBW[j])
-	    PathMinReservableBW[j] = er_hops[i].ReservableBW[j];
-	}
       er_hops[i].te_metric = *((int *) p);
       p += sizeof (int);
-      SumTeMetric += er_hops[i].te_metric;
       er_hops[i].ColorMask = *((int *) p);
       p += sizeof (int);
-      if (er_hops[i].MaxReservableBW < PathMaxReservableBW)
-	PathMaxReservableBW = er_hops[i].MaxReservableBW;
     }
-  if (hop_count == 0)
-    er_hops = NULL;
-  pPath->u.er_hops = er_hops;
-  pPath->PathProperties.PathType = PSC_PATH;
-  pPath->PathProperties.PathHopCount = hop_count;
-  pPath->PathProperties.PathMaxLspBW = PathMaxBW;
-  pPath->PathProperties.PathMaxReservableBW = PathMaxReservableBW;
+  PathAdd (dest_ip, er_hops, hop_count);
+}
 
-  for (j = 0; j < 8; j++)
-    pPath->PathProperties.PathReservableBW[j] = PathMinReservableBW[j];
+/* the same for a path computed by the in-process CSPF */
+void
+TE_CSPF_API_PathAdd (IPV4_ADDR dest_ip, CSPF_PATH * pCspfPath)
+{
+  TE_HOP *er_hops;
+  CSPF_LINK_INFO *pHop;
+  uns32 i;
 
-  pPath->PathProperties.PathSumTeMetric = SumTeMetric;
-  pPath->destination = dest_ip;
-  if (rdb_add_mod_path (dest_ip, pPath) != E_OK)
+  er_hops =
+    (TE_HOP *) XMALLOC (MTYPE_TE,
+			sizeof (TE_HOP) * (pCspfPath->HopCount + 1));
+  if (er_hops == NULL)
     {
-      zlog_err ("Cannot add path");
+      zlog_err ("Cannot allocate memory %s %d", __FILE__, __LINE__);
+      return;
+    }
+  memset (er_hops, 0, sizeof (TE_HOP) * pCspfPath->HopCount);
+  for (i = 0; i < pCspfPath->HopCount; i++)
+    {
+      pHop = &pCspfPath->pHops[i];
+      er_hops[i].local_ip = pHop->LocalIp;
+      er_hops[i].remote_ip = pHop->RemoteIp;
+      er_hops[i].MaxReservableBW = pHop->MaxReservableBW;
+      memcpy (er_hops[i].ReservableBW, pHop->ReservableBW,
+	      sizeof (er_hops[i].ReservableBW));
+      er_hops[i].MaxLspBW = pHop->MaxLspBW;
+      er_hops[i].te_metric = pHop->TeMetric;
+      er_hops[i].ColorMask = pHop->ColorMask;
     }
+  PathAdd (dest_ip, er_hops, pCspfPath->HopCount);
 }
 
 void
@@ -410,7 +410,7 @@ BwPreemptionUseful (uns32 IfIndex, uns8 SetupPriority, float RequiredBW,
   IF_BW_KEY if_bw_key;
   IF_BW_DATA *pIfBwEntry;
   int j;
-  zlog_info ("entering BwPreemptionUseful");
+  RSVP_TRACE ("entering BwPreemptionUseful");
   (*MaximumPossibleBW) = 0;
   memset (&if_bw_key, 0, sizeof (IF_BW_KEY));
   if_bw_key.IfIndex = IfIndex;
@@ -425,13 +425,13 @@ BwPreemptionUseful (uns32 IfIndex, uns8 SetupPriority, float RequiredBW,
 	  if ((*MaximumPossibleBW) >= RequiredBW)
 	    {
 	      *PreemptedPriority = j;
-	      zlog_info ("leaving BwPreemptionUseful+");
+	      RSVP_TRACE ("leaving BwPreemptionUseful+");
 	      return TRUE;
 	    }
 	  if_bw_key = pIfBwEntry->if_bw_key;
 	}
     }
-  zlog_info ("leaving BwPreemptionUseful-");
+  RSVP_TRACE ("leaving BwPreemptionUseful-");
   return FALSE;
 }
 
@@ -490,7 +490,7 @@ te_timer_expiry (struct thread *thread)
 uns32
 te_start_timer (TE_TMR * tmr, TE_TMR_E type, uns32 period)
 {
-  zlog_info ("entering te_start_timer");
+  RSVP_TRACE ("entering te_start_timer");
   if (tmr->thread)
     {
       te_stop_timer (tmr);
@@ -502,7 +502,7 @@ te_start_timer (TE_TMR * tmr, TE_TMR_E type, uns32 period)
       THREAD_VAL (tmr->thread) = period;
       tmr->is_active = TRUE;
     }
-  zlog_info ("leaving te_start_timer");
+  RSVP_TRACE ("leaving te_start_timer");
   return E_OK;
 }
 
@@ -510,14 +510,14 @@ void
 te_stop_timer (TE_TMR * tmr)
 {
   /* Stop the timer if it is active... */
-  zlog_info ("entering te_stop_timer");
+  RSVP_TRACE ("entering te_stop_timer");
   if (tmr->is_active == TRUE)
     {
       thread_cancel (tmr->thread);
       tmr->thread = NULL;
       tmr->is_active = FALSE;
     }
-  zlog_info ("leaving te_stop_timer");
+  RSVP_TRACE ("leaving te_stop_timer");
 }
 #endif
 
@@ -889,7 +889,7 @@ TE_RSVPTE_API_RsvpTunnelEstablished (RESV_NOTIFICATION * resv_notif)
   LSP_SM_NOTIF_DATA *pLspSmNotifData = NULL;
   SM_CALL_T *pCall = NULL;
   int i;
-  zlog_info ("entering of RsvpTunnelEstablished");
+  RSVP_TRACE ("entering of RsvpTunnelEstablished");
   memset (&PsbKey, 0, sizeof (PSB_KEY));
   PsbKey.Session = resv_notif->RsbKey.Session;
 
@@ -972,7 +972,7 @@ TE_RSVPTE_API_RsvpTunnelEstablished (RESV_NOTIFICATION * resv_notif)
 	}
       sm_call (pCall);
     }
-  zlog_info ("leaving of RsvpTunnelEstablished");
+  RSVP_TRACE ("leaving of RsvpTunnelEstablished");
 }
 
 
@@ -1483,17 +1483,17 @@ USER_LSP *
 UserLspGet (char *pLspName)
 {
   USER_LSP_LIST *pUserLsp = UserLspListHead;
-  zlog_info ("entering UserLspGet");
+  RSVP_TRACE ("entering UserLspGet");
   while (pUserLsp != NULL)
     {
       if (strcmp (pLspName, pUserLsp->lsp->params.LspName) == 0)
 	{
-	  zlog_info ("leaving UserLspGet+");
+	  RSVP_TRACE ("leaving UserLspGet+");
 	  return pUserLsp->lsp;
 	}
       pUserLsp = pUserLsp->next;
     }
-  zlog_info ("leaving UserLspGet-");
+  RSVP_TRACE ("leaving UserLspGet-");
   return NULL;
 }
 
@@ -1651,7 +1651,7 @@ CreateRequest2Signalling (IPV4_ADDR dest,
   INGRESS_API *pOpenLspParams;
   int i;
 
-  zlog_info ("entering CreateRequest2Signalling");
+  RSVP_TRACE ("entering CreateRequest2Signalling");
 
   if ((pOpenLspParams =
        (INGRESS_API *) XMALLOC (MTYPE_TE, sizeof (INGRESS_API))) == NULL)
@@ -1680,6 +1680,6 @@ CreateRequest2Signalling (IPV4_ADDR dest,
   pOpenLspParams->ExcludeAny = ExcludeAny;
   pOpenLspParams->IncludeAny = IncludeAny;
   pOpenLspParams->IncludeAll = IncludeAll;
-  zlog_info ("leaving CreateRequest2Signalling");
+  RSVP_TRACE ("leaving CreateRequest2Signalling");
   return pOpenLspParams;
 }
@@ -154,7 +154,7 @@ RegisterClient (int handle, int instance, IPV4_ADDR dest, void *pSm)
 {
   CR_CLIENT_NODE *pCrClientNode;
   CR_CLIENT_KEY key;
-  zlog_info ("entering RegisterClient");
+  RSVP_TRACE ("entering RegisterClient");
   key.handle = handle;
   key.instance = instance;
 
@@ -219,7 +219,7 @@ RegisterClient (int handle, int instance, IPV4_ADDR dest, void *pSm)
 	}
       pCrClientNode->dest = dest;
 //      pCrClientNode->sm = pSm;
-      zlog_info ("leaving RegisterClient1");
+      RSVP_TRACE ("leaving RegisterClient1");
       return;
     }
 
@@ -243,7 +243,7 @@ RegisterClient (int handle, int instance, IPV4_ADDR dest, void *pSm)
     {
       zlog_err ("cannot create CR request %s %d", __FILE__, __LINE__);
     }
-  zlog_info ("leaving RegisterClient2");
+  RSVP_TRACE ("leaving RegisterClient2");
 }
 
 void
@@ -252,7 +252,7 @@ UnregisterClient (int handle, int TunnelId)
   CR_CLIENT_NODE *pCrClientNode;
   CR_CLIENT_KEY key;
 
-  zlog_info ("entering UnregisterClient");
+  RSVP_TRACE ("entering UnregisterClient");
 
   key.handle = handle;
   key.instance = TunnelId;
@@ -312,14 +312,14 @@ UnregisterClient (int handle, int TunnelId)
 	      constraint_route_resolution_sm_destroy (pCrReqList->pSm);
 	      XFREE (MTYPE_TE, pCrReqList);
 	      XFREE (MTYPE_TE, pCrClientNode);
-	      zlog_info ("leaving UnregisterClient2");
+	      RSVP_TRACE ("leaving UnregisterClient2");
 	      return;
 	    }
 	  pCrReqListPrev = pCrReqList;
 	  pCrReqList = pCrReqList->next;
 	}
     }
-  zlog_info ("leaving UnregisterClient3");
+  RSVP_TRACE ("leaving UnregisterClient3");
 }
 
 int
@@ -382,12 +382,12 @@ CspfReply (IPV4_ADDR dest, void *handle)
   CR_CLIENT_NODE *pCrClientNode;
   CR_CLIENT_KEY key;
   int rc;
-  zlog_info ("entering CspfReply");
+  RSVP_TRACE ("entering CspfReply");
   if ((pCrNode =
        (CR_REQ_NODE *) patricia_tree_get (&ConstraintRouteResReqTree,
 					  (const uns8 *) &dest)) == NULL)
     {
-      zlog_info ("leaving CspfReply1 %x", dest);
+      RSVP_TRACE ("leaving CspfReply1 %x", dest);
       return;
     }
   pCrReqList = pCrNode->pCrReqList;
@@ -445,7 +445,7 @@ CspfReply (IPV4_ADDR dest, void *handle)
 		      XFREE (MTYPE_TE, pCrNode);
 		    }
 		  XFREE (MTYPE_TE, pCrReqList);
-		  zlog_info ("leaving CspfReply2");
+		  RSVP_TRACE ("leaving CspfReply2");
 		  return;
 		}
 	    }
@@ -526,7 +526,7 @@ CspfReply (IPV4_ADDR dest, void *handle)
 		  XFREE (MTYPE_TE, pCrNode);
 		}
 	      XFREE (MTYPE_TE, pCrReqList);
-	      zlog_info ("leaving CspfReply3");
+	      RSVP_TRACE ("leaving CspfReply3");
 	      return;
 	    }
 	}
@@ -536,7 +536,7 @@ CspfReply (IPV4_ADDR dest, void *handle)
 	  pCrReqList = pCrReqList->next;
 	}
     }
-  zlog_info ("leaving CspfReply4");
+  RSVP_TRACE ("leaving CspfReply4");
 }
 
 E_RC
@@ -546,7 +546,7 @@ CreateConstraintRouteResReq (SM_T * pSm, int handle)
   CR_REQUESTS_LIST *pCrReqList, *pCrReqListNew;
   CONSTRAINT_ROUTE_RESOLUTION_ARGS *pCrArgs;
 
-  zlog_info ("entering CreateConstraintRouteResReq");
+  RSVP_TRACE ("entering CreateConstraintRouteResReq");
 
   pCrArgs = ((CONSTRAINT_ROUTE_RESOLUTION_SM_DATA *) (pSm->data))->args;
 
@@ -583,22 +583,22 @@ CreateConstraintRouteResReq (SM_T * pSm, int handle)
 	  XFREE (MTYPE_TE, pCrNode);
 	  return E_ERR;
 	}
-      zlog_info ("leaving CreateConstraintRouteResReq0 %x",
-		 ((CONSTRAINT_ROUTE_RESOLUTION_SM_DATA *) (pSm->data))->args);
+      RSVP_TRACE ("leaving CreateConstraintRouteResReq0 %x",
+		  ((CONSTRAINT_ROUTE_RESOLUTION_SM_DATA *) (pSm->data))->args);
       return E_OK;
     }
   pCrReqList = pCrNode->pCrReqList;
   if (!pCrReqList)
     {
       pCrNode->pCrReqList = pCrReqListNew;
-      zlog_info ("leaving CreateConstraintRouteResReq1 %x",
-		 ((CONSTRAINT_ROUTE_RESOLUTION_SM_DATA *) (pSm->data))->args);
+      RSVP_TRACE ("leaving CreateConstraintRouteResReq1 %x",
+		  ((CONSTRAINT_ROUTE_RESOLUTION_SM_DATA *) (pSm->data))->args);
       return E_OK;
     }
   while (pCrReqList->next != NULL)
     pCrReqList = pCrReqList->next;
   pCrReqList->next = pCrReqListNew;
-  zlog_info ("leaving CreateConstraintRouteResReq2");
+  RSVP_TRACE ("leaving CreateConstraintRouteResReq2");
   return E_OK;
 }
 
@@ -611,14 +611,88 @@ constraint_route_resolution_sm_empty_handler (SM_T * pSm,
   return NULL;
 }
 
+/* Resolves the route with the in-process CSPF and feeds the path to the
+   path cache, the result is delivered to the caller synchronously.
+   Until the TE database is learned the request is sent to the IGP. */
+static SM_CALL_T *
+ConstraintRouteResolutionCspf (SM_T * pSm,
+			       CONSTRAINT_ROUTE_RESOLUTION_ARGS * pCrArgs)
+{
+  SM_CALL_T *pCall = NULL;
+  SM_EVENT_E event = CONSTRAINT_ROUTE_RESOLVE_FAILED_EVENT;
+  CSPF_REQUEST *pCspfRequest;
+  CSPF_PATH Path;
+  int Len = 0, *pMessage;
+  E_RC rc;
+
+  if ((pCspfRequest = CreateCspfRequest (pCrArgs->dest,
+					 pCrArgs->SetupPriority,
+					 pCrArgs->ExclColorMask,
+					 pCrArgs->InclAnyColorMask,
+					 pCrArgs->InclColorMask,
+					 pCrArgs->HopCount,
+					 pCrArgs->BW,
+					 pCrArgs->LinkBwNumber,
+					 (LINK_BW *) pCrArgs->pLinkBw,
+					 pCrArgs->AvoidHopNumber,
+					 pCrArgs->AvoidHopsArray,
+					 pCrArgs->ExcludeHopNumber,
+					 pCrArgs->ExcludeHopsArray,
+					 &Len, &pMessage)) == NULL)
+    {
+      return NULL;
+    }
+  pCspfRequest->handle = pSm;
+  if (CspfLinkCount () == 0)
+    {
+      te_send_msg (pMessage, Len);
+      XFREE (MTYPE_TE, pMessage);
+      RegisterClient ((int) pSm->caller,
+		      pCrArgs->PsbKey.Session.TunnelId, pCrArgs->dest, pSm);
+      return NULL;
+    }
+  rc = CspfCompute (rdb_get_router_id (), pCspfRequest, &Path);
+  XFREE (MTYPE_TE, pMessage);
+  if (rc == E_OK)
+    {
+      TE_CSPF_API_PathAdd (pCrArgs->dest, &Path);
+      CspfPathFree (&Path);
+      if (IntraAreaConstraintRouteResolution (pSm, pCrArgs) != E_OK)
+	{
+	  zlog_info ("intra-area constraint route resolution is failed");
+	}
+      else
+	{
+	  switch (pCrArgs->rc)
+	    {
+	    case OUTPUT_LSP_SETUP_PENDING:
+	      pSm->state = CONSTAINT_ROUTE_RESOLUTION_SM_ADAPTIVITY_STATE;
+	      return NULL;
+	    case OUTPUT_EGRESS:
+	    case OUTPUT_LSP:
+	    case OUTPUT_NEXT_HOP:
+	    case OUTPUT_PATH:
+	      event = CONSTRAINT_ROUTE_RESOLVED_EVENT;
+	      break;
+	    default:
+	      break;
+	    }
+	}
+    }
+  if ((pCall = sm_gen_sync_event_send (pSm->caller, event, pCrArgs)) == NULL)
+    {
+      zlog_err ("cannot send sycn event %s %d", __FILE__, __LINE__);
+    }
+  constraint_route_resolution_sm_destroy (pSm);
+  return pCall;
+}
+
 static SM_CALL_T *
 constraint_route_resolution_sm_init (SM_T * pSm, SM_EVENT_T * sm_event)
 {
   SM_CALL_T *pCall = NULL;
   CONSTRAINT_ROUTE_RESOLUTION_ARGS *pCrArgs = NULL;
   DESTINATION_TYPE_E type;
-  CSPF_REQUEST *pCspfRequest;
-  int Len = 0, *pMessage;
   SM_EVENT_E event = CONSTRAINT_ROUTE_RESOLVE_FAILED_EVENT;
 
 
@@ -658,30 +732,7 @@ constraint_route_resolution_sm_init (SM_T * pSm, SM_EVENT_T * sm_event)
 
       if ((DontUsePathCash) || (pCrArgs->AvoidHopNumber != 0))
 	{
-	  if ((pCspfRequest = CreateCspfRequest (pCrArgs->dest,
-						 pCrArgs->SetupPriority,
-						 pCrArgs->ExclColorMask,
-						 pCrArgs->InclAnyColorMask,
-						 pCrArgs->InclColorMask,
-						 pCrArgs->HopCount,
-						 pCrArgs->BW,
-						 pCrArgs->LinkBwNumber,
-						 (LINK_BW *) pCrArgs->pLinkBw,
-						 pCrArgs->AvoidHopNumber,
-						 pCrArgs->AvoidHopsArray,
-						 pCrArgs->ExcludeHopNumber,
-						 pCrArgs->ExcludeHopsArray,
-						 &Len, &pMessage)) == NULL)
-	    {
-	      return NULL;
-	    }
-	  pCspfRequest->handle = pSm;
-	  te_send_msg (pMessage, Len);
-	  XFREE (MTYPE_TE, pMessage);
-	  RegisterClient ((int) pSm->caller,
-			  pCrArgs->PsbKey.Session.TunnelId,
-			  pCrArgs->dest, pSm);
-	  return NULL;
+	  return ConstraintRouteResolutionCspf (pSm, pCrArgs);
 	}
 
       if (TunnelsTunnel2BeModified (pCrArgs, pSm) == TRUE)
@@ -740,34 +791,7 @@ constraint_route_resolution_sm_init (SM_T * pSm, SM_EVENT_T * sm_event)
 	      break;
 	    case OUTPUT_CAC_FAILED:
 	    case OUTPUT_UNREACHABLE:
-	      if ((pCspfRequest = CreateCspfRequest (pCrArgs->dest,
-						     pCrArgs->SetupPriority,
-						     pCrArgs->ExclColorMask,
-						     pCrArgs->
-						     InclAnyColorMask,
-						     pCrArgs->InclColorMask,
-						     pCrArgs->HopCount,
-						     pCrArgs->BW,
-						     pCrArgs->LinkBwNumber,
-						     (LINK_BW *) pCrArgs->
-						     pLinkBw,
-						     pCrArgs->AvoidHopNumber,
-						     pCrArgs->AvoidHopsArray,
-						     pCrArgs->
-						     ExcludeHopNumber,
-						     pCrArgs->
-						     ExcludeHopsArray, &Len,
-						     &pMessage)) == NULL)
-		{
-		  return NULL;
-		}
-	      pCspfRequest->handle = pSm;
-	      te_send_msg (pMessage, Len);
-	      XFREE (MTYPE_TE, pMessage);
-	      RegisterClient ((int) pSm->caller,
-			      pCrArgs->PsbKey.Session.TunnelId,
-			      pCrArgs->dest, pSm);
-	      return NULL;
+	      return ConstraintRouteResolutionCspf (pSm, pCrArgs);
 	    default:
 	      zlog_err ("default case %s %d", __FILE__, __LINE__);
 	      event = CONSTRAINT_ROUTE_RESOLVE_FAILED_EVENT;
@@ -810,34 +834,7 @@ constraint_route_resolution_sm_init (SM_T * pSm, SM_EVENT_T * sm_event)
 	      break;
 	    case OUTPUT_CAC_FAILED:
 	    case OUTPUT_UNREACHABLE:
-	      if ((pCspfRequest = CreateCspfRequest (pCrArgs->dest,
-						     pCrArgs->SetupPriority,
-						     pCrArgs->ExclColorMask,
-						     pCrArgs->
-						     InclAnyColorMask,
-						     pCrArgs->InclColorMask,
-						     pCrArgs->HopCount,
-						     pCrArgs->BW,
-						     pCrArgs->LinkBwNumber,
-						     (LINK_BW *) pCrArgs->
-						     pLinkBw,
-						     pCrArgs->AvoidHopNumber,
-						     pCrArgs->AvoidHopsArray,
-						     pCrArgs->
-						     ExcludeHopNumber,
-						     pCrArgs->
-						     ExcludeHopsArray, &Len,
-						     &pMessage)) == NULL)
-		{
-		  return NULL;
-		}
-	      pCspfRequest->handle = pSm;
-	      te_send_msg (pMessage, Len);
-	      XFREE (MTYPE_TE, pMessage);
-	      RegisterClient ((int) pSm->caller,
-			      pCrArgs->PsbKey.Session.TunnelId,
-			      pCrArgs->dest, pSm);
-	      return NULL;
+	      return ConstraintRouteResolutionCspf (pSm, pCrArgs);
 	    default:
 	      zlog_err ("default case %s %d", __FILE__, __LINE__);
 	      event = CONSTRAINT_ROUTE_RESOLVE_FAILED_EVENT;
@@ -890,30 +887,7 @@ constraint_route_resolution_sm_init (SM_T * pSm, SM_EVENT_T * sm_event)
 	    }
 	  break;
 	case UNKNOWN_DEST:
-	  if ((pCspfRequest = CreateCspfRequest (pCrArgs->dest,
-						 pCrArgs->SetupPriority,
-						 pCrArgs->ExclColorMask,
-						 pCrArgs->InclAnyColorMask,
-						 pCrArgs->InclColorMask,
-						 pCrArgs->HopCount,
-						 pCrArgs->BW,
-						 pCrArgs->LinkBwNumber,
-						 (LINK_BW *) pCrArgs->pLinkBw,
-						 pCrArgs->AvoidHopNumber,
-						 pCrArgs->AvoidHopsArray,
-						 pCrArgs->ExcludeHopNumber,
-						 pCrArgs->ExcludeHopsArray,
-						 &Len, &pMessage)) == NULL)
-	    {
-	      return NULL;
-	    }
-	  pCspfRequest->handle = pSm;
-	  te_send_msg (pMessage, Len);
-	  XFREE (MTYPE_TE, pMessage);
-	  RegisterClient ((int) pSm->caller,
-			  pCrArgs->PsbKey.Session.TunnelId,
-			  pCrArgs->dest, pSm);
-	  return NULL;
+	  return ConstraintRouteResolutionCspf (pSm, pCrArgs);
 	case LOCAL_IF_DEST:
 	  pCrArgs->rc = OUTPUT_EGRESS;
 	  if ((pCall = sm_gen_sync_event_send (pSm->caller,
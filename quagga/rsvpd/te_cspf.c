@@ -0,0 +1,748 @@
+/* Module:   te_cspf.c
+   Contains: TE application in-process constrained SPF over the TE
+   link state database
+   */
+#include <zebra.h>
+
+#include "memory.h"
+#include "log.h"
+#include "vty.h"
+
+#include "patricia.h"
+#include "te_cspf.h"
+
+#define CSPF_INFINITY      0xFFFFFFFF
+#define CSPF_NONE          0xFFFFFFFF
+#define CSPF_POPPED        0xFFFFFFFE
+#define CSPF_AVOID_PENALTY 0x10000
+
+#define CSPF_EDGE_OK       0
+#define CSPF_EDGE_PRUNED   1
+#define CSPF_EDGE_AVOIDED  2
+
+typedef struct
+{
+  IPV4_ADDR LocalIp;
+  IPV4_ADDR RemoteIp;
+} CSPF_LINK_KEY;
+
+typedef struct
+{
+  PATRICIA_NODE Node;
+  CSPF_LINK_KEY Key;
+  CSPF_LINK_INFO Info;
+  uns32 From;			/* graph vertices, valid while compiling */
+  uns32 To;
+} CSPF_LINK;
+
+/* an advertising router or a local address of its links */
+typedef struct
+{
+  PATRICIA_NODE Node;
+  IPV4_ADDR Addr;
+  IPV4_ADDR RouterId;
+  uns32 RefCount;
+  uns32 Index;			/* graph vertex, routers only */
+} CSPF_ADDR;
+
+typedef struct
+{
+  uns32 To;
+  CSPF_LINK *pLink;
+} CSPF_EDGE;
+
+/* the constraints the SPF tree was computed for */
+typedef struct
+{
+  int Priority;
+  float Bw;
+  int ExcludeColorMask;
+  int IncludeAnyColorMask;
+  int IncludeColorMask;
+  int HopCountLimit;
+} CSPF_CONSTRAINTS;
+
+static PATRICIA_TREE CspfLinkTree;
+static PATRICIA_TREE CspfRouterTree;
+static PATRICIA_TREE CspfAddrTree;
+static CSPF_STATISTICS CspfStatistics;
+
+/* the link state database compiled into adjacency arrays */
+static uns8 GraphValid;
+static uns32 VertexCount, VertexSize;
+static uns32 EdgeCount, EdgeSize;
+static IPV4_ADDR *pVertexRouterId;
+static uns32 *pEdgeStart;
+static CSPF_EDGE *pEdges;
+static uns8 *pEdgeState;
+
+/* SPF scratch, holds the last SPF tree */
+static uns32 *pDist, *pHops, *pPred, *pHeap, *pHeapPos;
+static uns32 HeapCount;
+static uns8 TreeValid;
+static uns32 TreeSource;
+static CSPF_CONSTRAINTS TreeConstraints;
+
+static CSPF_REQUEST **ppSortedRequests;
+
+E_RC
+InitCspf ()
+{
+  PATRICIA_PARAMS params;
+
+  memset (&params, 0, sizeof (params));
+  params.key_size = sizeof (CSPF_LINK_KEY);
+  if (patricia_tree_init (&CspfLinkTree, &params) != E_OK)
+    return E_ERR;
+  params.key_size = sizeof (IPV4_ADDR);
+  if (patricia_tree_init (&CspfRouterTree, &params) != E_OK)
+    return E_ERR;
+  if (patricia_tree_init (&CspfAddrTree, &params) != E_OK)
+    return E_ERR;
+  memset (&CspfStatistics, 0, sizeof (CSPF_STATISTICS));
+  GraphValid = FALSE;
+  TreeValid = FALSE;
+  return E_OK;
+}
+
+static E_RC
+AddrRef (PATRICIA_TREE * pTree, IPV4_ADDR Addr, IPV4_ADDR RouterId)
+{
+  CSPF_ADDR *pAddr;
+
+  if ((pAddr =
+       (CSPF_ADDR *) patricia_tree_get (pTree, (const uns8 *) &Addr)) == NULL)
+    {
+      if ((pAddr =
+	   (CSPF_ADDR *) XMALLOC (MTYPE_TE, sizeof (CSPF_ADDR))) == NULL)
+	{
+	  zlog_err ("cannot allocate memory %s %d", __FILE__, __LINE__);
+	  return E_ERR;
+	}
+      memset (pAddr, 0, sizeof (CSPF_ADDR));
+      pAddr->Addr = Addr;
+      pAddr->Node.key_info = (uns8 *) & pAddr->Addr;
+      if (patricia_tree_add (pTree, &pAddr->Node) != E_OK)
+	{
+	  zlog_err ("cannot add node to patricia %s %d", __FILE__, __LINE__);
+	  XFREE (MTYPE_TE, pAddr);
+	  return E_ERR;
+	}
+    }
+  pAddr->RouterId = RouterId;
+  pAddr->RefCount++;
+  return E_OK;
+}
+
+static void
+AddrUnref (PATRICIA_TREE * pTree, IPV4_ADDR Addr)
+{
+  CSPF_ADDR *pAddr;
+
+  if ((pAddr =
+       (CSPF_ADDR *) patricia_tree_get (pTree, (const uns8 *) &Addr)) == NULL)
+    return;
+  if (--pAddr->RefCount != 0)
+    return;
+  if (patricia_tree_del (pTree, &pAddr->Node) != E_OK)
+    {
+      zlog_err ("cannot delete node from patricia %s %d", __FILE__,
+		__LINE__);
+      return;
+    }
+  XFREE (MTYPE_TE, pAddr);
+}
+
+static void
+CspfTopologyChanged ()
+{
+  GraphValid = FALSE;
+  TreeValid = FALSE;
+}
+
+E_RC
+CspfLinkUpdate (CSPF_LINK_INFO * pLinkInfo)
+{
+  CSPF_LINK *pLink;
+  CSPF_LINK_KEY Key;
+
+  Key.LocalIp = pLinkInfo->LocalIp;
+  Key.RemoteIp = pLinkInfo->RemoteIp;
+  if ((pLink =
+       (CSPF_LINK *) patricia_tree_get (&CspfLinkTree,
+					(const uns8 *) &Key)) != NULL)
+    {
+      if (pLink->Info.RouterId != pLinkInfo->RouterId)
+	{
+	  AddrUnref (&CspfRouterTree, pLink->Info.RouterId);
+	  AddrUnref (&CspfAddrTree, pLink->Key.LocalIp);
+	  if ((AddrRef (&CspfRouterTree, pLinkInfo->RouterId,
+			pLinkInfo->RouterId) != E_OK) ||
+	      (AddrRef (&CspfAddrTree, pLinkInfo->LocalIp,
+			pLinkInfo->RouterId) != E_OK))
+	    return E_ERR;
+	  CspfTopologyChanged ();
+	}
+      pLink->Info = *pLinkInfo;
+      TreeValid = FALSE;
+      return E_OK;
+    }
+  if ((pLink = (CSPF_LINK *) XMALLOC (MTYPE_TE, sizeof (CSPF_LINK))) == NULL)
+    {
+      zlog_err ("cannot allocate memory %s %d", __FILE__, __LINE__);
+      return E_ERR;
+    }
+  memset (pLink, 0, sizeof (CSPF_LINK));
+  pLink->Key = Key;
+  pLink->Info = *pLinkInfo;
+  pLink->Node.key_info = (uns8 *) & pLink->Key;
+  if (patricia_tree_add (&CspfLinkTree, &pLink->Node) != E_OK)
+    {
+      zlog_err ("cannot add node to patricia %s %d", __FILE__, __LINE__);
+      XFREE (MTYPE_TE, pLink);
+      return E_ERR;
+    }
+  if ((AddrRef (&CspfRouterTree, pLinkInfo->RouterId,
+		pLinkInfo->RouterId) != E_OK) ||
+      (AddrRef (&CspfAddrTree, pLinkInfo->LocalIp,
+		pLinkInfo->RouterId) != E_OK))
+    return E_ERR;
+  CspfTopologyChanged ();
+  return E_OK;
+}
+
+E_RC
+CspfLinkDelete (IPV4_ADDR LocalIp, IPV4_ADDR RemoteIp)
+{
+  CSPF_LINK *pLink;
+  CSPF_LINK_KEY Key;
+
+  Key.LocalIp = LocalIp;
+  Key.RemoteIp = RemoteIp;
+  if ((pLink =
+       (CSPF_LINK *) patricia_tree_get (&CspfLinkTree,
+					(const uns8 *) &Key)) == NULL)
+    return E_ERR;
+  if (patricia_tree_del (&CspfLinkTree, &pLink->Node) != E_OK)
+    {
+      zlog_err ("cannot delete node from patricia %s %d", __FILE__,
+		__LINE__);
+      return E_ERR;
+    }
+  AddrUnref (&CspfRouterTree, pLink->Info.RouterId);
+  AddrUnref (&CspfAddrTree, pLink->Key.LocalIp);
+  XFREE (MTYPE_TE, pLink);
+  CspfTopologyChanged ();
+  return E_OK;
+}
+
+/* Bandwidth reserved by a new LSP, before the IGP floods it */
+void
+CspfLinkBwDecrease (IPV4_ADDR LocalIp, IPV4_ADDR RemoteIp, float Bw,
+		    uns8 Priority)
+{
+  CSPF_LINK *pLink;
+  CSPF_LINK_KEY Key;
+  int i;
+
+  Key.LocalIp = LocalIp;
+  Key.RemoteIp = RemoteIp;
+  if ((pLink =
+       (CSPF_LINK *) patricia_tree_get (&CspfLinkTree,
+					(const uns8 *) &Key)) == NULL)
+    return;
+  for (i = Priority; i < 8; i++)
+    {
+      if (pLink->Info.ReservableBW[i] > Bw)
+	pLink->Info.ReservableBW[i] -= Bw;
+      else
+	pLink->Info.ReservableBW[i] = 0;
+    }
+  pLink->Info.MaxReservableBW = 0;
+  for (i = 0; i < 8; i++)
+    {
+      if (pLink->Info.ReservableBW[i] > pLink->Info.MaxReservableBW)
+	pLink->Info.MaxReservableBW = pLink->Info.ReservableBW[i];
+    }
+  TreeValid = FALSE;
+}
+
+uns32
+CspfLinkCount ()
+{
+  return patricia_tree_size (&CspfLinkTree);
+}
+
+/* router ID or an address of a router's link to the graph vertex */
+static uns32
+CspfVertexGet (IPV4_ADDR Addr)
+{
+  CSPF_ADDR *pAddr;
+
+  if ((pAddr =
+       (CSPF_ADDR *) patricia_tree_get (&CspfRouterTree,
+					(const uns8 *) &Addr)) != NULL)
+    return pAddr->Index;
+  if ((pAddr =
+       (CSPF_ADDR *) patricia_tree_get (&CspfAddrTree,
+					(const uns8 *) &Addr)) == NULL)
+    return CSPF_NONE;
+  if ((pAddr =
+       (CSPF_ADDR *) patricia_tree_get (&CspfRouterTree,
+					(const uns8 *) &pAddr->RouterId)) ==
+      NULL)
+    return CSPF_NONE;
+  return pAddr->Index;
+}
+
+static E_RC
+CspfArraysResize (uns32 Vertices, uns32 Edges)
+{
+  if (Vertices > VertexSize)
+    {
+      VertexSize = Vertices * 2;
+      pVertexRouterId =
+	XREALLOC (MTYPE_TE, pVertexRouterId, VertexSize * sizeof (IPV4_ADDR));
+      pEdgeStart =
+	XREALLOC (MTYPE_TE, pEdgeStart, (VertexSize + 1) * sizeof (uns32));
+      pDist = XREALLOC (MTYPE_TE, pDist, VertexSize * sizeof (uns32));
+      pHops = XREALLOC (MTYPE_TE, pHops, VertexSize * sizeof (uns32));
+      pPred = XREALLOC (MTYPE_TE, pPred, VertexSize * sizeof (uns32));
+      pHeap = XREALLOC (MTYPE_TE, pHeap, VertexSize * sizeof (uns32));
+      pHeapPos = XREALLOC (MTYPE_TE, pHeapPos, VertexSize * sizeof (uns32));
+      if ((pVertexRouterId == NULL) || (pEdgeStart == NULL) ||
+	  (pDist == NULL) || (pHops == NULL) || (pPred == NULL) ||
+	  (pHeap == NULL) || (pHeapPos == NULL))
+	{
+	  VertexSize = 0;
+	  return E_ERR;
+	}
+    }
+  if (Edges > EdgeSize)
+    {
+      EdgeSize = Edges * 2;
+      pEdges = XREALLOC (MTYPE_TE, pEdges, EdgeSize * sizeof (CSPF_EDGE));
+      pEdgeState = XREALLOC (MTYPE_TE, pEdgeState, EdgeSize);
+      if ((pEdges == NULL) || (pEdgeState == NULL))
+	{
+	  EdgeSize = 0;
+	  return E_ERR;
+	}
+    }
+  return E_OK;
+}
+
+static E_RC
+CspfGraphBuild ()
+{
+  CSPF_ADDR *pAddr;
+  CSPF_LINK *pLink;
+  uns32 i, Vertices, Links;
+
+  Vertices = patricia_tree_size (&CspfRouterTree);
+  Links = patricia_tree_size (&CspfLinkTree);
+  if (CspfArraysResize (Vertices + 1, Links + 1) != E_OK)
+    {
+      zlog_err ("cannot allocate memory %s %d", __FILE__, __LINE__);
+      return E_ERR;
+    }
+
+  VertexCount = 0;
+  pAddr = (CSPF_ADDR *) patricia_tree_getnext (&CspfRouterTree, NULL);
+  while (pAddr != NULL)
+    {
+      pAddr->Index = VertexCount;
+      pVertexRouterId[VertexCount++] = pAddr->Addr;
+      pAddr =
+	(CSPF_ADDR *) patricia_tree_getnext (&CspfRouterTree,
+					     (const uns8 *) &pAddr->Addr);
+    }
+
+  /* count the edges of each vertex, then place them */
+  memset (pEdgeStart, 0, (VertexCount + 1) * sizeof (uns32));
+  pLink = (CSPF_LINK *) patricia_tree_getnext (&CspfLinkTree, NULL);
+  while (pLink != NULL)
+    {
+      pLink->From = CspfVertexGet (pLink->Info.RouterId);
+      pLink->To = CspfVertexGet (pLink->Key.RemoteIp);
+      if ((pLink->From != CSPF_NONE) && (pLink->To != CSPF_NONE) &&
+	  (pLink->From != pLink->To))
+	pEdgeStart[pLink->From + 1]++;
+      pLink =
+	(CSPF_LINK *) patricia_tree_getnext (&CspfLinkTree,
+					     (const uns8 *) &pLink->Key);
+    }
+  for (i = 0; i < VertexCount; i++)
+    {
+      pEdgeStart[i + 1] += pEdgeStart[i];
+      pHeap[i] = pEdgeStart[i];	/* fill cursor */
+    }
+  EdgeCount = pEdgeStart[VertexCount];
+  pLink = (CSPF_LINK *) patricia_tree_getnext (&CspfLinkTree, NULL);
+  while (pLink != NULL)
+    {
+      if ((pLink->From != CSPF_NONE) && (pLink->To != CSPF_NONE) &&
+	  (pLink->From != pLink->To))
+	{
+	  i = pHeap[pLink->From]++;
+	  pEdges[i].To = pLink->To;
+	  pEdges[i].pLink = pLink;
+	}
+      pLink =
+	(CSPF_LINK *) patricia_tree_getnext (&CspfLinkTree,
+					     (const uns8 *) &pLink->Key);
+    }
+  GraphValid = TRUE;
+  TreeValid = FALSE;
+  CspfStatistics.GraphBuilds++;
+  return E_OK;
+}
+
+static void
+CspfRequestData (CSPF_REQUEST * pRequest, LINK_BW ** ppLinkBw,
+		 IPV4_ADDR ** ppAvoid, IPV4_ADDR ** ppExclude)
+{
+  char *pData = (char *) (pRequest + 1);
+
+  /* the lists either follow the request, as CreateCspfRequest packs
+     them, or are pointed to */
+  *ppLinkBw = pRequest->pLinkBw;
+  *ppAvoid = (IPV4_ADDR *) pRequest->Hops2Avoid;
+  *ppExclude = (IPV4_ADDR *) pRequest->Hops2Exclude;
+  if ((*ppLinkBw == NULL) && (pRequest->LinkBwCount != 0))
+    *ppLinkBw = (LINK_BW *) pData;
+  pData += pRequest->LinkBwCount * sizeof (LINK_BW);
+  if ((*ppAvoid == NULL) && (pRequest->Hops2AvoidCount != 0))
+    *ppAvoid = (IPV4_ADDR *) pData;
+  pData += pRequest->Hops2AvoidCount * sizeof (IPV4_ADDR);
+  if ((*ppExclude == NULL) && (pRequest->Hops2ExcludeCount != 0))
+    *ppExclude = (IPV4_ADDR *) pData;
+}
+
+static uns8
+HopListed (IPV4_ADDR * pHops, int Count, CSPF_EDGE * pEdge, uns32 From)
+{
+  int i;
+
+  for (i = 0; i < Count; i++)
+    {
+      if ((pHops[i] == pEdge->pLink->Key.LocalIp) ||
+	  (pHops[i] == pEdge->pLink->Key.RemoteIp) ||
+	  (pHops[i] == pVertexRouterId[From]) ||
+	  (pHops[i] == pVertexRouterId[pEdge->To]))
+	return TRUE;
+    }
+  return FALSE;
+}
+
+static void
+CspfPrune (CSPF_REQUEST * pRequest)
+{
+  LINK_BW *pLinkBw;
+  IPV4_ADDR *pAvoid, *pExclude;
+  CSPF_LINK_INFO *pInfo;
+  uns32 u, e;
+  uns32 ExcludeColorMask = (uns32) pRequest->ExcludeColorMask;
+  uns32 IncludeAnyColorMask = (uns32) pRequest->IncludeAnyColorMask;
+  uns32 IncludeColorMask = (uns32) pRequest->IncludeColorMask;
+  float Bw;
+  int i, Priority = pRequest->Priority & 7;
+
+  CspfRequestData (pRequest, &pLinkBw, &pAvoid, &pExclude);
+  for (u = 0; u < VertexCount; u++)
+    for (e = pEdgeStart[u]; e < pEdgeStart[u + 1]; e++)
+      {
+	pInfo = &pEdges[e].pLink->Info;
+	pEdgeState[e] = CSPF_EDGE_PRUNED;
+	if (pInfo->ColorMask & ExcludeColorMask)
+	  continue;
+	if ((IncludeAnyColorMask != 0) &&
+	    ((pInfo->ColorMask & IncludeAnyColorMask) == 0))
+	  continue;
+	if ((pInfo->ColorMask & IncludeColorMask) != IncludeColorMask)
+	  continue;
+	/* the bandwidth the LSP already holds on the link is its own */
+	Bw = pInfo->ReservableBW[Priority];
+	for (i = 0; i < pRequest->LinkBwCount; i++)
+	  if ((pLinkBw[i].LocalIp.s_addr == pInfo->LocalIp) &&
+	      (pLinkBw[i].RemoteIp.s_addr == pInfo->RemoteIp))
+	    Bw += pLinkBw[i].Bw;
+	if (Bw < pRequest->Bw)
+	  continue;
+	if ((pInfo->MaxLspBW != 0) && (pInfo->MaxLspBW < pRequest->Bw))
+	  continue;
+	if (HopListed (pExclude, pRequest->Hops2ExcludeCount, &pEdges[e], u))
+	  continue;
+	if (HopListed (pAvoid, pRequest->Hops2AvoidCount, &pEdges[e], u))
+	  pEdgeState[e] = CSPF_EDGE_AVOIDED;
+	else
+	  pEdgeState[e] = CSPF_EDGE_OK;
+      }
+  CspfStatistics.PrunedGraphs++;
+}
+
+/* the vertex with the lower cost, then with the fewer hops, is closer */
+#define CSPF_CLOSER(a, b) \
+  ((pDist[a] < pDist[b]) || ((pDist[a] == pDist[b]) && (pHops[a] < pHops[b])))
+
+static void
+HeapUp (uns32 Pos)
+{
+  uns32 v = pHeap[Pos], Parent;
+
+  while (Pos > 0)
+    {
+      Parent = (Pos - 1) / 2;
+      if (!CSPF_CLOSER (v, pHeap[Parent]))
+	break;
+      pHeap[Pos] = pHeap[Parent];
+      pHeapPos[pHeap[Pos]] = Pos;
+      Pos = Parent;
+    }
+  pHeap[Pos] = v;
+  pHeapPos[v] = Pos;
+}
+
+static uns32
+HeapPop ()
+{
+  uns32 Top = pHeap[0], v, Pos = 0, Child;
+
+  v = pHeap[--HeapCount];
+  while ((Child = 2 * Pos + 1) < HeapCount)
+    {
+      if ((Child + 1 < HeapCount) &&
+	  CSPF_CLOSER (pHeap[Child + 1], pHeap[Child]))
+	Child++;
+      if (!CSPF_CLOSER (pHeap[Child], v))
+	break;
+      pHeap[Pos] = pHeap[Child];
+      pHeapPos[pHeap[Pos]] = Pos;
+      Pos = Child;
+    }
+  if (HeapCount != 0)
+    {
+      pHeap[Pos] = v;
+      pHeapPos[v] = Pos;
+    }
+  pHeapPos[Top] = CSPF_POPPED;
+  return Top;
+}
+
+static void
+CspfSpf (uns32 Source, int HopCountLimit)
+{
+  uns32 u, v, e, Cost, Metric;
+
+  for (v = 0; v < VertexCount; v++)
+    {
+      pDist[v] = CSPF_INFINITY;
+      pHops[v] = 0;
+      pPred[v] = CSPF_NONE;
+      pHeapPos[v] = CSPF_NONE;
+    }
+  pDist[Source] = 0;
+  pHeap[0] = Source;
+  pHeapPos[Source] = 0;
+  HeapCount = 1;
+  while (HeapCount != 0)
+    {
+      u = HeapPop ();
+      if ((HopCountLimit > 0) && (pHops[u] >= (uns32) HopCountLimit))
+	continue;
+      for (e = pEdgeStart[u]; e < pEdgeStart[u + 1]; e++)
+	{
+	  if (pEdgeState[e] == CSPF_EDGE_PRUNED)
+	    continue;
+	  v = pEdges[e].To;
+	  if (pHeapPos[v] == CSPF_POPPED)
+	    continue;
+	  Metric = pEdges[e].pLink->Info.TeMetric;
+	  if (Metric == 0)
+	    Metric = 1;
+	  if (pEdgeState[e] == CSPF_EDGE_AVOIDED)
+	    Metric += CSPF_AVOID_PENALTY;
+	  Cost = pDist[u] + Metric;
+	  if ((Cost > pDist[v]) ||
+	      ((Cost == pDist[v]) && (pHops[u] + 1 >= pHops[v])))
+	    continue;
+	  pDist[v] = Cost;
+	  pHops[v] = pHops[u] + 1;
+	  pPred[v] = e;
+	  if (pHeapPos[v] == CSPF_NONE)
+	    {
+	      pHeap[HeapCount] = v;
+	      HeapUp (HeapCount++);
+	    }
+	  else
+	    HeapUp (pHeapPos[v]);
+	}
+    }
+  CspfStatistics.SpfRuns++;
+}
+
+static E_RC
+CspfPathExtract (uns32 Dest, CSPF_PATH * pPath)
+{
+  uns32 v, e, i;
+
+  memset (pPath, 0, sizeof (CSPF_PATH));
+  if (pDist[Dest] == CSPF_INFINITY)
+    return E_ERR;
+  pPath->Cost = pDist[Dest];
+  pPath->HopCount = pHops[Dest];
+  if (pPath->HopCount == 0)
+    return E_OK;
+  if ((pPath->pHops =
+       (CSPF_LINK_INFO *) XMALLOC (MTYPE_TE,
+				   pPath->HopCount *
+				   sizeof (CSPF_LINK_INFO))) == NULL)
+    {
+      zlog_err ("cannot allocate memory %s %d", __FILE__, __LINE__);
+      return E_ERR;
+    }
+  for (v = Dest, i = pPath->HopCount; i > 0; i--)
+    {
+      e = pPred[v];
+      pPath->pHops[i - 1] = pEdges[e].pLink->Info;
+      v = pEdges[e].pLink->From;
+    }
+  return E_OK;
+}
+
+E_RC
+CspfCompute (IPV4_ADDR Source, CSPF_REQUEST * pRequest, CSPF_PATH * pPath)
+{
+  CSPF_CONSTRAINTS Constraints;
+  uns32 From, To;
+  uns8 Shared;
+
+  CspfStatistics.Requests++;
+  memset (pPath, 0, sizeof (CSPF_PATH));
+  if ((GraphValid == FALSE) && (CspfGraphBuild () != E_OK))
+    {
+      CspfStatistics.Failures++;
+      return E_ERR;
+    }
+  if (((From = CspfVertexGet (Source)) == CSPF_NONE) ||
+      ((To = CspfVertexGet (pRequest->Destination.s_addr)) == CSPF_NONE))
+    {
+      CspfStatistics.Failures++;
+      return E_ERR;
+    }
+
+  memset (&Constraints, 0, sizeof (CSPF_CONSTRAINTS));
+  Constraints.Priority = pRequest->Priority;
+  Constraints.Bw = pRequest->Bw;
+  Constraints.ExcludeColorMask = pRequest->ExcludeColorMask;
+  Constraints.IncludeAnyColorMask = pRequest->IncludeAnyColorMask;
+  Constraints.IncludeColorMask = pRequest->IncludeColorMask;
+  Constraints.HopCountLimit = pRequest->HopCountLimit;
+  /* per LSP lists make the pruned graph the LSP's own */
+  Shared = ((pRequest->LinkBwCount == 0) &&
+	    (pRequest->Hops2AvoidCount == 0) &&
+	    (pRequest->Hops2ExcludeCount == 0));
+
+  if ((Shared == TRUE) && (TreeValid == TRUE) && (TreeSource == From) &&
+      (memcmp (&Constraints, &TreeConstraints,
+	       sizeof (CSPF_CONSTRAINTS)) == 0))
+    CspfStatistics.SpfReused++;
+  else
+    {
+      CspfPrune (pRequest);
+      CspfSpf (From, pRequest->HopCountLimit);
+      TreeValid = Shared;
+      TreeSource = From;
+      TreeConstraints = Constraints;
+    }
+  if (CspfPathExtract (To, pPath) != E_OK)
+    {
+      CspfStatistics.Failures++;
+      return E_ERR;
+    }
+  return E_OK;
+}
+
+static int
+CspfRequestCmp (const void *p1, const void *p2)
+{
+  CSPF_REQUEST *pReq1 = ppSortedRequests[*(const uns32 *) p1];
+  CSPF_REQUEST *pReq2 = ppSortedRequests[*(const uns32 *) p2];
+  int Own1, Own2;
+
+  Own1 = pReq1->LinkBwCount + pReq1->Hops2AvoidCount +
+    pReq1->Hops2ExcludeCount;
+  Own2 = pReq2->LinkBwCount + pReq2->Hops2AvoidCount +
+    pReq2->Hops2ExcludeCount;
+  if ((Own1 == 0) != (Own2 == 0))
+    return (Own1 == 0) ? -1 : 1;
+  if (pReq1->Priority != pReq2->Priority)
+    return (pReq1->Priority < pReq2->Priority) ? -1 : 1;
+  if (pReq1->Bw != pReq2->Bw)
+    return (pReq1->Bw < pReq2->Bw) ? -1 : 1;
+  if (pReq1->ExcludeColorMask != pReq2->ExcludeColorMask)
+    return (pReq1->ExcludeColorMask < pReq2->ExcludeColorMask) ? -1 : 1;
+  if (pReq1->IncludeAnyColorMask != pReq2->IncludeAnyColorMask)
+    return (pReq1->IncludeAnyColorMask < pReq2->IncludeAnyColorMask) ? -1 : 1;
+  if (pReq1->IncludeColorMask != pReq2->IncludeColorMask)
+    return (pReq1->IncludeColorMask < pReq2->IncludeColorMask) ? -1 : 1;
+  if (pReq1->HopCountLimit != pReq2->HopCountLimit)
+    return (pReq1->HopCountLimit < pReq2->HopCountLimit) ? -1 : 1;
+  return 0;
+}
+
+/* Requests sharing the constraints are computed one after another, so
+   that they are answered from one pruned graph and SPF tree */
+void
+CspfComputeBatch (IPV4_ADDR Source, CSPF_REQUEST ** ppRequests, uns32 Count,
+		  CSPF_PATH * pPaths, E_RC * pRc)
+{
+  uns32 *pOrder, i;
+
+  CspfStatistics.Batches++;
+  if ((pOrder = XMALLOC (MTYPE_TE, Count * sizeof (uns32))) == NULL)
+    {
+      for (i = 0; i < Count; i++)
+	pRc[i] = CspfCompute (Source, ppRequests[i], &pPaths[i]);
+      return;
+    }
+  for (i = 0; i < Count; i++)
+    pOrder[i] = i;
+  ppSortedRequests = ppRequests;
+  qsort (pOrder, Count, sizeof (uns32), CspfRequestCmp);
+  ppSortedRequests = NULL;
+  for (i = 0; i < Count; i++)
+    pRc[pOrder[i]] =
+      CspfCompute (Source, ppRequests[pOrder[i]], &pPaths[pOrder[i]]);
+  XFREE (MTYPE_TE, pOrder);
+}
+
+void
+CspfPathFree (CSPF_PATH * pPath)
+{
+  if (pPath->pHops != NULL)
+    XFREE (MTYPE_TE, pPath->pHops);
+  pPath->pHops = NULL;
+  pPath->HopCount = 0;
+}
+
+void
+DumpCspf (struct vty *vty)
+{
+  vty_out (vty, "TE links %d, routers %d, addresses %d%s",
+	   patricia_tree_size (&CspfLinkTree),
+	   patricia_tree_size (&CspfRouterTree),
+	   patricia_tree_size (&CspfAddrTree), VTY_NEWLINE);
+  if (GraphValid == TRUE)
+    vty_out (vty, "Graph: %d vertices %d edges%s", VertexCount, EdgeCount,
+	     VTY_NEWLINE);
+  else
+    vty_out (vty, "Graph: not compiled%s", VTY_NEWLINE);
+  vty_out (vty, "Requests %d (batches %d), failed %d%s",
+	   CspfStatistics.Requests, CspfStatistics.Batches,
+	   CspfStatistics.Failures, VTY_NEWLINE);
+  vty_out (vty, "Graph builds %d, pruned graphs %d, SPF runs %d, "
+	   "SPF trees reused %d%s", CspfStatistics.GraphBuilds,
+	   CspfStatistics.PrunedGraphs, CspfStatistics.SpfRuns,
+	   CspfStatistics.SpfReused, VTY_NEWLINE);
+}
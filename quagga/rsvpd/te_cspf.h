@@ -47,4 +47,58 @@ typedef struct
   float ResBw[8];
 } REMOTE_BW_UPDATE_REQUEST;
 
+/* In-process CSPF.
+   The TE links advertised by the IGP are kept in a link state database
+   which is compiled into an adjacency array on the first computation
+   after a topology change.  A computation prunes the links by the
+   unreserved bandwidth of the setup priority and by the affinities, and
+   runs SPF over the rest; the SPF tree is kept and reused by the
+   following requests with the same constraints. */
+
+typedef struct
+{
+  IPV4_ADDR RouterId;		/* advertising router */
+  IPV4_ADDR LocalIp;
+  IPV4_ADDR RemoteIp;
+  uns32 TeMetric;
+  uns32 ColorMask;
+  float MaxLspBW;
+  float MaxReservableBW;
+  float ReservableBW[8];
+} CSPF_LINK_INFO;
+
+typedef struct
+{
+  uns32 HopCount;
+  uns32 Cost;
+  CSPF_LINK_INFO *pHops;
+} CSPF_PATH;
+
+typedef struct
+{
+  uns32 Requests;
+  uns32 Batches;
+  uns32 GraphBuilds;
+  uns32 PrunedGraphs;
+  uns32 SpfRuns;
+  uns32 SpfReused;
+  uns32 Failures;
+} CSPF_STATISTICS;
+
+struct vty;
+
+E_RC InitCspf ();
+E_RC CspfLinkUpdate (CSPF_LINK_INFO * pLinkInfo);
+E_RC CspfLinkDelete (IPV4_ADDR LocalIp, IPV4_ADDR RemoteIp);
+void CspfLinkBwDecrease (IPV4_ADDR LocalIp, IPV4_ADDR RemoteIp, float Bw,
+			 uns8 Priority);
+uns32 CspfLinkCount ();
+E_RC CspfCompute (IPV4_ADDR Source, CSPF_REQUEST * pRequest,
+		  CSPF_PATH * pPath);
+void CspfComputeBatch (IPV4_ADDR Source, CSPF_REQUEST ** ppRequests,
+		       uns32 Count, CSPF_PATH * pPaths, E_RC * pRc);
+void CspfPathFree (CSPF_PATH * pPath);
+void DumpCspf (struct vty *vty);
+void TE_CSPF_API_PathAdd (IPV4_ADDR dest_ip, CSPF_PATH * pCspfPath);
+
 #endif
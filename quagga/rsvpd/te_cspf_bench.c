@@ -0,0 +1,171 @@
+/* Module:   te_cspf_bench.c
+   Contains: CSPF benchmark over a synthetic TE topology
+
+   te_cspf_bench [routers [lsps [links per router]]]
+
+   Every router advertises links to its ring neighbors plus random
+   chords.  The LSPs use a few bandwidth/priority/affinity classes, one
+   in eight carries a hop to exclude.  The requests are computed one by
+   one in arrival order and then as one batch; the paths must cost the
+   same.
+   */
+#include <zebra.h>
+
+#include "memory.h"
+#include "log.h"
+#include "vty.h"
+#include "buffer.h"
+
+#include "patricia.h"
+#include "te_cspf.h"
+
+#define ROUTER_ID(i) htonl (0x0a000000 + (i) + 1)
+#define LINK_IP(i, j) htonl (0xc0000000 + ((i) << 12) + (j))
+
+static uns32 Seed = 1;
+
+static uns32
+Random ()
+{
+  Seed = Seed * 1103515245 + 12345;
+  return (Seed >> 8) & 0xffffff;
+}
+
+static void
+AddLinkPair (uns32 a, uns32 b, uns32 Slot)
+{
+  CSPF_LINK_INFO Info;
+  int p;
+
+  memset (&Info, 0, sizeof (Info));
+  Info.TeMetric = 1 + Random () % 100;
+  Info.ColorMask = 1 << (Random () % 4);
+  Info.MaxLspBW = 1000;
+  Info.MaxReservableBW = 1000;
+  for (p = 0; p < 8; p++)
+    Info.ReservableBW[p] = 100 + Random () % 900 + p * 10;
+
+  Info.RouterId = ROUTER_ID (a);
+  Info.LocalIp = LINK_IP (a, Slot);
+  Info.RemoteIp = LINK_IP (b, Slot);
+  CspfLinkUpdate (&Info);
+  Info.RouterId = ROUTER_ID (b);
+  Info.LocalIp = LINK_IP (b, Slot);
+  Info.RemoteIp = LINK_IP (a, Slot);
+  CspfLinkUpdate (&Info);
+}
+
+static double
+Elapsed (struct timeval *pStart)
+{
+  struct timeval Now;
+
+  gettimeofday (&Now, NULL);
+  return (Now.tv_sec - pStart->tv_sec) * 1000.0 +
+    (Now.tv_usec - pStart->tv_usec) / 1000.0;
+}
+
+int
+main (int argc, char **argv)
+{
+  uns32 Routers = 1000, Lsps = 1000, Degree = 4, i, j, Slot = 1;
+  CSPF_REQUEST *pRequests, **ppRequests;
+  IPV4_ADDR *pExclude;
+  CSPF_PATH *pSingle, *pBatch;
+  E_RC *pRcSingle, *pRcBatch;
+  uns32 Found = 0, Mismatch = 0;
+  struct timeval Start;
+  double SingleMs, BatchMs, BuildMs;
+  struct vty *vty;
+
+  if (argc > 1)
+    Routers = atoi (argv[1]);
+  if (argc > 2)
+    Lsps = atoi (argv[2]);
+  if (argc > 3)
+    Degree = atoi (argv[3]);
+
+  memory_init ();
+  zlog_default = openzlog (argv[0], ZLOG_NONE, LOG_CONS | LOG_NDELAY, 0);
+  zlog_set_level (NULL, ZLOG_DEST_SYSLOG, ZLOG_DISABLED);
+  zlog_set_level (NULL, ZLOG_DEST_STDOUT, LOG_ERR);
+  if (InitCspf () != E_OK)
+    return 1;
+
+  for (i = 0; i < Routers; i++)
+    AddLinkPair (i, (i + 1) % Routers, Slot++);
+  for (i = 0; i < Routers * (Degree - 2) / 2; i++)
+    {
+      uns32 a = Random () % Routers, b = Random () % Routers;
+      if (a != b)
+	AddLinkPair (a, b, Slot++);
+    }
+
+  pRequests = calloc (Lsps, sizeof (CSPF_REQUEST));
+  ppRequests = calloc (Lsps, sizeof (CSPF_REQUEST *));
+  pExclude = calloc (Lsps, sizeof (IPV4_ADDR));
+  pSingle = calloc (Lsps, sizeof (CSPF_PATH));
+  pBatch = calloc (Lsps, sizeof (CSPF_PATH));
+  pRcSingle = calloc (Lsps, sizeof (E_RC));
+  pRcBatch = calloc (Lsps, sizeof (E_RC));
+  for (i = 0; i < Lsps; i++)
+    {
+      j = i % 4;
+      pRequests[i].Destination.s_addr = ROUTER_ID (1 + Random () %
+						   (Routers - 1));
+      pRequests[i].Priority = j * 2;
+      pRequests[i].Bw = 50 + j * 50;
+      pRequests[i].ExcludeColorMask = (j == 3) ? 0x8 : 0;
+      if ((i % 8) == 7)
+	{
+	  pExclude[i] = ROUTER_ID (Random () % Routers);
+	  pRequests[i].Hops2ExcludeCount = 1;
+	  pRequests[i].Hops2Exclude = (struct in_addr *) &pExclude[i];
+	}
+      ppRequests[i] = &pRequests[i];
+    }
+
+  gettimeofday (&Start, NULL);
+  CspfCompute (ROUTER_ID (0), &pRequests[0], &pSingle[0]);
+  CspfPathFree (&pSingle[0]);
+  BuildMs = Elapsed (&Start);
+
+  gettimeofday (&Start, NULL);
+  for (i = 0; i < Lsps; i++)
+    pRcSingle[i] = CspfCompute (ROUTER_ID (0), &pRequests[i], &pSingle[i]);
+  SingleMs = Elapsed (&Start);
+
+  gettimeofday (&Start, NULL);
+  CspfComputeBatch (ROUTER_ID (0), ppRequests, Lsps, pBatch, pRcBatch);
+  BatchMs = Elapsed (&Start);
+
+  for (i = 0; i < Lsps; i++)
+    {
+      if (pRcSingle[i] == E_OK)
+	Found++;
+      if ((pRcSingle[i] != pRcBatch[i]) ||
+	  ((pRcSingle[i] == E_OK) && (pSingle[i].Cost != pBatch[i].Cost)))
+	Mismatch++;
+      CspfPathFree (&pSingle[i]);
+      CspfPathFree (&pBatch[i]);
+    }
+
+  printf ("%d routers, %d TE links, %d LSPs, %d paths found\n",
+	  Routers, CspfLinkCount (), Lsps, Found);
+  printf ("graph build + first SPF  %8.2f ms\n", BuildMs);
+  printf ("one by one               %8.2f ms (%.1f us per LSP)\n",
+	  SingleMs, SingleMs * 1000 / Lsps);
+  printf ("batch                    %8.2f ms (%.1f us per LSP)\n",
+	  BatchMs, BatchMs * 1000 / Lsps);
+  vty = vty_new ();
+  vty->type = VTY_SHELL;
+  vty->fd = 1;
+  DumpCspf (vty);
+  buffer_flush_all (vty->obuf, 1);
+  if (Mismatch != 0)
+    {
+      printf ("%d paths differ between the runs\n", Mismatch);
+      return 1;
+    }
+  return 0;
+}
@@ -220,7 +220,7 @@ rdb_create ()
 
   StaticPathHead = NULL;
 
-  return E_OK;
+  return InitCspf ();
 }
 
 
@@ -533,7 +533,7 @@ rdb_get_component_link (uns32 TeLinkId, uns32 IfIndex,
 {
   TE_LINK_L_LIST *pTeLinks;
   COMPONENT_LINK *pComponentLinks;
-  zlog_info ("entering rdb_get_component_link");
+  RSVP_TRACE ("entering rdb_get_component_link");
   *ppCompLink = NULL;
   pTeLinks = TeLinkLListHead;
   while (pTeLinks != NULL)
@@ -546,7 +546,7 @@ rdb_get_component_link (uns32 TeLinkId, uns32 IfIndex,
 	      if (pComponentLinks->oifIndex == IfIndex)
 		{
 		  *ppCompLink = pComponentLinks;
-		  zlog_info ("leaving rdb_get_component_link+");
+		  RSVP_TRACE ("leaving rdb_get_component_link+");
 		  return E_OK;
 		}
 	      pComponentLinks = pComponentLinks->next;
@@ -554,7 +554,7 @@ rdb_get_component_link (uns32 TeLinkId, uns32 IfIndex,
 	}
       pTeLinks = pTeLinks->next;
     }
-  zlog_info ("leaving rdb_get_component_link-");
+  RSVP_TRACE ("leaving rdb_get_component_link-");
   return E_ERR;
 }
 
@@ -641,7 +641,7 @@ rdb_add_te_link (TE_LINK * pTeLink)
   TE_LINK_L_LIST *pTeLinks, *pTeLinksPrev = NULL, *pNew;
   PATRICIA_PARAMS params;
 
-  zlog_info
+  RSVP_TRACE
     ("entering rdb_add_te_link: TE link ID %x Metric %d Colors %x BW %f",
      pTeLink->te_link_id, pTeLink->te_link_properties.TeMetric,
      pTeLink->te_link_properties.color_mask,
@@ -670,7 +670,7 @@ rdb_add_te_link (TE_LINK * pTeLink)
   if (TeLinkLListHead == NULL)
     {
       TeLinkLListHead = pNew;
-      zlog_info ("leaving rdb_add_te_link1");
+      RSVP_TRACE ("leaving rdb_add_te_link1");
       return E_OK;
     }
   else
@@ -690,7 +690,7 @@ rdb_add_te_link (TE_LINK * pTeLink)
 		  pTeLinksPrev->next = pNew;
 		  pNew->next = pTeLinks;
 		}
-	      zlog_info ("leaving rdb_add_te_link2");
+	      RSVP_TRACE ("leaving rdb_add_te_link2");
 	      return E_OK;
 	    }
 	  else if (pTeLinks->te_link->te_link_id == pTeLink->te_link_id)
@@ -698,14 +698,14 @@ rdb_add_te_link (TE_LINK * pTeLink)
 	      copy_te_link (pTeLinks->te_link, pTeLink);
 	      delete_te_link (pTeLink);
 	      XFREE (MTYPE_TE, pNew);
-	      zlog_info ("leaving rdb_add_te_link3");
+	      RSVP_TRACE ("leaving rdb_add_te_link3");
 	      return E_OK;
 	    }
 	  pTeLinksPrev = pTeLinks;
 	  pTeLinks = pTeLinks->next;
 	}
       pTeLinksPrev->next = pNew;
-      zlog_info ("leaving rdb_add_te_link4");
+      RSVP_TRACE ("leaving rdb_add_te_link4");
       return E_OK;
     }
 }
@@ -729,7 +729,7 @@ rdb_del_te_link (uns32 te_link_id)
   TE_LINK_NEXT_HOP *pTeLinkNextHop;
   uns32 key = 0;
 
-  zlog_info ("entering rdb_del_te_link: TE link ID %x", te_link_id);
+  RSVP_TRACE ("entering rdb_del_te_link: TE link ID %x", te_link_id);
 
   pPrev = pTeLink = TeLinkLListHead;
   while (pTeLink != NULL)
@@ -764,7 +764,7 @@ rdb_del_te_link (uns32 te_link_id)
     }
   delete_te_link (pTeLink->te_link);
   XFREE (MTYPE_TE, pTeLink);
-  zlog_info ("leaving rdb_del_te_link");
+  RSVP_TRACE ("leaving rdb_del_te_link");
   return E_OK;
 }
 
@@ -788,8 +788,8 @@ rdb_add_next_hop (IPV4_ADDR next_hop, uns32 TeLinkId)
   TE_LINK_L_LIST *pPrevTeLink, *pTeLinkLList, *pNew, *pTeLinkLList2;
   TE_LINK_NEXT_HOP *pTeLinkNextHop;
 
-  zlog_info ("entering rdb_add_next_hop: next hop %x TE link ID %x", next_hop,
-	     TeLinkId);
+  RSVP_TRACE ("entering rdb_add_next_hop: next hop %x TE link ID %x", next_hop,
+	      TeLinkId);
 
   pTeLinkLList = TeLinkLListHead;
   while (pTeLinkLList != NULL)
@@ -859,7 +859,7 @@ rdb_add_next_hop (IPV4_ADDR next_hop, uns32 TeLinkId)
 	  zlog_err ("an error at %s %d", __FILE__, __LINE__);
 	  return E_ERR;
 	}
-      zlog_info ("leaving rdb_add_next_hop1+");
+      RSVP_TRACE ("leaving rdb_add_next_hop1+");
       return E_OK;
     }
   else
@@ -879,7 +879,7 @@ rdb_add_next_hop (IPV4_ADDR next_hop, uns32 TeLinkId)
 		}
 	      XFREE (MTYPE_TE, pTeLinkNextHop);
 	      XFREE (MTYPE_TE, pNew);
-	      zlog_info ("leaving rdb_add_next_hop2+");
+	      RSVP_TRACE ("leaving rdb_add_next_hop2+");
 	      return E_OK;
 	    }
 	  else if (pTeLinkLList2->te_link->te_link_id > TeLinkId)
@@ -895,7 +895,7 @@ rdb_add_next_hop (IPV4_ADDR next_hop, uns32 TeLinkId)
 		  pPrevTeLink->next = pNew;
 		}
 	      next_hop_entry->LListItemsCount++;
-	      zlog_info ("leaving rdb_add_next_hop3+");
+	      RSVP_TRACE ("leaving rdb_add_next_hop3+");
 	      return E_OK;
 	    }
 	  pPrevTeLink = pTeLinkLList2;
@@ -905,7 +905,7 @@ rdb_add_next_hop (IPV4_ADDR next_hop, uns32 TeLinkId)
       /* if this point is reached, TE link is new and should be inserted */
       pPrevTeLink->next = pNew;
       next_hop_entry->LListItemsCount++;
-      zlog_info ("leaving rdb_add_next_hop4+");
+      RSVP_TRACE ("leaving rdb_add_next_hop4+");
       return E_OK;
     }
   /* should not be reached */
@@ -930,8 +930,8 @@ uns32
 rdb_local_link_status_change (uns32 TeLinkId, uns8 Status)
 {
   TE_LINK_L_LIST *pTeLinkLList;
-  zlog_info ("entering rdb_local_link_status_change: TE link ID %x status %x",
-	     TeLinkId, Status);
+  RSVP_TRACE ("entering rdb_local_link_status_change: TE link ID %x status %x",
+	      TeLinkId, Status);
   pTeLinkLList = TeLinkLListHead;
   while (pTeLinkLList != NULL)
     {
@@ -945,7 +945,7 @@ rdb_local_link_status_change (uns32 TeLinkId, uns8 Status)
     }
 
   pTeLinkLList->te_link->Status = Status;
-  zlog_info ("leaving rdb_local_link_status_change");
+  RSVP_TRACE ("leaving rdb_local_link_status_change");
   return E_OK;
 }
 
@@ -967,8 +967,8 @@ rdb_del_next_hop (IPV4_ADDR next_hop, uns32 te_link_id)
   TE_LINK_L_LIST *pTeLink, *pTeLinkPrev = NULL;
   TE_LINK_NEXT_HOP *pTeLinkNextHop;
 
-  zlog_info ("entering rdb_del_next_hop: next hop %x TE link ID %x", next_hop,
-	     te_link_id);
+  RSVP_TRACE ("entering rdb_del_next_hop: next hop %x TE link ID %x", next_hop,
+	      te_link_id);
 
   if ((next_hop_entry =
        (RDB_NEXT_HOP *) patricia_tree_get (&NextHopTree,
@@ -1027,7 +1027,7 @@ rdb_del_next_hop (IPV4_ADDR next_hop, uns32 te_link_id)
 	}
       XFREE (MTYPE_TE, next_hop_entry);
     }
-  zlog_info ("leaving rdb_del_next_hop");
+  RSVP_TRACE ("leaving rdb_del_next_hop");
   return E_OK;
 }
 
@@ -2186,6 +2186,9 @@ rdb_remote_link_bw_update (IPV4_ADDR from_node,
   int i, recalculate = 0;
   float PathMaxReservableBW, HopMaxReservableBW;
 
+  if (LinkSwitchCap == PSC_PATH)
+    CspfLinkBwDecrease (from_node, to_node, BW2Decrease, Priority);
+
   link_key.local_ip = from_node;
   link_key.remote_ip = to_node;
 
@@ -0,0 +1,302 @@
+#include <zebra.h>
+
+#include "checksum.h"
+
+/* Checksums: the word at a time in_cksum and fletcher_checksum against
+ * the byte at a time versions they replace, for every length and
+ * checksum offset up to a few hundred bytes, at every alignment and on
+ * longer buffers, then their throughput.
+ *
+ * The Fletcher reference is ospf_lsa_checksum as it was, ospf6d had the
+ * same code.  iso_csum_create wrote a bad checksum for a few inputs,
+ * there the new checksum must verify where the old one did not.
+ *
+ * testchecksum [iterations]
+ */
+
+struct thread_master *master;
+
+static unsigned long seed = 1;
+
+static unsigned long
+test_random (void)
+{
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 8) & 0xffffff;
+}
+
+/* The in_cksum of lib/checksum.c before. */
+static int
+ref_in_cksum (void *parg, int nbytes)
+{
+  u_short *ptr = parg;
+  long sum;
+  u_short oddbyte;
+  u_short answer;
+
+  sum = 0;
+  while (nbytes > 1)
+    {
+      sum += *ptr++;
+      nbytes -= 2;
+    }
+  if (nbytes == 1)
+    {
+      oddbyte = 0;
+      *((u_char *) &oddbyte) = *(u_char *) ptr;
+      sum += oddbyte;
+    }
+  sum = (sum >> 16) + (sum & 0xffff);
+  sum += (sum >> 16);
+  answer = ~sum;
+  return answer;
+}
+
+/* ospf_lsa_checksum before, on len bytes with the checksum at offset. */
+#define MODX 4102
+
+static u_int16_t
+ref_fletcher (u_char *buffer, int len, int offset)
+{
+  u_char *sp, *ep, *p, *q;
+  int c0 = 0, c1 = 0;
+  int x, y;
+
+  buffer[offset] = buffer[offset + 1] = 0;
+  sp = buffer;
+  for (ep = sp + len; sp < ep; sp = q)
+    {
+      q = sp + MODX;
+      if (q > ep)
+        q = ep;
+      for (p = sp; p < q; p++)
+        {
+          c0 += *p;
+          c1 += c0;
+        }
+      c0 %= 255;
+      c1 %= 255;
+    }
+
+  x = ((len - offset - 1) * c0 - c1) % 255;
+  if (x <= 0)
+    x += 255;
+  y = 510 - c0 - x;
+  if (y > 255)
+    y -= 255;
+  buffer[offset] = x;
+  buffer[offset + 1] = y;
+  return (x << 8) + y;
+}
+
+/* iso_csum_create before, isisd/iso_checksum.c. */
+static u_int16_t
+ref_iso_create (u_char *buffer, int len, u_int16_t n)
+{
+  u_int8_t *p;
+  int x, y;
+  u_int32_t mul, c0, c1;
+  u_int16_t checksum;
+  int init_len, partial_len, i;
+
+  checksum = 0;
+  memcpy (buffer + n, &checksum, 2);
+  p = buffer;
+  c0 = c1 = 0;
+  init_len = len;
+  while (len != 0)
+    {
+      partial_len = MIN (len, 5803);
+      for (i = 0; i < partial_len; i++)
+	{
+	  c0 = c0 + *(p++);
+	  c1 += c0;
+	}
+      c0 = c0 % 255;
+      c1 = c1 % 255;
+      len -= partial_len;
+    }
+  mul = (init_len - n) * (c0);
+  x = mul - c0 - c1;
+  y = c1 - mul - 1;
+  if (y > 0)
+    y++;
+  if (x < 0)
+    x--;
+  x %= 255;
+  y %= 255;
+  if (x == 0)
+    x = 255;
+  if (y == 0)
+    y = 1;
+  checksum = (y << 8) | (x & 0xFF);
+  memcpy (buffer + n, &checksum, 2);
+  return checksum;
+}
+
+static void
+test_fill (u_char *buf, int len, int pattern)
+{
+  int i;
+
+  for (i = 0; i < len; i++)
+    switch (pattern)
+      {
+      case 0: buf[i] = 0; break;
+      case 1: buf[i] = 0xff; break;
+      case 2: buf[i] = (test_random () % 3) ? 0 : 0xff; break;
+      default: buf[i] = test_random (); break;
+      }
+}
+
+#define TEST_MAX 70000
+#define TEST_PATTERNS 4
+
+static u_char ref_buf[TEST_MAX + 8];
+static u_char new_buf[TEST_MAX + 8];
+
+static int failed;
+
+static void
+test_report (const char *what, int len, int offset, int align, int pattern)
+{
+  if (failed++ < 10)
+    printf ("%s differs: length %d offset %d alignment %d pattern %d\n",
+	    what, len, offset, align, pattern);
+}
+
+static void
+test_in_cksum (int len, int align, int pattern)
+{
+  u_char *buf = new_buf + align;
+
+  test_fill (buf, len, pattern);
+  memcpy (ref_buf, buf, len);
+  if (in_cksum (buf, len) != ref_in_cksum (ref_buf, len))
+    test_report ("in_cksum", len, 0, align, pattern);
+}
+
+static int iso_bad;
+
+static void
+test_fletcher (int len, int offset, int align, int pattern)
+{
+  u_char *buf = new_buf + align;
+  u_int16_t sum;
+
+  test_fill (buf, len, pattern);
+  memcpy (ref_buf, buf, len);
+
+  sum = fletcher_checksum (buf, len, offset);
+  if (sum != ref_fletcher (ref_buf, len, offset)
+      || memcmp (buf, ref_buf, len) != 0)
+    test_report ("fletcher_checksum", len, offset, align, pattern);
+  if (fletcher_checksum (buf, len, FLETCHER_CHECKSUM_VALIDATE) != 0)
+    test_report ("fletcher_checksum validate", len, offset, align,
+		 pattern);
+
+  /* Where iso_csum_create differs, its checksum must be the bad one. */
+  ref_iso_create (ref_buf, len, offset);
+  if (memcmp (buf + offset, ref_buf + offset, 2) != 0)
+    {
+      if (fletcher_checksum (ref_buf, len, FLETCHER_CHECKSUM_VALIDATE) == 0)
+	test_report ("iso_csum_create", len, offset, align, pattern);
+      iso_bad++;
+    }
+
+  /* Corrupt a byte, the checksum must no longer verify. */
+  buf[test_random () % len] ^= 1 << (test_random () % 8);
+  if (fletcher_checksum (buf, len, FLETCHER_CHECKSUM_VALIDATE) == 0)
+    test_report ("fletcher_checksum corrupt", len, offset, align, pattern);
+}
+
+static double
+elapsed (struct timeval *start)
+{
+  struct timeval now;
+
+  gettimeofday (&now, NULL);
+  return (now.tv_sec - start->tv_sec) + (now.tv_usec - start->tv_usec) / 1e6;
+}
+
+static void
+bench (int len, long iterations)
+{
+  struct timeval start;
+  double t[4];
+  volatile u_int16_t sink;
+  long i, n;
+
+  test_fill (new_buf, len, 3);
+  n = iterations * 1500 / len + 1;
+
+  gettimeofday (&start, NULL);
+  for (i = 0; i < n; i++)
+    sink = ref_fletcher (new_buf, len, 14);
+  t[0] = elapsed (&start);
+  gettimeofday (&start, NULL);
+  for (i = 0; i < n; i++)
+    sink = fletcher_checksum (new_buf, len, 14);
+  t[1] = elapsed (&start);
+  gettimeofday (&start, NULL);
+  for (i = 0; i < n; i++)
+    sink = ref_in_cksum (new_buf, len);
+  t[2] = elapsed (&start);
+  gettimeofday (&start, NULL);
+  for (i = 0; i < n; i++)
+    sink = in_cksum (new_buf, len);
+  t[3] = elapsed (&start);
+  (void) sink;
+
+  printf ("%6d bytes: fletcher %8.1f MB/s, before %8.1f MB/s; "
+	  "in_cksum %8.1f MB/s, before %8.1f MB/s\n", len,
+	  n * len / t[1] / 1e6, n * len / t[0] / 1e6,
+	  n * len / t[3] / 1e6, n * len / t[2] / 1e6);
+}
+
+int
+main (int argc, char **argv)
+{
+  long iterations = 200000;
+  int len, offset, align, pattern, i;
+
+  if (argc > 1)
+    iterations = atol (argv[1]);
+
+  for (pattern = 0; pattern < TEST_PATTERNS; pattern++)
+    for (align = 0; align < 8; align++)
+      {
+	for (len = 0; len <= 1100; len++)
+	  test_in_cksum (len, align, pattern);
+	for (len = 2; len <= 300; len++)
+	  for (offset = 0; offset < len - 1; offset++)
+	    test_fletcher (len, offset, align, pattern);
+      }
+
+  /* Longer buffers, past the chunks the sums are reduced in.  The
+     checksum offset is 16 bits. */
+  for (i = 0; i < 2000; i++)
+    {
+      len = 2 + test_random () % (TEST_MAX - 2);
+      if (i < 100)
+	len = TEST_MAX - i;
+      pattern = i % TEST_PATTERNS;
+      align = test_random () % 8;
+      test_in_cksum (len, align, pattern);
+      offset = test_random () % MIN (len - 1, FLETCHER_CHECKSUM_VALIDATE);
+      test_fletcher (len, offset, align, pattern);
+    }
+
+  if (failed)
+    {
+      printf ("%d checks failed\n", failed);
+      return 1;
+    }
+  printf ("checksums agree, iso_csum_create was bad %d times\n", iso_bad);
+
+  bench (64, iterations);
+  bench (1500, iterations);
+  bench (8192, iterations);
+  bench (65535, iterations);
+  return 0;
+}
@@ -0,0 +1,287 @@
+#include <zebra.h>
+
+#include "command.h"
+#include "memory.h"
+#include "vector.h"
+#include "vty.h"
+#include "buffer.h"
+#include "prefix.h"
+#include "filter.h"
+#include "plist.h"
+#include "routemap.h"
+
+/* Configuration loading: time config_from_file on a generated
+ * configuration with the commands matched through the per-node token
+ * trie and with the linear match, after checking both agree on a set of
+ * good, partial and bad lines.
+ *
+ * The config node holds the access-list, prefix-list and route-map
+ * commands of lib plus synthetic commands standing in for a daemon's
+ * command set.
+ *
+ * testcmdtrie [lines [commands]]
+ */
+
+struct thread_master *master;
+extern vector cmdvec;
+
+static int
+filler_func (struct cmd_element *self, struct vty *vty, int argc,
+	     const char *argv[])
+{
+  return CMD_SUCCESS;
+}
+
+/* Command shapes of the synthetic set, %d is the command number. */
+static const char *filler_shapes[] =
+{
+  "filler%d (alpha|beta|gamma) <1-4294967295>",
+  "filler%d neighbor A.B.C.D remote-as <1-65535>",
+  "filler%d neighbor A.B.C.D description .LINE",
+  "filler%d network A.B.C.D/M [route-map WORD]",
+  "filler%d timers <1-65535> <1-65535>",
+  "no filler%d (alpha|beta|gamma)",
+  "filler%d area (A.B.C.D|<0-4294967295>) range A.B.C.D/M",
+  "filler%d redistribute (kernel|connected|static) metric <0-16>",
+};
+#define FILLER_SHAPES (sizeof (filler_shapes) / sizeof (filler_shapes[0]))
+
+static void
+filler_install (int count)
+{
+  struct cmd_element *cmd;
+  char buf[256];
+  int i;
+
+  for (i = 0; i < count; i++)
+    {
+      snprintf (buf, sizeof (buf), filler_shapes[i % FILLER_SHAPES],
+		i / FILLER_SHAPES);
+      cmd = XCALLOC (MTYPE_TMP, sizeof (struct cmd_element));
+      cmd->string = strdup (buf);
+      cmd->func = filler_func;
+      cmd->doc = "";
+      install_element (CONFIG_NODE, cmd);
+    }
+}
+
+static void
+config_write (FILE *fp, const char *name, long lines, int count)
+{
+  int groups = count / FILLER_SHAPES;
+  long i;
+
+  for (i = 0; i < lines; i++)
+    {
+      int n = (i / 8) % groups;
+
+      switch (i % 8)
+	{
+	case 0:
+	  fprintf (fp, "ip prefix-list %s%ld seq %ld permit 10.%ld.%ld.0/24 "
+		   "le 32\n", name, i % 97, i + 5, (i >> 8) & 255, i & 255);
+	  break;
+	case 1:
+	  fprintf (fp, "access-list %s%ld permit 172.%ld.%ld.0/24\n",
+		   name, i % 89, 16 + (i >> 8) % 16, i & 255);
+	  break;
+	case 2:
+	  fprintf (fp, "filler%d neighbor 192.0.2.%ld remote-as %ld\n",
+		   n, i & 255, 1 + i % 65535);
+	  break;
+	case 3:
+	  fprintf (fp, "filler%d neighbor 192.0.2.%ld description peer %ld "
+		   "of %s\n", n, i & 255, i, name);
+	  break;
+	case 4:
+	  fprintf (fp, "filler%d area %ld range 10.%ld.0.0/16\n", n, i % 10,
+		   i & 255);
+	  break;
+	case 5:
+	  fprintf (fp, "route-map %s%ld permit %ld\n", name, i % 31,
+		   1 + i % 65535);
+	  fprintf (fp, " description entry %ld\n", i);
+	  break;
+	case 6:
+	  fprintf (fp, "filler%d redistribute connected metric %ld\n", n,
+		   i % 17);
+	  break;
+	default:
+	  fprintf (fp, "filler%d network 10.%ld.%ld.0/24 route-map %s\n", n,
+		   (i >> 8) & 255, i & 255, name);
+	  break;
+	}
+    }
+}
+
+static double
+config_load (struct vty *vty, const char *file)
+{
+  struct timeval start, end;
+  FILE *fp;
+  int ret;
+
+  fp = fopen (file, "r");
+  vty->node = CONFIG_NODE;
+  gettimeofday (&start, NULL);
+  ret = config_from_file (vty, fp);
+  gettimeofday (&end, NULL);
+  fclose (fp);
+  buffer_reset (vty->obuf);
+  if (ret != CMD_SUCCESS)
+    {
+      printf ("line failed with %d: %s", ret, vty->buf);
+      exit (1);
+    }
+  return (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) / 1e6;
+}
+
+/* Lines both matchers must agree on. */
+static const char *check_lines[] =
+{
+  "ip prefix-list CHECK seq 5 permit 10.0.0.0/8",
+  "ip prefix-list CHECK seq 5 permit 10.0.0.0/8 le",
+  "ip prefix-list CHECK seq 5 permit 10.0.0.0/8 le 32",
+  "ip prefix-list CHECK seq 5 permit 10.0.0.0/",
+  "ip prefix-list CHECK permit any",
+  "ip prefix-list CHECK description some text here",
+  "ip prefix",
+  "ip prefix-lis CHECK permit any",
+  "access-list CHECK permit 10.0.0.0/8",
+  "access-list 10 permit 10.0.0.0 0.0.0.255",
+  "access-list 100 permit ip any any",
+  "access-list 99999 permit any",
+  "no access-list CHECK",
+  "route-map CHECK permit 10",
+  "route-map CHECK permit 99999999",
+  "route-map CHECK",
+  "filler0 alpha 7",
+  "filler0 alpha 4294967296",
+  "filler0 delta 7",
+  "filler0 alpha",
+  "filler1 neighbor 192.0.2.1 remote-as 100",
+  "filler1 neighbor 192.0.2.1 remote-as 100 extra",
+  "filler1 neighbor 192.0.2 remote-as 100",
+  "filler2 neighbor 192.0.2.1 description a b c d",
+  "filler3 network 10.0.0.0/8",
+  "filler3 network 10.0.0.0/8 route-map X",
+  "filler3 network 10.0.0.0/8 route-map",
+  "filler3 network 10.0.0.0",
+  "filler4 timers 1 2",
+  "filler5 area 1.1.1.1 range 10.0.0.0/8",
+  "filler5 area 17 range 10.0.0.0/8",
+  "filler6 redistribute static metric 3",
+  "filler6 redistribute static metric 17",
+  "no filler7 gamma",
+  "no filler7",
+  "fill",
+  "",
+};
+#define CHECK_LINES (sizeof (check_lines) / sizeof (check_lines[0]))
+
+static int
+check_match (struct vty *vty, struct cmd_node *cnode)
+{
+  struct cmd_trie_node *trie = cnode->trie;
+  struct cmd_element *cmd_trie, *cmd_linear;
+  int ret_trie, ret_linear;
+  int failed = 0;
+  unsigned int i;
+  vector vline;
+
+  for (i = 0; i < CHECK_LINES; i++)
+    {
+      if ((vline = cmd_make_strvec (check_lines[i])) == NULL)
+	continue;
+      cmd_trie = cmd_linear = NULL;
+      vty->node = CONFIG_NODE;
+      ret_trie = cmd_execute_command_strict (vline, vty, &cmd_trie);
+      cnode->trie = NULL;
+      vty->node = CONFIG_NODE;
+      ret_linear = cmd_execute_command_strict (vline, vty, &cmd_linear);
+      cnode->trie = trie;
+      cmd_free_strvec (vline);
+
+      if (cmd_trie != cmd_linear
+	  || (ret_trie != ret_linear
+	      && (ret_trie == CMD_ERR_NO_MATCH
+		  || ret_trie == CMD_ERR_AMBIGUOUS
+		  || ret_trie == CMD_ERR_INCOMPLETE
+		  || ret_linear == CMD_ERR_NO_MATCH
+		  || ret_linear == CMD_ERR_AMBIGUOUS
+		  || ret_linear == CMD_ERR_INCOMPLETE)))
+	{
+	  printf ("\"%s\": trie %d %s, linear %d %s\n", check_lines[i],
+		  ret_trie, cmd_trie ? cmd_trie->string : "-",
+		  ret_linear, cmd_linear ? cmd_linear->string : "-");
+	  failed++;
+	}
+    }
+  buffer_reset (vty->obuf);
+  return failed;
+}
+
+int
+main (int argc, char **argv)
+{
+  char file_trie[] = "/tmp/testcmdtrie.XXXXXX";
+  char file_linear[] = "/tmp/testcmdtrie.XXXXXX";
+  long lines = 50000;
+  int count = 2000;
+  struct cmd_node *cnode;
+  struct cmd_trie_node *trie;
+  double trie_time, linear_time;
+  struct vty *vty;
+  FILE *fp;
+  int fd;
+
+  if (argc > 1)
+    lines = atol (argv[1]);
+  if (argc > 2)
+    count = atoi (argv[2]);
+  if (count < (int) FILLER_SHAPES * 8)
+    count = FILLER_SHAPES * 8;
+
+  cmd_init (1);
+  access_list_init ();
+  prefix_list_init ();
+  route_map_init ();
+  route_map_init_vty ();
+  filler_install (count);
+  vty = vty_new ();
+  cnode = vector_slot (cmdvec, CONFIG_NODE);
+
+  if (check_match (vty, cnode))
+    return 1;
+
+  if ((fd = mkstemp (file_trie)) < 0 || (fp = fdopen (fd, "w")) == NULL)
+    {
+      perror ("mkstemp");
+      return 1;
+    }
+  config_write (fp, "T", lines, count);
+  fclose (fp);
+  if ((fd = mkstemp (file_linear)) < 0 || (fp = fdopen (fd, "w")) == NULL)
+    {
+      perror ("mkstemp");
+      return 1;
+    }
+  config_write (fp, "L", lines, count);
+  fclose (fp);
+
+  trie_time = config_load (vty, file_trie);
+  trie = cnode->trie;
+  cnode->trie = NULL;
+  linear_time = config_load (vty, file_linear);
+  cnode->trie = trie;
+  unlink (file_trie);
+  unlink (file_linear);
+
+  printf ("%ld configuration lines, %d config node commands\n",
+	  lines + lines / 8, vector_active (cnode->cmd_vector));
+  printf ("trie:   %8.3f sec, %8.0f lines/sec\n", trie_time,
+	  (lines + lines / 8) / trie_time);
+  printf ("linear: %8.3f sec, %8.0f lines/sec\n", linear_time,
+	  (lines + lines / 8) / linear_time);
+  return 0;
+}
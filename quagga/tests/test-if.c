@@ -0,0 +1,260 @@
+#include <zebra.h>
+
+#include "if.h"
+#include "prefix.h"
+#include "memory.h"
+#include "linklist.h"
+
+/* Interface lookups on a box with many VLAN subinterfaces: lookups per
+ * second by ifindex, by name, by exact address and by longest prefix,
+ * through the interface indexes and by walking iflist as before.  Both
+ * must return the same interface.
+ *
+ * testif [interfaces [lookups]]
+ */
+
+struct thread_master *master;
+
+static unsigned long seed = 1;
+
+static unsigned long
+bench_random (void)
+{
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 8) & 0xffffff;
+}
+
+/* The iflist walks the lookups used to do. */
+static struct interface *
+walk_by_index (unsigned int index)
+{
+  struct listnode *node;
+  struct interface *ifp;
+
+  for (ALL_LIST_ELEMENTS_RO (iflist, node, ifp))
+    if (ifp->ifindex == index)
+      return ifp;
+  return NULL;
+}
+
+static struct interface *
+walk_by_name (const char *name)
+{
+  struct listnode *node;
+  struct interface *ifp;
+
+  for (ALL_LIST_ELEMENTS_RO (iflist, node, ifp))
+    if (strcmp (name, ifp->name) == 0)
+      return ifp;
+  return NULL;
+}
+
+static struct interface *
+walk_exact_address (struct in_addr src)
+{
+  struct listnode *node, *cnode;
+  struct interface *ifp;
+  struct connected *c;
+
+  for (ALL_LIST_ELEMENTS_RO (iflist, node, ifp))
+    for (ALL_LIST_ELEMENTS_RO (ifp->connected, cnode, c))
+      if (c->address && c->address->family == AF_INET
+	  && IPV4_ADDR_SAME (&c->address->u.prefix4, &src))
+	return ifp;
+  return NULL;
+}
+
+static struct interface *
+walk_address (struct in_addr src)
+{
+  struct listnode *node, *cnode;
+  struct interface *ifp, *match = NULL;
+  struct connected *c;
+  struct prefix addr;
+  int bestlen = 0;
+
+  addr.family = AF_INET;
+  addr.u.prefix4 = src;
+  addr.prefixlen = IPV4_MAX_BITLEN;
+
+  for (ALL_LIST_ELEMENTS_RO (iflist, node, ifp))
+    for (ALL_LIST_ELEMENTS_RO (ifp->connected, cnode, c))
+      if (c->address && (c->address->family == AF_INET)
+	  && prefix_match (CONNECTED_PREFIX (c), &addr)
+	  && (c->address->prefixlen > bestlen))
+	{
+	  bestlen = c->address->prefixlen;
+	  match = ifp;
+	}
+  return match;
+}
+
+/* Interface i is vlan i on one of four trunks, with a /24, a /30
+   towards a router, and every 16th a peer address. */
+static void
+bench_setup (int count)
+{
+  struct interface *ifp;
+  struct connected *ifc;
+  struct prefix p, d;
+  char name[INTERFACE_NAMSIZ];
+  int i;
+
+  for (i = 0; i < count; i++)
+    {
+      snprintf (name, sizeof (name), "eth%d.%d", i % 4, 100 + i);
+      ifp = if_get_by_name (name);
+      if_set_index (ifp, 10 + i);
+
+      str2prefix ("10.0.0.1/24", &p);
+      p.u.prefix4.s_addr = htonl (0x0a000001 + (i << 8));
+      connected_add_by_prefix (ifp, &p, NULL);
+
+      str2prefix ("172.16.0.1/30", &p);
+      p.u.prefix4.s_addr = htonl (0xac100001 + (i << 2));
+      connected_add_by_prefix (ifp, &p, NULL);
+
+      if ((i % 16) == 0)
+	{
+	  str2prefix ("192.168.0.1/32", &p);
+	  p.u.prefix4.s_addr = htonl (0xc0a80001 + (i << 1));
+	  d = p;
+	  d.u.prefix4.s_addr = htonl (0xc0a80002 + (i << 1));
+	  ifc = connected_add_by_prefix (ifp, &p, &d);
+	  SET_FLAG (ifc->flags, ZEBRA_IFA_PEER);
+	}
+    }
+
+  /* Renumber and remove a few, the indexes must follow. */
+  for (i = 0; i < count; i += 7)
+    {
+      snprintf (name, sizeof (name), "eth%d.%d", i % 4, 100 + i);
+      ifp = if_lookup_by_name (name);
+      if_set_index (ifp, 10 + count + i);
+      str2prefix ("10.0.0.1/24", &p);
+      p.u.prefix4.s_addr = htonl (0x0a000001 + (i << 8));
+      connected_free (connected_delete_by_prefix (ifp, &p));
+    }
+}
+
+static struct in_addr
+bench_address (int count)
+{
+  struct in_addr addr;
+
+  switch (bench_random () % 4)
+    {
+    case 0:
+      addr.s_addr = htonl (0x0a000001 + ((bench_random () % count) << 8)
+			   + bench_random () % 4);
+      break;
+    case 1:
+      addr.s_addr = htonl (0xac100001 + ((bench_random () % count) << 2)
+			   + bench_random () % 2);
+      break;
+    case 2:
+      addr.s_addr = htonl (0xc0a80001 + bench_random () % (count * 2));
+      break;
+    default:
+      addr.s_addr = htonl (bench_random ());
+      break;
+    }
+  return addr;
+}
+
+static double
+elapsed (struct timeval *start)
+{
+  struct timeval now;
+
+  gettimeofday (&now, NULL);
+  return (now.tv_sec - start->tv_sec) + (now.tv_usec - start->tv_usec) / 1e6;
+}
+
+int
+main (int argc, char **argv)
+{
+  int count = 4096;
+  long lookups = 200000, i;
+  unsigned int *indexes;
+  char (*names)[INTERFACE_NAMSIZ];
+  struct in_addr *addrs;
+  struct interface *volatile sink;
+  struct timeval start;
+  double indexed[4], walked[4];
+  long failed = 0;
+  const char *kind[4] = { "ifindex", "name", "exact address", "address" };
+  int k;
+
+  if (argc > 1)
+    count = atoi (argv[1]);
+  if (argc > 2)
+    lookups = atol (argv[2]);
+  if (count < 16)
+    count = 16;
+
+  if_init ();
+  bench_setup (count);
+
+  indexes = calloc (lookups, sizeof (unsigned int));
+  names = calloc (lookups, INTERFACE_NAMSIZ);
+  addrs = calloc (lookups, sizeof (struct in_addr));
+  for (i = 0; i < lookups; i++)
+    {
+      indexes[i] = 10 + bench_random () % (count * 2);
+      snprintf (names[i], INTERFACE_NAMSIZ, "eth%ld.%ld",
+		bench_random () % 4, 100 + bench_random () % count);
+      addrs[i] = bench_address (count);
+    }
+
+  /* The iflist walks are slow: check a sample of one lookup in 100
+     against them, as the timing loop below walks lookups / 100. */
+  for (i = 0; i < lookups; i += 100)
+    if (if_lookup_by_index (indexes[i]) != walk_by_index (indexes[i])
+	|| if_lookup_by_name (names[i]) != walk_by_name (names[i])
+	|| if_lookup_exact_address (addrs[i]) != walk_exact_address (addrs[i])
+	|| if_lookup_address (addrs[i]) != walk_address (addrs[i]))
+      {
+	if (failed++ < 10)
+	  printf ("lookup %ld differs: index %u name %s address %s\n",
+		  i, indexes[i], names[i], inet_ntoa (addrs[i]));
+      }
+
+  for (k = 0; k < 4; k++)
+    {
+      gettimeofday (&start, NULL);
+      for (i = 0; i < lookups; i++)
+	switch (k)
+	  {
+	  case 0: sink = if_lookup_by_index (indexes[i]); break;
+	  case 1: sink = if_lookup_by_name (names[i]); break;
+	  case 2: sink = if_lookup_exact_address (addrs[i]); break;
+	  default: sink = if_lookup_address (addrs[i]); break;
+	  }
+      indexed[k] = elapsed (&start);
+
+      gettimeofday (&start, NULL);
+      for (i = 0; i < lookups / 100; i++)
+	switch (k)
+	  {
+	  case 0: sink = walk_by_index (indexes[i]); break;
+	  case 1: sink = walk_by_name (names[i]); break;
+	  case 2: sink = walk_exact_address (addrs[i]); break;
+	  default: sink = walk_address (addrs[i]); break;
+	  }
+      walked[k] = elapsed (&start) * 100;
+    }
+  (void) sink;
+
+  printf ("%d interfaces, %ld lookups\n", count, lookups);
+  for (k = 0; k < 4; k++)
+    printf ("%-14s indexed %10.0f/sec, iflist walk %10.0f/sec\n", kind[k],
+	    lookups / indexed[k], lookups / walked[k]);
+  if (failed)
+    {
+      printf ("%ld of %ld checked lookups differ\n", failed,
+	      (lookups + 99) / 100);
+      return 1;
+    }
+  return 0;
+}
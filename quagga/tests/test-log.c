@@ -0,0 +1,106 @@
+#include <zebra.h>
+
+#include "log.h"
+#include "memory.h"
+
+/* Logging throughput: zlog_debug calls per second to a log file, with
+ * every line written as it is logged and with the lines queued and
+ * written in batches, the way the thread scheduler flushes them.
+ *
+ * testlog [messages [batch]]
+ */
+
+struct thread_master *master;
+
+static double
+log_run (const char *file, size_t async, long count, long batch)
+{
+  struct timeval start, end;
+  long i;
+
+  unlink (file);
+  zlog_set_file (NULL, file, LOG_DEBUG);
+  zlog_set_async (NULL, async);
+
+  gettimeofday (&start, NULL);
+  for (i = 0; i < count; i++)
+    {
+      zlog_debug ("update from peer 192.0.2.%ld: prefix 10.%ld.%ld.0/24 "
+		  "nexthop 198.51.100.1 med %ld", i % 250, (i >> 8) & 255,
+		  i & 255, i);
+      if (((i + 1) % batch) == 0)
+	zlog_flush (NULL);
+    }
+  zlog_flush (NULL);
+  gettimeofday (&end, NULL);
+
+  zlog_set_async (NULL, 0);
+  zlog_reset_file (NULL);
+  return (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) / 1e6;
+}
+
+static long
+log_lines (const char *file)
+{
+  FILE *fp;
+  long lines = 0;
+  int c;
+
+  if ((fp = fopen (file, "r")) == NULL)
+    return -1;
+  while ((c = getc (fp)) != EOF)
+    if (c == '\n')
+      lines++;
+  fclose (fp);
+  return lines;
+}
+
+int
+main (int argc, char **argv)
+{
+  char file[] = "/tmp/testlog.XXXXXX";
+  long count = 200000, batch = 100;
+  double sync_time, async_time;
+  int fd;
+
+  if (argc > 1)
+    count = atol (argv[1]);
+  if (argc > 2)
+    batch = atol (argv[2]);
+
+  if ((fd = mkstemp (file)) < 0)
+    {
+      perror ("mkstemp");
+      return 1;
+    }
+  close (fd);
+
+  zlog_default = openzlog ("testlog", ZLOG_NONE, LOG_CONS|LOG_NDELAY|LOG_PID,
+			   LOG_DAEMON);
+  zlog_set_level (NULL, ZLOG_DEST_SYSLOG, ZLOG_DISABLED);
+  zlog_set_level (NULL, ZLOG_DEST_MONITOR, ZLOG_DISABLED);
+
+  sync_time = log_run (file, 0, count, batch);
+  if (log_lines (file) != count)
+    {
+      printf ("synchronous: %ld lines logged, %ld written\n", count,
+	      log_lines (file));
+      return 1;
+    }
+  async_time = log_run (file, ZLOG_ASYNC_DEFAULT_SIZE, count, batch);
+  if (log_lines (file) + (long) zlog_default->async[ZLOG_DEST_FILE].dropped
+      != count)
+    {
+      printf ("asynchronous: %ld lines logged, %ld written\n", count,
+	      log_lines (file));
+      return 1;
+    }
+  unlink (file);
+
+  printf ("%ld messages, flushed every %ld\n", count, batch);
+  printf ("synchronous:  %8.0f calls/sec\n", count / sync_time);
+  printf ("asynchronous: %8.0f calls/sec, %lu writes, %lu dropped\n",
+	  count / async_time, zlog_default->async[ZLOG_DEST_FILE].writes,
+	  zlog_default->async[ZLOG_DEST_FILE].dropped);
+  return 0;
+}
@@ -0,0 +1,191 @@
+#include <zebra.h>
+
+#include "prefix.h"
+#include "table.h"
+#include "memory.h"
+
+/* Resuming a walk by key: route_table_get_next against route_node_get
+ * and route_next, the way the SNMP lookups found the row after an index.
+ * Both must return the same node for keys in and out of the table, and
+ * route_table_get_next must leave the table as it was.  Then the time of
+ * a full walk resumed from the key at every step, as an SNMP walk does.
+ *
+ * testtable [routes]
+ */
+
+struct thread_master *master;
+
+static unsigned long seed = 1;
+
+static unsigned long
+test_random (void)
+{
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 8) & 0xffffff;
+}
+
+/* Prefixes clustered the way a routing table is, under a few /8s with
+   lengths from 8 to 32. */
+static void
+test_prefix (struct prefix_ipv4 *p)
+{
+  static const int lens[] = { 8, 12, 16, 19, 20, 22, 23, 24, 24, 24, 24, 32 };
+
+  p->family = AF_INET;
+  p->prefixlen = lens[test_random () % (sizeof (lens) / sizeof (lens[0]))];
+  p->prefix.s_addr = htonl (((10 + test_random () % 4) << 24)
+			    | (test_random () << 8) | (test_random () & 0xff));
+  apply_mask_ipv4 (p);
+}
+
+static unsigned long
+table_nodes (struct route_table *table)
+{
+  struct route_node *rn;
+  unsigned long n = 0;
+
+  for (rn = route_top (table); rn; rn = route_next (rn))
+    n++;
+  return n;
+}
+
+/* The node after p as found before: add p, step on and let route_next
+   remove p again. */
+static struct route_node *
+ref_get_next (struct route_table *table, struct prefix *p)
+{
+  return route_next (route_node_get (table, p));
+}
+
+static int failed;
+
+#define LSDB_KEYS 20000
+
+static void
+test_check (struct route_table *table, struct prefix *p)
+{
+  struct route_node *rn, *ref;
+  char buf[BUFSIZ];
+
+  rn = route_table_get_next (table, p);
+  ref = ref_get_next (table, p);
+  if (rn != ref && failed++ < 10)
+    printf ("next of %s/%d differs\n",
+	    inet_ntop (AF_INET, &p->u.prefix, buf, sizeof (buf)), p->prefixlen);
+  if (rn)
+    route_unlock_node (rn);
+  if (ref)
+    route_unlock_node (ref);
+}
+
+static double
+elapsed (struct timeval *start)
+{
+  struct timeval now;
+
+  gettimeofday (&now, NULL);
+  return (now.tv_sec - start->tv_sec) + (now.tv_usec - start->tv_usec) / 1e6;
+}
+
+/* Visit every route, each step from the key of the one before. */
+static double
+walk (struct route_table *table, int get_next, unsigned long *count)
+{
+  struct route_node *rn;
+  struct prefix key;
+  struct timeval start;
+
+  *count = 0;
+  gettimeofday (&start, NULL);
+  for (rn = route_top (table); rn; )
+    {
+      if (rn->info)
+	(*count)++;
+      key = rn->p;
+      route_unlock_node (rn);
+      rn = get_next ? route_table_get_next (table, &key)
+		    : ref_get_next (table, &key);
+    }
+  return elapsed (&start);
+}
+
+int
+main (int argc, char **argv)
+{
+  struct route_table *table, *lsdb;
+  struct route_node *rn;
+  struct prefix_ipv4 p;
+  struct prefix_ls lp;
+  unsigned long nodes, count_next, count_get;
+  double t_next, t_get;
+  int routes = 200000;
+  int i;
+
+  if (argc > 1)
+    routes = atoi (argv[1]);
+
+  table = route_table_init ();
+  for (i = 0; i < routes; i++)
+    {
+      test_prefix (&p);
+      rn = route_node_get (table, (struct prefix *) &p);
+      if (rn->info)
+	route_unlock_node (rn);
+      else
+	rn->info = table;
+    }
+  nodes = table_nodes (table);
+
+  /* Keys in the table, and not, also above and below all of it. */
+  for (rn = route_top (table); rn; rn = route_next (rn))
+    test_check (table, &rn->p);
+  for (i = 0; i < routes; i++)
+    {
+      test_prefix (&p);
+      if (i % 16 == 0)
+	p.prefixlen = test_random () % 33;
+      apply_mask_ipv4 (&p);
+      test_check (table, (struct prefix *) &p);
+    }
+  str2prefix_ipv4 ("0.0.0.0/0", &p);
+  test_check (table, (struct prefix *) &p);
+  str2prefix_ipv4 ("255.255.255.255/32", &p);
+  test_check (table, (struct prefix *) &p);
+  if (table_nodes (table) != nodes && failed++ < 10)
+    printf ("table has %lu nodes, had %lu\n", table_nodes (table), nodes);
+
+  /* The OSPF LSDB keys, 64 bits of LSA ID and advertising router. */
+  lsdb = route_table_init ();
+  memset (&lp, 0, sizeof (lp));
+  lp.prefixlen = 64;
+  for (i = 0; i < 2 * LSDB_KEYS; i++)
+    {
+      lp.id.s_addr = htonl ((100 << 24) | test_random ());
+      lp.adv_router.s_addr = htonl (test_random () % 8);
+      if (i < LSDB_KEYS)
+	{
+	  rn = route_node_get (lsdb, (struct prefix *) &lp);
+	  rn->info = lsdb;
+	}
+      else
+	test_check (lsdb, (struct prefix *) &lp);
+    }
+  for (rn = route_top (lsdb); rn; rn = route_next (rn))
+    test_check (lsdb, &rn->p);
+
+  if (failed)
+    {
+      printf ("%d checks failed\n", failed);
+      return 1;
+    }
+
+  t_next = walk (table, 1, &count_next);
+  t_get = walk (table, 0, &count_get);
+  printf ("%lu routes in %lu nodes, next node found the same\n",
+	  count_next, nodes);
+  printf ("route_table_get_next:     %8.3f sec, %10.0f steps/sec\n", t_next,
+	  nodes / t_next);
+  printf ("route_node_get/route_next: %7.3f sec, %10.0f steps/sec\n", t_get,
+	  nodes / t_get);
+  return count_next == count_get ? 0 : 1;
+}
@@ -0,0 +1,304 @@
+#include <zebra.h>
+
+#include "prefix.h"
+#include "table.h"
+#include "stream.h"
+#include "buffer.h"
+#include "linklist.h"
+#include "thread.h"
+#include "memory.h"
+
+#include "zebra/rib.h"
+#include "zebra/zserv.h"
+#include "zebra/redistribute.h"
+#include "zebra/debug.h"
+#include "zebra/router-id.h"
+
+/* Order of the messages zebra's redistribution queue sends to a client.
+ * Route changes are queued from redistribute_add/delete and drained by
+ * the queue thread; the stubs below stand in for the rest of zebra and
+ * record the (command, route type) of every message written out.  The
+ * node locks of the queue table are checked after every drain.
+ */
+
+struct thread_master *master;
+struct zebra_t zebrad;
+unsigned long zebra_debug_event = 0;
+
+#define SENT_MAX 16
+
+static struct
+{
+  int cmd;
+  int type;
+} sent[SENT_MAX];
+static int sent_num;
+
+struct route_table *
+vrf_table (afi_t afi, safi_t safi, u_int32_t id)
+{
+  return NULL;
+}
+
+int
+zserv_encode_route_multipath (int cmd, struct stream *s, struct prefix *p,
+                              struct rib *rib)
+{
+  stream_reset (s);
+  stream_putc (s, cmd);
+  stream_putc (s, rib->type);
+  return stream_get_endp (s);
+}
+
+int
+zebra_server_send_stream (struct zserv *client, struct stream *s)
+{
+  size_t i;
+
+  for (i = 0; i + 2 <= stream_get_endp (s) && sent_num < SENT_MAX; i += 2)
+    {
+      sent[sent_num].cmd = stream_getc_from (s, i);
+      sent[sent_num].type = stream_getc_from (s, i + 1);
+      sent_num++;
+    }
+  return 0;
+}
+
+int
+zsend_route_multipath (int cmd, struct zserv *client, struct prefix *p,
+                       struct rib *rib)
+{
+  zserv_encode_route_multipath (cmd, client->obuf, p, rib);
+  return zebra_server_send_stream (client, client->obuf);
+}
+
+int
+zsend_interface_add (struct zserv *client, struct interface *ifp)
+{
+  return 0;
+}
+
+int
+zsend_interface_delete (struct zserv *client, struct interface *ifp)
+{
+  return 0;
+}
+
+int
+zsend_interface_address (int cmd, struct zserv *client,
+                         struct interface *ifp, struct connected *ifc)
+{
+  return 0;
+}
+
+int
+zsend_interface_update (int cmd, struct zserv *client, struct interface *ifp)
+{
+  return 0;
+}
+
+void
+router_id_add_address (struct connected *ifc)
+{
+}
+
+void
+router_id_del_address (struct connected *ifc)
+{
+}
+
+static struct zserv client;
+static int failed;
+
+/* Every node of the queue table must be locked once by the walk and
+   once more if it holds entries; once drained, no node may be left. */
+static void
+test_check_locks (const char *name)
+{
+  struct route_node *rn;
+  char buf[BUFSIZ];
+  int nodes = 0;
+
+  if (! client.redist_queue[AFI_IP])
+    return;
+
+  for (rn = route_top (client.redist_queue[AFI_IP]); rn; rn = route_next (rn))
+    {
+      nodes++;
+      if (rn->lock != 1 + (rn->info != NULL))
+	{
+	  printf ("%s: %s/%d locked %d times\n", name,
+		  inet_ntop (AF_INET, &rn->p.u.prefix, buf, sizeof (buf)),
+		  rn->p.prefixlen, rn->lock - 1);
+	  failed++;
+	}
+    }
+
+  if (nodes && ! client.redist_depth)
+    {
+      printf ("%s: %d nodes left in an empty queue\n", name, nodes);
+      failed++;
+    }
+}
+
+/* Run the queue thread until it has nothing left to send. */
+static void
+test_drain (void)
+{
+  struct thread thread;
+
+  sent_num = 0;
+  while (client.t_redist && thread_fetch (zebrad.master, &thread))
+    thread_call (&thread);
+  test_check_locks ("drain");
+}
+
+static void
+test_prefix (struct prefix_ipv4 *p, u_int32_t addr, int len)
+{
+  memset (p, 0, sizeof (struct prefix_ipv4));
+  p->family = AF_INET;
+  p->prefixlen = len;
+  p->prefix.s_addr = htonl (addr);
+}
+
+static void
+test_subscribe (int type)
+{
+  stream_reset (client.ibuf);
+  stream_putc (client.ibuf, type);
+  zebra_redistribute_add (ZEBRA_REDISTRIBUTE_ADD, &client, 1);
+}
+
+static void
+test_unsubscribe (int type)
+{
+  stream_reset (client.ibuf);
+  stream_putc (client.ibuf, type);
+  zebra_redistribute_delete (ZEBRA_REDISTRIBUTE_DELETE, &client, 1);
+}
+
+static void
+test_expect (const char *name, int num, ...)
+{
+  va_list ap;
+  int i, cmd, type;
+  int ok = (sent_num == num);
+
+  va_start (ap, num);
+  for (i = 0; i < num; i++)
+    {
+      cmd = va_arg (ap, int);
+      type = va_arg (ap, int);
+      if (i < sent_num && (sent[i].cmd != cmd || sent[i].type != type))
+	ok = 0;
+    }
+  va_end (ap);
+
+  printf ("%s: %s\n", name, ok ? "OK" : "failed");
+  if (! ok)
+    {
+      failed++;
+      for (i = 0; i < sent_num; i++)
+	printf ("  sent %d: cmd %d type %d\n", i, sent[i].cmd, sent[i].type);
+    }
+}
+
+int
+main (void)
+{
+  struct prefix_ipv4 p, def;
+  struct prefix_ipv4 nested[4];
+  struct rib static_rib, ospf_rib;
+  int i, round;
+
+  master = zebrad.master = thread_master_create ();
+  zebrad.client_list = list_new ();
+
+  client.ibuf = stream_new (ZEBRA_MAX_PACKET_SIZ);
+  client.obuf = stream_new (ZEBRA_MAX_PACKET_SIZ);
+  client.wb = buffer_new (0);
+  listnode_add (zebrad.client_list, &client);
+
+  test_prefix (&p, 0x0a000000, 24);
+  test_prefix (&def, 0, 0);
+
+  /* Overlapping prefixes, with a branch node above 10.1/16 and 10.2/16
+     that never holds entries. */
+  test_prefix (&nested[0], 0x0a010000, 16);
+  test_prefix (&nested[1], 0x0a020000, 16);
+  test_prefix (&nested[2], 0x0a010100, 24);
+  test_prefix (&nested[3], 0x0a000000, 8);
+
+  memset (&static_rib, 0, sizeof (static_rib));
+  static_rib.type = ZEBRA_ROUTE_STATIC;
+  static_rib.distance = 1;
+  memset (&ospf_rib, 0, sizeof (ospf_rib));
+  ospf_rib.type = ZEBRA_ROUTE_OSPF;
+  ospf_rib.distance = 110;
+
+  test_subscribe (ZEBRA_ROUTE_STATIC);
+  test_subscribe (ZEBRA_ROUTE_OSPF);
+
+  /* The selected route changes type: the old type's DELETE is queued
+     first and must also be sent first. */
+  redistribute_delete ((struct prefix *) &p, &static_rib);
+  redistribute_add ((struct prefix *) &p, &ospf_rib);
+  test_drain ();
+  test_expect ("delete then add", 2,
+	       ZEBRA_IPV4_ROUTE_DELETE, ZEBRA_ROUTE_STATIC,
+	       ZEBRA_IPV4_ROUTE_ADD, ZEBRA_ROUTE_OSPF);
+
+  /* Coalesced messages move behind those queued before them. */
+  redistribute_delete ((struct prefix *) &p, &static_rib);
+  redistribute_add ((struct prefix *) &p, &ospf_rib);
+  redistribute_delete ((struct prefix *) &p, &ospf_rib);
+  redistribute_add ((struct prefix *) &p, &static_rib);
+  test_drain ();
+  test_expect ("coalesced flap", 2,
+	       ZEBRA_IPV4_ROUTE_DELETE, ZEBRA_ROUTE_OSPF,
+	       ZEBRA_IPV4_ROUTE_ADD, ZEBRA_ROUTE_STATIC);
+
+  /* Nothing is sent for a type the client stopped redistributing. */
+  redistribute_add ((struct prefix *) &p, &static_rib);
+  redistribute_add ((struct prefix *) &p, &ospf_rib);
+  test_unsubscribe (ZEBRA_ROUTE_STATIC);
+  test_drain ();
+  test_expect ("unsubscribed type", 1,
+	       ZEBRA_IPV4_ROUTE_ADD, ZEBRA_ROUTE_OSPF);
+
+  /* Nor for the default route once default redistribution is off. */
+  zebra_redistribute_default_add (ZEBRA_REDISTRIBUTE_DEFAULT_ADD, &client, 0);
+  redistribute_add ((struct prefix *) &def, &static_rib);
+  redistribute_add ((struct prefix *) &def, &ospf_rib);
+  zebra_redistribute_default_delete (ZEBRA_REDISTRIBUTE_DEFAULT_DELETE,
+				     &client, 0);
+  test_drain ();
+  test_expect ("unsubscribed default", 1,
+	       ZEBRA_IPV4_ROUTE_ADD, ZEBRA_ROUTE_OSPF);
+
+  /* Several overlapping prefixes, drained more than once: nodes
+     without entries must keep their lock counts. */
+  for (round = 0; round < 3; round++)
+    {
+      for (i = 0; i < 4; i++)
+	redistribute_add ((struct prefix *) &nested[i], &ospf_rib);
+      test_check_locks ("nested queued");
+      test_drain ();
+      test_expect ("nested prefixes", 4,
+		   ZEBRA_IPV4_ROUTE_ADD, ZEBRA_ROUTE_OSPF,
+		   ZEBRA_IPV4_ROUTE_ADD, ZEBRA_ROUTE_OSPF,
+		   ZEBRA_IPV4_ROUTE_ADD, ZEBRA_ROUTE_OSPF,
+		   ZEBRA_IPV4_ROUTE_ADD, ZEBRA_ROUTE_OSPF);
+    }
+
+  if (client.redist_depth)
+    {
+      printf ("queue depth %lu after drain\n", client.redist_depth);
+      failed++;
+    }
+  zebra_redistribute_queue_free (&client);
+
+  printf ("%s\n", failed ? "failed" : "OK");
+  return failed;
+}
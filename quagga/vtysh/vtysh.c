@@ -26,6 +26,7 @@
 #include <sys/wait.h>
 #include <sys/resource.h>
 #include <sys/stat.h>
+#include <poll.h>
 
 #include <readline/readline.h>
 #include <readline/history.h>
@@ -83,170 +84,200 @@ vclient_close (struct vtysh_client *vclient)
     }
 }
 
-/* Following filled with debug code to trace a problematic condition
- * under load - it SHOULD handle it. */
-#define ERR_WHERE_STRING "vtysh(): vtysh_client_config(): "
-static int
-vtysh_client_config (struct vtysh_client *vclient, char *line)
+/* Reply of one daemon to a command sent to several at once. */
+struct vtysh_reply
 {
-  int ret;
+  struct vtysh_client *vclient;
+
+  /* Received and not yet shown. */
   char *buf;
-  size_t bufsz;
-  char *pbuf;
-  size_t left;
-  char *eoln;
+  size_t length;
+  size_t size;
+
+  /* Bytes received in all. */
+  size_t total;
+
+  /* The title has been printed. */
+  int titled;
+
+  /* Result of the command, -1 until it is in. */
+  int ret;
+
+  struct timeval start;
+  struct timeval end;
+};
+
+/* Each read asks for at least this much. */
+#define VTYSH_READ_SIZE (64 * 1024)
+
+/* Print the time each daemon took on a command. */
+static int vtysh_debug_fanout = 0;
+
+static void
+vtysh_reply_read (struct vtysh_reply *reply)
+{
   int nbytes;
-  int i;
-  int readln;
 
-  if (vclient->fd < 0)
-    return CMD_SUCCESS;
+  while (reply->size - reply->length < VTYSH_READ_SIZE)
+    {
+      reply->size *= 2;
+      reply->buf = XREALLOC (MTYPE_TMP, reply->buf, reply->size);
+    }
 
-  ret = write (vclient->fd, line, strlen (line) + 1);
-  if (ret <= 0)
+  nbytes = read (reply->vclient->fd, reply->buf + reply->length,
+		 reply->size - reply->length);
+  if (nbytes <= 0)
     {
-      vclient_close (vclient);
-      return CMD_SUCCESS;
+      if (nbytes < 0 && (errno == EINTR || errno == EAGAIN))
+	return;
+      vclient_close (reply->vclient);
+      reply->ret = CMD_SUCCESS;
+      gettimeofday (&reply->end, NULL);
+      return;
     }
-	
-  /* Allow enough room for buffer to read more than a few pages from socket. */
-  bufsz = 5 * getpagesize() + 1;
-  buf = XMALLOC(MTYPE_TMP, bufsz);
-  memset(buf, 0, bufsz);
-  pbuf = buf;
-
-  while (1)
+  reply->length += nbytes;
+  reply->total += nbytes;
+
+  /* The daemon ends its output with \0\0\0<ret code>, see
+     lib/vty.c::vtysh_read. */
+  if (reply->length >= 4
+      && reply->buf[reply->length - 4] == '\0'
+      && reply->buf[reply->length - 3] == '\0'
+      && reply->buf[reply->length - 2] == '\0')
     {
-      if (pbuf >= ((buf + bufsz) -1))
-	{
-	  fprintf (stderr, ERR_WHERE_STRING \
-		   "warning - pbuf beyond buffer end.\n");
-	  return CMD_WARNING;
-	}
+      reply->ret = reply->buf[reply->length - 1];
+      reply->length -= 4;
+      gettimeofday (&reply->end, NULL);
+    }
+}
 
-      readln = (buf + bufsz) - pbuf - 1;
-      nbytes = read (vclient->fd, pbuf, readln);
+/* Write out what has come in of a reply.  The last three bytes wait
+   until the reply is complete, they may be the start of its end. */
+static void
+vtysh_reply_show (struct vtysh_reply *reply, FILE *fp)
+{
+  size_t length = reply->length;
 
-      if (nbytes <= 0)
-	{
+  if (reply->ret < 0)
+    length = (length > 3) ? length - 3 : 0;
+  if (length == 0)
+    return;
 
-	  if (errno == EINTR)
-	    continue;
+  fwrite (reply->buf, 1, length, fp);
+  fflush (fp);
+  reply->length -= length;
+  memmove (reply->buf, reply->buf + length, reply->length);
+}
 
-	  fprintf(stderr, ERR_WHERE_STRING "(%u)", errno);
-	  perror("");
+/* Send line to the connected daemons in flags all at once and wait for
+   their replies with poll.  The replies are written to fp in the order
+   of vtysh_client[]: the first daemon still working is shown as its
+   output comes in, the others are held until it is done.  With fp NULL
+   the replies are parsed as configuration instead.  title, if given,
+   is printed with the name of each daemon before its output.  Returns
+   the first result which is not CMD_SUCCESS, in the same order. */
+static int
+vtysh_client_fanout (int flags, const char *line, FILE *fp,
+		     const char *title)
+{
+  struct vtysh_reply reply[VTYSH_INDEX_MAX];
+  struct pollfd fds[VTYSH_INDEX_MAX];
+  u_int map[VTYSH_INDEX_MAX];
+  u_int i, n, nfds, head;
+  int ret = CMD_SUCCESS;
 
-	  if (errno == EAGAIN || errno == EIO)
-	    continue;
+  for (i = n = 0; i < VTYSH_INDEX_MAX; i++)
+    {
+      struct vtysh_client *vclient = &vtysh_client[i];
 
+      if (! (vclient->flag & flags) || vclient->fd < 0)
+	continue;
+      if (write (vclient->fd, line, strlen (line) + 1) <= 0)
+	{
 	  vclient_close (vclient);
-	  XFREE(MTYPE_TMP, buf);
-	  return CMD_SUCCESS;
+	  continue;
 	}
+      memset (&reply[n], 0, sizeof (struct vtysh_reply));
+      reply[n].vclient = vclient;
+      reply[n].size = VTYSH_READ_SIZE;
+      reply[n].buf = XMALLOC (MTYPE_TMP, reply[n].size);
+      reply[n].ret = -1;
+      gettimeofday (&reply[n].start, NULL);
+      n++;
+    }
 
-      pbuf[nbytes] = '\0';
+  head = 0;
+  while (head < n)
+    {
+      for (i = head, nfds = 0; i < n; i++)
+	if (reply[i].ret < 0)
+	  {
+	    fds[nfds].fd = reply[i].vclient->fd;
+	    fds[nfds].events = POLLIN;
+	    fds[nfds].revents = 0;
+	    map[nfds++] = i;
+	  }
 
-      if (nbytes >= 4)
+      if (nfds && poll (fds, nfds, -1) < 0)
 	{
-	  i = nbytes - 4;
-	  if (pbuf[i] == '\0' && pbuf[i + 1] == '\0' && pbuf[i + 2] == '\0')
+	  if (errno == EINTR)
+	    continue;
+	  perror ("poll");
+	  for (i = 0; i < nfds; i++)
 	    {
-	      ret = pbuf[i + 3];
-	      break;
+	      vclient_close (reply[map[i]].vclient);
+	      reply[map[i]].ret = CMD_SUCCESS;
 	    }
 	}
-      pbuf += nbytes;
-
-      /* See if a line exists in buffer, if so parse and consume it, and
-       * reset read position. */
-      if ((eoln = strrchr(buf, '\n')) == NULL)
-	continue;
+      for (i = 0; i < nfds; i++)
+	if (fds[i].revents)
+	  vtysh_reply_read (&reply[map[i]]);
 
-      if (eoln >= ((buf + bufsz) - 1))
+      /* Show the replies which are next in order. */
+      for (; head < n; head++)
 	{
-	  fprintf (stderr, ERR_WHERE_STRING \
-		   "warning - eoln beyond buffer end.\n");
-	}
-      vtysh_config_parse(buf);
-
-      eoln++;
-      left = (size_t)(buf + bufsz - eoln);
-      memmove(buf, eoln, left);
-      buf[bufsz-1] = '\0';
-      pbuf = buf + strlen(buf);
-    }
+	  struct vtysh_reply *r = &reply[head];
 
-  /* Parse anything left in the buffer. */
+	  if (fp)
+	    {
+	      if (title && ! r->titled)
+		{
+		  fprintf (fp, title, r->vclient->name);
+		  r->titled = 1;
+		}
+	      vtysh_reply_show (r, fp);
+	    }
+	  if (r->ret < 0)
+	    break;
 
-  vtysh_config_parse (buf);
+	  if (! fp)
+	    {
+	      if (r->length == r->size)
+		r->buf = XREALLOC (MTYPE_TMP, r->buf, r->size + 1);
+	      r->buf[r->length] = '\0';
+	      vtysh_config_parse (r->buf);
+	    }
+	  else if (title)
+	    fprintf (fp, "\n");
+
+	  if (vtysh_debug_fanout)
+	    fprintf (stderr, "%% %s: %lu bytes in %.3f ms\n", r->vclient->name,
+		     (unsigned long) r->total,
+		     (r->end.tv_sec - r->start.tv_sec) * 1000.0
+		     + (r->end.tv_usec - r->start.tv_usec) / 1000.0);
+	  if (ret == CMD_SUCCESS)
+	    ret = r->ret;
+	  XFREE (MTYPE_TMP, r->buf);
+	}
+    }
 
-  XFREE(MTYPE_TMP, buf);
   return ret;
 }
 
 static int
 vtysh_client_execute (struct vtysh_client *vclient, const char *line, FILE *fp)
 {
-  int ret;
-  char buf[1001];
-  int nbytes;
-  int i; 
-  int numnulls = 0;
-
-  if (vclient->fd < 0)
-    return CMD_SUCCESS;
-
-  ret = write (vclient->fd, line, strlen (line) + 1);
-  if (ret <= 0)
-    {
-      vclient_close (vclient);
-      return CMD_SUCCESS;
-    }
-	
-  while (1)
-    {
-      nbytes = read (vclient->fd, buf, sizeof(buf)-1);
-
-      if (nbytes <= 0 && errno != EINTR)
-	{
-	  vclient_close (vclient);
-	  return CMD_SUCCESS;
-	}
-
-      if (nbytes > 0)
-	{
-	  if ((numnulls == 3) && (nbytes == 1))
-	    return buf[0];
-
-	  buf[nbytes] = '\0';
-	  fputs (buf, fp);
-	  fflush (fp);
-	  
-	  /* check for trailling \0\0\0<ret code>, 
-	   * even if split across reads 
-	   * (see lib/vty.c::vtysh_read)
-	   */
-          if (nbytes >= 4) 
-            {
-              i = nbytes-4;
-              numnulls = 0;
-            }
-          else
-            i = 0;
-          
-          while (i < nbytes && numnulls < 3)
-            {
-              if (buf[i++] == '\0')
-                numnulls++;
-              else
-                numnulls = 0;
-            }
-
-          /* got 3 or more trailing NULs? */
-          if ((numnulls >= 3) && (i < nbytes))
-            return (buf[nbytes-1]);
-	}
-    }
+  return vtysh_client_fanout (vclient->flag, line, fp, NULL);
 }
 
 void
@@ -409,16 +440,22 @@ vtysh_execute_func (const char *line, int pager)
 		}
 	  }
 
+	/* Outside the configuration the daemons are independent and get
+	   the command all at once.  A configuration command is not sent
+	   on once a daemon refused it. */
 	cmd_stat = CMD_SUCCESS;
-	for (i = 0; i < VTYSH_INDEX_MAX; i++)
-	  {
-	    if (cmd->daemon & vtysh_client[i].flag)
-	      {
-	        cmd_stat = vtysh_client_execute(&vtysh_client[i], line, fp);
-		if (cmd_stat != CMD_SUCCESS)
-		  break;
-	      }
-	  }
+	if (vty->node < CONFIG_NODE)
+	  cmd_stat = vtysh_client_fanout (cmd->daemon, line, fp, NULL);
+	else
+	  for (i = 0; i < VTYSH_INDEX_MAX; i++)
+	    {
+	      if (cmd->daemon & vtysh_client[i].flag)
+		{
+		  cmd_stat = vtysh_client_execute(&vtysh_client[i], line, fp);
+		  if (cmd_stat != CMD_SUCCESS)
+		    break;
+		}
+	    }
 	if (cmd_stat != CMD_SUCCESS)
 	  break;
 
@@ -1318,20 +1355,10 @@ DEFUN (vtysh_show_memory,
        SHOW_STR
        "Memory statistics\n")
 {
-  unsigned int i;
-  int ret = CMD_SUCCESS;
   char line[] = "show memory\n";
   
-  for (i = 0; i < VTYSH_INDEX_MAX; i++)
-    if ( vtysh_client[i].fd >= 0 )
-      {
-        fprintf (stdout, "Memory statistics for %s:\n", 
-                 vtysh_client[i].name);
-        ret = vtysh_client_execute (&vtysh_client[i], line, stdout);
-        fprintf (stdout,"\n");
-      }
-  
-  return ret;
+  return vtysh_client_fanout (VTYSH_ALL, line, stdout,
+			      "Memory statistics for %s:\n");
 }
 
 /* Logging commands. */
@@ -1341,20 +1368,33 @@ DEFUN (vtysh_show_logging,
        SHOW_STR
        "Show current logging configuration\n")
 {
-  unsigned int i;
-  int ret = CMD_SUCCESS;
   char line[] = "show logging\n";
   
-  for (i = 0; i < VTYSH_INDEX_MAX; i++)
-    if ( vtysh_client[i].fd >= 0 )
-      {
-        fprintf (stdout,"Logging configuration for %s:\n", 
-                 vtysh_client[i].name);
-        ret = vtysh_client_execute (&vtysh_client[i], line, stdout);
-        fprintf (stdout,"\n");
-      }
-  
-  return ret;
+  return vtysh_client_fanout (VTYSH_ALL, line, stdout,
+			      "Logging configuration for %s:\n");
+}
+
+DEFUN (debug_vtysh_fanout,
+       debug_vtysh_fanout_cmd,
+       "debug vtysh fanout",
+       DEBUG_STR
+       "Virtual terminal shell\n"
+       "Time of each daemon on commands sent to several\n")
+{
+  vtysh_debug_fanout = 1;
+  return CMD_SUCCESS;
+}
+
+DEFUN (no_debug_vtysh_fanout,
+       no_debug_vtysh_fanout_cmd,
+       "no debug vtysh fanout",
+       NO_STR
+       DEBUG_STR
+       "Virtual terminal shell\n"
+       "Time of each daemon on commands sent to several\n")
+{
+  vtysh_debug_fanout = 0;
+  return CMD_SUCCESS;
 }
 
 DEFUNSH (VTYSH_ALL,
@@ -1595,6 +1635,78 @@ DEFUNSH (VTYSH_ALL,
   return CMD_SUCCESS;
 }
 
+DEFUNSH (VTYSH_ALL,
+	 vtysh_log_async,
+	 vtysh_log_async_cmd,
+	 "log async",
+	 "Logging control\n"
+	 "Queue file and stdout logging and write it in batches\n")
+{
+  return CMD_SUCCESS;
+}
+
+DEFUNSH (VTYSH_ALL,
+	 vtysh_log_async_size,
+	 vtysh_log_async_size_cmd,
+	 "log async <4096-16777216>",
+	 "Logging control\n"
+	 "Queue file and stdout logging and write it in batches\n"
+	 "Buffer size per destination in bytes\n")
+{
+  return CMD_SUCCESS;
+}
+
+DEFUNSH (VTYSH_ALL,
+	 no_vtysh_log_async,
+	 no_vtysh_log_async_cmd,
+	 "no log async",
+	 NO_STR
+	 "Logging control\n"
+	 "Write file and stdout logging as it is logged\n")
+{
+  return CMD_SUCCESS;
+}
+
+ALIAS_SH (VTYSH_ALL,
+	  no_vtysh_log_async,
+	  no_vtysh_log_async_size_cmd,
+	  "no log async <4096-16777216>",
+	  NO_STR
+	  "Logging control\n"
+	  "Write file and stdout logging as it is logged\n"
+	  "Buffer size per destination in bytes\n")
+
+DEFUNSH (VTYSH_ALL,
+	 vtysh_thread_slow_warning,
+	 vtysh_thread_slow_warning_cmd,
+	 "thread slow-warning <1-3600000>",
+	 "Thread scheduler\n"
+	 "Warn of callbacks and commands running longer than this\n"
+	 "Milliseconds\n")
+{
+  return CMD_SUCCESS;
+}
+
+DEFUNSH (VTYSH_ALL,
+	 no_vtysh_thread_slow_warning,
+	 no_vtysh_thread_slow_warning_cmd,
+	 "no thread slow-warning",
+	 NO_STR
+	 "Thread scheduler\n"
+	 "Warn of callbacks and commands running longer than this\n")
+{
+  return CMD_SUCCESS;
+}
+
+ALIAS_SH (VTYSH_ALL,
+	  no_vtysh_thread_slow_warning,
+	  no_vtysh_thread_slow_warning_val_cmd,
+	  "no thread slow-warning <1-3600000>",
+	  NO_STR
+	  "Thread scheduler\n"
+	  "Warn of callbacks and commands running longer than this\n"
+	  "Milliseconds\n")
+
 DEFUNSH (VTYSH_ALL,
 	 vtysh_service_password_encrypt,
 	 vtysh_service_password_encrypt_cmd,
@@ -1679,8 +1791,6 @@ DEFUN (vtysh_write_terminal,
        "Write running configuration to memory, network, or terminal\n"
        "Write to terminal\n")
 {
-  u_int i;
-  int ret;
   char line[] = "write terminal\n";
   FILE *fp = NULL;
 
@@ -1701,8 +1811,7 @@ DEFUN (vtysh_write_terminal,
 	   VTY_NEWLINE);
   vty_out (vty, "!%s", VTY_NEWLINE);
 
-  for (i = 0; i < VTYSH_INDEX_MAX; i++)
-    ret = vtysh_client_config (&vtysh_client[i], line);
+  vtysh_client_fanout (VTYSH_ALL, line, NULL, NULL);
 
   /* Integrate vtysh specific configuration. */
   vtysh_config_write ();
@@ -1749,8 +1858,6 @@ DEFUN (no_vtysh_integrated_config,
 static int
 write_config_integrated(void)
 {
-  u_int i;
-  int ret;
   char line[] = "write terminal\n";
   FILE *fp;
   char *integrate_sav = NULL;
@@ -1775,8 +1882,7 @@ write_config_integrated(void)
       return CMD_SUCCESS;
     }
 
-  for (i = 0; i < VTYSH_INDEX_MAX; i++)
-    ret = vtysh_client_config (&vtysh_client[i], line);
+  vtysh_client_fanout (VTYSH_ALL, line, NULL, NULL);
 
   vtysh_config_dump (fp);
 
@@ -1802,9 +1908,8 @@ DEFUN (vtysh_write_memory,
        "Write running configuration to memory, network, or terminal\n"
        "Write configuration to the file (same as write file)\n")
 {
-  int ret = CMD_SUCCESS;
+  int ret;
   char line[] = "write memory\n";
-  u_int i;
   
   /* If integrated Quagga.conf explicitely set. */
   if (vtysh_writeconfig_integrated)
@@ -1812,8 +1917,7 @@ DEFUN (vtysh_write_memory,
 
   fprintf (stdout,"Building Configuration...\n");
 	  
-  for (i = 0; i < VTYSH_INDEX_MAX; i++)
-    ret = vtysh_client_execute (&vtysh_client[i], line, stdout);
+  ret = vtysh_client_fanout (VTYSH_ALL, line, stdout, NULL);
   
   fprintf (stdout,"[OK]\n");
 
@@ -2415,6 +2519,10 @@ vtysh_init_vty (void)
   /* Logging */
   install_element (ENABLE_NODE, &vtysh_show_logging_cmd);
   install_element (VIEW_NODE, &vtysh_show_logging_cmd);
+  install_element (VIEW_NODE, &debug_vtysh_fanout_cmd);
+  install_element (ENABLE_NODE, &debug_vtysh_fanout_cmd);
+  install_element (VIEW_NODE, &no_debug_vtysh_fanout_cmd);
+  install_element (ENABLE_NODE, &no_debug_vtysh_fanout_cmd);
   install_element (CONFIG_NODE, &vtysh_log_stdout_cmd);
   install_element (CONFIG_NODE, &vtysh_log_stdout_level_cmd);
   install_element (CONFIG_NODE, &no_vtysh_log_stdout_cmd);
@@ -2436,6 +2544,13 @@ vtysh_init_vty (void)
   install_element (CONFIG_NODE, &no_vtysh_log_record_priority_cmd);
   install_element (CONFIG_NODE, &vtysh_log_timestamp_precision_cmd);
   install_element (CONFIG_NODE, &no_vtysh_log_timestamp_precision_cmd);
+  install_element (CONFIG_NODE, &vtysh_log_async_cmd);
+  install_element (CONFIG_NODE, &vtysh_log_async_size_cmd);
+  install_element (CONFIG_NODE, &no_vtysh_log_async_cmd);
+  install_element (CONFIG_NODE, &no_vtysh_log_async_size_cmd);
+  install_element (CONFIG_NODE, &vtysh_thread_slow_warning_cmd);
+  install_element (CONFIG_NODE, &no_vtysh_thread_slow_warning_cmd);
+  install_element (CONFIG_NODE, &no_vtysh_thread_slow_warning_val_cmd);
 
   install_element (CONFIG_NODE, &vtysh_service_password_encrypt_cmd);
   install_element (CONFIG_NODE, &no_vtysh_service_password_encrypt_cmd);
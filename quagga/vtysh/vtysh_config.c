@@ -248,6 +248,8 @@ vtysh_config_parse_line (const char *line)
 	{
 	  if (strncmp (line, "log", strlen ("log")) == 0
 	      || strncmp (line, "hostname", strlen ("hostname")) == 0
+	      || strncmp (line, "thread", strlen ("thread")) == 0
+	      || strncmp (line, "no thread", strlen ("no thread")) == 0
 	     )
 	    config_add_line_uniq (config_top, line);
 	  else
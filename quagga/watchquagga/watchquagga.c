@@ -122,6 +122,7 @@ static struct global_state
   long min_restart_interval;
   long max_restart_interval;
   int do_ping;
+  long health_check;	/* ms for show thread health, 0 to echo */
   struct daemon *daemons;
   const char *restart_command;
   const char *start_command;
@@ -172,6 +173,11 @@ struct daemon {
   daemon_state_t state;
   int fd;
   struct timeval echo_sent;
+  int health_sent;	/* the ping was show thread health */
+  int no_health;	/* daemon does not know show thread health */
+  int health_valid;
+  u_long health[4];	/* its counts at health_time */
+  struct timeval health_time;
   u_int connect_tries;
   struct thread *t_wakeup;
   struct thread *t_read;
@@ -185,6 +191,7 @@ static const struct option longopts[] =
   { "daemon", no_argument, NULL, 'd'},
   { "statedir", required_argument, NULL, 'S'},
   { "no-echo", no_argument, NULL, 'e'},
+  { "latency-check", required_argument, NULL, 'L'},
   { "loglevel", required_argument, NULL, 'l'},
   { "interval", required_argument, NULL, 'i'},
   { "timeout", required_argument, NULL, 't'},
@@ -268,6 +275,12 @@ Options:\n\
 -e, --no-echo	Do not ping the daemons to test responsiveness (this\n\
 		option is necessary if the daemons do not support the\n\
 		echo command)\n\
+-L, --latency-check\n\
+		Ping the daemons with show thread health instead of echo,\n\
+		and warn when since the last ping callbacks ran, timers or\n\
+		events waited, or event loop periods took at least the given\n\
+		milliseconds, rounded up to a power of two microseconds.\n\
+		Daemons without the command are pinged with echo.\n\
 -l, --loglevel	Set the logging level (default is %d).\n\
 		The value should range from %d (LOG_EMERG) to %d (LOG_DEBUG),\n\
 		but it can be set higher than %d if extra-verbose debugging\n\
@@ -582,6 +595,9 @@ daemon_down(struct daemon *dmn, const char *why)
   if (IS_UP(dmn))
     gs.numdown++;
   dmn->state = DAEMON_DOWN;
+  dmn->health_sent = 0;
+  dmn->no_health = 0;
+  dmn->health_valid = 0;
   if (dmn->fd >= 0)
     {
       close(dmn->fd);
@@ -595,12 +611,65 @@ daemon_down(struct daemon *dmn, const char *why)
   phase_check();
 }
 
+/* The answer to show thread health: "health <ms> calls <n> slow <n>
+   late <n> long <n>", counts since the daemon started, and the vtysh
+   trailer of three zeroes and the command status. */
+static int
+handle_health(struct daemon *dmn, char *buf, ssize_t rc)
+{
+  u_long h[4];
+  long msec;
+  struct timeval delay;
+  char why[300];
+
+  dmn->health_sent = 0;
+  if ((rc < 4) || buf[rc-4] || buf[rc-3] || buf[rc-2])
+    {
+      snprintf(why,sizeof(why),"read returned bad health response of %d "
+			       "bytes: %.*s",(int)rc,(int)rc,buf);
+      daemon_down(dmn,why);
+      return -1;
+    }
+  if (buf[rc-1])
+    {
+      zlog_notice("%s: no show thread health, pinging with echo instead",
+		  dmn->name);
+      dmn->no_health = 1;
+      return 0;
+    }
+
+  buf[rc-4] = '\0';
+  if (sscanf(buf,"health %ld calls %lu slow %lu late %lu long %lu",
+	     &msec,&h[0],&h[1],&h[2],&h[3]) != 5)
+    {
+      snprintf(why,sizeof(why),"read returned bad health response: %s",buf);
+      daemon_down(dmn,why);
+      return -1;
+    }
+
+  if (dmn->health_valid && (h[0] >= dmn->health[0]) &&
+      ((h[1] > dmn->health[1]) || (h[2] > dmn->health[2]) ||
+       (h[3] > dmn->health[3])))
+    {
+      time_elapsed(&delay,&dmn->health_time);
+      zlog_warn("%s: in the last %ld.%06ld seconds %lu callbacks ran, "
+		"%lu timers or events waited and %lu loop periods took "
+		"%ld ms or more",dmn->name,(long)delay.tv_sec,
+		(long)delay.tv_usec,h[1]-dmn->health[1],h[2]-dmn->health[2],
+		h[3]-dmn->health[3],msec);
+    }
+  memcpy(dmn->health,h,sizeof(dmn->health));
+  dmn->health_valid = 1;
+  gettimeofday(&dmn->health_time,NULL);
+  return 0;
+}
+
 static int
 handle_read(struct thread *t_read)
 {
   struct daemon *dmn = THREAD_ARG(t_read);
   static const char resp[sizeof(PING_TOKEN)+4] = PING_TOKEN "\n";
-  char buf[sizeof(resp)+100];
+  char buf[sizeof(resp)+200];
   ssize_t rc;
   struct timeval delay;
 
@@ -637,7 +706,12 @@ handle_read(struct thread *t_read)
   /* We are expecting an echo response: is there any chance that the
      response would not be returned entirely in the first read?  That
      seems inconceivable... */
-  if ((rc != sizeof(resp)) || memcmp(buf,resp,sizeof(resp)))
+  if (dmn->health_sent)
+    {
+      if (handle_health(dmn,buf,rc) < 0)
+	return 0;
+    }
+  else if ((rc != sizeof(resp)) || memcmp(buf,resp,sizeof(resp)))
     {
       char why[100+sizeof(buf)];
       snprintf(why,sizeof(why),"read returned bad echo response of %d bytes "
@@ -967,20 +1041,30 @@ static int
 wakeup_send_echo(struct thread *t_wakeup)
 {
   static const char echocmd[] = "echo " PING_TOKEN;
+  char healthcmd[40];
+  const char *cmd = echocmd;
+  size_t len = sizeof(echocmd);
   ssize_t rc;
   struct daemon *dmn = THREAD_ARG(t_wakeup);
 
   dmn->t_wakeup = NULL;
-  if (((rc = write(dmn->fd,echocmd,sizeof(echocmd))) < 0) ||
-      ((size_t)rc != sizeof(echocmd)))
+  if (gs.health_check && !dmn->no_health)
+    {
+      snprintf(healthcmd,sizeof(healthcmd),"show thread health %ld",
+	       gs.health_check);
+      cmd = healthcmd;
+      len = strlen(healthcmd)+1;
+    }
+  if (((rc = write(dmn->fd,cmd,len)) < 0) || ((size_t)rc != len))
     {
-      char why[100+sizeof(echocmd)];
+      char why[100+sizeof(healthcmd)];
       snprintf(why,sizeof(why),"write '%s' returned %d instead of %u",
-               echocmd,(int)rc,(u_int)sizeof(echocmd));
+               cmd,(int)rc,(u_int)len);
       daemon_down(dmn,why);
     }
   else
     {
+      dmn->health_sent = (cmd == healthcmd);
       gettimeofday(&dmn->echo_sent,NULL);
       dmn->t_wakeup = thread_add_timer(master,wakeup_no_answer,dmn,gs.timeout);
     }
@@ -1056,7 +1140,7 @@ main(int argc, char **argv)
     progname = argv[0];
 
   gs.restart.name = "all";
-  while ((opt = getopt_long(argc, argv, "aAb:dek:l:m:M:i:p:r:R:S:s:t:T:zvh",
+  while ((opt = getopt_long(argc, argv, "aAb:dek:l:L:m:M:i:p:r:R:S:s:t:T:zvh",
 			    longopts, 0)) != EOF)
     {
       switch (opt)
@@ -1196,6 +1280,17 @@ main(int argc, char **argv)
 	case 'S':
 	  gs.vtydir = optarg;
 	  break;
+	case 'L':
+	  {
+	    char garbage[3];
+	    if ((sscanf(optarg,"%ld%1s",&gs.health_check,garbage) != 1) ||
+	        (gs.health_check < 1) || (gs.health_check > 3600000))
+	      {
+	        fprintf(stderr,"Invalid latency check argument: %s\n",optarg);
+		return usage(progname,1);
+	      }
+	  }
+	  break;
 	case 't':
 	  {
 	    char garbage[3];
@@ -63,7 +63,7 @@ connected_withdraw (struct connected *ifc)
 
   if (!CHECK_FLAG (ifc->conf, ZEBRA_IFC_CONFIGURED))
     {
-      listnode_delete (ifc->ifp->connected, ifc);
+      connected_delete (ifc->ifp, ifc);
       connected_free (ifc);
     }
 }
@@ -74,7 +74,7 @@ connected_announce (struct interface *ifp, struct connected *ifc)
   if (!ifc)
     return;
   
-  listnode_add (ifp->connected, ifc);
+  connected_add (ifp, ifc);
 
   /* Update interface address information to protocol daemon. */
   if (! CHECK_FLAG (ifc->conf, ZEBRA_IFC_REAL))
@@ -159,6 +159,7 @@ connected_implicit_withdraw (struct interface *ifp, struct connected *ifc)
       if (connected_same (current, ifc) && CHECK_FLAG(current->conf, ZEBRA_IFC_REAL))
         {
           /* nothing to do */
+          UNSET_FLAG (current->conf, ZEBRA_IFC_STALE);
           connected_free (ifc);
           return NULL;
         }
@@ -169,6 +170,46 @@ connected_implicit_withdraw (struct interface *ifp, struct connected *ifc)
   return ifc;
 }
 
+/* Mark the kernel's addresses of the given family stale, or clear the
+   marks again.  Addresses the kernel reports afterwards lose the mark
+   in connected_implicit_withdraw(). */
+void
+connected_mark_stale (int family, int stale)
+{
+  struct listnode *node, *cnode;
+  struct interface *ifp;
+  struct connected *ifc;
+
+  for (ALL_LIST_ELEMENTS_RO (iflist, node, ifp))
+    for (ALL_LIST_ELEMENTS_RO (ifp->connected, cnode, ifc))
+      if (ifc->address->family == family)
+	{
+	  if (stale && CHECK_FLAG (ifc->conf, ZEBRA_IFC_REAL))
+	    SET_FLAG (ifc->conf, ZEBRA_IFC_STALE);
+	  else
+	    UNSET_FLAG (ifc->conf, ZEBRA_IFC_STALE);
+	}
+}
+
+/* Withdraw the addresses of the given family which are still marked
+   stale, the kernel no longer has them. */
+void
+connected_sweep_stale (int family)
+{
+  struct listnode *node, *cnode, *cnnode;
+  struct interface *ifp;
+  struct connected *ifc;
+
+  for (ALL_LIST_ELEMENTS_RO (iflist, node, ifp))
+    for (ALL_LIST_ELEMENTS (ifp->connected, cnode, cnnode, ifc))
+      if (ifc->address->family == family
+	  && CHECK_FLAG (ifc->conf, ZEBRA_IFC_STALE))
+	{
+	  UNSET_FLAG (ifc->conf, ZEBRA_IFC_STALE);
+	  connected_withdraw (ifc);
+	}
+}
+
 /* Called from if_up(). */
 void
 connected_up_ipv4 (struct interface *ifp, struct connected *ifc)
@@ -190,8 +231,6 @@ connected_up_ipv4 (struct interface *ifp, struct connected *ifc)
 
   rib_add_ipv4 (ZEBRA_ROUTE_CONNECT, 0, &p, NULL, NULL, ifp->ifindex,
 	RT_TABLE_MAIN, ifp->metric, 0);
-
-  rib_update ();
 }
 
 /* Add connected IPv4 route to the interface. */
@@ -296,8 +335,6 @@ connected_down_ipv4 (struct interface *ifp, struct connected *ifc)
 
   /* Same logic as for connected_up_ipv4(): push the changes into the head. */
   rib_delete_ipv4 (ZEBRA_ROUTE_CONNECT, 0, &p, NULL, ifp->ifindex, 0);
-
-  rib_update ();
 }
 
 /* Delete connected IPv4 route to the interface. */
@@ -342,8 +379,6 @@ connected_up_ipv6 (struct interface *ifp, struct connected *ifc)
 
   rib_add_ipv6 (ZEBRA_ROUTE_CONNECT, 0, &p, NULL, ifp->ifindex, 0,
                 ifp->metric, 0);
-
-  rib_update ();
 }
 
 /* Add connected IPv6 route to the interface. */
@@ -416,8 +451,6 @@ connected_down_ipv6 (struct interface *ifp, struct connected *ifc)
     return;
 
   rib_delete_ipv6 (ZEBRA_ROUTE_CONNECT, 0, &p, NULL, ifp->ifindex, 0);
-
-  rib_update ();
 }
 
 void
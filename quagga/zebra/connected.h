@@ -35,6 +35,9 @@ extern void
 connected_delete_ipv4 (struct interface *ifp, int flags, struct in_addr *addr,
 		       u_char prefixlen, struct in_addr *broad);
 
+extern void connected_mark_stale (int family, int stale);
+extern void connected_sweep_stale (int family);
+
 extern void connected_up_ipv4 (struct interface *, struct connected *);
 extern void connected_down_ipv4 (struct interface *, struct connected *);
 
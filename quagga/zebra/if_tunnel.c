@@ -236,7 +236,7 @@ do_mpls_tunnel (int cmd, struct interface *ifp)
   ifc->destination = (struct prefix *) p;
 
   /* Add to linked list. */
-  listnode_add (ifp->connected, ifc);
+  connected_add (ifp, ifc);
 
   SET_FLAG (ifc->conf, ZEBRA_IFC_CONFIGURED);
 
@@ -289,7 +289,7 @@ do_mpls_tunnel (int cmd, struct interface *ifp)
   connected_down_ipv4 (ifp, ifc);
 
   /* Free address information. */
-  listnode_delete (ifp->connected, ifc);
+  connected_delete (ifp, ifc);
   connected_free (ifc);
 
   mpls_ctrl_tunnel_unregister(ifp, 1);
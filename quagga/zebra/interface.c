@@ -442,7 +442,7 @@ if_delete_update (struct interface *ifp)
 		  /* Remove from interface address list (unconditionally). */
 		  if (!CHECK_FLAG (ifc->conf, ZEBRA_IFC_CONFIGURED))
 		    {
-		      listnode_delete (ifp->connected, ifc);
+		      connected_delete (ifp, ifc);
 		      connected_free (ifc);
                     }
                   else
@@ -467,7 +467,7 @@ if_delete_update (struct interface *ifp)
 		last = node;
 	      else
 		{
-		  listnode_delete (ifp->connected, ifc);
+		  connected_delete (ifp, ifc);
 		  connected_free (ifc);
 		}
 	    }
@@ -481,7 +481,7 @@ if_delete_update (struct interface *ifp)
      while processing the deletion.  Each client daemon is responsible
      for setting ifindex to IFINDEX_INTERNAL after processing the
      interface deletion message. */
-  ifp->ifindex = IFINDEX_INTERNAL;
+  if_set_index (ifp, IFINDEX_INTERNAL);
 }
 
 /* Interface is up. */
@@ -512,8 +512,8 @@ if_up (struct interface *ifp)
 	}
     }
 
-  /* Examine all static routes. */
-  rib_update ();
+  /* Examine routes through the interface. */
+  rib_update_if (ifp);
 }
 
 /* Interface goes down.  We have to manage different behavior of based
@@ -545,8 +545,8 @@ if_down (struct interface *ifp)
 	}
     }
 
-  /* Examine all static routes which direct to the interface. */
-  rib_update ();
+  /* Examine routes through the interface. */
+  rib_update_if (ifp);
 }
 
 void
@@ -1193,7 +1193,7 @@ ip_address_install (struct vty *vty, struct interface *ifp,
 	ifc->label = XSTRDUP (MTYPE_CONNECTED_LABEL, label);
 
       /* Add to linked list. */
-      listnode_add (ifp->connected, ifc);
+      connected_add (ifp, ifc);
     }
 
   /* This address is configured from zebra. */
@@ -1271,7 +1271,7 @@ ip_address_uninstall (struct vty *vty, struct interface *ifp,
   if (! CHECK_FLAG (ifc->conf, ZEBRA_IFC_REAL)
       || ! CHECK_FLAG (ifp->status, ZEBRA_INTERFACE_ACTIVE))
     {
-      listnode_delete (ifp->connected, ifc);
+      connected_delete (ifp, ifc);
       connected_free (ifc);
       return CMD_WARNING;
     }
@@ -1293,7 +1293,7 @@ ip_address_uninstall (struct vty *vty, struct interface *ifp,
   connected_down_ipv4 (ifp, ifc);
 
   /* Free address information. */
-  listnode_delete (ifp->connected, ifc);
+  connected_delete (ifp, ifc);
   connected_free (ifc);
 #endif
 
@@ -1386,7 +1386,7 @@ ipv6_address_install (struct vty *vty, struct interface *ifp,
 	ifc->label = XSTRDUP (MTYPE_CONNECTED_LABEL, label);
 
       /* Add to linked list. */
-      listnode_add (ifp->connected, ifc);
+      connected_add (ifp, ifc);
     }
 
   /* This address is configured from zebra. */
@@ -1460,7 +1460,7 @@ ipv6_address_uninstall (struct vty *vty, struct interface *ifp,
   if (! CHECK_FLAG (ifc->conf, ZEBRA_IFC_REAL)
       || ! CHECK_FLAG (ifp->status, ZEBRA_INTERFACE_ACTIVE))
     {
-      listnode_delete (ifp->connected, ifc);
+      connected_delete (ifp, ifc);
       connected_free (ifc);
       return CMD_WARNING;
     }
@@ -1481,7 +1481,7 @@ ipv6_address_uninstall (struct vty *vty, struct interface *ifp,
   connected_down_ipv6 (ifp, ifc);
 
   /* Free address information. */
-  listnode_delete (ifp->connected, ifc);
+  connected_delete (ifp, ifc);
   connected_free (ifc);
 
   return CMD_SUCCESS;
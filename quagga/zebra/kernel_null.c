@@ -37,4 +37,5 @@ int kernel_address_delete_ipv4 (struct interface *a, struct connected *b)
 }
 
 void kernel_init (void) { return; }
+void kernel_statistics (struct vty *vty) { return; }
 #pragma weak route_read = kernel_init
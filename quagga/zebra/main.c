@@ -39,6 +39,9 @@
 #include "zebra/router-id.h"
 #include "zebra/irdp.h"
 #include "zebra/rtadv.h"
+#ifdef HAVE_MPLS
+#include "zebra/mpls_lib.h"
+#endif /* HAVE_MPLS */
 
 /* Zebra instance */
 struct zebra_t zebrad =
@@ -320,6 +323,9 @@ main (int argc, char **argv)
   /* Zebra related initialize. */
   zebra_init ();
   rib_init ();
+#ifdef HAVE_MPLS
+  mpls_init ();
+#endif /* HAVE_MPLS */
   zebra_if_init ();
   zebra_debug_init ();
   router_id_init();
@@ -26,6 +26,7 @@
 #ifdef HAVE_MPLS
 
 #include "linklist.h"
+#include "hash.h"
 #include "memory.h"
 #include "if.h"
 #include "log.h"
@@ -139,6 +140,64 @@ int mpls_out_segment_cmp(void *val1, void *val2)
 
 static int mpls_out_segment_nextindex = 1;
 
+/* The lists keep registration order for show and config output, the
+   hashes below are what lookups go through. */
+static struct hash *mpls_out_segment_hash;	/* by index */
+static struct hash *mpls_out_key_hash;		/* by out_key, if installed */
+static struct hash *mpls_nhlfe_hash;		/* by owner and nexthop */
+
+static unsigned int
+mpls_out_segment_hash_key (void *p)
+{
+  return ((struct zmpls_out_segment *)p)->index;
+}
+
+static int
+mpls_out_segment_hash_cmp (void *a, void *b)
+{
+  return ((struct zmpls_out_segment *)a)->index ==
+    ((struct zmpls_out_segment *)b)->index;
+}
+
+static unsigned int
+mpls_out_key_hash_key (void *p)
+{
+  return ((struct zmpls_out_segment *)p)->out_key;
+}
+
+static int
+mpls_out_key_hash_cmp (void *a, void *b)
+{
+  return ((struct zmpls_out_segment *)a)->out_key ==
+    ((struct zmpls_out_segment *)b)->out_key;
+}
+
+/* Only fields zapi_nexthop_match() compares for ZEBRA_NEXTHOP_ALL go
+   into the key. */
+static unsigned int
+mpls_nhlfe_hash_key (void *p)
+{
+  struct zmpls_out_segment *out = p;
+  unsigned int key = (out->owner << 24) ^ out->nh.type;
+
+  if (CHECK_FLAG (out->nh.type, ZEBRA_NEXTHOP_MPLS)
+      && out->nh.mpls.type == ZEBRA_MPLS_LABEL_GEN)
+    key ^= out->nh.mpls.u.gen << 4;
+  if (CHECK_FLAG (out->nh.type, ZEBRA_NEXTHOP_IPV4))
+    key ^= out->nh.gw.ipv4.s_addr;
+  return key;
+}
+
+static int
+mpls_nhlfe_hash_cmp (void *a, void *b)
+{
+  struct zmpls_out_segment *v1 = a;
+  struct zmpls_out_segment *v2 = b;
+
+  return v1->owner == v2->owner &&
+    zapi_nexthop_match (&v1->nh, &v2->nh, ZEBRA_NEXTHOP_ALL);
+}
+
 struct list mpls_out_segment_list = {
   .head = NULL,
   .tail = NULL, 
@@ -150,64 +209,47 @@ struct list mpls_out_segment_list = {
 unsigned int
 mpls_out_segment_find_index_by_nexthop(struct zapi_nexthop *nh)
 {
-  struct listnode *node;
+  struct zmpls_out_segment lookup;
   struct zmpls_out_segment *old;
+  int owner;
 
-  for (ALL_LIST_ELEMENTS_RO(&mpls_out_segment_list,node,old))
-  {
-    if (zapi_nexthop_match(&old->nh, nh, ZEBRA_NEXTHOP_ALL))
-      goto found;
-  }
+  /* the nexthop index is per owner, try each of them */
+  memcpy (&lookup.nh, nh, sizeof (struct zapi_nexthop));
+  for (owner = 0; owner < ZEBRA_ROUTE_MAX; owner++)
+    {
+      lookup.owner = owner;
+      if ((old = hash_lookup (mpls_nhlfe_hash, &lookup)))
+	return old->index;
+    }
   return 0;
-found:
-  return old->index;
 }
 
 unsigned int
 mpls_out_segment_find_index_by_nhlfe(struct zmpls_out_segment *out)
 {
-  struct listnode *node;
   struct zmpls_out_segment *old;
 
-  for (ALL_LIST_ELEMENTS_RO(&mpls_out_segment_list,node,old))
-  {
-    if (old->owner == out->owner &&
-	zapi_nexthop_match(&old->nh, &out->nh, ZEBRA_NEXTHOP_ALL))
-      goto found;
-  }
+  if ((old = hash_lookup (mpls_nhlfe_hash, out)))
+    return old->index;
   return 0;
-found:
-  return old->index;
 }
 
 struct zmpls_out_segment*
 mpls_out_segment_find(unsigned int index)
 {
-  struct listnode *node;
-  struct zmpls_out_segment *old;
+  struct zmpls_out_segment lookup;
 
-  for (ALL_LIST_ELEMENTS_RO(&mpls_out_segment_list,node,old))
-    if (index == old->index)
-      goto found;
-
-  return NULL;
-found:
-  return old;
+  lookup.index = index;
+  return hash_lookup (mpls_out_segment_hash, &lookup);
 }
 
 struct zmpls_out_segment*
 mpls_out_segment_find_by_out_key(unsigned int key)
 {
-  struct listnode *node;
-  struct zmpls_out_segment *old;
-
-  for (ALL_LIST_ELEMENTS_RO(&mpls_out_segment_list,node,old))
-    if (key == old->out_key)
-      goto found;
+  struct zmpls_out_segment lookup;
 
-  return NULL;
-found:
-  return old;
+  lookup.out_key = key;
+  return hash_lookup (mpls_out_key_hash, &lookup);
 }
 
 static int
@@ -218,6 +260,10 @@ do_mpls_out_segment_unregister(struct zmpls_out_segment *old)
     ret = mpls_ctrl_nhlfe_unregister(old);
 
   redistribute_delete_mpls_out_segment (old);
+  hash_release (mpls_out_segment_hash, old);
+  hash_release (mpls_nhlfe_hash, old);
+  if (mpls_out_segment_find_by_out_key (old->out_key) == old)
+    hash_release (mpls_out_key_hash, old);
   LISTNODE_DETACH(&mpls_out_segment_list, &old->global);
   XFREE (MTYPE_TMP, old);
   return ret;
@@ -287,6 +333,10 @@ mpls_out_segment_register(struct zmpls_out_segment *out)
   }
 
   LISTNODE_ATTACH(&mpls_out_segment_list, &new->global);
+  hash_get (mpls_out_segment_hash, new, hash_alloc_intern);
+  hash_get (mpls_nhlfe_hash, new, hash_alloc_intern);
+  if (new->installed && ! mpls_out_segment_find_by_out_key (new->out_key))
+    hash_get (mpls_out_key_hash, new, hash_alloc_intern);
 
   if (new->installed)
     redistribute_add_mpls_out_segment (new);
@@ -304,6 +354,9 @@ struct list mpls_in_segment_list = {
   .del = NULL,
 };
 
+/* ILM, by labelspace and label. */
+static struct hash *mpls_in_segment_hash;
+
 int
 mpls_in_segment_match(struct zmpls_in_segment *a, struct zmpls_in_segment *b)
 {
@@ -314,17 +367,28 @@ mpls_in_segment_match(struct zmpls_in_segment *a, struct zmpls_in_segment *b)
   return 0;
 }
 
-struct zmpls_in_segment*
-mpls_in_segment_find(struct zmpls_in_segment *in)
+static unsigned int
+mpls_in_segment_hash_key (void *p)
 {
-  struct listnode *node;
-  struct zmpls_in_segment *old;
+  struct zmpls_in_segment *in = p;
+  unsigned int key = (in->labelspace << 24) ^ (in->label.type << 20);
 
-  for (ALL_LIST_ELEMENTS_RO(&mpls_in_segment_list,node,old))
-    if (mpls_in_segment_match(in, old))
-      return old;
+  /* only a generic label is known to fill the whole union */
+  if (in->label.type == ZEBRA_MPLS_LABEL_GEN)
+    key ^= in->label.u.gen;
+  return key;
+}
 
-  return NULL;
+static int
+mpls_in_segment_hash_cmp (void *a, void *b)
+{
+  return mpls_in_segment_match (a, b);
+}
+
+struct zmpls_in_segment*
+mpls_in_segment_find(struct zmpls_in_segment *in)
+{
+  return hash_lookup (mpls_in_segment_hash, in);
 }
 
 static int
@@ -346,6 +410,7 @@ do_mpls_in_segment_unregister(struct zmpls_in_segment *in, int flag)
   }
 
   redistribute_delete_mpls_in_segment (in);
+  hash_release (mpls_in_segment_hash, in);
   LISTNODE_DETACH (&mpls_in_segment_list, &in->global);
   XFREE (MTYPE_TMP, in);
 
@@ -391,6 +456,7 @@ mpls_in_segment_register(struct zmpls_in_segment *in, int install)
   }
 
   LISTNODE_ATTACH(&mpls_in_segment_list, &new->global);
+  hash_get (mpls_in_segment_hash, new, hash_alloc_intern);
   redistribute_add_mpls_in_segment (new);
   return 0;
 }
@@ -419,16 +485,26 @@ struct list mpls_xc_list = {
   .del = NULL,
 };
 
-struct zmpls_xc *mpls_xc_find(unsigned int index)
+static struct hash *mpls_xc_hash;	/* by index */
+
+static unsigned int
+mpls_xc_hash_key (void *p)
 {
-  struct listnode *node;
-  struct zmpls_xc *xc;
+  return ((struct zmpls_xc *)p)->index;
+}
+
+static int
+mpls_xc_hash_cmp (void *a, void *b)
+{
+  return ((struct zmpls_xc *)a)->index == ((struct zmpls_xc *)b)->index;
+}
 
-  for (ALL_LIST_ELEMENTS_RO(&mpls_xc_list,node,xc))
-    if (index == xc->index)
-      return xc;
+struct zmpls_xc *mpls_xc_find(unsigned int index)
+{
+  struct zmpls_xc lookup;
 
-  return NULL;
+  lookup.index = index;
+  return hash_lookup (mpls_xc_hash, &lookup);
 }
 
 int
@@ -462,6 +538,7 @@ mpls_xc_register(struct zmpls_xc *xc)
   in->xc = new->index;
 
   LISTNODE_ATTACH(&mpls_xc_list, &new->global);
+  hash_get (mpls_xc_hash, new, hash_alloc_intern);
 
   if (in->owner != ZEBRA_ROUTE_KERNEL)
   {
@@ -500,6 +577,7 @@ mpls_xc_unregister(struct zmpls_xc *old)
   in->xc = 0;
 
   redistribute_delete_mpls_xc(old);
+  hash_release (mpls_xc_hash, old);
   LISTNODE_DETACH(&mpls_xc_list, &old->global);
   XFREE (MTYPE_TMP, old);
 }
@@ -528,41 +606,131 @@ struct list mpls_ftn_list = {
   .del = NULL,
 };
 
+static struct hash *mpls_ftn_hash;	/* by index */
+
+/* IPv4 and IPv6 FECs by prefix, each node holds a list of the FTNs
+   registered for that prefix. */
+static struct route_table *mpls_ftn_table[AFI_MAX];
+
+static unsigned int
+mpls_ftn_hash_key (void *p)
+{
+  return ((struct zmpls_ftn *)p)->index;
+}
+
+static int
+mpls_ftn_hash_cmp (void *a, void *b)
+{
+  return ((struct zmpls_ftn *)a)->index == ((struct zmpls_ftn *)b)->index;
+}
+
+static struct route_table *
+mpls_ftn_table_get (struct zmpls_fec *fec)
+{
+  switch (fec->type)
+    {
+    case ZEBRA_MPLS_FEC_IPV4:
+      return mpls_ftn_table[AFI_IP];
+    case ZEBRA_MPLS_FEC_IPV6:
+      return mpls_ftn_table[AFI_IP6];
+    default:
+      return NULL;
+    }
+}
+
+static void
+mpls_ftn_table_add (struct zmpls_ftn *ftn)
+{
+  struct route_table *table;
+  struct route_node *rn;
+
+  if (! (table = mpls_ftn_table_get (&ftn->fec)))
+    return;
+
+  /* the node stays locked while it holds FTNs */
+  rn = route_node_get (table, &ftn->fec.u.p);
+  if (! rn->info)
+    rn->info = list_new ();
+  else
+    route_unlock_node (rn);
+  listnode_add (rn->info, ftn);
+}
+
+static void
+mpls_ftn_table_delete (struct zmpls_ftn *ftn)
+{
+  struct route_table *table;
+  struct route_node *rn;
+
+  if (! (table = mpls_ftn_table_get (&ftn->fec)))
+    return;
+
+  if (! (rn = route_node_lookup (table, &ftn->fec.u.p)))
+    return;
+
+  listnode_delete (rn->info, ftn);
+  if (! listcount ((struct list *)rn->info))
+    {
+      list_free (rn->info);
+      rn->info = NULL;
+      route_unlock_node (rn);
+    }
+  route_unlock_node (rn);
+}
+
 struct zmpls_ftn*
 mpls_ftn_find(unsigned int index)
 {
-  struct listnode *node;
-  struct zmpls_ftn *ftn;
+  struct zmpls_ftn lookup;
 
-  for (ALL_LIST_ELEMENTS_RO(&mpls_ftn_list,node,ftn))
-    if (index == ftn->index)
-      return ftn;
-
-  return NULL;
+  lookup.index = index;
+  return hash_lookup (mpls_ftn_hash, &lookup);
 }
 
+/* FTN of the longest FEC prefix covering p. */
 struct zmpls_ftn*
 mpls_ftn_find_by_prefix(struct prefix* p)
 {
-  struct listnode *node;
+  struct route_table *table;
+  struct route_node *rn;
   struct zmpls_ftn *ftn;
 
-  for (ALL_LIST_ELEMENTS_RO(&mpls_ftn_list,node,ftn))
-    if ((ftn->fec.type == ZEBRA_MPLS_FEC_IPV4 ||
-	ftn->fec.type == ZEBRA_MPLS_FEC_IPV6) &&
-	prefix_match(&ftn->fec.u.p, p))
-      return ftn;
+  if (p->family == AF_INET)
+    table = mpls_ftn_table[AFI_IP];
+  else if (p->family == AF_INET6)
+    table = mpls_ftn_table[AFI_IP6];
+  else
+    return NULL;
 
-  return NULL;
+  if (! (rn = route_node_match (table, p)))
+    return NULL;
+
+  ftn = listgetdata (listhead ((struct list *)rn->info));
+  route_unlock_node (rn);
+  return ftn;
 }
 
 struct zmpls_ftn*
 mpls_ftn_find_by_fec(struct zmpls_fec* fec)
 {
+  struct route_table *table;
+  struct route_node *rn;
   struct listnode *node;
   struct zmpls_ftn *ftn;
 
-  for (ALL_LIST_ELEMENTS_RO(&mpls_ftn_list,node,ftn))
+  if (! (table = mpls_ftn_table_get (fec)))
+    {
+      for (ALL_LIST_ELEMENTS_RO(&mpls_ftn_list,node,ftn))
+        if (mpls_fec_match(fec, &ftn->fec))
+          return ftn;
+      return NULL;
+    }
+
+  if (! (rn = route_node_lookup (table, &fec->u.p)))
+    return NULL;
+
+  route_unlock_node (rn);
+  for (ALL_LIST_ELEMENTS_RO((struct list *)rn->info,node,ftn))
     if (mpls_fec_match(fec, &ftn->fec))
       return ftn;
 
@@ -588,6 +756,8 @@ do_mpls_ftn_register(struct zmpls_ftn *ftn)
   ftn->index = new->index;
 
   LISTNODE_ATTACH(&mpls_ftn_list, &new->global);
+  hash_get (mpls_ftn_hash, new, hash_alloc_intern);
+  mpls_ftn_table_add (new);
   mpls_ctrl_ftn_register(new);
   redistribute_add_mpls_ftn (new);
   return new;
@@ -673,6 +843,8 @@ do_mpls_ftn_unregister(struct zmpls_ftn *ftn)
   mpls_ctrl_ftn_unregister(ftn);
 
   redistribute_delete_mpls_ftn(ftn);
+  hash_release (mpls_ftn_hash, ftn);
+  mpls_ftn_table_delete (ftn);
   LISTNODE_DETACH(&mpls_ftn_list, &ftn->global);
   XFREE (MTYPE_TMP, ftn);
 }
@@ -751,6 +923,17 @@ mpls_ftn_unregister(struct zmpls_ftn *ftn, int modify)
 void
 mpls_init (void)
 {
+  mpls_in_segment_hash = hash_create (mpls_in_segment_hash_key,
+				      mpls_in_segment_hash_cmp);
+  mpls_out_segment_hash = hash_create (mpls_out_segment_hash_key,
+				       mpls_out_segment_hash_cmp);
+  mpls_out_key_hash = hash_create (mpls_out_key_hash_key,
+				   mpls_out_key_hash_cmp);
+  mpls_nhlfe_hash = hash_create (mpls_nhlfe_hash_key, mpls_nhlfe_hash_cmp);
+  mpls_xc_hash = hash_create (mpls_xc_hash_key, mpls_xc_hash_cmp);
+  mpls_ftn_hash = hash_create (mpls_ftn_hash_key, mpls_ftn_hash_cmp);
+  mpls_ftn_table[AFI_IP] = route_table_init ();
+  mpls_ftn_table[AFI_IP6] = route_table_init ();
 }
 
 void
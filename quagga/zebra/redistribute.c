@@ -30,6 +30,9 @@
 #include "zclient.h"
 #include "linklist.h"
 #include "log.h"
+#include "memory.h"
+#include "thread.h"
+#include "buffer.h"
 
 #include "zebra/rib.h"
 #include "zebra/zserv.h"
@@ -84,6 +87,15 @@ is_default (struct prefix *p)
   return 0;
 }
 
+/* Whether client asked for routes of the given type to prefix p. */
+static int
+zebra_redistribute_wanted (struct zserv *client, struct prefix *p, int type)
+{
+  if (is_default (p))
+    return client->redist_default || client->redist[type];
+  return client->redist[type];
+}
+
 static void
 zebra_redistribute_default (struct zserv *client)
 {
@@ -168,76 +180,373 @@ zebra_redistribute (struct zserv *client, int type)
 #endif /* HAVE_IPV6 */
 }
 
-void
-redistribute_add (struct prefix *p, struct rib *rib)
+/* Redistribution queue.
+ *
+ * Route changes coming out of rib_process() are not written to the
+ * clients straight away.  Instead the message for each change is encoded
+ * and parked in a per-client table, keyed by prefix and route type, so
+ * that a later change to the same prefix and type simply replaces the
+ * earlier one.  A short timer then packs the queued messages into large
+ * writes.  While a client's write buffer still holds data, draining stops
+ * and resumes once zserv_flush_data() has emptied it, so a slow client
+ * sees coalesced state instead of every intermediate flap.
+ */
+
+/* Delay before queued changes are sent, to give flaps a chance to
+   coalesce. */
+#define ZEBRA_REDIST_DELAY_MSEC     10
+
+/* Size of a single packed write to a client. */
+#define ZEBRA_REDIST_BATCH_SIZE     65536
+
+/* Number of packed writes per run of the drain thread. */
+#define ZEBRA_REDIST_BATCH_MAX      16
+
+/* Room for one zsend_route_multipath() message, which carries at most
+   a single IPv6 prefix and nexthop. */
+#define ZEBRA_REDIST_MSG_SIZE       64
+
+struct redist_entry
+{
+  struct redist_entry *next;
+
+  /* Route type this message is for. */
+  u_char type;
+
+  /* Encoded ZEBRA_IPV{4,6}_ROUTE_{ADD,DELETE} message. */
+  u_int16_t length;
+  u_char data[ZEBRA_REDIST_MSG_SIZE];
+};
+
+static int zebra_redistribute_queue_run (struct thread *);
+
+static void
+zebra_redistribute_queue_schedule (struct zserv *client, long msec)
+{
+  if (client->t_redist || client->t_suicide)
+    return;
+  client->t_redist = thread_add_timer_msec (zebrad.master,
+					    zebra_redistribute_queue_run,
+					    client, msec);
+}
+
+/* Unlink entry from the chain of messages queued at rn. */
+static void
+zebra_redistribute_entry_unlink (struct route_node *rn,
+				 struct redist_entry *entry)
+{
+  struct redist_entry *prev;
+
+  if (rn->info == entry)
+    {
+      rn->info = entry->next;
+      return;
+    }
+
+  for (prev = rn->info; prev->next != entry; prev = prev->next)
+    ;
+  prev->next = entry->next;
+}
+
+/* Add entry at the tail of the chain queued at rn, so that the
+   messages for one prefix go out in the order they were queued. */
+static void
+zebra_redistribute_entry_append (struct route_node *rn,
+				 struct redist_entry *entry)
+{
+  struct redist_entry *last;
+
+  entry->next = NULL;
+  if (! rn->info)
+    {
+      rn->info = entry;
+      return;
+    }
+
+  for (last = rn->info; last->next; last = last->next)
+    ;
+  last->next = entry;
+}
+
+/* Queue cmd for the given prefix and rib to client, replacing any
+   message still pending for the same prefix and route type.  The
+   replacing message moves behind the others queued for the prefix, as
+   e.g. a DELETE for the old type must reach the client before an ADD
+   for the new one. */
+static void
+zebra_redistribute_enqueue (int cmd, struct zserv *client,
+			    struct prefix *p, struct rib *rib)
+{
+  struct route_table *table;
+  struct route_node *rn;
+  struct redist_entry *entry;
+  afi_t afi;
+  int length;
+
+  afi = family2afi (p->family);
+  if (afi != AFI_IP && afi != AFI_IP6)
+    return;
+
+  /* Messages which do not fit in an entry go out directly. */
+  length = zserv_encode_route_multipath (cmd, client->obuf, p, rib);
+  if (length > ZEBRA_REDIST_MSG_SIZE)
+    {
+      zebra_server_send_stream (client, client->obuf);
+      client->redist_sent++;
+      return;
+    }
+
+  if (! client->redist_queue[afi])
+    client->redist_queue[afi] = route_table_init ();
+  table = client->redist_queue[afi];
+
+  rn = route_node_get (table, p);
+  for (entry = rn->info; entry; entry = entry->next)
+    if (entry->type == rib->type)
+      break;
+
+  if (entry)
+    {
+      /* Drop the reference route_node_get took; rn->info holds one. */
+      route_unlock_node (rn);
+      client->redist_coalesced++;
+
+      zebra_redistribute_entry_unlink (rn, entry);
+      zebra_redistribute_entry_append (rn, entry);
+    }
+  else
+    {
+      if (rn->info)
+	route_unlock_node (rn);
+
+      entry = XCALLOC (MTYPE_ZEBRA_REDIST, sizeof (struct redist_entry));
+      entry->type = rib->type;
+      zebra_redistribute_entry_append (rn, entry);
+
+      client->redist_depth++;
+      if (client->redist_depth > client->redist_depth_max)
+	client->redist_depth_max = client->redist_depth;
+    }
+
+  entry->length = length;
+  memcpy (entry->data, STREAM_DATA (client->obuf), length);
+  client->redist_queued++;
+
+  zebra_redistribute_queue_schedule (client, ZEBRA_REDIST_DELAY_MSEC);
+}
+
+/* Pack queued messages for client into redist_buf and write them out,
+   stopping as soon as the write buffer backs up. */
+static int
+zebra_redistribute_queue_run (struct thread *thread)
 {
-  struct listnode *node, *nnode;
   struct zserv *client;
+  struct route_node *rn;
+  struct redist_entry *entry;
+  struct stream *s;
+  afi_t afi;
+  int batches = 0;
 
-  for (ALL_LIST_ELEMENTS (zebrad.client_list, node, nnode, client))
+  client = THREAD_ARG (thread);
+  client->t_redist = NULL;
+
+  if (client->t_suicide)
+    return 0;
+
+  /* Wait for zserv_flush_data() to drain what is already buffered. */
+  if (! buffer_empty (client->wb))
     {
-      if (is_default (p))
-        {
-          if (client->redist_default || client->redist[rib->type])
-            {
-              if (p->family == AF_INET)
-                zsend_route_multipath (ZEBRA_IPV4_ROUTE_ADD, client, p, rib);
-#ifdef HAVE_IPV6
-              if (p->family == AF_INET6)
-                zsend_route_multipath (ZEBRA_IPV6_ROUTE_ADD, client, p, rib);
-#endif /* HAVE_IPV6 */	  
+      client->redist_blocked++;
+      return 0;
+    }
+
+  if (! client->redist_buf)
+    client->redist_buf = stream_new (ZEBRA_REDIST_BATCH_SIZE);
+  s = client->redist_buf;
+  stream_reset (s);
+
+  for (afi = AFI_IP; afi < AFI_MAX; afi++)
+    {
+      if (! client->redist_queue[afi])
+	continue;
+
+      for (rn = route_top (client->redist_queue[afi]); rn;
+	   rn = route_next (rn))
+	{
+	  if (! rn->info)
+	    continue;
+
+	  while ((entry = rn->info) != NULL)
+	    {
+	      if (STREAM_WRITEABLE (s) < entry->length)
+		{
+		  if (zebra_server_send_stream (client, s) < 0)
+		    {
+		      route_unlock_node (rn);
+		      return 0;
+		    }
+		  stream_reset (s);
+		  client->redist_writes++;
+
+		  if (! buffer_empty (client->wb)
+		      || ++batches >= ZEBRA_REDIST_BATCH_MAX)
+		    {
+		      /* Back off; zserv_flush_data() resumes us when the
+			 client has caught up. */
+		      if (! buffer_empty (client->wb))
+			client->redist_blocked++;
+		      else
+			zebra_redistribute_queue_schedule (client, 0);
+		      route_unlock_node (rn);
+		      return 0;
+		    }
+		}
+
+	      stream_put (s, entry->data, entry->length);
+	      client->redist_sent++;
+	      client->redist_depth--;
+
+	      rn->info = entry->next;
+	      XFREE (MTYPE_ZEBRA_REDIST, entry);
 	    }
-        }
-      else if (client->redist[rib->type])
-        {
-          if (p->family == AF_INET)
-            zsend_route_multipath (ZEBRA_IPV4_ROUTE_ADD, client, p, rib);
-#ifdef HAVE_IPV6
-          if (p->family == AF_INET6)
-            zsend_route_multipath (ZEBRA_IPV6_ROUTE_ADD, client, p, rib);
-#endif /* HAVE_IPV6 */	  
-        }
+	  /* Release the reference held by the queued entries. */
+	  route_unlock_node (rn);
+	}
     }
+
+  if (stream_get_endp (s))
+    {
+      if (zebra_server_send_stream (client, s) < 0)
+	return 0;
+      client->redist_writes++;
+    }
+
+  return 0;
 }
 
+/* Called once the client's write buffer has been flushed. */
 void
-redistribute_delete (struct prefix *p, struct rib *rib)
+zebra_redistribute_queue_resume (struct zserv *client)
 {
-  struct listnode *node, *nnode;
-  struct zserv *client;
+  if (client->redist_depth)
+    zebra_redistribute_queue_schedule (client, 0);
+}
 
-  /* Add DISTANCE_INFINITY check. */
-  if (rib->distance == DISTANCE_INFINITY)
-    return;
+/* Drop the messages queued to client for route types and prefixes it
+   no longer redistributes. */
+static void
+zebra_redistribute_queue_purge (struct zserv *client)
+{
+  struct route_node *rn;
+  struct redist_entry *entry, *next;
+  afi_t afi;
 
-  for (ALL_LIST_ELEMENTS (zebrad.client_list, node, nnode, client))
+  for (afi = AFI_IP; afi < AFI_MAX; afi++)
     {
-      if (is_default (p))
+      if (! client->redist_queue[afi])
+	continue;
+
+      for (rn = route_top (client->redist_queue[afi]); rn;
+	   rn = route_next (rn))
 	{
-	  if (client->redist_default || client->redist[rib->type])
+	  if (! rn->info)
+	    continue;
+
+	  for (entry = rn->info; entry; entry = next)
 	    {
-	      if (p->family == AF_INET)
-		zsend_route_multipath (ZEBRA_IPV4_ROUTE_DELETE, client, p,
-				       rib);
-#ifdef HAVE_IPV6
-	      if (p->family == AF_INET6)
-		zsend_route_multipath (ZEBRA_IPV6_ROUTE_DELETE, client, p,
-				       rib);
-#endif /* HAVE_IPV6 */
+	      next = entry->next;
+	      if (zebra_redistribute_wanted (client, &rn->p, entry->type))
+		continue;
+
+	      zebra_redistribute_entry_unlink (rn, entry);
+	      XFREE (MTYPE_ZEBRA_REDIST, entry);
+	      client->redist_depth--;
 	    }
+
+	  /* Release the reference held by the queued entries. */
+	  if (! rn->info)
+	    route_unlock_node (rn);
 	}
-      else if (client->redist[rib->type])
-	{
-	  if (p->family == AF_INET)
-	    zsend_route_multipath (ZEBRA_IPV4_ROUTE_DELETE, client, p, rib);
+    }
+}
+
+/* Release all pending redistribution state of a client. */
+void
+zebra_redistribute_queue_free (struct zserv *client)
+{
+  struct route_node *rn;
+  struct redist_entry *entry, *next;
+  afi_t afi;
+
+  THREAD_OFF (client->t_redist);
+
+  for (afi = AFI_IP; afi < AFI_MAX; afi++)
+    {
+      if (! client->redist_queue[afi])
+	continue;
+
+      for (rn = route_top (client->redist_queue[afi]); rn;
+	   rn = route_next (rn))
+	if (rn->info)
+	  {
+	    for (entry = rn->info; entry; entry = next)
+	      {
+		next = entry->next;
+		XFREE (MTYPE_ZEBRA_REDIST, entry);
+	      }
+	    rn->info = NULL;
+	    route_unlock_node (rn);
+	  }
+
+      route_table_finish (client->redist_queue[afi]);
+      client->redist_queue[afi] = NULL;
+    }
+  client->redist_depth = 0;
+
+  if (client->redist_buf)
+    {
+      stream_free (client->redist_buf);
+      client->redist_buf = NULL;
+    }
+}
+
+static void
+redistribute_update (int cmd4, int cmd6, struct prefix *p, struct rib *rib)
+{
+  struct listnode *node, *nnode;
+  struct zserv *client;
+
+  for (ALL_LIST_ELEMENTS (zebrad.client_list, node, nnode, client))
+    {
+      if (! zebra_redistribute_wanted (client, p, rib->type))
+        continue;
+
+      if (p->family == AF_INET)
+        zebra_redistribute_enqueue (cmd4, client, p, rib);
 #ifdef HAVE_IPV6
-	  if (p->family == AF_INET6)
-	    zsend_route_multipath (ZEBRA_IPV6_ROUTE_DELETE, client, p, rib);
+      if (p->family == AF_INET6)
+        zebra_redistribute_enqueue (cmd6, client, p, rib);
 #endif /* HAVE_IPV6 */
-	}
     }
 }
 
+void
+redistribute_add (struct prefix *p, struct rib *rib)
+{
+  redistribute_update (ZEBRA_IPV4_ROUTE_ADD, ZEBRA_IPV6_ROUTE_ADD, p, rib);
+}
+
+void
+redistribute_delete (struct prefix *p, struct rib *rib)
+{
+  /* Add DISTANCE_INFINITY check. */
+  if (rib->distance == DISTANCE_INFINITY)
+    return;
+
+  redistribute_update (ZEBRA_IPV4_ROUTE_DELETE, ZEBRA_IPV6_ROUTE_DELETE,
+		       p, rib);
+}
+
 void
 zebra_redistribute_add (int command, struct zserv *client, int length)
 {
@@ -284,6 +593,7 @@ zebra_redistribute_delete (int command, struct zserv *client, int length)
     case ZEBRA_ROUTE_OSPF6:
     case ZEBRA_ROUTE_BGP:
       client->redist[type] = 0;
+      zebra_redistribute_queue_purge (client);
       break;
     default:
       break;
@@ -301,7 +611,8 @@ void
 zebra_redistribute_default_delete (int command, struct zserv *client,
 				   int length)
 {
-  client->redist_default = 0;;
+  client->redist_default = 0;
+  zebra_redistribute_queue_purge (client);
 }     
 
 /* Interface up information. */
@@ -36,6 +36,9 @@ union g_addr {
 #endif /* HAVE_IPV6 */
 };
 
+struct interface;
+struct nexthop_group;
+
 struct rib
 {
   /* Status Flags for the *route_node*, but kept in the head RIB.. */
@@ -48,6 +51,15 @@ struct rib
   
   /* Nexthop structure */
   struct nexthop *nexthop;
+
+  /* Shared nexthop group the above list belongs to, NULL when the
+     list is private to this RIB entry. */
+  struct nexthop_group *nhg;
+  struct rib *nhg_next;
+  struct rib *nhg_prev;
+
+  /* Route node the entry is linked to. */
+  struct route_node *rn;
   
   /* Refrence count. */
   unsigned long refcnt;
@@ -76,6 +88,8 @@ struct rib
   /* RIB internal status */
   u_char status;
 #define RIB_ENTRY_REMOVED	(1 << 0)
+#define RIB_ENTRY_INSTALLED	(1 << 1)
+#define RIB_ENTRY_STALE		(1 << 2)
 
   /* Nexthop information. */
   u_char nexthop_num;
@@ -198,6 +212,46 @@ struct nexthop
   union g_addr src;
 };
 
+/* Interned nexthop list shared by all RIB entries with the same
+ * nexthops and the same resolution context (address family, route type
+ * and ZEBRA_FLAG_INTERNAL).  Resolution state is computed once per
+ * group and RIB generation.  A group whose resolution changes while
+ * some of its RIB entries are installed in the kernel is superseded by
+ * a copy, so those entries can still be withdrawn with the nexthops
+ * they were installed with.
+ */
+struct nexthop_group
+{
+  struct nexthop *nexthop;
+  u_char nexthop_num;
+  u_char nexthop_active_num;
+
+  /* Resolution context. */
+  u_char family;
+  u_char flags;
+  int type;
+
+  unsigned int key;
+
+  /* RIB entries using the group. */
+  struct rib *ribs;
+
+  /* RIB entries plus superseded groups referring to this one. */
+  unsigned long refcnt;
+
+  /* RIB entries currently installed in the kernel. */
+  unsigned long fib_refcnt;
+
+  /* RIB generation the nexthops were last resolved at. */
+  unsigned long generation;
+
+  /* Queued for re-resolution. */
+  u_char pending;
+
+  /* Newer copy of the group, set once this one is superseded. */
+  struct nexthop_group *successor;
+};
+
 /* Routing table instance.  */
 struct vrf
 {
@@ -220,6 +274,9 @@ struct vrf
   struct route_table *stable[AFI_MAX][SAFI_MAX];
 };
 
+extern void rib_free (struct rib *);
+extern void nexthop_group_count (unsigned long *, unsigned long *,
+				 unsigned long *);
 extern struct nexthop *nexthop_ifindex_add (struct rib *, unsigned int);
 extern struct nexthop *nexthop_ifname_add (struct rib *, char *);
 extern struct nexthop *nexthop_blackhole_add (struct rib *);
@@ -262,8 +319,11 @@ extern struct rib *rib_match_ipv4 (struct in_addr);
 extern struct rib *rib_lookup_ipv4 (struct prefix_ipv4 *);
 
 extern void rib_update (void);
+extern void rib_update_if (struct interface *);
 extern void rib_weed_tables (void);
 extern void rib_sweep_route (void);
+extern void rib_mark_stale (afi_t, int);
+extern void rib_sweep_stale (afi_t);
 extern void rib_close (void);
 extern void rib_init (void);
 
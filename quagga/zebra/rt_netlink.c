@@ -35,6 +35,7 @@
 #include "rib.h"
 #include "thread.h"
 #include "privs.h"
+#include "vty.h"
 
 #include "zebra/zserv.h"
 #include "zebra/rt.h"
@@ -42,6 +43,21 @@
 #include "zebra/interface.h"
 #include "zebra/debug.h"
 
+/* Receive buffer size, large enough for the dump batches the kernel
+   builds when given room to. */
+#define NL_PKT_BUF_SIZE         32768
+
+/* Datagrams read from the listen socket with one system call. */
+#define NL_RCV_BATCH            8
+
+/* Seconds to wait after an overrun before resynchronising. */
+#define NL_RESYNC_DELAY         1
+
+/* Receive buffers are kept per socket, as handlers of messages from
+   the listen socket may talk to the kernel on the command socket. */
+static char netlink_buf[NL_RCV_BATCH][NL_PKT_BUF_SIZE];
+static char netlink_cmd_buf[1][NL_PKT_BUF_SIZE];
+
 /* Socket interface to kernel */
 struct nlsock
 {
@@ -49,8 +65,44 @@ struct nlsock
   int seq;
   struct sockaddr_nl snl;
   const char *name;
-} netlink      = { -1, 0, {0}, "netlink-listen"},     /* kernel messages */
-  netlink_cmd  = { -1, 0, {0}, "netlink-cmd"};        /* command channel */
+
+  /* Receive buffers and the number of datagrams read at once. */
+  char (*buf)[NL_PKT_BUF_SIZE];
+  int batch;
+
+  /* Statistics. */
+  unsigned long reads;
+  unsigned long msgs;
+  unsigned long overruns;
+  unsigned long resyncs;
+} netlink      = { -1, 0, {0}, "netlink-listen",      /* kernel messages */
+		   netlink_buf, NL_RCV_BATCH },
+  netlink_cmd  = { -1, 0, {0}, "netlink-cmd",         /* command channel */
+		   netlink_cmd_buf, 1 };
+
+static struct thread *netlink_resync_thread;
+
+#ifndef HAVE_RECVMMSG
+/* Fallback reading a single datagram. */
+struct mmsghdr
+{
+  struct msghdr msg_hdr;
+  unsigned int msg_len;
+};
+
+static int
+recvmmsg (int sock, struct mmsghdr *vec, unsigned int vlen, int flags,
+	  struct timespec *timeout)
+{
+  int ret;
+
+  ret = recvmsg (sock, &vec->msg_hdr, flags);
+  if (ret < 0)
+    return ret;
+  vec->msg_len = ret;
+  return 1;
+}
+#endif /* HAVE_RECVMMSG */
 
 struct message nlmsg_str[] = {
   {RTM_NEWROUTE, "RTM_NEWROUTE"},
@@ -110,7 +162,7 @@ set_ifindex(struct interface *ifp, unsigned int ifi_index)
 	  if_delete_update(oifp);
         }
     }
-  ifp->ifindex = ifi_index;
+  if_set_index (ifp, ifi_index);
 }
 
 /* Make socket for Linux netlink interface. */
@@ -316,164 +368,242 @@ netlink_request (int family, int type, struct nlsock *nl)
   return 0;
 }
 
-/* Receive message from netlink interface and pass those information
-   to the given function. */
+static int netlink_resync (struct thread *);
+
+/* The kernel dropped messages for the listen socket, schedule a
+   resynchronisation once the burst is over. */
+static void
+netlink_overrun (struct nlsock *nl)
+{
+  nl->overruns++;
+
+  if (netlink_resync_thread)
+    return;
+
+  zlog (NULL, LOG_ERR, "%s recvmsg overrun, resynchronising in %d seconds",
+        nl->name, NL_RESYNC_DELAY);
+  netlink_resync_thread = thread_add_timer (zebrad.master, netlink_resync,
+                                            NULL, NL_RESYNC_DELAY);
+}
+
+/* Pass the messages of one datagram read from nl to filter.  Returns
+   1 when the datagram ends the reply being read, with *ret set to what
+   netlink_parse_info returns, 0 to read on.  Filter errors are left in
+   *ret either way. */
 static int
-netlink_parse_info (int (*filter) (struct sockaddr_nl *, struct nlmsghdr *),
-                    struct nlsock *nl)
+netlink_parse_datagram (int (*filter) (struct sockaddr_nl *,
+                                       struct nlmsghdr *),
+                        struct nlsock *nl, struct sockaddr_nl *snl,
+                        struct mmsghdr *mmsg, char *buf, int *ret)
 {
+  struct msghdr *msg = &mmsg->msg_hdr;
+  struct nlmsghdr *h;
   int status;
-  int ret = 0;
   int error;
 
-  while (1)
-    {
-      char buf[4096];
-      struct iovec iov = { buf, sizeof buf };
-      struct sockaddr_nl snl;
-      struct msghdr msg = { (void *) &snl, sizeof snl, &iov, 1, NULL, 0, 0 };
-      struct nlmsghdr *h;
-      int save_errno;
-
-      if (zserv_privs.change (ZPRIVS_RAISE))
-        zlog (NULL, LOG_ERR, "Can't raise privileges");
+  status = mmsg->msg_len;
 
-      status = recvmsg (nl->sock, &msg, 0);
-      save_errno = errno;
+  if (status == 0)
+    {
+      zlog (NULL, LOG_ERR, "%s EOF", nl->name);
+      *ret = -1;
+      return 1;
+    }
 
-      if (zserv_privs.change (ZPRIVS_LOWER))
-        zlog (NULL, LOG_ERR, "Can't lower privileges");
+  if (msg->msg_namelen != sizeof *snl)
+    {
+      zlog (NULL, LOG_ERR, "%s sender address length error: length %d",
+            nl->name, msg->msg_namelen);
+      *ret = -1;
+      return 1;
+    }
 
-      if (status < 0)
-        {
-          if (save_errno == EINTR)
-            continue;
-          if (save_errno == EWOULDBLOCK || save_errno == EAGAIN)
-            break;
-          zlog (NULL, LOG_ERR, "%s recvmsg overrun: %s",
-	  	nl->name, safe_strerror(save_errno));
-          continue;
-        }
+  /* JF: Ignore messages that aren't from the kernel */
+  if ( snl->nl_pid != 0 )
+    {
+      zlog ( NULL, LOG_ERR, "Ignoring message from pid %u", snl->nl_pid );
+      return 0;
+    }
 
-      if (status == 0)
-        {
-          zlog (NULL, LOG_ERR, "%s EOF", nl->name);
-          return -1;
-        }
+  for (h = (struct nlmsghdr *) buf; NLMSG_OK (h, (unsigned int) status);
+       h = NLMSG_NEXT (h, status))
+    {
+      nl->msgs++;
 
-      if (msg.msg_namelen != sizeof snl)
-        {
-          zlog (NULL, LOG_ERR, "%s sender address length error: length %d",
-                nl->name, msg.msg_namelen);
-          return -1;
-        }
-      
-      /* JF: Ignore messages that aren't from the kernel */
-      if ( snl.nl_pid != 0 )
-        {
-          zlog ( NULL, LOG_ERR, "Ignoring message from pid %u", snl.nl_pid );
-          continue;
-        }
+      /* Finish of reading. */
+      if (h->nlmsg_type == NLMSG_DONE)
+        return 1;
 
-      for (h = (struct nlmsghdr *) buf; NLMSG_OK (h, (unsigned int) status);
-           h = NLMSG_NEXT (h, status))
+      /* Error handling. */
+      if (h->nlmsg_type == NLMSG_ERROR)
         {
-          /* Finish of reading. */
-          if (h->nlmsg_type == NLMSG_DONE)
-            return ret;
+          struct nlmsgerr *err = (struct nlmsgerr *) NLMSG_DATA (h);
 
-          /* Error handling. */
-          if (h->nlmsg_type == NLMSG_ERROR)
+          /* If the error field is zero, then this is an ACK */
+          if (err->error == 0)
             {
-              struct nlmsgerr *err = (struct nlmsgerr *) NLMSG_DATA (h);
-
-              /* If the error field is zero, then this is an ACK */
-              if (err->error == 0)
+              if (IS_ZEBRA_DEBUG_KERNEL)
                 {
-                  if (IS_ZEBRA_DEBUG_KERNEL)
-                    {
-                      zlog_debug ("%s: %s ACK: type=%s(%u), seq=%u, pid=%u",
-                                 __FUNCTION__, nl->name,
-                                 lookup (nlmsg_str, err->msg.nlmsg_type),
-                                 err->msg.nlmsg_type, err->msg.nlmsg_seq,
-                                 err->msg.nlmsg_pid);
-                    }
-
-                  /* return if not a multipart message, otherwise continue */
-                  if (!(h->nlmsg_flags & NLM_F_MULTI))
-                    {
-                      return 0;
-                    }
-                  continue;
+                  zlog_debug ("%s: %s ACK: type=%s(%u), seq=%u, pid=%u",
+                              __FUNCTION__, nl->name,
+                              lookup (nlmsg_str, err->msg.nlmsg_type),
+                              err->msg.nlmsg_type, err->msg.nlmsg_seq,
+                              err->msg.nlmsg_pid);
                 }
 
-              if (h->nlmsg_len < NLMSG_LENGTH (sizeof (struct nlmsgerr)))
+              /* return if not a multipart message, otherwise
+                 continue */
+              if (!(h->nlmsg_flags & NLM_F_MULTI))
                 {
-                  zlog (NULL, LOG_ERR, "%s error: message truncated",
-                        nl->name);
-                  return -1;
+                  *ret = 0;
+                  return 1;
                 }
+              continue;
+            }
 
-              /* Deal with Error Noise  - MAG */
-              {
-                int loglvl = LOG_ERR;
-                int errnum = err->error;
-                int msg_type = err->msg.nlmsg_type;
-
-                if (nl == &netlink_cmd
-                    && (-errnum == ENODEV || -errnum == ESRCH)
-                    && (msg_type == RTM_NEWROUTE || msg_type == RTM_DELROUTE))
-                  loglvl = LOG_DEBUG;
-
-                zlog (NULL, loglvl, "%s error: %s, type=%s(%u), "
-                      "seq=%u, pid=%u",
-                      nl->name, safe_strerror (-errnum),
-                      lookup (nlmsg_str, msg_type),
-                      msg_type, err->msg.nlmsg_seq, err->msg.nlmsg_pid);
-              }
-              /*
-                 ret = -1;
-                 continue;
-               */
-              return -1;
+          if (h->nlmsg_len < NLMSG_LENGTH (sizeof (struct nlmsgerr)))
+            {
+              zlog (NULL, LOG_ERR, "%s error: message truncated", nl->name);
+              *ret = -1;
+              return 1;
             }
 
-          /* OK we got netlink message. */
+          /* Deal with Error Noise  - MAG */
+          {
+            int loglvl = LOG_ERR;
+            int errnum = err->error;
+            int msg_type = err->msg.nlmsg_type;
+
+            if (nl == &netlink_cmd
+                && (-errnum == ENODEV || -errnum == ESRCH)
+                && (msg_type == RTM_NEWROUTE || msg_type == RTM_DELROUTE))
+              loglvl = LOG_DEBUG;
+
+            zlog (NULL, loglvl, "%s error: %s, type=%s(%u), "
+                  "seq=%u, pid=%u",
+                  nl->name, safe_strerror (-errnum),
+                  lookup (nlmsg_str, msg_type),
+                  msg_type, err->msg.nlmsg_seq, err->msg.nlmsg_pid);
+          }
+          /*
+             ret = -1;
+             continue;
+           */
+          *ret = -1;
+          return 1;
+        }
+
+      /* OK we got netlink message. */
+      if (IS_ZEBRA_DEBUG_KERNEL)
+        zlog_debug ("netlink_parse_info: %s type %s(%u), seq=%u, pid=%u",
+                    nl->name, lookup (nlmsg_str, h->nlmsg_type),
+                    h->nlmsg_type, h->nlmsg_seq, h->nlmsg_pid);
+
+      /* skip unsolicited messages originating from command socket */
+      if (nl != &netlink_cmd && h->nlmsg_pid == netlink_cmd.snl.nl_pid)
+        {
           if (IS_ZEBRA_DEBUG_KERNEL)
-            zlog_debug ("netlink_parse_info: %s type %s(%u), seq=%u, pid=%u",
-                       nl->name,
-                       lookup (nlmsg_str, h->nlmsg_type), h->nlmsg_type,
-                       h->nlmsg_seq, h->nlmsg_pid);
+            zlog_debug ("netlink_parse_info: %s packet comes from %s",
+                        netlink_cmd.name, nl->name);
+          continue;
+        }
 
-          /* skip unsolicited messages originating from command socket */
-          if (nl != &netlink_cmd && h->nlmsg_pid == netlink_cmd.snl.nl_pid)
-            {
-              if (IS_ZEBRA_DEBUG_KERNEL)
-                zlog_debug ("netlink_parse_info: %s packet comes from %s",
-                            netlink_cmd.name, nl->name);
-              continue;
-            }
+      error = (*filter) (snl, h);
+      if (error < 0)
+        {
+          zlog (NULL, LOG_ERR, "%s filter function error", nl->name);
+          *ret = error;
+        }
+    }
 
-          error = (*filter) (&snl, h);
-          if (error < 0)
-            {
-              zlog (NULL, LOG_ERR, "%s filter function error", nl->name);
-              ret = error;
-            }
+  /* After error care. */
+  if (msg->msg_flags & MSG_TRUNC)
+    {
+      zlog (NULL, LOG_ERR, "%s error: message truncated", nl->name);
+      return 0;
+    }
+  if (status)
+    {
+      zlog (NULL, LOG_ERR, "%s error: data remnant size %d", nl->name,
+            status);
+      *ret = -1;
+      return 1;
+    }
+  return 0;
+}
+
+/* Receive message from netlink interface and pass those information
+   to the given function. */
+static int
+netlink_parse_info (int (*filter) (struct sockaddr_nl *, struct nlmsghdr *),
+                    struct nlsock *nl)
+{
+  int ret = 0;
+
+  while (1)
+    {
+      struct sockaddr_nl snls[NL_RCV_BATCH];
+      struct iovec iov[NL_RCV_BATCH];
+      struct mmsghdr msgs[NL_RCV_BATCH];
+      int count;
+      int i;
+      int finished = 0;
+      int result = 0;
+
+      memset (msgs, 0, sizeof msgs);
+      for (i = 0; i < nl->batch; i++)
+        {
+          iov[i].iov_base = nl->buf[i];
+          iov[i].iov_len = NL_PKT_BUF_SIZE;
+          msgs[i].msg_hdr.msg_name = &snls[i];
+          msgs[i].msg_hdr.msg_namelen = sizeof snls[i];
+          msgs[i].msg_hdr.msg_iov = &iov[i];
+          msgs[i].msg_hdr.msg_iovlen = 1;
         }
 
-      /* After error care. */
-      if (msg.msg_flags & MSG_TRUNC)
+      /* Reading needs no privileges, the kernel checks them when a
+         request is sent. */
+      count = recvmmsg (nl->sock, msgs, nl->batch, 0, NULL);
+
+      if (count < 0)
         {
-          zlog (NULL, LOG_ERR, "%s error: message truncated", nl->name);
+          if (errno == EINTR)
+            continue;
+          if (errno == EWOULDBLOCK || errno == EAGAIN)
+            break;
+          if (errno == ENOBUFS && nl == &netlink)
+            {
+              netlink_overrun (nl);
+              continue;
+            }
+          zlog (NULL, LOG_ERR, "%s recvmsg overrun: %s",
+	  	nl->name, safe_strerror(errno));
           continue;
         }
-      if (status)
+
+      nl->reads++;
+
+      /* The datagrams are off the socket, so all of them are handled
+         even after one of them ended the reply being read. */
+      for (i = 0; i < count; i++)
         {
-          zlog (NULL, LOG_ERR, "%s error: data remnant size %d", nl->name,
-                status);
-          return -1;
+          int dgram_ret = ret;
+
+          if (netlink_parse_datagram (filter, nl, &snls[i], &msgs[i],
+                                      nl->buf[i], &dgram_ret))
+            {
+              if (! finished)
+                {
+                  finished = 1;
+                  result = dgram_ret;
+                }
+            }
+          else
+            ret = dgram_ret;
         }
+
+      if (finished)
+        return result;
     }
   return ret;
 }
@@ -1938,6 +2068,115 @@ kernel_read (struct thread *thread)
   return 0;
 }
 
+/* Mark the addresses or kernel routes a dump of the given type and
+   family refreshes stale, or clear the marks again. */
+static void
+netlink_stale_mark (int family, int type, int stale)
+{
+  switch (type)
+    {
+    case RTM_GETADDR:
+      connected_mark_stale (family, stale);
+      break;
+    case RTM_GETROUTE:
+      rib_mark_stale (family2afi (family), stale);
+      break;
+    }
+}
+
+/* Remove what a completed dump did not refresh. */
+static void
+netlink_stale_sweep (int family, int type)
+{
+  switch (type)
+    {
+    case RTM_GETADDR:
+      connected_sweep_stale (family);
+      break;
+    case RTM_GETROUTE:
+      rib_sweep_stale (family2afi (family));
+      break;
+    }
+}
+
+/* Replay the kernel's interfaces, addresses and routes through the
+   change handlers after messages were lost.  The addresses and kernel
+   routes are marked stale before each dump, and those the dump did not
+   report are removed once it completed, as the kernel dropped them
+   while messages were lost. */
+static int
+netlink_resync (struct thread *thread)
+{
+  static const struct
+  {
+    int family;
+    int type;
+  } dumps[] =
+  {
+    { AF_PACKET, RTM_GETLINK },
+    { AF_INET,   RTM_GETADDR },
+#ifdef HAVE_IPV6
+    { AF_INET6,  RTM_GETADDR },
+#endif /* HAVE_IPV6 */
+    { AF_INET,   RTM_GETROUTE },
+#ifdef HAVE_IPV6
+    { AF_INET6,  RTM_GETROUTE },
+#endif /* HAVE_IPV6 */
+  };
+  unsigned int i;
+  int flags;
+  int snb_ret;
+
+  netlink_resync_thread = NULL;
+  netlink.resyncs++;
+
+  snb_ret = set_netlink_blocking (&netlink_cmd, &flags);
+  if (snb_ret < 0)
+    zlog (NULL, LOG_WARNING,
+          "%s:%i Warning: Could not set netlink socket to blocking.",
+          __FUNCTION__, __LINE__);
+
+  for (i = 0; i < sizeof dumps / sizeof dumps[0]; i++)
+    {
+      netlink_stale_mark (dumps[i].family, dumps[i].type, 1);
+      if (netlink_request (dumps[i].family, dumps[i].type, &netlink_cmd) < 0)
+        {
+          netlink_stale_mark (dumps[i].family, dumps[i].type, 0);
+          break;
+        }
+      if (netlink_parse_info (netlink_information_fetch, &netlink_cmd) < 0)
+        {
+          zlog (NULL, LOG_WARNING, "%s: resync of %s failed", netlink.name,
+                lookup (nlmsg_str, dumps[i].type));
+          netlink_stale_mark (dumps[i].family, dumps[i].type, 0);
+        }
+      else
+        netlink_stale_sweep (dumps[i].family, dumps[i].type);
+    }
+
+  if (snb_ret == 0)
+    set_netlink_nonblocking (&netlink_cmd, &flags);
+
+  zlog (NULL, LOG_INFO, "%s: resynchronised with the kernel", netlink.name);
+  return 0;
+}
+
+void
+kernel_statistics (struct vty *vty)
+{
+  struct nlsock *nl;
+  struct nlsock *socks[] = { &netlink, &netlink_cmd };
+  unsigned int i;
+
+  for (i = 0; i < sizeof socks / sizeof socks[0]; i++)
+    {
+      nl = socks[i];
+      vty_out (vty, "%s: %lu messages in %lu reads, %lu overruns, "
+               "%lu resyncs%s", nl->name, nl->msgs, nl->reads,
+               nl->overruns, nl->resyncs, VTY_NEWLINE);
+    }
+}
+
 /* Filter out messages from self that occur on listener socket */
 static void netlink_install_filter (int sock)
 {
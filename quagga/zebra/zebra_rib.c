@@ -34,6 +34,8 @@
 #include "workqueue.h"
 #include "prefix.h"
 #include "routemap.h"
+#include "hash.h"
+#include "jhash.h"
 
 #include "zebra/rib.h"
 #include "zebra/rt.h"
@@ -204,6 +206,25 @@ nexthop_free (struct nexthop *nexthop)
   XFREE (MTYPE_NEXTHOP, nexthop);
 }
 
+static void nexthop_group_unlink (struct rib *);
+
+/* Free rib and its nexthops. */
+void
+rib_free (struct rib *rib)
+{
+  struct nexthop *nexthop, *next;
+
+  if (rib->nhg)
+    nexthop_group_unlink (rib);
+
+  for (nexthop = rib->nexthop; nexthop; nexthop = next)
+    {
+      next = nexthop->next;
+      nexthop_free (nexthop);
+    }
+  XFREE (MTYPE_RIB, rib);
+}
+
 struct nexthop *
 nexthop_ifindex_add (struct rib *rib, unsigned int ifindex)
 {
@@ -770,24 +791,15 @@ rib_match_ipv6 (struct in6_addr *addr)
 #define RIB_SYSTEM_ROUTE(R) \
         ((R)->type == ZEBRA_ROUTE_KERNEL || (R)->type == ZEBRA_ROUTE_CONNECT)
 
-/* This function verifies reachability of one given nexthop, which can be
- * numbered or unnumbered, IPv4 or IPv6. The result is unconditionally stored
- * in nexthop->flags field. If the 4th parameter, 'set', is non-zero,
- * nexthop->ifindex will be updated appropriately as well.
- * An existing route map can turn (otherwise active) nexthop into inactive, but
- * not vice versa.
- *
- * The return value is the final value of 'ACTIVE' flag.
+/* Resolve one nexthop, numbered or unnumbered, IPv4 or IPv6, against the
+ * current RIB and store the result in its ACTIVE flag.  Returns the
+ * address family the nexthop belongs to, 0 for interface nexthops.
  */
-
 static int
-nexthop_active_check (struct route_node *rn, struct rib *rib,
-		      struct nexthop *nexthop, int set)
+nexthop_active_resolve (struct rib *rib, struct nexthop *nexthop, int set,
+			struct route_node *top)
 {
   struct interface *ifp;
-  route_map_result_t ret = RMAP_MATCH;
-  extern char *proto_rm[AFI_MAX][ZEBRA_ROUTE_MAX+1];
-  struct route_map *rmap;
   int family;
 
   family = 0;
@@ -820,7 +832,7 @@ nexthop_active_check (struct route_node *rn, struct rib *rib,
     case NEXTHOP_TYPE_IPV4:
     case NEXTHOP_TYPE_IPV4_IFINDEX:
       family = AFI_IP;
-      if (nexthop_active_ipv4 (rib, nexthop, set, rn))
+      if (nexthop_active_ipv4 (rib, nexthop, set, top))
 	SET_FLAG (nexthop->flags, NEXTHOP_FLAG_ACTIVE);
       else
 	UNSET_FLAG (nexthop->flags, NEXTHOP_FLAG_ACTIVE);
@@ -828,7 +840,7 @@ nexthop_active_check (struct route_node *rn, struct rib *rib,
 #ifdef HAVE_IPV6
     case NEXTHOP_TYPE_IPV6:
       family = AFI_IP6;
-      if (nexthop_active_ipv6 (rib, nexthop, set, rn))
+      if (nexthop_active_ipv6 (rib, nexthop, set, top))
 	SET_FLAG (nexthop->flags, NEXTHOP_FLAG_ACTIVE);
       else
 	UNSET_FLAG (nexthop->flags, NEXTHOP_FLAG_ACTIVE);
@@ -845,7 +857,7 @@ nexthop_active_check (struct route_node *rn, struct rib *rib,
 	}
       else
 	{
-	  if (nexthop_active_ipv6 (rib, nexthop, set, rn))
+	  if (nexthop_active_ipv6 (rib, nexthop, set, top))
 	    SET_FLAG (nexthop->flags, NEXTHOP_FLAG_ACTIVE);
 	  else
 	    UNSET_FLAG (nexthop->flags, NEXTHOP_FLAG_ACTIVE);
@@ -858,6 +870,29 @@ nexthop_active_check (struct route_node *rn, struct rib *rib,
     default:
       break;
     }
+  return family;
+}
+
+/* This function verifies reachability of one given nexthop, which can be
+ * numbered or unnumbered, IPv4 or IPv6. The result is unconditionally stored
+ * in nexthop->flags field. If the 4th parameter, 'set', is non-zero,
+ * nexthop->ifindex will be updated appropriately as well.
+ * An existing route map can turn (otherwise active) nexthop into inactive, but
+ * not vice versa.
+ *
+ * The return value is the final value of 'ACTIVE' flag.
+ */
+
+static int
+nexthop_active_check (struct route_node *rn, struct rib *rib,
+		      struct nexthop *nexthop, int set)
+{
+  route_map_result_t ret = RMAP_MATCH;
+  extern char *proto_rm[AFI_MAX][ZEBRA_ROUTE_MAX+1];
+  struct route_map *rmap;
+  int family;
+
+  family = nexthop_active_resolve (rib, nexthop, set, rn);
   if (! CHECK_FLAG (nexthop->flags, NEXTHOP_FLAG_ACTIVE))
     return 0;
 
@@ -881,6 +916,903 @@ nexthop_active_check (struct route_node *rn, struct rib *rib,
   return CHECK_FLAG (nexthop->flags, NEXTHOP_FLAG_ACTIVE);
 }
 
+/* Shared nexthop groups.
+ *
+ * Protocol routes are interned into nexthop groups when linked to their
+ * route_node (see rib_link), so that e.g. a full BGP table through a
+ * couple of upstreams keeps a couple of nexthop lists.  Resolution
+ * state is kept in the group and recomputed at most once per RIB
+ * generation; the generation is bumped whenever the FIB changes in a
+ * way that can affect recursive resolution.  A revalidation event then
+ * re-resolves every group once and queues the route_nodes of groups
+ * whose resolution changed, so the work after an IGP change scales
+ * with the number of groups rather than the number of routes.
+ *
+ * Routes subject to a protocol route-map, or whose nexthop lies within
+ * their own prefix, depend on the prefix for resolution and keep a
+ * private nexthop list.
+ */
+static struct hash *nexthop_group_hash;
+static unsigned long nexthop_group_generation = 1;
+static unsigned long nexthop_group_superseded;
+static unsigned long nexthop_group_ribs;
+static struct list *nexthop_group_pending;
+static struct thread *nexthop_group_thread;
+
+static void rib_queue_add (struct zebra_t *, struct route_node *);
+static int nexthop_group_revalidate (struct thread *);
+
+/* Nexthop tracking.
+ *
+ * Nexthop groups, and route nodes holding RIB entries with private
+ * nexthops, register with the gateways and interfaces their nexthops
+ * depend on.  A FIB change at some prefix then re-evaluates only what
+ * is registered with a gateway inside that prefix, and an interface
+ * event only what is registered with that interface, rather than every
+ * route in the RIB.
+ */
+struct rib_nh_dep
+{
+  /* Gateway host route in rib_nht_table, NULL for interfaces. */
+  struct route_node *rn;
+
+  /* Interface, by index or by name. */
+  unsigned int ifindex;
+  char *ifname;
+
+  /* Dependent nexthop groups and route nodes, as rib_nht_ref. */
+  struct hash *groups;
+  struct hash *nodes;
+};
+
+/* A nexthop group or route node registered with a rib_nh_dep, counted
+   once per registration: several RIB entries with private nexthops on
+   one route node each register it. */
+struct rib_nht_ref
+{
+  void *data;
+  unsigned int refcnt;
+};
+
+/* Initial size of the dependent tables, grown as they fill. */
+#define RIB_NHT_REF_HASH_SIZE 8
+
+static struct route_table *rib_nht_table[AFI_MAX];
+static struct hash *rib_nht_if_hash;
+
+static unsigned int
+rib_nht_if_hash_key (void *arg)
+{
+  struct rib_nh_dep *dep = arg;
+
+  if (dep->ifname)
+    return jhash (dep->ifname, strlen (dep->ifname), 0);
+  return jhash_1word (dep->ifindex, 0);
+}
+
+static int
+rib_nht_if_hash_cmp (void *arg1, void *arg2)
+{
+  struct rib_nh_dep *dep1 = arg1;
+  struct rib_nh_dep *dep2 = arg2;
+
+  if (dep1->ifname || dep2->ifname)
+    return dep1->ifname && dep2->ifname
+	   && strcmp (dep1->ifname, dep2->ifname) == 0;
+  return dep1->ifindex == dep2->ifindex;
+}
+
+static unsigned int
+rib_nht_ref_key (void *arg)
+{
+  struct rib_nht_ref *ref = arg;
+
+  return jhash (&ref->data, sizeof (ref->data), 0);
+}
+
+static int
+rib_nht_ref_cmp (void *arg1, void *arg2)
+{
+  struct rib_nht_ref *ref1 = arg1;
+  struct rib_nht_ref *ref2 = arg2;
+
+  return ref1->data == ref2->data;
+}
+
+static void *
+rib_nht_ref_alloc (void *arg)
+{
+  struct rib_nht_ref *lookup = arg;
+  struct rib_nht_ref *ref;
+
+  ref = XCALLOC (MTYPE_RIB_NHT, sizeof (struct rib_nht_ref));
+  ref->data = lookup->data;
+  return ref;
+}
+
+static struct hash *
+rib_nht_ref_hash (unsigned int size)
+{
+  return hash_create_size (size, rib_nht_ref_key, rib_nht_ref_cmp);
+}
+
+static void
+rib_nht_ref_move (struct hash_backet *backet, void *arg)
+{
+  hash_get ((struct hash *) arg, backet->data, hash_alloc_intern);
+}
+
+/* Take a reference on data in refs.  The table is grown as it fills,
+   so that registering and withdrawing a full table behind a single
+   gateway stays linear. */
+static void
+rib_nht_ref_add (struct hash **refs, void *data)
+{
+  struct rib_nht_ref lookup;
+  struct rib_nht_ref *ref;
+  struct hash *bigger;
+
+  lookup.data = data;
+  ref = hash_get (*refs, &lookup, rib_nht_ref_alloc);
+  ref->refcnt++;
+
+  if ((*refs)->count > (*refs)->size * 2)
+    {
+      bigger = rib_nht_ref_hash ((*refs)->size * 4);
+      hash_iterate (*refs, rib_nht_ref_move, bigger);
+      hash_clean (*refs, NULL);
+      hash_free (*refs);
+      *refs = bigger;
+    }
+}
+
+/* Drop a reference on data, forgetting it with the last one. */
+static void
+rib_nht_ref_del (struct hash *refs, void *data)
+{
+  struct rib_nht_ref lookup;
+  struct rib_nht_ref *ref;
+
+  lookup.data = data;
+  if (! (ref = hash_lookup (refs, &lookup)))
+    return;
+  if (--ref->refcnt)
+    return;
+
+  hash_release (refs, ref);
+  XFREE (MTYPE_RIB_NHT, ref);
+}
+
+static struct rib_nh_dep *
+rib_nht_new (void)
+{
+  struct rib_nh_dep *dep;
+
+  dep = XCALLOC (MTYPE_RIB_NHT, sizeof (struct rib_nh_dep));
+  dep->groups = rib_nht_ref_hash (RIB_NHT_REF_HASH_SIZE);
+  dep->nodes = rib_nht_ref_hash (RIB_NHT_REF_HASH_SIZE);
+  return dep;
+}
+
+static void *
+rib_nht_if_alloc (void *arg)
+{
+  struct rib_nh_dep *lookup = arg;
+  struct rib_nh_dep *dep;
+
+  dep = rib_nht_new ();
+  dep->ifindex = lookup->ifindex;
+  if (lookup->ifname)
+    dep->ifname = XSTRDUP (MTYPE_RIB_NHT, lookup->ifname);
+  return dep;
+}
+
+/* Find the entry for the gateway or interface a nexthop depends on,
+   optionally creating it.  Blackhole nexthops depend on nothing. */
+static struct rib_nh_dep *
+rib_nht_get (struct nexthop *nexthop, int create)
+{
+  struct rib_nh_dep lookup;
+  struct rib_nh_dep *dep;
+  struct route_node *rn;
+  struct prefix p;
+  afi_t afi = AFI_IP;
+
+  memset (&lookup, 0, sizeof (struct rib_nh_dep));
+  memset (&p, 0, sizeof (struct prefix));
+
+  switch (nexthop->type)
+    {
+    case NEXTHOP_TYPE_IPV4:
+    case NEXTHOP_TYPE_IPV4_IFINDEX:
+      p.family = AF_INET;
+      p.prefixlen = IPV4_MAX_PREFIXLEN;
+      p.u.prefix4 = nexthop->gate.ipv4;
+      break;
+#ifdef HAVE_IPV6
+    case NEXTHOP_TYPE_IPV6_IFINDEX:
+      if (IN6_IS_ADDR_LINKLOCAL (&nexthop->gate.ipv6))
+	{
+	  lookup.ifindex = nexthop->ifindex;
+	  break;
+	}
+      /* Fall through. */
+    case NEXTHOP_TYPE_IPV6:
+      afi = AFI_IP6;
+      p.family = AF_INET6;
+      p.prefixlen = IPV6_MAX_PREFIXLEN;
+      p.u.prefix6 = nexthop->gate.ipv6;
+      break;
+#endif /* HAVE_IPV6 */
+    case NEXTHOP_TYPE_IFINDEX:
+      lookup.ifindex = nexthop->ifindex;
+      break;
+    case NEXTHOP_TYPE_IFNAME:
+    case NEXTHOP_TYPE_IPV6_IFNAME:
+      lookup.ifname = nexthop->ifname;
+      break;
+    default:
+      return NULL;
+    }
+
+  if (! p.family)
+    {
+      if (create)
+	return hash_get (rib_nht_if_hash, &lookup, rib_nht_if_alloc);
+      return hash_lookup (rib_nht_if_hash, &lookup);
+    }
+
+  if (! create)
+    {
+      rn = route_node_lookup (rib_nht_table[afi], &p);
+      if (! rn)
+	return NULL;
+      route_unlock_node (rn);
+      return rn->info;
+    }
+
+  rn = route_node_get (rib_nht_table[afi], &p);
+  if (rn->info)
+    {
+      route_unlock_node (rn);
+      return rn->info;
+    }
+
+  /* The entry keeps the lock taken by route_node_get. */
+  dep = rib_nht_new ();
+  dep->rn = rn;
+  rn->info = dep;
+  return dep;
+}
+
+/* Release an entry nothing depends on any more. */
+static void
+rib_nht_put (struct rib_nh_dep *dep)
+{
+  if (dep->groups->count || dep->nodes->count)
+    return;
+
+  hash_free (dep->groups);
+  hash_free (dep->nodes);
+  if (dep->rn)
+    {
+      dep->rn->info = NULL;
+      route_unlock_node (dep->rn);
+    }
+  else
+    {
+      hash_release (rib_nht_if_hash, dep);
+      if (dep->ifname)
+	XFREE (MTYPE_RIB_NHT, dep->ifname);
+    }
+  XFREE (MTYPE_RIB_NHT, dep);
+}
+
+/* Register a nexthop group, or the route node of a RIB entry with
+   private nexthops, as depending on a nexthop. */
+static void
+rib_nht_add (struct nexthop *nexthop, struct nexthop_group *nhg,
+	     struct route_node *rn)
+{
+  struct rib_nh_dep *dep;
+
+  if (! (dep = rib_nht_get (nexthop, 1)))
+    return;
+
+  if (nhg)
+    rib_nht_ref_add (&dep->groups, nhg);
+  else
+    rib_nht_ref_add (&dep->nodes, rn);
+}
+
+static void
+rib_nht_del (struct nexthop *nexthop, struct nexthop_group *nhg,
+	     struct route_node *rn)
+{
+  struct rib_nh_dep *dep;
+
+  if (! (dep = rib_nht_get (nexthop, 0)))
+    return;
+
+  if (nhg)
+    rib_nht_ref_del (dep->groups, nhg);
+  else
+    rib_nht_ref_del (dep->nodes, rn);
+  rib_nht_put (dep);
+}
+
+static void
+rib_nht_track (struct nexthop *nexthop, struct nexthop_group *nhg,
+	       struct route_node *rn, int add)
+{
+  for (; nexthop; nexthop = nexthop->next)
+    if (add)
+      rib_nht_add (nexthop, nhg, rn);
+    else
+      rib_nht_del (nexthop, nhg, rn);
+}
+
+/* Have a group re-resolved from the revalidation event. */
+static void
+nexthop_group_stale (struct nexthop_group *nhg)
+{
+  nhg->generation = 0;
+  if (nhg->pending)
+    return;
+
+  nhg->pending = 1;
+  listnode_add (nexthop_group_pending, nhg);
+  if (! nexthop_group_thread)
+    nexthop_group_thread = thread_add_event (zebrad.master,
+					     nexthop_group_revalidate,
+					     NULL, 0);
+}
+
+static void
+rib_nht_queue_group (struct hash_backet *backet, void *arg)
+{
+  struct rib_nht_ref *ref = backet->data;
+
+  nexthop_group_stale (ref->data);
+}
+
+static void
+rib_nht_queue_node (struct hash_backet *backet, void *arg)
+{
+  struct rib_nht_ref *ref = backet->data;
+
+  rib_queue_add (&zebrad, ref->data);
+}
+
+static void
+rib_nht_queue (struct rib_nh_dep *dep)
+{
+  hash_iterate (dep->groups, rib_nht_queue_group, NULL);
+  hash_iterate (dep->nodes, rib_nht_queue_node, NULL);
+}
+
+/* The FIB changed at a route node, re-evaluate whatever resolves
+   through a gateway covered by its prefix. */
+static void
+rib_nht_changed (struct route_node *rn)
+{
+  struct route_table *table;
+  struct route_node *top;
+  struct route_node *node;
+
+  switch (PREFIX_FAMILY (&rn->p))
+    {
+    case AF_INET:
+      table = rib_nht_table[AFI_IP];
+      break;
+#ifdef HAVE_IPV6
+    case AF_INET6:
+      table = rib_nht_table[AFI_IP6];
+      break;
+#endif /* HAVE_IPV6 */
+    default:
+      return;
+    }
+
+  /* Hold the top of the walk, it may not have an entry of its own. */
+  top = route_node_get (table, &rn->p);
+  route_lock_node (top);
+  for (node = top; node; node = route_next_until (node, top))
+    if (node->info)
+      rib_nht_queue (node->info);
+  route_unlock_node (top);
+}
+
+/* Interface went up or down, re-evaluate whatever depends on it. */
+void
+rib_update_if (struct interface *ifp)
+{
+  struct rib_nh_dep lookup;
+  struct rib_nh_dep *dep;
+
+  memset (&lookup, 0, sizeof (struct rib_nh_dep));
+  lookup.ifindex = ifp->ifindex;
+  if ((dep = hash_lookup (rib_nht_if_hash, &lookup)))
+    rib_nht_queue (dep);
+
+  lookup.ifname = ifp->name;
+  if ((dep = hash_lookup (rib_nht_if_hash, &lookup)))
+    rib_nht_queue (dep);
+}
+
+/* Nexthop types whose ifindex is given by the route's originator rather
+   than set by nexthop resolution. */
+#define NEXTHOP_IFINDEX_FIXED(T) \
+        ((T) == NEXTHOP_TYPE_IFINDEX || (T) == NEXTHOP_TYPE_IPV4_IFINDEX \
+         || (T) == NEXTHOP_TYPE_IPV6_IFINDEX)
+
+static unsigned int
+nexthop_group_make_key (struct nexthop_group *nhg)
+{
+  struct nexthop *nexthop;
+  unsigned int key;
+
+  key = jhash_3words (nhg->family, nhg->type, nhg->flags, 0);
+  for (nexthop = nhg->nexthop; nexthop; nexthop = nexthop->next)
+    {
+      key = jhash_2words (nexthop->type,
+			  NEXTHOP_IFINDEX_FIXED (nexthop->type)
+			  ? nexthop->ifindex : 0, key);
+      key = jhash (&nexthop->gate, sizeof (union g_addr), key);
+      key = jhash (&nexthop->src, sizeof (union g_addr), key);
+      if (nexthop->ifname)
+	key = jhash (nexthop->ifname, strlen (nexthop->ifname), key);
+    }
+  return key;
+}
+
+static unsigned int
+nexthop_group_hash_key (void *arg)
+{
+  struct nexthop_group *nhg = arg;
+
+  return nhg->key;
+}
+
+/* Compare the nexthops as given by the route's originator, ignoring
+   any resolution state. */
+static int
+nexthop_same_config (struct nexthop *a, struct nexthop *b)
+{
+  if (a->type != b->type)
+    return 0;
+  if (NEXTHOP_IFINDEX_FIXED (a->type) && a->ifindex != b->ifindex)
+    return 0;
+  if (memcmp (&a->gate, &b->gate, sizeof (union g_addr))
+      || memcmp (&a->src, &b->src, sizeof (union g_addr)))
+    return 0;
+  if (a->ifname || b->ifname)
+    return a->ifname && b->ifname && strcmp (a->ifname, b->ifname) == 0;
+  return 1;
+}
+
+static int
+nexthop_group_hash_cmp (void *arg1, void *arg2)
+{
+  struct nexthop_group *nhg1 = arg1;
+  struct nexthop_group *nhg2 = arg2;
+  struct nexthop *a, *b;
+
+  if (nhg1->family != nhg2->family
+      || nhg1->type != nhg2->type
+      || nhg1->flags != nhg2->flags)
+    return 0;
+
+  for (a = nhg1->nexthop, b = nhg2->nexthop; a && b; a = a->next, b = b->next)
+    if (! nexthop_same_config (a, b))
+      return 0;
+  return a == NULL && b == NULL;
+}
+
+/* Compare the resolution state of two copies of the same nexthop. */
+static int
+nexthop_same_resolution (struct nexthop *a, struct nexthop *b)
+{
+  u_char mask = NEXTHOP_FLAG_ACTIVE | NEXTHOP_FLAG_RECURSIVE;
+
+  if ((a->flags & mask) != (b->flags & mask) || a->ifindex != b->ifindex)
+    return 0;
+  if (CHECK_FLAG (a->flags, NEXTHOP_FLAG_RECURSIVE)
+      && (a->rtype != b->rtype || a->rifindex != b->rifindex
+	  || memcmp (&a->rgate, &b->rgate, sizeof (union g_addr))))
+    return 0;
+  return 1;
+}
+
+static struct nexthop *
+nexthop_list_copy (struct nexthop *nexthop)
+{
+  struct nexthop *head = NULL, *last = NULL, *new;
+
+  for (; nexthop; nexthop = nexthop->next)
+    {
+      new = XMALLOC (MTYPE_NEXTHOP, sizeof (struct nexthop));
+      memcpy (new, nexthop, sizeof (struct nexthop));
+      if (nexthop->ifname)
+	new->ifname = XSTRDUP (0, nexthop->ifname);
+      new->next = NULL;
+      new->prev = last;
+      if (last)
+	last->next = new;
+      else
+	head = new;
+      last = new;
+    }
+  return head;
+}
+
+static void
+nexthop_list_free (struct nexthop *nexthop)
+{
+  struct nexthop *next;
+
+  for (; nexthop; nexthop = next)
+    {
+      next = nexthop->next;
+      nexthop_free (nexthop);
+    }
+}
+
+static void
+nexthop_list_unset_fib (struct nexthop *nexthop)
+{
+  for (; nexthop; nexthop = nexthop->next)
+    UNSET_FLAG (nexthop->flags, NEXTHOP_FLAG_FIB);
+}
+
+static void *
+nexthop_group_alloc (void *arg)
+{
+  struct nexthop_group *lookup = arg;
+  struct nexthop_group *nhg;
+
+  nhg = XCALLOC (MTYPE_NEXTHOP_GROUP, sizeof (struct nexthop_group));
+  *nhg = *lookup;
+  return nhg;
+}
+
+static void
+nexthop_group_unlock (struct nexthop_group *nhg)
+{
+  assert (nhg->refcnt);
+  if (--nhg->refcnt)
+    return;
+
+  if (nhg->pending)
+    listnode_delete (nexthop_group_pending, nhg);
+
+  if (nhg->successor)
+    {
+      nexthop_group_superseded--;
+      nexthop_group_unlock (nhg->successor);
+    }
+  else
+    {
+      hash_release (nexthop_group_hash, nhg);
+      rib_nht_track (nhg->nexthop, nhg, NULL, 0);
+    }
+
+  nexthop_list_free (nhg->nexthop);
+  XFREE (MTYPE_NEXTHOP_GROUP, nhg);
+}
+
+static void
+nexthop_group_link (struct nexthop_group *nhg, struct rib *rib)
+{
+  rib->nhg = nhg;
+  rib->nexthop = nhg->nexthop;
+  rib->nhg_prev = NULL;
+  rib->nhg_next = nhg->ribs;
+  if (nhg->ribs)
+    nhg->ribs->nhg_prev = rib;
+  nhg->ribs = rib;
+  nhg->refcnt++;
+  nexthop_group_ribs++;
+  if (CHECK_FLAG (rib->status, RIB_ENTRY_INSTALLED))
+    nhg->fib_refcnt++;
+}
+
+static void
+nexthop_group_unlink (struct rib *rib)
+{
+  struct nexthop_group *nhg = rib->nhg;
+
+  if (rib->nhg_next)
+    rib->nhg_next->nhg_prev = rib->nhg_prev;
+  if (rib->nhg_prev)
+    rib->nhg_prev->nhg_next = rib->nhg_next;
+  else
+    nhg->ribs = rib->nhg_next;
+
+  if (CHECK_FLAG (rib->status, RIB_ENTRY_INSTALLED)
+      && --nhg->fib_refcnt == 0)
+    nexthop_list_unset_fib (nhg->nexthop);
+
+  rib->nhg = NULL;
+  rib->nexthop = NULL;
+  rib->nhg_next = rib->nhg_prev = NULL;
+  nexthop_group_ribs--;
+  nexthop_group_unlock (nhg);
+}
+
+/* Does a protocol route-map apply to routes of this type? */
+static int
+nexthop_group_rmap (int type)
+{
+  extern char *proto_rm[AFI_MAX][ZEBRA_ROUTE_MAX+1];
+  afi_t afi;
+
+  for (afi = AFI_IP; afi < AFI_MAX; afi++)
+    if (proto_rm[afi][ZEBRA_ROUTE_MAX]
+	|| (type >= 0 && type < ZEBRA_ROUTE_MAX && proto_rm[afi][type]))
+      return 1;
+  return 0;
+}
+
+/* Can the nexthops of this RIB entry be resolved independently of the
+   prefix they are attached to? */
+static int
+nexthop_group_shareable (struct route_node *rn, struct rib *rib)
+{
+  struct nexthop *nexthop;
+  struct prefix p;
+
+  if (RIB_SYSTEM_ROUTE (rib) || rib->type == ZEBRA_ROUTE_STATIC
+      || ! rib->nexthop || nexthop_group_rmap (rib->type))
+    return 0;
+
+  /* Nexthops lying within the route's own prefix must not resolve
+     through it, which makes their resolution prefix-dependent. */
+  for (nexthop = rib->nexthop; nexthop; nexthop = nexthop->next)
+    {
+      memset (&p, 0, sizeof (struct prefix));
+      switch (nexthop->type)
+	{
+	case NEXTHOP_TYPE_IPV4:
+	case NEXTHOP_TYPE_IPV4_IFINDEX:
+	  p.family = AF_INET;
+	  p.prefixlen = IPV4_MAX_PREFIXLEN;
+	  p.u.prefix4 = nexthop->gate.ipv4;
+	  break;
+#ifdef HAVE_IPV6
+	case NEXTHOP_TYPE_IPV6:
+	case NEXTHOP_TYPE_IPV6_IFINDEX:
+	  p.family = AF_INET6;
+	  p.prefixlen = IPV6_MAX_PREFIXLEN;
+	  p.u.prefix6 = nexthop->gate.ipv6;
+	  break;
+#endif /* HAVE_IPV6 */
+	default:
+	  continue;
+	}
+      if (prefix_match (&rn->p, &p))
+	return 0;
+    }
+  return 1;
+}
+
+/* Replace the private nexthop list of a RIB entry by the shared group
+   holding the same nexthops, creating the group if necessary. */
+static void
+nexthop_group_intern (struct route_node *rn, struct rib *rib)
+{
+  struct nexthop_group lookup;
+  struct nexthop_group *nhg;
+
+  if (rib->nhg || ! nexthop_group_shareable (rn, rib))
+    return;
+
+  memset (&lookup, 0, sizeof (struct nexthop_group));
+  lookup.nexthop = rib->nexthop;
+  lookup.nexthop_num = rib->nexthop_num;
+  lookup.family = rn->p.family;
+  lookup.type = rib->type;
+  lookup.flags = rib->flags & ZEBRA_FLAG_INTERNAL;
+  lookup.key = nexthop_group_make_key (&lookup);
+
+  nhg = hash_get (nexthop_group_hash, &lookup, nexthop_group_alloc);
+  if (nhg->nexthop != rib->nexthop)
+    nexthop_list_free (rib->nexthop);
+  else
+    rib_nht_track (nhg->nexthop, nhg, NULL, 1);
+
+  nexthop_group_link (nhg, rib);
+}
+
+/* Give a RIB entry a private copy of its nexthops, e.g. before they are
+   modified on its behalf only. */
+static void
+nexthop_group_unshare (struct rib *rib)
+{
+  struct nexthop *copy;
+
+  if (! rib->nhg)
+    return;
+
+  copy = nexthop_list_copy (rib->nexthop);
+  nexthop_group_unlink (rib);
+  rib->nexthop = copy;
+  rib_nht_track (rib->nexthop, NULL, rib->rn, 1);
+}
+
+/* Queue the route_nodes of all RIB entries using a group. */
+static void
+nexthop_group_queue (struct nexthop_group *nhg)
+{
+  struct rib *rib;
+
+  for (rib = nhg->ribs; rib; rib = rib->nhg_next)
+    if (! CHECK_FLAG (rib->status, RIB_ENTRY_REMOVED))
+      rib_queue_add (&zebrad, rib->rn);
+}
+
+/* Resolve a list of nexthops in the context of a group, returning the
+   number of active nexthops. */
+static int
+nexthop_group_resolve_list (struct nexthop_group *nhg,
+			    struct nexthop *nexthop)
+{
+  struct rib rib;
+  int active = 0;
+
+  /* Resolution only looks at the type and flags of the route. */
+  memset (&rib, 0, sizeof (struct rib));
+  rib.type = nhg->type;
+  rib.flags = nhg->flags;
+
+  for (; nexthop; nexthop = nexthop->next)
+    {
+      nexthop_active_resolve (&rib, nexthop, 1, NULL);
+      if (CHECK_FLAG (nexthop->flags, NEXTHOP_FLAG_ACTIVE))
+	active++;
+    }
+  return active;
+}
+
+/* Copy the resolution state of a nexthop over another copy of it. */
+static void
+nexthop_copy_resolution (struct nexthop *to, struct nexthop *from)
+{
+  u_char mask = NEXTHOP_FLAG_ACTIVE | NEXTHOP_FLAG_RECURSIVE;
+
+  to->flags = (to->flags & ~mask) | (from->flags & mask);
+  to->ifindex = from->ifindex;
+  to->rtype = from->rtype;
+  to->rifindex = from->rifindex;
+  to->rgate = from->rgate;
+}
+
+/* Bring a group up to date with the current RIB generation and return
+   the group now current for its nexthops.  That is a new group if the
+   resolution changed while RIB entries were installed in the kernel
+   with the old state.  RIB entries of a changed group are queued. */
+static struct nexthop_group *
+nexthop_group_resolve (struct nexthop_group *nhg)
+{
+  struct nexthop_group *new;
+  struct nexthop *copy, *a, *b;
+  int active;
+
+  while (nhg->successor)
+    nhg = nhg->successor;
+
+  if (nhg->generation == nexthop_group_generation)
+    return nhg;
+  nhg->generation = nexthop_group_generation;
+
+  copy = nexthop_list_copy (nhg->nexthop);
+  active = nexthop_group_resolve_list (nhg, copy);
+
+  for (a = nhg->nexthop, b = copy; a && b; a = a->next, b = b->next)
+    if (! nexthop_same_resolution (a, b))
+      break;
+  if (! a)
+    {
+      nexthop_list_free (copy);
+      return nhg;
+    }
+
+  /* Nothing in the kernel depends on the old state, update in place. */
+  if (! nhg->fib_refcnt)
+    {
+      for (a = nhg->nexthop, b = copy; a && b; a = a->next, b = b->next)
+	nexthop_copy_resolution (a, b);
+      nexthop_list_free (copy);
+      nhg->nexthop_active_num = active;
+      nexthop_group_queue (nhg);
+      return nhg;
+    }
+
+  nexthop_list_unset_fib (copy);
+  new = XCALLOC (MTYPE_NEXTHOP_GROUP, sizeof (struct nexthop_group));
+  new->nexthop = copy;
+  new->nexthop_num = nhg->nexthop_num;
+  new->nexthop_active_num = active;
+  new->family = nhg->family;
+  new->flags = nhg->flags;
+  new->type = nhg->type;
+  new->key = nhg->key;
+  new->generation = nhg->generation;
+
+  /* The superseded group keeps the new one alive until its own RIB
+     entries have moved over. */
+  hash_release (nexthop_group_hash, nhg);
+  hash_get (nexthop_group_hash, new, hash_alloc_intern);
+  rib_nht_track (nhg->nexthop, nhg, NULL, 0);
+  rib_nht_track (new->nexthop, new, NULL, 1);
+  nhg->successor = new;
+  new->refcnt++;
+  nexthop_group_superseded++;
+
+  nexthop_group_queue (nhg);
+  return new;
+}
+
+/* Move a RIB entry over to the current group for its nexthops. */
+static void
+nexthop_group_move (struct rib *rib, struct nexthop_group *nhg)
+{
+  nhg->refcnt++;
+  nexthop_group_unlink (rib);
+  nexthop_group_link (nhg, rib);
+  nexthop_group_unlock (nhg);
+}
+
+/* Refresh the nexthops of a RIB entry using a shared group.  RIB entries
+   installed in the kernel stay on a superseded group until 'set' is
+   given, i.e. until they have been withdrawn. */
+static int
+nexthop_group_update (struct rib *rib, int set)
+{
+  struct nexthop_group *nhg;
+
+  UNSET_FLAG (rib->flags, ZEBRA_FLAG_CHANGED);
+
+  nhg = nexthop_group_resolve (rib->nhg);
+  if (nhg != rib->nhg)
+    {
+      SET_FLAG (rib->flags, ZEBRA_FLAG_CHANGED);
+      if (set || ! CHECK_FLAG (rib->status, RIB_ENTRY_INSTALLED))
+	nexthop_group_move (rib, nhg);
+    }
+
+  rib->nexthop_active_num = nhg->nexthop_active_num;
+  return rib->nexthop_active_num;
+}
+
+/* Re-resolve the groups depending on what changed in the FIB. */
+static int
+nexthop_group_revalidate (struct thread *thread)
+{
+  struct nexthop_group *nhg;
+
+  nexthop_group_thread = NULL;
+
+  while ((nhg = listnode_head (nexthop_group_pending)))
+    {
+      list_delete_node (nexthop_group_pending,
+			listhead (nexthop_group_pending));
+      nhg->pending = 0;
+      nexthop_group_resolve (nhg);
+    }
+
+  return 0;
+}
+
+void
+nexthop_group_count (unsigned long *groups, unsigned long *ribs,
+		     unsigned long *superseded)
+{
+  *groups = nexthop_group_hash->count;
+  *ribs = nexthop_group_ribs;
+  *superseded = nexthop_group_superseded;
+}
+
 /* Iterate over all nexthops of the given RIB entry and refresh their
  * ACTIVE flag. rib->nexthop_active_num is updated accordingly. If any
  * nexthop is found to toggle the ACTIVE flag, the whole rib structure
@@ -896,6 +1828,15 @@ nexthop_active_update (struct route_node *rn, struct rib *rib, int set)
   struct nexthop *nexthop;
   int prev_active, new_active;
 
+  if (rib->nhg)
+    {
+      if (! nexthop_group_rmap (rib->type))
+	return nexthop_group_update (rib, set);
+
+      /* A route-map was configured since the entry was interned. */
+      nexthop_group_unshare (rib);
+    }
+
   rib->nexthop_active_num = 0;
   UNSET_FLAG (rib->flags, ZEBRA_FLAG_CHANGED);
 
@@ -933,8 +1874,16 @@ rib_install_kernel (struct route_node *rn, struct rib *rib)
   /* This condition is never met, if we are using rt_socket.c */
   if (ret < 0)
     {
-      for (nexthop = rib->nexthop; nexthop; nexthop = nexthop->next)
-	UNSET_FLAG (nexthop->flags, NEXTHOP_FLAG_FIB);
+      /* Shared nexthops stay flagged for the other installed users. */
+      if (! rib->nhg || ! rib->nhg->fib_refcnt)
+	for (nexthop = rib->nexthop; nexthop; nexthop = nexthop->next)
+	  UNSET_FLAG (nexthop->flags, NEXTHOP_FLAG_FIB);
+    }
+  else if (! CHECK_FLAG (rib->status, RIB_ENTRY_INSTALLED))
+    {
+      SET_FLAG (rib->status, RIB_ENTRY_INSTALLED);
+      if (rib->nhg)
+	rib->nhg->fib_refcnt++;
     }
 }
 
@@ -959,8 +1908,16 @@ rib_uninstall_kernel (struct route_node *rn, struct rib *rib)
 #endif /* HAVE_IPV6 */
     }
 
-  for (nexthop = rib->nexthop; nexthop; nexthop = nexthop->next)
-    UNSET_FLAG (nexthop->flags, NEXTHOP_FLAG_FIB);
+  if (CHECK_FLAG (rib->status, RIB_ENTRY_INSTALLED))
+    {
+      UNSET_FLAG (rib->status, RIB_ENTRY_INSTALLED);
+      if (rib->nhg)
+	rib->nhg->fib_refcnt--;
+    }
+
+  if (! rib->nhg || ! rib->nhg->fib_refcnt)
+    for (nexthop = rib->nexthop; nexthop; nexthop = nexthop->next)
+      UNSET_FLAG (nexthop->flags, NEXTHOP_FLAG_FIB);
 
   return ret;
 }
@@ -1106,6 +2063,9 @@ rib_process (struct route_node *rn)
           if (! RIB_SYSTEM_ROUTE (select))
             rib_install_kernel (rn, select);
           redistribute_add (&rn->p, select);
+
+          if (select->type != ZEBRA_ROUTE_BGP)
+            rib_nht_changed (rn);
         }
       else if (! RIB_SYSTEM_ROUTE (select))
         {
@@ -1116,12 +2076,15 @@ rib_process (struct route_node *rn)
              This makes sure the routes are IN the kernel.
            */
 
-          for (nexthop = select->nexthop; nexthop; nexthop = nexthop->next)
-            if (CHECK_FLAG (nexthop->flags, NEXTHOP_FLAG_FIB))
-            {
-              installed = 1;
-              break;
-            }
+          if (select->nhg)
+            installed = CHECK_FLAG (select->status, RIB_ENTRY_INSTALLED);
+          else
+            for (nexthop = select->nexthop; nexthop; nexthop = nexthop->next)
+              if (CHECK_FLAG (nexthop->flags, NEXTHOP_FLAG_FIB))
+              {
+                installed = 1;
+                break;
+              }
           if (! installed) 
             rib_install_kernel (rn, select);
         }
@@ -1164,6 +2127,13 @@ rib_process (struct route_node *rn)
       redistribute_add (&rn->p, select);
     }
 
+  /* Recursive nexthops skip over BGP routes, so only a change involving
+   * other route types can affect their resolution.
+   */
+  if ((fib && fib->type != ZEBRA_ROUTE_BGP)
+      || (select && select->type != ZEBRA_ROUTE_BGP))
+    rib_nht_changed (rn);
+
   /* FIB route was removed, should be deleted */
   if (del)
     {
@@ -1436,6 +2406,10 @@ rib_link (struct route_node *rn, struct rib *rib)
     }
   rib->next = head;
   rn->info = rib;
+  rib->rn = rn;
+  nexthop_group_intern (rn, rib);
+  if (! rib->nhg)
+    rib_nht_track (rib->nexthop, NULL, rn, 1);
   rib_queue_add (&zebrad, rn);
 }
 
@@ -1463,7 +2437,6 @@ rib_addnode (struct route_node *rn, struct rib *rib)
 static void
 rib_unlink (struct route_node *rn, struct rib *rib)
 {
-  struct nexthop *nexthop, *next;
   char buf[INET6_ADDRSTRLEN];
 
   assert (rn && rib);
@@ -1494,12 +2467,9 @@ rib_unlink (struct route_node *rn, struct rib *rib)
     }
 
   /* free RIB and nexthops */
-  for (nexthop = rib->nexthop; nexthop; nexthop = next)
-    {
-      next = nexthop->next;
-      nexthop_free (nexthop);
-    }
-  XFREE (MTYPE_RIB, rib);
+  if (! rib->nhg)
+    rib_nht_track (rib->nexthop, NULL, rn, 0);
+  rib_free (rib);
 
   route_unlock_node (rn); /* rn route table reference */
 }
@@ -1939,6 +2909,8 @@ rib_delete_ipv4 (int type, int flags, struct prefix_ipv4 *p,
       if (fib && type == ZEBRA_ROUTE_KERNEL)
 	{
 	  /* Unset flags. */
+	  nexthop_group_unshare (fib);
+	  UNSET_FLAG (fib->status, RIB_ENTRY_INSTALLED);
 	  for (nexthop = fib->nexthop; nexthop; nexthop = nexthop->next)
 	    UNSET_FLAG (nexthop->flags, NEXTHOP_FLAG_FIB);
 
@@ -2003,6 +2975,7 @@ static_install_ipv4 (struct prefix *p, struct static_ipv4 *si)
       /* Same distance static route is there.  Update it with new
          nexthop. */
       route_unlock_node (rn);
+      rib_nht_track (rib->nexthop, NULL, rn, 0);
       switch (si->type)
         {
           case STATIC_IPV4_GATEWAY:
@@ -2015,6 +2988,7 @@ static_install_ipv4 (struct prefix *p, struct static_ipv4 *si)
             nexthop_blackhole_add (rib);
             break;
         }
+      rib_nht_track (rib->nexthop, NULL, rn, 1);
       rib_queue_add (&zebrad, rn);
     }
   else
@@ -2118,6 +3092,7 @@ static_uninstall_ipv4 (struct prefix *p, struct static_ipv4 *si)
     {
       if (CHECK_FLAG (nexthop->flags, NEXTHOP_FLAG_FIB))
         rib_uninstall (rn, rib);
+      rib_nht_del (nexthop, NULL, rn);
       nexthop_delete (rib, nexthop);
       nexthop_free (nexthop);
       rib_queue_add (&zebrad, rn);
@@ -2488,6 +3463,8 @@ rib_delete_ipv6 (int type, int flags, struct prefix_ipv6 *p,
       if (fib && type == ZEBRA_ROUTE_KERNEL)
 	{
 	  /* Unset flags. */
+	  nexthop_group_unshare (fib);
+	  UNSET_FLAG (fib->status, RIB_ENTRY_INSTALLED);
 	  for (nexthop = fib->nexthop; nexthop; nexthop = nexthop->next)
 	    UNSET_FLAG (nexthop->flags, NEXTHOP_FLAG_FIB);
 
@@ -2553,6 +3530,7 @@ static_install_ipv6 (struct prefix *p, struct static_ipv6 *si)
          nexthop. */
       route_unlock_node (rn);
 
+      rib_nht_track (rib->nexthop, NULL, rn, 0);
       switch (si->type)
 	{
 	case STATIC_IPV6_GATEWAY:
@@ -2565,6 +3543,7 @@ static_install_ipv6 (struct prefix *p, struct static_ipv6 *si)
 	  nexthop_ipv6_ifname_add (rib, &si->ipv6, si->ifname);
 	  break;
 	}
+      rib_nht_track (rib->nexthop, NULL, rn, 1);
       rib_queue_add (&zebrad, rn);
     }
   else
@@ -2671,6 +3650,7 @@ static_uninstall_ipv6 (struct prefix *p, struct static_ipv6 *si)
     {
       if (CHECK_FLAG (nexthop->flags, NEXTHOP_FLAG_FIB))
         rib_uninstall (rn, rib);
+      rib_nht_del (nexthop, NULL, rn);
       nexthop_delete (rib, nexthop);
       nexthop_free (nexthop);
       rib_queue_add (&zebrad, rn);
@@ -2829,6 +3809,9 @@ rib_update (void)
   struct route_node *rn;
   struct route_table *table;
   
+  /* Every route is queued, no need for group revalidation. */
+  nexthop_group_generation++;
+
   table = vrf_table (AFI_IP, SAFI_UNICAST, 0);
   if (table)
     for (rn = route_top (table); rn; rn = route_next (rn))
@@ -2846,14 +3829,14 @@ rib_update (void)
 static void
 rib_if_up (struct interface *ifp)
 {
-  rib_update ();
+  rib_update_if (ifp);
 }
 
 /* Interface goes down. */
 static void
 rib_if_down (struct interface *ifp)
 {
-  rib_update ();
+  rib_update_if (ifp);
 }
 
 /* Remove all routes which comes from non main table.  */
@@ -2923,6 +3906,59 @@ rib_sweep_route (void)
   rib_sweep_table (vrf_table (AFI_IP6, SAFI_UNICAST, 0));
 }
 
+/* Mark the kernel routes of a family stale, or clear the marks again.
+   Routes the kernel reports afterwards replace the marked entries in
+   rib_add_ipv4/ipv6, so only the ones it no longer has keep the mark. */
+void
+rib_mark_stale (afi_t afi, int stale)
+{
+  struct route_table *table;
+  struct route_node *rn;
+  struct rib *rib;
+
+  table = vrf_table (afi, SAFI_UNICAST, 0);
+  if (! table)
+    return;
+
+  for (rn = route_top (table); rn; rn = route_next (rn))
+    for (rib = rn->info; rib; rib = rib->next)
+      {
+	if (stale && rib->type == ZEBRA_ROUTE_KERNEL
+	    && ! CHECK_FLAG (rib->status, RIB_ENTRY_REMOVED)
+	    && ! CHECK_FLAG (rib->flags, ZEBRA_FLAG_SELFROUTE))
+	  SET_FLAG (rib->status, RIB_ENTRY_STALE);
+	else
+	  UNSET_FLAG (rib->status, RIB_ENTRY_STALE);
+      }
+}
+
+/* Remove the kernel routes of a family still marked stale. */
+void
+rib_sweep_stale (afi_t afi)
+{
+  struct route_table *table;
+  struct route_node *rn;
+  struct rib *rib;
+  struct rib *next;
+
+  table = vrf_table (afi, SAFI_UNICAST, 0);
+  if (! table)
+    return;
+
+  for (rn = route_top (table); rn; rn = route_next (rn))
+    for (rib = rn->info; rib; rib = next)
+      {
+	next = rib->next;
+
+	if (! CHECK_FLAG (rib->status, RIB_ENTRY_STALE))
+	  continue;
+
+	UNSET_FLAG (rib->status, RIB_ENTRY_STALE);
+	if (! CHECK_FLAG (rib->status, RIB_ENTRY_REMOVED))
+	  rib_delnode (rn, rib);
+      }
+}
+
 /* Close RIB and clean up kernel routes. */
 static void
 rib_close_table (struct route_table *table)
@@ -2952,6 +3988,12 @@ rib_close (void)
 void
 rib_init (void)
 {
+  nexthop_group_hash = hash_create (nexthop_group_hash_key,
+				    nexthop_group_hash_cmp);
+  nexthop_group_pending = list_new ();
+  rib_nht_table[AFI_IP] = route_table_init ();
+  rib_nht_table[AFI_IP6] = route_table_init ();
+  rib_nht_if_hash = hash_create (rib_nht_if_hash_key, rib_nht_if_hash_cmp);
   rib_queue_init (&zebrad);
   /* VRF initialization.  */
   vrf_init ();
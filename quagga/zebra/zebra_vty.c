@@ -806,6 +806,79 @@ vty_show_ip_route (struct vty *vty, struct route_node *rn, struct rib *rib)
   "S - static, R - RIP, O - OSPF,%s       I - ISIS, B - BGP, " \
   "> - selected route, * - FIB route%s%s"
 
+#ifdef HAVE_IPV6
+static void vty_show_ipv6_route (struct vty *, struct route_node *,
+				 struct rib *);
+#define SHOW_ROUTE_V6_HEADER "Codes: K - kernel route, C - connected, S - static, R - RIPng, O - OSPFv3,%s       I - ISIS, B - BGP, * - FIB route.%s%s"
+#endif /* HAVE_IPV6 */
+
+/* Cursor of a routing table walk written in slices, see
+   vty_output_start.  The vrf tables are never freed, the node is. */
+struct rib_show_walk
+{
+  afi_t afi;
+
+  /* Next node to show, locked. */
+  struct route_node *rn;
+
+  int first;
+};
+
+static int
+rib_show_walk_run (struct vty *vty, void *arg)
+{
+  struct rib_show_walk *walk = arg;
+  struct rib *rib;
+  int budget = VTY_OUTPUT_SLICE;
+
+  for (; walk->rn && budget > 0; walk->rn = route_next (walk->rn))
+    for (rib = walk->rn->info; rib; rib = rib->next)
+      {
+	if (walk->first)
+	  {
+#ifdef HAVE_IPV6
+	    if (walk->afi == AFI_IP6)
+	      vty_out (vty, SHOW_ROUTE_V6_HEADER, VTY_NEWLINE, VTY_NEWLINE,
+		       VTY_NEWLINE);
+	    else
+#endif /* HAVE_IPV6 */
+	      vty_out (vty, SHOW_ROUTE_V4_HEADER, VTY_NEWLINE, VTY_NEWLINE,
+		       VTY_NEWLINE);
+	    walk->first = 0;
+	  }
+#ifdef HAVE_IPV6
+	if (walk->afi == AFI_IP6)
+	  vty_show_ipv6_route (vty, walk->rn, rib);
+	else
+#endif /* HAVE_IPV6 */
+	  vty_show_ip_route (vty, walk->rn, rib);
+	budget--;
+      }
+  return walk->rn != NULL;
+}
+
+static void
+rib_show_walk_free (struct vty *vty, void *arg)
+{
+  struct rib_show_walk *walk = arg;
+
+  if (walk->rn)
+    route_unlock_node (walk->rn);
+  XFREE (MTYPE_RIB_SHOW_WALK, walk);
+}
+
+static int
+rib_show_walk_start (struct vty *vty, struct route_table *table, afi_t afi)
+{
+  struct rib_show_walk *walk;
+
+  walk = XCALLOC (MTYPE_RIB_SHOW_WALK, sizeof (struct rib_show_walk));
+  walk->afi = afi;
+  walk->rn = route_top (table);
+  walk->first = 1;
+  return vty_output_start (vty, rib_show_walk_run, rib_show_walk_free, walk);
+}
+
 DEFUN (show_ip_route,
        show_ip_route_cmd,
        "show ip route",
@@ -814,27 +887,13 @@ DEFUN (show_ip_route,
        "IP routing table\n")
 {
   struct route_table *table;
-  struct route_node *rn;
-  struct rib *rib;
-  int first = 1;
 
   table = vrf_table (AFI_IP, SAFI_UNICAST, 0);
   if (! table)
     return CMD_SUCCESS;
 
   /* Show all IPv4 routes. */
-  for (rn = route_top (table); rn; rn = route_next (rn))
-    for (rib = rn->info; rib; rib = rib->next)
-      {
-	if (first)
-	  {
-	    vty_out (vty, SHOW_ROUTE_V4_HEADER, VTY_NEWLINE, VTY_NEWLINE,
-		     VTY_NEWLINE);
-	    first = 0;
-	  }
-	vty_show_ip_route (vty, rn, rib);
-      }
-  return CMD_SUCCESS;
+  return rib_show_walk_start (vty, table, AFI_IP);
 }
 
 DEFUN (show_ip_route_prefix_longer,
@@ -1106,6 +1165,26 @@ DEFUN (show_ip_route_summary,
   return CMD_SUCCESS;
 }
 
+/* Show shared nexthop group usage.  */
+DEFUN (show_ip_route_nexthop_groups,
+       show_ip_route_nexthop_groups_cmd,
+       "show ip route nexthop-groups",
+       SHOW_STR
+       IP_STR
+       "IP routing table\n"
+       "Shared nexthop groups\n")
+{
+  unsigned long groups, ribs, superseded;
+
+  nexthop_group_count (&groups, &ribs, &superseded);
+
+  vty_out (vty, "Nexthop groups: %lu, superseded: %lu%s",
+	   groups, superseded, VTY_NEWLINE);
+  vty_out (vty, "Routes using shared nexthops: %lu%s", ribs, VTY_NEWLINE);
+
+  return CMD_SUCCESS;
+}
+
 /* Write IPv4 static route configuration. */
 static int
 static_config_ipv4 (struct vty *vty)
@@ -1734,8 +1813,6 @@ vty_show_ipv6_route (struct vty *vty, struct route_node *rn,
     }
 }
 
-#define SHOW_ROUTE_V6_HEADER "Codes: K - kernel route, C - connected, S - static, R - RIPng, O - OSPFv3,%s       I - ISIS, B - BGP, * - FIB route.%s%s"
-
 DEFUN (show_ipv6_route,
        show_ipv6_route_cmd,
        "show ipv6 route",
@@ -1744,26 +1821,13 @@ DEFUN (show_ipv6_route,
        "IPv6 routing table\n")
 {
   struct route_table *table;
-  struct route_node *rn;
-  struct rib *rib;
-  int first = 1;
 
   table = vrf_table (AFI_IP6, SAFI_UNICAST, 0);
   if (! table)
     return CMD_SUCCESS;
 
   /* Show all IPv6 route. */
-  for (rn = route_top (table); rn; rn = route_next (rn))
-    for (rib = rn->info; rib; rib = rib->next)
-      {
-	if (first)
-	  {
-	    vty_out (vty, SHOW_ROUTE_V6_HEADER, VTY_NEWLINE, VTY_NEWLINE, VTY_NEWLINE);
-	    first = 0;
-	  }
-	vty_show_ipv6_route (vty, rn, rib);
-      }
-  return CMD_SUCCESS;
+  return rib_show_walk_start (vty, table, AFI_IP6);
 }
 
 DEFUN (show_ipv6_route_prefix_longer,
@@ -2082,6 +2146,8 @@ zebra_vty_init (void)
   install_element (ENABLE_NODE, &show_ip_route_prefix_longer_cmd);
   install_element (ENABLE_NODE, &show_ip_route_protocol_cmd);
   install_element (ENABLE_NODE, &show_ip_route_supernets_cmd);
+  install_element (VIEW_NODE, &show_ip_route_nexthop_groups_cmd);
+  install_element (ENABLE_NODE, &show_ip_route_nexthop_groups_cmd);
 
 #if 0
   install_element (VIEW_NODE, &show_ip_route_summary_cmd);
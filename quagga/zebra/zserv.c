@@ -87,18 +87,22 @@ zserv_flush_data(struct thread *thread)
       					 client, client->sock);
       break;
     case BUFFER_EMPTY:
+      /* Client caught up, resume draining queued redistribution. */
+      zebra_redistribute_queue_resume (client);
       break;
     }
   return 0;
 }
 
-static int
-zebra_server_send_message(struct zserv *client)
+/* Write out the given stream to the client, queueing whatever the
+   socket does not take immediately. */
+int
+zebra_server_send_stream (struct zserv *client, struct stream *s)
 {
   if (client->t_suicide)
     return -1;
-  switch (buffer_write(client->wb, client->sock, STREAM_DATA(client->obuf),
-		       stream_get_endp(client->obuf)))
+  switch (buffer_write(client->wb, client->sock, STREAM_DATA(s),
+		       stream_get_endp(s)))
     {
     case BUFFER_ERROR:
       zlog_warn("%s: buffer_write failed to zserv client fd %d, closing",
@@ -121,6 +125,12 @@ zebra_server_send_message(struct zserv *client)
   return 0;
 }
 
+static int
+zebra_server_send_message(struct zserv *client)
+{
+  return zebra_server_send_stream (client, client->obuf);
+}
+
 static void
 zserv_create_header (struct stream *s, uint16_t cmd)
 {
@@ -362,15 +372,25 @@ zsend_interface_update (int cmd, struct zserv *client, struct interface *ifp)
 int
 zsend_route_multipath (int cmd, struct zserv *client, struct prefix *p,
                        struct rib *rib)
+{
+  zserv_encode_route_multipath (cmd, client->obuf, p, rib);
+
+  return zebra_server_send_message(client);
+}
+
+/* Build the message sent by zsend_route_multipath into the given
+   stream, so that it can also be queued for later transmission.
+   Returns the length of the encoded message. */
+int
+zserv_encode_route_multipath (int cmd, struct stream *s, struct prefix *p,
+                              struct rib *rib)
 {
   int psize;
-  struct stream *s;
   struct nexthop *nexthop;
   unsigned long nhnummark = 0, messmark = 0;
   int nhnum = 0;
   u_char zapi_flags = 0;
   
-  s = client->obuf;
   stream_reset (s);
   
   zserv_create_header (s, cmd);
@@ -469,7 +489,7 @@ zsend_route_multipath (int cmd, struct zserv *client, struct prefix *p,
   /* Write packet size. */
   stream_putw_at (s, 0, stream_get_endp (s));
 
-  return zebra_server_send_message(client);
+  return stream_get_endp (s);
 }
 
 #ifdef HAVE_IPV6
@@ -723,43 +743,18 @@ zread_interface_delete (struct zserv *client, u_short length)
   return 0;
 }
 
-/* This function support multiple nexthop. */
-/* 
- * Parse the ZEBRA_IPV4_ROUTE_ADD sent from client. Update rib and
- * add kernel route. 
- */
-static int
-zread_ipv4_add (struct zserv *client, u_short length)
+/* Parse the nexthop, distance and metric fields of a ZEBRA_IPV4_ROUTE_ADD
+   into rib. */
+static void
+zread_ipv4_rib_attr (struct stream *s, u_char message, struct rib *rib)
 {
   int i;
-  struct rib *rib;
-  struct prefix_ipv4 p;
-  u_char message;
   struct in_addr nexthop;
   u_char nexthop_num;
   u_char nexthop_type;
-  struct stream *s;
   unsigned int ifindex;
   u_char ifname_len;
 
-  /* Get input stream.  */
-  s = client->ibuf;
-
-  /* Allocate new rib. */
-  rib = XCALLOC (MTYPE_RIB, sizeof (struct rib));
-  
-  /* Type, flags, message. */
-  rib->type = stream_getc (s);
-  rib->flags = stream_getc (s);
-  message = stream_getc (s); 
-  rib->uptime = time (NULL);
-
-  /* IPv4 prefix. */
-  memset (&p, 0, sizeof (struct prefix_ipv4));
-  p.family = AF_INET;
-  p.prefixlen = stream_getc (s);
-  stream_get (&p.prefix, s, PSIZE (p.prefixlen));
-
   /* Nexthop parse. */
   if (CHECK_FLAG (message, ZAPI_MESSAGE_NEXTHOP))
     {
@@ -800,44 +795,21 @@ zread_ipv4_add (struct zserv *client, u_short length)
   /* Metric. */
   if (CHECK_FLAG (message, ZAPI_MESSAGE_METRIC))
     rib->metric = stream_getl (s);
-    
-  /* Table */
-  rib->table=zebrad.rtm_table_default;
-  rib_add_ipv4_multipath (&p, rib);
-  return 0;
 }
 
-/* Zebra server IPv4 prefix delete function. */
-static int
-zread_ipv4_delete (struct zserv *client, u_short length)
+/* Parse the nexthop, distance and metric fields of a
+   ZEBRA_IPV4_ROUTE_DELETE.  Only the last nexthop and ifindex are kept. */
+static void
+zread_ipv4_delete_attr (struct stream *s, struct zapi_ipv4 *api,
+			struct in_addr *nexthop, unsigned long *ifindex)
 {
   int i;
-  struct stream *s;
-  struct zapi_ipv4 api;
-  struct in_addr nexthop;
-  unsigned long ifindex;
-  struct prefix_ipv4 p;
   u_char nexthop_num;
   u_char nexthop_type;
   u_char ifname_len;
-  
-  s = client->ibuf;
-  ifindex = 0;
-  nexthop.s_addr = 0;
-
-  /* Type, flags, message. */
-  api.type = stream_getc (s);
-  api.flags = stream_getc (s);
-  api.message = stream_getc (s);
-
-  /* IPv4 prefix. */
-  memset (&p, 0, sizeof (struct prefix_ipv4));
-  p.family = AF_INET;
-  p.prefixlen = stream_getc (s);
-  stream_get (&p.prefix, s, PSIZE (p.prefixlen));
 
   /* Nexthop, ifindex, distance, metric. */
-  if (CHECK_FLAG (api.message, ZAPI_MESSAGE_NEXTHOP))
+  if (CHECK_FLAG (api->message, ZAPI_MESSAGE_NEXTHOP))
     {
       nexthop_num = stream_getc (s);
 
@@ -848,14 +820,14 @@ zread_ipv4_delete (struct zserv *client, u_short length)
 	  switch (nexthop_type)
 	    {
 	    case ZEBRA_NEXTHOP_IFINDEX:
-	      ifindex = stream_getl (s);
+	      *ifindex = stream_getl (s);
 	      break;
 	    case ZEBRA_NEXTHOP_IFNAME:
 	      ifname_len = stream_getc (s);
 	      stream_forward_getp (s, ifname_len);
 	      break;
 	    case ZEBRA_NEXTHOP_IPV4:
-	      nexthop.s_addr = stream_get_ipv4 (s);
+	      nexthop->s_addr = stream_get_ipv4 (s);
 	      break;
 	    case ZEBRA_NEXTHOP_IPV6:
 	      stream_forward_getp (s, IPV6_MAX_BYTELEN);
@@ -865,22 +837,196 @@ zread_ipv4_delete (struct zserv *client, u_short length)
     }
 
   /* Distance. */
-  if (CHECK_FLAG (api.message, ZAPI_MESSAGE_DISTANCE))
-    api.distance = stream_getc (s);
+  if (CHECK_FLAG (api->message, ZAPI_MESSAGE_DISTANCE))
+    api->distance = stream_getc (s);
   else
-    api.distance = 0;
+    api->distance = 0;
 
   /* Metric. */
-  if (CHECK_FLAG (api.message, ZAPI_MESSAGE_METRIC))
-    api.metric = stream_getl (s);
+  if (CHECK_FLAG (api->message, ZAPI_MESSAGE_METRIC))
+    api->metric = stream_getl (s);
   else
-    api.metric = 0;
+    api->metric = 0;
+}
+
+/* Read a prefix entry of a route message.  Returns -1 if it is
+   malformed. */
+static int
+zread_prefix (struct stream *s, struct prefix *p, int family)
+{
+  memset (p, 0, sizeof (struct prefix));
+  p->family = family;
+  p->prefixlen = stream_getc (s);
+  if (p->prefixlen > prefix_blen (p) * 8)
+    return -1;
+  stream_get (&p->u.prefix, s, PSIZE (p->prefixlen));
+  return 0;
+}
+
+/* This function support multiple nexthop. */
+/* 
+ * Parse the ZEBRA_IPV4_ROUTE_ADD sent from client. Update rib and
+ * add kernel route. 
+ */
+static int
+zread_ipv4_add (struct zserv *client, u_short length)
+{
+  struct rib *rib;
+  struct prefix_ipv4 p;
+  u_char message;
+  struct stream *s;
+
+  /* Get input stream.  */
+  s = client->ibuf;
+
+  /* Allocate new rib. */
+  rib = XCALLOC (MTYPE_RIB, sizeof (struct rib));
+  
+  /* Type, flags, message. */
+  rib->type = stream_getc (s);
+  rib->flags = stream_getc (s);
+  message = stream_getc (s); 
+  rib->uptime = time (NULL);
+
+  /* IPv4 prefix. */
+  memset (&p, 0, sizeof (struct prefix_ipv4));
+  p.family = AF_INET;
+  p.prefixlen = stream_getc (s);
+  stream_get (&p.prefix, s, PSIZE (p.prefixlen));
+
+  /* Nexthop, distance and metric. */
+  zread_ipv4_rib_attr (s, message, rib);
+    
+  /* Table */
+  rib->table=zebrad.rtm_table_default;
+  rib_add_ipv4_multipath (&p, rib);
+  return 0;
+}
+
+/*
+ * Parse a ZEBRA_IPV4_ROUTE_ADD_BULK, which carries many prefixes sharing
+ * the type, flags, nexthops, distance and metric, and add a rib for each.
+ */
+static int
+zread_ipv4_add_bulk (struct zserv *client, u_short length)
+{
+  struct rib *rib;
+  struct prefix p;
+  u_char type, flags, message;
+  u_int16_t count, i;
+  size_t attr, pfx;
+  struct stream *s;
+  time_t now;
+
+  s = client->ibuf;
+
+  type = stream_getc (s);
+  flags = stream_getc (s);
+  message = stream_getc (s);
+  count = stream_getw (s);
+  now = time (NULL);
+
+  /* The shared attributes are parsed again for every prefix, the
+     resulting nexthops are interned when the rib is linked. */
+  attr = stream_get_getp (s);
+  pfx = 0;
+
+  for (i = 0; i < count; i++)
+    {
+      rib = XCALLOC (MTYPE_RIB, sizeof (struct rib));
+      rib->type = type;
+      rib->flags = flags;
+      rib->uptime = now;
+
+      stream_set_getp (s, attr);
+      zread_ipv4_rib_attr (s, message, rib);
+      if (i)
+	stream_set_getp (s, pfx);
+
+      if (zread_prefix (s, &p, AF_INET) < 0)
+	{
+	  zlog_warn ("%s: bad prefix length %d from client fd %d", __func__,
+		     p.prefixlen, client->sock);
+	  rib_free (rib);
+	  return -1;
+	}
+      pfx = stream_get_getp (s);
+
+      rib->table = zebrad.rtm_table_default;
+      rib_add_ipv4_multipath ((struct prefix_ipv4 *) &p, rib);
+    }
+  return 0;
+}
+
+/* Zebra server IPv4 prefix delete function. */
+static int
+zread_ipv4_delete (struct zserv *client, u_short length)
+{
+  struct stream *s;
+  struct zapi_ipv4 api;
+  struct in_addr nexthop;
+  unsigned long ifindex;
+  struct prefix_ipv4 p;
+  
+  s = client->ibuf;
+  ifindex = 0;
+  nexthop.s_addr = 0;
+
+  /* Type, flags, message. */
+  api.type = stream_getc (s);
+  api.flags = stream_getc (s);
+  api.message = stream_getc (s);
+
+  /* IPv4 prefix. */
+  memset (&p, 0, sizeof (struct prefix_ipv4));
+  p.family = AF_INET;
+  p.prefixlen = stream_getc (s);
+  stream_get (&p.prefix, s, PSIZE (p.prefixlen));
+
+  /* Nexthop, ifindex, distance, metric. */
+  zread_ipv4_delete_attr (s, &api, &nexthop, &ifindex);
     
   rib_delete_ipv4 (api.type, api.flags, &p, &nexthop, ifindex,
 		   client->rtm_table);
   return 0;
 }
 
+/* Zebra server IPv4 bulk prefix delete function. */
+static int
+zread_ipv4_delete_bulk (struct zserv *client, u_short length)
+{
+  struct stream *s;
+  struct zapi_ipv4 api;
+  struct in_addr nexthop;
+  unsigned long ifindex;
+  struct prefix p;
+  u_int16_t count, i;
+
+  s = client->ibuf;
+  ifindex = 0;
+  nexthop.s_addr = 0;
+
+  api.type = stream_getc (s);
+  api.flags = stream_getc (s);
+  api.message = stream_getc (s);
+  count = stream_getw (s);
+
+  zread_ipv4_delete_attr (s, &api, &nexthop, &ifindex);
+
+  for (i = 0; i < count; i++)
+    {
+      if (zread_prefix (s, &p, AF_INET) < 0)
+	{
+	  zlog_warn ("%s: bad prefix length %d from client fd %d", __func__,
+		     p.prefixlen, client->sock);
+	  return -1;
+	}
+      rib_delete_ipv4 (api.type, api.flags, (struct prefix_ipv4 *) &p,
+		       &nexthop, ifindex, client->rtm_table);
+    }
+  return 0;
+}
+
 /* Nexthop lookup for IPv4. */
 static int
 zread_ipv4_nexthop_lookup (struct zserv *client, u_short length)
@@ -905,78 +1051,65 @@ zread_ipv4_import_lookup (struct zserv *client, u_short length)
 }
 
 #ifdef HAVE_IPV6
-/* Zebra server IPv6 prefix add function. */
-static int
-zread_ipv6_add (struct zserv *client, u_short length)
+/* Parse the nexthop, distance and metric fields of a ZEBRA_IPV6_ROUTE_ADD
+   or ZEBRA_IPV6_ROUTE_DELETE. */
+static void
+zread_ipv6_attr (struct stream *s, struct zapi_ipv6 *api,
+		 struct in6_addr *nexthop, unsigned long *ifindex)
 {
   int i;
-  struct stream *s;
-  struct zapi_ipv6 api;
-  struct in6_addr nexthop;
-  unsigned long ifindex;
-  struct prefix_ipv6 p;
-  
-  s = client->ibuf;
-  ifindex = 0;
-  memset (&nexthop, 0, sizeof (struct in6_addr));
-
-  /* Type, flags, message. */
-  api.type = stream_getc (s);
-  api.flags = stream_getc (s);
-  api.message = stream_getc (s);
-
-  /* IPv4 prefix. */
-  memset (&p, 0, sizeof (struct prefix_ipv6));
-  p.family = AF_INET6;
-  p.prefixlen = stream_getc (s);
-  stream_get (&p.prefix, s, PSIZE (p.prefixlen));
 
   /* Nexthop, ifindex, distance, metric. */
-  if (CHECK_FLAG (api.message, ZAPI_MESSAGE_NEXTHOP))
+  if (CHECK_FLAG (api->message, ZAPI_MESSAGE_NEXTHOP))
     {
       u_char nexthop_type;
 
-      api.nexthop_num = stream_getc (s);
-      for (i = 0; i < api.nexthop_num; i++)
+      api->nexthop_num = stream_getc (s);
+      for (i = 0; i < api->nexthop_num; i++)
 	{
 	  nexthop_type = stream_getc (s);
 
 	  switch (nexthop_type)
 	    {
 	    case ZEBRA_NEXTHOP_IPV6:
-	      stream_get (&nexthop, s, 16);
+	      stream_get (nexthop, s, 16);
 	      break;
 	    case ZEBRA_NEXTHOP_IFINDEX:
-	      ifindex = stream_getl (s);
+	      *ifindex = stream_getl (s);
 	      break;
 	    }
 	}
     }
 
-  if (CHECK_FLAG (api.message, ZAPI_MESSAGE_DISTANCE))
-    api.distance = stream_getc (s);
+  if (CHECK_FLAG (api->message, ZAPI_MESSAGE_DISTANCE))
+    api->distance = stream_getc (s);
   else
-    api.distance = 0;
+    api->distance = 0;
 
-  if (CHECK_FLAG (api.message, ZAPI_MESSAGE_METRIC))
-    api.metric = stream_getl (s);
+  if (CHECK_FLAG (api->message, ZAPI_MESSAGE_METRIC))
+    api->metric = stream_getl (s);
   else
-    api.metric = 0;
-    
-  if (IN6_IS_ADDR_UNSPECIFIED (&nexthop))
-    rib_add_ipv6 (api.type, api.flags, &p, NULL, ifindex, 0, api.metric,
-		  api.distance);
+    api->metric = 0;
+}
+
+static void
+zebra_ipv6_route (int add, struct zapi_ipv6 *api, struct prefix_ipv6 *p,
+		  struct in6_addr *nexthop, unsigned long ifindex)
+{
+  if (IN6_IS_ADDR_UNSPECIFIED (nexthop))
+    nexthop = NULL;
+
+  if (add)
+    rib_add_ipv6 (api->type, api->flags, p, nexthop, ifindex, 0,
+		  api->metric, api->distance);
   else
-    rib_add_ipv6 (api.type, api.flags, &p, &nexthop, ifindex, 0, api.metric,
-		  api.distance);
-  return 0;
+    rib_delete_ipv6 (api->type, api->flags, p, nexthop, ifindex, 0);
 }
 
-/* Zebra server IPv6 prefix delete function. */
+/* Zebra server IPv6 prefix add and delete function. */
 static int
-zread_ipv6_delete (struct zserv *client, u_short length)
+zread_ipv6_route (int add, struct zserv *client, u_short length)
 {
-  int i;
   struct stream *s;
   struct zapi_ipv6 api;
   struct in6_addr nexthop;
@@ -992,47 +1125,52 @@ zread_ipv6_delete (struct zserv *client, u_short length)
   api.flags = stream_getc (s);
   api.message = stream_getc (s);
 
-  /* IPv4 prefix. */
+  /* IPv6 prefix. */
   memset (&p, 0, sizeof (struct prefix_ipv6));
   p.family = AF_INET6;
   p.prefixlen = stream_getc (s);
   stream_get (&p.prefix, s, PSIZE (p.prefixlen));
 
   /* Nexthop, ifindex, distance, metric. */
-  if (CHECK_FLAG (api.message, ZAPI_MESSAGE_NEXTHOP))
-    {
-      u_char nexthop_type;
+  zread_ipv6_attr (s, &api, &nexthop, &ifindex);
 
-      api.nexthop_num = stream_getc (s);
-      for (i = 0; i < api.nexthop_num; i++)
-	{
-	  nexthop_type = stream_getc (s);
+  zebra_ipv6_route (add, &api, &p, &nexthop, ifindex);
+  return 0;
+}
 
-	  switch (nexthop_type)
-	    {
-	    case ZEBRA_NEXTHOP_IPV6:
-	      stream_get (&nexthop, s, 16);
-	      break;
-	    case ZEBRA_NEXTHOP_IFINDEX:
-	      ifindex = stream_getl (s);
-	      break;
-	    }
+/* Zebra server IPv6 bulk prefix add and delete function. */
+static int
+zread_ipv6_route_bulk (int add, struct zserv *client, u_short length)
+{
+  struct stream *s;
+  struct zapi_ipv6 api;
+  struct in6_addr nexthop;
+  unsigned long ifindex;
+  struct prefix p;
+  u_int16_t count, i;
+
+  s = client->ibuf;
+  ifindex = 0;
+  memset (&nexthop, 0, sizeof (struct in6_addr));
+
+  api.type = stream_getc (s);
+  api.flags = stream_getc (s);
+  api.message = stream_getc (s);
+  count = stream_getw (s);
+
+  zread_ipv6_attr (s, &api, &nexthop, &ifindex);
+
+  for (i = 0; i < count; i++)
+    {
+      if (zread_prefix (s, &p, AF_INET6) < 0)
+	{
+	  zlog_warn ("%s: bad prefix length %d from client fd %d", __func__,
+		     p.prefixlen, client->sock);
+	  return -1;
 	}
+      zebra_ipv6_route (add, &api, (struct prefix_ipv6 *) &p, &nexthop,
+			ifindex);
     }
-
-  if (CHECK_FLAG (api.message, ZAPI_MESSAGE_DISTANCE))
-    api.distance = stream_getc (s);
-  else
-    api.distance = 0;
-  if (CHECK_FLAG (api.message, ZAPI_MESSAGE_METRIC))
-    api.metric = stream_getl (s);
-  else
-    api.metric = 0;
-    
-  if (IN6_IS_ADDR_UNSPECIFIED (&nexthop))
-    rib_delete_ipv6 (api.type, api.flags, &p, NULL, ifindex, 0);
-  else
-    rib_delete_ipv6 (api.type, api.flags, &p, &nexthop, ifindex, 0);
   return 0;
 }
 
@@ -1082,6 +1220,9 @@ zebra_client_close (struct zserv *client)
       client->sock = -1;
     }
 
+  /* Drop pending redistribution. */
+  zebra_redistribute_queue_free (client);
+
   /* Free stream buffers. */
   if (client->ibuf)
     stream_free (client->ibuf);
@@ -1252,12 +1393,24 @@ zebra_client_read (struct thread *thread)
     case ZEBRA_IPV4_ROUTE_DELETE:
       zread_ipv4_delete (client, length);
       break;
+    case ZEBRA_IPV4_ROUTE_ADD_BULK:
+      zread_ipv4_add_bulk (client, length);
+      break;
+    case ZEBRA_IPV4_ROUTE_DELETE_BULK:
+      zread_ipv4_delete_bulk (client, length);
+      break;
 #ifdef HAVE_IPV6
     case ZEBRA_IPV6_ROUTE_ADD:
-      zread_ipv6_add (client, length);
+      zread_ipv6_route (1, client, length);
       break;
     case ZEBRA_IPV6_ROUTE_DELETE:
-      zread_ipv6_delete (client, length);
+      zread_ipv6_route (0, client, length);
+      break;
+    case ZEBRA_IPV6_ROUTE_ADD_BULK:
+      zread_ipv6_route_bulk (1, client, length);
+      break;
+    case ZEBRA_IPV6_ROUTE_DELETE_BULK:
+      zread_ipv6_route_bulk (0, client, length);
       break;
 #endif /* HAVE_IPV6 */
     case ZEBRA_REDISTRIBUTE_ADD:
@@ -1553,11 +1706,32 @@ DEFUN (show_zebra_client,
   struct zserv *client;
 
   for (ALL_LIST_ELEMENTS_RO (zebrad.client_list, node, client))
-    vty_out (vty, "Client fd %d%s", client->sock, VTY_NEWLINE);
+    {
+      vty_out (vty, "Client fd %d%s", client->sock, VTY_NEWLINE);
+      vty_out (vty, "  Redistribution queue depth %lu (max %lu), "
+	       "queued %lu, coalesced %lu%s",
+	       client->redist_depth, client->redist_depth_max,
+	       client->redist_queued, client->redist_coalesced, VTY_NEWLINE);
+      vty_out (vty, "  Redistributed %lu routes in %lu writes, "
+	       "blocked %lu times%s",
+	       client->redist_sent, client->redist_writes,
+	       client->redist_blocked, VTY_NEWLINE);
+    }
   
   return CMD_SUCCESS;
 }
 
+DEFUN (show_zebra_kernel,
+       show_zebra_kernel_cmd,
+       "show zebra kernel",
+       SHOW_STR
+       "Zebra information"
+       "Kernel interface statistics")
+{
+  kernel_statistics (vty);
+  return CMD_SUCCESS;
+}
+
 /* Table configuration write function. */
 static int
 config_write_table (struct vty *vty)
@@ -1720,6 +1894,7 @@ zebra_init (void)
   install_element (CONFIG_NODE, &ip_forwarding_cmd);
   install_element (CONFIG_NODE, &no_ip_forwarding_cmd);
   install_element (ENABLE_NODE, &show_zebra_client_cmd);
+  install_element (ENABLE_NODE, &show_zebra_kernel_cmd);
 
 #ifdef HAVE_NETLINK
   install_element (VIEW_NODE, &show_table_cmd);
@@ -26,6 +26,8 @@
 #include "if.h"
 #include "workqueue.h"
 
+struct vty;
+
 /* Default port information. */
 #define ZEBRA_VTY_PORT                2601
 
@@ -66,6 +68,21 @@ struct zserv
 
   /* Router-id information. */
   u_char ridinfo;
+
+  /* Pending redistribution messages, coalesced per prefix and route
+     type, and the thread which drains them into wb. */
+  struct route_table *redist_queue[AFI_MAX];
+  struct stream *redist_buf;
+  struct thread *t_redist;
+
+  /* Redistribution queue statistics. */
+  unsigned long redist_depth;
+  unsigned long redist_depth_max;
+  unsigned long redist_queued;
+  unsigned long redist_coalesced;
+  unsigned long redist_sent;
+  unsigned long redist_writes;
+  unsigned long redist_blocked;
 };
 
 /* Zebra instance */
@@ -93,6 +110,7 @@ extern void hostinfo_get (void);
 extern void rib_init (void);
 extern void interface_list (void);
 extern void kernel_init (void);
+extern void kernel_statistics (struct vty *);
 extern void route_read (void);
 extern void zebra_route_map_init (void);
 extern void zebra_snmp_init (void);
@@ -105,6 +123,9 @@ extern int zsend_interface_address (int, struct zserv *, struct interface *,
 extern int zsend_interface_update (int, struct zserv *, struct interface *);
 extern int zsend_route_multipath (int, struct zserv *, struct prefix *, 
                                   struct rib *);
+extern int zserv_encode_route_multipath (int, struct stream *,
+                                         struct prefix *, struct rib *);
+extern int zebra_server_send_stream (struct zserv *, struct stream *);
 extern int zsend_router_id_update(struct zserv *, struct prefix *);
 
 extern pid_t pid;